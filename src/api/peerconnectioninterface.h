@@ -475,6 +475,13 @@ class PeerConnectionInterface : public rtc::RefCountInterface {
     // interval specified in milliseconds by the uniform distribution [a, b].
     rtc::Optional<rtc::IntervalRange> ice_regather_interval_range;
 
+    // The send and receive buffer sizes of the SCTP socket that data channels
+    // use, in bytes. Larger buffers allow a larger window, for more throughput
+    // on links with a large bandwidth-delay product. If unset, the usrsctp
+    // defaults are used.
+    rtc::Optional<int> sctp_send_buffer_size;
+    rtc::Optional<int> sctp_receive_buffer_size;
+
     //
     // Don't forget to update operator== if adding something.
     //
@@ -928,6 +935,18 @@ class PeerConnectionFactoryInterface : public rtc::RefCountInterface {
 
     // Sets crypto related options, e.g. enabled cipher suites.
     rtc::CryptoOptions crypto_options;
+
+    // The number of network threads that PeerConnections created with the
+    // default PortAllocator are spread over. Each PeerConnection is assigned
+    // to the thread with the fewest PeerConnections when it is created and
+    // keeps it for its lifetime. The factory's network thread is the first
+    // thread of the pool; the others are created as needed.
+    // Only network threads are pooled. Worker threads are not: the voice
+    // engine, AudioState and audio device module are bound to the factory's
+    // worker thread, so every Call and media channel still runs there.
+    // Pooling worker threads is a follow-up, and needs a media engine that
+    // is not bound to a single worker thread; it will get its own option.
+    int network_thread_pool_size = 1;
   };
 
   // Set the options to be used for subsequently created PeerConnections.
@@ -325,6 +325,9 @@ struct RtpRtxParameters {
   bool operator!=(const RtpRtxParameters& o) const { return !(*this == o); }
 };
 
+// The default of |RtpEncodingParameters::bitrate_priority|.
+const double kDefaultBitratePriority = 1.0;
+
 struct RtpEncodingParameters {
   RtpEncodingParameters();
   ~RtpEncodingParameters();
@@ -365,6 +368,12 @@ struct RtpEncodingParameters {
   // TODO(deadbeef): Not implemented.
   rtc::Optional<PriorityType> priority;
 
+  // The relative weight of this encoding when the bandwidth above the min
+  // bitrates of all streams is shared between them. An encoding with priority
+  // 2.0 gets twice as much of it as one with 1.0. Must be positive. Only the
+  // priority of the first encoding is used, for all encodings of a sender.
+  double bitrate_priority = kDefaultBitratePriority;
+
   // If set, this represents the Transport Independent Application Specific
   // maximum bandwidth defined in RFC3890. If unset, there is no maximum
   // bitrate.
@@ -407,7 +416,8 @@ struct RtpEncodingParameters {
   bool operator==(const RtpEncodingParameters& o) const {
     return ssrc == o.ssrc && codec_payload_type == o.codec_payload_type &&
            fec == o.fec && rtx == o.rtx && dtx == o.dtx &&
-           priority == o.priority && max_bitrate_bps == o.max_bitrate_bps &&
+           priority == o.priority && bitrate_priority == o.bitrate_priority &&
+           max_bitrate_bps == o.max_bitrate_bps &&
            max_framerate == o.max_framerate &&
            scale_resolution_down_by == o.scale_resolution_down_by &&
            scale_framerate_down_by == o.scale_framerate_down_by &&
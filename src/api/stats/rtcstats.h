@@ -76,6 +76,12 @@ class RTCStats {
   // object, listing all of its members (names and values).
   std::string ToJson() const;
 
+  // Creates a copy of this object in which only the members that differ from
+  // |previous| are defined. |previous| must be a stats object of the same type
+  // and with the same ID. Returns null if no member has changed. A member that
+  // has become undefined since |previous| is not reported.
+  std::unique_ptr<RTCStats> CopyChangedMembers(const RTCStats& previous) const;
+
   // Downcasts the stats object to an |RTCStats| subclass |T|. DCHECKs that the
   // object is of type |T|.
   template<typename T>
@@ -85,6 +91,9 @@ class RTCStats {
   }
 
  protected:
+  // Like |Members|, but the members can be modified.
+  std::vector<RTCStatsMemberInterface*> MutableMembers();
+
   // Gets a vector of all members of this |RTCStats| object, including members
   // derived from parent classes. |additional_capacity| is how many more members
   // shall be reserved in the vector (so that subclasses can allocate a vector
@@ -92,6 +101,9 @@ class RTCStats {
   virtual std::vector<const RTCStatsMemberInterface*>
   MembersOfThisObjectAndAncestors(
       size_t additional_capacity) const;
+  // Non-const version of |MembersOfThisObjectAndAncestors|.
+  virtual std::vector<RTCStatsMemberInterface*>
+  MutableMembersOfThisObjectAndAncestors(size_t additional_capacity);
 
   std::string const id_;
   int64_t timestamp_us_;
@@ -102,10 +114,10 @@ class RTCStats {
 // |WEBRTC_RTCSTATS_IMPL| is placed outside the class definition (in a .cc).
 //
 // These macros declare (in _DECL) and define (in _IMPL) the static |kType| and
-// overrides methods as required by subclasses of |RTCStats|: |copy|, |type| and
-// |MembersOfThisObjectAndAncestors|. The |...| argument is a list of addresses
-// to each member defined in the implementing class. The list must have at least
-// one member.
+// overrides methods as required by subclasses of |RTCStats|: |copy|, |type|,
+// |MembersOfThisObjectAndAncestors| and its non-const version. The |...|
+// argument is a list of addresses to each member defined in the implementing
+// class. The list must have at least one member.
 //
 // (Since class names need to be known to implement these methods this cannot be
 // part of the base |RTCStats|. While these methods could be implemented using
@@ -149,6 +161,9 @@ class RTCStats {
   std::vector<const webrtc::RTCStatsMemberInterface*>                          \
   MembersOfThisObjectAndAncestors(                                             \
       size_t local_var_additional_capacity) const override;                    \
+  std::vector<webrtc::RTCStatsMemberInterface*>                                \
+  MutableMembersOfThisObjectAndAncestors(                                      \
+      size_t local_var_additional_capacity) override;                          \
                                                                                \
  public:
 
@@ -181,6 +196,23 @@ class RTCStats {
                                  &local_var_members[0],                        \
                                  &local_var_members[local_var_members_count]); \
     return local_var_members_vec;                                              \
+  }                                                                            \
+                                                                               \
+  std::vector<webrtc::RTCStatsMemberInterface*>                                \
+  this_class::MutableMembersOfThisObjectAndAncestors(                          \
+      size_t local_var_additional_capacity) {                                  \
+    webrtc::RTCStatsMemberInterface* local_var_members[] = {                   \
+      __VA_ARGS__                                                              \
+    };                                                                         \
+    size_t local_var_members_count =                                           \
+        sizeof(local_var_members) / sizeof(local_var_members[0]);              \
+    std::vector<webrtc::RTCStatsMemberInterface*> local_var_members_vec =      \
+        parent_class::MutableMembersOfThisObjectAndAncestors(                  \
+            local_var_members_count + local_var_additional_capacity);          \
+    local_var_members_vec.insert(local_var_members_vec.end(),                  \
+                                 &local_var_members[0],                        \
+                                 &local_var_members[local_var_members_count]); \
+    return local_var_members_vec;                                              \
   }
 
 // Interface for |RTCStats| members, which have a name and a value of a type
@@ -215,6 +247,8 @@ class RTCStatsMemberInterface {
   virtual bool is_sequence() const = 0;
   virtual bool is_string() const = 0;
   bool is_defined() const { return is_defined_; }
+  // Makes the value undefined.
+  void Undefine() { is_defined_ = false; }
   // Type and value comparator. The names are not compared. These operators are
   // exposed for testing.
   virtual bool operator==(const RTCStatsMemberInterface& other) const = 0;
@@ -85,6 +85,44 @@ class RTCStatsReport : public rtc::RefCountInterface {
   // listing all of its stats objects.
   std::string ToJson() const;
 
+  // Creates a report with the stats of this report that are new or have
+  // changed since |previous|, where only the changed members of each stats
+  // object are defined (see |RTCStats::CopyChangedMembers|). The IDs of the
+  // stats objects that are present in |previous| but not in this report are
+  // listed in |removed_ids| of the delta report.
+  rtc::scoped_refptr<RTCStatsReport> CreateDelta(
+      const RTCStatsReport& previous) const;
+  // For a report created by |CreateDelta|, the IDs of the stats objects that
+  // have been removed since the previous report, in lexicographic order.
+  const std::vector<std::string>& removed_ids() const { return removed_ids_; }
+
+  // Creates a compact binary representation of the report. Only defined
+  // members are encoded. Every string used as a stats ID, type or member name
+  // is written once and subsequently referred to by its index:
+  //
+  //   report := varint(timestamp_us) uvarint(stats count) stats*
+  //             uvarint(removed ID count) string(removed ID)*
+  //   stats  := string(id) string(type) varint(timestamp_us)
+  //             uvarint(member count) member*
+  //   member := string(name) uint8(RTCStatsMemberInterface::Type) value
+  //   string := uvarint(index) [uvarint(length) bytes]
+  //
+  // The length and bytes of a string are only present the first time it is
+  // used, i.e. when |index| equals the number of strings seen so far. A
+  // varint is a zigzag encoded uvarint. Values of signed integer types are
+  // written as varints, unsigned ones as uvarints, doubles as their 64 bit
+  // IEEE 754 representation in network byte order, bools as a single byte and
+  // strings as uvarint(length) bytes. Sequences are uvarint(count) followed by
+  // the elements.
+  std::string ToBinary() const;
+  // Decodes a report created by |ToBinary|. Returns null if |binary| is not a
+  // valid encoding. The decoded stats objects have the types, IDs, timestamps
+  // and defined members of the encoded ones, but are not instances of the
+  // |RTCStats| subclasses they were encoded from, so they can't be |cast_to|
+  // those, and are only equal to other stats objects decoded with them.
+  static rtc::scoped_refptr<RTCStatsReport> FromBinary(
+      const std::string& binary);
+
   friend class rtc::RefCountedObject<RTCStatsReport>;
 
  private:
@@ -92,6 +130,7 @@ class RTCStatsReport : public rtc::RefCountInterface {
 
   int64_t timestamp_us_;
   StatsMap stats_;
+  std::vector<std::string> removed_ids_;
 };
 
 }  // namespace webrtc
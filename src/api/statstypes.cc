@@ -441,6 +441,16 @@ const char* StatsReport::Value::display_name() const {
 
     // Candidate related attributes. Values are taken from
     // http://w3c.github.io/webrtc-stats/#rtcstatstype-enum*.
+    case kStatsValueNameCandidateGatheringDoneMs:
+      return "googCandidateGatheringDoneMs";
+    case kStatsValueNameCandidateGatheringFirstCandidateMs:
+      return "googCandidateGatheringFirstCandidateMs";
+    case kStatsValueNameCandidateGatheringRelayPhaseMs:
+      return "googCandidateGatheringRelayPhaseMs";
+    case kStatsValueNameCandidateGatheringTcpPhaseMs:
+      return "googCandidateGatheringTcpPhaseMs";
+    case kStatsValueNameCandidateGatheringUdpPhaseMs:
+      return "googCandidateGatheringUdpPhaseMs";
     case kStatsValueNameCandidateIPAddress:
       return "ipAddress";
     case kStatsValueNameCandidateNetworkType:
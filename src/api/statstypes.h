@@ -139,6 +139,11 @@ class StatsReport {
     kStatsValueNameBandwidthLimitedResolution,
     kStatsValueNameBucketDelay,
     kStatsValueNameCaptureStartNtpTimeMs,
+    kStatsValueNameCandidateGatheringDoneMs,
+    kStatsValueNameCandidateGatheringFirstCandidateMs,
+    kStatsValueNameCandidateGatheringRelayPhaseMs,
+    kStatsValueNameCandidateGatheringTcpPhaseMs,
+    kStatsValueNameCandidateGatheringUdpPhaseMs,
     kStatsValueNameCandidateIPAddress,
     kStatsValueNameCandidateNetworkType,
     kStatsValueNameCandidatePortNumber,
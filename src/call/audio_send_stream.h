@@ -105,6 +105,9 @@ class AudioSendStream {
     // Note: This is still an experimental feature and not ready for real usage.
     int min_bitrate_bps = -1;
     int max_bitrate_bps = -1;
+    // The weight of this stream when the bitrate above the min bitrates of all
+    // streams is shared between them, see |BitrateAllocator::AddObserver|.
+    double bitrate_priority = kDefaultBitratePriority;
 
     // Defines whether to turn on audio network adaptor, and defines its config
     // string.
@@ -48,6 +48,9 @@ double MediaRatio(uint32_t allocated_bitrate, uint32_t protection_bitrate) {
 BitrateAllocator::BitrateAllocator(LimitObserver* limit_observer)
     : limit_observer_(limit_observer),
       bitrate_observer_configs_(),
+      sum_min_bitrates_(0),
+      sum_max_bitrates_(0),
+      sum_bitrate_priorities_(0.0),
       last_bitrate_bps_(0),
       last_non_zero_bitrate_bps_(kDefaultBitrateBps),
       last_fraction_loss_(0),
@@ -86,8 +89,9 @@ void BitrateAllocator::OnNetworkChanged(uint32_t target_bitrate_bps,
 
   ObserverAllocation allocation = AllocateBitrates(target_bitrate_bps);
 
-  for (auto& config : bitrate_observer_configs_) {
-    uint32_t allocated_bitrate = allocation[config.observer];
+  for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i) {
+    ObserverConfig& config = bitrate_observer_configs_[i];
+    uint32_t allocated_bitrate = allocation[i];
     uint32_t protection_bitrate = config.observer->OnBitrateUpdated(
         allocated_bitrate, last_fraction_loss_, last_rtt_,
         last_bwe_period_ms_);
@@ -124,28 +128,41 @@ void BitrateAllocator::AddObserver(BitrateAllocatorObserver* observer,
                                    uint32_t min_bitrate_bps,
                                    uint32_t max_bitrate_bps,
                                    uint32_t pad_up_bitrate_bps,
-                                   bool enforce_min_bitrate) {
+                                   bool enforce_min_bitrate,
+                                   double bitrate_priority) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
+  RTC_DCHECK_GT(bitrate_priority, 0.0);
   auto it = FindObserverConfig(observer);
 
   // Update settings if the observer already exists, create a new one otherwise.
   if (it != bitrate_observer_configs_.end()) {
+    size_t index = it - bitrate_observer_configs_.begin();
+    RemoveFromDistributionOrder(index);
+    sum_min_bitrates_ -= it->min_bitrate_bps;
+    sum_max_bitrates_ -= it->max_bitrate_bps;
+    sum_bitrate_priorities_ -= it->bitrate_priority;
     it->min_bitrate_bps = min_bitrate_bps;
     it->max_bitrate_bps = max_bitrate_bps;
     it->pad_up_bitrate_bps = pad_up_bitrate_bps;
     it->enforce_min_bitrate = enforce_min_bitrate;
+    it->bitrate_priority = bitrate_priority;
+    InsertInDistributionOrder(index);
   } else {
-    bitrate_observer_configs_.push_back(
-        ObserverConfig(observer, min_bitrate_bps, max_bitrate_bps,
-                       pad_up_bitrate_bps, enforce_min_bitrate));
+    bitrate_observer_configs_.push_back(ObserverConfig(
+        observer, min_bitrate_bps, max_bitrate_bps, pad_up_bitrate_bps,
+        enforce_min_bitrate, bitrate_priority));
+    InsertInDistributionOrder(bitrate_observer_configs_.size() - 1);
   }
+  sum_min_bitrates_ += min_bitrate_bps;
+  sum_max_bitrates_ += max_bitrate_bps;
+  sum_bitrate_priorities_ += bitrate_priority;
 
-  ObserverAllocation allocation;
   if (last_bitrate_bps_ > 0) {
     // Calculate a new allocation and update all observers.
-    allocation = AllocateBitrates(last_bitrate_bps_);
-    for (auto& config : bitrate_observer_configs_) {
-      uint32_t allocated_bitrate = allocation[config.observer];
+    ObserverAllocation allocation = AllocateBitrates(last_bitrate_bps_);
+    for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i) {
+      ObserverConfig& config = bitrate_observer_configs_[i];
+      uint32_t allocated_bitrate = allocation[i];
       uint32_t protection_bitrate = config.observer->OnBitrateUpdated(
           allocated_bitrate, last_fraction_loss_, last_rtt_,
           last_bwe_period_ms_);
@@ -155,9 +172,8 @@ void BitrateAllocator::AddObserver(BitrateAllocatorObserver* observer,
     }
   } else {
     // Currently, an encoder is not allowed to produce frames.
-    // But we still have to return the initial config bitrate + let the
-    // observer know that it can not produce frames.
-    allocation = AllocateBitrates(last_non_zero_bitrate_bps_);
+    // But we still have to let the observer know that it can not produce
+    // frames.
     observer->OnBitrateUpdated(0, last_fraction_loss_, last_rtt_,
                                last_bwe_period_ms_);
   }
@@ -200,7 +216,21 @@ void BitrateAllocator::RemoveObserver(BitrateAllocatorObserver* observer) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
   auto it = FindObserverConfig(observer);
   if (it != bitrate_observer_configs_.end()) {
+    size_t index = it - bitrate_observer_configs_.begin();
+    RemoveFromDistributionOrder(index);
+    sum_min_bitrates_ -= it->min_bitrate_bps;
+    sum_max_bitrates_ -= it->max_bitrate_bps;
+    sum_bitrate_priorities_ -= it->bitrate_priority;
     bitrate_observer_configs_.erase(it);
+    // Don't let rounding errors in the sum of priorities accumulate.
+    if (bitrate_observer_configs_.empty())
+      sum_bitrate_priorities_ = 0.0;
+    // The observers after the removed one moved down one index, which doesn't
+    // change their relative order.
+    for (size_t& other_index : distribution_order_) {
+      if (other_index > index)
+        --other_index;
+    }
   }
 
   UpdateAllocationLimits();
@@ -243,61 +273,51 @@ BitrateAllocator::ObserverAllocation BitrateAllocator::AllocateBitrates(
   if (bitrate == 0)
     return ZeroRateAllocation();
 
-  uint32_t sum_min_bitrates = 0;
-  uint32_t sum_max_bitrates = 0;
-  for (const auto& observer_config : bitrate_observer_configs_) {
-    sum_min_bitrates += observer_config.min_bitrate_bps;
-    sum_max_bitrates += observer_config.max_bitrate_bps;
-  }
-
   // Not enough for all observers to get an allocation, allocate according to:
   // enforced min bitrate -> allocated bitrate previous round -> restart paused
   // streams.
-  if (!EnoughBitrateForAllObservers(bitrate, sum_min_bitrates))
+  if (!EnoughBitrateForAllObservers(bitrate, sum_min_bitrates_))
     return LowRateAllocation(bitrate);
 
-  // All observers will get their min bitrate plus an even share of the rest.
-  if (bitrate <= sum_max_bitrates)
-    return NormalRateAllocation(bitrate, sum_min_bitrates);
+  // All observers will get their min bitrate plus a share of the rest.
+  if (bitrate <= sum_max_bitrates_)
+    return NormalRateAllocation(bitrate, sum_min_bitrates_);
 
   // All observers will get up to kTransmissionMaxBitrateMultiplier x max.
-  return MaxRateAllocation(bitrate, sum_max_bitrates);
+  return MaxRateAllocation(bitrate, sum_max_bitrates_);
 }
 
 BitrateAllocator::ObserverAllocation BitrateAllocator::ZeroRateAllocation() {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
-  ObserverAllocation allocation;
-  for (const auto& observer_config : bitrate_observer_configs_)
-    allocation[observer_config.observer] = 0;
-  return allocation;
+  return ObserverAllocation(bitrate_observer_configs_.size(), 0);
 }
 
 BitrateAllocator::ObserverAllocation BitrateAllocator::LowRateAllocation(
     uint32_t bitrate) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
-  ObserverAllocation allocation;
+  ObserverAllocation allocation(bitrate_observer_configs_.size(), 0);
   // Start by allocating bitrate to observers enforcing a min bitrate, hence
   // remaining_bitrate might turn negative.
   int64_t remaining_bitrate = bitrate;
-  for (const auto& observer_config : bitrate_observer_configs_) {
-    int32_t allocated_bitrate = 0;
-    if (observer_config.enforce_min_bitrate)
-      allocated_bitrate = observer_config.min_bitrate_bps;
-
-    allocation[observer_config.observer] = allocated_bitrate;
-    remaining_bitrate -= allocated_bitrate;
+  for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i) {
+    const ObserverConfig& observer_config = bitrate_observer_configs_[i];
+    if (observer_config.enforce_min_bitrate) {
+      allocation[i] = observer_config.min_bitrate_bps;
+      remaining_bitrate -= observer_config.min_bitrate_bps;
+    }
   }
 
   // Allocate bitrate to all previously active streams.
   if (remaining_bitrate > 0) {
-    for (const auto& observer_config : bitrate_observer_configs_) {
+    for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i) {
+      const ObserverConfig& observer_config = bitrate_observer_configs_[i];
       if (observer_config.enforce_min_bitrate ||
           LastAllocatedBitrate(observer_config) == 0)
         continue;
 
       uint32_t required_bitrate = MinBitrateWithHysteresis(observer_config);
       if (remaining_bitrate >= required_bitrate) {
-        allocation[observer_config.observer] = required_bitrate;
+        allocation[i] = required_bitrate;
         remaining_bitrate -= required_bitrate;
       }
     }
@@ -305,20 +325,21 @@ BitrateAllocator::ObserverAllocation BitrateAllocator::LowRateAllocation(
 
   // Allocate bitrate to previously paused streams.
   if (remaining_bitrate > 0) {
-    for (const auto& observer_config : bitrate_observer_configs_) {
+    for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i) {
+      const ObserverConfig& observer_config = bitrate_observer_configs_[i];
       if (LastAllocatedBitrate(observer_config) != 0)
         continue;
 
       // Add a hysteresis to avoid toggling.
       uint32_t required_bitrate = MinBitrateWithHysteresis(observer_config);
       if (remaining_bitrate >= required_bitrate) {
-        allocation[observer_config.observer] = required_bitrate;
+        allocation[i] = required_bitrate;
         remaining_bitrate -= required_bitrate;
       }
     }
   }
 
-  // Split a possible remainder evenly on all streams with an allocation.
+  // Split a possible remainder on all streams with an allocation.
   if (remaining_bitrate > 0)
     DistributeBitrateEvenly(remaining_bitrate, false, 1, &allocation);
 
@@ -331,8 +352,9 @@ BitrateAllocator::ObserverAllocation BitrateAllocator::NormalRateAllocation(
     uint32_t sum_min_bitrates) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
   ObserverAllocation allocation;
+  allocation.reserve(bitrate_observer_configs_.size());
   for (const auto& observer_config : bitrate_observer_configs_)
-    allocation[observer_config.observer] = observer_config.min_bitrate_bps;
+    allocation.push_back(observer_config.min_bitrate_bps);
 
   bitrate -= sum_min_bitrates;
   if (bitrate > 0)
@@ -346,11 +368,10 @@ BitrateAllocator::ObserverAllocation BitrateAllocator::MaxRateAllocation(
     uint32_t sum_max_bitrates) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
   ObserverAllocation allocation;
-
-  for (const auto& observer_config : bitrate_observer_configs_) {
-    allocation[observer_config.observer] = observer_config.max_bitrate_bps;
-    bitrate -= observer_config.max_bitrate_bps;
-  }
+  allocation.reserve(bitrate_observer_configs_.size());
+  for (const auto& observer_config : bitrate_observer_configs_)
+    allocation.push_back(observer_config.max_bitrate_bps);
+  bitrate -= sum_max_bitrates;
   DistributeBitrateEvenly(bitrate, true, kTransmissionMaxBitrateMultiplier,
                           &allocation);
   return allocation;
@@ -391,32 +412,45 @@ void BitrateAllocator::DistributeBitrateEvenly(uint32_t bitrate,
                                                ObserverAllocation* allocation) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
   RTC_DCHECK_EQ(allocation->size(), bitrate_observer_configs_.size());
-
-  ObserverSortingMap list_max_bitrates;
-  for (const auto& observer_config : bitrate_observer_configs_) {
-    if (include_zero_allocations ||
-        allocation->at(observer_config.observer) != 0) {
-      list_max_bitrates.insert(std::pair<uint32_t, const ObserverConfig*>(
-          observer_config.max_bitrate_bps, &observer_config));
+  RTC_DCHECK_EQ(distribution_order_.size(), bitrate_observer_configs_.size());
+
+  size_t num_remaining = 0;
+  double remaining_priority = 0.0;
+  for (size_t i = 0; i < bitrate_observer_configs_.size(); ++i) {
+    if (include_zero_allocations || (*allocation)[i] != 0) {
+      ++num_remaining;
+      remaining_priority += bitrate_observer_configs_[i].bitrate_priority;
     }
   }
-  auto it = list_max_bitrates.begin();
-  while (it != list_max_bitrates.end()) {
+  // Observers are visited in increasing order of max bitrate over priority,
+  // so that the ones that reach their max carry over what they can't use to
+  // the ones that come after.
+  for (size_t index : distribution_order_) {
+    if (num_remaining == 0)
+      break;
+    uint32_t& observer_allocation = (*allocation)[index];
+    if (!include_zero_allocations && observer_allocation == 0)
+      continue;
+    const ObserverConfig& observer_config = bitrate_observer_configs_[index];
     RTC_DCHECK_GT(bitrate, 0);
     uint32_t extra_allocation =
-        bitrate / static_cast<uint32_t>(list_max_bitrates.size());
-    uint32_t total_allocation =
-        extra_allocation + allocation->at(it->second->observer);
+        num_remaining == 1
+            ? bitrate
+            : static_cast<uint32_t>(bitrate * observer_config.bitrate_priority /
+                                    remaining_priority);
+    --num_remaining;
+    remaining_priority -= observer_config.bitrate_priority;
+    uint32_t total_allocation = extra_allocation + observer_allocation;
+    uint32_t max_allocation = max_multiplier * observer_config.max_bitrate_bps;
     bitrate -= extra_allocation;
-    if (total_allocation > max_multiplier * it->first) {
+    if (total_allocation > max_allocation) {
       // There is more than we can fit for this observer, carry over to the
       // remaining observers.
-      bitrate += total_allocation - max_multiplier * it->first;
-      total_allocation = max_multiplier * it->first;
+      bitrate += total_allocation - max_allocation;
+      total_allocation = max_allocation;
     }
     // Finally, update the allocation for this observer.
-    allocation->at(it->second->observer) = total_allocation;
-    it = list_max_bitrates.erase(it);
+    observer_allocation = total_allocation;
   }
 }
 
@@ -426,15 +460,50 @@ bool BitrateAllocator::EnoughBitrateForAllObservers(uint32_t bitrate,
   if (bitrate < sum_min_bitrates)
     return false;
 
-  uint32_t extra_bitrate_per_observer =
-      (bitrate - sum_min_bitrates) /
-      static_cast<uint32_t>(bitrate_observer_configs_.size());
+  double extra_bitrate_per_priority =
+      (bitrate - sum_min_bitrates) / sum_bitrate_priorities_;
   for (const auto& observer_config : bitrate_observer_configs_) {
-    if (observer_config.min_bitrate_bps + extra_bitrate_per_observer <
+    uint32_t extra_bitrate = static_cast<uint32_t>(
+        extra_bitrate_per_priority * observer_config.bitrate_priority);
+    if (observer_config.min_bitrate_bps + extra_bitrate <
         MinBitrateWithHysteresis(observer_config)) {
       return false;
     }
   }
   return true;
 }
+
+bool BitrateAllocator::DistributesBefore(size_t index,
+                                         size_t other_index) const {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
+  const ObserverConfig& config = bitrate_observer_configs_[index];
+  const ObserverConfig& other_config = bitrate_observer_configs_[other_index];
+  double key = config.max_bitrate_bps / config.bitrate_priority;
+  double other_key =
+      other_config.max_bitrate_bps / other_config.bitrate_priority;
+  if (key != other_key)
+    return key < other_key;
+  return index < other_index;
+}
+
+void BitrateAllocator::InsertInDistributionOrder(size_t index) {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
+  auto it = std::lower_bound(distribution_order_.begin(),
+                             distribution_order_.end(), index,
+                             [this](size_t lhs, size_t rhs) {
+                               return DistributesBefore(lhs, rhs);
+                             });
+  distribution_order_.insert(it, index);
+}
+
+void BitrateAllocator::RemoveFromDistributionOrder(size_t index) {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&sequenced_checker_);
+  auto it = std::lower_bound(distribution_order_.begin(),
+                             distribution_order_.end(), index,
+                             [this](size_t lhs, size_t rhs) {
+                               return DistributesBefore(lhs, rhs);
+                             });
+  RTC_DCHECK(it != distribution_order_.end() && *it == index);
+  distribution_order_.erase(it);
+}
 }  // namespace webrtc
@@ -13,7 +13,6 @@
 
 #include <stdint.h>
 
-#include <map>
 #include <utility>
 #include <vector>
 
@@ -74,6 +73,10 @@ class BitrateAllocator {
   // |enforce_min_bitrate| = 'true' will allocate at least |min_bitrate_bps| for
   //    this observer, even if the BWE is too low, 'false' will allocate 0 to
   //    the observer if BWE doesn't allow |min_bitrate_bps|.
+  // |bitrate_priority| is the weight of this observer when the bitrate above
+  //    the min bitrates is shared, relative to the other observers. An
+  //    observer with priority 2.0 gets twice as much as one with 1.0, until
+  //    it reaches its max bitrate.
   // Note that |observer|->OnBitrateUpdated() will be called within the scope of
   // this method with the current rtt, fraction_loss and available bitrate and
   // that the bitrate in OnBitrateUpdated will be zero if the |observer| is
@@ -82,7 +85,8 @@ class BitrateAllocator {
                    uint32_t min_bitrate_bps,
                    uint32_t max_bitrate_bps,
                    uint32_t pad_up_bitrate_bps,
-                   bool enforce_min_bitrate);
+                   bool enforce_min_bitrate,
+                   double bitrate_priority = 1.0);
 
   // Removes a previously added observer, but will not trigger a new bitrate
   // allocation.
@@ -99,12 +103,14 @@ class BitrateAllocator {
                    uint32_t min_bitrate_bps,
                    uint32_t max_bitrate_bps,
                    uint32_t pad_up_bitrate_bps,
-                   bool enforce_min_bitrate)
+                   bool enforce_min_bitrate,
+                   double bitrate_priority)
         : observer(observer),
           min_bitrate_bps(min_bitrate_bps),
           max_bitrate_bps(max_bitrate_bps),
           pad_up_bitrate_bps(pad_up_bitrate_bps),
           enforce_min_bitrate(enforce_min_bitrate),
+          bitrate_priority(bitrate_priority),
           allocated_bitrate_bps(-1),
           media_ratio(1.0) {}
 
@@ -113,6 +119,7 @@ class BitrateAllocator {
     uint32_t max_bitrate_bps;
     uint32_t pad_up_bitrate_bps;
     bool enforce_min_bitrate;
+    double bitrate_priority;
     int64_t allocated_bitrate_bps;
     double media_ratio;  // Part of the total bitrate used for media [0.0, 1.0].
   };
@@ -125,8 +132,8 @@ class BitrateAllocator {
   ObserverConfigs::iterator FindObserverConfig(
       const BitrateAllocatorObserver* observer);
 
-  typedef std::multimap<uint32_t, const ObserverConfig*> ObserverSortingMap;
-  typedef std::map<BitrateAllocatorObserver*, int> ObserverAllocation;
+  // Allocated bitrates, indexed like |bitrate_observer_configs_|.
+  typedef std::vector<uint32_t> ObserverAllocation;
 
   ObserverAllocation AllocateBitrates(uint32_t bitrate);
 
@@ -141,10 +148,10 @@ class BitrateAllocator {
   // The minimum bitrate required by this observer, including enable-hysteresis
   // if the observer is in a paused state.
   uint32_t MinBitrateWithHysteresis(const ObserverConfig& observer_config);
-  // Splits |bitrate| evenly to observers already in |allocation|.
-  // |include_zero_allocations| decides if zero allocations should be part of
-  // the distribution or not. The allowed max bitrate is |max_multiplier| x
-  // observer max bitrate.
+  // Splits |bitrate| to observers already in |allocation|, in proportion to
+  // their bitrate priority. |include_zero_allocations| decides if zero
+  // allocations should be part of the distribution or not. The allowed max
+  // bitrate is |max_multiplier| x observer max bitrate.
   void DistributeBitrateEvenly(uint32_t bitrate,
                                bool include_zero_allocations,
                                int max_multiplier,
@@ -152,10 +159,24 @@ class BitrateAllocator {
   bool EnoughBitrateForAllObservers(uint32_t bitrate,
                                     uint32_t sum_min_bitrates);
 
+  // Keep |distribution_order_| sorted when the observer at |index| is added,
+  // removed or has its max bitrate or priority changed, without re-sorting.
+  bool DistributesBefore(size_t index, size_t other_index) const;
+  void InsertInDistributionOrder(size_t index);
+  void RemoveFromDistributionOrder(size_t index);
+
   rtc::SequencedTaskChecker sequenced_checker_;
   LimitObserver* const limit_observer_ RTC_GUARDED_BY(&sequenced_checker_);
   // Stored in a list to keep track of the insertion order.
   ObserverConfigs bitrate_observer_configs_ RTC_GUARDED_BY(&sequenced_checker_);
+  // Indices into |bitrate_observer_configs_|, in the order bitrate is
+  // distributed to the observers: by max bitrate over bitrate priority, so
+  // that what doesn't fit into an observer's max is carried over to the ones
+  // that can take more, and otherwise in insertion order.
+  std::vector<size_t> distribution_order_ RTC_GUARDED_BY(&sequenced_checker_);
+  uint32_t sum_min_bitrates_ RTC_GUARDED_BY(&sequenced_checker_);
+  uint32_t sum_max_bitrates_ RTC_GUARDED_BY(&sequenced_checker_);
+  double sum_bitrate_priorities_ RTC_GUARDED_BY(&sequenced_checker_);
   uint32_t last_bitrate_bps_ RTC_GUARDED_BY(&sequenced_checker_);
   uint32_t last_non_zero_bitrate_bps_ RTC_GUARDED_BY(&sequenced_checker_);
   uint8_t last_fraction_loss_ RTC_GUARDED_BY(&sequenced_checker_);
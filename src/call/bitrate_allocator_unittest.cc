@@ -14,6 +14,8 @@
 
 #include "call/bitrate_allocator.h"
 #include "modules/bitrate_controller/include/bitrate_controller.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/timeutils.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 
@@ -519,4 +521,97 @@ TEST_F(BitrateAllocatorTest, PassProbingInterval) {
   allocator_->RemoveObserver(&observer);
 }
 
+
+TEST_F(BitrateAllocatorTest, PrioritySplitsBitrateAboveMin) {
+  TestBitrateObserver low_priority;
+  TestBitrateObserver high_priority;
+  allocator_->AddObserver(&low_priority, 100000, 2000000, 0, true, 1.0);
+  allocator_->AddObserver(&high_priority, 100000, 2000000, 0, true, 3.0);
+
+  // The 400 kbps above the min bitrates are split 1:3.
+  allocator_->OnNetworkChanged(600000, 0, 0, kDefaultProbingIntervalMs);
+  EXPECT_EQ(200000u, low_priority.last_bitrate_bps_);
+  EXPECT_EQ(400000u, high_priority.last_bitrate_bps_);
+
+  // What doesn't fit into the max of the high priority observer goes to the
+  // low priority one.
+  allocator_->AddObserver(&high_priority, 100000, 300000, 0, true, 3.0);
+  allocator_->OnNetworkChanged(1000000, 0, 0, kDefaultProbingIntervalMs);
+  EXPECT_EQ(700000u, low_priority.last_bitrate_bps_);
+  EXPECT_EQ(300000u, high_priority.last_bitrate_bps_);
+
+  allocator_->RemoveObserver(&low_priority);
+  allocator_->RemoveObserver(&high_priority);
+}
+
+TEST_F(BitrateAllocatorTest, UpdatedObserversAllocateLikeNewObservers) {
+  const uint32_t kBitrateBps = 2500000;
+  TestBitrateObserver observers[4];
+  allocator_->AddObserver(&observers[0], 100000, 800000, 0, true, 1.0);
+  allocator_->AddObserver(&observers[1], 50000, 400000, 0, true, 2.0);
+  allocator_->AddObserver(&observers[2], 200000, 1000000, 0, true, 1.0);
+  allocator_->AddObserver(&observers[3], 100000, 600000, 0, true, 0.5);
+  allocator_->OnNetworkChanged(kBitrateBps, 0, 0, kDefaultProbingIntervalMs);
+
+  allocator_->AddObserver(&observers[1], 50000, 2000000, 0, true, 1.5);
+  allocator_->RemoveObserver(&observers[2]);
+  allocator_->AddObserver(&observers[3], 150000, 500000, 0, true, 4.0);
+  allocator_->OnNetworkChanged(kBitrateBps, 0, 0, kDefaultProbingIntervalMs);
+
+  NiceMock<MockLimitObserver> limit_observer;
+  BitrateAllocator allocator(&limit_observer);
+  TestBitrateObserver new_observers[3];
+  allocator.AddObserver(&new_observers[0], 100000, 800000, 0, true, 1.0);
+  allocator.AddObserver(&new_observers[1], 50000, 2000000, 0, true, 1.5);
+  allocator.AddObserver(&new_observers[2], 150000, 500000, 0, true, 4.0);
+  allocator.OnNetworkChanged(kBitrateBps, 0, 0, kDefaultProbingIntervalMs);
+
+  EXPECT_EQ(new_observers[0].last_bitrate_bps_, observers[0].last_bitrate_bps_);
+  EXPECT_EQ(new_observers[1].last_bitrate_bps_, observers[1].last_bitrate_bps_);
+  EXPECT_EQ(new_observers[2].last_bitrate_bps_, observers[3].last_bitrate_bps_);
+  EXPECT_EQ(kBitrateBps, observers[0].last_bitrate_bps_ +
+                             observers[1].last_bitrate_bps_ +
+                             observers[3].last_bitrate_bps_);
+
+  allocator_->RemoveObserver(&observers[0]);
+  allocator_->RemoveObserver(&observers[1]);
+  allocator_->RemoveObserver(&observers[3]);
+  for (auto& observer : new_observers)
+    allocator.RemoveObserver(&observer);
+}
+
+TEST_F(BitrateAllocatorTest, DISABLED_ManyObserversPerformance) {
+  const int kNumObservers = 1000;
+  const int kUpdatesPerSecond = 20;
+  const int kNumUpdates = 60 * kUpdatesPerSecond;
+  std::vector<TestBitrateObserver> observers(kNumObservers);
+  for (int i = 0; i < kNumObservers; ++i) {
+    allocator_->AddObserver(&observers[i], 30000 + (i % 10) * 10000,
+                            300000 + (i % 7) * 200000, 0, i % 3 == 0,
+                            1.0 + i % 4);
+  }
+
+  int64_t start_ns = rtc::TimeNanos();
+  for (int i = 0; i < kNumUpdates; ++i) {
+    // Sweep the estimate through the low, normal and max rate allocations.
+    uint32_t bitrate_bps = 20000000 + (i % 100) * 10000000;
+    allocator_->OnNetworkChanged(bitrate_bps, 0, 0, kDefaultProbingIntervalMs);
+  }
+  int64_t update_ns = (rtc::TimeNanos() - start_ns) / kNumUpdates;
+
+  // Change the constraints of some observers, as a renegotiation would.
+  start_ns = rtc::TimeNanos();
+  for (int i = 0; i < kNumObservers; i += 10) {
+    allocator_->AddObserver(&observers[i], 50000, 1000000, 0, false, 2.0);
+  }
+  int64_t reconfigure_ns =
+      (rtc::TimeNanos() - start_ns) / (kNumObservers / 10);
+
+  LOG(LS_INFO) << kNumObservers << " observers: " << update_ns / 1000
+               << " us per bitrate update, " << reconfigure_ns / 1000
+               << " us per observer reconfiguration.";
+  for (auto& observer : observers)
+    allocator_->RemoveObserver(&observer);
+}
+
 }  // namespace webrtc
@@ -31,6 +31,8 @@
 namespace webrtc {
 
 class AudioProcessing;
+class DecodeScheduler;
+class EncoderQueuePool;
 class RtcEventLog;
 
 enum class MediaType {
@@ -112,6 +114,16 @@ class Call {
     // RtcEventLog to use for this call. Required.
     // Use webrtc::RtcEventLog::CreateNull() for a null implementation.
     RtcEventLog* event_log = nullptr;
+
+    // Decodes the video receive streams on a pool of threads, which may be
+    // shared between calls, instead of on a thread per stream. Optional, must
+    // outlive the call.
+    DecodeScheduler* decode_scheduler = nullptr;
+
+    // Runs the encoders of the video send streams on a pool of task queues,
+    // which may be shared between calls, instead of on a task queue per
+    // stream. Optional, must outlive the call.
+    EncoderQueuePool* encoder_queue_pool = nullptr;
   };
 
   struct Stats {
@@ -49,6 +49,10 @@ struct VideoStream {
   // TODO(kthelgason): Apart from a special case for two-layer screencast these
   // thresholds are not propagated to the VideoEncoder. To be implemented.
   std::vector<int> temporal_layer_thresholds_bps;
+
+  // The bitrate priority of the send stream, see
+  // |VideoEncoderConfig::bitrate_priority|. Only set for the first stream.
+  rtc::Optional<double> bitrate_priority;
 };
 
 class VideoEncoderConfig {
@@ -142,6 +146,9 @@ class VideoEncoderConfig {
   // unless the estimated bandwidth indicates that the link can handle it.
   int min_transmit_bitrate_bps;
   int max_bitrate_bps;
+  // The weight of this stream when the bitrate above the min bitrates of all
+  // streams is shared between them, see |BitrateAllocator::AddObserver|.
+  double bitrate_priority;
 
   // Max number of encoded VideoStreams to produce.
   size_t number_of_streams;
@@ -76,6 +76,8 @@ class VideoReceiveStream {
     int jitter_buffer_ms = 0;
     int min_playout_delay_ms = 0;
     int render_delay_ms = 10;
+    // Number of frames in the jitter buffer waiting to be decoded.
+    int frames_buffered = 0;
     int64_t interframe_delay_max_ms = -1;
     uint32_t frames_decoded = 0;
     rtc::Optional<uint64_t> qp_sum;
@@ -101,6 +103,14 @@ class VideoReceiveStream {
     // Timing frame info: all important timestamps for a full lifetime of a
     // single 'timing frame'.
     rtc::Optional<webrtc::TimingFrameInfo> timing_frame_info;
+
+    // Per-frame latency of each receive pipeline stage: from the first to the
+    // last packet of the frame, from the last packet until decoding starts,
+    // decoding, and from decoded until rendered.
+    LatencyPercentiles packet_receive_latency;
+    LatencyPercentiles jitter_buffer_latency;
+    LatencyPercentiles decode_latency;
+    LatencyPercentiles render_latency;
   };
 
   struct Config {
@@ -84,6 +84,10 @@ class VideoSendStream {
     std::map<uint32_t, StreamStats> substreams;
     webrtc::VideoContentType content_type =
         webrtc::VideoContentType::UNSPECIFIED;
+    // Per-frame latency from capture until encoding starts, and of the
+    // encoding itself.
+    LatencyPercentiles encode_queue_latency;
+    LatencyPercentiles encode_latency;
   };
 
   struct Config {
@@ -273,6 +273,15 @@ struct FrameCounts {
   int delta_frames;
 };
 
+// Percentiles of the time spent in one stage of the media pipeline. Values are
+// -1 until a sample has been recorded for the stage.
+struct LatencyPercentiles {
+  int p50_ms = -1;
+  int p99_ms = -1;
+  int max_ms = -1;
+  size_t num_samples = 0;
+};
+
 // Callback, used to notify an observer whenever frame counts have been updated.
 class FrameCountObserver {
  public:
@@ -10,6 +10,7 @@
 
 #include "logging/rtc_event_log/rtc_event_log.h"
 
+#include <algorithm>
 #include <atomic>
 #include <deque>
 #include <functional>
@@ -35,6 +36,7 @@
 #include "modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
 #include "rtc_base/event.h"
 #include "rtc_base/ignore_wundef.h"
 #include "rtc_base/logging.h"
@@ -65,6 +67,127 @@ namespace webrtc {
 namespace {
 const int kEventsInHistory = 10000;
 
+// With EncodingType::kBatched, this many consecutive RTP packets are written
+// as a single RTP_PACKET_BATCH_EVENT, unless another event is logged first.
+const size_t kRtpPacketsPerBatch = 256;
+// A batch is also written once its first packet is this old, when the next
+// packet is logged or, if none is, by a task that checks this periodically.
+const int kMaxRtpBatchDelayMs = 500;
+// RTP headers longer than this are logged as individual RTP_EVENTs.
+const size_t kMaxBatchedRtpHeaderSize = 96;
+const size_t kFixedRtpHeaderSize = 12;
+
+// Fixed size record of an RTP packet waiting to be written as part of a batch.
+struct BatchedRtpPacket {
+  int64_t timestamp_us;
+  uint32_t packet_length;
+  int probe_cluster_id;
+  bool incoming;
+  uint8_t header_length;
+  uint8_t header[kMaxBatchedRtpHeaderSize];
+};
+
+// Returns the number of logged events |event| holds.
+size_t NumberOfLoggedEvents(const rtclog::Event& event) {
+  if (event.type() == rtclog::Event::RTP_PACKET_BATCH_EVENT)
+    return event.rtp_packet_batch().timestamp_us_deltas_size();
+  return 1;
+}
+
+// Writes |packets| as a RTP_PACKET_BATCH_EVENT, see rtc_event_log.proto for a
+// description of the columns.
+std::unique_ptr<rtclog::Event> EncodeRtpPacketBatch(
+    const std::vector<BatchedRtpPacket>& packets) {
+  RTC_DCHECK(!packets.empty());
+  std::unique_ptr<rtclog::Event> event(new rtclog::Event());
+  event->set_timestamp_us(packets.front().timestamp_us);
+  event->set_type(rtclog::Event::RTP_PACKET_BATCH_EVENT);
+  rtclog::RtpPacketBatch* batch = event->mutable_rtp_packet_batch();
+
+  const int num_packets = static_cast<int>(packets.size());
+  batch->mutable_timestamp_us_deltas()->Reserve(num_packets);
+  batch->mutable_incoming()->Reserve(num_packets);
+  batch->mutable_packet_length_deltas()->Reserve(num_packets);
+  batch->mutable_ssrc_indices()->Reserve(num_packets);
+  batch->mutable_first_header_bytes()->Reserve(num_packets);
+  batch->mutable_sequence_number_deltas()->Reserve(num_packets);
+  batch->mutable_rtp_timestamp_deltas()->Reserve(num_packets);
+  batch->mutable_header_tail_lengths()->Reserve(num_packets);
+
+  // The last sequence number and RTP timestamp seen for each SSRC and
+  // direction. A batch rarely holds more than a handful of streams, so these
+  // are searched linearly.
+  struct StreamState {
+    uint32_t ssrc_index;
+    bool incoming;
+    uint16_t sequence_number;
+    uint32_t rtp_timestamp;
+  };
+  std::vector<StreamState> streams;
+
+  int64_t previous_timestamp_us = packets.front().timestamp_us;
+  int64_t previous_packet_length = 0;
+  bool has_probes = false;
+  for (const BatchedRtpPacket& packet : packets) {
+    batch->add_timestamp_us_deltas(packet.timestamp_us - previous_timestamp_us);
+    previous_timestamp_us = packet.timestamp_us;
+    batch->add_incoming(packet.incoming);
+    batch->add_packet_length_deltas(
+        static_cast<int32_t>(packet.packet_length - previous_packet_length));
+    previous_packet_length = packet.packet_length;
+    has_probes |= packet.probe_cluster_id != PacedPacketInfo::kNotAProbe;
+
+    const uint8_t* header = packet.header;
+    batch->add_first_header_bytes((header[0] << 8) | header[1]);
+    const uint16_t sequence_number =
+        ByteReader<uint16_t>::ReadBigEndian(header + 2);
+    const uint32_t rtp_timestamp =
+        ByteReader<uint32_t>::ReadBigEndian(header + 4);
+    const uint32_t ssrc = ByteReader<uint32_t>::ReadBigEndian(header + 8);
+
+    uint32_t ssrc_index = 0;
+    while (ssrc_index < static_cast<uint32_t>(batch->ssrcs_size()) &&
+           batch->ssrcs(ssrc_index) != ssrc) {
+      ++ssrc_index;
+    }
+    if (ssrc_index == static_cast<uint32_t>(batch->ssrcs_size()))
+      batch->add_ssrcs(ssrc);
+    batch->add_ssrc_indices(ssrc_index);
+
+    auto stream = std::find_if(streams.begin(), streams.end(),
+                               [&](const StreamState& state) {
+                                 return state.ssrc_index == ssrc_index &&
+                                        state.incoming == packet.incoming;
+                               });
+    if (stream == streams.end()) {
+      batch->add_sequence_number_deltas(sequence_number);
+      batch->add_rtp_timestamp_deltas(rtp_timestamp);
+      streams.push_back(
+          {ssrc_index, packet.incoming, sequence_number, rtp_timestamp});
+    } else {
+      batch->add_sequence_number_deltas(static_cast<int16_t>(
+          static_cast<uint16_t>(sequence_number - stream->sequence_number)));
+      batch->add_rtp_timestamp_deltas(static_cast<int32_t>(
+          static_cast<uint32_t>(rtp_timestamp - stream->rtp_timestamp)));
+      stream->sequence_number = sequence_number;
+      stream->rtp_timestamp = rtp_timestamp;
+    }
+
+    RTC_DCHECK_GE(packet.header_length, kFixedRtpHeaderSize);
+    batch->add_header_tail_lengths(packet.header_length - kFixedRtpHeaderSize);
+    batch->mutable_header_tails()->append(
+        reinterpret_cast<const char*>(header + kFixedRtpHeaderSize),
+        packet.header_length - kFixedRtpHeaderSize);
+  }
+
+  if (has_probes) {
+    batch->mutable_probe_cluster_ids()->Reserve(num_packets);
+    for (const BatchedRtpPacket& packet : packets)
+      batch->add_probe_cluster_ids(packet.probe_cluster_id + 1);
+  }
+  return event;
+}
+
 bool IsConfigEvent(const rtclog::Event& event) {
   rtclog::Event_EventType event_type = event.type();
   return event_type == rtclog::Event::VIDEO_RECEIVER_CONFIG_EVENT ||
@@ -100,7 +223,7 @@ class ResourceOwningTask final : public rtc::QueuedTask {
 
 class RtcEventLogImpl final : public RtcEventLog {
  public:
-  RtcEventLogImpl();
+  explicit RtcEventLogImpl(EncodingType encoding_type);
   ~RtcEventLogImpl() override;
 
   bool StartLogging(const std::string& file_name,
@@ -143,6 +266,18 @@ class RtcEventLogImpl final : public RtcEventLog {
                             int64_t max_size_bytes);
 
   void StoreEvent(std::unique_ptr<rtclog::Event> event);
+  void PostEvent(std::unique_ptr<rtclog::Event> event);
+
+  // Posts the RTP packets collected in |rtp_batch_| to the task queue, where
+  // they are encoded and stored as a single event.
+  void FlushRtpBatch() RTC_EXCLUSIVE_LOCKS_REQUIRED(batch_lock_);
+  // Flushes |rtp_batch_| if its first packet was logged at least
+  // kMaxRtpBatchDelayMs before |now_us|.
+  void FlushRtpBatchIfExpired(int64_t now_us)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(batch_lock_);
+  // Posts a task that flushes an expired batch every kMaxRtpBatchDelayMs, so
+  // that the packets are written even when nothing else is logged.
+  void ScheduleRtpBatchFlush();
   void LogProbeResult(int id,
                       rtclog::BweProbeResult::ResultType result,
                       int bitrate_bps);
@@ -154,6 +289,7 @@ class RtcEventLogImpl final : public RtcEventLog {
                            ProtoString* output_string) RTC_WARN_UNUSED_RESULT;
 
   void LogToMemory(std::unique_ptr<rtclog::Event> event);
+  void AddToHistory(std::unique_ptr<rtclog::Event> event);
 
   void StartLogFile();
   void LogToFile(std::unique_ptr<rtclog::Event> event);
@@ -163,6 +299,16 @@ class RtcEventLogImpl final : public RtcEventLog {
   // as started/stopped - from the same thread/task-queue.
   rtc::SequencedTaskChecker owner_sequence_checker_;
 
+  const EncodingType encoding_type_;
+
+  // RTP packets waiting to be written as one batch. Only used with
+  // EncodingType::kBatched. Tasks for other events are posted while holding
+  // |batch_lock_|, after flushing the batch, so that events reach the task
+  // queue in the order they were logged.
+  rtc::CriticalSection batch_lock_;
+  std::unique_ptr<std::vector<BatchedRtpPacket>> rtp_batch_
+      RTC_GUARDED_BY(batch_lock_);
+
   // History containing all past configuration events.
   std::vector<std::unique_ptr<rtclog::Event>> config_history_
       RTC_ACCESS_ON(task_queue_);
@@ -170,6 +316,8 @@ class RtcEventLogImpl final : public RtcEventLog {
   // History containing the most recent (non-configuration) events (~10s).
   std::deque<std::unique_ptr<rtclog::Event>> history_
       RTC_ACCESS_ON(task_queue_);
+  // Number of logged events in |history_|, counting every packet of a batch.
+  size_t history_event_count_ RTC_ACCESS_ON(task_queue_);
 
   std::unique_ptr<FileWrapper> file_ RTC_ACCESS_ON(task_queue_);
 
@@ -225,11 +373,16 @@ rtclog::BweProbeResult::ResultType ConvertProbeResultType(
   return rtclog::BweProbeResult::SUCCESS;
 }
 
-RtcEventLogImpl::RtcEventLogImpl()
-    : file_(FileWrapper::Create()),
+RtcEventLogImpl::RtcEventLogImpl(EncodingType encoding_type)
+    : encoding_type_(encoding_type),
+      history_event_count_(0),
+      file_(FileWrapper::Create()),
       max_size_bytes_(std::numeric_limits<decltype(max_size_bytes_)>::max()),
       written_bytes_(0),
-      task_queue_("rtc_event_log") {}
+      task_queue_("rtc_event_log") {
+  if (encoding_type_ == EncodingType::kBatched)
+    ScheduleRtpBatchFlush();
+}
 
 RtcEventLogImpl::~RtcEventLogImpl() {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&owner_sequence_checker_);
@@ -288,6 +441,11 @@ void RtcEventLogImpl::StopLogging() {
 
   const int64_t stop_time = rtc::TimeMicros();
 
+  if (encoding_type_ == EncodingType::kBatched) {
+    rtc::CritScope lock(&batch_lock_);
+    FlushRtpBatch();
+  }
+
   rtc::Event file_finished(true, false);
 
   task_queue_.PostTask([this, stop_time, &file_finished]() {
@@ -444,6 +602,29 @@ void RtcEventLogImpl::LogRtpHeader(PacketDirection direction,
     header_length += (x_len + 1) * 4;
   }
 
+  if (encoding_type_ == EncodingType::kBatched &&
+      header_length <= kMaxBatchedRtpHeaderSize &&
+      header_length <= packet_length) {
+    const int64_t timestamp_us = rtc::TimeMicros();
+    rtc::CritScope lock(&batch_lock_);
+    FlushRtpBatchIfExpired(timestamp_us);
+    if (!rtp_batch_) {
+      rtp_batch_.reset(new std::vector<BatchedRtpPacket>());
+      rtp_batch_->reserve(kRtpPacketsPerBatch);
+    }
+    rtp_batch_->emplace_back();
+    BatchedRtpPacket& packet = rtp_batch_->back();
+    packet.timestamp_us = timestamp_us;
+    packet.packet_length = static_cast<uint32_t>(packet_length);
+    packet.probe_cluster_id = probe_cluster_id;
+    packet.incoming = direction == kIncomingPacket;
+    packet.header_length = static_cast<uint8_t>(header_length);
+    memcpy(packet.header, header, header_length);
+    if (rtp_batch_->size() >= kRtpPacketsPerBatch)
+      FlushRtpBatch();
+    return;
+  }
+
   std::unique_ptr<rtclog::Event> rtp_event(new rtclog::Event());
   rtp_event->set_timestamp_us(rtc::TimeMicros());
   rtp_event->set_type(rtclog::Event::RTP_EVENT);
@@ -608,6 +789,12 @@ void RtcEventLogImpl::StartLoggingInternal(std::unique_ptr<FileWrapper> file,
   max_size_bytes = (max_size_bytes <= 0)
                        ? std::numeric_limits<decltype(max_size_bytes)>::max()
                        : max_size_bytes;
+  if (encoding_type_ == EncodingType::kBatched) {
+    // Packets logged before logging started go to the history.
+    rtc::CritScope lock(&batch_lock_);
+    FlushRtpBatch();
+  }
+
   auto file_handler = [this,
                        max_size_bytes](std::unique_ptr<FileWrapper> file) {
     RTC_DCHECK_RUN_ON(&task_queue_);
@@ -626,7 +813,16 @@ void RtcEventLogImpl::StartLoggingInternal(std::unique_ptr<FileWrapper> file,
 
 void RtcEventLogImpl::StoreEvent(std::unique_ptr<rtclog::Event> event) {
   RTC_DCHECK(event);
+  if (encoding_type_ == EncodingType::kBatched) {
+    rtc::CritScope lock(&batch_lock_);
+    FlushRtpBatch();
+    PostEvent(std::move(event));
+    return;
+  }
+  PostEvent(std::move(event));
+}
 
+void RtcEventLogImpl::PostEvent(std::unique_ptr<rtclog::Event> event) {
   auto event_handler = [this](std::unique_ptr<rtclog::Event> rtclog_event) {
     RTC_DCHECK_RUN_ON(&task_queue_);
     if (file_->is_open()) {
@@ -640,6 +836,47 @@ void RtcEventLogImpl::StoreEvent(std::unique_ptr<rtclog::Event> event) {
       std::move(event), event_handler));
 }
 
+void RtcEventLogImpl::FlushRtpBatch() {
+  if (!rtp_batch_ || rtp_batch_->empty())
+    return;
+
+  auto batch_handler =
+      [this](std::unique_ptr<std::vector<BatchedRtpPacket>> packets) {
+        RTC_DCHECK_RUN_ON(&task_queue_);
+        std::unique_ptr<rtclog::Event> event = EncodeRtpPacketBatch(*packets);
+        if (file_->is_open()) {
+          LogToFile(std::move(event));
+        } else {
+          LogToMemory(std::move(event));
+        }
+      };
+
+  task_queue_.PostTask(
+      rtc::MakeUnique<ResourceOwningTask<std::vector<BatchedRtpPacket>>>(
+          std::move(rtp_batch_), batch_handler));
+}
+
+void RtcEventLogImpl::FlushRtpBatchIfExpired(int64_t now_us) {
+  if (rtp_batch_ && !rtp_batch_->empty() &&
+      now_us - rtp_batch_->front().timestamp_us >=
+          kMaxRtpBatchDelayMs * rtc::kNumMicrosecsPerMillisec) {
+    FlushRtpBatch();
+  }
+}
+
+void RtcEventLogImpl::ScheduleRtpBatchFlush() {
+  task_queue_.PostDelayedTask(
+      [this] {
+        RTC_DCHECK_RUN_ON(&task_queue_);
+        {
+          rtc::CritScope lock(&batch_lock_);
+          FlushRtpBatchIfExpired(rtc::TimeMicros());
+        }
+        ScheduleRtpBatchFlush();
+      },
+      kMaxRtpBatchDelayMs);
+}
+
 bool RtcEventLogImpl::AppendEventToString(rtclog::Event* event,
                                           ProtoString* output_string) {
   RTC_DCHECK_RUN_ON(&task_queue_);
@@ -681,10 +918,17 @@ void RtcEventLogImpl::LogToMemory(std::unique_ptr<rtclog::Event> event) {
   if (IsConfigEvent(*event.get())) {
     config_history_.push_back(std::move(event));
   } else {
-    history_.push_back(std::move(event));
-    if (history_.size() > kEventsInHistory) {
-      history_.pop_front();
-    }
+    AddToHistory(std::move(event));
+  }
+}
+
+void RtcEventLogImpl::AddToHistory(std::unique_ptr<rtclog::Event> event) {
+  RTC_DCHECK_RUN_ON(&task_queue_);
+  history_event_count_ += NumberOfLoggedEvents(*event);
+  history_.push_back(std::move(event));
+  while (history_event_count_ > kEventsInHistory) {
+    history_event_count_ -= NumberOfLoggedEvents(*history_.front());
+    history_.pop_front();
   }
 }
 
@@ -719,6 +963,7 @@ void RtcEventLogImpl::StartLogFile() {
       // Known issue - if writing to the file fails, these events will have
       // been lost. If we try to open a new file, these events will be missing
       // from it.
+      history_event_count_ -= NumberOfLoggedEvents(*history_.front());
       history_.pop_front();
     }
   }
@@ -752,7 +997,8 @@ void RtcEventLogImpl::LogToFile(std::unique_ptr<rtclog::Event> event) {
 
   if (!appended) {
     RTC_DCHECK(file_->is_open());
-    history_.push_back(std::move(event));
+    if (event)
+      AddToHistory(std::move(event));
     StopLogFile(rtc::TimeMicros());
     return;
   }
@@ -800,6 +1046,10 @@ void RtcEventLogImpl::StopLogFile(int64_t stop_time) {
 
 // RtcEventLog member functions.
 std::unique_ptr<RtcEventLog> RtcEventLog::Create() {
+  return Create(EncodingType::kLegacy);
+}
+
+std::unique_ptr<RtcEventLog> RtcEventLog::Create(EncodingType encoding_type) {
 #ifdef ENABLE_RTC_EVENT_LOG
     // TODO(eladalon): Known issue - there's a race over |rtc_event_log_count|.
   constexpr int kMaxLogCount = 5;
@@ -810,7 +1060,7 @@ std::unique_ptr<RtcEventLog> RtcEventLog::Create() {
     std::atomic_fetch_sub(&rtc_event_log_count, 1);
     return CreateNull();
   }
-  return rtc::MakeUnique<RtcEventLogImpl>();
+  return rtc::MakeUnique<RtcEventLogImpl>(encoding_type);
 #else
   return CreateNull();
 #endif  // ENABLE_RTC_EVENT_LOG
@@ -43,10 +43,20 @@ enum ProbeFailureReason {
 
 class RtcEventLog {
  public:
+  // How events are written to the log. kLegacy writes one protobuf message
+  // per event. kBatched collects consecutive RTP packets and writes them as
+  // a single RTP_PACKET_BATCH_EVENT with delta encoded columns, which is
+  // considerably cheaper to produce and smaller on disk. A packet waits at
+  // most about a second before its batch is written. ParsedRtcEventLog reads
+  // both. The event logs of a PeerConnectionFactory use kBatched when the
+  // field trial "WebRTC-RtcEventLogBatchedEncoding" is enabled.
+  enum class EncodingType { kLegacy, kBatched };
+
   virtual ~RtcEventLog() {}
 
   // Factory method to create an RtcEventLog object.
   static std::unique_ptr<RtcEventLog> Create();
+  static std::unique_ptr<RtcEventLog> Create(EncodingType encoding_type);
   // TODO(nisse): webrtc::Clock is deprecated. Delete this method and
   // above forward declaration of Clock when
   // webrtc/system_wrappers/include/clock.h is deleted.
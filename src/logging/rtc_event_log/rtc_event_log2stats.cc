@@ -162,6 +162,8 @@ std::string EventTypeToString(webrtc::rtclog::Event::EventType event_type) {
       return "BWE_PROBE_CREATED";
     case webrtc::rtclog::Event::BWE_PROBE_RESULT_EVENT:
       return "BWE_PROBE_RESULT";
+    case webrtc::rtclog::Event::RTP_PACKET_BATCH_EVENT:
+      return "RTP_PACKET_BATCH";
   }
   RTC_NOTREACHED();
   return "UNKNOWN_EVENT";
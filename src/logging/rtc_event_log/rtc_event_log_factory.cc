@@ -11,11 +11,19 @@
 #include "logging/rtc_event_log/rtc_event_log_factory.h"
 
 #include "logging/rtc_event_log/rtc_event_log.h"
+#include "system_wrappers/include/field_trial.h"
 
 namespace webrtc {
 
+namespace {
+const char kBatchedEncodingFieldTrial[] = "WebRTC-RtcEventLogBatchedEncoding";
+}  // namespace
+
 std::unique_ptr<RtcEventLog> RtcEventLogFactory::CreateRtcEventLog() {
-  return RtcEventLog::Create();
+  return RtcEventLog::Create(
+      field_trial::IsEnabled(kBatchedEncodingFieldTrial)
+          ? RtcEventLog::EncodingType::kBatched
+          : RtcEventLog::EncodingType::kLegacy);
 }
 
 std::unique_ptr<RtcEventLogFactoryInterface> CreateRtcEventLogFactory() {
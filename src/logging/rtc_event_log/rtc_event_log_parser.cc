@@ -13,9 +13,17 @@
 #include <stdint.h>
 #include <string.h>
 
+#if defined(WEBRTC_POSIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <algorithm>
 #include <fstream>
 #include <istream>
+#include <limits>
 #include <map>
 #include <utility>
 
@@ -24,6 +32,7 @@
 #include "modules/remote_bitrate_estimator/include/bwe_defines.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/constructormagic.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/protobuf_utils.h"
 
@@ -74,6 +83,9 @@ ParsedRtcEventLog::EventType GetRuntimeEventType(
       return ParsedRtcEventLog::EventType::BWE_PROBE_CLUSTER_CREATED_EVENT;
     case rtclog::Event::BWE_PROBE_RESULT_EVENT:
       return ParsedRtcEventLog::EventType::BWE_PROBE_RESULT_EVENT;
+    case rtclog::Event::RTP_PACKET_BATCH_EVENT:
+      // Batches are expanded into RTP_EVENTs while parsing.
+      return ParsedRtcEventLog::EventType::UNKNOWN_EVENT;
   }
   return ParsedRtcEventLog::EventType::UNKNOWN_EVENT;
 }
@@ -113,6 +125,132 @@ std::pair<uint64_t, bool> ParseVarInt(std::istream& stream) {
   return std::make_pair(varint, false);
 }
 
+std::pair<uint64_t, bool> ParseVarInt(const uint8_t* data,
+                                      size_t size,
+                                      size_t* offset) {
+  uint64_t varint = 0;
+  for (size_t bytes_read = 0; bytes_read < 10; ++bytes_read) {
+    if (*offset == size) {
+      return std::make_pair(varint, false);
+    }
+    uint8_t byte = data[(*offset)++];
+    varint |= static_cast<uint64_t>(byte & 0x7F) << (7 * bytes_read);
+    if ((byte & 0x80) == 0) {
+      return std::make_pair(varint, true);
+    }
+  }
+  return std::make_pair(varint, false);
+}
+
+bool IsEventTypeSelected(
+    ParsedRtcEventLog::EventType type,
+    const std::vector<ParsedRtcEventLog::EventType>& event_types) {
+  return event_types.empty() ||
+         std::find(event_types.begin(), event_types.end(), type) !=
+             event_types.end();
+}
+
+// Appends one RTP_EVENT per packet in the RTP_PACKET_BATCH_EVENT |event| to
+// |events|. Returns false if the batch is malformed.
+bool ExpandRtpPacketBatch(const rtclog::Event& event,
+                          std::vector<rtclog::Event>* events) {
+  if (!event.has_rtp_packet_batch()) {
+    LOG(LS_WARNING) << "RTP packet batch event without packets.";
+    return false;
+  }
+  const rtclog::RtpPacketBatch& batch = event.rtp_packet_batch();
+  const int num_packets = batch.timestamp_us_deltas_size();
+  if (batch.incoming_size() != num_packets ||
+      batch.packet_length_deltas_size() != num_packets ||
+      batch.ssrc_indices_size() != num_packets ||
+      batch.first_header_bytes_size() != num_packets ||
+      batch.sequence_number_deltas_size() != num_packets ||
+      batch.rtp_timestamp_deltas_size() != num_packets ||
+      batch.header_tail_lengths_size() != num_packets ||
+      (batch.probe_cluster_ids_size() != 0 &&
+       batch.probe_cluster_ids_size() != num_packets)) {
+    LOG(LS_WARNING) << "RTP packet batch with columns of different lengths.";
+    return false;
+  }
+
+  // The last sequence number and RTP timestamp for each SSRC index and
+  // direction, see |EncodeRtpPacketBatch|.
+  struct StreamState {
+    uint32_t ssrc_index;
+    bool incoming;
+    uint16_t sequence_number;
+    uint32_t rtp_timestamp;
+  };
+  std::vector<StreamState> streams;
+
+  const size_t kFixedRtpHeaderSize = 12;
+  const std::string& header_tails = batch.header_tails();
+  size_t header_tail_offset = 0;
+  int64_t timestamp_us = event.timestamp_us();
+  int64_t packet_length = 0;
+  for (int i = 0; i < num_packets; ++i) {
+    timestamp_us += batch.timestamp_us_deltas(i);
+    packet_length += batch.packet_length_deltas(i);
+    const bool incoming = batch.incoming(i);
+    const uint32_t ssrc_index = batch.ssrc_indices(i);
+    const size_t header_tail_length = batch.header_tail_lengths(i);
+    if (ssrc_index >= static_cast<uint32_t>(batch.ssrcs_size()) ||
+        header_tail_length > header_tails.size() - header_tail_offset ||
+        kFixedRtpHeaderSize + header_tail_length > IP_PACKET_SIZE ||
+        packet_length < 0) {
+      LOG(LS_WARNING) << "Malformed packet in RTP packet batch.";
+      return false;
+    }
+
+    uint16_t sequence_number;
+    uint32_t rtp_timestamp;
+    auto stream = std::find_if(streams.begin(), streams.end(),
+                               [&](const StreamState& state) {
+                                 return state.ssrc_index == ssrc_index &&
+                                        state.incoming == incoming;
+                               });
+    if (stream == streams.end()) {
+      sequence_number =
+          static_cast<uint16_t>(batch.sequence_number_deltas(i));
+      rtp_timestamp = static_cast<uint32_t>(batch.rtp_timestamp_deltas(i));
+      streams.push_back({ssrc_index, incoming, sequence_number, rtp_timestamp});
+    } else {
+      sequence_number = static_cast<uint16_t>(
+          stream->sequence_number + batch.sequence_number_deltas(i));
+      rtp_timestamp = static_cast<uint32_t>(stream->rtp_timestamp +
+                                            batch.rtp_timestamp_deltas(i));
+      stream->sequence_number = sequence_number;
+      stream->rtp_timestamp = rtp_timestamp;
+    }
+
+    uint8_t fixed_header[kFixedRtpHeaderSize];
+    const uint32_t first_header_bytes = batch.first_header_bytes(i);
+    fixed_header[0] = static_cast<uint8_t>(first_header_bytes >> 8);
+    fixed_header[1] = static_cast<uint8_t>(first_header_bytes);
+    ByteWriter<uint16_t>::WriteBigEndian(fixed_header + 2, sequence_number);
+    ByteWriter<uint32_t>::WriteBigEndian(fixed_header + 4, rtp_timestamp);
+    ByteWriter<uint32_t>::WriteBigEndian(fixed_header + 8,
+                                         batch.ssrcs(ssrc_index));
+
+    events->emplace_back();
+    rtclog::Event& rtp_event = events->back();
+    rtp_event.set_timestamp_us(timestamp_us);
+    rtp_event.set_type(rtclog::Event::RTP_EVENT);
+    rtclog::RtpPacket* rtp_packet = rtp_event.mutable_rtp_packet();
+    rtp_packet->set_incoming(incoming);
+    rtp_packet->set_packet_length(static_cast<uint32_t>(packet_length));
+    std::string* header = rtp_packet->mutable_header();
+    header->reserve(kFixedRtpHeaderSize + header_tail_length);
+    header->assign(reinterpret_cast<const char*>(fixed_header),
+                   kFixedRtpHeaderSize);
+    header->append(header_tails, header_tail_offset, header_tail_length);
+    header_tail_offset += header_tail_length;
+    if (batch.probe_cluster_ids_size() != 0 && batch.probe_cluster_ids(i) != 0)
+      rtp_packet->set_probe_cluster_id(batch.probe_cluster_ids(i) - 1);
+  }
+  return true;
+}
+
 void GetHeaderExtensions(
     std::vector<RtpExtension>* header_extensions,
     const RepeatedPtrField<rtclog::RtpHeaderExtension>&
@@ -129,14 +267,67 @@ void GetHeaderExtensions(
 
 }  // namespace
 
-bool ParsedRtcEventLog::ParseFile(const std::string& filename) {
-  std::ifstream file(filename, std::ios_base::in | std::ios_base::binary);
-  if (!file.good() || !file.is_open()) {
-    LOG(LS_WARNING) << "Could not open file for reading.";
-    return false;
+// Read-only memory mapping of a whole log file.
+class ParsedRtcEventLog::MappedFile {
+ public:
+  // Returns nullptr if the file can't be mapped.
+  static std::unique_ptr<MappedFile> Open(const std::string& file_name) {
+#if defined(WEBRTC_POSIX)
+    int fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0)
+      return nullptr;
+    struct stat file_info;
+    if (fstat(fd, &file_info) != 0) {
+      close(fd);
+      return nullptr;
+    }
+    size_t size = static_cast<size_t>(file_info.st_size);
+    void* data = nullptr;
+    if (size > 0) {
+      data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        close(fd);
+        return nullptr;
+      }
+      // The log is read from start to end exactly once.
+      madvise(data, size, MADV_SEQUENTIAL);
+    }
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+    return std::unique_ptr<MappedFile>(
+        new MappedFile(static_cast<const uint8_t*>(data), size));
+#else
+    return nullptr;
+#endif
   }
 
-  return ParseStream(file);
+  ~MappedFile() {
+#if defined(WEBRTC_POSIX)
+    if (data_)
+      munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+  }
+
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  MappedFile(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  const uint8_t* const data_;
+  const size_t size_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(MappedFile);
+};
+
+ParsedRtcEventLog::ParsedRtcEventLog() = default;
+
+ParsedRtcEventLog::~ParsedRtcEventLog() = default;
+
+bool ParsedRtcEventLog::ParseFile(const std::string& filename) {
+  if (!StartParsingFile(filename, false))
+    return false;
+  return ParseNextEvents(std::numeric_limits<size_t>::max(), {});
 }
 
 bool ParsedRtcEventLog::ParseString(const std::string& s) {
@@ -145,113 +336,236 @@ bool ParsedRtcEventLog::ParseString(const std::string& s) {
 }
 
 bool ParsedRtcEventLog::ParseStream(std::istream& stream) {
+  RTC_DCHECK(stream.good());
+  CloseLog();
+  stream_ = &stream;
+  end_of_log_ = false;
+  return ParseNextEvents(std::numeric_limits<size_t>::max(), {});
+}
+
+bool ParsedRtcEventLog::StartParsingFile(const std::string& file_name,
+                                         bool memory_map) {
+  CloseLog();
   events_.clear();
+  if (memory_map) {
+    mapped_file_ = MappedFile::Open(file_name);
+    if (!mapped_file_) {
+      LOG(LS_WARNING) << "Could not map file, reading it instead.";
+    }
+  }
+  if (!mapped_file_) {
+    owned_stream_.reset(new std::ifstream(
+        file_name, std::ios_base::in | std::ios_base::binary));
+    if (!owned_stream_->good()) {
+      LOG(LS_WARNING) << "Could not open file for reading.";
+      owned_stream_.reset();
+      return false;
+    }
+    stream_ = owned_stream_.get();
+  }
+  end_of_log_ = false;
+  return true;
+}
+
+bool ParsedRtcEventLog::ParseNextEvents(
+    size_t max_events,
+    const std::vector<EventType>& event_types) {
+  events_.clear();
+  rtclog::Event event;
+  while (events_.size() < max_events) {
+    if (next_pending_event_ < pending_events_.size()) {
+      rtclog::Event& rtp_event = pending_events_[next_pending_event_++];
+      if (IsEventTypeSelected(RTP_EVENT, event_types))
+        events_.push_back(std::move(rtp_event));
+      continue;
+    }
+    pending_events_.clear();
+    next_pending_event_ = 0;
+
+    switch (ReadNextEvent(&event)) {
+      case ReadResult::kEvent:
+        break;
+      case ReadResult::kEndOfLog:
+        CloseLog();
+        return true;
+      case ReadResult::kError:
+        CloseLog();
+        return false;
+    }
+
+    if (event.type() == rtclog::Event::RTP_PACKET_BATCH_EVENT) {
+      if (!ExpandRtpPacketBatch(event, &pending_events_)) {
+        CloseLog();
+        return false;
+      }
+      continue;
+    }
+
+    EventType type = GetRuntimeEventType(event.type());
+    AddStreams(type, event);
+    if (IsEventTypeSelected(type, event_types))
+      events_.push_back(std::move(event));
+  }
+  return true;
+}
+
+bool ParsedRtcEventLog::AtEndOfLog() const {
+  return end_of_log_;
+}
+
+ParsedRtcEventLog::ReadResult ParsedRtcEventLog::ReadNextEvent(
+    rtclog::Event* event) {
   const size_t kMaxEventSize = (1u << 16) - 1;
-  std::vector<char> tmp_buffer(kMaxEventSize);
+  // The tag number is defined as (fieldnumber << 3) | wire_type. In our case,
+  // the field number is supposed to be 1 and the wire type for an
+  // length-delimited field is 2.
+  const uint64_t kExpectedTag = (1 << 3) | 2;
   uint64_t tag;
   uint64_t message_length;
   bool success;
 
-  RTC_DCHECK(stream.good());
+  if (end_of_log_)
+    return ReadResult::kEndOfLog;
 
-  while (1) {
-    // Check whether we have reached end of file.
-    stream.peek();
-    if (stream.eof()) {
-      // Process all extensions maps for faster look-up later.
-      for (auto& event_stream : streams_) {
-        rtp_extensions_maps_[StreamId(event_stream.ssrc,
-                                      event_stream.direction)] =
-            &event_stream.rtp_extensions_map;
-      }
-      return true;
-    }
+  if (mapped_file_) {
+    const uint8_t* data = mapped_file_->data();
+    const size_t size = mapped_file_->size();
+    if (mapped_offset_ == size)
+      return ReadResult::kEndOfLog;
 
-    // Read the next message tag. The tag number is defined as
-    // (fieldnumber << 3) | wire_type. In our case, the field number is
-    // supposed to be 1 and the wire type for an
-    // length-delimited field is 2.
-    const uint64_t kExpectedTag = (1 << 3) | 2;
-    std::tie(tag, success) = ParseVarInt(stream);
+    std::tie(tag, success) = ParseVarInt(data, size, &mapped_offset_);
     if (!success) {
       LOG(LS_WARNING) << "Missing field tag from beginning of protobuf event.";
-      return false;
+      return ReadResult::kError;
     } else if (tag != kExpectedTag) {
       LOG(LS_WARNING) << "Unexpected field tag at beginning of protobuf event.";
-      return false;
+      return ReadResult::kError;
     }
-
-    // Read the length field.
-    std::tie(message_length, success) = ParseVarInt(stream);
+    std::tie(message_length, success) =
+        ParseVarInt(data, size, &mapped_offset_);
     if (!success) {
       LOG(LS_WARNING) << "Missing message length after protobuf field tag.";
-      return false;
+      return ReadResult::kError;
     } else if (message_length > kMaxEventSize) {
       LOG(LS_WARNING) << "Protobuf message length is too large.";
-      return false;
-    }
-
-    // Read the next protobuf event to a temporary char buffer.
-    stream.read(tmp_buffer.data(), message_length);
-    if (stream.gcount() != static_cast<int>(message_length)) {
+      return ReadResult::kError;
+    } else if (message_length > size - mapped_offset_) {
       LOG(LS_WARNING) << "Failed to read protobuf message from file.";
-      return false;
+      return ReadResult::kError;
     }
 
-    // Parse the protobuf event from the buffer.
-    rtclog::Event event;
-    if (!event.ParseFromArray(tmp_buffer.data(), message_length)) {
+    // Parse straight from the mapping, without copying the message.
+    if (!event->ParseFromArray(data + mapped_offset_, message_length)) {
       LOG(LS_WARNING) << "Failed to parse protobuf message.";
-      return false;
+      return ReadResult::kError;
     }
+    mapped_offset_ += message_length;
+    return ReadResult::kEvent;
+  }
 
-    EventType type = GetRuntimeEventType(event.type());
-    switch (type) {
-      case VIDEO_RECEIVER_CONFIG_EVENT: {
-        rtclog::StreamConfig config = GetVideoReceiveConfig(event);
-        streams_.emplace_back(config.remote_ssrc, MediaType::VIDEO,
-                              kIncomingPacket,
-                              RtpHeaderExtensionMap(config.rtp_extensions));
-        streams_.emplace_back(config.local_ssrc, MediaType::VIDEO,
-                              kOutgoingPacket,
-                              RtpHeaderExtensionMap(config.rtp_extensions));
-        break;
-      }
-      case VIDEO_SENDER_CONFIG_EVENT: {
-        std::vector<rtclog::StreamConfig> configs = GetVideoSendConfig(event);
-        for (size_t i = 0; i < configs.size(); i++) {
-          streams_.emplace_back(
-              configs[i].local_ssrc, MediaType::VIDEO, kOutgoingPacket,
-              RtpHeaderExtensionMap(configs[i].rtp_extensions));
-
-          streams_.emplace_back(
-              configs[i].rtx_ssrc, MediaType::VIDEO, kOutgoingPacket,
-              RtpHeaderExtensionMap(configs[i].rtp_extensions));
-        }
-        break;
-      }
-      case AUDIO_RECEIVER_CONFIG_EVENT: {
-        rtclog::StreamConfig config = GetAudioReceiveConfig(event);
-        streams_.emplace_back(config.remote_ssrc, MediaType::AUDIO,
-                              kIncomingPacket,
-                              RtpHeaderExtensionMap(config.rtp_extensions));
-        streams_.emplace_back(config.local_ssrc, MediaType::AUDIO,
-                              kOutgoingPacket,
-                              RtpHeaderExtensionMap(config.rtp_extensions));
-        break;
-      }
-      case AUDIO_SENDER_CONFIG_EVENT: {
-        rtclog::StreamConfig config = GetAudioSendConfig(event);
-        streams_.emplace_back(config.local_ssrc, MediaType::AUDIO,
-                              kOutgoingPacket,
-                              RtpHeaderExtensionMap(config.rtp_extensions));
-        break;
+  RTC_DCHECK(stream_);
+  // Check whether we have reached end of file.
+  stream_->peek();
+  if (stream_->eof())
+    return ReadResult::kEndOfLog;
+
+  std::tie(tag, success) = ParseVarInt(*stream_);
+  if (!success) {
+    LOG(LS_WARNING) << "Missing field tag from beginning of protobuf event.";
+    return ReadResult::kError;
+  } else if (tag != kExpectedTag) {
+    LOG(LS_WARNING) << "Unexpected field tag at beginning of protobuf event.";
+    return ReadResult::kError;
+  }
+
+  // Read the length field.
+  std::tie(message_length, success) = ParseVarInt(*stream_);
+  if (!success) {
+    LOG(LS_WARNING) << "Missing message length after protobuf field tag.";
+    return ReadResult::kError;
+  } else if (message_length > kMaxEventSize) {
+    LOG(LS_WARNING) << "Protobuf message length is too large.";
+    return ReadResult::kError;
+  }
+
+  // Read the next protobuf event to a temporary char buffer.
+  read_buffer_.resize(kMaxEventSize);
+  stream_->read(read_buffer_.data(), message_length);
+  if (stream_->gcount() != static_cast<int>(message_length)) {
+    LOG(LS_WARNING) << "Failed to read protobuf message from file.";
+    return ReadResult::kError;
+  }
+
+  // Parse the protobuf event from the buffer.
+  if (!event->ParseFromArray(read_buffer_.data(), message_length)) {
+    LOG(LS_WARNING) << "Failed to parse protobuf message.";
+    return ReadResult::kError;
+  }
+  return ReadResult::kEvent;
+}
+
+void ParsedRtcEventLog::CloseLog() {
+  owned_stream_.reset();
+  stream_ = nullptr;
+  mapped_file_.reset();
+  mapped_offset_ = 0;
+  pending_events_.clear();
+  next_pending_event_ = 0;
+  end_of_log_ = true;
+}
+
+void ParsedRtcEventLog::AddStreams(EventType type,
+                                   const rtclog::Event& event) {
+  switch (type) {
+    case VIDEO_RECEIVER_CONFIG_EVENT: {
+      rtclog::StreamConfig config = GetVideoReceiveConfig(event);
+      streams_.emplace_back(config.remote_ssrc, MediaType::VIDEO,
+                            kIncomingPacket,
+                            RtpHeaderExtensionMap(config.rtp_extensions));
+      streams_.emplace_back(config.local_ssrc, MediaType::VIDEO,
+                            kOutgoingPacket,
+                            RtpHeaderExtensionMap(config.rtp_extensions));
+      break;
+    }
+    case VIDEO_SENDER_CONFIG_EVENT: {
+      std::vector<rtclog::StreamConfig> configs = GetVideoSendConfig(event);
+      for (size_t i = 0; i < configs.size(); i++) {
+        streams_.emplace_back(
+            configs[i].local_ssrc, MediaType::VIDEO, kOutgoingPacket,
+            RtpHeaderExtensionMap(configs[i].rtp_extensions));
+
+        streams_.emplace_back(
+            configs[i].rtx_ssrc, MediaType::VIDEO, kOutgoingPacket,
+            RtpHeaderExtensionMap(configs[i].rtp_extensions));
       }
-      default:
-        break;
+      break;
     }
+    case AUDIO_RECEIVER_CONFIG_EVENT: {
+      rtclog::StreamConfig config = GetAudioReceiveConfig(event);
+      streams_.emplace_back(config.remote_ssrc, MediaType::AUDIO,
+                            kIncomingPacket,
+                            RtpHeaderExtensionMap(config.rtp_extensions));
+      streams_.emplace_back(config.local_ssrc, MediaType::AUDIO,
+                            kOutgoingPacket,
+                            RtpHeaderExtensionMap(config.rtp_extensions));
+      break;
+    }
+    case AUDIO_SENDER_CONFIG_EVENT: {
+      rtclog::StreamConfig config = GetAudioSendConfig(event);
+      streams_.emplace_back(config.local_ssrc, MediaType::AUDIO,
+                            kOutgoingPacket,
+                            RtpHeaderExtensionMap(config.rtp_extensions));
+      break;
+    }
+    default:
+      return;
+  }
 
-    events_.push_back(event);
+  // Adding streams may have moved the extension maps, so all pointers to them
+  // are refreshed. Later configurations of an SSRC replace earlier ones.
+  for (auto& event_stream : streams_) {
+    rtp_extensions_maps_[StreamId(event_stream.ssrc, event_stream.direction)] =
+        &event_stream.rtp_extensions_map;
   }
 }
 
@@ -11,6 +11,7 @@
 #define LOGGING_RTC_EVENT_LOG_RTC_EVENT_LOG_PARSER_H_
 
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>  // pair
 #include <vector>
@@ -81,6 +82,9 @@ class ParsedRtcEventLog {
 
   enum class MediaType { ANY, AUDIO, VIDEO, DATA };
 
+  ParsedRtcEventLog();
+  ~ParsedRtcEventLog();
+
   // Reads an RtcEventLog file and returns true if parsing was successful.
   bool ParseFile(const std::string& file_name);
 
@@ -90,6 +94,25 @@ class ParsedRtcEventLog {
   // Reads an RtcEventLog from an istream and returns true if successful.
   bool ParseStream(std::istream& stream);
 
+  // Incremental parsing, for logs that are too large to keep in memory.
+  // StartParsingFile() opens the log, and every call to ParseNextEvents()
+  // replaces the parsed events with the ones that follow, so the accessors
+  // below only see the events of the latest call. Stream configurations are
+  // remembered across calls, so RTP headers can be parsed in any chunk.
+  //
+  // If |memory_map| is true, the file is mapped into memory and events are
+  // parsed in place. Where that isn't supported the file is read as usual.
+  bool StartParsingFile(const std::string& file_name, bool memory_map);
+
+  // Parses up to |max_events| events, keeping only the types listed in
+  // |event_types|, or every event if it is empty. Returns false if the log
+  // is malformed, in which case the events parsed before the error are kept.
+  bool ParseNextEvents(size_t max_events,
+                       const std::vector<EventType>& event_types);
+
+  // Returns true once all events of the log have been parsed.
+  bool AtEndOfLog() const;
+
   // Returns the number of events in an EventStream.
   size_t GetNumberOfEvents() const;
 
@@ -176,6 +199,15 @@ class ParsedRtcEventLog {
   MediaType GetMediaType(uint32_t ssrc, PacketDirection direction) const;
 
  private:
+  class MappedFile;
+  enum class ReadResult { kEvent, kEndOfLog, kError };
+
+  // Reads the next protobuf event of the open log.
+  ReadResult ReadNextEvent(rtclog::Event* event);
+  void CloseLog();
+  // Tracks the streams configured by |event|, if it is a config event.
+  void AddStreams(EventType type, const rtclog::Event& event);
+
   rtclog::StreamConfig GetVideoReceiveConfig(const rtclog::Event& event) const;
   std::vector<rtclog::StreamConfig> GetVideoSendConfig(
       const rtclog::Event& event) const;
@@ -184,6 +216,18 @@ class ParsedRtcEventLog {
 
   std::vector<rtclog::Event> events_;
 
+  // The log being parsed, either through |stream_| or mapped into memory.
+  std::unique_ptr<std::istream> owned_stream_;
+  std::istream* stream_ = nullptr;
+  std::unique_ptr<MappedFile> mapped_file_;
+  size_t mapped_offset_ = 0;
+  std::vector<char> read_buffer_;
+  bool end_of_log_ = true;
+
+  // RTP events expanded from a packet batch that haven't been returned yet.
+  std::vector<rtclog::Event> pending_events_;
+  size_t next_pending_event_ = 0;
+
   struct Stream {
     Stream(uint32_t ssrc,
            MediaType media_type,
@@ -29,7 +29,9 @@
 #include "rtc_base/buffer.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/fakeclock.h"
+#include "rtc_base/logging.h"
 #include "rtc_base/random.h"
+#include "rtc_base/timeutils.h"
 #include "test/gtest.h"
 #include "test/testsupport/fileutils.h"
 
@@ -240,7 +242,8 @@ void LogSessionAndReadBack(size_t rtp_count,
                            size_t bwe_loss_count,
                            uint32_t extensions_bitvector,
                            uint32_t csrcs_count,
-                           unsigned int random_seed) {
+                           unsigned int random_seed,
+                           RtcEventLog::EncodingType encoding_type) {
   ASSERT_LE(rtcp_count, rtp_count);
   ASSERT_LE(playout_count, rtp_count);
   ASSERT_LE(bwe_loss_count, rtp_count);
@@ -296,7 +299,8 @@ void LogSessionAndReadBack(size_t rtp_count,
   {
     rtc::ScopedFakeClock fake_clock;
     fake_clock.SetTimeMicros(prng.Rand<uint32_t>());
-    std::unique_ptr<RtcEventLog> log_dumper(RtcEventLog::Create());
+    std::unique_ptr<RtcEventLog> log_dumper(
+        RtcEventLog::Create(encoding_type));
     log_dumper->LogVideoReceiveStreamConfig(receiver_config);
     fake_clock.AdvanceTimeMicros(prng.Rand(1, 1000));
     log_dumper->LogVideoSendStreamConfig(sender_config);
@@ -398,10 +402,10 @@ void LogSessionAndReadBack(size_t rtp_count,
   remove(temp_filename.c_str());
 }
 
-TEST(RtcEventLogTest, LogSessionAndReadBack) {
+void LogSessionsAndReadBack(RtcEventLog::EncodingType encoding_type) {
   // Log 5 RTP, 2 RTCP, 0 playout events and 0 BWE events
   // with no header extensions or CSRCS.
-  LogSessionAndReadBack(5, 2, 0, 0, 0, 0, 321);
+  LogSessionAndReadBack(5, 2, 0, 0, 0, 0, 321, encoding_type);
 
   // Enable AbsSendTime and TransportSequenceNumbers.
   uint32_t extensions = 0;
@@ -412,10 +416,12 @@ TEST(RtcEventLogTest, LogSessionAndReadBack) {
       extensions |= 1u << i;
     }
   }
-  LogSessionAndReadBack(8, 2, 0, 0, extensions, 0, 3141592653u);
+  LogSessionAndReadBack(8, 2, 0, 0, extensions, 0, 3141592653u,
+                        encoding_type);
 
   extensions = (1u << kNumExtensions) - 1;  // Enable all header extensions.
-  LogSessionAndReadBack(9, 2, 3, 2, extensions, 2, 2718281828u);
+  LogSessionAndReadBack(9, 2, 3, 2, extensions, 2, 2718281828u,
+                        encoding_type);
 
   // Try all combinations of header extensions and up to 2 CSRCS.
   for (extensions = 0; extensions < (1u << kNumExtensions); extensions++) {
@@ -426,8 +432,324 @@ TEST(RtcEventLogTest, LogSessionAndReadBack) {
                             1 + csrcs_count,  // Number of BWE loss events.
                             extensions,       // Bit vector choosing extensions.
                             csrcs_count,      // Number of contributing sources.
-                            extensions * 3 + csrcs_count + 1);  // Random seed.
+                            extensions * 3 + csrcs_count + 1,  // Random seed.
+                            encoding_type);
+    }
+  }
+}
+
+TEST(RtcEventLogTest, LogSessionAndReadBack) {
+  LogSessionsAndReadBack(RtcEventLog::EncodingType::kLegacy);
+}
+
+TEST(RtcEventLogTest, LogSessionAndReadBackBatched) {
+  LogSessionsAndReadBack(RtcEventLog::EncodingType::kBatched);
+}
+
+// Generates the headers of |num_packets| packets of a video stream, its
+// retransmissions and an audio stream, the way a sender would produce them.
+// The sequence numbers of the video stream wrap around.
+std::vector<RtpPacketToSend> GenerateRtpStreams(
+    const RtpHeaderExtensionMap* extensions,
+    size_t num_packets,
+    Random* prng) {
+  const uint32_t kVideoSsrc = prng->Rand<uint32_t>();
+  const uint32_t kRtxSsrc = prng->Rand<uint32_t>();
+  const uint32_t kAudioSsrc = prng->Rand<uint32_t>();
+  uint16_t video_sequence_number = 0xffff - 100;
+  uint16_t rtx_sequence_number = prng->Rand<uint16_t>();
+  uint16_t audio_sequence_number = prng->Rand<uint16_t>();
+  uint32_t video_timestamp = prng->Rand<uint32_t>();
+  uint32_t audio_timestamp = prng->Rand<uint32_t>();
+  uint16_t transport_sequence_number = prng->Rand<uint16_t>();
+  uint32_t abs_send_time = prng->Rand(0x00ffffff);
+
+  std::vector<RtpPacketToSend> packets;
+  packets.reserve(num_packets);
+  for (size_t i = 0; i < num_packets; ++i) {
+    packets.emplace_back(extensions, 100);
+    RtpPacketToSend& packet = packets.back();
+    if (i % 10 == 0) {
+      packet.SetPayloadType(111);
+      packet.SetSequenceNumber(audio_sequence_number++);
+      packet.SetSsrc(kAudioSsrc);
+      packet.SetTimestamp(audio_timestamp += 960);
+      packet.SetExtension<AudioLevel>(true, prng->Rand(127));
+    } else if (i % 25 == 0) {
+      packet.SetPayloadType(97);
+      packet.SetSequenceNumber(rtx_sequence_number++);
+      packet.SetSsrc(kRtxSsrc);
+      packet.SetTimestamp(video_timestamp - 3000);
+    } else {
+      packet.SetPayloadType(96);
+      packet.SetMarker(i % 8 == 0);
+      packet.SetSequenceNumber(video_sequence_number++);
+      packet.SetSsrc(kVideoSsrc);
+      if (i % 8 == 0)
+        video_timestamp += 3000;
+      packet.SetTimestamp(video_timestamp);
+      packet.SetExtension<VideoOrientation>(0);
+    }
+    packet.SetExtension<TransportSequenceNumber>(transport_sequence_number++);
+    abs_send_time = (abs_send_time + prng->Rand(1, 100)) & 0x00ffffff;
+    packet.SetExtension<AbsoluteSendTime>(abs_send_time);
+  }
+  return packets;
+}
+
+TEST(RtcEventLogTest, LogBatchedRtpPacketsAndReadBack) {
+  Random prng(1234567);
+  RtpHeaderExtensionMap extensions;
+  for (size_t i = 0; i < kNumExtensions; i++)
+    extensions.Register(kExtensionTypes[i], i + 1);
+  // More packets than fit in a single batch.
+  const size_t kNumPackets = 1000;
+  std::vector<RtpPacketToSend> packets =
+      GenerateRtpStreams(&extensions, kNumPackets, &prng);
+  std::vector<size_t> packet_lengths;
+  std::vector<int64_t> timestamps;
+  rtc::Buffer rtcp_packet = GenerateRtcpPacket(&prng);
+
+  auto test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+  const std::string temp_filename =
+      test::OutputPath() + test_info->test_case_name() + test_info->name();
+
+  {
+    rtc::ScopedFakeClock fake_clock;
+    fake_clock.SetTimeMicros(prng.Rand<uint32_t>());
+    std::unique_ptr<RtcEventLog> log_dumper(
+        RtcEventLog::Create(RtcEventLog::EncodingType::kBatched));
+    log_dumper->StartLogging(temp_filename, 10000000);
+    for (size_t i = 0; i < kNumPackets; ++i) {
+      packet_lengths.push_back(prng.Rand(packets[i].headers_size(), 1200));
+      timestamps.push_back(rtc::TimeMicros());
+      log_dumper->LogRtpHeader(
+          i % 3 == 0 ? kIncomingPacket : kOutgoingPacket, packets[i].data(),
+          packet_lengths.back(), i % 7 == 0 ? 2 : PacedPacketInfo::kNotAProbe);
+      fake_clock.AdvanceTimeMicros(prng.Rand(0, 1000));
+      // Other events end the current batch.
+      if (i == 600) {
+        timestamps.push_back(rtc::TimeMicros());
+        log_dumper->LogRtcpPacket(kIncomingPacket, rtcp_packet.data(),
+                                  rtcp_packet.size());
+      }
+    }
+    log_dumper->StopLogging();
+  }
+
+  ParsedRtcEventLog parsed_log;
+  ASSERT_TRUE(parsed_log.ParseFile(temp_filename));
+  ASSERT_EQ(kNumPackets + 3, parsed_log.GetNumberOfEvents());
+  RtcEventLogTestHelper::VerifyLogStartEvent(parsed_log, 0);
+  size_t event_index = 1;
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    EXPECT_EQ(timestamps[event_index - 1],
+              parsed_log.GetTimestamp(event_index));
+    RtcEventLogTestHelper::VerifyRtpEvent(
+        parsed_log, event_index,
+        i % 3 == 0 ? kIncomingPacket : kOutgoingPacket, packets[i].data(),
+        packets[i].headers_size(), packet_lengths[i]);
+    ++event_index;
+    if (i == 600) {
+      EXPECT_EQ(timestamps[event_index - 1],
+                parsed_log.GetTimestamp(event_index));
+      RtcEventLogTestHelper::VerifyRtcpEvent(parsed_log, event_index,
+                                             kIncomingPacket,
+                                             rtcp_packet.data(),
+                                             rtcp_packet.size());
+      ++event_index;
+    }
+  }
+  RtcEventLogTestHelper::VerifyLogEndEvent(parsed_log, event_index);
+
+  remove(temp_filename.c_str());
+}
+
+// Returns the number of packets in each RTP_PACKET_BATCH_EVENT of the log in
+// |file_name|.
+std::vector<int> GetRtpBatchSizes(const std::string& file_name) {
+  std::vector<int> batch_sizes;
+  FILE* file = fopen(file_name.c_str(), "rb");
+  if (!file)
+    return batch_sizes;
+  std::string contents;
+  char buffer[4096];
+  size_t bytes_read;
+  while ((bytes_read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    contents.append(buffer, bytes_read);
+  fclose(file);
+
+  rtclog::EventStream stream;
+  if (!stream.ParseFromString(contents))
+    return batch_sizes;
+  for (const rtclog::Event& event : stream.stream()) {
+    if (event.type() == rtclog::Event::RTP_PACKET_BATCH_EVENT) {
+      batch_sizes.push_back(
+          event.rtp_packet_batch().timestamp_us_deltas_size());
+    }
+  }
+  return batch_sizes;
+}
+
+TEST(RtcEventLogTest, WritesRtpBatchOnceFirstPacketIsTooOld) {
+  Random prng(8765432);
+  RtpHeaderExtensionMap extensions;
+  const size_t kNumPackets = 10;
+  std::vector<RtpPacketToSend> packets =
+      GenerateRtpStreams(&extensions, kNumPackets, &prng);
+
+  auto test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+  const std::string temp_filename =
+      test::OutputPath() + test_info->test_case_name() + test_info->name();
+
+  {
+    rtc::ScopedFakeClock fake_clock;
+    fake_clock.SetTimeMicros(prng.Rand<uint32_t>());
+    std::unique_ptr<RtcEventLog> log_dumper(
+        RtcEventLog::Create(RtcEventLog::EncodingType::kBatched));
+    log_dumper->StartLogging(temp_filename, 10000000);
+    for (size_t i = 0; i < kNumPackets; ++i) {
+      log_dumper->LogRtpHeader(kOutgoingPacket, packets[i].data(),
+                               packets[i].size());
+      fake_clock.AdvanceTimeMicros(300000);
+    }
+    log_dumper->StopLogging();
+  }
+
+  // A packet logged 600 ms after the first packet of the batch, which is
+  // more than the 500 ms a packet may wait, starts a new batch.
+  EXPECT_EQ(std::vector<int>({2, 2, 2, 2, 2}),
+            GetRtpBatchSizes(temp_filename));
+
+  remove(temp_filename.c_str());
+}
+
+TEST(RtcEventLogTest, ParseLogIncrementally) {
+  Random prng(987654);
+  RtpHeaderExtensionMap extensions;
+  for (size_t i = 0; i < kNumExtensions; i++)
+    extensions.Register(kExtensionTypes[i], i + 1);
+  const size_t kNumPackets = 700;
+  std::vector<RtpPacketToSend> packets =
+      GenerateRtpStreams(&extensions, kNumPackets, &prng);
+  rtc::Buffer rtcp_packet = GenerateRtcpPacket(&prng);
+  rtclog::StreamConfig sender_config;
+  GenerateVideoSendConfig((1u << kNumExtensions) - 1, &sender_config, &prng);
+  // Packet 1 belongs to the video stream.
+  sender_config.local_ssrc = packets[1].Ssrc();
+
+  auto test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+  const std::string temp_filename =
+      test::OutputPath() + test_info->test_case_name() + test_info->name();
+
+  {
+    rtc::ScopedFakeClock fake_clock;
+    fake_clock.SetTimeMicros(prng.Rand<uint32_t>());
+    std::unique_ptr<RtcEventLog> log_dumper(
+        RtcEventLog::Create(RtcEventLog::EncodingType::kBatched));
+    log_dumper->LogVideoSendStreamConfig(sender_config);
+    log_dumper->StartLogging(temp_filename, 10000000);
+    for (size_t i = 0; i < kNumPackets; ++i) {
+      log_dumper->LogRtpHeader(kOutgoingPacket, packets[i].data(),
+                               packets[i].size());
+      if (i % 50 == 0) {
+        log_dumper->LogRtcpPacket(kIncomingPacket, rtcp_packet.data(),
+                                  rtcp_packet.size());
+        log_dumper->LogLossBasedBweUpdate(prng.Rand<int32_t>(), 0, 100);
+      }
+      fake_clock.AdvanceTimeMicros(prng.Rand(0, 1000));
     }
+    log_dumper->StopLogging();
+  }
+
+  ParsedRtcEventLog full_log;
+  ASSERT_TRUE(full_log.ParseFile(temp_filename));
+
+  for (bool memory_map : {false, true}) {
+    // Every event, a few at a time.
+    ParsedRtcEventLog log;
+    ASSERT_TRUE(log.StartParsingFile(temp_filename, memory_map));
+    size_t index = 0;
+    while (!log.AtEndOfLog()) {
+      ASSERT_TRUE(log.ParseNextEvents(7, {}));
+      EXPECT_LE(log.GetNumberOfEvents(), 7u);
+      for (size_t i = 0; i < log.GetNumberOfEvents(); ++i, ++index) {
+        ASSERT_LT(index, full_log.GetNumberOfEvents());
+        EXPECT_EQ(full_log.GetEventType(index), log.GetEventType(i));
+        EXPECT_EQ(full_log.GetTimestamp(index), log.GetTimestamp(i));
+      }
+    }
+    EXPECT_EQ(full_log.GetNumberOfEvents(), index);
+
+    // Only the RTP packets. Their headers are parsed with the extensions of
+    // the config event, which was skipped.
+    ASSERT_TRUE(log.StartParsingFile(temp_filename, memory_map));
+    size_t packet_index = 0;
+    while (!log.AtEndOfLog()) {
+      ASSERT_TRUE(log.ParseNextEvents(100, {ParsedRtcEventLog::RTP_EVENT}));
+      for (size_t i = 0; i < log.GetNumberOfEvents(); ++i, ++packet_index) {
+        ASSERT_EQ(ParsedRtcEventLog::RTP_EVENT, log.GetEventType(i));
+        ASSERT_LT(packet_index, kNumPackets);
+        RtcEventLogTestHelper::VerifyRtpEvent(
+            log, i, kOutgoingPacket, packets[packet_index].data(),
+            packets[packet_index].headers_size(),
+            packets[packet_index].size());
+        if (packets[packet_index].Ssrc() == sender_config.local_ssrc) {
+          uint8_t header[IP_PACKET_SIZE];
+          EXPECT_NE(nullptr,
+                    log.GetRtpHeader(i, nullptr, header, nullptr, nullptr));
+        }
+      }
+    }
+    EXPECT_EQ(kNumPackets, packet_index);
+  }
+
+  remove(temp_filename.c_str());
+}
+
+// Compares the cost of logging RTP packets with both encodings. Disabled by
+// default since it only logs timings and sizes.
+TEST(RtcEventLogTest, DISABLED_RtpPacketEncodingPerformance) {
+  Random prng(7654321);
+  RtpHeaderExtensionMap extensions;
+  for (size_t i = 0; i < kNumExtensions; i++)
+    extensions.Register(kExtensionTypes[i], i + 1);
+  const size_t kNumPackets = 200000;
+  std::vector<RtpPacketToSend> packets =
+      GenerateRtpStreams(&extensions, kNumPackets, &prng);
+
+  auto test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+  const std::string temp_filename =
+      test::OutputPath() + test_info->test_case_name() + test_info->name();
+
+  for (RtcEventLog::EncodingType encoding_type :
+       {RtcEventLog::EncodingType::kLegacy,
+        RtcEventLog::EncodingType::kBatched}) {
+    std::unique_ptr<RtcEventLog> log_dumper(RtcEventLog::Create(encoding_type));
+    log_dumper->StartLogging(temp_filename, 0);
+    int64_t start_ns = rtc::TimeNanos();
+    for (size_t i = 0; i < kNumPackets; ++i) {
+      log_dumper->LogRtpHeader(kOutgoingPacket, packets[i].data(), 1200);
+      if (i % 100 == 0)
+        log_dumper->LogLossBasedBweUpdate(300000, 0, 100);
+    }
+    int64_t logged_ns = rtc::TimeNanos();
+    log_dumper->StopLogging();
+    int64_t stopped_ns = rtc::TimeNanos();
+    size_t file_size = test::GetFileSize(temp_filename);
+    LOG(LS_INFO) << (encoding_type == RtcEventLog::EncodingType::kLegacy
+                         ? "Legacy"
+                         : "Batched")
+                 << " encoding: " << kNumPackets << " packets logged in "
+                 << (logged_ns - start_ns) / rtc::kNumNanosecsPerMillisec
+                 << " ms, written after "
+                 << (stopped_ns - start_ns) / rtc::kNumNanosecsPerMillisec
+                 << " ms ("
+                 << (stopped_ns - start_ns) / static_cast<int64_t>(kNumPackets)
+                 << " ns per packet), "
+                 << static_cast<double>(file_size) / kNumPackets
+                 << " bytes per packet.";
+    remove(temp_filename.c_str());
   }
 }
 
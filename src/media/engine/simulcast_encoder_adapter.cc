@@ -20,6 +20,7 @@
 #include "modules/video_coding/codecs/vp8/screenshare_layers.h"
 #include "modules/video_coding/codecs/vp8/simulcast_rate_allocator.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/event.h"
 #include "system_wrappers/include/clock.h"
 
 namespace {
@@ -129,10 +130,17 @@ namespace webrtc {
 
 SimulcastEncoderAdapter::SimulcastEncoderAdapter(
     cricket::WebRtcVideoEncoderFactory* factory)
+    : SimulcastEncoderAdapter(factory, nullptr) {}
+
+SimulcastEncoderAdapter::SimulcastEncoderAdapter(
+    cricket::WebRtcVideoEncoderFactory* factory,
+    EncoderQueuePool* encode_queue_pool)
     : inited_(0),
       factory_(factory),
+      encode_queue_pool_(encode_queue_pool),
       encoded_complete_callback_(nullptr),
-      implementation_name_("SimulcastEncoderAdapter") {
+      implementation_name_("SimulcastEncoderAdapter"),
+      buffer_encoded_images_(false) {
   // The adapter is typically created on the worker thread, but operated on
   // the encoder task queue.
   encoder_queue_.Detach();
@@ -148,6 +156,9 @@ SimulcastEncoderAdapter::~SimulcastEncoderAdapter() {
 int SimulcastEncoderAdapter::Release() {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&encoder_queue_);
 
+  for (rtc::TaskQueue* queue : encode_queues_)
+    encode_queue_pool_->ReleaseQueue(queue);
+  encode_queues_.clear();
   while (!streaminfos_.empty()) {
     std::unique_ptr<VideoEncoder> encoder =
         std::move(streaminfos_.back().encoder);
@@ -195,6 +206,14 @@ int SimulcastEncoderAdapter::InitEncode(const VideoCodec* inst,
     return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
   }
 
+  // When the streams are encoded in parallel, each encoder gets its share of
+  // the cores.
+  const bool encode_in_parallel =
+      doing_simulcast && number_of_cores > 1 && encode_queue_pool_;
+  const int stream_number_of_cores =
+      encode_in_parallel ? std::max(1, number_of_cores / number_of_streams)
+                         : number_of_cores;
+
   codec_ = *inst;
   SimulcastRateAllocator rate_allocator(codec_, nullptr);
   BitrateAllocation allocation = rate_allocator.GetAllocation(
@@ -242,7 +261,8 @@ int SimulcastEncoderAdapter::InitEncode(const VideoCodec* inst,
       encoder = CreateScopedVideoEncoder(factory_, cricket::VideoCodec("VP8"));
     }
 
-    ret = encoder->InitEncode(&stream_codec, number_of_cores, max_payload_size);
+    ret = encoder->InitEncode(&stream_codec, stream_number_of_cores,
+                              max_payload_size);
     if (ret < 0) {
       // Explicitly destroy the current encoder; because we haven't registered a
       // StreamInfo for it yet, Release won't do anything about it.
@@ -273,6 +293,11 @@ int SimulcastEncoderAdapter::InitEncode(const VideoCodec* inst,
   // To save memory, don't store encoders that we don't use.
   DestroyStoredEncoders();
 
+  if (encode_in_parallel) {
+    for (int i = 0; i < number_of_streams - 1; ++i)
+      encode_queues_.push_back(encode_queue_pool_->AcquireQueue());
+  }
+
   rtc::AtomicOps::ReleaseStore(&inited_, 1);
 
   return WEBRTC_VIDEO_CODEC_OK;
@@ -310,69 +335,150 @@ int SimulcastEncoderAdapter::Encode(
     }
   }
 
-  int src_width = input_image.width();
-  int src_height = input_image.height();
+  std::vector<FrameType> stream_frame_types;
+  stream_frame_types.push_back(send_key_frame ? kVideoFrameKey
+                                              : kVideoFrameDelta);
+  std::vector<size_t> stream_indices;
   for (size_t stream_idx = 0; stream_idx < streaminfos_.size(); ++stream_idx) {
     // Don't encode frames in resolutions that we don't intend to send.
     if (!streaminfos_[stream_idx].send_stream) {
       continue;
     }
-
-    std::vector<FrameType> stream_frame_types;
     if (send_key_frame) {
-      stream_frame_types.push_back(kVideoFrameKey);
       streaminfos_[stream_idx].key_frame_request = false;
-    } else {
-      stream_frame_types.push_back(kVideoFrameDelta);
     }
+    stream_indices.push_back(stream_idx);
+  }
 
-    int dst_width = streaminfos_[stream_idx].width;
-    int dst_height = streaminfos_[stream_idx].height;
-    // If scaling isn't required, because the input resolution
-    // matches the destination or the input image is empty (e.g.
-    // a keyframe request for encoders with internal camera
-    // sources) or the source image has a native handle, pass the image on
-    // directly. Otherwise, we'll scale it to match what the encoder expects
-    // (below).
-    // For texture frames, the underlying encoder is expected to be able to
-    // correctly sample/scale the source texture.
-    // TODO(perkj): ensure that works going forward, and figure out how this
-    // affects webrtc:5683.
-    if ((dst_width == src_width && dst_height == src_height) ||
-        input_image.video_frame_buffer()->type() ==
-            VideoFrameBuffer::Type::kNative) {
-      int ret = streaminfos_[stream_idx].encoder->Encode(
-          input_image, codec_specific_info, &stream_frame_types);
-      if (ret != WEBRTC_VIDEO_CODEC_OK) {
-        return ret;
-      }
-    } else {
-      rtc::scoped_refptr<I420Buffer> dst_buffer =
-          I420Buffer::Create(dst_width, dst_height);
-      rtc::scoped_refptr<I420BufferInterface> src_buffer =
-          input_image.video_frame_buffer()->ToI420();
-      libyuv::I420Scale(src_buffer->DataY(), src_buffer->StrideY(),
-                        src_buffer->DataU(), src_buffer->StrideU(),
-                        src_buffer->DataV(), src_buffer->StrideV(), src_width,
-                        src_height, dst_buffer->MutableDataY(),
-                        dst_buffer->StrideY(), dst_buffer->MutableDataU(),
-                        dst_buffer->StrideU(), dst_buffer->MutableDataV(),
-                        dst_buffer->StrideV(), dst_width, dst_height,
-                        libyuv::kFilterBilinear);
-
-      int ret = streaminfos_[stream_idx].encoder->Encode(
-          VideoFrame(dst_buffer, input_image.timestamp(),
-                     input_image.render_time_ms(), webrtc::kVideoRotation_0),
-          codec_specific_info, &stream_frame_types);
-      if (ret != WEBRTC_VIDEO_CODEC_OK) {
-        return ret;
-      }
+  // Texture frames are passed on to the encoders as they are, and such
+  // encoders may need to be used on one thread only.
+  if (!encode_queues_.empty() && stream_indices.size() > 1 &&
+      input_image.video_frame_buffer()->type() !=
+          VideoFrameBuffer::Type::kNative) {
+    return EncodeStreamsInParallel(stream_indices, input_image,
+                                   codec_specific_info, stream_frame_types);
+  }
+
+  for (size_t stream_idx : stream_indices) {
+    int ret = EncodeStream(stream_idx, input_image, codec_specific_info,
+                           stream_frame_types);
+    if (ret != WEBRTC_VIDEO_CODEC_OK) {
+      return ret;
     }
   }
 
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+int SimulcastEncoderAdapter::EncodeStream(
+    size_t stream_idx,
+    const VideoFrame& input_image,
+    const CodecSpecificInfo* codec_specific_info,
+    const std::vector<FrameType>& frame_types) {
+  int src_width = input_image.width();
+  int src_height = input_image.height();
+  int dst_width = streaminfos_[stream_idx].width;
+  int dst_height = streaminfos_[stream_idx].height;
+  // If scaling isn't required, because the input resolution
+  // matches the destination or the input image is empty (e.g.
+  // a keyframe request for encoders with internal camera
+  // sources) or the source image has a native handle, pass the image on
+  // directly. Otherwise, we'll scale it to match what the encoder expects
+  // (below).
+  // For texture frames, the underlying encoder is expected to be able to
+  // correctly sample/scale the source texture.
+  // TODO(perkj): ensure that works going forward, and figure out how this
+  // affects webrtc:5683.
+  if ((dst_width == src_width && dst_height == src_height) ||
+      input_image.video_frame_buffer()->type() ==
+          VideoFrameBuffer::Type::kNative) {
+    return streaminfos_[stream_idx].encoder->Encode(
+        input_image, codec_specific_info, &frame_types);
+  }
+
+  rtc::scoped_refptr<I420Buffer> dst_buffer =
+      I420Buffer::Create(dst_width, dst_height);
+  rtc::scoped_refptr<I420BufferInterface> src_buffer =
+      input_image.video_frame_buffer()->ToI420();
+  libyuv::I420Scale(src_buffer->DataY(), src_buffer->StrideY(),
+                    src_buffer->DataU(), src_buffer->StrideU(),
+                    src_buffer->DataV(), src_buffer->StrideV(), src_width,
+                    src_height, dst_buffer->MutableDataY(),
+                    dst_buffer->StrideY(), dst_buffer->MutableDataU(),
+                    dst_buffer->StrideU(), dst_buffer->MutableDataV(),
+                    dst_buffer->StrideV(), dst_width, dst_height,
+                    libyuv::kFilterBilinear);
+
+  return streaminfos_[stream_idx].encoder->Encode(
+      VideoFrame(dst_buffer, input_image.timestamp(),
+                 input_image.render_time_ms(), webrtc::kVideoRotation_0),
+      codec_specific_info, &frame_types);
+}
+
+int SimulcastEncoderAdapter::EncodeStreamsInParallel(
+    const std::vector<size_t>& stream_indices,
+    const VideoFrame& input_image,
+    const CodecSpecificInfo* codec_specific_info,
+    const std::vector<FrameType>& frame_types) {
+  {
+    rtc::CritScope lock(&buffered_images_crit_);
+    RTC_DCHECK(buffered_images_.empty());
+    buffer_encoded_images_ = true;
+  }
+
+  // The last stream, with the highest resolution, is encoded on this queue
+  // while the others are encoded on their own.
+  const size_t last_stream_idx = streaminfos_.size() - 1;
+  const bool encode_last_stream = stream_indices.back() == last_stream_idx;
+  const int num_queued = static_cast<int>(stream_indices.size()) -
+                         (encode_last_stream ? 1 : 0);
+  volatile int num_pending = num_queued;
+  std::vector<int> results(streaminfos_.size(), WEBRTC_VIDEO_CODEC_OK);
+  rtc::Event done_event(false, false);
+  for (size_t stream_idx : stream_indices) {
+    if (stream_idx == last_stream_idx)
+      continue;
+    encode_queues_[stream_idx]->PostTask([this, stream_idx, &input_image,
+                                          codec_specific_info, &frame_types,
+                                          &results, &num_pending,
+                                          &done_event] {
+      results[stream_idx] = EncodeStream(stream_idx, input_image,
+                                         codec_specific_info, frame_types);
+      if (rtc::AtomicOps::Decrement(&num_pending) == 0)
+        done_event.Set();
+    });
+  }
+  if (encode_last_stream) {
+    results[last_stream_idx] = EncodeStream(
+        last_stream_idx, input_image, codec_specific_info, frame_types);
+  }
+  if (num_queued > 0)
+    done_event.Wait(rtc::Event::kForever);
+
+  std::vector<BufferedImage> buffered_images;
+  {
+    rtc::CritScope lock(&buffered_images_crit_);
+    buffered_images.swap(buffered_images_);
+    buffer_encoded_images_ = false;
+  }
+  // Deliver the images in the order encoding the streams one after another
+  // would have.
+  std::stable_sort(buffered_images.begin(), buffered_images.end(),
+                   [](const BufferedImage& a, const BufferedImage& b) {
+                     return a.stream_idx < b.stream_idx;
+                   });
+  for (const BufferedImage& image : buffered_images) {
+    DeliverEncodedImage(image.stream_idx, image.encoded_image,
+                        &image.codec_specific_info, image.fragmentation.get());
+  }
+
+  for (size_t stream_idx : stream_indices) {
+    if (results[stream_idx] != WEBRTC_VIDEO_CODEC_OK)
+      return results[stream_idx];
+  }
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
 int SimulcastEncoderAdapter::RegisterEncodeCompleteCallback(
     EncodedImageCallback* callback) {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&encoder_queue_);
@@ -450,6 +556,38 @@ EncodedImageCallback::Result SimulcastEncoderAdapter::OnEncodedImage(
     const EncodedImage& encodedImage,
     const CodecSpecificInfo* codecSpecificInfo,
     const RTPFragmentationHeader* fragmentation) {
+  {
+    rtc::CritScope lock(&buffered_images_crit_);
+    if (buffer_encoded_images_) {
+      buffered_images_.emplace_back();
+      BufferedImage* image = &buffered_images_.back();
+      image->stream_idx = stream_idx;
+      image->encoded_image = encodedImage;
+      image->buffer.reset(new uint8_t[encodedImage._length]);
+      if (encodedImage._length > 0) {
+        memcpy(image->buffer.get(), encodedImage._buffer,
+               encodedImage._length);
+      }
+      image->encoded_image._buffer = image->buffer.get();
+      image->encoded_image._size = encodedImage._length;
+      image->codec_specific_info = *codecSpecificInfo;
+      if (fragmentation) {
+        image->fragmentation.reset(new RTPFragmentationHeader());
+        image->fragmentation->CopyFrom(*fragmentation);
+      }
+      return EncodedImageCallback::Result(EncodedImageCallback::Result::OK,
+                                          encodedImage._timeStamp);
+    }
+  }
+  return DeliverEncodedImage(stream_idx, encodedImage, codecSpecificInfo,
+                             fragmentation);
+}
+
+EncodedImageCallback::Result SimulcastEncoderAdapter::DeliverEncodedImage(
+    size_t stream_idx,
+    const EncodedImage& encodedImage,
+    const CodecSpecificInfo* codecSpecificInfo,
+    const RTPFragmentationHeader* fragmentation) {
   CodecSpecificInfo stream_codec_specific = *codecSpecificInfo;
   stream_codec_specific.codec_name = implementation_name_.c_str();
   CodecSpecificInfoVP8* vp8Info = &(stream_codec_specific.codecSpecific.VP8);
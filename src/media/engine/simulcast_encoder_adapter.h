@@ -21,7 +21,11 @@
 #include "media/engine/webrtcvideoencoderfactory.h"
 #include "modules/video_coding/codecs/vp8/include/vp8.h"
 #include "rtc_base/atomicops.h"
+#include "rtc_base/criticalsection.h"
 #include "rtc_base/sequenced_task_checker.h"
+#include "rtc_base/task_queue.h"
+#include "rtc_base/thread_annotations.h"
+#include "video/encoder_queue_pool.h"
 
 namespace webrtc {
 
@@ -31,9 +35,20 @@ class SimulcastRateAllocator;
 // webrtc::VideoEncoder instances with the given VideoEncoderFactory.
 // The object is created and destroyed on the worker thread, but all public
 // interfaces should be called from the encoder task queue.
+// When given an EncoderQueuePool and more than one core, the streams of a
+// frame are encoded in parallel: the highest resolution stream on the calling
+// queue and the others on queues of the pool, and the cores are divided among
+// the streams. The pool may be shared by many adapters, but the calling queue
+// must not be one of its queues. The encoded images are still delivered on the
+// calling queue, in stream order, before Encode() returns. Since Encode() of
+// the wrapped encoders then runs on other queues than their other methods,
+// only give a pool with a factory whose encoders allow that, such as the
+// libvpx encoders.
 class SimulcastEncoderAdapter : public VP8Encoder {
  public:
   explicit SimulcastEncoderAdapter(cricket::WebRtcVideoEncoderFactory* factory);
+  SimulcastEncoderAdapter(cricket::WebRtcVideoEncoderFactory* factory,
+                          EncoderQueuePool* encode_queue_pool);
   virtual ~SimulcastEncoderAdapter();
 
   // Implements VideoEncoder.
@@ -84,6 +99,16 @@ class SimulcastEncoderAdapter : public VP8Encoder {
     bool send_stream;
   };
 
+  // An encoded image that was delivered while the streams of a frame were
+  // being encoded in parallel, with a copy of its payload.
+  struct BufferedImage {
+    size_t stream_idx;
+    EncodedImage encoded_image;
+    std::unique_ptr<uint8_t[]> buffer;
+    CodecSpecificInfo codec_specific_info;
+    std::unique_ptr<RTPFragmentationHeader> fragmentation;
+  };
+
   // Populate the codec settings for each simulcast stream.
   static void PopulateStreamCodec(const webrtc::VideoCodec& inst,
                                   int stream_index,
@@ -93,10 +118,31 @@ class SimulcastEncoderAdapter : public VP8Encoder {
 
   bool Initialized() const;
 
+  // Scales |input_image| to the resolution of the stream, if needed, and
+  // encodes it.
+  int EncodeStream(size_t stream_idx,
+                   const VideoFrame& input_image,
+                   const CodecSpecificInfo* codec_specific_info,
+                   const std::vector<FrameType>& frame_types);
+  // Encodes the streams in |stream_indices| in parallel. Unlike encoding the
+  // streams one after another, which stops at the first stream that fails,
+  // all streams are encoded and the images of those that succeed are
+  // delivered. Returns the error of the lowest stream that failed, if any.
+  int EncodeStreamsInParallel(const std::vector<size_t>& stream_indices,
+                              const VideoFrame& input_image,
+                              const CodecSpecificInfo* codec_specific_info,
+                              const std::vector<FrameType>& frame_types);
+  EncodedImageCallback::Result DeliverEncodedImage(
+      size_t stream_idx,
+      const EncodedImage& encoded_image,
+      const CodecSpecificInfo* codec_specific_info,
+      const RTPFragmentationHeader* fragmentation);
+
   void DestroyStoredEncoders();
 
   volatile int inited_;  // Accessed atomically.
   cricket::WebRtcVideoEncoderFactory* const factory_;
+  EncoderQueuePool* const encode_queue_pool_;
   VideoCodec codec_;
   std::vector<StreamInfo> streaminfos_;
   EncodedImageCallback* encoded_complete_callback_;
@@ -108,6 +154,18 @@ class SimulcastEncoderAdapter : public VP8Encoder {
   // Store encoders in between calls to Release and InitEncode, so they don't
   // have to be recreated. Remaining encoders are destroyed by the destructor.
   std::stack<std::unique_ptr<VideoEncoder>> stored_encoders_;
+
+  // Queues of |encode_queue_pool_| for encoding all streams but the last in
+  // parallel, indexed by stream. Empty when encoding the streams one after
+  // another.
+  std::vector<rtc::TaskQueue*> encode_queues_;
+
+  rtc::CriticalSection buffered_images_crit_;
+  // Set while encoding the streams in parallel, when the encoded images are
+  // held back to be delivered in stream order.
+  bool buffer_encoded_images_ RTC_GUARDED_BY(buffered_images_crit_);
+  std::vector<BufferedImage> buffered_images_
+      RTC_GUARDED_BY(buffered_images_crit_);
 };
 
 }  // namespace webrtc
@@ -16,6 +16,9 @@
 #include "media/engine/simulcast_encoder_adapter.h"
 #include "modules/video_coding/codecs/vp8/simulcast_test_utility.h"
 #include "modules/video_coding/include/video_codec_interface.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/event.h"
+#include "system_wrappers/include/sleep.h"
 #include "test/gmock.h"
 
 namespace webrtc {
@@ -120,6 +123,7 @@ class MockVideoEncoder : public VideoEncoder {
                      int32_t numberOfCores,
                      size_t maxPayloadSize) /* override */ {
     codec_ = *codecSettings;
+    number_of_cores_ = numberOfCores;
     return init_encode_return_value_;
   }
 
@@ -152,6 +156,7 @@ class MockVideoEncoder : public VideoEncoder {
   virtual ~MockVideoEncoder() {}
 
   const VideoCodec& codec() const { return codec_; }
+  int number_of_cores() const { return number_of_cores_; }
 
   void SendEncodedImage(int width, int height) {
     // Sends a fake image of the given width/height.
@@ -181,6 +186,7 @@ class MockVideoEncoder : public VideoEncoder {
   BitrateAllocation last_set_bitrate_;
 
   VideoCodec codec_;
+  int number_of_cores_ = 0;
   EncodedImageCallback* callback_;
 };
 
@@ -235,12 +241,12 @@ class MockVideoEncoderFactory : public cricket::WebRtcVideoEncoderFactory {
 class TestSimulcastEncoderAdapterFakeHelper {
  public:
   TestSimulcastEncoderAdapterFakeHelper()
-      : factory_(new MockVideoEncoderFactory()) {}
+      : factory_(new MockVideoEncoderFactory()), encode_queue_pool_(2) {}
 
   // Can only be called once as the SimulcastEncoderAdapter will take the
   // ownership of |factory_|.
   VP8Encoder* CreateMockEncoderAdapter() {
-    return new SimulcastEncoderAdapter(factory_.get());
+    return new SimulcastEncoderAdapter(factory_.get(), &encode_queue_pool_);
   }
 
   void ExpectCallSetChannelParameters(uint32_t packetLoss, int64_t rtt) {
@@ -256,6 +262,7 @@ class TestSimulcastEncoderAdapterFakeHelper {
 
  private:
   std::unique_ptr<MockVideoEncoderFactory> factory_;
+  EncoderQueuePool encode_queue_pool_;
 };
 
 static const int kTestTemporalLayerProfile[3] = {3, 2, 1};
@@ -283,6 +290,8 @@ class TestSimulcastEncoderAdapterFake : public ::testing::Test,
     if (codec_specific_info) {
       last_encoded_image_simulcast_index_ =
           codec_specific_info->codecSpecific.VP8.simulcastIdx;
+      encoded_simulcast_indices_.push_back(
+          last_encoded_image_simulcast_index_);
     }
     return Result(Result::OK, encoded_image._timeStamp);
   }
@@ -388,6 +397,7 @@ class TestSimulcastEncoderAdapterFake : public ::testing::Test,
   int last_encoded_image_width_;
   int last_encoded_image_height_;
   int last_encoded_image_simulcast_index_;
+  std::vector<int> encoded_simulcast_indices_;
   TemporalLayersFactory tl_factory_;
   std::unique_ptr<SimulcastRateAllocator> rate_allocator_;
 };
@@ -808,6 +818,56 @@ TEST_F(TestSimulcastEncoderAdapterFake, TestFailureReturnCodesFromEncodeCalls) {
             adapter_->Encode(input_frame, nullptr, &frame_types));
 }
 
+TEST_F(TestSimulcastEncoderAdapterFake, EncodesStreamsInParallel) {
+  TestVp8Simulcast::DefaultSettings(
+      &codec_, static_cast<const int*>(kTestTemporalLayerProfile));
+  codec_.VP8()->tl_factory = &tl_factory_;
+  codec_.numberOfSimulcastStreams = 3;
+  // High start bitrate, so all streams are enabled.
+  codec_.startBitrate = 3000;
+  EXPECT_EQ(0, adapter_->InitEncode(&codec_, 6, 1200));
+  adapter_->RegisterEncodeCompleteCallback(this);
+  std::vector<MockVideoEncoder*> encoders = helper_->factory()->encoders();
+  ASSERT_EQ(3u, encoders.size());
+  // The cores are divided among the streams.
+  for (MockVideoEncoder* encoder : encoders)
+    EXPECT_EQ(2, encoder->number_of_cores());
+
+  // Each encoder waits for all of them to have started encoding, and the
+  // lowest stream is the last to finish.
+  rtc::CriticalSection crit;
+  int num_started = 0;
+  rtc::Event all_started_event(true /* manual_reset */, false);
+  for (int i = 0; i < 3; ++i) {
+    MockVideoEncoder* encoder = encoders[i];
+    EXPECT_CALL(*encoder, Encode(_, _, _))
+        .WillOnce(::testing::Invoke(
+            [&, encoder, i](const VideoFrame& frame,
+                            const CodecSpecificInfo* codec_specific_info,
+                            const std::vector<FrameType>* frame_types) {
+              {
+                rtc::CritScope lock(&crit);
+                if (++num_started == 3)
+                  all_started_event.Set();
+              }
+              EXPECT_TRUE(all_started_event.Wait(1000));
+              if (i == 0)
+                SleepMs(10);
+              encoder->SendEncodedImage(frame.width(), frame.height());
+              return WEBRTC_VIDEO_CODEC_OK;
+            }));
+  }
+
+  rtc::scoped_refptr<I420Buffer> input_buffer =
+      I420Buffer::Create(kDefaultWidth, kDefaultHeight);
+  input_buffer->InitializeData();
+  VideoFrame input_frame(input_buffer, 0, 0, webrtc::kVideoRotation_0);
+  std::vector<FrameType> frame_types(3, kVideoFrameKey);
+  EXPECT_EQ(0, adapter_->Encode(input_frame, nullptr, &frame_types));
+  // The images are delivered in stream order before Encode() returns.
+  EXPECT_EQ(std::vector<int>({0, 1, 2}), encoded_simulcast_indices_);
+}
+
 TEST_F(TestSimulcastEncoderAdapterFake, TestInitFailureCleansUpEncoders) {
   TestVp8Simulcast::DefaultSettings(
       &codec_, static_cast<const int*>(kTestTemporalLayerProfile));
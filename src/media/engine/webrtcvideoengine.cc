@@ -37,10 +37,12 @@
 #include "media/engine/webrtcvideoencoderfactory.h"
 #include "media/engine/webrtcvoiceengine.h"
 #include "rtc_base/copyonwritebuffer.h"
+#include "rtc_base/criticalsection.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/stringutils.h"
 #include "rtc_base/timeutils.h"
 #include "rtc_base/trace_event.h"
+#include "system_wrappers/include/cpu_info.h"
 #include "system_wrappers/include/field_trial.h"
 
 using DegradationPreference = webrtc::VideoSendStream::DegradationPreference;
@@ -109,8 +111,16 @@ class CricketEncoderFactoryAdapter : public EncoderFactoryAdapter {
 
   std::vector<VideoCodec> GetSupportedCodecs() const override;
 
+  // Returns the pool that the SimulcastEncoderAdapters created by this factory
+  // for internal encoders encode their lower resolution streams on. Created on
+  // first use.
+  webrtc::EncoderQueuePool* GetSimulcastEncodeQueuePool() const;
+
   const std::unique_ptr<WebRtcVideoEncoderFactory> internal_encoder_factory_;
   WebRtcVideoEncoderFactory* const external_encoder_factory_;
+  mutable rtc::CriticalSection simulcast_encode_queue_pool_crit_;
+  mutable std::unique_ptr<webrtc::EncoderQueuePool> simulcast_encode_queue_pool_
+      RTC_GUARDED_BY(simulcast_encode_queue_pool_crit_);
 };
 
 class CricketDecoderFactoryAdapter : public DecoderFactoryAdapter {
@@ -561,6 +571,19 @@ std::vector<VideoCodec> AssignPayloadTypesAndAddAssociatedRtxCodecs(
 }
 }  // namespace
 
+webrtc::EncoderQueuePool*
+CricketEncoderFactoryAdapter::GetSimulcastEncodeQueuePool() const {
+  rtc::CritScope lock(&simulcast_encode_queue_pool_crit_);
+  if (!simulcast_encode_queue_pool_) {
+    // The highest resolution stream of each adapter is encoded on its own
+    // encoder queue, so one core is left for those.
+    int num_cores = static_cast<int>(webrtc::CpuInfo::DetectNumberOfCores());
+    simulcast_encode_queue_pool_.reset(
+        new webrtc::EncoderQueuePool(std::max(1, num_cores - 1)));
+  }
+  return simulcast_encode_queue_pool_.get();
+}
+
 std::vector<VideoCodec> CricketEncoderFactoryAdapter::GetSupportedCodecs()
     const {
   std::vector<VideoCodec> codecs = InternalEncoderFactory().supported_codecs();
@@ -1706,6 +1729,8 @@ CricketEncoderFactoryAdapter::CreateVideoEncoder(
     std::unique_ptr<webrtc::VideoEncoder> external_encoder;
     if (CodecNamesEq(codec.name.c_str(), kVp8CodecName)) {
       // If it's a codec type we can simulcast, create a wrapped encoder.
+      // External encoders are often hardware encoders that expect all calls
+      // on one queue, so their streams are not encoded in parallel.
       external_encoder = std::unique_ptr<webrtc::VideoEncoder>(
           new webrtc::SimulcastEncoderAdapter(external_encoder_factory_));
     } else {
@@ -1734,7 +1759,8 @@ CricketEncoderFactoryAdapter::CreateVideoEncoder(
       // TODO(sprang): Remove this adapter once libvpx supports simulcast with
       // same-resolution substreams.
       internal_encoder = std::unique_ptr<webrtc::VideoEncoder>(
-          new webrtc::SimulcastEncoderAdapter(internal_encoder_factory_.get()));
+          new webrtc::SimulcastEncoderAdapter(internal_encoder_factory_.get(),
+                                              GetSimulcastEncodeQueuePool()));
     } else {
       internal_encoder = std::unique_ptr<webrtc::VideoEncoder>(
           internal_encoder_factory_->CreateVideoEncoder(codec));
@@ -1854,8 +1880,10 @@ bool WebRtcVideoChannel::WebRtcVideoSendStream::SetRtpParameters(
     return false;
   }
 
-  bool reconfigure_encoder = new_parameters.encodings[0].max_bitrate_bps !=
-                             rtp_parameters_.encodings[0].max_bitrate_bps;
+  bool reconfigure_encoder = (new_parameters.encodings[0].max_bitrate_bps !=
+                              rtp_parameters_.encodings[0].max_bitrate_bps) ||
+                             (new_parameters.encodings[0].bitrate_priority !=
+                              rtp_parameters_.encodings[0].bitrate_priority);
   rtp_parameters_ = new_parameters;
   // Codecs are currently handled at the WebRtcVideoChannel level.
   rtp_parameters_.codecs.clear();
@@ -1885,6 +1913,11 @@ bool WebRtcVideoChannel::WebRtcVideoSendStream::ValidateRtpParameters(
     LOG(LS_ERROR) << "Attempted to set RtpParameters with modified SSRC";
     return false;
   }
+  if (!(rtp_parameters.encodings[0].bitrate_priority > 0)) {
+    LOG(LS_ERROR) << "Attempted to set RtpParameters bitrate_priority to "
+                     "an invalid number. bitrate_priority must be > 0.";
+    return false;
+  }
   return true;
 }
 
@@ -1942,6 +1975,8 @@ WebRtcVideoChannel::WebRtcVideoSendStream::CreateVideoEncoderConfig(
     stream_max_bitrate = codec_max_bitrate_kbps * 1000;
   }
   encoder_config.max_bitrate_bps = stream_max_bitrate;
+  encoder_config.bitrate_priority =
+      rtp_parameters_.encodings[0].bitrate_priority;
 
   int max_qp = kDefaultQpMax;
   codec.GetParam(kCodecParamMaxQuantization, &max_qp);
@@ -9,6 +9,7 @@
  */
 
 #include <algorithm>
+#include <limits>
 #include <map>
 #include <memory>
 #include <vector>
@@ -4290,6 +4291,32 @@ TEST_F(WebRtcVideoChannelTest, CannotSetSsrcInRtpSendParameters) {
   EXPECT_FALSE(channel_->SetRtpSendParameters(last_ssrc_, parameters));
 }
 
+// Test that the bitrate priority of the encoding is passed on to the encoder
+// config, and that it must be positive.
+TEST_F(WebRtcVideoChannelTest, SetRtpSendParametersBitratePriority) {
+  FakeVideoSendStream* stream = AddSendStream();
+  webrtc::RtpParameters parameters = channel_->GetRtpSendParameters(last_ssrc_);
+  ASSERT_EQ(1u, parameters.encodings.size());
+  EXPECT_EQ(webrtc::kDefaultBitratePriority,
+            parameters.encodings[0].bitrate_priority);
+  EXPECT_EQ(webrtc::kDefaultBitratePriority,
+            stream->GetEncoderConfig().bitrate_priority);
+
+  parameters.encodings[0].bitrate_priority = 2.0;
+  EXPECT_TRUE(channel_->SetRtpSendParameters(last_ssrc_, parameters));
+  EXPECT_EQ(2.0, stream->GetEncoderConfig().bitrate_priority);
+  EXPECT_EQ(2.0, channel_->GetRtpSendParameters(last_ssrc_)
+                     .encodings[0]
+                     .bitrate_priority);
+
+  parameters.encodings[0].bitrate_priority = 0.0;
+  EXPECT_FALSE(channel_->SetRtpSendParameters(last_ssrc_, parameters));
+  parameters.encodings[0].bitrate_priority =
+      std::numeric_limits<double>::quiet_NaN();
+  EXPECT_FALSE(channel_->SetRtpSendParameters(last_ssrc_, parameters));
+  EXPECT_EQ(2.0, stream->GetEncoderConfig().bitrate_priority);
+}
+
 // Test that a stream will not be sending if its encoding is made inactive
 // through SetRtpSendParameters.
 // TODO(deadbeef): Update this test when we start supporting setting parameters
@@ -1033,6 +1033,11 @@ class WebRtcVoiceMediaChannel::WebRtcAudioSendStream
       LOG(LS_ERROR) << "Attempted to set RtpParameters with modified SSRC";
       return false;
     }
+    if (!(rtp_parameters.encodings[0].bitrate_priority > 0)) {
+      LOG(LS_ERROR) << "Attempted to set RtpParameters bitrate_priority to "
+                       "an invalid number. bitrate_priority must be > 0.";
+      return false;
+    }
     return true;
   }
 
@@ -1053,15 +1058,23 @@ class WebRtcVoiceMediaChannel::WebRtcAudioSendStream
 
     const rtc::Optional<int> old_rtp_max_bitrate =
         rtp_parameters_.encodings[0].max_bitrate_bps;
+    const double old_bitrate_priority =
+        rtp_parameters_.encodings[0].bitrate_priority;
 
     rtp_parameters_ = parameters;
+    config_.bitrate_priority = rtp_parameters_.encodings[0].bitrate_priority;
 
+    bool reconfigure_send_stream =
+        (rtp_parameters_.encodings[0].bitrate_priority != old_bitrate_priority);
     if (rtp_parameters_.encodings[0].max_bitrate_bps != old_rtp_max_bitrate) {
       // Reconfigure AudioSendStream with new bit rate.
       if (send_rate) {
         config_.send_codec_spec->target_bitrate_bps = send_rate;
       }
       UpdateAllowedBitrateRange();
+      reconfigure_send_stream = true;
+    }
+    if (reconfigure_send_stream) {
       ReconfigureAudioSendStream();
     } else {
       // parameters.encodings[0].active could have changed.
@@ -8,6 +8,7 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <limits>
 #include <memory>
 
 #include "api/audio_codecs/builtin_audio_decoder_factory.h"
@@ -1071,6 +1072,29 @@ TEST_F(WebRtcVoiceEngineTestFake, CannotSetSsrcInRtpSendParameters) {
   EXPECT_FALSE(channel_->SetRtpSendParameters(kSsrcX, parameters));
 }
 
+// Test that the bitrate priority of the encoding is passed on to the send
+// stream config, and that it must be positive.
+TEST_F(WebRtcVoiceEngineTestFake, SetRtpParametersBitratePriority) {
+  EXPECT_TRUE(SetupSendStream());
+  webrtc::RtpParameters parameters = channel_->GetRtpSendParameters(kSsrcX);
+  ASSERT_EQ(1u, parameters.encodings.size());
+  EXPECT_EQ(webrtc::kDefaultBitratePriority,
+            parameters.encodings[0].bitrate_priority);
+  EXPECT_EQ(webrtc::kDefaultBitratePriority,
+            GetSendStreamConfig(kSsrcX).bitrate_priority);
+
+  parameters.encodings[0].bitrate_priority = 2.0;
+  EXPECT_TRUE(channel_->SetRtpSendParameters(kSsrcX, parameters));
+  EXPECT_EQ(2.0, GetSendStreamConfig(kSsrcX).bitrate_priority);
+
+  parameters.encodings[0].bitrate_priority = -1.0;
+  EXPECT_FALSE(channel_->SetRtpSendParameters(kSsrcX, parameters));
+  parameters.encodings[0].bitrate_priority =
+      std::numeric_limits<double>::quiet_NaN();
+  EXPECT_FALSE(channel_->SetRtpSendParameters(kSsrcX, parameters));
+  EXPECT_EQ(2.0, GetSendStreamConfig(kSsrcX).bitrate_priority);
+}
+
 // Test that a stream will not be sending if its encoding is made
 // inactive through SetRtpSendParameters.
 TEST_F(WebRtcVoiceEngineTestFake, SetRtpParametersEncodingsActive) {
@@ -25,6 +25,7 @@ enum PreservedErrno {
 
 #include <memory>
 #include <sstream>
+#include <utility>
 
 #include "usrsctplib/usrsctp.h"
 #include "media/base/codec.h"
@@ -49,6 +50,11 @@ static constexpr size_t kSctpMtu = 1200;
 // The size of the SCTP association send buffer.  256kB, the usrsctp default.
 static constexpr int kSendBufferSize = 262144;
 
+// The largest message that is reassembled from the parts usrsctp hands up.
+// Larger messages are dropped, so that the remote side can't make us buffer
+// without bound. This is as much as a DataChannel queues for sending.
+static constexpr size_t kMaxReassembledMessageSize = 16 * 1024 * 1024;
+
 // Set the initial value of the static SCTP Data Engines reference count.
 int g_usrsctp_usage_count = 0;
 rtc::GlobalLockPod g_usrsctp_lock_;
@@ -504,10 +510,58 @@ bool SctpTransport::SendData(const SendDataParams& params,
     *result = SDR_ERROR;
   }
 
+  if (!CanSendData(params, payload.size())) {
+    return false;
+  }
+  return SendMessageToSctp(params, payload, result);
+}
+
+size_t SctpTransport::SendDataBulk(
+    const SendDataParams& params,
+    const std::vector<rtc::CopyOnWriteBuffer>& payloads,
+    SendDataResult* result) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  if (result) {
+    *result = SDR_ERROR;
+  }
+
+  // The socket and stream can't change while we're on the network thread, so
+  // they only need to be checked once for the whole batch.
+  if (payloads.empty() || !CanSendData(params, payloads.front().size())) {
+    return 0;
+  }
+  size_t sent = 0;
+  for (const rtc::CopyOnWriteBuffer& payload : payloads) {
+    if (!SendMessageToSctp(params, payload, result)) {
+      break;
+    }
+    ++sent;
+  }
+  return sent;
+}
+
+bool SctpTransport::SetBufferSizes(int send_buffer_size,
+                                   int receive_buffer_size) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  if (sock_) {
+    LOG(LS_WARNING) << debug_name_ << "->SetBufferSizes(...): "
+                    << "Can't change buffer sizes after the socket is created.";
+    return false;
+  }
+  if (send_buffer_size < 0 || receive_buffer_size < 0) {
+    return false;
+  }
+  send_buffer_size_ = send_buffer_size;
+  receive_buffer_size_ = receive_buffer_size;
+  return true;
+}
+
+bool SctpTransport::CanSendData(const SendDataParams& params,
+                                size_t size) const {
   if (!sock_) {
     LOG(LS_WARNING) << debug_name_ << "->SendData(...): "
                     << "Not sending packet with sid=" << params.sid
-                    << " len=" << payload.size() << " before Start().";
+                    << " len=" << size << " before Start().";
     return false;
   }
 
@@ -518,7 +572,12 @@ bool SctpTransport::SendData(const SendDataParams& params,
                     << params.sid;
     return false;
   }
+  return true;
+}
 
+bool SctpTransport::SendMessageToSctp(const SendDataParams& params,
+                                      const rtc::CopyOnWriteBuffer& payload,
+                                      SendDataResult* result) {
   // Send data using SCTP.
   ssize_t send_res = 0;  // result from usrsctp_sendv.
   struct sctp_sendv_spa spa = {0};
@@ -546,7 +605,9 @@ bool SctpTransport::SendData(const SendDataParams& params,
       rtc::checked_cast<socklen_t>(sizeof(spa)), SCTP_SENDV_SPA, 0);
   if (send_res < 0) {
     if (errno == SCTP_EWOULDBLOCK) {
-      *result = SDR_BLOCK;
+      if (result) {
+        *result = SDR_BLOCK;
+      }
       ready_to_send_data_ = false;
       LOG(LS_INFO) << debug_name_ << "->SendData(...): EWOULDBLOCK returned";
     } else {
@@ -653,10 +714,14 @@ bool SctpTransport::OpenSctpSocket() {
   // still have to do something reasonable here.  Look up what the buffer's
   // real size is and set our threshold to something reasonable.
   static const int kSendThreshold = usrsctp_sysctl_get_sctp_sendspace() / 2;
+  // With a configured send buffer, signal "ready to send" once half of it has
+  // drained, as we do for the default one.
+  const int send_threshold =
+      send_buffer_size_ > 0 ? send_buffer_size_ / 2 : kSendThreshold;
 
   sock_ = usrsctp_socket(
       AF_CONN, SOCK_STREAM, IPPROTO_SCTP, &UsrSctpWrapper::OnSctpInboundPacket,
-      &UsrSctpWrapper::SendThresholdCallback, kSendThreshold, this);
+      &UsrSctpWrapper::SendThresholdCallback, send_threshold, this);
   if (!sock_) {
     LOG_ERRNO(LS_ERROR) << debug_name_ << "->OpenSctpSocket(): "
                         << "Failed to create SCTP socket.";
@@ -712,6 +777,23 @@ bool SctpTransport::ConfigureSctpSocket() {
     return false;
   }
 
+  // Socket buffers, which bound the congestion and receive windows.
+  if (send_buffer_size_ > 0 &&
+      usrsctp_setsockopt(sock_, SOL_SOCKET, SO_SNDBUF, &send_buffer_size_,
+                         sizeof(send_buffer_size_))) {
+    LOG_ERRNO(LS_ERROR) << debug_name_ << "->ConfigureSctpSocket(): "
+                        << "Failed to set SO_SNDBUF to " << send_buffer_size_;
+    return false;
+  }
+  if (receive_buffer_size_ > 0 &&
+      usrsctp_setsockopt(sock_, SOL_SOCKET, SO_RCVBUF, &receive_buffer_size_,
+                         sizeof(receive_buffer_size_))) {
+    LOG_ERRNO(LS_ERROR) << debug_name_ << "->ConfigureSctpSocket(): "
+                        << "Failed to set SO_RCVBUF to "
+                        << receive_buffer_size_;
+    return false;
+  }
+
   // Nagle.
   uint32_t nodelay = 1;
   if (usrsctp_setsockopt(sock_, IPPROTO_SCTP, SCTP_NODELAY, &nodelay,
@@ -752,6 +834,8 @@ void SctpTransport::CloseSctpSocket() {
     usrsctp_deregister_address(this);
     UsrSctpWrapper::DecrementUsrSctpUsageCount();
     ready_to_send_data_ = false;
+    partial_message_.Clear();
+    discarding_partial_message_ = false;
   }
 }
 
@@ -908,9 +992,37 @@ void SctpTransport::OnInboundPacketFromSctpToChannel(
   }
   if (flags & MSG_NOTIFICATION) {
     OnNotificationFromSctp(buffer);
-  } else {
-    OnDataFromSctpToChannel(params, buffer);
+    return;
+  }
+  const bool last_part = (flags & MSG_EOR) != 0;
+  if (discarding_partial_message_) {
+    // The rest of a message that was too large to reassemble.
+    discarding_partial_message_ = !last_part;
+    return;
+  }
+  if (!last_part || partial_message_.size()) {
+    // Part of a message that exceeded the partial delivery point; hold on to
+    // it until the rest arrives.
+    if (partial_message_.size() + buffer.size() > kMaxReassembledMessageSize) {
+      LOG(LS_WARNING) << debug_name_
+                      << "->OnInboundPacketFromSctpToChannel(...): "
+                      << "Dropping a message larger than "
+                      << kMaxReassembledMessageSize << " bytes on stream "
+                      << params.sid;
+      partial_message_.Clear();
+      discarding_partial_message_ = !last_part;
+      return;
+    }
+    partial_message_.AppendData(buffer);
+    if (!last_part)
+      return;
+    // Hand the reassembled message up without another copy; this leaves
+    // |partial_message_| empty for the next one.
+    rtc::CopyOnWriteBuffer message(std::move(partial_message_));
+    OnDataFromSctpToChannel(params, message);
+    return;
   }
+  OnDataFromSctpToChannel(params, buffer);
 }
 
 void SctpTransport::OnDataFromSctpToChannel(
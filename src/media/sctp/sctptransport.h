@@ -78,6 +78,10 @@ class SctpTransport : public SctpTransportInternal,
   bool SendData(const SendDataParams& params,
                 const rtc::CopyOnWriteBuffer& payload,
                 SendDataResult* result = nullptr) override;
+  size_t SendDataBulk(const SendDataParams& params,
+                      const std::vector<rtc::CopyOnWriteBuffer>& payloads,
+                      SendDataResult* result = nullptr) override;
+  bool SetBufferSizes(int send_buffer_size, int receive_buffer_size) override;
   bool ReadyToSendData() override;
   void set_debug_name_for_testing(const char* debug_name) override {
     debug_name_ = debug_name;
@@ -101,6 +105,13 @@ class SctpTransport : public SctpTransportInternal,
   // Sets |sock_ |to nullptr.
   void CloseSctpSocket();
 
+  // Returns false, and logs why, if a message can't be sent on |params.sid|.
+  bool CanSendData(const SendDataParams& params, size_t size) const;
+  // Hands one message to usrsctp; assumes CanSendData() returned true.
+  bool SendMessageToSctp(const SendDataParams& params,
+                         const rtc::CopyOnWriteBuffer& payload,
+                         SendDataResult* result);
+
   // Sends a SCTP_RESET_STREAM for all streams in closing_ssids_.
   bool SendQueuedStreamResets();
 
@@ -153,6 +164,19 @@ class SctpTransport : public SctpTransportInternal,
   // send".
   bool ready_to_send_data_ = false;
 
+  // Socket buffer sizes set by SetBufferSizes(); 0 means the usrsctp default.
+  int send_buffer_size_ = 0;
+  int receive_buffer_size_ = 0;
+
+  // usrsctp hands messages larger than its partial delivery point up in
+  // several parts. They are collected here until the last part (flagged with
+  // MSG_EOR) arrives, so that SignalDataReceived always carries a whole
+  // message.
+  rtc::CopyOnWriteBuffer partial_message_;
+  // Set while dropping the parts of a message that grew too large to
+  // reassemble, until its last part arrives.
+  bool discarding_partial_message_ = false;
+
   typedef std::set<uint32_t> StreamSet;
   // When a data channel opens a stream, it goes into open_streams_.  When we
   // want to close it, the stream's ID goes into queued_reset_streams_.  When
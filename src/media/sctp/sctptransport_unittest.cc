@@ -11,7 +11,9 @@
 #include <errno.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -25,6 +27,7 @@
 #include "rtc_base/helpers.h"
 #include "rtc_base/ssladapter.h"
 #include "rtc_base/thread.h"
+#include "rtc_base/timeutils.h"
 
 namespace {
 static const int kDefaultTimeout = 10000;  // 10 seconds.
@@ -546,6 +549,183 @@ TEST_F(SctpTransportTest, ClosesStreamsOnBothSides) {
   EXPECT_TRUE_WAIT(transport1_sig_receiver.WasStreamClosed(4), kDefaultTimeout);
 }
 
+// Counts received messages and bytes, for tests that send many messages.
+class SctpMessageCounter : public sigslot::has_slots<> {
+ public:
+  void OnDataReceived(const ReceiveDataParams& params,
+                      const rtc::CopyOnWriteBuffer& data) {
+    ++messages_;
+    bytes_ += data.size();
+    last_size_ = data.size();
+  }
+
+  int messages() const { return messages_; }
+  size_t bytes() const { return bytes_; }
+  size_t last_size() const { return last_size_; }
+
+ private:
+  int messages_ = 0;
+  size_t bytes_ = 0;
+  size_t last_size_ = 0;
+};
+
+TEST_F(SctpTransportTest, SendDataBulk) {
+  SetupConnectedTransportsWithTwoStreams();
+  SctpMessageCounter counter;
+  transport2()->SignalDataReceived.connect(&counter,
+                                           &SctpMessageCounter::OnDataReceived);
+
+  SendDataParams params;
+  params.sid = 1;
+  std::vector<rtc::CopyOnWriteBuffer> payloads;
+  for (const char* msg : {"one", "two", "three"}) {
+    payloads.emplace_back(msg, strlen(msg));
+  }
+  SendDataResult result;
+  EXPECT_EQ(3u, transport1()->SendDataBulk(params, payloads, &result));
+  EXPECT_EQ(SDR_SUCCESS, result);
+  EXPECT_EQ_WAIT(3, counter.messages(), kDefaultTimeout);
+  EXPECT_TRUE(ReceivedData(receiver2(), 1, "three"));
+}
+
+TEST_F(SctpTransportTest, SendDataBulkWithNonexistentStreamFails) {
+  SetupConnectedTransportsWithTwoStreams();
+  SendDataParams params;
+  params.sid = 123;
+  std::vector<rtc::CopyOnWriteBuffer> payloads(2,
+                                               rtc::CopyOnWriteBuffer("a", 1));
+  SendDataResult result;
+  EXPECT_EQ(0u, transport1()->SendDataBulk(params, payloads, &result));
+  EXPECT_EQ(SDR_ERROR, result);
+}
+
+TEST_F(SctpTransportTest, SetBufferSizesFailsOnceSocketIsCreated) {
+  SetupConnectedTransportsWithTwoStreams();
+  EXPECT_FALSE(transport1()->SetBufferSizes(1024 * 1024, 1024 * 1024));
+}
+
+// A message larger than the receive buffer is delivered by usrsctp in several
+// parts; it should still reach the upper layers as a single message.
+TEST_F(SctpTransportTest, LargeMessageIsDeliveredWhole) {
+  static const size_t kMessageSize = 512 * 1024;
+  FakeDtlsTransport fake_dtls1("fake dtls 1", 0);
+  FakeDtlsTransport fake_dtls2("fake dtls 2", 0);
+  SctpFakeDataReceiver recv1;
+  SctpFakeDataReceiver recv2;
+  SctpMessageCounter counter;
+  std::unique_ptr<SctpTransport> transport1(
+      CreateTransport(&fake_dtls1, &recv1));
+  std::unique_ptr<SctpTransport> transport2(
+      CreateTransport(&fake_dtls2, &recv2));
+  transport2->SignalDataReceived.connect(&counter,
+                                         &SctpMessageCounter::OnDataReceived);
+  EXPECT_TRUE(transport1->SetBufferSizes(2 * kMessageSize, 0));
+  EXPECT_TRUE(transport2->SetBufferSizes(0, 64 * 1024));
+
+  transport1->OpenStream(1);
+  transport2->OpenStream(1);
+  transport1->Start(kTransport1Port, kTransport2Port);
+  transport2->Start(kTransport2Port, kTransport1Port);
+  bool asymmetric = false;
+  fake_dtls1.SetDestination(&fake_dtls2, asymmetric);
+
+  SendDataParams params;
+  params.sid = 1;
+  std::vector<char> buffer(kMessageSize, 'x');
+  SendDataResult result;
+  ASSERT_TRUE(transport1->SendData(
+      params, rtc::CopyOnWriteBuffer(&buffer[0], buffer.size()), &result));
+  EXPECT_EQ_WAIT(1, counter.messages(), kDefaultTimeout);
+  EXPECT_EQ(kMessageSize, counter.last_size());
+}
+
+// A message too large to reassemble from its parts is dropped, and the
+// messages after it are still delivered.
+TEST_F(SctpTransportTest, TooLargeMessageIsDropped) {
+  static const size_t kMessageSize = 16 * 1024 * 1024 + 1;
+  FakeDtlsTransport fake_dtls1("fake dtls 1", 0);
+  FakeDtlsTransport fake_dtls2("fake dtls 2", 0);
+  SctpFakeDataReceiver recv1;
+  SctpFakeDataReceiver recv2;
+  SctpMessageCounter counter;
+  std::unique_ptr<SctpTransport> transport1(
+      CreateTransport(&fake_dtls1, &recv1));
+  std::unique_ptr<SctpTransport> transport2(
+      CreateTransport(&fake_dtls2, &recv2));
+  transport2->SignalDataReceived.connect(&counter,
+                                         &SctpMessageCounter::OnDataReceived);
+  EXPECT_TRUE(transport1->SetBufferSizes(2 * kMessageSize, 0));
+  EXPECT_TRUE(transport2->SetBufferSizes(0, 64 * 1024));
+
+  transport1->OpenStream(1);
+  transport2->OpenStream(1);
+  transport1->Start(kTransport1Port, kTransport2Port);
+  transport2->Start(kTransport2Port, kTransport1Port);
+  bool asymmetric = false;
+  fake_dtls1.SetDestination(&fake_dtls2, asymmetric);
+
+  SendDataParams params;
+  params.sid = 1;
+  std::vector<char> buffer(kMessageSize, 'x');
+  SendDataResult result;
+  ASSERT_TRUE(transport1->SendData(
+      params, rtc::CopyOnWriteBuffer(&buffer[0], buffer.size()), &result));
+  ASSERT_TRUE(SendData(transport1.get(), 1, "after", &result));
+  EXPECT_TRUE_WAIT(ReceivedData(&recv2, 1, "after"), kDefaultTimeout);
+  EXPECT_EQ(1, counter.messages());
+}
+
+// Measures data channel throughput over a loopback association using large
+// socket buffers and bulk sends. Disabled by default to avoid unnecessarily
+// loading the bots.
+TEST_F(SctpTransportTest, DISABLED_BulkThroughput) {
+  static const size_t kMessageSize = 64 * 1024;
+  static const size_t kMessagesPerBatch = 16;
+  static const size_t kTotalBytes = 256 * 1024 * 1024;
+  static const int kBufferSize = 4 * 1024 * 1024;
+  FakeDtlsTransport fake_dtls1("fake dtls 1", 0);
+  FakeDtlsTransport fake_dtls2("fake dtls 2", 0);
+  SctpFakeDataReceiver recv1;
+  SctpFakeDataReceiver recv2;
+  SctpMessageCounter counter;
+  std::unique_ptr<SctpTransport> transport1(
+      CreateTransport(&fake_dtls1, &recv1));
+  std::unique_ptr<SctpTransport> transport2(
+      CreateTransport(&fake_dtls2, &recv2));
+  transport2->SignalDataReceived.connect(&counter,
+                                         &SctpMessageCounter::OnDataReceived);
+  EXPECT_TRUE(transport1->SetBufferSizes(kBufferSize, kBufferSize));
+  EXPECT_TRUE(transport2->SetBufferSizes(kBufferSize, kBufferSize));
+  transport1->OpenStream(1);
+  transport2->OpenStream(1);
+  transport1->Start(kTransport1Port, kTransport2Port);
+  transport2->Start(kTransport2Port, kTransport1Port);
+  bool asymmetric = false;
+  fake_dtls1.SetDestination(&fake_dtls2, asymmetric);
+
+  SendDataParams params;
+  params.sid = 1;
+  std::vector<char> buffer(kMessageSize, 'x');
+  std::vector<rtc::CopyOnWriteBuffer> payloads(
+      kMessagesPerBatch, rtc::CopyOnWriteBuffer(&buffer[0], buffer.size()));
+
+  int64_t start_ms = rtc::TimeMillis();
+  size_t bytes_sent = 0;
+  while (bytes_sent < kTotalBytes) {
+    SendDataResult result;
+    size_t sent = transport1->SendDataBulk(params, payloads, &result);
+    bytes_sent += sent * kMessageSize;
+    if (result != SDR_SUCCESS) {
+      rtc::Thread::Current()->ProcessMessages(1);
+    }
+  }
+  EXPECT_TRUE_WAIT(counter.bytes() == bytes_sent, kDefaultTimeout);
+  int64_t elapsed_ms = std::max<int64_t>(1, rtc::TimeMillis() - start_ms);
+  LOG(LS_INFO) << "Received " << counter.bytes() << " bytes in " << elapsed_ms
+               << " ms: " << counter.bytes() * 8 / elapsed_ms / 1000
+               << " Mbps";
+}
+
 TEST_F(SctpTransportTest, RefusesHighNumberedTransports) {
   SetupConnectedTransportsWithTwoStreams();
   EXPECT_TRUE(AddStream(kMaxSctpSid));
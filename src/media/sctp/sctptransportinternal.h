@@ -99,6 +99,32 @@ class SctpTransportInternal {
   virtual bool SendData(const SendDataParams& params,
                         const rtc::CopyOnWriteBuffer& payload,
                         SendDataResult* result = nullptr) = 0;
+  // Sends each of |payloads| as a separate message with the same |params|,
+  // stopping at the first one that can't be queued. Returns the number of
+  // messages queued; |result| describes the outcome of the last attempt, so
+  // SDR_BLOCK means the remaining messages should be retried after
+  // SignalReadyToSendData.
+  virtual size_t SendDataBulk(
+      const SendDataParams& params,
+      const std::vector<rtc::CopyOnWriteBuffer>& payloads,
+      SendDataResult* result = nullptr) {
+    size_t sent = 0;
+    for (const rtc::CopyOnWriteBuffer& payload : payloads) {
+      if (!SendData(params, payload, result)) {
+        break;
+      }
+      ++sent;
+    }
+    return sent;
+  }
+
+  // Sets the SCTP socket send and receive buffer sizes in bytes. These bound
+  // the amount of unacknowledged outgoing data and the receive window
+  // advertised to the peer, so they limit throughput on high
+  // bandwidth-delay links. A size of 0 keeps the usrsctp default. Must be
+  // called before the association is created; returns false otherwise.
+  virtual bool SetBufferSizes(int send_buffer_size,
+                              int receive_buffer_size) = 0;
 
   // Indicates when the SCTP socket is created and not blocked by congestion
   // control. This changes to false when SDR_BLOCK is returned from SendData,
@@ -110,7 +136,8 @@ class SctpTransportInternal {
 
   sigslot::signal0<> SignalReadyToSendData;
   // ReceiveDataParams includes SID, seq num, timestamp, etc. CopyOnWriteBuffer
-  // contains message payload.
+  // contains the complete message payload, even if usrsctp delivered it in
+  // several parts.
   sigslot::signal2<const ReceiveDataParams&, const rtc::CopyOnWriteBuffer&>
       SignalDataReceived;
   // Parameter is SID of closed stream.
@@ -0,0 +1,439 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/congestion_controller/bbr_network_controller.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "modules/remote_bitrate_estimator/include/bwe_defines.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+namespace {
+
+// Doubles the delivery rate each round trip in startup.
+const float kHighGain = 2.885f;
+const float kDrainGain = 1 / kHighGain;
+// Gain of the congestion window in probe bandwidth mode. Leaves room for the
+// delivery rate to be sampled over a whole feedback interval.
+const float kCongestionWindowGain = 2.0f;
+const float kPacingGainCycle[] = {1.25f, 0.75f, 1.0f, 1.0f,
+                                  1.0f,  1.0f,  1.0f, 1.0f};
+const size_t kGainCycleLength =
+    sizeof(kPacingGainCycle) / sizeof(kPacingGainCycle[0]);
+// Share of the estimate given to the encoder outside the probing phases. The
+// pacer sends the whole estimate, so whatever queued up in it drains, also
+// when the estimate is a bit too high.
+const float kCruisingEncoderGain = 0.95f;
+// Startup ends after this many rounds without the delivery rate growing by
+// |kStartupGrowthTarget|.
+const float kStartupGrowthTarget = 1.25f;
+const int kRoundsWithoutGrowthBeforeExitingStartup = 3;
+// Number of rounds the maximum delivery rate is taken over.
+const int64_t kBandwidthWindowRounds = 10;
+// The minimum round trip time is remeasured in probe RTT mode when it has not
+// been seen for this long.
+const int64_t kMinRttExpiryMs = 10000;
+const int64_t kProbeRttDurationMs = 200;
+const size_t kMaxPacketSizeBytes = 1500;
+const size_t kMinCongestionWindowBytes = 4 * kMaxPacketSizeBytes;
+// Delivery rate samples are taken over at least this long, so that the
+// receive time granularity does not dominate the sample.
+const int64_t kMinSampleIntervalMs = 10;
+const int64_t kDefaultBwePeriodMs = 3000;
+const int64_t kMaxFeedbackIntervalMs = 250;
+// The seed of the random start phase of the gain cycle.
+const uint64_t kRandomSeed = 0xbb5;
+
+}  // namespace
+
+BbrNetworkController::BbrNetworkController() : random_(kRandomSeed) {
+  min_bitrate_bps_ = congestion_controller::GetMinBitrateBps();
+  max_bitrate_bps_ = 0;
+  start_bitrate_bps_ = min_bitrate_bps_;
+  Reset();
+}
+
+BbrNetworkController::~BbrNetworkController() {}
+
+void BbrNetworkController::Reset() {
+  bandwidth_samples_.clear();
+  sample_start_packet_.reset();
+  sample_bytes_ = 0;
+  min_rtt_ms_.reset();
+  min_rtt_time_ms_ = 0;
+  avg_rtt_ms_ = 0;
+  last_feedback_time_ms_.reset();
+  feedback_interval_ms_ = 0;
+  round_count_ = 0;
+  round_start_time_ms_.reset();
+  full_bandwidth_reached_ = false;
+  full_bandwidth_bps_ = 0;
+  rounds_without_growth_ = 0;
+  cycle_index_ = 0;
+  cycle_start_time_ms_ = 0;
+  probe_rtt_done_time_ms_.reset();
+  probe_rtt_done_round_ = 0;
+  in_recovery_ = false;
+  recovery_start_time_ms_ = 0;
+  recovery_window_bytes_ = 0;
+  data_in_flight_bytes_ = 0;
+  fraction_loss_ = 0;
+  last_target_rate_.reset();
+  last_congestion_window_bytes_.reset();
+  last_pacing_factor_.reset();
+  EnterStartup();
+}
+
+void BbrNetworkController::SetConstraints(
+    const TargetRateConstraints& constraints) {
+  min_bitrate_bps_ = constraints.min_bitrate_bps;
+  max_bitrate_bps_ = constraints.max_bitrate_bps;
+  if (constraints.start_bitrate_bps > 0)
+    start_bitrate_bps_ = constraints.start_bitrate_bps;
+  start_bitrate_bps_ = std::max(start_bitrate_bps_, min_bitrate_bps_);
+}
+
+NetworkControlUpdate BbrNetworkController::OnNetworkAvailability(
+    bool network_available,
+    int64_t at_time_ms) {
+  return NetworkControlUpdate();
+}
+
+NetworkControlUpdate BbrNetworkController::OnNetworkRouteChange(
+    const TargetRateConstraints& constraints,
+    int64_t at_time_ms) {
+  Reset();
+  SetConstraints(constraints);
+  return CreateUpdate();
+}
+
+NetworkControlUpdate BbrNetworkController::OnTargetRateConstraints(
+    const TargetRateConstraints& constraints,
+    int64_t at_time_ms) {
+  SetConstraints(constraints);
+  return CreateUpdate();
+}
+
+NetworkControlUpdate BbrNetworkController::OnRoundTripTimeUpdate(
+    int64_t avg_rtt_ms,
+    int64_t max_rtt_ms,
+    int64_t at_time_ms) {
+  avg_rtt_ms_ = avg_rtt_ms;
+  return CreateUpdate();
+}
+
+NetworkControlUpdate BbrNetworkController::OnTransportPacketsFeedback(
+    const TransportPacketsFeedback& feedback) {
+  const int64_t now_ms = feedback.feedback_time_ms;
+  std::vector<PacketFeedback> received = feedback.ReceivedWithSendInfo();
+  std::vector<PacketFeedback> lost = feedback.LostWithSendInfo();
+  std::sort(received.begin(), received.end(), PacketFeedbackComparator());
+  data_in_flight_bytes_ = feedback.data_in_flight_bytes;
+  if (last_feedback_time_ms_) {
+    feedback_interval_ms_ = std::min(now_ms - *last_feedback_time_ms_,
+                                     kMaxFeedbackIntervalMs);
+  }
+  last_feedback_time_ms_.emplace(now_ms);
+
+  if (!received.empty() || !lost.empty()) {
+    fraction_loss_ = static_cast<uint8_t>(
+        255 * lost.size() / (received.size() + lost.size()));
+  }
+  if (received.empty())
+    return CreateUpdate();
+
+  int64_t last_send_time_ms = 0;
+  size_t acked_bytes = 0;
+  for (const PacketFeedback& packet : received) {
+    last_send_time_ms = std::max(last_send_time_ms, packet.send_time_ms);
+    acked_bytes += packet.payload_size;
+  }
+
+  bool new_round = false;
+  if (!round_start_time_ms_ || last_send_time_ms >= *round_start_time_ms_) {
+    ++round_count_;
+    round_start_time_ms_.emplace(now_ms);
+    new_round = true;
+  }
+
+  UpdateMinRtt(now_ms - last_send_time_ms, now_ms);
+  UpdateBandwidth(received, feedback.alr_start_time_ms.has_value());
+  if (new_round && !feedback.alr_start_time_ms)
+    UpdateFullBandwidthReached();
+
+  if (!lost.empty() && !in_recovery_) {
+    in_recovery_ = true;
+    recovery_start_time_ms_ = now_ms;
+    recovery_window_bytes_ = std::max(data_in_flight_bytes_ + acked_bytes,
+                                      kMinCongestionWindowBytes);
+  } else if (in_recovery_ && last_send_time_ms >= recovery_start_time_ms_) {
+    in_recovery_ = false;
+  } else if (in_recovery_) {
+    // Packet conservation: send as much as was acked.
+    recovery_window_bytes_ =
+        std::max(recovery_window_bytes_, data_in_flight_bytes_ + acked_bytes);
+  }
+
+  switch (mode_) {
+    case Mode::kStartup:
+      if (full_bandwidth_reached_) {
+        mode_ = Mode::kDrain;
+        pacing_gain_ = kDrainGain;
+        congestion_window_gain_ = kHighGain;
+      }
+      break;
+    case Mode::kDrain:
+      if (data_in_flight_bytes_ <= BandwidthDelayProductBytes(1.0f))
+        EnterProbeBw(now_ms);
+      break;
+    case Mode::kProbeBw:
+      UpdateGainCycle(now_ms, data_in_flight_bytes_, !lost.empty());
+      break;
+    case Mode::kProbeRtt:
+      break;
+  }
+  UpdateProbeRtt(now_ms, data_in_flight_bytes_);
+  return CreateUpdate();
+}
+
+NetworkControlUpdate BbrNetworkController::OnProcessInterval(
+    int64_t at_time_ms) {
+  // Leave probe RTT mode on time even if feedback is sparse.
+  if (mode_ == Mode::kProbeRtt)
+    UpdateProbeRtt(at_time_ms, data_in_flight_bytes_);
+  return CreateUpdate();
+}
+
+int64_t BbrNetworkController::bandwidth_estimate_bps() const {
+  return bandwidth_samples_.empty() ? 0
+                                    : bandwidth_samples_.front().bandwidth_bps;
+}
+
+void BbrNetworkController::UpdateMinRtt(int64_t rtt_ms, int64_t now_ms) {
+  if (rtt_ms < 0)
+    return;
+  bool expired = min_rtt_ms_ && now_ms > min_rtt_time_ms_ + kMinRttExpiryMs;
+  if (!min_rtt_ms_ || rtt_ms <= *min_rtt_ms_ || expired) {
+    min_rtt_ms_.emplace(rtt_ms);
+    min_rtt_time_ms_ = now_ms;
+  }
+  if (expired && mode_ != Mode::kProbeRtt) {
+    mode_ = Mode::kProbeRtt;
+    pacing_gain_ = 1.0f;
+    congestion_window_gain_ = 1.0f;
+    probe_rtt_done_time_ms_.reset();
+  }
+}
+
+void BbrNetworkController::UpdateBandwidth(
+    const std::vector<PacketFeedback>& received,
+    bool app_limited) {
+  const PacketFeedback& last = received.back();
+  if (!sample_start_packet_) {
+    sample_start_packet_.emplace(last);
+    return;
+  }
+  for (const PacketFeedback& packet : received)
+    sample_bytes_ += packet.payload_size;
+  int64_t ack_interval_ms =
+      last.arrival_time_ms - sample_start_packet_->arrival_time_ms;
+  int64_t send_interval_ms =
+      last.send_time_ms - sample_start_packet_->send_time_ms;
+  if (ack_interval_ms < kMinSampleIntervalMs)
+    return;
+
+  // The delivery rate can not be higher than the rate the packets were sent
+  // at, which guards against receive time compression.
+  int64_t sample_bps = sample_bytes_ * 8000 / ack_interval_ms;
+  if (send_interval_ms > 0) {
+    sample_bps = std::min<int64_t>(sample_bps,
+                                   sample_bytes_ * 8000 / send_interval_ms);
+  }
+  sample_start_packet_.emplace(last);
+  sample_bytes_ = 0;
+
+  if (app_limited && sample_bps <= bandwidth_estimate_bps())
+    return;
+  while (!bandwidth_samples_.empty() &&
+         bandwidth_samples_.back().bandwidth_bps <= sample_bps) {
+    bandwidth_samples_.pop_back();
+  }
+  bandwidth_samples_.push_back({round_count_, sample_bps});
+  while (bandwidth_samples_.front().round + kBandwidthWindowRounds <=
+         round_count_) {
+    bandwidth_samples_.pop_front();
+  }
+}
+
+void BbrNetworkController::UpdateFullBandwidthReached() {
+  if (full_bandwidth_reached_)
+    return;
+  int64_t bandwidth_bps = bandwidth_estimate_bps();
+  if (bandwidth_bps >= full_bandwidth_bps_ * kStartupGrowthTarget) {
+    full_bandwidth_bps_ = bandwidth_bps;
+    rounds_without_growth_ = 0;
+    return;
+  }
+  if (++rounds_without_growth_ >= kRoundsWithoutGrowthBeforeExitingStartup) {
+    full_bandwidth_reached_ = true;
+    LOG(LS_INFO) << "BBR startup done at " << bandwidth_bps << " bps.";
+  }
+}
+
+void BbrNetworkController::UpdateGainCycle(int64_t now_ms,
+                                           size_t data_in_flight,
+                                           bool has_losses) {
+  RTC_DCHECK(min_rtt_ms_);
+  int64_t elapsed_ms = now_ms - cycle_start_time_ms_;
+  bool advance = elapsed_ms > *min_rtt_ms_;
+  if (pacing_gain_ > 1.0f) {
+    // Stay in the probing phase until the extra data is in flight, unless it
+    // is lost or the sender can not produce it.
+    advance = advance &&
+              (has_losses ||
+               data_in_flight >= BandwidthDelayProductBytes(pacing_gain_) ||
+               elapsed_ms > 2 * *min_rtt_ms_);
+  } else if (pacing_gain_ < 1.0f) {
+    // Leave the draining phase as soon as the queue is gone.
+    advance = advance || data_in_flight <= BandwidthDelayProductBytes(1.0f);
+  }
+  if (advance) {
+    cycle_index_ = (cycle_index_ + 1) % kGainCycleLength;
+    cycle_start_time_ms_ = now_ms;
+    pacing_gain_ = kPacingGainCycle[cycle_index_];
+  }
+}
+
+void BbrNetworkController::UpdateProbeRtt(int64_t now_ms,
+                                          size_t data_in_flight) {
+  if (mode_ != Mode::kProbeRtt)
+    return;
+  if (!probe_rtt_done_time_ms_) {
+    if (data_in_flight <= kMinCongestionWindowBytes) {
+      probe_rtt_done_time_ms_.emplace(now_ms + kProbeRttDurationMs);
+      probe_rtt_done_round_ = round_count_ + 1;
+    }
+    return;
+  }
+  if (now_ms >= *probe_rtt_done_time_ms_ &&
+      round_count_ >= probe_rtt_done_round_) {
+    min_rtt_time_ms_ = now_ms;
+    if (full_bandwidth_reached_) {
+      EnterProbeBw(now_ms);
+    } else {
+      EnterStartup();
+    }
+  }
+}
+
+void BbrNetworkController::EnterStartup() {
+  mode_ = Mode::kStartup;
+  pacing_gain_ = kHighGain;
+  congestion_window_gain_ = kHighGain;
+}
+
+void BbrNetworkController::EnterProbeBw(int64_t now_ms) {
+  mode_ = Mode::kProbeBw;
+  congestion_window_gain_ = kCongestionWindowGain;
+  // Start at a random phase other than the draining one, so that flows
+  // sharing a bottleneck do not probe in lockstep.
+  cycle_index_ = random_.Rand(static_cast<uint32_t>(kGainCycleLength - 2));
+  if (cycle_index_ >= 1)
+    ++cycle_index_;
+  cycle_start_time_ms_ = now_ms;
+  pacing_gain_ = kPacingGainCycle[cycle_index_];
+}
+
+size_t BbrNetworkController::BandwidthDelayProductBytes(float gain) const {
+  if (!min_rtt_ms_ || bandwidth_samples_.empty())
+    return kMinCongestionWindowBytes;
+  size_t bdp_bytes = static_cast<size_t>(
+      gain * bandwidth_estimate_bps() * *min_rtt_ms_ / 8000);
+  return std::max(bdp_bytes, kMinCongestionWindowBytes);
+}
+
+NetworkControlUpdate BbrNetworkController::CreateUpdate() {
+  NetworkControlUpdate update;
+  rtc::Optional<size_t> congestion_window_bytes;
+  if (min_rtt_ms_) {
+    // Besides the round trip, the window covers the data sent while waiting
+    // for the next feedback report.
+    congestion_window_bytes.emplace(
+        mode_ == Mode::kProbeRtt
+            ? kMinCongestionWindowBytes
+            : BandwidthDelayProductBytes(congestion_window_gain_) +
+                  bandwidth_estimate_bps() * feedback_interval_ms_ / 8000);
+    if (in_recovery_) {
+      congestion_window_bytes.emplace(
+          std::min(*congestion_window_bytes, recovery_window_bytes_));
+    }
+  }
+  if (congestion_window_bytes != last_congestion_window_bytes_) {
+    update.congestion_window_bytes = congestion_window_bytes;
+    last_congestion_window_bytes_ = congestion_window_bytes;
+  }
+
+  // The encoder produces about the bandwidth estimate and the pacer cycles
+  // around it, except in startup where the extra data to find the capacity
+  // has to come from the encoder. The encoder is never given more than the
+  // pacer sends, or than the congestion window lets through each round trip,
+  // so that the queue in the pacer stays short. The round trip used for the
+  // window is the current one, as it grows with the queue startup builds.
+  int64_t pacing_rate_bps =
+      bandwidth_samples_.empty()
+          ? start_bitrate_bps_
+          : static_cast<int64_t>(pacing_gain_ * bandwidth_estimate_bps());
+  int64_t target_bitrate_bps = pacing_rate_bps;
+  if (mode_ != Mode::kStartup && !bandwidth_samples_.empty()) {
+    float encoder_gain =
+        std::min(pacing_gain_ == 1.0f ? kCruisingEncoderGain : 1.0f,
+                 pacing_gain_);
+    target_bitrate_bps =
+        static_cast<int64_t>(encoder_gain * bandwidth_estimate_bps());
+  }
+  int64_t rtt_ms = std::max(avg_rtt_ms_, min_rtt_ms_.value_or(0));
+  if (congestion_window_bytes && rtt_ms > 0) {
+    target_bitrate_bps = std::min<int64_t>(
+        target_bitrate_bps, *congestion_window_bytes * 8000 / rtt_ms);
+  }
+  target_bitrate_bps = std::max<int64_t>(target_bitrate_bps, min_bitrate_bps_);
+  if (max_bitrate_bps_ > 0) {
+    target_bitrate_bps =
+        std::min<int64_t>(target_bitrate_bps, max_bitrate_bps_);
+  }
+
+  float pacing_factor = std::max(
+      1.0f, static_cast<float>(pacing_rate_bps) / target_bitrate_bps);
+  if (last_pacing_factor_ != pacing_factor) {
+    update.pacing_factor = rtc::Optional<float>(pacing_factor);
+    last_pacing_factor_ = update.pacing_factor;
+  }
+
+  TargetTransferRate target_rate;
+  target_rate.target_bitrate_bps = static_cast<uint32_t>(target_bitrate_bps);
+  target_rate.fraction_loss = fraction_loss_;
+  target_rate.rtt_ms = avg_rtt_ms_ > 0 ? avg_rtt_ms_ : min_rtt_ms_.value_or(0);
+  target_rate.bwe_period_ms =
+      min_rtt_ms_ ? std::max<int64_t>(kGainCycleLength * *min_rtt_ms_, 1000)
+                  : kDefaultBwePeriodMs;
+  if (!last_target_rate_ ||
+      last_target_rate_->target_bitrate_bps != target_rate.target_bitrate_bps ||
+      last_target_rate_->fraction_loss != target_rate.fraction_loss ||
+      last_target_rate_->rtt_ms != target_rate.rtt_ms) {
+    update.target_rate = rtc::Optional<TargetTransferRate>(target_rate);
+    last_target_rate_ = update.target_rate;
+  }
+  return update;
+}
+
+}  // namespace webrtc
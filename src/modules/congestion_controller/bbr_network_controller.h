@@ -0,0 +1,144 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_CONGESTION_CONTROLLER_BBR_NETWORK_CONTROLLER_H_
+#define MODULES_CONGESTION_CONTROLLER_BBR_NETWORK_CONTROLLER_H_
+
+#include <deque>
+#include <vector>
+
+#include "api/optional.h"
+#include "modules/congestion_controller/include/network_controller.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/random.h"
+
+namespace webrtc {
+
+// Bottleneck bandwidth and round trip time congestion control. The controller
+// models the path by its maximum delivery rate over the last rounds and its
+// minimum round trip time, paces at a gain cycling around the delivery rate
+// and bounds the data in flight to a multiple of the bandwidth-delay product.
+//
+// The delivery rate is sampled from the receive times in transport feedback,
+// and the round trip time includes the feedback interval. Samples taken while
+// the pacer is application limited only raise the estimate.
+class BbrNetworkController : public NetworkControllerInterface {
+ public:
+  enum class Mode {
+    // Doubles the sending rate each round until the delivery rate stops
+    // growing.
+    kStartup,
+    // Drains the queue built during startup.
+    kDrain,
+    // Cycles the pacing gain around the bandwidth estimate.
+    kProbeBw,
+    // Shrinks the congestion window to measure the minimum round trip time.
+    kProbeRtt,
+  };
+
+  BbrNetworkController();
+  ~BbrNetworkController() override;
+
+  // Implements NetworkControllerInterface.
+  NetworkControlUpdate OnNetworkAvailability(bool network_available,
+                                             int64_t at_time_ms) override;
+  NetworkControlUpdate OnNetworkRouteChange(
+      const TargetRateConstraints& constraints,
+      int64_t at_time_ms) override;
+  NetworkControlUpdate OnTargetRateConstraints(
+      const TargetRateConstraints& constraints,
+      int64_t at_time_ms) override;
+  NetworkControlUpdate OnRoundTripTimeUpdate(int64_t avg_rtt_ms,
+                                             int64_t max_rtt_ms,
+                                             int64_t at_time_ms) override;
+  NetworkControlUpdate OnTransportPacketsFeedback(
+      const TransportPacketsFeedback& feedback) override;
+  NetworkControlUpdate OnProcessInterval(int64_t at_time_ms) override;
+
+  Mode mode() const { return mode_; }
+  // Zero until the first delivery rate sample.
+  int64_t bandwidth_estimate_bps() const;
+  rtc::Optional<int64_t> min_rtt_ms() const { return min_rtt_ms_; }
+
+ private:
+  struct BandwidthSample {
+    int64_t round;
+    int64_t bandwidth_bps;
+  };
+
+  void Reset();
+  void SetConstraints(const TargetRateConstraints& constraints);
+  void UpdateMinRtt(int64_t rtt_ms, int64_t now_ms);
+  void UpdateBandwidth(const std::vector<PacketFeedback>& received,
+                       bool app_limited);
+  void UpdateFullBandwidthReached();
+  void UpdateGainCycle(int64_t now_ms, size_t data_in_flight, bool has_losses);
+  void UpdateProbeRtt(int64_t now_ms, size_t data_in_flight);
+  void EnterStartup();
+  void EnterProbeBw(int64_t now_ms);
+  size_t BandwidthDelayProductBytes(float gain) const;
+  NetworkControlUpdate CreateUpdate();
+
+  Random random_;
+  int min_bitrate_bps_;
+  int max_bitrate_bps_;
+  int start_bitrate_bps_;
+
+  Mode mode_;
+  float pacing_gain_;
+  float congestion_window_gain_;
+
+  // Windowed maximum of the delivery rate, with the samples of later rounds
+  // in decreasing order of bandwidth.
+  std::deque<BandwidthSample> bandwidth_samples_;
+  // The delivery rate sample accumulates the feedback since this packet.
+  rtc::Optional<PacketFeedback> sample_start_packet_;
+  size_t sample_bytes_;
+
+  rtc::Optional<int64_t> min_rtt_ms_;
+  int64_t min_rtt_time_ms_;
+  int64_t avg_rtt_ms_;
+  // Time between the last two feedback reports, during which the data in
+  // flight grows without any being acked.
+  rtc::Optional<int64_t> last_feedback_time_ms_;
+  int64_t feedback_interval_ms_;
+
+  // A round ends when a packet sent after |round_start_time_ms_| is acked.
+  int64_t round_count_;
+  rtc::Optional<int64_t> round_start_time_ms_;
+
+  bool full_bandwidth_reached_;
+  int64_t full_bandwidth_bps_;
+  int rounds_without_growth_;
+
+  size_t cycle_index_;
+  int64_t cycle_start_time_ms_;
+
+  rtc::Optional<int64_t> probe_rtt_done_time_ms_;
+  int64_t probe_rtt_done_round_;
+
+  // Packet conservation after losses, until a packet sent after the loss was
+  // detected is acked.
+  bool in_recovery_;
+  int64_t recovery_start_time_ms_;
+  size_t recovery_window_bytes_;
+  size_t data_in_flight_bytes_;
+
+  uint8_t fraction_loss_;
+  rtc::Optional<TargetTransferRate> last_target_rate_;
+  rtc::Optional<size_t> last_congestion_window_bytes_;
+  rtc::Optional<float> last_pacing_factor_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(BbrNetworkController);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_CONGESTION_CONTROLLER_BBR_NETWORK_CONTROLLER_H_
@@ -0,0 +1,247 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "modules/congestion_controller/bbr_network_controller.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace test {
+
+namespace {
+
+constexpr size_t kPacketSizeBytes = 1200;
+constexpr int64_t kFeedbackIntervalMs = 50;
+constexpr int kMinBitrateBps = 30000;
+constexpr int kStartBitrateBps = 300000;
+constexpr int kMaxBitrateBps = 50000000;
+
+// A sender paced by the controller, sending through a single bottleneck link
+// with a FIFO queue, and getting transport feedback at a fixed interval.
+class BottleneckSimulation {
+ public:
+  BottleneckSimulation(BbrNetworkController* controller,
+                       int capacity_bps,
+                       int64_t one_way_delay_ms)
+      : controller_(controller),
+        capacity_bps_(capacity_bps),
+        one_way_delay_ms_(one_way_delay_ms),
+        now_ms_(0),
+        target_bitrate_bps_(0),
+        pacing_factor_(1.0f),
+        budget_bytes_(0),
+        link_free_time_ms_(0),
+        sequence_number_(0),
+        next_feedback_time_ms_(kFeedbackIntervalMs),
+        max_queue_delay_ms_(0) {}
+
+  void SetConstraints(int max_bitrate_bps) {
+    TargetRateConstraints constraints;
+    constraints.min_bitrate_bps = kMinBitrateBps;
+    constraints.start_bitrate_bps = kStartBitrateBps;
+    constraints.max_bitrate_bps = max_bitrate_bps;
+    Apply(controller_->OnNetworkRouteChange(constraints, now_ms_));
+  }
+
+  void set_one_way_delay_ms(int64_t one_way_delay_ms) {
+    one_way_delay_ms_ = one_way_delay_ms;
+  }
+
+  void RunFor(int64_t duration_ms) {
+    for (int64_t end_ms = now_ms_ + duration_ms; now_ms_ < end_ms; ++now_ms_) {
+      SendPackets();
+      if (now_ms_ >= next_feedback_time_ms_) {
+        SendFeedback();
+        next_feedback_time_ms_ += kFeedbackIntervalMs;
+      }
+      if (now_ms_ % 25 == 0)
+        Apply(controller_->OnProcessInterval(now_ms_));
+    }
+  }
+
+  uint32_t target_bitrate_bps() const { return target_bitrate_bps_; }
+  int64_t max_queue_delay_ms() const { return max_queue_delay_ms_; }
+  void reset_max_queue_delay() { max_queue_delay_ms_ = 0; }
+  // The congestion windows reported in probe RTT mode.
+  const std::vector<size_t>& probe_rtt_windows() const {
+    return probe_rtt_windows_;
+  }
+
+ private:
+  size_t DataInFlight() const {
+    return in_flight_.size() * kPacketSizeBytes;
+  }
+
+  void SendPackets() {
+    budget_bytes_ += pacing_factor_ * target_bitrate_bps_ / 8000.0;
+    budget_bytes_ = std::min(budget_bytes_, 2.0 * kPacketSizeBytes);
+    while (budget_bytes_ >= kPacketSizeBytes) {
+      if (congestion_window_bytes_ &&
+          DataInFlight() + kPacketSizeBytes > *congestion_window_bytes_) {
+        // Window limited; the budget is not carried over.
+        budget_bytes_ = 0;
+        return;
+      }
+      budget_bytes_ -= kPacketSizeBytes;
+      PacketFeedback packet(PacketFeedback::kNotReceived, now_ms_,
+                            sequence_number_++, kPacketSizeBytes,
+                            PacedPacketInfo());
+      link_free_time_ms_ = std::max<double>(now_ms_, link_free_time_ms_) +
+                           kPacketSizeBytes * 8000.0 / capacity_bps_;
+      int64_t departure_time_ms = static_cast<int64_t>(link_free_time_ms_);
+      max_queue_delay_ms_ =
+          std::max(max_queue_delay_ms_, departure_time_ms - now_ms_);
+      packet.arrival_time_ms = departure_time_ms + one_way_delay_ms_;
+      in_flight_.push_back(packet);
+    }
+  }
+
+  void SendFeedback() {
+    TransportPacketsFeedback feedback;
+    feedback.feedback_time_ms = now_ms_;
+    // The feedback travels back over the same delay.
+    while (!in_flight_.empty() &&
+           in_flight_.front().arrival_time_ms + one_way_delay_ms_ <= now_ms_) {
+      feedback.packet_feedbacks.push_back(in_flight_.front());
+      in_flight_.pop_front();
+    }
+    if (feedback.packet_feedbacks.empty())
+      return;
+    feedback.data_in_flight_bytes = DataInFlight();
+    Apply(controller_->OnTransportPacketsFeedback(feedback));
+  }
+
+  void Apply(const NetworkControlUpdate& update) {
+    if (update.target_rate)
+      target_bitrate_bps_ = update.target_rate->target_bitrate_bps;
+    if (update.pacing_factor)
+      pacing_factor_ = *update.pacing_factor;
+    if (update.congestion_window_bytes) {
+      congestion_window_bytes_ = update.congestion_window_bytes;
+      if (controller_->mode() == BbrNetworkController::Mode::kProbeRtt)
+        probe_rtt_windows_.push_back(*update.congestion_window_bytes);
+    }
+  }
+
+  BbrNetworkController* const controller_;
+  const int capacity_bps_;
+  int64_t one_way_delay_ms_;
+  int64_t now_ms_;
+  uint32_t target_bitrate_bps_;
+  float pacing_factor_;
+  rtc::Optional<size_t> congestion_window_bytes_;
+  double budget_bytes_;
+  double link_free_time_ms_;
+  uint16_t sequence_number_;
+  int64_t next_feedback_time_ms_;
+  int64_t max_queue_delay_ms_;
+  std::deque<PacketFeedback> in_flight_;
+  std::vector<size_t> probe_rtt_windows_;
+};
+
+}  // namespace
+
+TEST(BbrNetworkControllerTest, ReportsStartBitrateAndPacingFactor) {
+  BbrNetworkController controller;
+  TargetRateConstraints constraints;
+  constraints.min_bitrate_bps = kMinBitrateBps;
+  constraints.start_bitrate_bps = kStartBitrateBps;
+  constraints.max_bitrate_bps = kMaxBitrateBps;
+  NetworkControlUpdate update =
+      controller.OnNetworkRouteChange(constraints, 0);
+  ASSERT_TRUE(update.target_rate);
+  EXPECT_EQ(kStartBitrateBps,
+            static_cast<int>(update.target_rate->target_bitrate_bps));
+  ASSERT_TRUE(update.pacing_factor);
+  EXPECT_EQ(1.0f, *update.pacing_factor);
+  EXPECT_FALSE(update.congestion_window_bytes);
+  EXPECT_EQ(BbrNetworkController::Mode::kStartup, controller.mode());
+
+  // Nothing changed, so nothing is reported.
+  update = controller.OnProcessInterval(25);
+  EXPECT_FALSE(update.target_rate);
+  EXPECT_FALSE(update.pacing_factor);
+}
+
+TEST(BbrNetworkControllerTest, ConvergesToBottleneckCapacity) {
+  const int kCapacityBps = 2000000;
+  BbrNetworkController controller;
+  BottleneckSimulation simulation(&controller, kCapacityBps, 40);
+  simulation.SetConstraints(kMaxBitrateBps);
+  simulation.RunFor(20000);
+
+  EXPECT_EQ(BbrNetworkController::Mode::kProbeBw, controller.mode());
+  EXPECT_NEAR(kCapacityBps, controller.bandwidth_estimate_bps(),
+              0.1 * kCapacityBps);
+  ASSERT_TRUE(controller.min_rtt_ms());
+  // Round trip propagation delay plus at most one feedback interval.
+  EXPECT_GE(*controller.min_rtt_ms(), 80);
+  EXPECT_LE(*controller.min_rtt_ms(), 80 + kFeedbackIntervalMs);
+
+  // The queue stays bounded by the congestion window once startup is over.
+  simulation.reset_max_queue_delay();
+  simulation.RunFor(10000);
+  EXPECT_LT(simulation.max_queue_delay_ms(), 2 * *controller.min_rtt_ms());
+}
+
+TEST(BbrNetworkControllerTest, RespectsMaxBitrate) {
+  const int kCapacityBps = 2000000;
+  const int kMaxBitrateLimitBps = 500000;
+  BbrNetworkController controller;
+  BottleneckSimulation simulation(&controller, kCapacityBps, 20);
+  simulation.SetConstraints(kMaxBitrateLimitBps);
+  for (int i = 0; i < 100; ++i) {
+    simulation.RunFor(100);
+    ASSERT_LE(simulation.target_bitrate_bps(),
+              static_cast<uint32_t>(kMaxBitrateLimitBps));
+  }
+  EXPECT_EQ(static_cast<uint32_t>(kMaxBitrateLimitBps),
+            simulation.target_bitrate_bps());
+}
+
+TEST(BbrNetworkControllerTest, ProbesRttWithMinimalWindowWhenRttIncreases) {
+  const int kCapacityBps = 1000000;
+  BbrNetworkController controller;
+  BottleneckSimulation simulation(&controller, kCapacityBps, 20);
+  simulation.SetConstraints(kMaxBitrateBps);
+  simulation.RunFor(5000);
+  ASSERT_TRUE(controller.min_rtt_ms());
+  int64_t old_min_rtt_ms = *controller.min_rtt_ms();
+  EXPECT_TRUE(simulation.probe_rtt_windows().empty());
+
+  // The old minimum is never seen again, and expires.
+  simulation.set_one_way_delay_ms(100);
+  simulation.RunFor(15000);
+  ASSERT_FALSE(simulation.probe_rtt_windows().empty());
+  EXPECT_EQ(4 * 1500u, simulation.probe_rtt_windows().front());
+  EXPECT_EQ(BbrNetworkController::Mode::kProbeBw, controller.mode());
+  ASSERT_TRUE(controller.min_rtt_ms());
+  EXPECT_GT(*controller.min_rtt_ms(), old_min_rtt_ms + 100);
+}
+
+TEST(BbrNetworkControllerTest, RouteChangeRestartsStartup) {
+  BbrNetworkController controller;
+  BottleneckSimulation simulation(&controller, 1000000, 20);
+  simulation.SetConstraints(kMaxBitrateBps);
+  simulation.RunFor(5000);
+  EXPECT_NE(BbrNetworkController::Mode::kStartup, controller.mode());
+
+  simulation.SetConstraints(kMaxBitrateBps);
+  EXPECT_EQ(BbrNetworkController::Mode::kStartup, controller.mode());
+  EXPECT_EQ(0, controller.bandwidth_estimate_bps());
+  EXPECT_EQ(static_cast<uint32_t>(kStartBitrateBps),
+            simulation.target_bitrate_bps());
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,227 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/congestion_controller/goog_cc_network_controller.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "modules/bitrate_controller/include/bitrate_controller.h"
+#include "modules/congestion_controller/acknowledged_bitrate_estimator.h"
+#include "modules/congestion_controller/delay_based_bwe.h"
+#include "modules/congestion_controller/probe_controller.h"
+#include "modules/remote_bitrate_estimator/include/bwe_defines.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/format_macros.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/ptr_util.h"
+#include "system_wrappers/include/field_trial.h"
+
+namespace webrtc {
+namespace {
+
+const char kCwndExperiment[] = "WebRTC-CwndExperiment";
+const int64_t kDefaultAcceptedQueueMs = 250;
+const size_t kMinCwndBytes = 2 * 1500;
+
+bool CwndExperimentEnabled() {
+  std::string experiment_string =
+      webrtc::field_trial::FindFullName(kCwndExperiment);
+  // The experiment is enabled iff the field trial string begins with "Enabled".
+  return experiment_string.find("Enabled") == 0;
+}
+
+bool ReadCwndExperimentParameter(int64_t* accepted_queue_ms) {
+  RTC_DCHECK(accepted_queue_ms);
+  std::string experiment_string =
+      webrtc::field_trial::FindFullName(kCwndExperiment);
+  int parsed_values =
+      sscanf(experiment_string.c_str(), "Enabled-%" PRId64, accepted_queue_ms);
+  if (parsed_values == 1) {
+    RTC_CHECK_GE(*accepted_queue_ms, 0)
+        << "Accepted must be greater than or equal to 0.";
+    return true;
+  }
+  return false;
+}
+
+std::vector<PacketFeedback> ReceivedPacketFeedbackVector(
+    const std::vector<PacketFeedback>& input) {
+  std::vector<PacketFeedback> received_packet_feedback_vector;
+  auto is_received = [](const PacketFeedback& packet_feedback) {
+    return packet_feedback.arrival_time_ms != PacketFeedback::kNotReceived;
+  };
+  std::copy_if(input.begin(), input.end(),
+               std::back_inserter(received_packet_feedback_vector),
+               is_received);
+  return received_packet_feedback_vector;
+}
+
+}  // namespace
+
+GoogCcNetworkController::GoogCcNetworkController(
+    const Clock* clock,
+    RtcEventLog* event_log,
+    BitrateController* bitrate_controller)
+    : clock_(clock),
+      event_log_(event_log),
+      bitrate_controller_(bitrate_controller),
+      acknowledged_bitrate_estimator_(
+          rtc::MakeUnique<AcknowledgedBitrateEstimator>()),
+      delay_based_bwe_(new DelayBasedBwe(event_log_, clock_)),
+      probe_controller_(new ProbeController(clock_)),
+      last_target_bitrate_bps_(0),
+      was_in_alr_(false),
+      in_cwnd_experiment_(CwndExperimentEnabled()),
+      accepted_queue_ms_(kDefaultAcceptedQueueMs) {
+  RTC_DCHECK(bitrate_controller_);
+  delay_based_bwe_->SetMinBitrate(congestion_controller::GetMinBitrateBps());
+  if (in_cwnd_experiment_ &&
+      !ReadCwndExperimentParameter(&accepted_queue_ms_)) {
+    LOG(LS_WARNING) << "Failed to parse parameters for CwndExperiment "
+                       "from field trial string. Experiment disabled.";
+    in_cwnd_experiment_ = false;
+  }
+}
+
+GoogCcNetworkController::~GoogCcNetworkController() {}
+
+NetworkControlUpdate GoogCcNetworkController::OnNetworkAvailability(
+    bool network_available,
+    int64_t at_time_ms) {
+  probe_controller_->OnNetworkStateChanged(network_available ? kNetworkUp
+                                                             : kNetworkDown);
+  return MaybeTriggerOnNetworkChanged();
+}
+
+NetworkControlUpdate GoogCcNetworkController::OnNetworkRouteChange(
+    const TargetRateConstraints& constraints,
+    int64_t at_time_ms) {
+  // TODO(honghaiz): Recreate this object once the bitrate controller is
+  // no longer exposed outside SendSideCongestionController.
+  bitrate_controller_->ResetBitrates(constraints.start_bitrate_bps,
+                                     constraints.min_bitrate_bps,
+                                     constraints.max_bitrate_bps);
+
+  delay_based_bwe_.reset(new DelayBasedBwe(event_log_, clock_));
+  acknowledged_bitrate_estimator_.reset(new AcknowledgedBitrateEstimator());
+  delay_based_bwe_->SetStartBitrate(constraints.start_bitrate_bps);
+  delay_based_bwe_->SetMinBitrate(constraints.min_bitrate_bps);
+
+  probe_controller_->Reset();
+  probe_controller_->SetBitrates(constraints.min_bitrate_bps,
+                                 constraints.start_bitrate_bps,
+                                 constraints.max_bitrate_bps);
+  return MaybeTriggerOnNetworkChanged();
+}
+
+NetworkControlUpdate GoogCcNetworkController::OnTargetRateConstraints(
+    const TargetRateConstraints& constraints,
+    int64_t at_time_ms) {
+  bitrate_controller_->SetBitrates(constraints.start_bitrate_bps,
+                                   constraints.min_bitrate_bps,
+                                   constraints.max_bitrate_bps);
+  probe_controller_->SetBitrates(constraints.min_bitrate_bps,
+                                 constraints.start_bitrate_bps,
+                                 constraints.max_bitrate_bps);
+  if (constraints.start_bitrate_bps > 0)
+    delay_based_bwe_->SetStartBitrate(constraints.start_bitrate_bps);
+  delay_based_bwe_->SetMinBitrate(constraints.min_bitrate_bps);
+  return MaybeTriggerOnNetworkChanged();
+}
+
+NetworkControlUpdate GoogCcNetworkController::OnRoundTripTimeUpdate(
+    int64_t avg_rtt_ms,
+    int64_t max_rtt_ms,
+    int64_t at_time_ms) {
+  delay_based_bwe_->OnRttUpdate(avg_rtt_ms, max_rtt_ms);
+  return NetworkControlUpdate();
+}
+
+NetworkControlUpdate GoogCcNetworkController::OnTransportPacketsFeedback(
+    const TransportPacketsFeedback& feedback) {
+  std::vector<PacketFeedback> feedback_vector =
+      ReceivedPacketFeedbackVector(feedback.packet_feedbacks);
+  std::sort(feedback_vector.begin(), feedback_vector.end(),
+            PacketFeedbackComparator());
+
+  bool currently_in_alr = feedback.alr_start_time_ms.has_value();
+  if (was_in_alr_ && !currently_in_alr) {
+    acknowledged_bitrate_estimator_->SetAlrEndedTimeMs(
+        feedback.feedback_time_ms);
+    probe_controller_->SetAlrEndedTimeMs(feedback.feedback_time_ms);
+  }
+  was_in_alr_ = currently_in_alr;
+  probe_controller_->SetAlrStartTimeMs(feedback.alr_start_time_ms);
+
+  acknowledged_bitrate_estimator_->IncomingPacketFeedbackVector(
+      feedback_vector);
+  DelayBasedBwe::Result result = delay_based_bwe_->IncomingPacketFeedbackVector(
+      feedback_vector, acknowledged_bitrate_estimator_->bitrate_bps());
+
+  NetworkControlUpdate update;
+  if (result.updated) {
+    bitrate_controller_->OnDelayBasedBweResult(result);
+    // Update the estimate in the ProbeController, in case we want to probe.
+    update = MaybeTriggerOnNetworkChanged();
+  }
+  if (result.recovered_from_overuse) {
+    probe_controller_->RequestProbe();
+    std::vector<int> probes = probe_controller_->GetAndResetPendingProbes();
+    update.probe_cluster_bitrates_bps.insert(
+        update.probe_cluster_bitrates_bps.end(), probes.begin(), probes.end());
+  }
+
+  // No valid RTT. Could be because send-side BWE isn't used, in which case
+  // we don't try to limit the outstanding packets.
+  if (in_cwnd_experiment_ && feedback.min_feedback_rtt_ms) {
+    update.congestion_window_bytes.emplace(std::max<size_t>(
+        (*feedback.min_feedback_rtt_ms + accepted_queue_ms_) *
+            last_target_bitrate_bps_ / 1000 / 8,
+        kMinCwndBytes));
+  }
+  return update;
+}
+
+NetworkControlUpdate GoogCcNetworkController::OnProcessInterval(
+    int64_t at_time_ms) {
+  bitrate_controller_->Process();
+  probe_controller_->Process();
+  return MaybeTriggerOnNetworkChanged();
+}
+
+void GoogCcNetworkController::EnablePeriodicAlrProbing(bool enable) {
+  probe_controller_->EnablePeriodicAlrProbing(enable);
+}
+
+NetworkControlUpdate GoogCcNetworkController::MaybeTriggerOnNetworkChanged() {
+  NetworkControlUpdate update;
+  uint32_t bitrate_bps;
+  uint8_t fraction_loss;
+  int64_t rtt_ms;
+  if (bitrate_controller_->GetNetworkParameters(&bitrate_bps, &fraction_loss,
+                                                &rtt_ms)) {
+    probe_controller_->SetEstimatedBitrate(bitrate_bps);
+    last_target_bitrate_bps_ = bitrate_bps;
+
+    TargetTransferRate target_rate;
+    target_rate.target_bitrate_bps = bitrate_bps;
+    target_rate.fraction_loss = fraction_loss;
+    target_rate.rtt_ms = rtt_ms;
+    target_rate.bwe_period_ms = delay_based_bwe_->GetExpectedBwePeriodMs();
+    update.target_rate = rtc::Optional<TargetTransferRate>(target_rate);
+  }
+  update.probe_cluster_bitrates_bps =
+      probe_controller_->GetAndResetPendingProbes();
+  return update;
+}
+
+}  // namespace webrtc
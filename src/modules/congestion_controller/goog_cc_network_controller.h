@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_CONGESTION_CONTROLLER_GOOG_CC_NETWORK_CONTROLLER_H_
+#define MODULES_CONGESTION_CONTROLLER_GOOG_CC_NETWORK_CONTROLLER_H_
+
+#include <memory>
+
+#include "modules/congestion_controller/include/network_controller.h"
+#include "rtc_base/constructormagic.h"
+
+namespace webrtc {
+
+class AcknowledgedBitrateEstimator;
+class BitrateController;
+class Clock;
+class DelayBasedBwe;
+class ProbeController;
+class RtcEventLog;
+
+// The Google congestion controller: the minimum of a delay based estimate from
+// transport feedback and a loss based estimate from RTCP receiver reports,
+// with probing to find the initial capacity and to recover after drops.
+class GoogCcNetworkController : public NetworkControllerInterface {
+ public:
+  // |bitrate_controller| holds the loss based estimate. It receives the RTCP
+  // reports directly, and must outlive the controller.
+  GoogCcNetworkController(const Clock* clock,
+                          RtcEventLog* event_log,
+                          BitrateController* bitrate_controller);
+  ~GoogCcNetworkController() override;
+
+  // Implements NetworkControllerInterface.
+  NetworkControlUpdate OnNetworkAvailability(bool network_available,
+                                             int64_t at_time_ms) override;
+  NetworkControlUpdate OnNetworkRouteChange(
+      const TargetRateConstraints& constraints,
+      int64_t at_time_ms) override;
+  NetworkControlUpdate OnTargetRateConstraints(
+      const TargetRateConstraints& constraints,
+      int64_t at_time_ms) override;
+  NetworkControlUpdate OnRoundTripTimeUpdate(int64_t avg_rtt_ms,
+                                             int64_t max_rtt_ms,
+                                             int64_t at_time_ms) override;
+  NetworkControlUpdate OnTransportPacketsFeedback(
+      const TransportPacketsFeedback& feedback) override;
+  NetworkControlUpdate OnProcessInterval(int64_t at_time_ms) override;
+  void EnablePeriodicAlrProbing(bool enable) override;
+
+ private:
+  // Reports the estimate if it changed, and the probes to send.
+  NetworkControlUpdate MaybeTriggerOnNetworkChanged();
+
+  const Clock* const clock_;
+  RtcEventLog* const event_log_;
+  BitrateController* const bitrate_controller_;
+  std::unique_ptr<AcknowledgedBitrateEstimator> acknowledged_bitrate_estimator_;
+  std::unique_ptr<DelayBasedBwe> delay_based_bwe_;
+  const std::unique_ptr<ProbeController> probe_controller_;
+  uint32_t last_target_bitrate_bps_;
+  bool was_in_alr_;
+  bool in_cwnd_experiment_;
+  int64_t accepted_queue_ms_;
+
+  RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(GoogCcNetworkController);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_CONGESTION_CONTROLLER_GOOG_CC_NETWORK_CONTROLLER_H_
@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+
+#include "logging/rtc_event_log/mock/mock_rtc_event_log.h"
+#include "modules/bitrate_controller/include/bitrate_controller.h"
+#include "modules/congestion_controller/goog_cc_network_controller.h"
+#include "system_wrappers/include/clock.h"
+#include "test/field_trial.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+using testing::NiceMock;
+
+namespace webrtc {
+namespace test {
+
+namespace {
+
+constexpr int kMinBitrateBps = 10000;
+constexpr int kStartBitrateBps = 300000;
+constexpr int kMaxBitrateBps = 2000000;
+
+TargetRateConstraints Constraints(int start_bitrate_bps) {
+  TargetRateConstraints constraints;
+  constraints.min_bitrate_bps = kMinBitrateBps;
+  constraints.start_bitrate_bps = start_bitrate_bps;
+  constraints.max_bitrate_bps = kMaxBitrateBps;
+  return constraints;
+}
+
+}  // namespace
+
+class GoogCcNetworkControllerTest : public ::testing::Test {
+ protected:
+  GoogCcNetworkControllerTest() : clock_(123456) {}
+
+  void SetUp() override {
+    bitrate_controller_.reset(
+        BitrateController::CreateBitrateController(&clock_, &event_log_));
+    controller_.reset(new GoogCcNetworkController(&clock_, &event_log_,
+                                                  bitrate_controller_.get()));
+  }
+
+  TransportPacketsFeedback CreateFeedback(int64_t min_feedback_rtt_ms) {
+    TransportPacketsFeedback feedback;
+    feedback.feedback_time_ms = clock_.TimeInMilliseconds();
+    for (uint16_t i = 0; i < 10; ++i) {
+      PacketFeedback packet(clock_.TimeInMilliseconds() - 100 + 10 * i,
+                            clock_.TimeInMilliseconds() - 150 + 10 * i, i,
+                            1200, PacedPacketInfo());
+      feedback.packet_feedbacks.push_back(packet);
+    }
+    feedback.min_feedback_rtt_ms =
+        rtc::Optional<int64_t>(min_feedback_rtt_ms);
+    return feedback;
+  }
+
+  SimulatedClock clock_;
+  NiceMock<MockRtcEventLog> event_log_;
+  std::unique_ptr<BitrateController> bitrate_controller_;
+  std::unique_ptr<GoogCcNetworkController> controller_;
+};
+
+TEST_F(GoogCcNetworkControllerTest, ReportsStartBitrateAndInitialProbes) {
+  NetworkControlUpdate update = controller_->OnTargetRateConstraints(
+      Constraints(kStartBitrateBps), clock_.TimeInMilliseconds());
+  ASSERT_TRUE(update.target_rate);
+  EXPECT_EQ(static_cast<uint32_t>(kStartBitrateBps),
+            update.target_rate->target_bitrate_bps);
+  EXPECT_THAT(update.probe_cluster_bitrates_bps,
+              ElementsAre(3 * kStartBitrateBps, 6 * kStartBitrateBps));
+  EXPECT_FALSE(update.congestion_window_bytes);
+
+  // Unchanged estimates and no new probes are not reported again.
+  clock_.AdvanceTimeMilliseconds(25);
+  update = controller_->OnProcessInterval(clock_.TimeInMilliseconds());
+  EXPECT_FALSE(update.target_rate);
+  EXPECT_THAT(update.probe_cluster_bitrates_bps, IsEmpty());
+}
+
+TEST_F(GoogCcNetworkControllerTest, RouteChangeResetsEstimateAndProbes) {
+  controller_->OnTargetRateConstraints(Constraints(kStartBitrateBps),
+                                       clock_.TimeInMilliseconds());
+  clock_.AdvanceTimeMilliseconds(25);
+  const int kNewStartBitrateBps = 200000;
+  NetworkControlUpdate update = controller_->OnNetworkRouteChange(
+      Constraints(kNewStartBitrateBps), clock_.TimeInMilliseconds());
+  ASSERT_TRUE(update.target_rate);
+  EXPECT_EQ(static_cast<uint32_t>(kNewStartBitrateBps),
+            update.target_rate->target_bitrate_bps);
+  EXPECT_THAT(update.probe_cluster_bitrates_bps,
+              ElementsAre(3 * kNewStartBitrateBps, 6 * kNewStartBitrateBps));
+}
+
+TEST_F(GoogCcNetworkControllerTest, NoCongestionWindowByDefault) {
+  controller_->OnTargetRateConstraints(Constraints(kStartBitrateBps),
+                                       clock_.TimeInMilliseconds());
+  clock_.AdvanceTimeMilliseconds(25);
+  NetworkControlUpdate update =
+      controller_->OnTransportPacketsFeedback(CreateFeedback(100));
+  EXPECT_FALSE(update.congestion_window_bytes);
+}
+
+TEST_F(GoogCcNetworkControllerTest, CongestionWindowInCwndExperiment) {
+  ScopedFieldTrials trial("WebRTC-CwndExperiment/Enabled-250/");
+  SetUp();
+  controller_->OnTargetRateConstraints(Constraints(kStartBitrateBps),
+                                       clock_.TimeInMilliseconds());
+  clock_.AdvanceTimeMilliseconds(25);
+  NetworkControlUpdate update =
+      controller_->OnTransportPacketsFeedback(CreateFeedback(100));
+  ASSERT_TRUE(update.congestion_window_bytes);
+  // (min feedback rtt + accepted queue) * target bitrate.
+  EXPECT_EQ(static_cast<size_t>((100 + 250) * kStartBitrateBps / 8000),
+            *update.congestion_window_bytes);
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -0,0 +1,118 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_CONGESTION_CONTROLLER_INCLUDE_NETWORK_CONTROLLER_H_
+#define MODULES_CONGESTION_CONTROLLER_INCLUDE_NETWORK_CONTROLLER_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "api/optional.h"
+#include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+
+namespace webrtc {
+
+struct TargetRateConstraints {
+  int min_bitrate_bps = 0;
+  // Zero or negative if the start bitrate is not changed.
+  int start_bitrate_bps = 0;
+  // Zero or negative if there is no upper limit.
+  int max_bitrate_bps = 0;
+};
+
+struct TransportPacketsFeedback {
+  TransportPacketsFeedback();
+  TransportPacketsFeedback(const TransportPacketsFeedback&);
+  TransportPacketsFeedback(TransportPacketsFeedback&&);
+  ~TransportPacketsFeedback();
+  TransportPacketsFeedback& operator=(const TransportPacketsFeedback&);
+  TransportPacketsFeedback& operator=(TransportPacketsFeedback&&);
+
+  // The packets reported by one transport feedback message, including lost
+  // packets, with the send information of the packets filled in.
+  std::vector<PacketFeedback> ReceivedWithSendInfo() const;
+  std::vector<PacketFeedback> LostWithSendInfo() const;
+
+  int64_t feedback_time_ms = 0;
+  std::vector<PacketFeedback> packet_feedbacks;
+  // Bytes sent but not yet acknowledged, after this feedback was applied.
+  size_t data_in_flight_bytes = 0;
+  // The start of the current application limited region of the pacer, if any.
+  rtc::Optional<int64_t> alr_start_time_ms;
+  // The smallest round trip time seen from sending a packet until receiving
+  // its feedback.
+  rtc::Optional<int64_t> min_feedback_rtt_ms;
+};
+
+struct TargetTransferRate {
+  uint32_t target_bitrate_bps = 0;
+  uint8_t fraction_loss = 0;  // 0 - 255.
+  int64_t rtt_ms = 0;
+  // The expected time it takes the estimate to react to a capacity increase.
+  int64_t bwe_period_ms = 0;
+};
+
+// The output of a NetworkControllerInterface. Fields are only set when they
+// change.
+struct NetworkControlUpdate {
+  NetworkControlUpdate();
+  NetworkControlUpdate(const NetworkControlUpdate&);
+  NetworkControlUpdate(NetworkControlUpdate&&);
+  ~NetworkControlUpdate();
+  NetworkControlUpdate& operator=(const NetworkControlUpdate&);
+  NetworkControlUpdate& operator=(NetworkControlUpdate&&);
+
+  // Adds the fields set in |other|, overriding the fields set in both.
+  void Merge(const NetworkControlUpdate& other);
+
+  rtc::Optional<TargetTransferRate> target_rate;
+  // The pacer sends media at |pacing_factor| times the target rate. Only set
+  // by controllers that override the pacing factor of the pacer.
+  rtc::Optional<float> pacing_factor;
+  // The pacer is paused while more than |congestion_window_bytes| are in
+  // flight.
+  rtc::Optional<size_t> congestion_window_bytes;
+  // Bitrates of the probe clusters to send.
+  std::vector<int> probe_cluster_bitrates_bps;
+};
+
+// An event driven congestion controller. The controller is told about events
+// on the network and returns how the sending should adapt. Not thread safe;
+// the owner must serialize the calls.
+class NetworkControllerInterface {
+ public:
+  virtual ~NetworkControllerInterface() {}
+
+  virtual NetworkControlUpdate OnNetworkAvailability(bool network_available,
+                                                     int64_t at_time_ms) = 0;
+  // The estimate restarts from |constraints.start_bitrate_bps|.
+  virtual NetworkControlUpdate OnNetworkRouteChange(
+      const TargetRateConstraints& constraints,
+      int64_t at_time_ms) = 0;
+  virtual NetworkControlUpdate OnTargetRateConstraints(
+      const TargetRateConstraints& constraints,
+      int64_t at_time_ms) = 0;
+  virtual NetworkControlUpdate OnRoundTripTimeUpdate(int64_t avg_rtt_ms,
+                                                     int64_t max_rtt_ms,
+                                                     int64_t at_time_ms) = 0;
+  virtual NetworkControlUpdate OnTransportPacketsFeedback(
+      const TransportPacketsFeedback& feedback) = 0;
+  // Called periodically, at least every 25 ms.
+  virtual NetworkControlUpdate OnProcessInterval(int64_t at_time_ms) = 0;
+
+  // Probe for a higher rate while the pacer is application limited.
+  // Controllers that do not probe ignore this.
+  virtual void EnablePeriodicAlrProbing(bool enable) {}
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_CONGESTION_CONTROLLER_INCLUDE_NETWORK_CONTROLLER_H_
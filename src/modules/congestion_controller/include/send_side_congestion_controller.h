@@ -15,7 +15,9 @@
 #include <vector>
 
 #include "common_types.h"  // NOLINT(build/include)
+#include "api/optional.h"
 #include "modules/congestion_controller/delay_based_bwe.h"
+#include "modules/congestion_controller/include/network_controller.h"
 #include "modules/congestion_controller/transport_feedback_adapter.h"
 #include "modules/include/module.h"
 #include "modules/include/module_common_types.h"
@@ -34,11 +36,13 @@ namespace webrtc {
 
 class BitrateController;
 class Clock;
-class AcknowledgedBitrateEstimator;
-class ProbeController;
 class RateLimiter;
 class RtcEventLog;
 
+// Applies the decisions of a NetworkControllerInterface to the pacer and
+// reports the target rate to the observer. The controller is the Google
+// congestion controller, or BBR with the field trial "WebRTC-BweBbrController"
+// set to "Enabled".
 class SendSideCongestionController : public CallStatsObserver,
                                      public Module,
                                      public TransportFeedbackObserver {
@@ -116,6 +120,9 @@ class SendSideCongestionController : public CallStatsObserver,
   std::vector<PacketFeedback> GetTransportFeedbackVector() const override;
 
  private:
+  // Applies |update| to the pacer, but leaves reporting to the observer to
+  // MaybeTriggerOnNetworkChanged().
+  void ApplyUpdate(const NetworkControlUpdate& update);
   void MaybeTriggerOnNetworkChanged();
 
   bool IsSendQueueFull() const;
@@ -130,9 +137,9 @@ class SendSideCongestionController : public CallStatsObserver,
   RtcEventLog* const event_log_;
   std::unique_ptr<PacedSender> owned_pacer_;
   PacedSender* pacer_;
+  // Receives the RTCP reports, and holds the loss based estimate of the Google
+  // congestion controller.
   const std::unique_ptr<BitrateController> bitrate_controller_;
-  std::unique_ptr<AcknowledgedBitrateEstimator> acknowledged_bitrate_estimator_;
-  const std::unique_ptr<ProbeController> probe_controller_;
   const std::unique_ptr<RateLimiter> retransmission_rate_limiter_;
   TransportFeedbackAdapter transport_feedback_adapter_;
   rtc::CriticalSection network_state_lock_;
@@ -140,19 +147,25 @@ class SendSideCongestionController : public CallStatsObserver,
   uint8_t last_reported_fraction_loss_ RTC_GUARDED_BY(network_state_lock_);
   int64_t last_reported_rtt_ RTC_GUARDED_BY(network_state_lock_);
   NetworkState network_state_ RTC_GUARDED_BY(network_state_lock_);
+  rtc::Optional<TargetTransferRate> target_rate_
+      RTC_GUARDED_BY(network_state_lock_);
+  rtc::Optional<size_t> congestion_window_bytes_
+      RTC_GUARDED_BY(network_state_lock_);
+  bool congestion_window_full_ RTC_GUARDED_BY(network_state_lock_);
   bool pause_pacer_ RTC_GUARDED_BY(network_state_lock_);
   // Duplicate the pacer paused state to avoid grabbing a lock when
   // pausing the pacer. This can be removed when we move this class
   // over to the task queue.
   bool pacer_paused_;
   rtc::CriticalSection bwe_lock_;
-  int min_bitrate_bps_ RTC_GUARDED_BY(bwe_lock_);
-  std::unique_ptr<DelayBasedBwe> delay_based_bwe_ RTC_GUARDED_BY(bwe_lock_);
-  bool in_cwnd_experiment_;
-  int64_t accepted_queue_ms_;
-  bool was_in_alr_;
+  const std::unique_ptr<NetworkControllerInterface> controller_
+      RTC_GUARDED_BY(bwe_lock_);
 
   rtc::RaceChecker worker_race_;
+  // Reused for every transport feedback, so that its packet vector is not
+  // reallocated each time.
+  TransportPacketsFeedback transport_packets_feedback_
+      RTC_GUARDED_BY(worker_race_);
 
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(SendSideCongestionController);
 };
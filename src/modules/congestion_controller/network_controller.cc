@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/congestion_controller/include/network_controller.h"
+
+namespace webrtc {
+
+TransportPacketsFeedback::TransportPacketsFeedback() = default;
+TransportPacketsFeedback::TransportPacketsFeedback(
+    const TransportPacketsFeedback&) = default;
+TransportPacketsFeedback::TransportPacketsFeedback(
+    TransportPacketsFeedback&&) = default;
+TransportPacketsFeedback::~TransportPacketsFeedback() = default;
+TransportPacketsFeedback& TransportPacketsFeedback::operator=(
+    const TransportPacketsFeedback&) = default;
+TransportPacketsFeedback& TransportPacketsFeedback::operator=(
+    TransportPacketsFeedback&&) = default;
+
+std::vector<PacketFeedback> TransportPacketsFeedback::ReceivedWithSendInfo()
+    const {
+  std::vector<PacketFeedback> received;
+  for (const PacketFeedback& packet : packet_feedbacks) {
+    if (packet.arrival_time_ms != PacketFeedback::kNotReceived &&
+        packet.send_time_ms >= 0) {
+      received.push_back(packet);
+    }
+  }
+  return received;
+}
+
+std::vector<PacketFeedback> TransportPacketsFeedback::LostWithSendInfo()
+    const {
+  std::vector<PacketFeedback> lost;
+  for (const PacketFeedback& packet : packet_feedbacks) {
+    if (packet.arrival_time_ms == PacketFeedback::kNotReceived &&
+        packet.send_time_ms >= 0) {
+      lost.push_back(packet);
+    }
+  }
+  return lost;
+}
+
+NetworkControlUpdate::NetworkControlUpdate() = default;
+NetworkControlUpdate::NetworkControlUpdate(const NetworkControlUpdate&) =
+    default;
+NetworkControlUpdate::NetworkControlUpdate(NetworkControlUpdate&&) = default;
+NetworkControlUpdate::~NetworkControlUpdate() = default;
+NetworkControlUpdate& NetworkControlUpdate::operator=(
+    const NetworkControlUpdate&) = default;
+NetworkControlUpdate& NetworkControlUpdate::operator=(NetworkControlUpdate&&) =
+    default;
+
+void NetworkControlUpdate::Merge(const NetworkControlUpdate& other) {
+  if (other.target_rate)
+    target_rate = other.target_rate;
+  if (other.pacing_factor)
+    pacing_factor = other.pacing_factor;
+  if (other.congestion_window_bytes)
+    congestion_window_bytes = other.congestion_window_bytes;
+  probe_cluster_bitrates_bps.insert(probe_cluster_bitrates_bps.end(),
+                                    other.probe_cluster_bitrates_bps.begin(),
+                                    other.probe_cluster_bitrates_bps.end());
+}
+
+}  // namespace webrtc
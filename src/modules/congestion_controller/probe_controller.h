@@ -12,9 +12,11 @@
 #define MODULES_CONGESTION_CONTROLLER_PROBE_CONTROLLER_H_
 
 #include <initializer_list>
+#include <vector>
 
+#include "api/optional.h"
 #include "common_types.h"  // NOLINT(build/include)
-#include "modules/pacing/paced_sender.h"
+#include "rtc_base/constructormagic.h"
 #include "rtc_base/criticalsection.h"
 
 namespace webrtc {
@@ -23,10 +25,11 @@ class Clock;
 
 // This class controls initiation of probing to estimate initial channel
 // capacity. There is also support for probing during a session when max
-// bitrate is adjusted by an application.
+// bitrate is adjusted by an application. The probe clusters to send are
+// collected until they are fetched with GetAndResetPendingProbes().
 class ProbeController {
  public:
-  ProbeController(PacedSender* pacer, const Clock* clock);
+  explicit ProbeController(const Clock* clock);
 
   void SetBitrates(int64_t min_bitrate_bps,
                    int64_t start_bitrate_bps,
@@ -40,6 +43,10 @@ class ProbeController {
 
   void SetAlrEndedTimeMs(int64_t alr_end_time);
 
+  // The start time of the current application limited region of the pacer,
+  // if the pacer is application limited.
+  void SetAlrStartTimeMs(rtc::Optional<int64_t> alr_start_time);
+
   void RequestProbe();
 
   // Resets the ProbeController to a state equivalent to as if it was just
@@ -48,6 +55,9 @@ class ProbeController {
 
   void Process();
 
+  // Returns the bitrates of the probe clusters initiated since the last call.
+  std::vector<int> GetAndResetPendingProbes();
+
  private:
   enum class State {
     // Initial state where no probing has been triggered yet.
@@ -65,8 +75,8 @@ class ProbeController {
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
 
   rtc::CriticalSection critsect_;
-  PacedSender* const pacer_;
   const Clock* const clock_;
+  std::vector<int> pending_probes_ RTC_GUARDED_BY(critsect_);
   NetworkState network_state_ RTC_GUARDED_BY(critsect_);
   State state_ RTC_GUARDED_BY(critsect_);
   int64_t min_bitrate_to_probe_further_bps_ RTC_GUARDED_BY(critsect_);
@@ -75,6 +85,7 @@ class ProbeController {
   int64_t start_bitrate_bps_ RTC_GUARDED_BY(critsect_);
   int64_t max_bitrate_bps_ RTC_GUARDED_BY(critsect_);
   int64_t last_bwe_drop_probing_time_ms_ RTC_GUARDED_BY(critsect_);
+  rtc::Optional<int64_t> alr_start_time_ms_ RTC_GUARDED_BY(critsect_);
   rtc::Optional<int64_t> alr_end_time_ms_ RTC_GUARDED_BY(critsect_);
   bool enable_periodic_alr_probing_ RTC_GUARDED_BY(critsect_);
   int64_t time_of_last_large_drop_ms_ RTC_GUARDED_BY(critsect_);
@@ -8,18 +8,17 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 #include <memory>
+#include <vector>
 
 #include "modules/congestion_controller/probe_controller.h"
-#include "modules/pacing/mock/mock_paced_sender.h"
 #include "rtc_base/logging.h"
 #include "system_wrappers/include/clock.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 
-using testing::_;
-using testing::AtLeast;
-using testing::NiceMock;
-using testing::Return;
+using testing::ElementsAre;
+using testing::IsEmpty;
+using testing::SizeIs;
 
 namespace webrtc {
 namespace test {
@@ -41,232 +40,225 @@ constexpr int kBitrateDropTimeoutMs = 5000;
 class ProbeControllerTest : public ::testing::Test {
  protected:
   ProbeControllerTest() : clock_(100000000L) {
-    probe_controller_.reset(new ProbeController(&pacer_, &clock_));
+    probe_controller_.reset(new ProbeController(&clock_));
   }
   ~ProbeControllerTest() override {}
 
+  std::vector<int> Probes() {
+    return probe_controller_->GetAndResetPendingProbes();
+  }
+
   SimulatedClock clock_;
-  NiceMock<MockPacedSender> pacer_;
   std::unique_ptr<ProbeController> probe_controller_;
 };
 
 TEST_F(ProbeControllerTest, InitiatesProbingAtStart) {
-  EXPECT_CALL(pacer_, CreateProbeCluster(_)).Times(AtLeast(2));
   probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
                                  kMaxBitrateBps);
+  EXPECT_GE(Probes().size(), 2u);
 }
 
 TEST_F(ProbeControllerTest, ProbeOnlyWhenNetworkIsUp) {
   probe_controller_->OnNetworkStateChanged(kNetworkDown);
-  EXPECT_CALL(pacer_, CreateProbeCluster(_)).Times(0);
   probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
                                  kMaxBitrateBps);
+  EXPECT_THAT(Probes(), IsEmpty());
 
-  testing::Mock::VerifyAndClearExpectations(&pacer_);
-  EXPECT_CALL(pacer_, CreateProbeCluster(_)).Times(AtLeast(2));
   probe_controller_->OnNetworkStateChanged(kNetworkUp);
+  EXPECT_GE(Probes().size(), 2u);
 }
 
 TEST_F(ProbeControllerTest, InitiatesProbingOnMaxBitrateIncrease) {
-  EXPECT_CALL(pacer_, CreateProbeCluster(_)).Times(AtLeast(2));
   probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
                                  kMaxBitrateBps);
+  EXPECT_GE(Probes().size(), 2u);
   // Long enough to time out exponential probing.
   clock_.AdvanceTimeMilliseconds(kExponentialProbingTimeoutMs);
   probe_controller_->SetEstimatedBitrate(kStartBitrateBps);
   probe_controller_->Process();
+  EXPECT_THAT(Probes(), IsEmpty());
 
-  EXPECT_CALL(pacer_, CreateProbeCluster(kMaxBitrateBps + 100));
   probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
                                  kMaxBitrateBps + 100);
+  EXPECT_THAT(Probes(), ElementsAre(kMaxBitrateBps + 100));
 }
 
 TEST_F(ProbeControllerTest, InitiatesProbingOnMaxBitrateIncreaseAtMaxBitrate) {
-  EXPECT_CALL(pacer_, CreateProbeCluster(_)).Times(AtLeast(2));
   probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
                                  kMaxBitrateBps);
+  EXPECT_GE(Probes().size(), 2u);
   // Long enough to time out exponential probing.
   clock_.AdvanceTimeMilliseconds(kExponentialProbingTimeoutMs);
   probe_controller_->SetEstimatedBitrate(kStartBitrateBps);
   probe_controller_->Process();
 
   probe_controller_->SetEstimatedBitrate(kMaxBitrateBps);
-  EXPECT_CALL(pacer_, CreateProbeCluster(kMaxBitrateBps + 100));
+  EXPECT_THAT(Probes(), IsEmpty());
   probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
                                  kMaxBitrateBps + 100);
+  EXPECT_THAT(Probes(), ElementsAre(kMaxBitrateBps + 100));
 }
 
 TEST_F(ProbeControllerTest, TestExponentialProbing) {
   probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
                                  kMaxBitrateBps);
+  Probes();
 
   // Repeated probe should only be sent when estimated bitrate climbs above
   // 0.7 * 6 * kStartBitrateBps = 1260.
-  EXPECT_CALL(pacer_, CreateProbeCluster(_)).Times(0);
   probe_controller_->SetEstimatedBitrate(1000);
-  testing::Mock::VerifyAndClearExpectations(&pacer_);
+  EXPECT_THAT(Probes(), IsEmpty());
 
-  EXPECT_CALL(pacer_, CreateProbeCluster(2 * 1800));
   probe_controller_->SetEstimatedBitrate(1800);
+  EXPECT_THAT(Probes(), ElementsAre(2 * 1800));
 }
 
 TEST_F(ProbeControllerTest, TestExponentialProbingTimeout) {
   probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
                                  kMaxBitrateBps);
+  Probes();
 
   // Advance far enough to cause a time out in waiting for probing result.
   clock_.AdvanceTimeMilliseconds(kExponentialProbingTimeoutMs);
   probe_controller_->Process();
 
-  EXPECT_CALL(pacer_, CreateProbeCluster(_)).Times(0);
   probe_controller_->SetEstimatedBitrate(1800);
+  EXPECT_THAT(Probes(), IsEmpty());
 }
 
 TEST_F(ProbeControllerTest, RequestProbeInAlr) {
-  EXPECT_CALL(pacer_, CreateProbeCluster(_)).Times(2);
   probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
                                  kMaxBitrateBps);
   probe_controller_->SetEstimatedBitrate(500);
-  testing::Mock::VerifyAndClearExpectations(&pacer_);
-  EXPECT_CALL(pacer_, CreateProbeCluster(0.85 * 500)).Times(1);
-  EXPECT_CALL(pacer_, GetApplicationLimitedRegionStartTime())
-      .WillRepeatedly(
-          Return(rtc::Optional<int64_t>(clock_.TimeInMilliseconds())));
+  EXPECT_THAT(Probes(), SizeIs(2));
+  probe_controller_->SetAlrStartTimeMs(
+      rtc::Optional<int64_t>(clock_.TimeInMilliseconds()));
   clock_.AdvanceTimeMilliseconds(kAlrProbeInterval + 1);
   probe_controller_->Process();
   probe_controller_->SetEstimatedBitrate(250);
   probe_controller_->RequestProbe();
+  EXPECT_THAT(Probes(), ElementsAre(0.85 * 500));
 }
 
 TEST_F(ProbeControllerTest, RequestProbeWhenAlrEndedRecently) {
-  EXPECT_CALL(pacer_, CreateProbeCluster(_)).Times(2);
   probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
                                  kMaxBitrateBps);
   probe_controller_->SetEstimatedBitrate(500);
-  testing::Mock::VerifyAndClearExpectations(&pacer_);
-  EXPECT_CALL(pacer_, CreateProbeCluster(0.85 * 500)).Times(1);
-  EXPECT_CALL(pacer_, GetApplicationLimitedRegionStartTime())
-      .WillRepeatedly(Return(rtc::Optional<int64_t>()));
+  EXPECT_THAT(Probes(), SizeIs(2));
+  probe_controller_->SetAlrStartTimeMs(rtc::Optional<int64_t>());
   clock_.AdvanceTimeMilliseconds(kAlrProbeInterval + 1);
   probe_controller_->Process();
   probe_controller_->SetEstimatedBitrate(250);
   probe_controller_->SetAlrEndedTimeMs(clock_.TimeInMilliseconds());
   clock_.AdvanceTimeMilliseconds(kAlrEndedTimeoutMs - 1);
   probe_controller_->RequestProbe();
+  EXPECT_THAT(Probes(), ElementsAre(0.85 * 500));
 }
 
 TEST_F(ProbeControllerTest, RequestProbeWhenAlrNotEndedRecently) {
-  EXPECT_CALL(pacer_, CreateProbeCluster(_)).Times(2);
   probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
                                  kMaxBitrateBps);
   probe_controller_->SetEstimatedBitrate(500);
-  testing::Mock::VerifyAndClearExpectations(&pacer_);
-  EXPECT_CALL(pacer_, CreateProbeCluster(_)).Times(0);
-  EXPECT_CALL(pacer_, GetApplicationLimitedRegionStartTime())
-      .WillRepeatedly(Return(rtc::Optional<int64_t>()));
+  EXPECT_THAT(Probes(), SizeIs(2));
+  probe_controller_->SetAlrStartTimeMs(rtc::Optional<int64_t>());
   clock_.AdvanceTimeMilliseconds(kAlrProbeInterval + 1);
   probe_controller_->Process();
   probe_controller_->SetEstimatedBitrate(250);
   probe_controller_->SetAlrEndedTimeMs(clock_.TimeInMilliseconds());
   clock_.AdvanceTimeMilliseconds(kAlrEndedTimeoutMs + 1);
   probe_controller_->RequestProbe();
+  EXPECT_THAT(Probes(), IsEmpty());
 }
 
 TEST_F(ProbeControllerTest, RequestProbeWhenBweDropNotRecent) {
-  EXPECT_CALL(pacer_, CreateProbeCluster(_)).Times(2);
   probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
                                  kMaxBitrateBps);
   probe_controller_->SetEstimatedBitrate(500);
-  testing::Mock::VerifyAndClearExpectations(&pacer_);
-  EXPECT_CALL(pacer_, CreateProbeCluster(_)).Times(0);
-  EXPECT_CALL(pacer_, GetApplicationLimitedRegionStartTime())
-      .WillRepeatedly(
-          Return(rtc::Optional<int64_t>(clock_.TimeInMilliseconds())));
+  EXPECT_THAT(Probes(), SizeIs(2));
+  probe_controller_->SetAlrStartTimeMs(
+      rtc::Optional<int64_t>(clock_.TimeInMilliseconds()));
   clock_.AdvanceTimeMilliseconds(kAlrProbeInterval + 1);
   probe_controller_->Process();
   probe_controller_->SetEstimatedBitrate(250);
   clock_.AdvanceTimeMilliseconds(kBitrateDropTimeoutMs + 1);
   probe_controller_->RequestProbe();
+  EXPECT_THAT(Probes(), IsEmpty());
 }
 
 TEST_F(ProbeControllerTest, PeriodicProbing) {
-  EXPECT_CALL(pacer_, CreateProbeCluster(_)).Times(2);
   probe_controller_->EnablePeriodicAlrProbing(true);
   probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
                                  kMaxBitrateBps);
   probe_controller_->SetEstimatedBitrate(500);
-  testing::Mock::VerifyAndClearExpectations(&pacer_);
+  EXPECT_THAT(Probes(), SizeIs(2));
 
   int64_t start_time = clock_.TimeInMilliseconds();
+  probe_controller_->SetAlrStartTimeMs(rtc::Optional<int64_t>(start_time));
 
   // Expect the controller to send a new probe after 5s has passed.
-  EXPECT_CALL(pacer_, CreateProbeCluster(1000)).Times(1);
-  EXPECT_CALL(pacer_, GetApplicationLimitedRegionStartTime())
-      .WillRepeatedly(Return(rtc::Optional<int64_t>(start_time)));
   clock_.AdvanceTimeMilliseconds(5000);
   probe_controller_->Process();
   probe_controller_->SetEstimatedBitrate(500);
-  testing::Mock::VerifyAndClearExpectations(&pacer_);
+  EXPECT_THAT(Probes(), ElementsAre(1000));
 
   // The following probe should be sent at 10s into ALR.
-  EXPECT_CALL(pacer_, CreateProbeCluster(_)).Times(0);
-  EXPECT_CALL(pacer_, GetApplicationLimitedRegionStartTime())
-      .WillRepeatedly(Return(rtc::Optional<int64_t>(start_time)));
   clock_.AdvanceTimeMilliseconds(4000);
   probe_controller_->Process();
   probe_controller_->SetEstimatedBitrate(500);
-  testing::Mock::VerifyAndClearExpectations(&pacer_);
+  EXPECT_THAT(Probes(), IsEmpty());
 
-  EXPECT_CALL(pacer_, CreateProbeCluster(_)).Times(1);
-  EXPECT_CALL(pacer_, GetApplicationLimitedRegionStartTime())
-      .WillRepeatedly(Return(rtc::Optional<int64_t>(start_time)));
   clock_.AdvanceTimeMilliseconds(1000);
   probe_controller_->Process();
   probe_controller_->SetEstimatedBitrate(500);
-  testing::Mock::VerifyAndClearExpectations(&pacer_);
+  EXPECT_THAT(Probes(), SizeIs(1));
 }
 
 TEST_F(ProbeControllerTest, PeriodicProbingAfterReset) {
-  testing::StrictMock<MockPacedSender> local_pacer;
-  probe_controller_.reset(new ProbeController(&local_pacer, &clock_));
   int64_t alr_start_time = clock_.TimeInMilliseconds();
-  EXPECT_CALL(local_pacer, GetApplicationLimitedRegionStartTime())
-      .WillRepeatedly(
-          Return(rtc::Optional<int64_t>(alr_start_time)));
+  probe_controller_->SetAlrStartTimeMs(
+      rtc::Optional<int64_t>(alr_start_time));
 
-  EXPECT_CALL(local_pacer, CreateProbeCluster(_)).Times(2);
   probe_controller_->EnablePeriodicAlrProbing(true);
   probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
                                  kMaxBitrateBps);
+  EXPECT_THAT(Probes(), SizeIs(2));
   probe_controller_->Reset();
 
   clock_.AdvanceTimeMilliseconds(10000);
   probe_controller_->Process();
+  EXPECT_THAT(Probes(), IsEmpty());
 
-  EXPECT_CALL(local_pacer, CreateProbeCluster(_)).Times(2);
   probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
                                  kMaxBitrateBps);
+  EXPECT_THAT(Probes(), SizeIs(2));
 
   // Make sure we use |kStartBitrateBps| as the estimated bitrate
   // until SetEstimatedBitrate is called with an updated estimate.
   clock_.AdvanceTimeMilliseconds(10000);
-  EXPECT_CALL(local_pacer, CreateProbeCluster(kStartBitrateBps*2));
   probe_controller_->Process();
+  EXPECT_THAT(Probes(), ElementsAre(kStartBitrateBps * 2));
+}
+
+TEST_F(ProbeControllerTest, ResetDropsPendingProbes) {
+  probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
+                                 kMaxBitrateBps);
+  probe_controller_->Reset();
+  EXPECT_THAT(Probes(), IsEmpty());
 }
 
 TEST_F(ProbeControllerTest, TestExponentialProbingOverflow) {
   const int64_t kMbpsMultiplier = 1000000;
   probe_controller_->SetBitrates(kMinBitrateBps, 10 * kMbpsMultiplier,
                                  100 * kMbpsMultiplier);
+  Probes();
 
   // Verify that probe bitrate is capped at the specified max bitrate
-  EXPECT_CALL(pacer_, CreateProbeCluster(100 * kMbpsMultiplier));
   probe_controller_->SetEstimatedBitrate(60 * kMbpsMultiplier);
-  testing::Mock::VerifyAndClearExpectations(&pacer_);
+  EXPECT_THAT(Probes(), ElementsAre(100 * kMbpsMultiplier));
 
   // Verify that repeated probes aren't sent.
-  EXPECT_CALL(pacer_, CreateProbeCluster(_)).Times(0);
   probe_controller_->SetEstimatedBitrate(100 * kMbpsMultiplier);
+  EXPECT_THAT(Probes(), IsEmpty());
 }
 
 }  // namespace test
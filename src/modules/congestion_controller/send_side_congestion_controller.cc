@@ -15,12 +15,10 @@
 #include <vector>
 
 #include "modules/bitrate_controller/include/bitrate_controller.h"
-#include "modules/congestion_controller/acknowledged_bitrate_estimator.h"
-#include "modules/congestion_controller/probe_controller.h"
-#include "modules/pacing/alr_detector.h"
+#include "modules/congestion_controller/bbr_network_controller.h"
+#include "modules/congestion_controller/goog_cc_network_controller.h"
 #include "modules/remote_bitrate_estimator/include/bwe_defines.h"
 #include "rtc_base/checks.h"
-#include "rtc_base/format_macros.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/ptr_util.h"
 #include "rtc_base/rate_limiter.h"
@@ -31,29 +29,7 @@
 namespace webrtc {
 namespace {
 
-const char kCwndExperiment[] = "WebRTC-CwndExperiment";
-const int64_t kDefaultAcceptedQueueMs = 250;
-
-bool CwndExperimentEnabled() {
-  std::string experiment_string =
-      webrtc::field_trial::FindFullName(kCwndExperiment);
-  // The experiment is enabled iff the field trial string begins with "Enabled".
-  return experiment_string.find("Enabled") == 0;
-}
-
-bool ReadCwndExperimentParameter(int64_t* accepted_queue_ms) {
-  RTC_DCHECK(accepted_queue_ms);
-  std::string experiment_string =
-      webrtc::field_trial::FindFullName(kCwndExperiment);
-  int parsed_values =
-      sscanf(experiment_string.c_str(), "Enabled-%" PRId64, accepted_queue_ms);
-  if (parsed_values == 1) {
-    RTC_CHECK_GE(*accepted_queue_ms, 0)
-        << "Accepted must be greater than or equal to 0.";
-    return true;
-  }
-  return false;
-}
+const char kBbrControllerExperiment[] = "WebRTC-BweBbrController";
 
 static const int64_t kRetransmitWindowSizeMs = 500;
 
@@ -72,23 +48,18 @@ static void ClampBitrates(int* bitrate_bps,
     *bitrate_bps = std::max(*min_bitrate_bps, *bitrate_bps);
 }
 
-std::vector<webrtc::PacketFeedback> ReceivedPacketFeedbackVector(
-    const std::vector<webrtc::PacketFeedback>& input) {
-  std::vector<PacketFeedback> received_packet_feedback_vector;
-  auto is_received = [](const webrtc::PacketFeedback& packet_feedback) {
-    return packet_feedback.arrival_time_ms !=
-           webrtc::PacketFeedback::kNotReceived;
-  };
-  std::copy_if(input.begin(), input.end(),
-               std::back_inserter(received_packet_feedback_vector),
-               is_received);
-  return received_packet_feedback_vector;
-}
-
-void SortPacketFeedbackVector(
-    std::vector<webrtc::PacketFeedback>* const input) {
-  RTC_DCHECK(input);
-  std::sort(input->begin(), input->end(), PacketFeedbackComparator());
+std::unique_ptr<NetworkControllerInterface> CreateNetworkController(
+    const Clock* clock,
+    RtcEventLog* event_log,
+    BitrateController* bitrate_controller) {
+  // The experiment is enabled iff the field trial string begins with "Enabled".
+  if (webrtc::field_trial::FindFullName(kBbrControllerExperiment)
+          .find("Enabled") == 0) {
+    LOG(LS_INFO) << "Using the BBR network controller.";
+    return rtc::MakeUnique<BbrNetworkController>();
+  }
+  return rtc::MakeUnique<GoogCcNetworkController>(clock, event_log,
+                                                  bitrate_controller);
 }
 
 }  // namespace
@@ -106,9 +77,6 @@ SendSideCongestionController::SendSideCongestionController(
       pacer_(owned_pacer_.get()),
       bitrate_controller_(
           BitrateController::CreateBitrateController(clock_, event_log)),
-      acknowledged_bitrate_estimator_(
-          rtc::MakeUnique<AcknowledgedBitrateEstimator>()),
-      probe_controller_(new ProbeController(pacer_, clock_)),
       retransmission_rate_limiter_(
           new RateLimiter(clock, kRetransmitWindowSizeMs)),
       transport_feedback_adapter_(clock_),
@@ -116,21 +84,12 @@ SendSideCongestionController::SendSideCongestionController(
       last_reported_fraction_loss_(0),
       last_reported_rtt_(0),
       network_state_(kNetworkUp),
+      congestion_window_full_(false),
       pause_pacer_(false),
       pacer_paused_(false),
-      min_bitrate_bps_(congestion_controller::GetMinBitrateBps()),
-      delay_based_bwe_(new DelayBasedBwe(event_log_, clock_)),
-      in_cwnd_experiment_(CwndExperimentEnabled()),
-      accepted_queue_ms_(kDefaultAcceptedQueueMs),
-      was_in_alr_(0) {
-  delay_based_bwe_->SetMinBitrate(min_bitrate_bps_);
-  if (in_cwnd_experiment_ &&
-      !ReadCwndExperimentParameter(&accepted_queue_ms_)) {
-    LOG(LS_WARNING) << "Failed to parse parameters for CwndExperiment "
-                       "from field trial string. Experiment disabled.";
-    in_cwnd_experiment_ = false;
-  }
-}
+      controller_(CreateNetworkController(clock_,
+                                          event_log_,
+                                          bitrate_controller_.get())) {}
 
 SendSideCongestionController::SendSideCongestionController(
     const Clock* clock,
@@ -143,9 +102,6 @@ SendSideCongestionController::SendSideCongestionController(
       pacer_(pacer),
       bitrate_controller_(
           BitrateController::CreateBitrateController(clock_, event_log)),
-      acknowledged_bitrate_estimator_(
-          rtc::MakeUnique<AcknowledgedBitrateEstimator>()),
-      probe_controller_(new ProbeController(pacer_, clock_)),
       retransmission_rate_limiter_(
           new RateLimiter(clock, kRetransmitWindowSizeMs)),
       transport_feedback_adapter_(clock_),
@@ -153,21 +109,12 @@ SendSideCongestionController::SendSideCongestionController(
       last_reported_fraction_loss_(0),
       last_reported_rtt_(0),
       network_state_(kNetworkUp),
+      congestion_window_full_(false),
       pause_pacer_(false),
       pacer_paused_(false),
-      min_bitrate_bps_(congestion_controller::GetMinBitrateBps()),
-      delay_based_bwe_(new DelayBasedBwe(event_log_, clock_)),
-      in_cwnd_experiment_(CwndExperimentEnabled()),
-      accepted_queue_ms_(kDefaultAcceptedQueueMs),
-      was_in_alr_(0) {
-  delay_based_bwe_->SetMinBitrate(min_bitrate_bps_);
-  if (in_cwnd_experiment_ &&
-      !ReadCwndExperimentParameter(&accepted_queue_ms_)) {
-    LOG(LS_WARNING) << "Failed to parse parameters for CwndExperiment "
-                       "from field trial string. Experiment disabled.";
-    in_cwnd_experiment_ = false;
-  }
-}
+      controller_(CreateNetworkController(clock_,
+                                          event_log_,
+                                          bitrate_controller_.get())) {}
 
 SendSideCongestionController::~SendSideCongestionController() {}
 
@@ -198,19 +145,17 @@ void SendSideCongestionController::SetBweBitrates(int min_bitrate_bps,
                                                   int start_bitrate_bps,
                                                   int max_bitrate_bps) {
   ClampBitrates(&start_bitrate_bps, &min_bitrate_bps, &max_bitrate_bps);
-  bitrate_controller_->SetBitrates(start_bitrate_bps, min_bitrate_bps,
-                                   max_bitrate_bps);
-
-  probe_controller_->SetBitrates(min_bitrate_bps, start_bitrate_bps,
-                                 max_bitrate_bps);
-
+  TargetRateConstraints constraints;
+  constraints.min_bitrate_bps = min_bitrate_bps;
+  constraints.start_bitrate_bps = start_bitrate_bps;
+  constraints.max_bitrate_bps = max_bitrate_bps;
+  NetworkControlUpdate update;
   {
     rtc::CritScope cs(&bwe_lock_);
-    if (start_bitrate_bps > 0)
-      delay_based_bwe_->SetStartBitrate(start_bitrate_bps);
-    min_bitrate_bps_ = min_bitrate_bps;
-    delay_based_bwe_->SetMinBitrate(min_bitrate_bps_);
+    update = controller_->OnTargetRateConstraints(
+        constraints, clock_->TimeInMilliseconds());
   }
+  ApplyUpdate(update);
   MaybeTriggerOnNetworkChanged();
 }
 
@@ -222,25 +167,19 @@ void SendSideCongestionController::OnNetworkRouteChanged(
     int min_bitrate_bps,
     int max_bitrate_bps) {
   ClampBitrates(&bitrate_bps, &min_bitrate_bps, &max_bitrate_bps);
-  // TODO(honghaiz): Recreate this object once the bitrate controller is
-  // no longer exposed outside SendSideCongestionController.
-  bitrate_controller_->ResetBitrates(bitrate_bps, min_bitrate_bps,
-                                     max_bitrate_bps);
-
   transport_feedback_adapter_.SetNetworkIds(network_route.local_network_id,
                                             network_route.remote_network_id);
+  TargetRateConstraints constraints;
+  constraints.min_bitrate_bps = min_bitrate_bps;
+  constraints.start_bitrate_bps = bitrate_bps;
+  constraints.max_bitrate_bps = max_bitrate_bps;
+  NetworkControlUpdate update;
   {
     rtc::CritScope cs(&bwe_lock_);
-    min_bitrate_bps_ = min_bitrate_bps;
-    delay_based_bwe_.reset(new DelayBasedBwe(event_log_, clock_));
-    acknowledged_bitrate_estimator_.reset(new AcknowledgedBitrateEstimator());
-    delay_based_bwe_->SetStartBitrate(bitrate_bps);
-    delay_based_bwe_->SetMinBitrate(min_bitrate_bps);
+    update = controller_->OnNetworkRouteChange(constraints,
+                                               clock_->TimeInMilliseconds());
   }
-
-  probe_controller_->Reset();
-  probe_controller_->SetBitrates(min_bitrate_bps, bitrate_bps, max_bitrate_bps);
-
+  ApplyUpdate(update);
   MaybeTriggerOnNetworkChanged();
 }
 
@@ -253,7 +192,8 @@ RateLimiter* SendSideCongestionController::GetRetransmissionRateLimiter() {
 }
 
 void SendSideCongestionController::EnablePeriodicAlrProbing(bool enable) {
-  probe_controller_->EnablePeriodicAlrProbing(enable);
+  rtc::CritScope cs(&bwe_lock_);
+  controller_->EnablePeriodicAlrProbing(enable);
 }
 
 int64_t SendSideCongestionController::GetPacerQueuingDelayMs() const {
@@ -277,7 +217,13 @@ void SendSideCongestionController::SignalNetworkState(NetworkState state) {
     pause_pacer_ = state == kNetworkDown;
     network_state_ = state;
   }
-  probe_controller_->OnNetworkStateChanged(state);
+  NetworkControlUpdate update;
+  {
+    rtc::CritScope cs(&bwe_lock_);
+    update = controller_->OnNetworkAvailability(state == kNetworkUp,
+                                                clock_->TimeInMilliseconds());
+  }
+  ApplyUpdate(update);
   MaybeTriggerOnNetworkChanged();
 }
 
@@ -295,14 +241,20 @@ void SendSideCongestionController::OnSentPacket(
     return;
   transport_feedback_adapter_.OnSentPacket(sent_packet.packet_id,
                                            sent_packet.send_time_ms);
-  if (in_cwnd_experiment_)
-    LimitOutstandingBytes(transport_feedback_adapter_.GetOutstandingBytes());
+  LimitOutstandingBytes(transport_feedback_adapter_.GetOutstandingBytes());
 }
 
 void SendSideCongestionController::OnRttUpdate(int64_t avg_rtt_ms,
                                                int64_t max_rtt_ms) {
-  rtc::CritScope cs(&bwe_lock_);
-  delay_based_bwe_->OnRttUpdate(avg_rtt_ms, max_rtt_ms);
+  NetworkControlUpdate update;
+  {
+    rtc::CritScope cs(&bwe_lock_);
+    update = controller_->OnRoundTripTimeUpdate(avg_rtt_ms, max_rtt_ms,
+                                                clock_->TimeInMilliseconds());
+  }
+  ApplyUpdate(update);
+  if (update.target_rate)
+    MaybeTriggerOnNetworkChanged();
 }
 
 int64_t SendSideCongestionController::TimeUntilNextProcess() {
@@ -315,7 +267,7 @@ void SendSideCongestionController::Process() {
   // replace this with a task instead.
   {
     rtc::CritScope lock(&network_state_lock_);
-    pause_pacer = pause_pacer_;
+    pause_pacer = pause_pacer_ || congestion_window_full_;
   }
   if (pause_pacer && !pacer_paused_) {
     pacer_->Pause();
@@ -324,8 +276,12 @@ void SendSideCongestionController::Process() {
     pacer_->Resume();
     pacer_paused_ = false;
   }
-  bitrate_controller_->Process();
-  probe_controller_->Process();
+  NetworkControlUpdate update;
+  {
+    rtc::CritScope cs(&bwe_lock_);
+    update = controller_->OnProcessInterval(clock_->TimeInMilliseconds());
+  }
+  ApplyUpdate(update);
   MaybeTriggerOnNetworkChanged();
 }
 
@@ -342,60 +298,69 @@ void SendSideCongestionController::OnTransportFeedback(
     const rtcp::TransportFeedback& feedback) {
   RTC_DCHECK_RUNS_SERIALIZED(&worker_race_);
   transport_feedback_adapter_.OnTransportFeedback(feedback);
-  std::vector<PacketFeedback> feedback_vector = ReceivedPacketFeedbackVector(
-      transport_feedback_adapter_.GetTransportFeedbackVector());
-  SortPacketFeedbackVector(&feedback_vector);
-
-  bool currently_in_alr =
-      pacer_->GetApplicationLimitedRegionStartTime().has_value();
-  if (was_in_alr_ && !currently_in_alr) {
-    int64_t now_ms = rtc::TimeMillis();
-    acknowledged_bitrate_estimator_->SetAlrEndedTimeMs(now_ms);
-    probe_controller_->SetAlrEndedTimeMs(now_ms);
-  }
-  was_in_alr_ = currently_in_alr;
+  TransportPacketsFeedback& packets_feedback = transport_packets_feedback_;
+  packets_feedback.feedback_time_ms = clock_->TimeInMilliseconds();
+  packets_feedback.packet_feedbacks =
+      transport_feedback_adapter_.GetTransportFeedbackVector();
+  packets_feedback.data_in_flight_bytes =
+      transport_feedback_adapter_.GetOutstandingBytes();
+  packets_feedback.alr_start_time_ms =
+      pacer_->GetApplicationLimitedRegionStartTime();
+  packets_feedback.min_feedback_rtt_ms =
+      transport_feedback_adapter_.GetMinFeedbackLoopRtt();
 
-  acknowledged_bitrate_estimator_->IncomingPacketFeedbackVector(
-      feedback_vector);
-  DelayBasedBwe::Result result;
+  NetworkControlUpdate update;
   {
     rtc::CritScope cs(&bwe_lock_);
-    result = delay_based_bwe_->IncomingPacketFeedbackVector(
-        feedback_vector, acknowledged_bitrate_estimator_->bitrate_bps());
+    update = controller_->OnTransportPacketsFeedback(packets_feedback);
   }
-  if (result.updated) {
-    bitrate_controller_->OnDelayBasedBweResult(result);
-    // Update the estimate in the ProbeController, in case we want to probe.
+  ApplyUpdate(update);
+  if (update.target_rate)
     MaybeTriggerOnNetworkChanged();
-  }
-  if (result.recovered_from_overuse)
-    probe_controller_->RequestProbe();
-  if (in_cwnd_experiment_)
-    LimitOutstandingBytes(transport_feedback_adapter_.GetOutstandingBytes());
+  LimitOutstandingBytes(packets_feedback.data_in_flight_bytes);
 }
 
 void SendSideCongestionController::LimitOutstandingBytes(
     size_t num_outstanding_bytes) {
-  RTC_DCHECK(in_cwnd_experiment_);
   rtc::CritScope lock(&network_state_lock_);
-  rtc::Optional<int64_t> min_rtt_ms =
-      transport_feedback_adapter_.GetMinFeedbackLoopRtt();
-  // No valid RTT. Could be because send-side BWE isn't used, in which case
-  // we don't try to limit the outstanding packets.
-  if (!min_rtt_ms)
+  if (!congestion_window_bytes_)
     return;
-  const size_t kMinCwndBytes = 2 * 1500;
-  size_t max_outstanding_bytes =
-      std::max<size_t>((*min_rtt_ms + accepted_queue_ms_) *
-                           last_reported_bitrate_bps_ / 1000 / 8,
-                       kMinCwndBytes);
-  LOG(LS_INFO) << clock_->TimeInMilliseconds()
-               << " Outstanding bytes: " << num_outstanding_bytes
-               << " pacer queue: " << pacer_->QueueInMs()
-               << " max outstanding: " << max_outstanding_bytes;
-  LOG(LS_INFO) << "Feedback rtt: " << *min_rtt_ms
-               << " Bitrate: " << last_reported_bitrate_bps_;
-  pause_pacer_ = num_outstanding_bytes > max_outstanding_bytes;
+  bool congestion_window_full =
+      num_outstanding_bytes > *congestion_window_bytes_;
+  if (congestion_window_full != congestion_window_full_) {
+    LOG(LS_VERBOSE) << clock_->TimeInMilliseconds()
+                    << " Outstanding bytes: " << num_outstanding_bytes
+                    << " congestion window: " << *congestion_window_bytes_;
+  }
+  congestion_window_full_ = congestion_window_full;
+}
+
+void SendSideCongestionController::ApplyUpdate(
+    const NetworkControlUpdate& update) {
+  if (update.pacing_factor)
+    pacer_->SetPacingFactor(*update.pacing_factor);
+  if (update.target_rate) {
+    uint32_t bitrate_bps = update.target_rate->target_bitrate_bps;
+    pacer_->SetEstimatedBitrate(bitrate_bps);
+    retransmission_rate_limiter_->SetMaxRate(bitrate_bps);
+  } else if (update.pacing_factor) {
+    rtc::Optional<TargetTransferRate> target_rate;
+    {
+      rtc::CritScope cs(&network_state_lock_);
+      target_rate = target_rate_;
+    }
+    // The pacing factor applies from the next estimate.
+    if (target_rate)
+      pacer_->SetEstimatedBitrate(target_rate->target_bitrate_bps);
+  }
+  for (int bitrate_bps : update.probe_cluster_bitrates_bps)
+    pacer_->CreateProbeCluster(bitrate_bps);
+
+  rtc::CritScope cs(&network_state_lock_);
+  if (update.target_rate)
+    target_rate_ = update.target_rate;
+  if (update.congestion_window_bytes)
+    congestion_window_bytes_ = update.congestion_window_bytes;
 }
 
 std::vector<PacketFeedback>
@@ -405,31 +370,24 @@ SendSideCongestionController::GetTransportFeedbackVector() const {
 }
 
 void SendSideCongestionController::MaybeTriggerOnNetworkChanged() {
-  uint32_t bitrate_bps;
-  uint8_t fraction_loss;
-  int64_t rtt;
-  bool estimate_changed = bitrate_controller_->GetNetworkParameters(
-      &bitrate_bps, &fraction_loss, &rtt);
-  if (estimate_changed) {
-    pacer_->SetEstimatedBitrate(bitrate_bps);
-    probe_controller_->SetEstimatedBitrate(bitrate_bps);
-    retransmission_rate_limiter_->SetMaxRate(bitrate_bps);
+  rtc::Optional<TargetTransferRate> target_rate;
+  {
+    rtc::CritScope cs(&network_state_lock_);
+    target_rate = target_rate_;
   }
+  if (!target_rate)
+    return;
 
-  bitrate_bps = IsNetworkDown() || IsSendQueueFull() ? 0 : bitrate_bps;
-
-  if (HasNetworkParametersToReportChanged(bitrate_bps, fraction_loss, rtt)) {
-    int64_t probing_interval_ms;
-    {
-      rtc::CritScope cs(&bwe_lock_);
-      probing_interval_ms = delay_based_bwe_->GetExpectedBwePeriodMs();
-    }
-    {
-      rtc::CritScope cs(&observer_lock_);
-      if (observer_) {
-        observer_->OnNetworkChanged(bitrate_bps, fraction_loss, rtt,
-                                    probing_interval_ms);
-      }
+  uint32_t bitrate_bps = IsNetworkDown() || IsSendQueueFull()
+                             ? 0
+                             : target_rate->target_bitrate_bps;
+  if (HasNetworkParametersToReportChanged(
+          bitrate_bps, target_rate->fraction_loss, target_rate->rtt_ms)) {
+    rtc::CritScope cs(&observer_lock_);
+    if (observer_) {
+      observer_->OnNetworkChanged(bitrate_bps, target_rate->fraction_loss,
+                                  target_rate->rtt_ms,
+                                  target_rate->bwe_period_ms);
     }
   }
 }
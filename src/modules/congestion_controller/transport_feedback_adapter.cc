@@ -102,8 +102,9 @@ void TransportFeedbackAdapter::SetNetworkIds(uint16_t local_id,
   remote_net_id_ = remote_id;
 }
 
-std::vector<PacketFeedback> TransportFeedbackAdapter::GetPacketFeedbackVector(
-    const rtcp::TransportFeedback& feedback) {
+void TransportFeedbackAdapter::GetPacketFeedbackVector(
+    const rtcp::TransportFeedback& feedback,
+    std::vector<PacketFeedback>* packet_feedback_vector) {
   int64_t timestamp_us = feedback.GetBaseTimeUs();
   int64_t now_ms = clock_->TimeInMilliseconds();
   // Add timestamp deltas to a local time base selected on first packet arrival.
@@ -125,12 +126,12 @@ std::vector<PacketFeedback> TransportFeedbackAdapter::GetPacketFeedbackVector(
   }
   last_timestamp_us_ = timestamp_us;
 
-  std::vector<PacketFeedback> packet_feedback_vector;
+  packet_feedback_vector->clear();
   if (feedback.GetPacketStatusCount() == 0) {
     LOG(LS_INFO) << "Empty transport feedback packet received.";
-    return packet_feedback_vector;
+    return;
   }
-  packet_feedback_vector.reserve(feedback.GetPacketStatusCount());
+  packet_feedback_vector->reserve(feedback.GetPacketStatusCount());
   int64_t feedback_rtt = -1;
   {
     rtc::CritScope cs(&lock_);
@@ -149,7 +150,7 @@ std::vector<PacketFeedback> TransportFeedbackAdapter::GetPacketFeedbackVector(
           ++failed_lookups;
         if (packet_feedback.local_net_id == local_net_id_ &&
             packet_feedback.remote_net_id == remote_net_id_) {
-          packet_feedback_vector.push_back(packet_feedback);
+          packet_feedback_vector->push_back(packet_feedback);
         }
       }
 
@@ -167,7 +168,7 @@ std::vector<PacketFeedback> TransportFeedbackAdapter::GetPacketFeedbackVector(
           // receiver.
           feedback_rtt = std::max(rtt, feedback_rtt);
         }
-        packet_feedback_vector.push_back(packet_feedback);
+        packet_feedback_vector->push_back(packet_feedback);
       }
 
       ++seq_num;
@@ -187,12 +188,11 @@ std::vector<PacketFeedback> TransportFeedbackAdapter::GetPacketFeedbackVector(
           *std::min_element(feedback_rtts_.begin(), feedback_rtts_.end()));
     }
   }
-  return packet_feedback_vector;
 }
 
 void TransportFeedbackAdapter::OnTransportFeedback(
     const rtcp::TransportFeedback& feedback) {
-  last_packet_feedback_vector_ = GetPacketFeedbackVector(feedback);
+  GetPacketFeedbackVector(feedback, &last_packet_feedback_vector_);
   {
     rtc::CritScope cs(&observers_lock_);
     for (auto observer : observers_) {
@@ -201,7 +201,7 @@ void TransportFeedbackAdapter::OnTransportFeedback(
   }
 }
 
-std::vector<PacketFeedback>
+const std::vector<PacketFeedback>&
 TransportFeedbackAdapter::GetTransportFeedbackVector() const {
   return last_packet_feedback_vector_;
 }
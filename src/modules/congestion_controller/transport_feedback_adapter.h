@@ -46,7 +46,9 @@ class TransportFeedbackAdapter {
   // can get rid of the dependency on BitrateController. Requires changes
   // to the CongestionController interface.
   void OnTransportFeedback(const rtcp::TransportFeedback& feedback);
-  std::vector<PacketFeedback> GetTransportFeedbackVector() const;
+  // The feedback of the last OnTransportFeedback() call. The vector is reused
+  // for the next feedback, so that it is not reallocated for every feedback.
+  const std::vector<PacketFeedback>& GetTransportFeedbackVector() const;
   rtc::Optional<int64_t> GetMinFeedbackLoopRtt() const;
 
   void SetTransportOverhead(int transport_overhead_bytes_per_packet);
@@ -56,8 +58,11 @@ class TransportFeedbackAdapter {
   size_t GetOutstandingBytes() const;
 
  private:
-  std::vector<PacketFeedback> GetPacketFeedbackVector(
-      const rtcp::TransportFeedback& feedback);
+  // Clears |packet_feedback_vector| and fills it with the packets reported
+  // in |feedback|.
+  void GetPacketFeedbackVector(
+      const rtcp::TransportFeedback& feedback,
+      std::vector<PacketFeedback>* packet_feedback_vector);
 
   const bool send_side_bwe_with_overhead_;
   rtc::CriticalSection lock_;
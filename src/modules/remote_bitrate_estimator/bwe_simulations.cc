@@ -11,13 +11,20 @@
 #include <memory>
 
 #include "modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
+#include "modules/remote_bitrate_estimator/test/bwe_scenario_runner.h"
 #include "modules/remote_bitrate_estimator/test/bwe_test.h"
 #include "modules/remote_bitrate_estimator/test/packet_receiver.h"
 #include "modules/remote_bitrate_estimator/test/packet_sender.h"
 #include "rtc_base/constructormagic.h"
+#include "rtc_base/flags.h"
 #include "test/gtest.h"
 #include "test/testsupport/fileutils.h"
 
+DEFINE_int(bwe_scenario_threads,
+           0,
+           "Number of threads running the scenario matrix, 0 for one per "
+           "core.");
+
 namespace webrtc {
 namespace testing {
 namespace bwe {
@@ -48,7 +55,9 @@ INSTANTIATE_TEST_CASE_P(VideoSendersTest,
                         ::testing::Values(kRembEstimator,
                                           kSendSideEstimator,
                                           kNadaEstimator,
-                                          kBbrEstimator));
+                                          kBbrEstimator,
+                                          kGoogCcControllerEstimator,
+                                          kBbrControllerEstimator));
 
 TEST_P(BweSimulation, SprintUplinkTest) {
   AdaptiveVideoSource source(0, 30, 300, 0, 0);
@@ -548,6 +557,96 @@ TEST_P(BweSimulation, GccComparisonChoke) {
   gcc_test.RunChoke(kSendSideEstimator, capacities_kbps);
 }
 
+namespace {
+// Writes |current| to out/remote_bitrate_estimator/|name|.json and fails the
+// test for each regression against the baseline of the same name in
+// resources/, if there is one.
+void ExpectNoRegressions(const std::string& name,
+                         const ScenarioBaseLine& current) {
+  EXPECT_TRUE(WriteScenarioBaseLine(name, current));
+  ScenarioBaseLine baseline;
+  if (!ReadScenarioBaseLine(name, &baseline))
+    return;
+  for (const std::string& regression :
+       FindRegressions(baseline, current, 0.1)) {
+    ADD_FAILURE() << regression;
+  }
+}
+}  // namespace
+
+// Runs every estimator over a matrix of links and flow mixes, writes the
+// metrics of all scenarios to out/remote_bitrate_estimator/
+// bwe_scenario_matrix.json and compares them to the baseline with the same
+// name in resources/. Copy the output file to resources/ to update the
+// baseline.
+TEST(BweScenarioMatrix, CompareToBaseLine) {
+  const int64_t kDurationMs = 60 * 1000;
+  const int64_t kStartIntervalMs = 10 * 1000;
+
+  std::vector<LinkProfile> links(4);
+  links[0].name = "constant";
+  links[0].capacity_steps = {{kDurationMs, 2000}};
+  links[1].name = "step_down_up";
+  links[1].capacity_steps = {{20000, 2000}, {20000, 500}, {20000, 2000}};
+  links[2].name = "lossy";
+  links[2].capacity_steps = {{kDurationMs, 1500}};
+  links[2].max_jitter_ms = kMaxJitterMs;
+  links[2].loss_percent = 2.0f;
+  links[3].name = "long_rtt";
+  links[3].capacity_steps = {{kDurationMs, 1000}};
+  links[3].one_way_delay_ms = 150;
+
+  std::vector<FlowMix> flow_mixes(3);
+  flow_mixes[0].name = "one_media";
+  flow_mixes[1].name = "three_media";
+  flow_mixes[1].num_media_flows = 3;
+  flow_mixes[1].start_interval_ms = kStartIntervalMs;
+  flow_mixes[2].name = "media_and_tcp";
+  flow_mixes[2].num_tcp_flows = 1;
+  flow_mixes[2].start_interval_ms = kStartIntervalMs;
+
+  std::vector<BweScenario> scenarios = CreateScenarioMatrix(
+      {kSendSideEstimator, kRembEstimator, kNadaEstimator, kBbrEstimator},
+      links, flow_mixes, kDurationMs);
+  BweScenarioRunner runner(FLAG_bwe_scenario_threads);
+  ScenarioBaseLine current = MetricsToBaseLine(runner.Run(scenarios));
+
+  ExpectNoRegressions("bwe_scenario_matrix", current);
+}
+
+// Compares the throughput and the queuing delay of the estimators on long,
+// fast links, where the delay based estimate ramps up slowly and the queue of
+// a window limited sender is large. Writes bwe_high_bdp.json like
+// CompareToBaseLine.
+TEST(BweScenarioMatrix, HighBandwidthDelayProduct) {
+  const int64_t kDurationMs = 60 * 1000;
+
+  std::vector<LinkProfile> links(2);
+  links[0].name = "20mbps_200ms";
+  links[0].capacity_steps = {{kDurationMs, 20000}};
+  links[0].one_way_delay_ms = 100;
+  links[0].max_queueing_delay_ms = 500;
+  links[1].name = "10mbps_300ms_lossy";
+  links[1].capacity_steps = {{kDurationMs, 10000}};
+  links[1].one_way_delay_ms = 150;
+  links[1].max_queueing_delay_ms = 500;
+  links[1].loss_percent = 0.5f;
+
+  std::vector<FlowMix> flow_mixes(2);
+  flow_mixes[0].name = "one_media";
+  flow_mixes[1].name = "media_and_tcp";
+  flow_mixes[1].num_tcp_flows = 1;
+  flow_mixes[1].start_interval_ms = 10 * 1000;
+
+  std::vector<BweScenario> scenarios = CreateScenarioMatrix(
+      {kSendSideEstimator, kBbrEstimator, kGoogCcControllerEstimator,
+       kBbrControllerEstimator},
+      links, flow_mixes, kDurationMs);
+  BweScenarioRunner runner(FLAG_bwe_scenario_threads);
+  ScenarioBaseLine current = MetricsToBaseLine(runner.Run(scenarios));
+  ExpectNoRegressions("bwe_high_bdp", current);
+}
+
 }  // namespace bwe
 }  // namespace testing
 }  // namespace webrtc
@@ -11,15 +11,14 @@
 #ifndef MODULES_REMOTE_BITRATE_ESTIMATOR_INCLUDE_SEND_TIME_HISTORY_H_
 #define MODULES_REMOTE_BITRATE_ESTIMATOR_INCLUDE_SEND_TIME_HISTORY_H_
 
-#include <map>
-
 #include "modules/include/module_common_types.h"
+#include "modules/remote_bitrate_estimator/sequence_buffer.h"
+#include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "rtc_base/basictypes.h"
 #include "rtc_base/constructormagic.h"
 
 namespace webrtc {
 class Clock;
-struct PacketFeedback;
 
 class SendTimeHistory {
  public:
@@ -45,7 +44,8 @@ class SendTimeHistory {
   const Clock* const clock_;
   const int64_t packet_age_limit_ms_;
   SequenceNumberUnwrapper seq_num_unwrapper_;
-  std::map<int64_t, PacketFeedback> history_;
+  // Indexed by unwrapped sequence number.
+  SequenceBuffer<PacketFeedback> history_;
   rtc::Optional<int64_t> latest_acked_seq_num_;
 
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(SendTimeHistory);
@@ -130,15 +130,13 @@ void RemoteEstimatorProxy::OnPacketArrival(uint16_t sequence_number,
     return;
   }
 
-  if (packet_arrival_times_.lower_bound(window_start_seq_) ==
-      packet_arrival_times_.end()) {
+  if (packet_arrival_times_.empty() ||
+      packet_arrival_times_.end_seq() <= window_start_seq_) {
     // Start new feedback packet, cull old packets.
-    for (auto it = packet_arrival_times_.begin();
-         it != packet_arrival_times_.end() && it->first < seq &&
-         arrival_time - it->second >= kBackWindowMs;) {
-      auto delete_it = it;
-      ++it;
-      packet_arrival_times_.erase(delete_it);
+    while (!packet_arrival_times_.empty() &&
+           packet_arrival_times_.begin_seq() < seq &&
+           arrival_time - packet_arrival_times_.front() >= kBackWindowMs) {
+      packet_arrival_times_.pop_front();
     }
   }
 
@@ -149,51 +147,66 @@ void RemoteEstimatorProxy::OnPacketArrival(uint16_t sequence_number,
   }
 
   // We are only interested in the first time a packet is received.
-  if (packet_arrival_times_.find(seq) != packet_arrival_times_.end())
-    return;
-
-  packet_arrival_times_[seq] = arrival_time;
+  packet_arrival_times_.Insert(seq, arrival_time);
 }
 
 bool RemoteEstimatorProxy::BuildFeedbackPacket(
     rtcp::TransportFeedback* feedback_packet) {
   // window_start_seq_ is the first sequence number to include in the current
-  // feedback packet. Some older may still be in the map, in case a reordering
-  // happens and we need to retransmit them.
+  // feedback packet. Some older may still be in the buffer, in case a
+  // reordering happens and we need to retransmit them.
   rtc::CritScope cs(&lock_);
-  auto it = packet_arrival_times_.lower_bound(window_start_seq_);
-  if (it == packet_arrival_times_.end()) {
+  int64_t seq = std::max(window_start_seq_, packet_arrival_times_.begin_seq());
+  while (seq < packet_arrival_times_.end_seq() &&
+         !packet_arrival_times_.Find(seq)) {
+    ++seq;
+  }
+  if (seq >= packet_arrival_times_.end_seq()) {
     // Feedback for all packets already sent.
     return false;
   }
 
   // TODO(sprang): Measure receive times in microseconds and remove the
   // conversions below.
-  const int64_t first_sequence = it->first;
+  const int64_t first_sequence = seq;
   feedback_packet->SetMediaSsrc(media_ssrc_);
   // Base sequence is the expected next (window_start_seq_). This is known, but
   // we might not have actually received it, so the base time shall be the time
   // of the first received packet in the feedback.
   feedback_packet->SetBase(static_cast<uint16_t>(window_start_seq_ & 0xFFFF),
-                           it->second * 1000);
+                           *packet_arrival_times_.Find(seq) * 1000);
   feedback_packet->SetFeedbackSequenceNumber(feedback_sequence_++);
-  for (; it != packet_arrival_times_.end(); ++it) {
-    if (!feedback_packet->AddReceivedPacket(
-            static_cast<uint16_t>(it->first & 0xFFFF), it->second * 1000)) {
-      // If we can't even add the first seq to the feedback packet, we won't be
-      // able to build it at all.
-      RTC_CHECK_NE(first_sequence, it->first);
-
-      // Could not add timestamp, feedback packet might be full. Return and
-      // try again with a fresh packet.
-      break;
-    }
 
-    // Note: Don't erase items from packet_arrival_times_ after sending, in case
-    // they need to be re-sent after a reordering. Removal will be handled
-    // by OnPacketArrival once packets are too old.
-    window_start_seq_ = it->first + 1;
+  // A feedback packet can't report more statuses than this, counted from its
+  // base sequence number, so the packets after are left for the next one.
+  const int64_t end_seq = std::min<int64_t>(
+      packet_arrival_times_.end_seq(),
+      window_start_seq_ + rtcp::TransportFeedback::kMaxReportedPackets);
+  feedback_sequence_numbers_.clear();
+  feedback_arrival_times_us_.clear();
+  for (; seq < end_seq; ++seq) {
+    const int64_t* arrival_time_ms = packet_arrival_times_.Find(seq);
+    if (!arrival_time_ms)
+      continue;
+    feedback_sequence_numbers_.push_back(static_cast<uint16_t>(seq & 0xFFFF));
+    feedback_arrival_times_us_.push_back(*arrival_time_ms * 1000);
   }
+  size_t num_added = feedback_packet->AddReceivedPackets(
+      feedback_sequence_numbers_, feedback_arrival_times_us_);
+  // If we can't even add the first seq to the feedback packet, we won't be
+  // able to build it at all. If not all could be added, the feedback packet
+  // might be full, and the rest are sent in a fresh packet.
+  RTC_CHECK_GT(num_added, 0);
+
+  // Note: Don't erase items from packet_arrival_times_ after sending, in case
+  // they need to be re-sent after a reordering. Removal will be handled
+  // by OnPacketArrival once packets are too old. The added packets are less
+  // than 2^16 sequence numbers apart, so the difference does not wrap.
+  window_start_seq_ =
+      first_sequence +
+      static_cast<uint16_t>(feedback_sequence_numbers_[num_added - 1] -
+                            feedback_sequence_numbers_[0]) +
+      1;
 
   return true;
 }
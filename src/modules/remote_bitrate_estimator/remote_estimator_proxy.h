@@ -11,11 +11,11 @@
 #ifndef MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_ESTIMATOR_PROXY_H_
 #define MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_ESTIMATOR_PROXY_H_
 
-#include <map>
 #include <vector>
 
 #include "modules/include/module_common_types.h"
 #include "modules/remote_bitrate_estimator/include/remote_bitrate_estimator.h"
+#include "modules/remote_bitrate_estimator/sequence_buffer.h"
 #include "rtc_base/criticalsection.h"
 
 namespace webrtc {
@@ -67,8 +67,11 @@ class RemoteEstimatorProxy : public RemoteBitrateEstimator {
   uint8_t feedback_sequence_ RTC_GUARDED_BY(&lock_);
   SequenceNumberUnwrapper unwrapper_ RTC_GUARDED_BY(&lock_);
   int64_t window_start_seq_ RTC_GUARDED_BY(&lock_);
-  // Map unwrapped seq -> time.
-  std::map<int64_t, int64_t> packet_arrival_times_ RTC_GUARDED_BY(&lock_);
+  // Arrival times, indexed by unwrapped sequence number.
+  SequenceBuffer<int64_t> packet_arrival_times_ RTC_GUARDED_BY(&lock_);
+  // The packets to add to the feedback packet being built, reused.
+  std::vector<uint16_t> feedback_sequence_numbers_ RTC_GUARDED_BY(&lock_);
+  std::vector<int64_t> feedback_arrival_times_us_ RTC_GUARDED_BY(&lock_);
   int64_t send_interval_ms_ RTC_GUARDED_BY(&lock_);
 };
 
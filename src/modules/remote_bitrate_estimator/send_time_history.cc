@@ -10,6 +10,8 @@
 
 #include "modules/remote_bitrate_estimator/include/send_time_history.h"
 
+#include <algorithm>
+
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "rtc_base/checks.h"
 #include "system_wrappers/include/clock.h"
@@ -26,24 +28,23 @@ void SendTimeHistory::AddAndRemoveOld(const PacketFeedback& packet) {
   int64_t now_ms = clock_->TimeInMilliseconds();
   // Remove old.
   while (!history_.empty() &&
-         now_ms - history_.begin()->second.creation_time_ms >
-             packet_age_limit_ms_) {
+         now_ms - history_.front().creation_time_ms > packet_age_limit_ms_) {
     // TODO(sprang): Warn if erasing (too many) old items?
-    history_.erase(history_.begin());
+    history_.pop_front();
   }
 
   // Add new.
   int64_t unwrapped_seq_num = seq_num_unwrapper_.Unwrap(packet.sequence_number);
-  history_.insert(std::make_pair(unwrapped_seq_num, packet));
+  history_.Insert(unwrapped_seq_num, packet);
 }
 
 bool SendTimeHistory::OnSentPacket(uint16_t sequence_number,
                                    int64_t send_time_ms) {
   int64_t unwrapped_seq_num = seq_num_unwrapper_.Unwrap(sequence_number);
-  auto it = history_.find(unwrapped_seq_num);
-  if (it == history_.end())
+  PacketFeedback* packet = history_.Find(unwrapped_seq_num);
+  if (!packet)
     return false;
-  it->second.send_time_ms = send_time_ms;
+  packet->send_time_ms = send_time_ms;
   return true;
 }
 
@@ -55,32 +56,31 @@ bool SendTimeHistory::GetFeedback(PacketFeedback* packet_feedback,
   latest_acked_seq_num_.emplace(
       std::max(unwrapped_seq_num, latest_acked_seq_num_.value_or(0)));
   RTC_DCHECK_GE(*latest_acked_seq_num_, 0);
-  auto it = history_.find(unwrapped_seq_num);
-  if (it == history_.end())
+  const PacketFeedback* packet = history_.Find(unwrapped_seq_num);
+  if (!packet)
     return false;
 
   // Save arrival_time not to overwrite it.
   int64_t arrival_time_ms = packet_feedback->arrival_time_ms;
-  *packet_feedback = it->second;
+  *packet_feedback = *packet;
   packet_feedback->arrival_time_ms = arrival_time_ms;
 
   if (remove)
-    history_.erase(it);
+    history_.Erase(unwrapped_seq_num);
   return true;
 }
 
 size_t SendTimeHistory::GetOutstandingBytes(uint16_t local_net_id,
                                             uint16_t remote_net_id) const {
   size_t outstanding_bytes = 0;
-  auto unacked_it = history_.begin();
-  if (latest_acked_seq_num_) {
-    unacked_it = history_.lower_bound(*latest_acked_seq_num_);
-  }
-  for (; unacked_it != history_.end(); ++unacked_it) {
-    if (unacked_it->second.local_net_id == local_net_id &&
-        unacked_it->second.remote_net_id == remote_net_id &&
-        unacked_it->second.send_time_ms >= 0) {
-      outstanding_bytes += unacked_it->second.payload_size;
+  int64_t seq = history_.begin_seq();
+  if (latest_acked_seq_num_)
+    seq = std::max(seq, *latest_acked_seq_num_);
+  for (; seq < history_.end_seq(); ++seq) {
+    const PacketFeedback* packet = history_.Find(seq);
+    if (packet && packet->local_net_id == local_net_id &&
+        packet->remote_net_id == remote_net_id && packet->send_time_ms >= 0) {
+      outstanding_bytes += packet->payload_size;
     }
   }
   return outstanding_bytes;
@@ -0,0 +1,133 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_REMOTE_BITRATE_ESTIMATOR_SEQUENCE_BUFFER_H_
+#define MODULES_REMOTE_BITRATE_ESTIMATOR_SEQUENCE_BUFFER_H_
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "api/optional.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+// Ring buffer of values keyed by unwrapped sequence number, for the per packet
+// histories of send side BWE. It covers the range of sequence numbers from
+// the oldest to the newest value, with gaps where there is no value, so that
+// lookups are an index operation and inserting in order does not allocate
+// once the buffer has grown to its working size.
+template <typename T>
+class SequenceBuffer {
+ public:
+  SequenceBuffer() : begin_seq_(0), end_seq_(0), size_(0) {}
+
+  bool empty() const { return size_ == 0; }
+  // Number of values in the buffer.
+  size_t size() const { return size_; }
+  // The values are in [begin_seq(), end_seq()), which is iterated over with
+  // Find(). If not empty, there are values at begin_seq() and end_seq() - 1.
+  int64_t begin_seq() const { return begin_seq_; }
+  int64_t end_seq() const { return end_seq_; }
+
+  // Returns null if there is no value for |seq|.
+  T* Find(int64_t seq) {
+    if (seq < begin_seq_ || seq >= end_seq_)
+      return nullptr;
+    rtc::Optional<T>& slot = Slot(seq);
+    return slot ? &*slot : nullptr;
+  }
+  const T* Find(int64_t seq) const {
+    if (seq < begin_seq_ || seq >= end_seq_)
+      return nullptr;
+    const rtc::Optional<T>& slot = Slot(seq);
+    return slot ? &*slot : nullptr;
+  }
+
+  // Returns false, and keeps the old value, if there already is a value for
+  // |seq|.
+  bool Insert(int64_t seq, const T& value) {
+    if (empty()) {
+      begin_seq_ = seq;
+      end_seq_ = seq;
+    }
+    int64_t new_begin_seq = std::min(begin_seq_, seq);
+    int64_t new_end_seq = std::max(end_seq_, seq + 1);
+    if (static_cast<uint64_t>(new_end_seq - new_begin_seq) > slots_.size())
+      Grow(static_cast<size_t>(new_end_seq - new_begin_seq));
+    // Slots outside of the range are always empty.
+    rtc::Optional<T>& slot = Slot(seq);
+    if (slot)
+      return false;
+    slot.emplace(value);
+    begin_seq_ = new_begin_seq;
+    end_seq_ = new_end_seq;
+    ++size_;
+    return true;
+  }
+
+  void Erase(int64_t seq) {
+    if (seq < begin_seq_ || seq >= end_seq_)
+      return;
+    rtc::Optional<T>& slot = Slot(seq);
+    if (!slot)
+      return;
+    slot.reset();
+    --size_;
+    // Keep the range tight, so that lookups and iteration stay within it.
+    while (begin_seq_ < end_seq_ && !Slot(begin_seq_))
+      ++begin_seq_;
+    while (end_seq_ > begin_seq_ && !Slot(end_seq_ - 1))
+      --end_seq_;
+  }
+
+  // The value with the lowest sequence number. Must not be empty.
+  T& front() {
+    RTC_DCHECK(!empty());
+    return *Slot(begin_seq_);
+  }
+  void pop_front() { Erase(begin_seq_); }
+
+ private:
+  rtc::Optional<T>& Slot(int64_t seq) {
+    return slots_[static_cast<uint64_t>(seq) & (slots_.size() - 1)];
+  }
+  const rtc::Optional<T>& Slot(int64_t seq) const {
+    return slots_[static_cast<uint64_t>(seq) & (slots_.size() - 1)];
+  }
+
+  // Grows to a power of two number of slots of at least |min_size|, moving
+  // the values to their slots in the new size.
+  void Grow(size_t min_size) {
+    size_t new_size = std::max<size_t>(slots_.size(), 64);
+    while (new_size < min_size)
+      new_size *= 2;
+    std::vector<rtc::Optional<T>> new_slots(new_size);
+    for (int64_t seq = begin_seq_; seq < end_seq_ && !slots_.empty(); ++seq) {
+      rtc::Optional<T>& slot = Slot(seq);
+      if (slot)
+        new_slots[static_cast<uint64_t>(seq) & (new_size - 1)] =
+            std::move(slot);
+    }
+    slots_.swap(new_slots);
+  }
+
+  std::vector<rtc::Optional<T>> slots_;
+  int64_t begin_seq_;
+  int64_t end_seq_;
+  size_t size_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_REMOTE_BITRATE_ESTIMATOR_SEQUENCE_BUFFER_H_
@@ -0,0 +1,94 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/remote_bitrate_estimator/sequence_buffer.h"
+
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace test {
+
+TEST(SequenceBufferTest, InsertFindAndErase) {
+  SequenceBuffer<int> buffer;
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_EQ(nullptr, buffer.Find(0));
+
+  EXPECT_TRUE(buffer.Insert(10, 100));
+  EXPECT_TRUE(buffer.Insert(12, 120));
+  EXPECT_EQ(2u, buffer.size());
+  EXPECT_EQ(10, buffer.begin_seq());
+  EXPECT_EQ(13, buffer.end_seq());
+  ASSERT_TRUE(buffer.Find(12));
+  EXPECT_EQ(120, *buffer.Find(12));
+  EXPECT_EQ(nullptr, buffer.Find(11));
+
+  // An existing value is kept.
+  EXPECT_FALSE(buffer.Insert(12, 121));
+  EXPECT_EQ(120, *buffer.Find(12));
+
+  buffer.Erase(12);
+  EXPECT_EQ(nullptr, buffer.Find(12));
+  EXPECT_EQ(11, buffer.end_seq());
+  buffer.Erase(10);
+  EXPECT_TRUE(buffer.empty());
+}
+
+TEST(SequenceBufferTest, RangeStaysTightWhenPoppingWithGaps) {
+  SequenceBuffer<int> buffer;
+  buffer.Insert(1, 1);
+  buffer.Insert(5, 5);
+  buffer.Insert(6, 6);
+  EXPECT_EQ(1, buffer.front());
+  buffer.pop_front();
+  EXPECT_EQ(5, buffer.begin_seq());
+  EXPECT_EQ(5, buffer.front());
+}
+
+TEST(SequenceBufferTest, InsertsBeforeTheFirstValue) {
+  SequenceBuffer<int> buffer;
+  buffer.Insert(100, 100);
+  EXPECT_TRUE(buffer.Insert(98, 98));
+  EXPECT_EQ(98, buffer.begin_seq());
+  EXPECT_EQ(98, buffer.front());
+  EXPECT_EQ(100, *buffer.Find(100));
+}
+
+TEST(SequenceBufferTest, GrowsAndWrapsAround) {
+  SequenceBuffer<int64_t> buffer;
+  // Keep a sliding window of 1000 values, which wraps around the slots many
+  // times, and grow it to 5000 in the middle.
+  int64_t first_seq = 0;
+  for (int64_t seq = 0; seq < 100000; ++seq) {
+    ASSERT_TRUE(buffer.Insert(seq, seq * 2));
+    size_t window = seq > 50000 && seq < 60000 ? 5000 : 1000;
+    while (buffer.size() > window) {
+      ASSERT_EQ(first_seq * 2, buffer.front());
+      buffer.pop_front();
+      ++first_seq;
+    }
+  }
+  for (int64_t seq = first_seq; seq < 100000; ++seq) {
+    ASSERT_TRUE(buffer.Find(seq));
+    EXPECT_EQ(seq * 2, *buffer.Find(seq));
+  }
+  EXPECT_EQ(nullptr, buffer.Find(first_seq - 1));
+}
+
+TEST(SequenceBufferTest, NegativeSequenceNumbers) {
+  SequenceBuffer<int> buffer;
+  buffer.Insert(-3, 3);
+  buffer.Insert(2, 2);
+  EXPECT_EQ(3, *buffer.Find(-3));
+  EXPECT_EQ(2, *buffer.Find(2));
+  EXPECT_EQ(nullptr, buffer.Find(-2));
+}
+
+}  // namespace test
+}  // namespace webrtc
@@ -20,6 +20,12 @@
 #include "system_wrappers/include/clock.h"
 
 namespace webrtc {
+namespace {
+// While the congestion window is full, a packet is sent this often anyway so
+// that feedback keeps arriving, like PacedSender does while paused. Otherwise
+// lost packets with nothing sent after them would block the window forever.
+const int64_t kWindowFullPacketIntervalUs = 500000;
+}  // namespace
 
 BbrPacedSender::BbrPacedSender(const Clock* clock,
                                PacedSender::PacketSender* packet_sender,
@@ -29,10 +35,9 @@ BbrPacedSender::BbrPacedSender(const Clock* clock,
       estimated_bitrate_bps_(100000),
       min_send_bitrate_kbps_(0),
       pacing_bitrate_kbps_(0),
-      time_last_update_us_(clock->TimeInMicroseconds()),
-      time_last_update_ms_(clock->TimeInMilliseconds()),
-      next_packet_send_time_(clock_->TimeInMilliseconds()),
-      rounding_error_time_ms_(0.0f),
+      next_send_time_us_(clock->TimeInMicroseconds()),
+      last_send_time_us_(clock->TimeInMicroseconds()),
+      last_process_time_us_(clock->TimeInMicroseconds()),
       packets_(),
       max_data_inflight_bytes_(10000),
       congestion_window_(new testing::bwe::CongestionWindow()) {}
@@ -67,24 +72,13 @@ void BbrPacedSender::InsertPacket(RtpPacketSender::Priority priority,
 }
 
 int64_t BbrPacedSender::TimeUntilNextProcess() {
-  // Once errors absolute value hits 1 millisecond, add compensating term to
-  // the |next_packet_send_time_|, so that we can send packet earlier or later,
-  // depending on the error.
-  rounding_error_time_ms_ = std::min(rounding_error_time_ms_, 1.0f);
-  if (rounding_error_time_ms_ < -0.9f)
-    rounding_error_time_ms_ = -1.0f;
-  int64_t result =
-      std::max<int64_t>(next_packet_send_time_ + time_last_update_ms_ -
-                            clock_->TimeInMilliseconds(),
-                        0);
-  if (rounding_error_time_ms_ == 1.0f || rounding_error_time_ms_ == -1.0f) {
-    next_packet_send_time_ -= rounding_error_time_ms_;
-    result = std::max<int64_t>(next_packet_send_time_ + time_last_update_ms_ -
-                                   clock_->TimeInMilliseconds(),
-                               0);
-    rounding_error_time_ms_ = 0;
-  }
-  return result;
+  // If there is nothing to send, or the congestion window doesn't allow
+  // sending, try again in 1 millisecond.
+  int64_t next_process_time_us = next_send_time_us_;
+  if (packets_.empty() || CongestionWindowFull())
+    next_process_time_us = last_process_time_us_ + 1000;
+  return std::max<int64_t>(
+      (next_process_time_us - clock_->TimeInMicroseconds() + 999) / 1000, 0);
 }
 
 void BbrPacedSender::OnBytesAcked(size_t bytes) {
@@ -94,42 +88,32 @@ void BbrPacedSender::OnBytesAcked(size_t bytes) {
 void BbrPacedSender::Process() {
   pacing_bitrate_kbps_ =
       std::max(min_send_bitrate_kbps_, estimated_bitrate_bps_ / 1000);
-  // If we have nothing to send, try sending again in 1 millisecond.
-  if (packets_.empty()) {
-    next_packet_send_time_ = 1;
-    return;
-  }
-  // If congestion window doesn't allow sending, try again in 1 millisecond.
-  if (packets_.front()->size_in_bytes + congestion_window_->data_inflight() >
-      max_data_inflight_bytes_) {
-    next_packet_send_time_ = 1;
-    return;
-  }
-  bool sent = TryToSendPacket(packets_.front());
-  if (sent) {
-    congestion_window_->PacketSent(packets_.front()->size_in_bytes);
+  int64_t now_us = clock_->TimeInMicroseconds();
+  last_process_time_us_ = now_us;
+  // Send every packet that is due, so that the pacing rate is not bounded by
+  // one packet per process call. Time not used while the queue was empty is
+  // not saved up for more than one millisecond.
+  next_send_time_us_ = std::max(next_send_time_us_, now_us - 1000);
+  while (!packets_.empty() && next_send_time_us_ <= now_us &&
+         (!CongestionWindowFull() ||
+          now_us - last_send_time_us_ >= kWindowFullPacketIntervalUs)) {
+    if (!TryToSendPacket(packets_.front()))
+      return;
+    last_send_time_us_ = now_us;
+    size_t size_in_bytes = packets_.front()->size_in_bytes;
+    congestion_window_->PacketSent(size_in_bytes);
     delete packets_.front();
     packets_.pop_front();
-    time_last_update_ms_ = clock_->TimeInMilliseconds();
-    if (!packets_.empty()) {
-      // Calculate in what time we should send current packet.
-      next_packet_send_time_ = (packets_.front()->size_in_bytes * 8000 +
-                                estimated_bitrate_bps_ / 2) /
-                               estimated_bitrate_bps_;
-      // As rounding errors may happen, |rounding_error_time_ms_| could be
-      // positive or negative depending on packet was sent earlier or later,
-      // after it hits certain threshold we will send a packet earlier or later
-      // depending on error we had so far.
-      rounding_error_time_ms_ +=
-          (next_packet_send_time_ - packets_.front()->size_in_bytes * 8000.0f /
-                                        estimated_bitrate_bps_ * 1.0f);
-    } else {
-      // If sending was unsuccessful try again in 1 millisecond.
-      next_packet_send_time_ = 1;
-    }
+    next_send_time_us_ +=
+        size_in_bytes * 8000000 / std::max<uint32_t>(estimated_bitrate_bps_, 1);
   }
 }
 
+bool BbrPacedSender::CongestionWindowFull() const {
+  return packets_.front()->size_in_bytes + congestion_window_->data_inflight() >
+         max_data_inflight_bytes_;
+}
+
 bool BbrPacedSender::TryToSendPacket(Packet* packet) {
   PacedPacketInfo pacing_info;
   return packet_sender_->TimeToSendPacket(packet->ssrc, packet->sequence_number,
@@ -74,15 +74,17 @@ class BbrPacedSender : public Pacer {
   bool TryToSendPacket(Packet* packet);
 
  private:
+  // The front packet does not fit in the congestion window.
+  bool CongestionWindowFull() const;
+
   const Clock* const clock_;
   PacedSender::PacketSender* const packet_sender_;
   uint32_t estimated_bitrate_bps_;
   uint32_t min_send_bitrate_kbps_;
   uint32_t pacing_bitrate_kbps_;
-  int64_t time_last_update_us_;
-  int64_t time_last_update_ms_;
-  int64_t next_packet_send_time_;
-  float rounding_error_time_ms_;
+  int64_t next_send_time_us_;
+  int64_t last_send_time_us_;
+  int64_t last_process_time_us_;
   std::list<Packet*> packets_;
   // TODO(gnish): integrate |max_data_inflight| into congestion window class.
   size_t max_data_inflight_bytes_;
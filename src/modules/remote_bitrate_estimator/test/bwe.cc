@@ -14,6 +14,7 @@
 
 #include "modules/remote_bitrate_estimator/test/estimators/bbr.h"
 #include "modules/remote_bitrate_estimator/test/estimators/nada.h"
+#include "modules/remote_bitrate_estimator/test/estimators/network_controller_sender.h"
 #include "modules/remote_bitrate_estimator/test/estimators/remb.h"
 #include "modules/remote_bitrate_estimator/test/estimators/send_side.h"
 #include "modules/remote_bitrate_estimator/test/estimators/tcp.h"
@@ -96,6 +97,10 @@ BweSender* CreateBweSender(BandwidthEstimatorType estimator,
       return new NadaBweSender(kbps, observer, clock);
     case kBbrEstimator:
       return new BbrBweSender(observer, clock);
+    case kGoogCcControllerEstimator:
+      FALLTHROUGH();
+    case kBbrControllerEstimator:
+      return new NetworkControllerBweSender(estimator, kbps, observer, clock);
     case kTcpEstimator:
       FALLTHROUGH();
     case kNullEstimator:
@@ -112,6 +117,10 @@ BweReceiver* CreateBweReceiver(BandwidthEstimatorType type,
     case kRembEstimator:
       return new RembReceiver(flow_id, plot);
     case kSendSideEstimator:
+      FALLTHROUGH();
+    case kGoogCcControllerEstimator:
+      FALLTHROUGH();
+    case kBbrControllerEstimator:
       return new SendSideBweReceiver(flow_id);
     case kNadaEstimator:
       return new NadaBweReceiver(flow_id);
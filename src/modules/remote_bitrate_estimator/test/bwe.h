@@ -178,10 +178,14 @@ enum BandwidthEstimatorType {
   kRembEstimator,
   kSendSideEstimator,
   kTcpEstimator,
-  kBbrEstimator
+  kBbrEstimator,
+  // The production controllers behind NetworkControllerInterface.
+  kGoogCcControllerEstimator,
+  kBbrControllerEstimator
 };
 
-const char* const bwe_names[] = {"Null", "NADA", "REMB", "GCC", "TCP", "BBR"};
+const char* const bwe_names[] = {"Null", "NADA", "REMB", "GCC", "TCP", "BBR",
+                                 "GoogCcController", "BbrController"};
 
 int64_t GetAbsSendTimeInMs(uint32_t abs_send_time);
 
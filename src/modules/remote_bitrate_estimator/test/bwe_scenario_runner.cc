@@ -0,0 +1,329 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/remote_bitrate_estimator/test/bwe_scenario_runner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <sstream>
+
+#include "modules/remote_bitrate_estimator/test/bwe_test_framework.h"
+#include "modules/remote_bitrate_estimator/test/metric_recorder.h"
+#include "modules/remote_bitrate_estimator/test/packet_receiver.h"
+#include "modules/remote_bitrate_estimator/test/packet_sender.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/platform_thread.h"
+#include "system_wrappers/include/cpu_info.h"
+
+namespace webrtc {
+namespace testing {
+namespace bwe {
+
+namespace {
+
+// Metrics are computed over windows of this length, and capacity changes take
+// effect at window boundaries.
+const int64_t kWindowMs = 1000;
+const double kConvergedUtilization = 0.85;
+
+struct MetricDescription {
+  const char* name;
+  bool higher_is_better;
+  // Changes smaller than this are never reported as regressions, so metrics
+  // close to zero don't fail on noise.
+  double absolute_margin;
+};
+
+const MetricDescription kMetricDescriptions[] = {
+    {"utilization", true, 0.02},
+    {"p95_delay_ms", false, 10.0},
+    {"loss_ratio", false, 0.005},
+    {"fairness", true, 0.02},
+    {"convergence_time_ms", false, 1000.0},
+};
+
+double JainFairnessIndex(const std::vector<double>& values) {
+  double sum = 0.0;
+  double sum_squares = 0.0;
+  for (double value : values) {
+    sum += value;
+    sum_squares += value * value;
+  }
+  if (sum_squares == 0.0)
+    return 0.0;
+  return sum * sum / (values.size() * sum_squares);
+}
+
+class ScenarioSimulation : public BweTest {
+ public:
+  ScenarioSimulation() : BweTest(false) {}
+
+  BweScenarioMetrics Run(const BweScenario& scenario);
+};
+
+BweScenarioMetrics ScenarioSimulation::Run(const BweScenario& scenario) {
+  const LinkProfile& link = scenario.link;
+  const size_t num_media_flows = scenario.flows.num_media_flows;
+  const size_t num_flows = num_media_flows + scenario.flows.num_tcp_flows;
+  RTC_DCHECK_GT(num_flows, 0u);
+
+  FlowIds all_flow_ids;
+  std::vector<int64_t> start_times_ms;
+  for (size_t i = 0; i < num_flows; ++i) {
+    all_flow_ids.insert(static_cast<int>(i));
+    start_times_ms.push_back(i * scenario.flows.start_interval_ms);
+  }
+  const int64_t all_started_ms = start_times_ms.back();
+
+  std::vector<std::unique_ptr<VideoSource>> sources;
+  std::vector<std::unique_ptr<PacketSender>> senders;
+  for (size_t i = 0; i < num_media_flows; ++i) {
+    sources.emplace_back(new AdaptiveVideoSource(static_cast<int>(i), 30, 300,
+                                                 0, start_times_ms[i]));
+    senders.emplace_back(new PacedVideoSender(&uplink_, sources.back().get(),
+                                              scenario.estimator));
+  }
+  for (size_t i = num_media_flows; i < num_flows; ++i) {
+    senders.emplace_back(
+        new TcpSender(&uplink_, static_cast<int>(i), start_times_ms[i]));
+  }
+
+  uint32_t capacity_kbps = link.CapacityKbpsAt(0);
+  ChokeFilter choke(&uplink_, all_flow_ids);
+  choke.set_capacity_kbps(capacity_kbps);
+  choke.set_max_delay_ms(link.max_queueing_delay_ms);
+  LinkShare link_share(&choke);
+
+  DelayFilter delay_uplink(&uplink_, all_flow_ids);
+  delay_uplink.SetOneWayDelayMs(link.one_way_delay_ms);
+  JitterFilter jitter(&uplink_, all_flow_ids);
+  jitter.SetMaxJitter(link.max_jitter_ms);
+  LossFilter loss(&uplink_, all_flow_ids);
+  loss.SetLoss(link.loss_percent);
+
+  std::vector<std::unique_ptr<MetricRecorder>> metric_recorders;
+  std::vector<std::unique_ptr<PacketReceiver>> receivers;
+  for (size_t i = 0; i < num_flows; ++i) {
+    BandwidthEstimatorType bwe_type =
+        i < num_media_flows ? scenario.estimator : kTcpEstimator;
+    metric_recorders.emplace_back(
+        new MetricRecorder(bwe_names[bwe_type], static_cast<int>(i),
+                           senders[i].get(), &link_share));
+    receivers.emplace_back(new PacketReceiver(&uplink_, static_cast<int>(i),
+                                              bwe_type, false, false,
+                                              metric_recorders.back().get()));
+  }
+
+  DelayFilter delay_downlink(&downlink_, all_flow_ids);
+  delay_downlink.SetOneWayDelayMs(link.one_way_delay_ms);
+
+  std::vector<size_t> last_flow_bytes(num_flows, 0);
+  std::vector<double> flow_bits(num_flows, 0.0);
+  double received_bits = 0.0;
+  double capacity_bits = 0.0;
+  bool converging = true;
+  int64_t converging_since_ms = 0;
+  int64_t convergence_time_ms = 0;
+  for (int64_t time_ms = 0; time_ms < scenario.duration_ms;
+       time_ms += kWindowMs) {
+    uint32_t new_capacity_kbps = link.CapacityKbpsAt(time_ms);
+    if (new_capacity_kbps != capacity_kbps) {
+      choke.set_capacity_kbps(new_capacity_kbps);
+      if (new_capacity_kbps > capacity_kbps && !converging) {
+        converging = true;
+        converging_since_ms = time_ms;
+      }
+      capacity_kbps = new_capacity_kbps;
+    }
+
+    RunFor(kWindowMs);
+
+    double window_bits = 0.0;
+    for (size_t i = 0; i < num_flows; ++i) {
+      size_t bytes = metric_recorders[i]->throughput_bytes();
+      double bits = 8.0 * (bytes - last_flow_bytes[i]);
+      last_flow_bytes[i] = bytes;
+      window_bits += bits;
+      if (time_ms >= all_started_ms)
+        flow_bits[i] += bits;
+    }
+    // Capacity in kbps times milliseconds gives bits.
+    const double window_capacity_bits =
+        static_cast<double>(capacity_kbps) * kWindowMs;
+    if (time_ms >= all_started_ms) {
+      received_bits += window_bits;
+      capacity_bits += window_capacity_bits;
+    }
+    if (converging &&
+        window_bits >= kConvergedUtilization * window_capacity_bits) {
+      convergence_time_ms = std::max(
+          convergence_time_ms, time_ms + kWindowMs - converging_since_ms);
+      converging = false;
+    }
+  }
+
+  BweScenarioMetrics metrics;
+  metrics.scenario = scenario.Name();
+  if (capacity_bits > 0.0)
+    metrics.utilization = received_bits / capacity_bits;
+  for (size_t i = 0; i < num_media_flows; ++i) {
+    int64_t delay_ms = metric_recorders[i]->NthDelayPercentile(95) -
+                       link.one_way_delay_ms;
+    metrics.p95_delay_ms =
+        std::max(metrics.p95_delay_ms, static_cast<double>(delay_ms));
+    metrics.loss_ratio += receivers[i]->GlobalPacketLoss();
+  }
+  if (num_media_flows > 0)
+    metrics.loss_ratio /= num_media_flows;
+  metrics.fairness = JainFairnessIndex(flow_bits);
+  metrics.convergence_time_ms =
+      converging ? scenario.duration_ms : convergence_time_ms;
+  return metrics;
+}
+
+// Shared by the worker threads, which take the next scenario to run until
+// all have been taken.
+struct ScenarioQueue {
+  ScenarioQueue(const std::vector<BweScenario>& scenarios,
+                std::vector<BweScenarioMetrics>* metrics)
+      : scenarios(scenarios), metrics(metrics) {}
+
+  const std::vector<BweScenario>& scenarios;
+  std::vector<BweScenarioMetrics>* const metrics;
+  rtc::CriticalSection crit;
+  size_t next_index RTC_GUARDED_BY(crit) = 0;
+};
+
+void RunScenarios(void* obj) {
+  ScenarioQueue* queue = static_cast<ScenarioQueue*>(obj);
+  while (true) {
+    size_t index;
+    {
+      rtc::CritScope cs(&queue->crit);
+      if (queue->next_index == queue->scenarios.size())
+        return;
+      index = queue->next_index++;
+    }
+    // Each index is written by one thread only, and the vector is not resized
+    // while the threads run.
+    (*queue->metrics)[index] =
+        BweScenarioRunner::RunScenario(queue->scenarios[index]);
+  }
+}
+
+}  // namespace
+
+uint32_t LinkProfile::CapacityKbpsAt(int64_t time_ms) const {
+  RTC_DCHECK(!capacity_steps.empty());
+  for (const CapacityStep& step : capacity_steps) {
+    if (time_ms < step.duration_ms)
+      return step.capacity_kbps;
+    time_ms -= step.duration_ms;
+  }
+  return capacity_steps.back().capacity_kbps;
+}
+
+std::string BweScenario::Name() const {
+  std::stringstream ss;
+  ss << bwe_names[estimator] << "/" << link.name << "/" << flows.name;
+  return ss.str();
+}
+
+BweScenarioRunner::BweScenarioRunner(size_t num_threads)
+    : num_threads_(num_threads > 0 ? num_threads
+                                   : CpuInfo::DetectNumberOfCores()) {}
+
+std::vector<BweScenarioMetrics> BweScenarioRunner::Run(
+    const std::vector<BweScenario>& scenarios) const {
+  std::vector<BweScenarioMetrics> metrics(scenarios.size());
+  ScenarioQueue queue(scenarios, &metrics);
+  size_t num_threads = std::min(num_threads_, scenarios.size());
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads.emplace_back(
+        new rtc::PlatformThread(&RunScenarios, &queue, "BweScenarioRunner"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+  return metrics;
+}
+
+BweScenarioMetrics BweScenarioRunner::RunScenario(const BweScenario& scenario) {
+  ScenarioSimulation simulation;
+  return simulation.Run(scenario);
+}
+
+std::vector<BweScenario> CreateScenarioMatrix(
+    const std::vector<BandwidthEstimatorType>& estimators,
+    const std::vector<LinkProfile>& links,
+    const std::vector<FlowMix>& flow_mixes,
+    int64_t duration_ms) {
+  std::vector<BweScenario> scenarios;
+  for (BandwidthEstimatorType estimator : estimators) {
+    for (const LinkProfile& link : links) {
+      for (const FlowMix& flows : flow_mixes)
+        scenarios.push_back(BweScenario{estimator, link, flows, duration_ms});
+    }
+  }
+  return scenarios;
+}
+
+ScenarioBaseLine MetricsToBaseLine(
+    const std::vector<BweScenarioMetrics>& metrics) {
+  ScenarioBaseLine baseline;
+  for (const BweScenarioMetrics& m : metrics) {
+    std::map<std::string, double>& values = baseline[m.scenario];
+    values["utilization"] = m.utilization;
+    values["p95_delay_ms"] = m.p95_delay_ms;
+    values["loss_ratio"] = m.loss_ratio;
+    values["fairness"] = m.fairness;
+    values["convergence_time_ms"] = m.convergence_time_ms;
+  }
+  return baseline;
+}
+
+std::vector<std::string> FindRegressions(const ScenarioBaseLine& baseline,
+                                         const ScenarioBaseLine& current,
+                                         double relative_tolerance) {
+  std::vector<std::string> regressions;
+  for (const auto& scenario : current) {
+    auto baseline_it = baseline.find(scenario.first);
+    if (baseline_it == baseline.end())
+      continue;
+    for (const MetricDescription& description : kMetricDescriptions) {
+      auto value_it = scenario.second.find(description.name);
+      auto expected_it = baseline_it->second.find(description.name);
+      if (value_it == scenario.second.end() ||
+          expected_it == baseline_it->second.end()) {
+        continue;
+      }
+      double value = value_it->second;
+      double expected = expected_it->second;
+      double margin = std::max(relative_tolerance * std::abs(expected),
+                               description.absolute_margin);
+      bool regressed = description.higher_is_better ? value < expected - margin
+                                                    : value > expected + margin;
+      if (regressed) {
+        std::stringstream ss;
+        ss << scenario.first << " " << description.name << ": " << value
+           << " (baseline " << expected << ")";
+        regressions.push_back(ss.str());
+      }
+    }
+  }
+  return regressions;
+}
+
+}  // namespace bwe
+}  // namespace testing
+}  // namespace webrtc
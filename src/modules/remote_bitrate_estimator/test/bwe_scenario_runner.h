@@ -0,0 +1,121 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_REMOTE_BITRATE_ESTIMATOR_TEST_BWE_SCENARIO_RUNNER_H_
+#define MODULES_REMOTE_BITRATE_ESTIMATOR_TEST_BWE_SCENARIO_RUNNER_H_
+
+#include <string>
+#include <vector>
+
+#include "modules/remote_bitrate_estimator/test/bwe.h"
+#include "modules/remote_bitrate_estimator/test/bwe_test.h"
+#include "modules/remote_bitrate_estimator/test/bwe_test_baselinefile.h"
+
+namespace webrtc {
+namespace testing {
+namespace bwe {
+
+// A bottleneck link whose capacity follows a piecewise constant trace.
+struct LinkProfile {
+  struct CapacityStep {
+    int64_t duration_ms;
+    uint32_t capacity_kbps;
+  };
+
+  std::string name;
+  // The last step lasts until the end of the scenario. The runner changes the
+  // capacity at whole seconds only.
+  std::vector<CapacityStep> capacity_steps;
+  int64_t one_way_delay_ms = kOneWayDelayMs;
+  int64_t max_queueing_delay_ms = kMaxQueueingDelayMs;
+  int64_t max_jitter_ms = 0;
+  float loss_percent = 0.0f;
+
+  uint32_t CapacityKbpsAt(int64_t time_ms) const;
+};
+
+// The flows competing for the link. Media flows use the estimator of the
+// scenario, and the flows start |start_interval_ms| apart, media flows first.
+struct FlowMix {
+  std::string name;
+  size_t num_media_flows = 1;
+  size_t num_tcp_flows = 0;
+  int64_t start_interval_ms = 0;
+};
+
+struct BweScenario {
+  BandwidthEstimatorType estimator;
+  LinkProfile link;
+  FlowMix flows;
+  int64_t duration_ms;
+
+  // "<estimator>/<link>/<flow mix>", e.g. "GCC/step_down/one_media".
+  std::string Name() const;
+};
+
+struct BweScenarioMetrics {
+  std::string scenario;
+  // Bits received by all flows over the link capacity, from the time the last
+  // flow started.
+  double utilization = 0.0;
+  // The largest 95th percentile delay of the media flows, excluding the
+  // propagation delay of the link.
+  double p95_delay_ms = 0.0;
+  // The average packet loss ratio of the media flows.
+  double loss_ratio = 0.0;
+  // Jain's fairness index of the throughput of all flows, from the time the
+  // last flow started. 1 if the capacity is shared equally.
+  double fairness = 0.0;
+  // The longest time, after the first flow started or the capacity increased,
+  // until the link was utilized to 85% over a one second window. The duration
+  // of the scenario if that never happened.
+  double convergence_time_ms = 0.0;
+};
+
+// Runs the simulations of many scenarios in parallel. Each scenario is
+// simulated on one thread with its own senders, filters and receivers, so the
+// results do not depend on the number of threads.
+class BweScenarioRunner {
+ public:
+  // Uses one thread per core if |num_threads| is 0.
+  explicit BweScenarioRunner(size_t num_threads);
+
+  // Returns the metrics in the order of |scenarios|.
+  std::vector<BweScenarioMetrics> Run(
+      const std::vector<BweScenario>& scenarios) const;
+
+  static BweScenarioMetrics RunScenario(const BweScenario& scenario);
+
+ private:
+  const size_t num_threads_;
+};
+
+// Returns every combination of estimator, link and flow mix.
+std::vector<BweScenario> CreateScenarioMatrix(
+    const std::vector<BandwidthEstimatorType>& estimators,
+    const std::vector<LinkProfile>& links,
+    const std::vector<FlowMix>& flow_mixes,
+    int64_t duration_ms);
+
+ScenarioBaseLine MetricsToBaseLine(
+    const std::vector<BweScenarioMetrics>& metrics);
+
+// Compares |current| to |baseline| and returns a description of each metric
+// that got worse by more than |relative_tolerance| and a small per-metric
+// absolute margin. Scenarios missing from either side are ignored.
+std::vector<std::string> FindRegressions(const ScenarioBaseLine& baseline,
+                                         const ScenarioBaseLine& current,
+                                         double relative_tolerance);
+
+}  // namespace bwe
+}  // namespace testing
+}  // namespace webrtc
+
+#endif  // MODULES_REMOTE_BITRATE_ESTIMATOR_TEST_BWE_SCENARIO_RUNNER_H_
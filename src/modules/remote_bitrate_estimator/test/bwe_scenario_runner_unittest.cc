@@ -0,0 +1,124 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/remote_bitrate_estimator/test/bwe_scenario_runner.h"
+
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace testing {
+namespace bwe {
+
+namespace {
+
+LinkProfile StepLink() {
+  LinkProfile link;
+  link.name = "step";
+  link.capacity_steps = {{5000, 1000}, {5000, 500}};
+  return link;
+}
+
+FlowMix SingleFlow() {
+  FlowMix flows;
+  flows.name = "single";
+  return flows;
+}
+
+}  // namespace
+
+TEST(BweScenarioRunnerTest, CapacityFollowsSteps) {
+  LinkProfile link = StepLink();
+  EXPECT_EQ(1000u, link.CapacityKbpsAt(0));
+  EXPECT_EQ(1000u, link.CapacityKbpsAt(4999));
+  EXPECT_EQ(500u, link.CapacityKbpsAt(5000));
+  // The last step is held.
+  EXPECT_EQ(500u, link.CapacityKbpsAt(60000));
+}
+
+TEST(BweScenarioRunnerTest, CreatesMatrixOfScenarios) {
+  FlowMix competing;
+  competing.name = "competing";
+  competing.num_tcp_flows = 1;
+  std::vector<BweScenario> scenarios = CreateScenarioMatrix(
+      {kSendSideEstimator, kNadaEstimator}, {StepLink()},
+      {SingleFlow(), competing}, 10000);
+  ASSERT_EQ(4u, scenarios.size());
+  EXPECT_EQ("GCC/step/single", scenarios[0].Name());
+  EXPECT_EQ("GCC/step/competing", scenarios[1].Name());
+  EXPECT_EQ("NADA/step/single", scenarios[2].Name());
+  EXPECT_EQ(10000, scenarios[3].duration_ms);
+}
+
+TEST(BweScenarioRunnerTest, BaseLineJsonRoundTrip) {
+  ScenarioBaseLine baseline;
+  baseline["GCC/step/single"]["utilization"] = 0.75;
+  baseline["GCC/step/single"]["p95_delay_ms"] = 120;
+  baseline["REMB/step/single"]["fairness"] = 1.0;
+
+  ScenarioBaseLine parsed;
+  ASSERT_TRUE(
+      ScenarioBaseLineFromJson(ScenarioBaseLineToJson(baseline), &parsed));
+  EXPECT_EQ(baseline, parsed);
+  EXPECT_FALSE(ScenarioBaseLineFromJson("{\"a\": 1}", &parsed));
+  EXPECT_FALSE(ScenarioBaseLineFromJson("not json", &parsed));
+}
+
+TEST(BweScenarioRunnerTest, FindsRegressionsInTheWorseDirectionOnly) {
+  ScenarioBaseLine baseline;
+  baseline["s"]["utilization"] = 0.9;
+  baseline["s"]["p95_delay_ms"] = 100;
+  baseline["s"]["loss_ratio"] = 0.0;
+
+  ScenarioBaseLine current = baseline;
+  // Improvements and changes within the tolerance are fine.
+  current["s"]["utilization"] = 0.95;
+  current["s"]["p95_delay_ms"] = 105;
+  current["s"]["loss_ratio"] = 0.004;
+  current["unknown"]["utilization"] = 0.0;
+  EXPECT_TRUE(FindRegressions(baseline, current, 0.1).empty());
+
+  current["s"]["utilization"] = 0.7;
+  current["s"]["p95_delay_ms"] = 150;
+  std::vector<std::string> regressions =
+      FindRegressions(baseline, current, 0.1);
+  ASSERT_EQ(2u, regressions.size());
+  EXPECT_NE(std::string::npos, regressions[0].find("utilization"));
+  EXPECT_NE(std::string::npos, regressions[1].find("p95_delay_ms"));
+}
+
+TEST(BweScenarioRunnerTest, ParallelRunMatchesSequentialRun) {
+  FlowMix two_flows;
+  two_flows.name = "two";
+  two_flows.num_media_flows = 2;
+  two_flows.start_interval_ms = 2000;
+  std::vector<BweScenario> scenarios = CreateScenarioMatrix(
+      {kSendSideEstimator, kRembEstimator}, {StepLink()},
+      {SingleFlow(), two_flows}, 10000);
+
+  ScenarioBaseLine sequential =
+      MetricsToBaseLine(BweScenarioRunner(1).Run(scenarios));
+  std::vector<BweScenarioMetrics> metrics = BweScenarioRunner(4).Run(scenarios);
+  EXPECT_EQ(sequential, MetricsToBaseLine(metrics));
+
+  ASSERT_EQ(scenarios.size(), metrics.size());
+  for (size_t i = 0; i < metrics.size(); ++i) {
+    EXPECT_EQ(scenarios[i].Name(), metrics[i].scenario);
+    EXPECT_GT(metrics[i].utilization, 0.0);
+    EXPECT_LE(metrics[i].utilization, 1.05);
+    EXPECT_GT(metrics[i].fairness, 0.0);
+    EXPECT_LE(metrics[i].fairness, 1.0 + 1e-9);
+    EXPECT_GE(metrics[i].loss_ratio, 0.0);
+    EXPECT_LE(metrics[i].convergence_time_ms, 10000);
+  }
+}
+
+}  // namespace bwe
+}  // namespace testing
+}  // namespace webrtc
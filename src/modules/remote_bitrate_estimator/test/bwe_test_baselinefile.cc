@@ -13,12 +13,15 @@
 #include <stdio.h>
 
 #include <algorithm>
+#include <fstream>
 #include <memory>
+#include <sstream>
 #include <vector>
 
 #include "modules/remote_bitrate_estimator/test/bwe_test_fileutils.h"
 #include "modules/remote_bitrate_estimator/test/bwe_test_logging.h"
 #include "rtc_base/constructormagic.h"
+#include "rtc_base/json.h"
 #include "test/testsupport/fileutils.h"
 
 namespace webrtc {
@@ -163,6 +166,77 @@ BaseLineFileInterface* BaseLineFileInterface::Create(
   }
   return result.release();
 }
+
+std::string ScenarioBaseLineToJson(const ScenarioBaseLine& baseline) {
+  Json::Value root(Json::objectValue);
+  for (const auto& scenario : baseline) {
+    Json::Value metrics(Json::objectValue);
+    for (const auto& metric : scenario.second)
+      metrics[metric.first] = metric.second;
+    root[scenario.first] = metrics;
+  }
+  Json::StyledWriter writer;
+  return writer.write(root);
+}
+
+bool ScenarioBaseLineFromJson(const std::string& json,
+                              ScenarioBaseLine* baseline) {
+  Json::Reader reader;
+  Json::Value root;
+  if (!reader.parse(json, root) || !root.isObject())
+    return false;
+  baseline->clear();
+  for (const std::string& scenario : root.getMemberNames()) {
+    const Json::Value& metrics = root[scenario];
+    if (!metrics.isObject())
+      return false;
+    for (const std::string& metric : metrics.getMemberNames()) {
+      double value;
+      if (!rtc::GetDoubleFromJson(metrics[metric], &value))
+        return false;
+      (*baseline)[scenario][metric] = value;
+    }
+  }
+  return true;
+}
+
+bool ReadScenarioBaseLine(const std::string& filename,
+                          ScenarioBaseLine* baseline) {
+  std::string filepath = webrtc::test::ResourcePath(
+      std::string(kResourceSubDir) + "/" + filename, "json");
+  std::ifstream file(filepath.c_str());
+  if (!file.good()) {
+    printf("WARNING: Missing baseline file for BWE test: %s\n",
+           filepath.c_str());
+    return false;
+  }
+  std::stringstream contents;
+  contents << file.rdbuf();
+  if (!ScenarioBaseLineFromJson(contents.str(), baseline)) {
+    printf("WARNING: Bad baseline file for BWE test: %s\n", filepath.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool WriteScenarioBaseLine(const std::string& filename,
+                           const ScenarioBaseLine& baseline) {
+  std::string dir_path = webrtc::test::OutputPath() + kResourceSubDir;
+  if (!webrtc::test::CreateDir(dir_path)) {
+    printf("WARNING: Cannot create output dir: %s\n", dir_path.c_str());
+    return false;
+  }
+  std::string filepath = dir_path + "/" + filename + ".json";
+  std::ofstream file(filepath.c_str());
+  file << ScenarioBaseLineToJson(baseline);
+  if (!file.good()) {
+    printf("WARNING: Cannot write output file: %s\n", filepath.c_str());
+    return false;
+  }
+  printf("NOTE: Writing baseline file for BWE test: %s\n", filepath.c_str());
+  return true;
+}
+
 }  // namespace bwe
 }  // namespace testing
 }  // namespace webrtc
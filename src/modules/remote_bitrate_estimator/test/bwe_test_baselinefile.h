@@ -11,7 +11,9 @@
 #ifndef MODULES_REMOTE_BITRATE_ESTIMATOR_TEST_BWE_TEST_BASELINEFILE_H_
 #define MODULES_REMOTE_BITRATE_ESTIMATOR_TEST_BWE_TEST_BASELINEFILE_H_
 
+#include <map>
 #include <string>
+
 #include "modules/include/module_common_types.h"
 
 namespace webrtc {
@@ -38,6 +40,26 @@ class BaseLineFileInterface {
   static BaseLineFileInterface* Create(const std::string& filename,
                                        bool write_updated_file);
 };
+
+// Summary metrics of scenario runs, keyed by scenario name and then by metric
+// name. Stored as JSON, e.g.
+//   { "SendSide/step_down/one_media": { "utilization": 0.93, ... }, ... }
+typedef std::map<std::string, std::map<std::string, double>> ScenarioBaseLine;
+
+std::string ScenarioBaseLineToJson(const ScenarioBaseLine& baseline);
+bool ScenarioBaseLineFromJson(const std::string& json,
+                              ScenarioBaseLine* baseline);
+
+// Reads the baseline |filename|.json from the resources/ directory. Returns
+// false if the file is missing or malformed.
+bool ReadScenarioBaseLine(const std::string& filename,
+                          ScenarioBaseLine* baseline);
+
+// Writes |baseline| to |filename|.json in the out/ directory, from where it can
+// be copied to resources/ to update the baseline.
+bool WriteScenarioBaseLine(const std::string& filename,
+                           const ScenarioBaseLine& baseline);
+
 }  // namespace bwe
 }  // namespace testing
 }  // namespace webrtc
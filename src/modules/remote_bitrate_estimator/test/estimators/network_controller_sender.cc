@@ -0,0 +1,211 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/remote_bitrate_estimator/test/estimators/network_controller_sender.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "modules/congestion_controller/bbr_network_controller.h"
+#include "modules/congestion_controller/goog_cc_network_controller.h"
+#include "modules/pacing/paced_sender.h"
+#include "modules/remote_bitrate_estimator/test/bwe_test_logging.h"
+
+namespace webrtc {
+namespace testing {
+namespace bwe {
+
+namespace {
+
+const int kFeedbackIntervalMs = 50;
+const int64_t kProcessIntervalMs = 25;
+
+std::unique_ptr<NetworkControllerInterface> CreateController(
+    BandwidthEstimatorType estimator,
+    Clock* clock,
+    RtcEventLog* event_log,
+    BitrateController* bitrate_controller) {
+  if (estimator == kBbrControllerEstimator)
+    return std::unique_ptr<NetworkControllerInterface>(
+        new BbrNetworkController());
+  assert(estimator == kGoogCcControllerEstimator);
+  return std::unique_ptr<NetworkControllerInterface>(
+      new GoogCcNetworkController(clock, event_log, bitrate_controller));
+}
+
+}  // namespace
+
+NetworkControllerBweSender::NetworkControllerBweSender(
+    BandwidthEstimatorType estimator,
+    int kbps,
+    BitrateObserver* observer,
+    Clock* clock)
+    : observer_(observer),
+      clock_(clock),
+      bitrate_controller_(
+          BitrateController::CreateBitrateController(clock, &event_log_)),
+      rtcp_observer_(bitrate_controller_->CreateRtcpBandwidthObserver()),
+      controller_(CreateController(estimator,
+                                   clock,
+                                   &event_log_,
+                                   bitrate_controller_.get())),
+      send_time_history_(clock_, 10000),
+      last_process_time_ms_(clock_->TimeInMilliseconds()),
+      pacing_factor_(PacedSender::kDefaultPaceMultiplier),
+      send_queue_full_(false) {
+  assert(kbps >= kMinBitrateKbps);
+  assert(kbps <= kMaxBitrateKbps);
+  TargetRateConstraints constraints;
+  constraints.min_bitrate_bps = 1000 * kMinBitrateKbps;
+  constraints.start_bitrate_bps = 1000 * kbps;
+  constraints.max_bitrate_bps = 1000 * kMaxBitrateKbps;
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  initial_update_ = controller_->OnTargetRateConstraints(constraints, now_ms);
+}
+
+NetworkControllerBweSender::~NetworkControllerBweSender() {}
+
+int NetworkControllerBweSender::GetFeedbackIntervalMs() const {
+  return kFeedbackIntervalMs;
+}
+
+void NetworkControllerBweSender::GiveFeedback(const FeedbackPacket& feedback) {
+  const SendSideBweFeedback& fb =
+      static_cast<const SendSideBweFeedback&>(feedback);
+  if (fb.packet_feedback_vector().empty())
+    return;
+  int64_t now_ms = clock_->TimeInMilliseconds();
+
+  // The receiver only reports received packets; the packets skipped over in
+  // sequence number order were lost.
+  TransportPacketsFeedback report;
+  report.feedback_time_ms = now_ms;
+  size_t num_lost = 0;
+  int64_t highest_seq_num = 0;
+  for (const PacketFeedback& received : fb.packet_feedback_vector()) {
+    int64_t seq_num = seq_num_unwrapper_.Unwrap(received.sequence_number);
+    if (!next_expected_seq_num_)
+      next_expected_seq_num_.emplace(seq_num);
+    for (int64_t lost_seq_num = *next_expected_seq_num_; lost_seq_num < seq_num;
+         ++lost_seq_num) {
+      PacketFeedback lost(PacketFeedback::kNotReceived,
+                          static_cast<uint16_t>(lost_seq_num));
+      if (send_time_history_.GetFeedback(&lost, true))
+        report.packet_feedbacks.push_back(lost);
+      ++num_lost;
+    }
+    next_expected_seq_num_.emplace(
+        std::max(*next_expected_seq_num_, seq_num + 1));
+    highest_seq_num = std::max(highest_seq_num, seq_num);
+    PacketFeedback packet_feedback = received;
+    if (send_time_history_.GetFeedback(&packet_feedback, true))
+      report.packet_feedbacks.push_back(packet_feedback);
+  }
+  for (const PacketFeedback& packet_feedback : report.packet_feedbacks)
+    observer_->OnBytesAcked(packet_feedback.payload_size);
+  report.data_in_flight_bytes = send_time_history_.GetOutstandingBytes(0, 0);
+
+  int64_t rtt_ms = now_ms - feedback.latest_send_time_ms();
+  report.min_feedback_rtt_ms = rtc::Optional<int64_t>(rtt_ms);
+  BWE_TEST_LOGGING_PLOT(1, "RTT", now_ms, rtt_ms);
+
+  size_t num_expected = fb.packet_feedback_vector().size() + num_lost;
+  report_block_.fraction_lost =
+      static_cast<uint8_t>((num_lost << 8) / num_expected);
+  report_block_.packets_lost += num_lost;
+  report_block_.extended_highest_sequence_number =
+      static_cast<uint32_t>(highest_seq_num);
+  ReportBlockList report_blocks;
+  report_blocks.push_back(report_block_);
+  rtcp_observer_->OnReceivedRtcpReceiverReport(report_blocks, rtt_ms, now_ms);
+
+  NetworkControlUpdate update =
+      controller_->OnRoundTripTimeUpdate(rtt_ms, rtt_ms, now_ms);
+  update.Merge(controller_->OnTransportPacketsFeedback(report));
+  ApplyUpdate(update);
+}
+
+void NetworkControllerBweSender::OnPacketsSent(const Packets& packets) {
+  for (Packet* packet : packets) {
+    if (packet->GetPacketType() == Packet::kMedia) {
+      MediaPacket* media_packet = static_cast<MediaPacket*>(packet);
+      PacketFeedback packet_feedback(
+          clock_->TimeInMilliseconds(), media_packet->header().sequenceNumber,
+          media_packet->payload_size(), 0, 0, PacedPacketInfo());
+      send_time_history_.AddAndRemoveOld(packet_feedback);
+      send_time_history_.OnSentPacket(media_packet->header().sequenceNumber,
+                                      media_packet->sender_timestamp_ms());
+    }
+  }
+}
+
+int64_t NetworkControllerBweSender::TimeUntilNextProcess() {
+  return std::max<int64_t>(
+      last_process_time_ms_ + kProcessIntervalMs - clock_->TimeInMilliseconds(),
+      0);
+}
+
+void NetworkControllerBweSender::Process() {
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  last_process_time_ms_ = now_ms;
+  NetworkControlUpdate update = initial_update_;
+  initial_update_ = NetworkControlUpdate();
+  update.Merge(controller_->OnProcessInterval(now_ms));
+  ApplyUpdate(update);
+}
+
+void NetworkControllerBweSender::ApplyUpdate(
+    const NetworkControlUpdate& update) {
+  if (update.pacing_factor)
+    pacing_factor_ = *update.pacing_factor;
+  if (update.congestion_window_bytes)
+    congestion_window_bytes_ = update.congestion_window_bytes;
+  if (update.target_rate)
+    target_rate_ = update.target_rate;
+  if (!target_rate_)
+    return;
+  uint32_t target_bitrate_bps = target_rate_->target_bitrate_bps;
+  if (!congestion_window_bytes_) {
+    if (update.target_rate) {
+      BWE_TEST_LOGGING_PLOT(1, "TargetBitrate_kbps",
+                            clock_->TimeInMilliseconds(),
+                            target_bitrate_bps / 1000);
+      observer_->OnNetworkChanged(target_bitrate_bps,
+                                  target_rate_->fraction_loss,
+                                  target_rate_->rtt_ms);
+    }
+    return;
+  }
+
+  // Like SendSideCongestionController, the encoder is paused while the pacer
+  // queue is too long. The pacer only sends what the window lets through, so
+  // the queue does not drain by itself.
+  uint32_t pacer_bitrate_bps =
+      static_cast<uint32_t>(pacing_factor_ * target_bitrate_bps);
+  bool send_queue_full =
+      observer_->pacer_queue_size_in_bytes() * 8000 /
+          std::max<uint32_t>(pacer_bitrate_bps, 1) >
+      static_cast<size_t>(PacedSender::kMaxQueueLengthMs);
+  if (!update.target_rate && !update.pacing_factor &&
+      !update.congestion_window_bytes && send_queue_full == send_queue_full_) {
+    return;
+  }
+  send_queue_full_ = send_queue_full;
+  uint32_t encoder_bitrate_bps = send_queue_full ? 0 : target_bitrate_bps;
+  BWE_TEST_LOGGING_PLOT(1, "TargetBitrate_kbps", clock_->TimeInMilliseconds(),
+                        encoder_bitrate_bps / 1000);
+  observer_->OnNetworkChanged(encoder_bitrate_bps, pacer_bitrate_bps, false,
+                              clock_->TimeInMicroseconds(),
+                              *congestion_window_bytes_);
+}
+
+}  // namespace bwe
+}  // namespace testing
+}  // namespace webrtc
@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_REMOTE_BITRATE_ESTIMATOR_TEST_ESTIMATORS_NETWORK_CONTROLLER_SENDER_H_
+#define MODULES_REMOTE_BITRATE_ESTIMATOR_TEST_ESTIMATORS_NETWORK_CONTROLLER_SENDER_H_
+
+#include <memory>
+
+#include "api/optional.h"
+#include "logging/rtc_event_log/mock/mock_rtc_event_log.h"
+#include "modules/bitrate_controller/include/bitrate_controller.h"
+#include "modules/congestion_controller/include/network_controller.h"
+#include "modules/remote_bitrate_estimator/include/send_time_history.h"
+#include "modules/remote_bitrate_estimator/test/bwe.h"
+
+namespace webrtc {
+namespace testing {
+namespace bwe {
+
+// Runs a NetworkControllerInterface implementation on the send side feedback
+// of SendSideBweReceiver. The target rate goes to the encoder and, scaled by
+// the pacing factor, to the pacer together with the congestion window. Probe
+// clusters are not supported by the simulated pacer and are dropped.
+class NetworkControllerBweSender : public BweSender {
+ public:
+  // |estimator| is kGoogCcControllerEstimator or kBbrControllerEstimator.
+  NetworkControllerBweSender(BandwidthEstimatorType estimator,
+                             int kbps,
+                             BitrateObserver* observer,
+                             Clock* clock);
+  ~NetworkControllerBweSender() override;
+
+  int GetFeedbackIntervalMs() const override;
+  void GiveFeedback(const FeedbackPacket& feedback) override;
+  void OnPacketsSent(const Packets& packets) override;
+  int64_t TimeUntilNextProcess() override;
+  void Process() override;
+
+ private:
+  void ApplyUpdate(const NetworkControlUpdate& update);
+
+  BitrateObserver* const observer_;
+  Clock* const clock_;
+  ::testing::NiceMock<MockRtcEventLog> event_log_;
+  // The loss based estimate of the GCC controller, fed with receiver reports
+  // built from the feedback.
+  const std::unique_ptr<BitrateController> bitrate_controller_;
+  const std::unique_ptr<RtcpBandwidthObserver> rtcp_observer_;
+  const std::unique_ptr<NetworkControllerInterface> controller_;
+  SendTimeHistory send_time_history_;
+  SequenceNumberUnwrapper seq_num_unwrapper_;
+  rtc::Optional<int64_t> next_expected_seq_num_;
+  RTCPReportBlock report_block_;
+  int64_t last_process_time_ms_;
+  // Applied on the first Process(), as the observer may not be fully
+  // constructed when the sender is.
+  NetworkControlUpdate initial_update_;
+  rtc::Optional<TargetTransferRate> target_rate_;
+  float pacing_factor_;
+  rtc::Optional<size_t> congestion_window_bytes_;
+  bool send_queue_full_;
+
+  RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(NetworkControllerBweSender);
+};
+
+}  // namespace bwe
+}  // namespace testing
+}  // namespace webrtc
+
+#endif  // MODULES_REMOTE_BITRATE_ESTIMATOR_TEST_ESTIMATORS_NETWORK_CONTROLLER_SENDER_H_
@@ -125,6 +125,12 @@ class MetricRecorder {
   void ResumeFlow(int64_t paused_time_ms);  // Plot zero.
   void PlotZero();
 
+  // Metrics over the packets received since start_computing_metrics_ms.
+  int64_t NthDelayPercentile(int n) const;
+  double AverageBitrateKbps(int64_t extra_offset_ms) const;
+  size_t throughput_bytes() const { return sum_throughput_bytes_; }
+  size_t num_packets_received() const { return num_packets_received_; }
+
  private:
   FRIEND_TEST_ALL_PREFIXES(MetricRecorderTest, NoPackets);
   FRIEND_TEST_ALL_PREFIXES(MetricRecorderTest, RegularPackets);
@@ -143,8 +149,6 @@ class MetricRecorder {
 
   void UpdateEstimateError(int64_t new_value);
   double DelayStdDev() const;
-  int64_t NthDelayPercentile(int n) const;
-  double AverageBitrateKbps(int64_t extra_offset_ms) const;
   int64_t RunDurationMs(int64_t extra_offset_ms) const;
 
   enum Metrics {
@@ -24,6 +24,15 @@
 namespace webrtc {
 namespace testing {
 namespace bwe {
+namespace {
+
+// The estimators that limit the data in flight need a pacer that enforces the
+// congestion window.
+bool UsesCongestionWindow(BandwidthEstimatorType estimator) {
+  return estimator == kBbrEstimator || estimator == kBbrControllerEstimator;
+}
+
+}  // namespace
 
 void PacketSender::Pause() {
   running_ = false;
@@ -151,6 +160,14 @@ void VideoSender::OnNetworkChanged(uint32_t target_bitrate_bps,
   RecordBitrate();
 }
 
+void VideoSender::OnNetworkChanged(uint32_t bitrate_for_encoder_bps,
+                                   uint32_t bitrate_for_pacer_bps,
+                                   bool in_probe_rtt,
+                                   int64_t target_set_time,
+                                   uint64_t congestion_window) {
+  OnNetworkChanged(bitrate_for_encoder_bps, 0u, 0u);
+}
+
 uint32_t VideoSender::TargetBitrateKbps() {
   return (source_->bits_per_second() + 500) / 1000;
 }
@@ -160,7 +177,7 @@ PacedVideoSender::PacedVideoSender(PacketProcessorListener* listener,
                                    BandwidthEstimatorType estimator)
     : VideoSender(listener, source, estimator),
       pacer_(
-          estimator == kBbrEstimator
+          UsesCongestionWindow(estimator)
               ? static_cast<Pacer*>(new BbrPacedSender(&clock_, this, nullptr))
               : static_cast<Pacer*>(new PacedSender(&clock_, this, nullptr))) {
   modules_.push_back(pacer_.get());
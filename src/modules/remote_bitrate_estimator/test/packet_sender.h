@@ -81,6 +81,12 @@ class VideoSender : public PacketSender, public BitrateObserver {
   void OnNetworkChanged(uint32_t target_bitrate_bps,
                         uint8_t fraction_lost,
                         int64_t rtt) override;
+  // Without a pacer, only the encoder rate is used.
+  void OnNetworkChanged(uint32_t bitrate_for_encoder_bps,
+                        uint32_t bitrate_for_pacer_bps,
+                        bool in_probe_rtt,
+                        int64_t target_set_time,
+                        uint64_t congestion_window) override;
   void Pause() override;
   void Resume(int64_t paused_time_ms) override;
 
@@ -42,6 +42,27 @@ constexpr int kBaseScaleFactor =
     TransportFeedback::kDeltaScaleFactor * (1 << 8);
 constexpr int64_t kTimeWrapPeriodUs = (1ll << 24) * kBaseScaleFactor;
 
+// Converts the time from |last_timestamp_us| to |timestamp_us| to a receive
+// delta, rounded to the nearest tick. Returns false if it doesn't fit in 16
+// bits.
+bool ToDeltaTicks(int64_t timestamp_us,
+                  int64_t last_timestamp_us,
+                  int16_t* delta_ticks) {
+  constexpr int kDeltaScaleFactor = TransportFeedback::kDeltaScaleFactor;
+  int64_t delta_full = timestamp_us - last_timestamp_us;
+  // Skips the 64 bit modulo in the common case, where it changes nothing.
+  if (delta_full <= -kTimeWrapPeriodUs || delta_full >= kTimeWrapPeriodUs)
+    delta_full %= kTimeWrapPeriodUs;
+  if (delta_full > kTimeWrapPeriodUs / 2)
+    delta_full -= kTimeWrapPeriodUs;
+  delta_full +=
+      delta_full < 0 ? -(kDeltaScaleFactor / 2) : kDeltaScaleFactor / 2;
+  delta_full /= kDeltaScaleFactor;
+
+  *delta_ticks = static_cast<int16_t>(delta_full);
+  return *delta_ticks == delta_full;
+}
+
 //    Message format
 //
 //     0                   1                   2                   3
@@ -81,12 +102,18 @@ class TransportFeedback::LastChunk {
   LastChunk();
 
   bool Empty() const;
+  size_t Size() const;
   void Clear();
   // Return if delta sizes still can be encoded into single chunk with added
   // |delta_size|.
   bool CanAdd(DeltaSize delta_size) const;
   // Add |delta_size|, assumes |CanAdd(delta_size)|,
   void Add(DeltaSize delta_size);
+  // Adds up to |count| |delta_size|s that can be encoded into a single run
+  // length chunk with the stored ones, and returns how many were added. Same
+  // as calling Add() while CanAdd() if the stored delta sizes are all equal to
+  // |delta_size|, otherwise adds none.
+  size_t AddRun(DeltaSize delta_size, size_t count);
 
   // Encode chunk as large as possible removing encoded delta sizes.
   // Assume CanAdd() == false for some valid delta_size.
@@ -98,6 +125,16 @@ class TransportFeedback::LastChunk {
   void Decode(uint16_t chunk, size_t max_size);
   // Appends content of the Lastchunk to |deltas|.
   void AppendTo(std::vector<DeltaSize>* deltas) const;
+  // Counts the received packets and the size of their deltas, and returns
+  // false if there is an invalid delta size.
+  bool CountDeltas(size_t* num_deltas, size_t* num_delta_bytes) const;
+  // Reads the deltas of the stored delta sizes from |buffer| at |*index| and
+  // appends the received packets to |packets|, numbering them from |*seq_no|.
+  // The caller checks that the deltas are within the buffer.
+  void ReadDeltas(const uint8_t* buffer,
+                  size_t* index,
+                  uint16_t* seq_no,
+                  std::vector<ReceivedPacket>* packets) const;
 
  private:
   static constexpr size_t kMaxRunLengthCapacity = 0x1fff;
@@ -133,6 +170,10 @@ bool TransportFeedback::LastChunk::Empty() const {
   return size_ == 0;
 }
 
+size_t TransportFeedback::LastChunk::Size() const {
+  return size_;
+}
+
 void TransportFeedback::LastChunk::Clear() {
   size_ = 0;
   all_same_ = true;
@@ -160,6 +201,19 @@ void TransportFeedback::LastChunk::Add(DeltaSize delta_size) {
   has_large_delta_ = has_large_delta_ || delta_size == kLarge;
 }
 
+size_t TransportFeedback::LastChunk::AddRun(DeltaSize delta_size,
+                                            size_t count) {
+  RTC_DCHECK_LE(delta_size, 2);
+  if (!Empty() && !(all_same_ && delta_sizes_[0] == delta_size))
+    return 0;
+  count = std::min(count, kMaxRunLengthCapacity - size_);
+  for (size_t i = size_; i < std::min(size_ + count, kMaxVectorCapacity); ++i)
+    delta_sizes_[i] = delta_size;
+  size_ += count;
+  has_large_delta_ = has_large_delta_ || delta_size == kLarge;
+  return count;
+}
+
 uint16_t TransportFeedback::LastChunk::Emit() {
   RTC_DCHECK(!CanAdd(0) || !CanAdd(1) || !CanAdd(2));
   if (all_same_) {
@@ -208,6 +262,65 @@ void TransportFeedback::LastChunk::AppendTo(
   }
 }
 
+bool TransportFeedback::LastChunk::CountDeltas(size_t* num_deltas,
+                                               size_t* num_delta_bytes) const {
+  if (all_same_) {
+    if (size_ > 0 && delta_sizes_[0] > kLarge)
+      return false;
+    if (size_ > 0 && delta_sizes_[0] > 0) {
+      *num_deltas += size_;
+      *num_delta_bytes += size_ * delta_sizes_[0];
+    }
+    return true;
+  }
+  for (size_t i = 0; i < size_; ++i) {
+    if (delta_sizes_[i] > kLarge)
+      return false;
+    if (delta_sizes_[i] > 0) {
+      ++*num_deltas;
+      *num_delta_bytes += delta_sizes_[i];
+    }
+  }
+  return true;
+}
+
+void TransportFeedback::LastChunk::ReadDeltas(
+    const uint8_t* buffer,
+    size_t* index,
+    uint16_t* seq_no,
+    std::vector<ReceivedPacket>* packets) const {
+  if (all_same_ && size_ > 0) {
+    // Run length chunk: the deltas have the same size.
+    switch (delta_sizes_[0]) {
+      case 0:
+        break;
+      case 1:
+        for (size_t i = 0; i < size_; ++i)
+          packets->emplace_back(*seq_no + i, buffer[(*index)++]);
+        break;
+      case kLarge:
+        for (size_t i = 0; i < size_; ++i, *index += 2) {
+          int16_t delta = ByteReader<int16_t>::ReadBigEndian(&buffer[*index]);
+          packets->emplace_back(*seq_no + i, delta);
+        }
+        break;
+      default:
+        RTC_NOTREACHED();
+    }
+    *seq_no += size_;
+    return;
+  }
+  for (size_t i = 0; i < size_; ++i, ++*seq_no) {
+    if (delta_sizes_[i] == 1) {
+      packets->emplace_back(*seq_no, buffer[(*index)++]);
+    } else if (delta_sizes_[i] == kLarge) {
+      int16_t delta = ByteReader<int16_t>::ReadBigEndian(&buffer[*index]);
+      packets->emplace_back(*seq_no, delta);
+      *index += 2;
+    }
+  }
+}
+
 void TransportFeedback::LastChunk::Decode(uint16_t chunk, size_t max_size) {
   if ((chunk & 0x8000) == 0) {
     DecodeRunLength(chunk, max_size);
@@ -332,17 +445,9 @@ void TransportFeedback::SetFeedbackSequenceNumber(uint8_t feedback_sequence) {
 
 bool TransportFeedback::AddReceivedPacket(uint16_t sequence_number,
                                           int64_t timestamp_us) {
-  // Convert to ticks and round.
-  int64_t delta_full = (timestamp_us - last_timestamp_us_) % kTimeWrapPeriodUs;
-  if (delta_full > kTimeWrapPeriodUs / 2)
-    delta_full -= kTimeWrapPeriodUs;
-  delta_full +=
-      delta_full < 0 ? -(kDeltaScaleFactor / 2) : kDeltaScaleFactor / 2;
-  delta_full /= kDeltaScaleFactor;
-
-  int16_t delta = static_cast<int16_t>(delta_full);
+  int16_t delta;
   // If larger than 16bit signed, we can't represent it - need new fb packet.
-  if (delta != delta_full) {
+  if (!ToDeltaTicks(timestamp_us, last_timestamp_us_, &delta)) {
     LOG(LS_WARNING) << "Delta value too large ( >= 2^16 ticks )";
     return false;
   }
@@ -367,6 +472,58 @@ bool TransportFeedback::AddReceivedPacket(uint16_t sequence_number,
   return true;
 }
 
+size_t TransportFeedback::AddReceivedPackets(
+    rtc::ArrayView<const uint16_t> sequence_numbers,
+    rtc::ArrayView<const int64_t> timestamps_us) {
+  RTC_DCHECK_EQ(sequence_numbers.size(), timestamps_us.size());
+  const size_t num_packets = sequence_numbers.size();
+  packets_.reserve(packets_.size() + num_packets);
+  size_t i = 0;
+  while (i < num_packets) {
+    int16_t delta;
+    if (!ToDeltaTicks(timestamps_us[i], last_timestamp_us_, &delta)) {
+      LOG(LS_WARNING) << "Delta value too large ( >= 2^16 ticks )";
+      return i;
+    }
+    uint16_t next_seq_no = base_seq_no_ + num_seq_no_;
+    if (sequence_numbers[i] != next_seq_no) {
+      uint16_t last_seq_no = next_seq_no - 1;
+      if (!IsNewerSequenceNumber(sequence_numbers[i], last_seq_no))
+        return i;
+      uint16_t num_missing = sequence_numbers[i] - next_seq_no;
+      if (AddDeltaSizes(0, num_missing) != num_missing)
+        return i;
+    }
+
+    // Collect the run of consecutive packets with deltas of the same size.
+    const DeltaSize delta_size = (delta >= 0 && delta <= 0xff) ? 1 : 2;
+    const size_t run_begin = packets_.size();
+    int64_t timestamp_us = last_timestamp_us_;
+    size_t run_end = i;
+    do {
+      packets_.emplace_back(sequence_numbers[run_end], delta);
+      timestamp_us += delta * kDeltaScaleFactor;
+      if (++run_end == num_packets ||
+          sequence_numbers[run_end] !=
+              static_cast<uint16_t>(sequence_numbers[run_end - 1] + 1) ||
+          !ToDeltaTicks(timestamps_us[run_end], timestamp_us, &delta)) {
+        break;
+      }
+    } while (((delta >= 0 && delta <= 0xff) ? 1 : 2) == delta_size);
+
+    size_t num_added = AddDeltaSizes(delta_size, run_end - i);
+    if (num_added < run_end - i) {
+      packets_.erase(packets_.begin() + run_begin + num_added, packets_.end());
+      for (size_t j = run_begin; j < packets_.size(); ++j)
+        last_timestamp_us_ += packets_[j].delta_us();
+      return i + num_added;
+    }
+    last_timestamp_us_ = timestamp_us;
+    i = run_end;
+  }
+  return num_packets;
+}
+
 const std::vector<TransportFeedback::ReceivedPacket>&
 TransportFeedback::GetReceivedPackets() const {
   return packets_;
@@ -410,9 +567,13 @@ bool TransportFeedback::Parse(const CommonHeader& packet) {
     return false;
   }
 
-  std::vector<uint8_t> delta_sizes;
-  delta_sizes.reserve(status_count);
-  while (delta_sizes.size() < status_count) {
+  // The status chunks are decoded twice: first to find where the receive
+  // deltas end, so that the bounds are checked once, and then to read the
+  // deltas a run or a vector at a time.
+  size_t num_statuses = 0;
+  size_t num_deltas = 0;
+  size_t num_delta_bytes = 0;
+  while (num_statuses < status_count) {
     if (index + kChunkSizeBytes > end_index) {
       LOG(LS_WARNING) << "Buffer overflow while parsing packet.";
       Clear();
@@ -422,48 +583,35 @@ bool TransportFeedback::Parse(const CommonHeader& packet) {
     uint16_t chunk = ByteReader<uint16_t>::ReadBigEndian(&payload[index]);
     index += kChunkSizeBytes;
     encoded_chunks_.push_back(chunk);
-    last_chunk_->Decode(chunk, status_count - delta_sizes.size());
-    last_chunk_->AppendTo(&delta_sizes);
-  }
-  // Last chunk is stored in the |last_chunk_|.
-  encoded_chunks_.pop_back();
-  RTC_DCHECK_EQ(delta_sizes.size(), status_count);
-  num_seq_no_ = status_count;
-
-  uint16_t seq_no = base_seq_no_;
-  for (size_t delta_size : delta_sizes) {
-    if (index + delta_size > end_index) {
-      LOG(LS_WARNING) << "Buffer overflow while parsing packet.";
+    last_chunk_->Decode(chunk, status_count - num_statuses);
+    if (!last_chunk_->CountDeltas(&num_deltas, &num_delta_bytes)) {
+      LOG(LS_WARNING) << "Invalid delta_size in chunk " << chunk;
       Clear();
       return false;
     }
-    switch (delta_size) {
-      case 0:
-        break;
-      case 1: {
-        int16_t delta = payload[index];
-        packets_.emplace_back(seq_no, delta);
-        last_timestamp_us_ += delta * kDeltaScaleFactor;
-        index += delta_size;
-        break;
-      }
-      case 2: {
-        int16_t delta = ByteReader<int16_t>::ReadBigEndian(&payload[index]);
-        packets_.emplace_back(seq_no, delta);
-        last_timestamp_us_ += delta * kDeltaScaleFactor;
-        index += delta_size;
-        break;
-      }
-      case 3:
-        Clear();
-        LOG(LS_WARNING) << "Invalid delta_size for seq_no " << seq_no;
-        return false;
-      default:
-        RTC_NOTREACHED();
-        break;
-    }
-    ++seq_no;
+    num_statuses += last_chunk_->Size();
+  }
+  if (index + num_delta_bytes > end_index) {
+    LOG(LS_WARNING) << "Buffer overflow while parsing packet.";
+    Clear();
+    return false;
+  }
+
+  packets_.reserve(num_deltas);
+  uint16_t seq_no = base_seq_no_;
+  num_statuses = 0;
+  LastChunk chunk_decoder;
+  for (uint16_t chunk : encoded_chunks_) {
+    chunk_decoder.Decode(chunk, status_count - num_statuses);
+    chunk_decoder.ReadDeltas(payload, &index, &seq_no, &packets_);
+    num_statuses += chunk_decoder.Size();
   }
+  for (const ReceivedPacket& received_packet : packets_)
+    last_timestamp_us_ += received_packet.delta_us();
+  // Last chunk is stored in the |last_chunk_|.
+  encoded_chunks_.pop_back();
+  RTC_DCHECK_EQ(num_statuses, status_count);
+  num_seq_no_ = status_count;
   size_bytes_ = RtcpPacket::kHeaderLength + index;
   RTC_DCHECK_LE(index, end_index);
   return true;
@@ -501,7 +649,7 @@ bool TransportFeedback::IsConsistent() const {
                   << num_seq_no_;
     return false;
   }
-  int64_t timestamp_us = base_time_ticks_ * kBaseScaleFactor;
+  int64_t timestamp_us = GetBaseTimeUs();
   auto packet_it = packets_.begin();
   uint16_t seq_no = base_seq_no_;
   for (DeltaSize delta_size : delta_sizes) {
@@ -639,5 +787,34 @@ bool TransportFeedback::AddDeltaSize(DeltaSize delta_size) {
   return true;
 }
 
+size_t TransportFeedback::AddDeltaSizes(DeltaSize delta_size, size_t count) {
+  size_t num_added = 0;
+  while (num_added < count) {
+    // Extend the run in the last chunk as far as the limits allow, which adds
+    // the same as adding the delta sizes one by one.
+    size_t add_chunk_size = last_chunk_->Empty() ? kChunkSizeBytes : 0;
+    size_t max_run = std::min<size_t>(count - num_added,
+                                      kMaxReportedPackets - num_seq_no_);
+    size_t free_bytes = kMaxSizeBytes - size_bytes_;
+    if (free_bytes < add_chunk_size) {
+      max_run = 0;
+    } else if (delta_size > 0) {
+      max_run = std::min(max_run, (free_bytes - add_chunk_size) / delta_size);
+    }
+    size_t run = last_chunk_->AddRun(delta_size, max_run);
+    if (run > 0) {
+      size_bytes_ += add_chunk_size + run * delta_size;
+      num_seq_no_ += run;
+      num_added += run;
+      continue;
+    }
+    if (!AddDeltaSize(delta_size))
+      break;
+    size_bytes_ += delta_size;
+    ++num_added;
+  }
+  return num_added;
+}
+
 }  // namespace rtcp
 }  // namespace webrtc
@@ -14,6 +14,7 @@
 #include <memory>
 #include <vector>
 
+#include "api/array_view.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/rtpfb.h"
 
 namespace webrtc {
@@ -52,6 +53,12 @@ class TransportFeedback : public Rtpfb {
   void SetFeedbackSequenceNumber(uint8_t feedback_sequence);
   // NOTE: This method requires increasing sequence numbers (excepting wraps).
   bool AddReceivedPacket(uint16_t sequence_number, int64_t timestamp_us);
+  // Adds the packets in order, with the same result as calling
+  // AddReceivedPacket() for each, but encodes runs of packets with the same
+  // status at once. Returns the number of packets added, which is less than
+  // the number given if one could not be added.
+  size_t AddReceivedPackets(rtc::ArrayView<const uint16_t> sequence_numbers,
+                            rtc::ArrayView<const int64_t> timestamps_us);
   const std::vector<ReceivedPacket>& GetReceivedPackets() const;
 
   uint16_t GetBaseSequence() const;
@@ -87,6 +94,9 @@ class TransportFeedback : public Rtpfb {
   void Clear();
 
   bool AddDeltaSize(DeltaSize delta_size);
+  // Adds up to |count| packet statuses with the same |delta_size|, including
+  // the size of their deltas, and returns how many were added.
+  size_t AddDeltaSizes(DeltaSize delta_size, size_t count);
 
   uint16_t base_seq_no_;
   uint16_t num_seq_no_;
@@ -22,6 +22,7 @@ extern "C" {
 
 #include "api/video/i420_buffer.h"
 #include "common_video/include/video_frame_buffer.h"
+#include "modules/video_coding/codecs/h264/h264_thread_count.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/keep_ref_until_done.h"
@@ -180,7 +181,9 @@ void H264DecoderImpl::AVFreeBuffer2(void* opaque, uint8_t* data) {
 H264DecoderImpl::H264DecoderImpl() : pool_(true),
                                      decoded_image_callback_(nullptr),
                                      has_reported_init_(false),
-                                     has_reported_error_(false) {
+                                     has_reported_error_(false),
+                                     number_of_cores_(1),
+                                     thread_count_(1) {
 }
 
 H264DecoderImpl::~H264DecoderImpl() {
@@ -229,9 +232,18 @@ int32_t H264DecoderImpl::InitDecode(const VideoCodec* codec_settings,
   av_context_->extradata = nullptr;
   av_context_->extradata_size = 0;
 
-  // If this is ever increased, look at |av_context_->thread_safe_callbacks| and
-  // make it possible to disable the thread checker in the frame buffer pool.
-  av_context_->thread_count = 1;
+  // Only slice threading is used, since frame threading delays the output by a
+  // frame per thread. With slice threading |get_buffer2| is only called on the
+  // decoding thread. If frame threading is ever used, look at
+  // |av_context_->thread_safe_callbacks| and make it possible to disable the
+  // thread checker in the frame buffer pool.
+  number_of_cores_ = number_of_cores;
+  thread_count_ = codec_settings
+                      ? H264NumberOfThreads(codec_settings->width,
+                                            codec_settings->height,
+                                            number_of_cores)
+                      : 1;
+  av_context_->thread_count = thread_count_;
   av_context_->thread_type = FF_THREAD_SLICE;
 
   // Function used by FFmpeg to get buffers to store decoded frames in.
@@ -300,6 +312,22 @@ int32_t H264DecoderImpl::Decode(const EncodedImage& input_image,
     return WEBRTC_VIDEO_CODEC_ERR_PARAMETER;
   }
 
+  // The resolution in the codec settings is often only a placeholder, so the
+  // number of threads is picked again when a keyframe changes it.
+  if (input_image._frameType == kVideoFrameKey &&
+      input_image._encodedWidth > 0 && input_image._encodedHeight > 0 &&
+      H264NumberOfThreads(input_image._encodedWidth,
+                          input_image._encodedHeight,
+                          number_of_cores_) != thread_count_) {
+    VideoCodec codec_settings;
+    codec_settings.codecType = kVideoCodecH264;
+    codec_settings.width = input_image._encodedWidth;
+    codec_settings.height = input_image._encodedHeight;
+    int32_t ret = InitDecode(&codec_settings, number_of_cores_);
+    if (ret != WEBRTC_VIDEO_CODEC_OK)
+      return ret;
+  }
+
   // FFmpeg requires padding due to some optimized bitstream readers reading 32
   // or 64 bits at once and could read over the end. See avcodec_decode_video2.
   RTC_CHECK_GE(input_image._size, input_image._length +
@@ -79,6 +79,10 @@ class H264DecoderImpl : public H264Decoder {
   bool has_reported_init_;
   bool has_reported_error_;
 
+  int number_of_cores_;
+  // The thread count |av_context_| was opened with.
+  int thread_count_;
+
   webrtc::H264BitstreamParser h264_bitstream_parser_;
 };
 
@@ -0,0 +1,23 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ *
+ */
+
+#ifndef MODULES_VIDEO_CODING_CODECS_H264_H264_THREAD_COUNT_H_
+#define MODULES_VIDEO_CODING_CODECS_H264_H264_THREAD_COUNT_H_
+
+namespace webrtc {
+
+// Number of threads for the H.264 encoder or decoder to use, based on the
+// resolution and the number of cores.
+int H264NumberOfThreads(int width, int height, int number_of_cores);
+
+}  // namespace webrtc
+
+#endif  // MODULES_VIDEO_CODING_CODECS_H264_H264_THREAD_COUNT_H_
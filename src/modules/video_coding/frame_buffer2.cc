@@ -75,54 +75,9 @@ FrameBuffer::ReturnReason FrameBuffer::NextFrame(
       if (stopped_)
         return kStopped;
 
-      wait_ms = max_wait_time_ms;
-
-      // Need to hold |crit_| in order to use |frames_|, therefore we
-      // set it here in the loop instead of outside the loop in order to not
-      // acquire the lock unnecesserily.
-      next_frame_it_ = frames_.end();
-
-      // |frame_it| points to the first frame after the
-      // |last_decoded_frame_it_|.
-      auto frame_it = frames_.end();
-      if (last_decoded_frame_it_ == frames_.end()) {
-        frame_it = frames_.begin();
-      } else {
-        frame_it = last_decoded_frame_it_;
-        ++frame_it;
-      }
-
-      // |continuous_end_it| points to the first frame after the
-      // |last_continuous_frame_it_|.
-      auto continuous_end_it = last_continuous_frame_it_;
-      if (continuous_end_it != frames_.end())
-        ++continuous_end_it;
-
-      for (; frame_it != continuous_end_it && frame_it != frames_.end();
-           ++frame_it) {
-        if (!frame_it->second.continuous ||
-            frame_it->second.num_missing_decodable > 0) {
-          continue;
-        }
-
-        FrameObject* frame = frame_it->second.frame.get();
-
-        if (keyframe_required && !frame->is_keyframe())
-          continue;
-
-        next_frame_it_ = frame_it;
-        if (frame->RenderTime() == -1)
-          frame->SetRenderTime(timing_->RenderTimeMs(frame->timestamp, now_ms));
-        wait_ms = timing_->MaxWaitingTime(frame->RenderTime(), now_ms);
-
-        // This will cause the frame buffer to prefer high framerate rather
-        // than high resolution in the case of the decoder not decoding fast
-        // enough and the stream has multiple spatial and temporal layers.
-        if (wait_ms == 0)
-          continue;
-
-        break;
-      }
+      wait_ms = FindNextFrame(now_ms, keyframe_required);
+      if (wait_ms == -1)
+        wait_ms = max_wait_time_ms;
     }  // rtc::Critscope lock(&crit_);
 
     wait_ms = std::min<int64_t>(wait_ms, latest_return_time_ms - now_ms);
@@ -132,63 +87,8 @@ FrameBuffer::ReturnReason FrameBuffer::NextFrame(
   {
     rtc::CritScope lock(&crit_);
     now_ms = clock_->TimeInMilliseconds();
-    if (next_frame_it_ != frames_.end()) {
-      std::unique_ptr<FrameObject> frame =
-          std::move(next_frame_it_->second.frame);
-
-      if (!frame->delayed_by_retransmission()) {
-        int64_t frame_delay;
-
-        if (inter_frame_delay_.CalculateDelay(frame->timestamp, &frame_delay,
-                                              frame->ReceivedTime())) {
-          jitter_estimator_->UpdateEstimate(frame_delay, frame->size());
-        }
-
-        float rtt_mult = protection_mode_ == kProtectionNackFEC ? 0.0 : 1.0;
-        timing_->SetJitterDelay(jitter_estimator_->GetJitterEstimate(rtt_mult));
-        timing_->UpdateCurrentDelay(frame->RenderTime(), now_ms);
-      }
-
-      // Gracefully handle bad RTP timestamps and render time issues.
-      if (HasBadRenderTiming(*frame, now_ms)) {
-        jitter_estimator_->Reset();
-        timing_->Reset();
-        frame->SetRenderTime(timing_->RenderTimeMs(frame->timestamp, now_ms));
-      }
-
-      UpdateJitterDelay();
-      UpdateTimingFrameInfo();
-      PropagateDecodability(next_frame_it_->second);
-
-      // Sanity check for RTP timestamp monotonicity.
-      if (last_decoded_frame_it_ != frames_.end()) {
-        const FrameKey& last_decoded_frame_key = last_decoded_frame_it_->first;
-        const FrameKey& frame_key = next_frame_it_->first;
-
-        const bool frame_is_higher_spatial_layer_of_last_decoded_frame =
-            last_decoded_frame_timestamp_ == frame->timestamp &&
-            last_decoded_frame_key.picture_id == frame_key.picture_id &&
-            last_decoded_frame_key.spatial_layer < frame_key.spatial_layer;
-
-        if (AheadOrAt(last_decoded_frame_timestamp_, frame->timestamp) &&
-            !frame_is_higher_spatial_layer_of_last_decoded_frame) {
-          // TODO(brandtr): Consider clearing the entire buffer when we hit
-          // these conditions.
-          LOG(LS_WARNING) << "Frame with (timestamp:picture_id:spatial_id) ("
-                          << frame->timestamp << ":" << frame->picture_id << ":"
-                          << static_cast<int>(frame->spatial_layer) << ")"
-                          << " sent to decoder after frame with"
-                          << " (timestamp:picture_id:spatial_id) ("
-                          << last_decoded_frame_timestamp_ << ":"
-                          << last_decoded_frame_key.picture_id << ":"
-                          << static_cast<int>(
-                                 last_decoded_frame_key.spatial_layer)
-                          << ").";
-        }
-      }
-
-      AdvanceLastDecodedFrame(next_frame_it_);
-      last_decoded_frame_timestamp_ = frame->timestamp;
+    std::unique_ptr<FrameObject> frame = GetNextFrame(now_ms);
+    if (frame) {
       *frame_out = std::move(frame);
       return kFrameFound;
     }
@@ -205,6 +105,136 @@ FrameBuffer::ReturnReason FrameBuffer::NextFrame(
   return kTimeout;
 }
 
+FrameBuffer::ReturnReason FrameBuffer::PollNextFrame(
+    std::unique_ptr<FrameObject>* frame_out,
+    int64_t* wait_ms_out,
+    bool keyframe_required) {
+  TRACE_EVENT0("webrtc", "FrameBuffer::PollNextFrame");
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  rtc::CritScope lock(&crit_);
+  if (stopped_)
+    return kStopped;
+
+  *wait_ms_out = FindNextFrame(now_ms, keyframe_required);
+  if (*wait_ms_out != 0)
+    return kTimeout;
+
+  *frame_out = GetNextFrame(now_ms);
+  RTC_DCHECK(*frame_out);
+  return kFrameFound;
+}
+
+int64_t FrameBuffer::FindNextFrame(int64_t now_ms, bool keyframe_required) {
+  int64_t wait_ms = -1;
+  next_frame_it_ = frames_.end();
+
+  // |frame_it| points to the first frame after the
+  // |last_decoded_frame_it_|.
+  auto frame_it = frames_.end();
+  if (last_decoded_frame_it_ == frames_.end()) {
+    frame_it = frames_.begin();
+  } else {
+    frame_it = last_decoded_frame_it_;
+    ++frame_it;
+  }
+
+  // |continuous_end_it| points to the first frame after the
+  // |last_continuous_frame_it_|.
+  auto continuous_end_it = last_continuous_frame_it_;
+  if (continuous_end_it != frames_.end())
+    ++continuous_end_it;
+
+  for (; frame_it != continuous_end_it && frame_it != frames_.end();
+       ++frame_it) {
+    if (!frame_it->second.continuous ||
+        frame_it->second.num_missing_decodable > 0) {
+      continue;
+    }
+
+    FrameObject* frame = frame_it->second.frame.get();
+
+    if (keyframe_required && !frame->is_keyframe())
+      continue;
+
+    next_frame_it_ = frame_it;
+    if (frame->RenderTime() == -1)
+      frame->SetRenderTime(timing_->RenderTimeMs(frame->timestamp, now_ms));
+    wait_ms = timing_->MaxWaitingTime(frame->RenderTime(), now_ms);
+
+    // This will cause the frame buffer to prefer high framerate rather
+    // than high resolution in the case of the decoder not decoding fast
+    // enough and the stream has multiple spatial and temporal layers.
+    if (wait_ms == 0)
+      continue;
+
+    break;
+  }
+  return wait_ms;
+}
+
+std::unique_ptr<FrameObject> FrameBuffer::GetNextFrame(int64_t now_ms) {
+  if (next_frame_it_ == frames_.end())
+    return nullptr;
+
+  std::unique_ptr<FrameObject> frame = std::move(next_frame_it_->second.frame);
+
+  if (!frame->delayed_by_retransmission()) {
+    int64_t frame_delay;
+
+    if (inter_frame_delay_.CalculateDelay(frame->timestamp, &frame_delay,
+                                          frame->ReceivedTime())) {
+      jitter_estimator_->UpdateEstimate(frame_delay, frame->size());
+    }
+
+    float rtt_mult = protection_mode_ == kProtectionNackFEC ? 0.0 : 1.0;
+    timing_->SetJitterDelay(jitter_estimator_->GetJitterEstimate(rtt_mult));
+    timing_->UpdateCurrentDelay(frame->RenderTime(), now_ms);
+  }
+
+  // Gracefully handle bad RTP timestamps and render time issues.
+  if (HasBadRenderTiming(*frame, now_ms)) {
+    jitter_estimator_->Reset();
+    timing_->Reset();
+    frame->SetRenderTime(timing_->RenderTimeMs(frame->timestamp, now_ms));
+  }
+
+  UpdateJitterDelay();
+  UpdateTimingFrameInfo();
+  PropagateDecodability(next_frame_it_->second);
+
+  // Sanity check for RTP timestamp monotonicity.
+  if (last_decoded_frame_it_ != frames_.end()) {
+    const FrameKey& last_decoded_frame_key = last_decoded_frame_it_->first;
+    const FrameKey& frame_key = next_frame_it_->first;
+
+    const bool frame_is_higher_spatial_layer_of_last_decoded_frame =
+        last_decoded_frame_timestamp_ == frame->timestamp &&
+        last_decoded_frame_key.picture_id == frame_key.picture_id &&
+        last_decoded_frame_key.spatial_layer < frame_key.spatial_layer;
+
+    if (AheadOrAt(last_decoded_frame_timestamp_, frame->timestamp) &&
+        !frame_is_higher_spatial_layer_of_last_decoded_frame) {
+      // TODO(brandtr): Consider clearing the entire buffer when we hit
+      // these conditions.
+      LOG(LS_WARNING) << "Frame with (timestamp:picture_id:spatial_id) ("
+                      << frame->timestamp << ":" << frame->picture_id << ":"
+                      << static_cast<int>(frame->spatial_layer) << ")"
+                      << " sent to decoder after frame with"
+                      << " (timestamp:picture_id:spatial_id) ("
+                      << last_decoded_frame_timestamp_ << ":"
+                      << last_decoded_frame_key.picture_id << ":"
+                      << static_cast<int>(last_decoded_frame_key.spatial_layer)
+                      << ").";
+    }
+  }
+
+  AdvanceLastDecodedFrame(next_frame_it_);
+  last_decoded_frame_timestamp_ = frame->timestamp;
+  if (stats_callback_)
+    stats_callback_->OnFramesBufferedUpdated(num_frames_buffered_);
+  return frame;
+}
+
 bool FrameBuffer::HasBadRenderTiming(const FrameObject& frame, int64_t now_ms) {
   // Assume that render timing errors are due to changes in the video stream.
   int64_t render_time_ms = frame.RenderTimeMs();
@@ -357,6 +387,8 @@ int FrameBuffer::InsertFrame(std::unique_ptr<FrameObject> frame) {
   UpdatePlayoutDelays(*frame);
   info->second.frame = std::move(frame);
   ++num_frames_buffered_;
+  if (stats_callback_)
+    stats_callback_->OnFramesBufferedUpdated(num_frames_buffered_);
 
   if (info->second.num_missing_continuous == 0) {
     info->second.continuous = true;
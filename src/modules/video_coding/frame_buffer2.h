@@ -60,6 +60,19 @@ class FrameBuffer {
                          std::unique_ptr<FrameObject>* frame_out,
                          bool keyframe_required = false);
 
+  // Non-blocking version of NextFrame(), for decoding many streams on a shared
+  // pool of threads.
+  //  - If a frame is due for decoding it will return kFrameFound and set
+  //    |frame_out| to the resulting frame.
+  //  - Otherwise it will return kTimeout and set |wait_ms_out| to the time
+  //    until the next frame is due, or to -1 if there is no decodable frame.
+  //    Calling NextFrame(0, ...) returns the frame without waiting for it to
+  //    be due, which is what NextFrame() does when it times out.
+  //  - If the FrameBuffer is stopped then it will return kStopped.
+  ReturnReason PollNextFrame(std::unique_ptr<FrameObject>* frame_out,
+                             int64_t* wait_ms_out,
+                             bool keyframe_required = false);
+
   // Tells the FrameBuffer which protection mode that is in use. Affects
   // the frame timing.
   // TODO(philipel): Remove this when new timing calculations has been
@@ -123,6 +136,16 @@ class FrameBuffer {
 
   using FrameMap = std::map<FrameKey, FrameInfo>;
 
+  // Sets |next_frame_it_| to the frame to decode next and returns the time
+  // until it is due for decoding, or returns -1 if there is no decodable frame.
+  int64_t FindNextFrame(int64_t now_ms, bool keyframe_required)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  // Hands off the frame found by FindNextFrame() for decoding, or returns null
+  // if there is none.
+  std::unique_ptr<FrameObject> GetNextFrame(int64_t now_ms)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
   // Check that the references of |frame| are valid.
   bool ValidReferences(const FrameObject& frame) const;
 
@@ -119,6 +119,7 @@ class VCMReceiveStatisticsCallbackMock : public VCMReceiveStatisticsCallback {
                     int jitter_buffer_ms,
                     int min_playout_delay_ms,
                     int render_delay_ms));
+  MOCK_METHOD1(OnFramesBufferedUpdated, void(int frames_buffered));
   MOCK_METHOD1(OnTimingFrameInfoUpdated, void(const TimingFrameInfo& info));
 };
 
@@ -496,6 +497,8 @@ TEST_F(TestFrameBuffer2, StatsCallback) {
               OnCompleteFrame(true, kFrameSize, VideoContentType::UNSPECIFIED));
   EXPECT_CALL(stats_callback_,
               OnFrameBufferTimingsUpdated(_, _, _, _, _, _, _));
+  EXPECT_CALL(stats_callback_, OnFramesBufferedUpdated(1));
+  EXPECT_CALL(stats_callback_, OnFramesBufferedUpdated(0));
 
   {
     std::unique_ptr<FrameObjectFake> frame(new FrameObjectFake());
@@ -546,6 +549,34 @@ TEST_F(TestFrameBuffer2, InvalidReferences) {
   EXPECT_EQ(2, InsertFrame(2, 0, 3000, false, 1));
 }
 
+TEST_F(TestFrameBuffer2, PollNextFrame) {
+  uint16_t pid = Rand();
+  uint32_t ts = Rand();
+  std::unique_ptr<FrameObject> frame;
+  int64_t wait_ms = 0;
+
+  EXPECT_EQ(FrameBuffer::ReturnReason::kTimeout,
+            buffer_.PollNextFrame(&frame, &wait_ms));
+  EXPECT_EQ(-1, wait_ms);
+
+  // The frame is not handed off until it is due for decoding.
+  InsertFrame(pid, 0, ts, false);
+  EXPECT_EQ(FrameBuffer::ReturnReason::kTimeout,
+            buffer_.PollNextFrame(&frame, &wait_ms));
+  EXPECT_FALSE(frame);
+  EXPECT_GT(wait_ms, 0);
+
+  clock_.AdvanceTimeMilliseconds(wait_ms);
+  EXPECT_EQ(FrameBuffer::ReturnReason::kFrameFound,
+            buffer_.PollNextFrame(&frame, &wait_ms));
+  ASSERT_TRUE(frame);
+  EXPECT_EQ(pid, frame->picture_id);
+
+  buffer_.Stop();
+  EXPECT_EQ(FrameBuffer::ReturnReason::kStopped,
+            buffer_.PollNextFrame(&frame, &wait_ms));
+}
+
 TEST_F(TestFrameBuffer2, KeyframeRequired) {
   EXPECT_EQ(1, InsertFrame(1, 0, 1000, false));
   EXPECT_EQ(2, InsertFrame(2, 0, 2000, false, 1));
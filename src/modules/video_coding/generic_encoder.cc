@@ -303,8 +303,11 @@ EncodedImageCallback::Result VCMEncodedFrameCallback::OnEncodedImage(
   // drift relative to rtc::TimeMillis(). We can't use it for Timing frames,
   // because to being sent in the network capture time required to be less than
   // all the other timestamps.
-  if (timing_flags != TimingFrameFlags::kInvalid && encode_start_ms) {
+  // Encode times are recorded on every frame for the send side latency stats,
+  // but only frames with valid timing flags carry them on the wire.
+  if (encode_start_ms)
     encoded_image.SetEncodeTime(*encode_start_ms, rtc::TimeMillis());
+  if (timing_flags != TimingFrameFlags::kInvalid && encode_start_ms) {
     encoded_image.timing_.flags = timing_flags;
   } else {
     encoded_image.timing_.flags = TimingFrameFlags::kInvalid;
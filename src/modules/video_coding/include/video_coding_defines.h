@@ -110,6 +110,9 @@ class VCMReceiveStatisticsCallback {
                                            int min_playout_delay_ms,
                                            int render_delay_ms) = 0;
 
+  // Number of frames waiting in the jitter buffer to be decoded.
+  virtual void OnFramesBufferedUpdated(int frames_buffered) = 0;
+
   virtual void OnTimingFrameInfoUpdated(const TimingFrameInfo& info) = 0;
 
  protected:
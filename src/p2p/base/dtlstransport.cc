@@ -371,6 +371,14 @@ int DtlsTransport::SendPacket(const char* data,
   }
 }
 
+rtc::PacketTransportInternal* DtlsTransport::srtp_bypass_transport() {
+  if (!dtls_active_ || dtls_state() != DTLS_TRANSPORT_CONNECTED ||
+      srtp_ciphers_.empty()) {
+    return nullptr;
+  }
+  return ice_transport_;
+}
+
 bool DtlsTransport::IsDtlsConnected() {
   return dtls_ && dtls_->IsTlsConnected();
 }
@@ -658,6 +666,7 @@ void DtlsTransport::set_dtls_state(DtlsTransportState state) {
                           << state;
   dtls_state_ = state;
   SignalDtlsState(this, state);
+  SignalSrtpBypassTransportChanged(this);
 }
 
 void DtlsTransport::OnDtlsHandshakeError(rtc::SSLHandshakeError error) {
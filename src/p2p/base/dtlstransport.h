@@ -121,6 +121,10 @@ class DtlsTransport : public DtlsTransportInternal {
                  const rtc::PacketOptions& options,
                  int flags) override;
 
+  // Once DTLS-SRTP is connected, SRTP packets are written directly to the
+  // underlying ICE transport, which is returned here.
+  rtc::PacketTransportInternal* srtp_bypass_transport() override;
+
   bool GetOption(rtc::Socket::Option opt, int* value) override {
     return ice_transport_->GetOption(opt, value);
   }
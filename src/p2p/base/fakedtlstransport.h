@@ -94,6 +94,7 @@ class FakeDtlsTransport : public DtlsTransportInternal {
       dtls_state_ = DTLS_TRANSPORT_CONNECTED;
       ice_transport_->SetDestination(
           static_cast<FakeIceTransport*>(dest->ice_transport()), asymmetric);
+      SignalSrtpBypassTransportChanged(this);
     } else {
       // Simulates loss of connectivity, by asymmetrically forgetting dest_.
       dest_ = nullptr;
@@ -193,6 +194,11 @@ class FakeDtlsTransport : public DtlsTransportInternal {
     }
     return ice_transport_->SendPacket(data, len, options, flags);
   }
+  PacketTransportInternal* srtp_bypass_transport() override {
+    return (do_dtls_ && dtls_state_ == DTLS_TRANSPORT_CONNECTED)
+               ? ice_transport_
+               : nullptr;
+  }
   int SetOption(rtc::Socket::Option opt, int value) override {
     return ice_transport_->SetOption(opt, value);
   }
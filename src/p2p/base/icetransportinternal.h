@@ -101,6 +101,11 @@ class IceTransportInternal : public rtc::PacketTransportInternal {
   // Returns the current stats for this connection.
   virtual bool GetStats(ConnectionInfos* infos) = 0;
 
+  // Returns the candidate gathering times of the most recent gathering.
+  virtual CandidateGatheringTimes GetCandidateGatheringTimes() const {
+    return CandidateGatheringTimes();
+  }
+
   // Returns RTT estimate over the currently active connection, or an empty
   // rtc::Optional if there is none.
   virtual rtc::Optional<int> GetRttEstimate() = 0;
@@ -292,6 +292,8 @@ bool JsepTransport::GetStats(TransportStats* stats) {
     dtls_transport->GetSrtpCryptoSuite(&substats.srtp_crypto_suite);
     dtls_transport->GetSslCipherSuite(&substats.ssl_cipher_suite);
     substats.dtls_state = dtls_transport->dtls_state();
+    substats.gathering_times =
+        dtls_transport->ice_transport()->GetCandidateGatheringTimes();
     if (!dtls_transport->ice_transport()->GetStats(
             &substats.connection_infos)) {
       return false;
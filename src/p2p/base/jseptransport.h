@@ -124,6 +124,18 @@ struct ConnectionInfo {
 // Information about all the connections of a channel.
 typedef std::vector<ConnectionInfo> ConnectionInfos;
 
+// Times of the milestones of candidate gathering, in milliseconds since
+// StartGettingPorts() was called. A value of -1 means the milestone has not
+// been reached yet. The phase times are those of the first allocation
+// sequence to enter the phase.
+struct CandidateGatheringTimes {
+  int64_t udp_phase_ms = -1;
+  int64_t relay_phase_ms = -1;
+  int64_t tcp_phase_ms = -1;
+  int64_t first_candidate_ms = -1;
+  int64_t done_ms = -1;
+};
+
 // Information about a specific channel
 struct TransportChannelStats {
   int component = 0;
@@ -131,6 +143,7 @@ struct TransportChannelStats {
   int srtp_crypto_suite = rtc::SRTP_INVALID_CRYPTO_SUITE;
   int ssl_cipher_suite = rtc::TLS_NULL_WITH_NULL_NULL;
   DtlsTransportState dtls_state = DTLS_TRANSPORT_NEW;
+  CandidateGatheringTimes gathering_times;
 };
 
 // Information about all the channels of a transport.
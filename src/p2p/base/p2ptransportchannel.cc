@@ -279,6 +279,15 @@ IceTransportState P2PTransportChannel::GetState() const {
   return state_;
 }
 
+CandidateGatheringTimes P2PTransportChannel::GetCandidateGatheringTimes()
+    const {
+  RTC_DCHECK(network_thread_ == rtc::Thread::Current());
+  if (allocator_sessions_.empty()) {
+    return CandidateGatheringTimes();
+  }
+  return allocator_sessions_.back()->gathering_times();
+}
+
 rtc::Optional<int> P2PTransportChannel::GetRttEstimate() {
   if (selected_connection_ != nullptr
       && selected_connection_->rtt_samples() > 0) {
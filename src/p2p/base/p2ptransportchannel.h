@@ -109,6 +109,7 @@ class P2PTransportChannel : public IceTransportInternal,
   bool GetOption(rtc::Socket::Option opt, int* value) override;
   int GetError() override { return error_; }
   bool GetStats(std::vector<ConnectionInfo>* stats) override;
+  CandidateGatheringTimes GetCandidateGatheringTimes() const override;
   rtc::Optional<int> GetRttEstimate() override;
 
   // TODO(honghaiz): Remove this method once the reference of it in
@@ -66,6 +66,14 @@ class PacketTransportInternal : public virtual webrtc::PacketTransportInterface,
   // Returns the most recent error that occurred on this channel.
   virtual int GetError() = 0;
 
+  // Returns the transport that packets flagged with PF_SRTP_BYPASS are
+  // ultimately written to, or null if there is no shorter send path than
+  // SendPacket() on this object. The result stays valid until
+  // SignalSrtpBypassTransportChanged is emitted, so callers on the network
+  // thread may cache it and hand already protected SRTP packets straight to
+  // it, skipping the intermediate layers.
+  virtual PacketTransportInternal* srtp_bypass_transport() { return nullptr; }
+
   // Emitted when the writable state, represented by |writable()|, changes.
   sigslot::signal1<PacketTransportInternal*> SignalWritableState;
 
@@ -91,6 +99,9 @@ class PacketTransportInternal : public virtual webrtc::PacketTransportInterface,
   sigslot::signal2<PacketTransportInternal*, const rtc::SentPacket&>
       SignalSentPacket;
 
+  // Emitted when the result of |srtp_bypass_transport()| may have changed.
+  sigslot::signal1<PacketTransportInternal*> SignalSrtpBypassTransportChanged;
+
  protected:
   PacketTransportInternal* GetInternal() override { return this; }
 };
@@ -86,6 +86,13 @@ enum {
   // the application to work in a wider variety of environments, at the expense
   // of having to allocate additional candidates.
   PORTALLOCATOR_ENABLE_ANY_ADDRESS_PORTS = 0x8000,
+
+  // When specified, the UDP/STUN, relay and TCP ports for a network are all
+  // created in the first allocation step instead of being spaced
+  // |step_delay| apart, so their candidates are gathered concurrently. This
+  // shortens the time to gather all candidates on hosts with many interfaces
+  // or servers, at the expense of a burst of STUN/TURN requests at start.
+  PORTALLOCATOR_ENABLE_PARALLEL_PHASES = 0x10000,
 };
 
 // Defines various reasons that have caused ICE regathering.
@@ -263,6 +270,11 @@ class PortAllocatorSession : public sigslot::has_slots<> {
   // Marks all ports in the current session as "pruned" so that they may be
   // destroyed if no connection is using them.
   virtual void PruneAllPorts() {}
+  // Returns when the milestones of candidate gathering were reached, if the
+  // implementation keeps track of them.
+  virtual CandidateGatheringTimes gathering_times() const {
+    return CandidateGatheringTimes();
+  }
 
   sigslot::signal2<PortAllocatorSession*, PortInterface*> SignalPortReady;
   // Fires this signal when the network of the ports failed (either because the
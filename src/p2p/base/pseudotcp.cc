@@ -116,6 +116,8 @@ const uint32_t DEF_ACK_DELAY = 100;  // 100 milliseconds
 
 const uint8_t FLAG_CTL = 0x02;
 const uint8_t FLAG_RST = 0x04;
+// Set on pure ACKs whose payload holds SACK blocks rather than data.
+const uint8_t FLAG_SACK = 0x08;
 
 const uint8_t CTL_CONNECT = 0;
 
@@ -124,6 +126,10 @@ const uint8_t TCP_OPT_EOL = 0;        // End of list.
 const uint8_t TCP_OPT_NOOP = 1;       // No-op.
 const uint8_t TCP_OPT_MSS = 2;        // Maximum segment size.
 const uint8_t TCP_OPT_WND_SCALE = 3;  // Window scale factor.
+const uint8_t TCP_OPT_SACK_PERMITTED = 4;  // Selective acknowledgements.
+
+// A SACK block is a [start, end) pair of sequence numbers (RFC 2018).
+const uint32_t SACK_BLOCK_SIZE = 8;
 
 const long DEFAULT_TIMEOUT = 4000; // If there are no pending clocks, wake up every 4 seconds
 const long CLOSED_TIMEOUT = 60 * 1000; // If the connection is closed, once per minute
@@ -254,6 +260,9 @@ PseudoTcp::PseudoTcp(IPseudoTcpNotify* notify, uint32_t conv)
   m_use_nagling = true;
   m_ack_delay = DEF_ACK_DELAY;
   m_support_wnd_scale = true;
+  m_support_sack = true;
+  m_sack_enabled = false;
+  m_sack_high = m_sack_rexmit = 0;
 }
 
 PseudoTcp::~PseudoTcp() {
@@ -309,6 +318,13 @@ void PseudoTcp::NotifyClock(uint32_t now) {
       //LOG(LS_INFO) << "m_ssthresh: " << m_ssthresh << "  nInFlight: " << nInFlight << "  m_mss: " << m_mss;
       m_cwnd = m_mss;
 
+      // The receiver may have discarded out-of-order data, so forget what it
+      // has selectively acknowledged (RFC 2018, section 8).
+      for (SSegment& sseg : m_slist) {
+        sseg.bSacked = false;
+      }
+      m_sack_high = m_sack_rexmit = m_snd_una;
+
       // Back off retransmit timer.  Note: the limit is lower when connecting.
       uint32_t rto_limit = (m_state < TCP_ESTABLISHED) ? DEF_RTO : MAX_RTO;
       m_rx_rto = std::min(rto_limit, m_rx_rto * 2);
@@ -522,7 +538,6 @@ IPseudoTcpNotify::WriteResult PseudoTcp::packet(uint32_t seq,
   long_to_bytes(seq, buffer.get() + 4);
   long_to_bytes(m_rcv_nxt, buffer.get() + 8);
   buffer[12] = 0;
-  buffer[13] = flags;
   short_to_bytes(static_cast<uint16_t>(m_rcv_wnd >> m_rwnd_scale),
                  buffer.get() + 14);
 
@@ -531,13 +546,21 @@ IPseudoTcpNotify::WriteResult PseudoTcp::packet(uint32_t seq,
   long_to_bytes(m_ts_recent, buffer.get() + 20);
   m_ts_lastack = m_rcv_nxt;
 
+  uint32_t sack_len = 0;
   if (len) {
     size_t bytes_read = 0;
     rtc::StreamResult result = m_sbuf.ReadOffset(
         buffer.get() + HEADER_SIZE, len, offset, &bytes_read);
     RTC_DCHECK(result == rtc::SR_SUCCESS);
     RTC_DCHECK(static_cast<uint32_t>(bytes_read) == len);
+  } else if (m_sack_enabled && !(flags & FLAG_CTL) && !m_rlist.empty()) {
+    // Tell the sender which out-of-order data we already hold.
+    sack_len = writeSackBlocks(buffer.get() + HEADER_SIZE);
+    if (sack_len) {
+      flags |= FLAG_SACK;
+    }
   }
+  buffer[13] = flags;
 
 #if _DEBUGMSG >= _DBG_VERBOSE
   LOG(LS_INFO) << "<-- <CONV=" << m_conv
@@ -551,7 +574,8 @@ IPseudoTcpNotify::WriteResult PseudoTcp::packet(uint32_t seq,
 #endif // _DEBUGMSG
 
   IPseudoTcpNotify::WriteResult wres = m_notify->TcpWritePacket(
-      this, reinterpret_cast<char *>(buffer.get()), len + HEADER_SIZE);
+      this, reinterpret_cast<char *>(buffer.get()),
+      len + sack_len + HEADER_SIZE);
   // Note: When len is 0, this is an ACK packet.  We don't read the return value for those,
   // and thus we won't retry.  So go ahead and treat the packet as a success (basically simulate
   // as if it were dropped), which will prevent our timers from being messed up.
@@ -585,6 +609,19 @@ bool PseudoTcp::parse(const uint8_t* buffer, uint32_t size) {
   seg.data = reinterpret_cast<const char *>(buffer) + HEADER_SIZE;
   seg.len = size - HEADER_SIZE;
 
+  seg.sack_count = 0;
+  if (seg.flags & FLAG_SACK) {
+    // The payload of a SACK segment is not data.
+    for (uint32_t offset = 0; (offset + SACK_BLOCK_SIZE <= seg.len) &&
+                              (seg.sack_count < kMaxSackBlocks);
+         offset += SACK_BLOCK_SIZE) {
+      SackBlock& block = seg.sack[seg.sack_count++];
+      block.start = bytes_to_long(seg.data + offset);
+      block.end = bytes_to_long(seg.data + offset + 4);
+    }
+    seg.len = 0;
+  }
+
 #if _DEBUGMSG >= _DBG_VERBOSE
   LOG(LS_INFO) << "--> <CONV=" << seg.conv
                << "><FLG=" << static_cast<unsigned>(seg.flags)
@@ -705,6 +742,10 @@ bool PseudoTcp::process(Segment& seg) {
     m_ts_recent = seg.tsval;
   }
 
+  if (m_sack_enabled && seg.sack_count) {
+    applySackBlocks(seg);
+  }
+
   // Check if this is a valuable ack
   if ((seg.ack > m_snd_una) && (seg.ack <= m_snd_nxt)) {
     // Calculate round-trip time
@@ -746,6 +787,7 @@ bool PseudoTcp::process(Segment& seg) {
     for (uint32_t nFree = nAcked; nFree > 0;) {
       RTC_DCHECK(!m_slist.empty());
       if (nFree < m_slist.front().len) {
+        m_slist.front().seq += nFree;
         m_slist.front().len -= nFree;
         nFree = 0;
       } else {
@@ -766,12 +808,22 @@ bool PseudoTcp::process(Segment& seg) {
 #endif // _DEBUGMSG
         m_dup_acks = 0;
       } else {
+        if (m_sack_enabled && (m_slist.front().seq < m_sack_rexmit)) {
+          // The next hole was already retransmitted on a duplicate ACK, so
+          // repair the one after it instead.
+          if (!retransmitSackHole(now)) {
+            closedown(ECONNABORTED);
+            return false;
+          }
+        } else {
 #if _DEBUGMSG >= _DBG_NORMAL
-        LOG(LS_INFO) << "recovery retransmit";
+          LOG(LS_INFO) << "recovery retransmit";
 #endif // _DEBUGMSG
-        if (!transmit(m_slist.begin(), now)) {
-          closedown(ECONNABORTED);
-          return false;
+          if (!transmit(m_slist.begin(), now)) {
+            closedown(ECONNABORTED);
+            return false;
+          }
+          m_sack_rexmit = std::max(m_sack_rexmit, m_slist.front().seq + 1);
         }
         m_cwnd += m_mss - std::min(nAcked, m_cwnd);
       }
@@ -803,12 +855,17 @@ bool PseudoTcp::process(Segment& seg) {
           return false;
         }
         m_recover = m_snd_nxt;
+        m_sack_rexmit = m_slist.front().seq + 1;
         uint32_t nInFlight = m_snd_nxt - m_snd_una;
         m_ssthresh = std::max(nInFlight / 2, 2 * m_mss);
         //LOG(LS_INFO) << "m_ssthresh: " << m_ssthresh << "  nInFlight: " << nInFlight << "  m_mss: " << m_mss;
         m_cwnd = m_ssthresh + 3 * m_mss;
       } else if (m_dup_acks > 3) {
         m_cwnd += m_mss;
+        if (m_sack_enabled && !retransmitSackHole(now)) {
+          closedown(ECONNABORTED);
+          return false;
+        }
       }
     } else {
       m_dup_acks = 0;
@@ -963,7 +1020,7 @@ bool PseudoTcp::process(Segment& seg) {
   return true;
 }
 
-bool PseudoTcp::transmit(const SList::iterator& seg, uint32_t now) {
+bool PseudoTcp::transmit(SList::iterator seg, uint32_t now) {
   if (seg->xmit >= ((m_state == TCP_ESTABLISHED) ? 15 : 30)) {
     LOG_F(LS_VERBOSE) << "too many retransmits";
     return false;
@@ -1016,8 +1073,8 @@ bool PseudoTcp::transmit(const SList::iterator& seg, uint32_t now) {
     subseg.xmit = seg->xmit;
     seg->len = nTransmit;
 
-    SList::iterator next = seg;
-    m_slist.insert(++next, subseg);
+    SList::iterator next = m_slist.insert(seg + 1, subseg);
+    seg = next - 1;
   }
 
   if (seg->xmit == 0) {
@@ -1103,19 +1160,20 @@ void PseudoTcp::attemptSend(SendFlags sflags) {
       return;
     }
 
-    // Find the next segment to transmit
-    SList::iterator it = m_slist.begin();
-    while (it->xmit > 0) {
-      ++it;
-      RTC_DCHECK(it != m_slist.end());
+    // Find the next segment to transmit. Everything before |m_snd_nxt| has
+    // been sent already.
+    SList::iterator seg = findSegment(m_snd_nxt);
+    while (seg->xmit > 0) {
+      ++seg;
+      RTC_DCHECK(seg != m_slist.end());
     }
-    SList::iterator seg = it;
 
     // If the segment is too large, break it into two
     if (seg->len > nAvailable) {
       SSegment subseg(seg->seq + nAvailable, seg->len - nAvailable, seg->bCtrl);
       seg->len = nAvailable;
-      m_slist.insert(++it, subseg);
+      SList::iterator next = m_slist.insert(seg + 1, subseg);
+      seg = next - 1;
     }
 
     if (!transmit(seg, now)) {
@@ -1167,6 +1225,11 @@ PseudoTcp::disableWindowScale() {
   m_support_wnd_scale = false;
 }
 
+void
+PseudoTcp::disableSack() {
+  m_support_sack = false;
+}
+
 void
 PseudoTcp::queueConnectMessage() {
   rtc::ByteBufferWriter buf(rtc::ByteBuffer::ORDER_NETWORK);
@@ -1177,6 +1240,10 @@ PseudoTcp::queueConnectMessage() {
     buf.WriteUInt8(1);
     buf.WriteUInt8(m_rwnd_scale);
   }
+  if (m_support_sack) {
+    buf.WriteUInt8(TCP_OPT_SACK_PERMITTED);
+    buf.WriteUInt8(0);
+  }
   m_snd_wnd = static_cast<uint32_t>(buf.Length());
   queue(buf.Data(), static_cast<uint32_t>(buf.Length()), true);
 }
@@ -1225,6 +1292,13 @@ void PseudoTcp::parseOptions(const char* data, uint32_t len) {
       m_swnd_scale = 0;
     }
   }
+
+  m_sack_enabled = m_support_sack &&
+                   options_specified.find(TCP_OPT_SACK_PERMITTED) !=
+                       options_specified.end();
+  if (!m_sack_enabled) {
+    LOG(LS_INFO) << "Selective acknowledgements disabled";
+  }
 }
 
 void PseudoTcp::applyOption(char kind, const char* data, uint32_t len) {
@@ -1246,6 +1320,63 @@ void PseudoTcp::applyWindowScaleOption(uint8_t scale_factor) {
   m_swnd_scale = scale_factor;
 }
 
+PseudoTcp::SList::iterator PseudoTcp::findSegment(uint32_t seq) {
+  return std::lower_bound(
+      m_slist.begin(), m_slist.end(), seq,
+      [](const SSegment& sseg, uint32_t seq) { return sseg.seq < seq; });
+}
+
+uint32_t PseudoTcp::writeSackBlocks(uint8_t* buffer) const {
+  // |m_rlist| is sorted by sequence number but its entries may overlap, so
+  // coalesce adjacent entries into a single block.
+  uint32_t count = 0;
+  RList::const_iterator it = m_rlist.begin();
+  while ((it != m_rlist.end()) && (count < kMaxSackBlocks)) {
+    uint32_t start = it->seq;
+    uint32_t end = it->seq + it->len;
+    for (++it; (it != m_rlist.end()) && (it->seq <= end); ++it) {
+      end = std::max(end, it->seq + it->len);
+    }
+    long_to_bytes(start, buffer + count * SACK_BLOCK_SIZE);
+    long_to_bytes(end, buffer + count * SACK_BLOCK_SIZE + 4);
+    ++count;
+  }
+  return count * SACK_BLOCK_SIZE;
+}
+
+void PseudoTcp::applySackBlocks(const Segment& seg) {
+  for (uint32_t i = 0; i < seg.sack_count; ++i) {
+    const SackBlock& block = seg.sack[i];
+    if ((block.start >= block.end) || (block.start < m_snd_una) ||
+        (block.end > m_snd_nxt)) {
+      LOG_F(LS_WARNING) << "Ignoring invalid SACK block";
+      continue;
+    }
+    for (SList::iterator it = findSegment(block.start);
+         (it != m_slist.end()) && (it->seq + it->len <= block.end); ++it) {
+      if (it->xmit > 0) {
+        it->bSacked = true;
+      }
+    }
+    m_sack_high = std::max(m_sack_high, block.end);
+  }
+}
+
+bool PseudoTcp::retransmitSackHole(uint32_t now) {
+  for (SList::iterator it = findSegment(m_sack_rexmit);
+       (it != m_slist.end()) && (it->seq + it->len <= m_sack_high); ++it) {
+    if ((it->xmit == 0) || it->bSacked) {
+      continue;
+    }
+#if _DEBUGMSG >= _DBG_NORMAL
+    LOG(LS_INFO) << "sack retransmit " << it->seq;
+#endif // _DEBUGMSG
+    m_sack_rexmit = it->seq + 1;
+    return transmit(it, now);
+  }
+  return true;
+}
+
 void PseudoTcp::resizeSendBuffer(uint32_t new_size) {
   m_sbuf_len = new_size;
   m_sbuf.SetCapacity(new_size);
@@ -11,6 +11,7 @@
 #ifndef P2P_BASE_PSEUDOTCP_H_
 #define P2P_BASE_PSEUDOTCP_H_
 
+#include <deque>
 #include <list>
 
 #include "rtc_base/basictypes.h"
@@ -110,6 +111,13 @@ class PseudoTcp {
  protected:
   enum SendFlags { sfNone, sfDelayedAck, sfImmediateAck };
 
+  // Maximum number of selective acknowledgement blocks carried by an ACK.
+  enum { kMaxSackBlocks = 4 };
+
+  struct SackBlock {
+    uint32_t start, end;
+  };
+
   struct Segment {
     uint32_t conv, seq, ack;
     uint8_t flags;
@@ -117,17 +125,24 @@ class PseudoTcp {
     const char * data;
     uint32_t len;
     uint32_t tsval, tsecr;
+    // Out-of-order ranges reported by the peer, only present on pure ACKs.
+    uint32_t sack_count;
+    SackBlock sack[kMaxSackBlocks];
   };
 
   struct SSegment {
     SSegment(uint32_t s, uint32_t l, bool c)
-        : seq(s), len(l), /*tstamp(0),*/ xmit(0), bCtrl(c) {}
+        : seq(s), len(l), /*tstamp(0),*/ xmit(0), bCtrl(c), bSacked(false) {}
     uint32_t seq, len;
     // uint32_t tstamp;
     uint8_t xmit;
     bool bCtrl;
+    // Set once the peer has selectively acknowledged the whole segment.
+    bool bSacked;
   };
-  typedef std::list<SSegment> SList;
+  // Segments are kept in sequence order in a deque, so the send queue can
+  // be searched by sequence number without walking a linked list.
+  typedef std::deque<SSegment> SList;
 
   struct RSegment {
     uint32_t seq, len;
@@ -156,7 +171,9 @@ class PseudoTcp {
   bool clock_check(uint32_t now, long& nTimeout);
 
   bool process(Segment& seg);
-  bool transmit(const SList::iterator& seg, uint32_t now);
+  // Transmits |seg|, splitting it if it is larger than the MSS. Note that
+  // splitting invalidates iterators into |m_slist|.
+  bool transmit(SList::iterator seg, uint32_t now);
 
   void adjustMTU();
 
@@ -168,6 +185,13 @@ class PseudoTcp {
   // support for testing backward compatibility.
   void disableWindowScale();
 
+  // This method is only used in tests, to disable selective acknowledgement
+  // support for testing backward compatibility.
+  void disableSack();
+
+  // Returns true if both sides negotiated selective acknowledgements.
+  bool isSackEnabled() const { return m_sack_enabled; }
+
  private:
   // Queue the connect message with TCP options.
   void queueConnectMessage();
@@ -181,6 +205,21 @@ class PseudoTcp {
   // Apply window scale option.
   void applyWindowScaleOption(uint8_t scale_factor);
 
+  // Returns the first segment in |m_slist| that starts at or after |seq|.
+  SList::iterator findSegment(uint32_t seq);
+
+  // Writes the out-of-order ranges held in |m_rlist| as SACK blocks to
+  // |buffer|. Returns the number of bytes written.
+  uint32_t writeSackBlocks(uint8_t* buffer) const;
+
+  // Marks the segments covered by the SACK blocks in |seg| as received.
+  void applySackBlocks(const Segment& seg);
+
+  // During fast recovery, retransmits the next segment that sits in a hole
+  // below the highest selectively acknowledged sequence number. Returns
+  // false if the retransmission failed.
+  bool retransmitSackHole(uint32_t now);
+
   // Resize the send buffer with |new_size| in bytes.
   void resizeSendBuffer(uint32_t new_size);
 
@@ -235,6 +274,15 @@ class PseudoTcp {
   // This is used by unit tests to test backward compatibility of
   // PseudoTcp implementations that don't support window scaling.
   bool m_support_wnd_scale;
+
+  // Selective acknowledgements. |m_support_sack| is cleared by unit tests to
+  // test backward compatibility. |m_sack_high| is the highest sequence number
+  // the peer has selectively acknowledged and |m_sack_rexmit| marks how far
+  // holes have been retransmitted during the current recovery.
+  bool m_support_sack;
+  bool m_sack_enabled;
+  uint32_t m_sack_high;
+  uint32_t m_sack_rexmit;
 };
 
 }  // namespace cricket
@@ -9,9 +9,12 @@
  */
 
 #include <algorithm>
+#include <set>
+#include <utility>
 #include <vector>
 
 #include "p2p/base/pseudotcp.h"
+#include "rtc_base/byteorder.h"
 #include "rtc_base/gunit.h"
 #include "rtc_base/helpers.h"
 #include "rtc_base/messagehandler.h"
@@ -23,6 +26,7 @@ using cricket::PseudoTcp;
 
 static const int kConnectTimeoutMs = 10000;  // ~3 * default RTO of 3000ms
 static const int kTransferTimeoutMs = 15000;
+static const int kGoodputDurationMs = 10000;
 static const int kBlockSize = 4096;
 
 class PseudoTcpForTest : public cricket::PseudoTcp {
@@ -37,6 +41,14 @@ class PseudoTcpForTest : public cricket::PseudoTcp {
   void disableWindowScale() {
     PseudoTcp::disableWindowScale();
   }
+
+  void disableSack() {
+    PseudoTcp::disableSack();
+  }
+
+  bool isSackEnabled() const {
+    return PseudoTcp::isSackEnabled();
+  }
 };
 
 class PseudoTcpTestBase : public testing::Test,
@@ -97,6 +109,12 @@ class PseudoTcpTestBase : public testing::Test,
   void DisableLocalWindowScale() {
     local_.disableWindowScale();
   }
+  void DisableRemoteSack() {
+    remote_.disableSack();
+  }
+  void DisableLocalSack() {
+    local_.disableSack();
+  }
 
  protected:
   int Connect() {
@@ -211,19 +229,8 @@ class PseudoTcpTest : public PseudoTcpTestBase {
     uint32_t start;
     int32_t elapsed;
     size_t received;
-    // Create some dummy data to send.
-    send_stream_.ReserveSize(size);
-    for (int i = 0; i < size; ++i) {
-      char ch = static_cast<char>(i);
-      send_stream_.Write(&ch, 1, NULL, NULL);
-    }
-    send_stream_.Rewind();
-    // Prepare the receive stream.
-    recv_stream_.ReserveSize(size);
-    // Connect and wait until connected.
     start = rtc::Time32();
-    EXPECT_EQ(0, Connect());
-    EXPECT_TRUE_WAIT(have_connected_, kConnectTimeoutMs);
+    StartTransfer(size);
     // Sending will start from OnTcpWriteable and complete when all data has
     // been received.
     EXPECT_TRUE_WAIT(have_disconnected_, kTransferTimeoutMs);
@@ -237,10 +244,50 @@ class PseudoTcpTest : public PseudoTcpTestBase {
     EXPECT_EQ(0, memcmp(send_stream_.GetBuffer(),
                         recv_stream_.GetBuffer(), size));
     LOG(LS_INFO) << "Transferred " << received << " bytes in " << elapsed
-                 << " ms (" << size * 8 / elapsed << " Kbps)";
+                 << " ms (" << received * 8 / std::max(elapsed, 1)
+                 << " Kbps)";
+  }
+
+  // Like TestTransfer(), but stops after |duration_ms| and reports the
+  // goodput of the data that was received by then.
+  void MeasureGoodput(int size, int duration_ms) {
+    uint32_t start;
+    int32_t elapsed;
+    size_t received;
+    start = rtc::Time32();
+    StartTransfer(size);
+    WAIT(have_disconnected_, duration_ms);
+    elapsed = rtc::Time32() - start;
+    recv_stream_.GetSize(&received);
+    EXPECT_GT(received, 0u);
+    EXPECT_EQ(0, memcmp(send_stream_.GetBuffer(),
+                        recv_stream_.GetBuffer(), received));
+    LOG(LS_INFO) << "Received " << received << " bytes in " << elapsed
+                 << " ms (" << received * 8 / std::max(elapsed, 1)
+                 << " Kbps), SACK "
+                 << (IsSackEnabled() ? "enabled" : "disabled");
+  }
+
+  bool IsSackEnabled() const {
+    return local_.isSackEnabled() && remote_.isSackEnabled();
   }
 
  private:
+  void StartTransfer(int size) {
+    // Create some dummy data to send.
+    send_stream_.ReserveSize(size);
+    for (int i = 0; i < size; ++i) {
+      char ch = static_cast<char>(i);
+      send_stream_.Write(&ch, 1, NULL, NULL);
+    }
+    send_stream_.Rewind();
+    // Prepare the receive stream.
+    recv_stream_.ReserveSize(size);
+    // Connect and wait until connected.
+    EXPECT_EQ(0, Connect());
+    EXPECT_TRUE_WAIT(have_connected_, kConnectTimeoutMs);
+  }
+
   // IPseudoTcpNotify interface
 
   virtual void OnTcpReadable(PseudoTcp* tcp) {
@@ -586,6 +633,77 @@ class PseudoTcpTestReceiveWindow : public PseudoTcpTestBase {
   std::vector<size_t> recv_position_;
 };
 
+// Drops chosen data segments of the local side the first time they are sent,
+// and records the SACK blocks sent by the remote side and the segments
+// retransmitted by the local side.
+class PseudoTcpTestSack : public PseudoTcpTest {
+ public:
+  typedef std::pair<uint32_t, uint32_t> Block;
+
+  struct Retransmission {
+    uint32_t seq;
+    // The highest cumulative ACK the remote side had sent at the time.
+    uint32_t remote_ack;
+  };
+
+  // Drops the |index|th data segment of the local side, counting from 0, on
+  // its first transmission.
+  void DropSegmentOnce(size_t index) { drop_indices_.insert(index); }
+
+  // The sequence number of the |index|th data segment of the local side.
+  uint32_t SegmentSeq(size_t index) const {
+    EXPECT_LT(index, segment_seqs_.size());
+    return index < segment_seqs_.size() ? segment_seqs_[index] : 0;
+  }
+
+  const std::vector<std::vector<Block>>& sacks() const { return sacks_; }
+  const std::vector<Retransmission>& retransmissions() const {
+    return retransmissions_;
+  }
+
+ protected:
+  // Layout of the PseudoTcp header, see pseudotcp.cc.
+  static const size_t kHeaderSize = 24;
+  static const uint8_t kFlagCtl = 0x02;
+  static const uint8_t kFlagSack = 0x08;
+
+  WriteResult TcpWritePacket(PseudoTcp* tcp,
+                             const char* buffer,
+                             size_t len) override {
+    const uint8_t flags = static_cast<uint8_t>(buffer[13]);
+    if (tcp == &remote_) {
+      remote_ack_ = std::max(remote_ack_, rtc::GetBE32(buffer + 8));
+      if (flags & kFlagSack) {
+        std::vector<Block> blocks;
+        for (size_t offset = kHeaderSize; offset + 8 <= len; offset += 8) {
+          blocks.push_back(Block(rtc::GetBE32(buffer + offset),
+                                 rtc::GetBE32(buffer + offset + 4)));
+        }
+        sacks_.push_back(blocks);
+      }
+    } else if (len > kHeaderSize && !(flags & kFlagCtl)) {
+      uint32_t seq = rtc::GetBE32(buffer + 4);
+      if (std::find(segment_seqs_.begin(), segment_seqs_.end(), seq) !=
+          segment_seqs_.end()) {
+        retransmissions_.push_back({seq, remote_ack_});
+      } else {
+        segment_seqs_.push_back(seq);
+        if (drop_indices_.count(segment_seqs_.size() - 1)) {
+          return WR_SUCCESS;
+        }
+      }
+    }
+    return PseudoTcpTest::TcpWritePacket(tcp, buffer, len);
+  }
+
+ private:
+  std::set<size_t> drop_indices_;
+  std::vector<uint32_t> segment_seqs_;
+  std::vector<std::vector<Block>> sacks_;
+  std::vector<Retransmission> retransmissions_;
+  uint32_t remote_ack_ = 0;
+};
+
 // Basic end-to-end data transfer tests
 
 // Test the normal case of sending data from one side to the other.
@@ -661,6 +779,121 @@ TEST_F(PseudoTcpTest, TestSendWithDelayAndOptAckDelayOff) {
   TestTransfer(100000);  // less data so test runs faster
 }
 
+// Test sending data with packet loss and a large window. Selective
+// acknowledgements let the sender repair several holes per round trip.
+TEST_F(PseudoTcpTest, TestSendWithLossAndLargeWindow) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetRemoteOptRcvBuf(100000);
+  SetLocalOptRcvBuf(100000);
+  SetLoss(10);
+  TestTransfer(100000);
+  EXPECT_TRUE(IsSackEnabled());
+}
+
+// Test packet loss with a receiver that doesn't support selective
+// acknowledgements.
+TEST_F(PseudoTcpTest, TestSendWithLossRemoteNoSack) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetLoss(10);
+  DisableRemoteSack();
+  TestTransfer(100000);
+  EXPECT_FALSE(local_.isSackEnabled());
+  EXPECT_FALSE(remote_.isSackEnabled());
+}
+
+// Test packet loss with a sender that doesn't support selective
+// acknowledgements.
+TEST_F(PseudoTcpTest, TestSendWithLossLocalNoSack) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetLoss(10);
+  DisableLocalSack();
+  TestTransfer(100000);
+  EXPECT_FALSE(local_.isSackEnabled());
+  EXPECT_FALSE(remote_.isSackEnabled());
+}
+
+// Test that a receiver with two holes in its data reports what it holds
+// beyond each hole, and that the sender retransmits only the two lost
+// segments, the second one before the first retransmission is acknowledged.
+TEST_F(PseudoTcpTestSack, TestSackBlocksAndSelectiveRetransmit) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetOptAckDelay(0);
+  DropSegmentOnce(10);
+  DropSegmentOnce(12);
+  TestTransfer(100000);
+  ASSERT_TRUE(IsSackEnabled());
+
+  // Segment 11 is held beyond the first hole, then segment 13 beyond the
+  // second one.
+  const Block after_first_hole(SegmentSeq(11), SegmentSeq(12));
+  const Block after_second_hole(SegmentSeq(13), SegmentSeq(14));
+  EXPECT_NE(sacks().end(),
+            std::find(sacks().begin(), sacks().end(),
+                      std::vector<Block>({after_first_hole})));
+  EXPECT_NE(sacks().end(),
+            std::find(sacks().begin(), sacks().end(),
+                      std::vector<Block>(
+                          {after_first_hole, after_second_hole})));
+  for (const std::vector<Block>& blocks : sacks()) {
+    for (const Block& block : blocks) {
+      EXPECT_TRUE(block.first == SegmentSeq(11) ||
+                  block.first == SegmentSeq(13));
+    }
+  }
+
+  ASSERT_EQ(2u, retransmissions().size());
+  EXPECT_EQ(SegmentSeq(10), retransmissions()[0].seq);
+  EXPECT_EQ(SegmentSeq(12), retransmissions()[1].seq);
+  EXPECT_EQ(SegmentSeq(10), retransmissions()[1].remote_ack);
+}
+
+// Test that without selective acknowledgements, the same two lost segments
+// are retransmitted one round trip apart, the second one on the partial ACK
+// of the first retransmission.
+TEST_F(PseudoTcpTestSack, TestRetransmitWithoutSack) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetOptAckDelay(0);
+  DisableLocalSack();
+  DropSegmentOnce(10);
+  DropSegmentOnce(12);
+  TestTransfer(100000);
+  ASSERT_FALSE(IsSackEnabled());
+  EXPECT_TRUE(sacks().empty());
+
+  ASSERT_EQ(2u, retransmissions().size());
+  EXPECT_EQ(SegmentSeq(10), retransmissions()[0].seq);
+  EXPECT_EQ(SegmentSeq(12), retransmissions()[1].seq);
+  EXPECT_EQ(SegmentSeq(12), retransmissions()[1].remote_ack);
+}
+
+// Measures goodput with and without selective acknowledgements over a lossy,
+// high-latency path with a large window, for a fixed time.
+TEST_F(PseudoTcpTest, DISABLED_GoodputWithDelayAndLoss) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetRemoteOptRcvBuf(1000000);
+  SetLocalOptRcvBuf(1000000);
+  SetDelay(50);
+  SetLoss(5);
+  MeasureGoodput(1000000, kGoodputDurationMs);
+}
+
+TEST_F(PseudoTcpTest, DISABLED_GoodputWithDelayAndLossNoSack) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetRemoteOptRcvBuf(1000000);
+  SetLocalOptRcvBuf(1000000);
+  SetDelay(50);
+  SetLoss(5);
+  DisableLocalSack();
+  MeasureGoodput(1000000, kGoodputDurationMs);
+}
+
 // Test a large receive buffer with a sender that doesn't support scaling.
 TEST_F(PseudoTcpTest, TestSendRemoteNoWindowScale) {
   SetLocalMtu(1500);
@@ -26,6 +26,7 @@
 #include "rtc_base/checks.h"
 #include "rtc_base/helpers.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/timeutils.h"
 
 using rtc::CreateRandomId;
 
@@ -263,6 +264,8 @@ void BasicPortAllocatorSession::SetCandidateFilter(uint32_t filter) {
 void BasicPortAllocatorSession::StartGettingPorts() {
   network_thread_ = rtc::Thread::Current();
   state_ = SessionState::GATHERING;
+  gathering_start_ms_ = rtc::TimeMillis();
+  gathering_times_ = CandidateGatheringTimes();
   if (!socket_factory_) {
     owned_socket_factory_.reset(
         new rtc::BasicPacketSocketFactory(network_thread_));
@@ -812,6 +815,10 @@ void BasicPortAllocatorSession::OnCandidateReady(
   }
 
   if (data->ready() && CheckCandidateFilter(c)) {
+    if (gathering_times_.first_candidate_ms < 0) {
+      gathering_times_.first_candidate_ms =
+          rtc::TimeMillis() - gathering_start_ms_;
+    }
     std::vector<Candidate> candidates;
     candidates.push_back(SanitizeRelatedAddress(c));
     SignalCandidatesReady(this, candidates);
@@ -968,8 +975,38 @@ void BasicPortAllocatorSession::OnPortAllocationComplete(
   MaybeSignalCandidatesAllocationDone();
 }
 
+void BasicPortAllocatorSession::OnAllocationPhaseStarted(int phase) {
+  int64_t* phase_ms = nullptr;
+  switch (phase) {
+    case PHASE_UDP:
+      phase_ms = &gathering_times_.udp_phase_ms;
+      break;
+    case PHASE_RELAY:
+      phase_ms = &gathering_times_.relay_phase_ms;
+      break;
+    case PHASE_TCP:
+      phase_ms = &gathering_times_.tcp_phase_ms;
+      break;
+    default:
+      RTC_NOTREACHED();
+      return;
+  }
+  if (*phase_ms < 0) {
+    *phase_ms = rtc::TimeMillis() - gathering_start_ms_;
+  }
+}
+
 void BasicPortAllocatorSession::MaybeSignalCandidatesAllocationDone() {
   if (CandidatesAllocationDone()) {
+    if (gathering_times_.done_ms < 0) {
+      gathering_times_.done_ms = rtc::TimeMillis() - gathering_start_ms_;
+      LOG(LS_INFO) << "Candidate gathering times (ms): udp="
+                   << gathering_times_.udp_phase_ms
+                   << " relay=" << gathering_times_.relay_phase_ms
+                   << " tcp=" << gathering_times_.tcp_phase_ms
+                   << " first_candidate=" << gathering_times_.first_candidate_ms
+                   << " done=" << gathering_times_.done_ms;
+    }
     if (pooled()) {
       LOG(LS_INFO) << "All candidates gathered for pooled session.";
     } else {
@@ -1147,28 +1184,33 @@ void AllocationSequence::OnMessage(rtc::Message* msg) {
 
   const char* const PHASE_NAMES[kNumPhases] = {"Udp", "Relay", "Tcp"};
 
-  // Perform all of the phases in the current step.
-  LOG_J(LS_INFO, network_) << "Allocation Phase="
-                           << PHASE_NAMES[phase_];
-
-  switch (phase_) {
-    case PHASE_UDP:
-      CreateUDPPorts();
-      CreateStunPorts();
-      break;
+  // Perform all of the phases in the current step. With parallel phases,
+  // every remaining phase is performed in this step.
+  const bool parallel_phases = IsFlagSet(PORTALLOCATOR_ENABLE_PARALLEL_PHASES);
+  do {
+    LOG_J(LS_INFO, network_) << "Allocation Phase="
+                             << PHASE_NAMES[phase_];
+    session_->OnAllocationPhaseStarted(phase_);
+
+    switch (phase_) {
+      case PHASE_UDP:
+        CreateUDPPorts();
+        CreateStunPorts();
+        break;
 
-    case PHASE_RELAY:
-      CreateRelayPorts();
-      break;
+      case PHASE_RELAY:
+        CreateRelayPorts();
+        break;
 
-    case PHASE_TCP:
-      CreateTCPPorts();
-      state_ = kCompleted;
-      break;
+      case PHASE_TCP:
+        CreateTCPPorts();
+        state_ = kCompleted;
+        break;
 
-    default:
-      RTC_NOTREACHED();
-  }
+      default:
+        RTC_NOTREACHED();
+    }
+  } while (parallel_phases && state() == kRunning && ++phase_ < kNumPhases);
 
   if (state() == kRunning) {
     ++phase_;
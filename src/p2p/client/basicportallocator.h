@@ -115,6 +115,10 @@ class BasicPortAllocatorSession : public PortAllocatorSession,
   void RegatherOnAllNetworks() override;
   void PruneAllPorts() override;
 
+  CandidateGatheringTimes gathering_times() const override {
+    return gathering_times_;
+  }
+
  protected:
   void UpdateIceParametersInternal() override;
 
@@ -201,6 +205,7 @@ class BasicPortAllocatorSession : public PortAllocatorSession,
   void OnPortDestroyed(PortInterface* port);
   void MaybeSignalCandidatesAllocationDone();
   void OnPortAllocationComplete(AllocationSequence* seq);
+  void OnAllocationPhaseStarted(int phase);
   PortData* FindPort(Port* port);
   std::vector<rtc::Network*> GetNetworks();
   std::vector<rtc::Network*> GetFailedNetworks();
@@ -242,6 +247,8 @@ class BasicPortAllocatorSession : public PortAllocatorSession,
   // Whether to prune low-priority ports, taken from the port allocator.
   bool prune_turn_ports_;
   SessionState state_ = SessionState::CLEARED;
+  int64_t gathering_start_ms_ = 0;
+  CandidateGatheringTimes gathering_times_;
 
   friend class AllocationSequence;
 };
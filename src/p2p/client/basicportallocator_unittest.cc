@@ -976,6 +976,82 @@ TEST_F(BasicPortAllocatorTest, TestGetAllPortsWithOneSecondStepDelay) {
   session_->StopGettingPorts();
 }
 
+// Verify that with parallel phases, all candidates are gathered in the first
+// allocation step even with the default step delay of 1sec.
+TEST_F(BasicPortAllocatorTest, TestGetAllPortsWithParallelPhases) {
+  AddInterface(kClientAddr);
+  allocator_->set_step_delay(kDefaultStepDelay);
+  allocator_->set_flags(allocator().flags() |
+                        PORTALLOCATOR_ENABLE_PARALLEL_PHASES);
+  EXPECT_TRUE(CreateSession(ICE_CANDIDATE_COMPONENT_RTP));
+  session_->StartGettingPorts();
+  ASSERT_TRUE_SIMULATED_WAIT(candidate_allocation_done_, 1000, fake_clock);
+  EXPECT_EQ(7U, candidates_.size());
+  EXPECT_EQ(4U, ports_.size());
+  EXPECT_PRED4(HasCandidate, candidates_, "relay", "udp", kRelayUdpIntAddr);
+  EXPECT_PRED4(HasCandidate, candidates_, "local", "tcp", kClientAddr);
+
+  const CandidateGatheringTimes& times =
+      static_cast<BasicPortAllocatorSession*>(session_.get())
+          ->gathering_times();
+  EXPECT_LE(0, times.udp_phase_ms);
+  EXPECT_EQ(times.udp_phase_ms, times.relay_phase_ms);
+  EXPECT_EQ(times.udp_phase_ms, times.tcp_phase_ms);
+  EXPECT_LE(times.udp_phase_ms, times.first_candidate_ms);
+  EXPECT_LE(times.first_candidate_ms, times.done_ms);
+}
+
+// Verify that the phase timing reflects the step delay between phases.
+TEST_F(BasicPortAllocatorTest, TestGatheringTimesWithOneSecondStepDelay) {
+  AddInterface(kClientAddr);
+  allocator_->set_step_delay(kDefaultStepDelay);
+  EXPECT_TRUE(CreateSession(ICE_CANDIDATE_COMPONENT_RTP));
+  session_->StartGettingPorts();
+  ASSERT_TRUE_SIMULATED_WAIT(candidate_allocation_done_, 3000, fake_clock);
+
+  const CandidateGatheringTimes& times =
+      static_cast<BasicPortAllocatorSession*>(session_.get())
+          ->gathering_times();
+  EXPECT_LE(0, times.udp_phase_ms);
+  EXPECT_EQ(times.udp_phase_ms + static_cast<int>(kDefaultStepDelay),
+            times.relay_phase_ms);
+  EXPECT_EQ(times.relay_phase_ms + static_cast<int>(kDefaultStepDelay),
+            times.tcp_phase_ms);
+  EXPECT_LE(times.tcp_phase_ms, times.done_ms);
+}
+
+// Reports the (simulated) time to the first candidate and to the end of
+// gathering on several interfaces, with sequential and parallel phases.
+TEST_F(BasicPortAllocatorTest, DISABLED_GatheringTimeWithParallelPhases) {
+  AddInterface(kClientAddr);
+  AddInterface(kClientAddr2);
+  allocator_->set_step_delay(kDefaultStepDelay);
+  for (bool parallel : {false, true}) {
+    uint32_t flags = allocator().flags();
+    if (parallel) {
+      flags |= PORTALLOCATOR_ENABLE_PARALLEL_PHASES;
+    } else {
+      flags &= ~PORTALLOCATOR_ENABLE_PARALLEL_PHASES;
+    }
+    allocator_->set_flags(flags);
+    candidate_allocation_done_ = false;
+    candidates_.clear();
+    ports_.clear();
+    EXPECT_TRUE(CreateSession(ICE_CANDIDATE_COMPONENT_RTP));
+    session_->StartGettingPorts();
+    ASSERT_TRUE_SIMULATED_WAIT(candidate_allocation_done_,
+                               kDefaultAllocationTimeout, fake_clock);
+    const CandidateGatheringTimes& times =
+        static_cast<BasicPortAllocatorSession*>(session_.get())
+            ->gathering_times();
+    LOG(LS_INFO) << (parallel ? "Parallel" : "Sequential")
+                 << " phases: " << candidates_.size()
+                 << " candidates, first after " << times.first_candidate_ms
+                 << " ms, done after " << times.done_ms << " ms";
+    session_->StopGettingPorts();
+  }
+}
+
 TEST_F(BasicPortAllocatorTest, TestSetupVideoRtpPortsWithNormalSendBuffers) {
   AddInterface(kClientAddr);
   EXPECT_TRUE(CreateSession(ICE_CANDIDATE_COMPONENT_RTP, CN_VIDEO));
@@ -315,6 +315,7 @@ void BaseChannel::SetTransports_n(
     // DTLS-SRTP when |writable_| becomes true again.
     writable_ = false;
     srtp_filter_.ResetParams();
+    UpdateMediaSendRecvState();
   }
 
   // If this BaseChannel doesn't require RTCP mux and we haven't fully
@@ -471,6 +472,40 @@ bool BaseChannel::SetRemoteContent(const MediaContentDescription* content,
                           action, error_desc));
 }
 
+void BaseChannel::SetLocalContentAsync(const MediaContentDescription* content,
+                                       ContentAction action,
+                                       const ContentCallback& callback) {
+  TRACE_EVENT0("webrtc", "BaseChannel::SetLocalContentAsync");
+  invoker_.AsyncInvoke<void>(
+      RTC_FROM_HERE, worker_thread_,
+      Bind(&BaseChannel::SetContentAsync_w, this, true, content, action,
+           rtc::Thread::Current(), callback));
+}
+
+void BaseChannel::SetRemoteContentAsync(const MediaContentDescription* content,
+                                        ContentAction action,
+                                        const ContentCallback& callback) {
+  TRACE_EVENT0("webrtc", "BaseChannel::SetRemoteContentAsync");
+  invoker_.AsyncInvoke<void>(
+      RTC_FROM_HERE, worker_thread_,
+      Bind(&BaseChannel::SetContentAsync_w, this, false, content, action,
+           rtc::Thread::Current(), callback));
+}
+
+void BaseChannel::SetContentAsync_w(bool local,
+                                    const MediaContentDescription* content,
+                                    ContentAction action,
+                                    rtc::Thread* callback_thread,
+                                    const ContentCallback& callback) {
+  RTC_DCHECK(worker_thread_->IsCurrent());
+  std::string error_desc;
+  bool success = local ? SetLocalContent_w(content, action, &error_desc)
+                       : SetRemoteContent_w(content, action, &error_desc);
+  invoker_.AsyncInvoke<void>(
+      RTC_FROM_HERE, callback_thread,
+      [callback, success, error_desc] { callback(success, error_desc); });
+}
+
 void BaseChannel::StartConnectionMonitor(int cms) {
   // We pass in the BaseChannel instead of the rtp_dtls_transport_
   // because if the rtp_dtls_transport_ changes, the ConnectionMonitor
@@ -512,20 +547,38 @@ bool BaseChannel::IsReadyToReceiveMedia_w() const {
 }
 
 bool BaseChannel::IsReadyToSendMedia_w() const {
-  // Need to access some state updated on the network thread.
-  return network_thread_->Invoke<bool>(
-      RTC_FROM_HERE, Bind(&BaseChannel::IsReadyToSendMedia_n, this));
-}
-
-bool BaseChannel::IsReadyToSendMedia_n() const {
   // Send outgoing data if we are enabled, have local and remote content,
   // and we have had some form of connectivity.
   return enabled() && IsReceiveContentDirection(remote_content_direction_) &&
          IsSendContentDirection(local_content_direction_) &&
-         was_ever_writable() &&
+         network_ready_to_send_media_;
+}
+
+bool BaseChannel::IsNetworkReadyToSendMedia_n() const {
+  RTC_DCHECK(network_thread_->IsCurrent());
+  return was_ever_writable() &&
          (srtp_filter_.IsActive() || !ShouldSetupDtlsSrtp_n());
 }
 
+void BaseChannel::SetNetworkReadyToSendMedia_w(bool ready,
+                                               uint64_t generation) {
+  RTC_DCHECK(worker_thread_->IsCurrent());
+  if (CacheNetworkReadyToSendMedia_w(ready, generation))
+    UpdateMediaSendRecvState_w();
+}
+
+bool BaseChannel::CacheNetworkReadyToSendMedia_w(bool ready,
+                                                 uint64_t generation) {
+  RTC_DCHECK(worker_thread_->IsCurrent());
+  // A value posted by UpdateMediaSendRecvState() can arrive after a newer one
+  // was read by SetRtpTransportParameters().
+  if (generation <= network_ready_generation_w_)
+    return false;
+  network_ready_generation_w_ = generation;
+  network_ready_to_send_media_ = ready;
+  return true;
+}
+
 bool BaseChannel::SendPacket(rtc::CopyOnWriteBuffer* packet,
                              const rtc::PacketOptions& options) {
   return SendPacket(false, packet, options);
@@ -582,6 +635,7 @@ void BaseChannel::OnDtlsState(DtlsTransportInternal* transport,
   // negotiated.
   if (state != DTLS_TRANSPORT_CONNECTED) {
     srtp_filter_.ResetParams();
+    UpdateMediaSendRecvState();
   }
 }
 
@@ -1045,11 +1099,20 @@ bool BaseChannel::SetRtpTransportParameters(
     }
   }
 
-  // Cache srtp_required_ for belt and suspenders check on SendPacket
-  return network_thread_->Invoke<bool>(
-      RTC_FROM_HERE, Bind(&BaseChannel::SetRtpTransportParameters_n, this,
-                          content, action, src, encrypted_extension_ids,
-                          error_desc));
+  // Setting the SRTP parameters may make the channel ready to send, so
+  // refresh the cached network state while we're blocked on the network
+  // thread anyway.
+  bool network_ready_to_send_media = false;
+  uint64_t generation = 0;
+  bool ret = network_thread_->Invoke<bool>(RTC_FROM_HERE, [&] {
+    bool success = SetRtpTransportParameters_n(
+        content, action, src, encrypted_extension_ids, error_desc);
+    network_ready_to_send_media = IsNetworkReadyToSendMedia_n();
+    generation = ++network_ready_generation_n_;
+    return success;
+  });
+  CacheNetworkReadyToSendMedia_w(network_ready_to_send_media, generation);
+  return ret;
 }
 
 bool BaseChannel::SetRtpTransportParameters_n(
@@ -1661,7 +1724,8 @@ void BaseChannel::UpdateMediaSendRecvState() {
   RTC_DCHECK(network_thread_->IsCurrent());
   invoker_.AsyncInvoke<void>(
       RTC_FROM_HERE, worker_thread_,
-      Bind(&BaseChannel::UpdateMediaSendRecvState_w, this));
+      Bind(&BaseChannel::SetNetworkReadyToSendMedia_w, this,
+           IsNetworkReadyToSendMedia_n(), ++network_ready_generation_n_));
 }
 
 int BaseChannel::GetTransportOverheadPerPacket() const {
@@ -11,6 +11,7 @@
 #ifndef PC_CHANNEL_H_
 #define PC_CHANNEL_H_
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
@@ -128,6 +129,21 @@ class BaseChannel
                         ContentAction action,
                         std::string* error_desc);
 
+  // Called with the result of SetLocalContentAsync/SetRemoteContentAsync and
+  // the error description if it failed.
+  typedef std::function<void(bool success, const std::string& error_desc)>
+      ContentCallback;
+  // Asynchronous versions of SetLocalContent/SetRemoteContent that don't block
+  // the calling thread on the worker thread. |callback| is posted back to the
+  // calling thread when the content has been applied, unless the channel is
+  // destroyed first. |content| must stay valid until then.
+  void SetLocalContentAsync(const MediaContentDescription* content,
+                            ContentAction action,
+                            const ContentCallback& callback);
+  void SetRemoteContentAsync(const MediaContentDescription* content,
+                             ContentAction action,
+                             const ContentCallback& callback);
+
   bool Enable(bool enable);
 
   // Multiplexing
@@ -293,7 +309,9 @@ class BaseChannel
 
   // Should be called whenever the conditions for
   // IsReadyToReceiveMedia/IsReadyToSendMedia are satisfied (or unsatisfied).
-  // Updates the send/recv state of the media channel.
+  // Updates the send/recv state of the media channel. The network thread
+  // version also posts the network part of the send conditions to the worker
+  // thread.
   void UpdateMediaSendRecvState();
   virtual void UpdateMediaSendRecvState_w() = 0;
 
@@ -365,7 +383,18 @@ class BaseChannel
   void SignalSentPacket_n(rtc::PacketTransportInternal* transport,
                           const rtc::SentPacket& sent_packet);
   void SignalSentPacket_w(const rtc::SentPacket& sent_packet);
-  bool IsReadyToSendMedia_n() const;
+  // Returns true if the transport has been writable and SRTP is set up if
+  // needed; the part of IsReadyToSendMedia_w owned by the network thread.
+  bool IsNetworkReadyToSendMedia_n() const;
+  // Caches |ready| and updates the send state, unless a value read later on
+  // the network thread has already been cached. |generation| orders the reads.
+  void SetNetworkReadyToSendMedia_w(bool ready, uint64_t generation);
+  bool CacheNetworkReadyToSendMedia_w(bool ready, uint64_t generation);
+  void SetContentAsync_w(bool local,
+                         const MediaContentDescription* content,
+                         ContentAction action,
+                         rtc::Thread* callback_thread,
+                         const ContentCallback& callback);
   void CacheRtpAbsSendTimeHeaderExtension_n(int rtp_abs_sendtime_extn_id);
   int GetTransportOverheadPerPacket() const;
   void UpdateTransportOverhead();
@@ -411,6 +440,15 @@ class BaseChannel
   std::vector<StreamParams> remote_streams_;
   MediaContentDirection local_content_direction_ = MD_INACTIVE;
   MediaContentDirection remote_content_direction_ = MD_INACTIVE;
+  // Copy of IsNetworkReadyToSendMedia_n(), so that updating the send state
+  // doesn't need to block on the network thread. Refreshed whenever
+  // transport parameters are set and posted by UpdateMediaSendRecvState().
+  bool network_ready_to_send_media_ = false;
+  // Incremented on the network thread for every read of
+  // IsNetworkReadyToSendMedia_n(). The worker thread keeps the generation of
+  // the cached copy, and drops posted values that are older.
+  uint64_t network_ready_generation_n_ = 0;
+  uint64_t network_ready_generation_w_ = 0;
   CandidatePairInterface* selected_candidate_pair_;
 };
 
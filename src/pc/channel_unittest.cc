@@ -9,6 +9,8 @@
  */
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "api/array_view.h"
 #include "media/base/fakemediaengine.h"
@@ -25,6 +27,8 @@
 #include "rtc_base/gunit.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/sslstreamadapter.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/timeutils.h"
 
 using cricket::CA_OFFER;
 using cricket::CA_PRANSWER;
@@ -329,6 +333,8 @@ class ChannelTest : public testing::Test, public sigslot::has_slots<> {
             fake_rtcp_packet_transport2_.get(), asymmetric);
       }
     });
+    // The new writable state is posted to the worker thread.
+    WaitForThreads();
   }
 
   bool SendInitiate() {
@@ -602,6 +608,31 @@ class ChannelTest : public testing::Test, public sigslot::has_slots<> {
                              media_channel1_->codecs()[0]));
   }
 
+  // Test that SetLocalContentAsync and SetRemoteContentAsync apply the
+  // content on the worker thread and report back to the calling thread.
+  void TestSetContentsAsync() {
+    CreateChannels(0, 0);
+    typename T::Content content;
+    CreateContent(0, kPcmuCodec, kH264Codec, &content);
+    int num_callbacks = 0;
+    int num_successes = 0;
+    auto callback = [&num_callbacks, &num_successes](
+                        bool success, const std::string& error_desc) {
+      ++num_callbacks;
+      if (success)
+        ++num_successes;
+    };
+    channel1_->SetLocalContentAsync(&content, CA_OFFER, callback);
+    channel1_->SetRemoteContentAsync(&content, CA_ANSWER, callback);
+    EXPECT_EQ(0, num_callbacks);
+    WaitForThreads();
+    EXPECT_EQ(2, num_callbacks);
+    EXPECT_EQ(2, num_successes);
+    ASSERT_EQ(1U, media_channel1_->codecs().size());
+    EXPECT_TRUE(CodecMatches(content.codecs()[0],
+                             media_channel1_->codecs()[0]));
+  }
+
   // Test that SetLocalContent and SetRemoteContent properly deals
   // with an empty offer.
   void TestSetContentsNullOffer() {
@@ -2280,6 +2311,10 @@ TEST_F(VoiceChannelSingleThreadTest, TestSetContents) {
   Base::TestSetContents();
 }
 
+TEST_F(VoiceChannelSingleThreadTest, TestSetContentsAsync) {
+  Base::TestSetContentsAsync();
+}
+
 TEST_F(VoiceChannelSingleThreadTest, TestSetContentsNullOffer) {
   Base::TestSetContentsNullOffer();
 }
@@ -2639,6 +2674,10 @@ TEST_F(VoiceChannelDoubleThreadTest, TestSetContents) {
   Base::TestSetContents();
 }
 
+TEST_F(VoiceChannelDoubleThreadTest, TestSetContentsAsync) {
+  Base::TestSetContentsAsync();
+}
+
 TEST_F(VoiceChannelDoubleThreadTest, TestSetContentsNullOffer) {
   Base::TestSetContentsNullOffer();
 }
@@ -3227,6 +3266,10 @@ TEST_F(VideoChannelDoubleThreadTest, TestSetContents) {
   Base::TestSetContents();
 }
 
+TEST_F(VideoChannelDoubleThreadTest, TestSetContentsAsync) {
+  Base::TestSetContentsAsync();
+}
+
 TEST_F(VideoChannelDoubleThreadTest, TestSetContentsNullOffer) {
   Base::TestSetContentsNullOffer();
 }
@@ -3897,4 +3940,78 @@ TEST_F(BaseChannelDeathTest, SetTransportsNonDtlsToDtls) {
 
 #endif  // RTC_DCHECK_IS_ON && GTEST_HAS_DEATH_TEST && !defined(WEBRTC_ANDROID)
 
+// Measures how long the signaling thread takes to negotiate 50 m-lines with
+// separate worker and network threads, first blocking on the worker thread for
+// every content and then with the asynchronous content API.
+TEST(BaseChannelPerfTest, DISABLED_Negotiate50MLines) {
+  const int kNumMLines = 50;
+  std::unique_ptr<rtc::Thread> network_thread = rtc::Thread::Create();
+  std::unique_ptr<rtc::Thread> worker_thread = rtc::Thread::Create();
+  network_thread->Start();
+  worker_thread->Start();
+  rtc::Thread* signaling_thread = rtc::Thread::Current();
+  cricket::FakeMediaEngine media_engine;
+
+  cricket::AudioContentDescription content;
+  content.AddCodec(kPcmuCodec);
+  content.set_rtcp_mux(true);
+
+  std::vector<std::unique_ptr<cricket::FakeDtlsTransport>> transports;
+  for (int i = 0; i < kNumMLines; ++i) {
+    transports.emplace_back(new cricket::FakeDtlsTransport(
+        "audio" + std::to_string(i), cricket::ICE_CANDIDATE_COMPONENT_RTP));
+  }
+  std::vector<cricket::VoiceChannel*> channels;
+  worker_thread->Invoke<void>(RTC_FROM_HERE, [&] {
+    for (auto& transport : transports) {
+      cricket::VoiceChannel* channel = new cricket::VoiceChannel(
+          worker_thread.get(), network_thread.get(), signaling_thread,
+          &media_engine,
+          new cricket::FakeVoiceMediaChannel(nullptr, cricket::AudioOptions()),
+          transport->transport_name(), true, false);
+      EXPECT_TRUE(channel->Init_w(transport.get(), nullptr, transport.get(),
+                                  nullptr));
+      channels.push_back(channel);
+    }
+  });
+
+  int64_t start_ns = rtc::TimeNanos();
+  for (cricket::VoiceChannel* channel : channels) {
+    EXPECT_TRUE(channel->SetLocalContent(&content, CA_OFFER, nullptr));
+    EXPECT_TRUE(channel->SetRemoteContent(&content, CA_ANSWER, nullptr));
+  }
+  int64_t blocking_ns = rtc::TimeNanos() - start_ns;
+
+  int num_callbacks = 0;
+  auto callback = [&num_callbacks](bool success,
+                                   const std::string& error_desc) {
+    EXPECT_TRUE(success);
+    ++num_callbacks;
+  };
+  start_ns = rtc::TimeNanos();
+  for (cricket::VoiceChannel* channel : channels) {
+    channel->SetLocalContentAsync(&content, CA_OFFER, callback);
+    channel->SetRemoteContentAsync(&content, CA_ANSWER, callback);
+  }
+  int64_t posted_ns = rtc::TimeNanos() - start_ns;
+  while (num_callbacks < 2 * kNumMLines) {
+    rtc::Message msg;
+    ASSERT_TRUE(signaling_thread->Get(&msg, kDefaultTimeout));
+    signaling_thread->Dispatch(&msg);
+  }
+  int64_t async_ns = rtc::TimeNanos() - start_ns;
+
+  LOG(LS_INFO) << "Negotiating " << kNumMLines << " m-lines: blocking "
+               << blocking_ns / rtc::kNumNanosecsPerMicrosec
+               << " us, asynchronous "
+               << async_ns / rtc::kNumNanosecsPerMicrosec
+               << " us of which the signaling thread was busy "
+               << posted_ns / rtc::kNumNanosecsPerMicrosec << " us.";
+
+  worker_thread->Invoke<void>(RTC_FROM_HERE, [&channels] {
+    for (cricket::VoiceChannel* channel : channels)
+      delete channel;
+  });
+}
+
 // TODO(pthatcher): TestSetReceiver?
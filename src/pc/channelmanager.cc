@@ -202,11 +202,27 @@ VoiceChannel* ChannelManager::CreateVoiceChannel(
     const std::string& content_name,
     bool srtp_required,
     const AudioOptions& options) {
+  return CreateVoiceChannel(call, media_config, rtp_transport, rtcp_transport,
+                            network_thread_, signaling_thread, content_name,
+                            srtp_required, options);
+}
+
+VoiceChannel* ChannelManager::CreateVoiceChannel(
+    webrtc::Call* call,
+    const cricket::MediaConfig& media_config,
+    DtlsTransportInternal* rtp_transport,
+    DtlsTransportInternal* rtcp_transport,
+    rtc::Thread* network_thread,
+    rtc::Thread* signaling_thread,
+    const std::string& content_name,
+    bool srtp_required,
+    const AudioOptions& options) {
   return worker_thread_->Invoke<VoiceChannel*>(
       RTC_FROM_HERE,
       Bind(&ChannelManager::CreateVoiceChannel_w, this, call, media_config,
            rtp_transport, rtcp_transport, rtp_transport, rtcp_transport,
-           signaling_thread, content_name, srtp_required, options));
+           network_thread, signaling_thread, content_name, srtp_required,
+           options));
 }
 
 VoiceChannel* ChannelManager::CreateVoiceChannel(
@@ -221,8 +237,8 @@ VoiceChannel* ChannelManager::CreateVoiceChannel(
   return worker_thread_->Invoke<VoiceChannel*>(
       RTC_FROM_HERE,
       Bind(&ChannelManager::CreateVoiceChannel_w, this, call, media_config,
-           nullptr, nullptr, rtp_transport, rtcp_transport, signaling_thread,
-           content_name, srtp_required, options));
+           nullptr, nullptr, rtp_transport, rtcp_transport, network_thread_,
+           signaling_thread, content_name, srtp_required, options));
 }
 
 VoiceChannel* ChannelManager::CreateVoiceChannel_w(
@@ -232,6 +248,7 @@ VoiceChannel* ChannelManager::CreateVoiceChannel_w(
     DtlsTransportInternal* rtcp_dtls_transport,
     rtc::PacketTransportInternal* rtp_packet_transport,
     rtc::PacketTransportInternal* rtcp_packet_transport,
+    rtc::Thread* network_thread,
     rtc::Thread* signaling_thread,
     const std::string& content_name,
     bool srtp_required,
@@ -250,7 +267,7 @@ VoiceChannel* ChannelManager::CreateVoiceChannel_w(
   }
 
   std::unique_ptr<VoiceChannel> voice_channel(
-      new VoiceChannel(worker_thread_, network_thread_, signaling_thread,
+      new VoiceChannel(worker_thread_, network_thread, signaling_thread,
                        media_engine_.get(), media_channel, content_name,
                        rtcp_packet_transport == nullptr, srtp_required));
 
@@ -296,11 +313,27 @@ VideoChannel* ChannelManager::CreateVideoChannel(
     const std::string& content_name,
     bool srtp_required,
     const VideoOptions& options) {
+  return CreateVideoChannel(call, media_config, rtp_transport, rtcp_transport,
+                            network_thread_, signaling_thread, content_name,
+                            srtp_required, options);
+}
+
+VideoChannel* ChannelManager::CreateVideoChannel(
+    webrtc::Call* call,
+    const cricket::MediaConfig& media_config,
+    DtlsTransportInternal* rtp_transport,
+    DtlsTransportInternal* rtcp_transport,
+    rtc::Thread* network_thread,
+    rtc::Thread* signaling_thread,
+    const std::string& content_name,
+    bool srtp_required,
+    const VideoOptions& options) {
   return worker_thread_->Invoke<VideoChannel*>(
       RTC_FROM_HERE,
       Bind(&ChannelManager::CreateVideoChannel_w, this, call, media_config,
            rtp_transport, rtcp_transport, rtp_transport, rtcp_transport,
-           signaling_thread, content_name, srtp_required, options));
+           network_thread, signaling_thread, content_name, srtp_required,
+           options));
 }
 
 VideoChannel* ChannelManager::CreateVideoChannel(
@@ -315,8 +348,8 @@ VideoChannel* ChannelManager::CreateVideoChannel(
   return worker_thread_->Invoke<VideoChannel*>(
       RTC_FROM_HERE,
       Bind(&ChannelManager::CreateVideoChannel_w, this, call, media_config,
-           nullptr, nullptr, rtp_transport, rtcp_transport, signaling_thread,
-           content_name, srtp_required, options));
+           nullptr, nullptr, rtp_transport, rtcp_transport, network_thread_,
+           signaling_thread, content_name, srtp_required, options));
 }
 
 VideoChannel* ChannelManager::CreateVideoChannel_w(
@@ -326,6 +359,7 @@ VideoChannel* ChannelManager::CreateVideoChannel_w(
     DtlsTransportInternal* rtcp_dtls_transport,
     rtc::PacketTransportInternal* rtp_packet_transport,
     rtc::PacketTransportInternal* rtcp_packet_transport,
+    rtc::Thread* network_thread,
     rtc::Thread* signaling_thread,
     const std::string& content_name,
     bool srtp_required,
@@ -340,7 +374,7 @@ VideoChannel* ChannelManager::CreateVideoChannel_w(
   }
 
   std::unique_ptr<VideoChannel> video_channel(new VideoChannel(
-      worker_thread_, network_thread_, signaling_thread, media_channel,
+      worker_thread_, network_thread, signaling_thread, media_channel,
       content_name, rtcp_packet_transport == nullptr, srtp_required));
   if (!video_channel->Init_w(rtp_dtls_transport, rtcp_dtls_transport,
                              rtp_packet_transport, rtcp_packet_transport)) {
@@ -383,16 +417,31 @@ RtpDataChannel* ChannelManager::CreateRtpDataChannel(
     rtc::Thread* signaling_thread,
     const std::string& content_name,
     bool srtp_required) {
+  return CreateRtpDataChannel(media_config, rtp_transport, rtcp_transport,
+                              network_thread_, signaling_thread, content_name,
+                              srtp_required);
+}
+
+RtpDataChannel* ChannelManager::CreateRtpDataChannel(
+    const cricket::MediaConfig& media_config,
+    DtlsTransportInternal* rtp_transport,
+    DtlsTransportInternal* rtcp_transport,
+    rtc::Thread* network_thread,
+    rtc::Thread* signaling_thread,
+    const std::string& content_name,
+    bool srtp_required) {
   return worker_thread_->Invoke<RtpDataChannel*>(
-      RTC_FROM_HERE, Bind(&ChannelManager::CreateRtpDataChannel_w, this,
-                          media_config, rtp_transport, rtcp_transport,
-                          signaling_thread, content_name, srtp_required));
+      RTC_FROM_HERE,
+      Bind(&ChannelManager::CreateRtpDataChannel_w, this, media_config,
+           rtp_transport, rtcp_transport, network_thread, signaling_thread,
+           content_name, srtp_required));
 }
 
 RtpDataChannel* ChannelManager::CreateRtpDataChannel_w(
     const cricket::MediaConfig& media_config,
     DtlsTransportInternal* rtp_transport,
     DtlsTransportInternal* rtcp_transport,
+    rtc::Thread* network_thread,
     rtc::Thread* signaling_thread,
     const std::string& content_name,
     bool srtp_required) {
@@ -406,7 +455,7 @@ RtpDataChannel* ChannelManager::CreateRtpDataChannel_w(
   }
 
   std::unique_ptr<RtpDataChannel> data_channel(new RtpDataChannel(
-      worker_thread_, network_thread_, signaling_thread, media_channel,
+      worker_thread_, network_thread, signaling_thread, media_channel,
       content_name, rtcp_transport == nullptr, srtp_required));
   if (!data_channel->Init_w(rtp_transport, rtcp_transport, rtp_transport,
                             rtcp_transport)) {
@@ -96,6 +96,18 @@ class ChannelManager {
       const std::string& content_name,
       bool srtp_required,
       const AudioOptions& options);
+  // Version of the above for transports that live on |network_thread| rather
+  // than on the ChannelManager's network thread.
+  VoiceChannel* CreateVoiceChannel(
+      webrtc::Call* call,
+      const cricket::MediaConfig& media_config,
+      DtlsTransportInternal* rtp_transport,
+      DtlsTransportInternal* rtcp_transport,
+      rtc::Thread* network_thread,
+      rtc::Thread* signaling_thread,
+      const std::string& content_name,
+      bool srtp_required,
+      const AudioOptions& options);
   // Version of the above that takes PacketTransportInternal.
   VoiceChannel* CreateVoiceChannel(
       webrtc::Call* call,
@@ -120,6 +132,18 @@ class ChannelManager {
       const std::string& content_name,
       bool srtp_required,
       const VideoOptions& options);
+  // Version of the above for transports that live on |network_thread| rather
+  // than on the ChannelManager's network thread.
+  VideoChannel* CreateVideoChannel(
+      webrtc::Call* call,
+      const cricket::MediaConfig& media_config,
+      DtlsTransportInternal* rtp_transport,
+      DtlsTransportInternal* rtcp_transport,
+      rtc::Thread* network_thread,
+      rtc::Thread* signaling_thread,
+      const std::string& content_name,
+      bool srtp_required,
+      const VideoOptions& options);
   // Version of the above that takes PacketTransportInternal.
   VideoChannel* CreateVideoChannel(
       webrtc::Call* call,
@@ -140,6 +164,15 @@ class ChannelManager {
       rtc::Thread* signaling_thread,
       const std::string& content_name,
       bool srtp_required);
+  // Version of the above for transports that live on |network_thread|.
+  RtpDataChannel* CreateRtpDataChannel(
+      const cricket::MediaConfig& media_config,
+      DtlsTransportInternal* rtp_transport,
+      DtlsTransportInternal* rtcp_transport,
+      rtc::Thread* network_thread,
+      rtc::Thread* signaling_thread,
+      const std::string& content_name,
+      bool srtp_required);
   // Destroys a data channel created by CreateRtpDataChannel.
   void DestroyRtpDataChannel(RtpDataChannel* data_channel);
 
@@ -180,6 +213,7 @@ class ChannelManager {
       DtlsTransportInternal* rtcp_dtls_transport,
       rtc::PacketTransportInternal* rtp_packet_transport,
       rtc::PacketTransportInternal* rtcp_packet_transport,
+      rtc::Thread* network_thread,
       rtc::Thread* signaling_thread,
       const std::string& content_name,
       bool srtp_required,
@@ -192,6 +226,7 @@ class ChannelManager {
       DtlsTransportInternal* rtcp_dtls_transport,
       rtc::PacketTransportInternal* rtp_packet_transport,
       rtc::PacketTransportInternal* rtcp_packet_transport,
+      rtc::Thread* network_thread,
       rtc::Thread* signaling_thread,
       const std::string& content_name,
       bool srtp_required,
@@ -201,6 +236,7 @@ class ChannelManager {
       const cricket::MediaConfig& media_config,
       DtlsTransportInternal* rtp_transport,
       DtlsTransportInternal* rtcp_transport,
+      rtc::Thread* network_thread,
       rtc::Thread* signaling_thread,
       const std::string& content_name,
       bool srtp_required);
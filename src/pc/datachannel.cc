@@ -75,10 +75,18 @@ bool DataChannel::PacketQueue::Empty() const {
   return packets_.empty();
 }
 
+size_t DataChannel::PacketQueue::Size() const {
+  return packets_.size();
+}
+
 DataBuffer* DataChannel::PacketQueue::Front() {
   return packets_.front();
 }
 
+DataBuffer* DataChannel::PacketQueue::At(size_t index) {
+  return packets_[index];
+}
+
 void DataChannel::PacketQueue::Pop() {
   if (packets_.empty()) {
     return;
@@ -523,14 +531,18 @@ void DataChannel::SendQueuedDataMessages() {
   RTC_DCHECK(state_ == kOpen || state_ == kClosing);
 
   uint64_t start_buffered_amount = buffered_amount();
-  while (!queued_send_data_.Empty()) {
-    DataBuffer* buffer = queued_send_data_.Front();
-    if (!SendDataMessage(*buffer, false)) {
-      // Leave the message in the queue if sending is aborted.
-      break;
+  if (data_channel_type_ == cricket::DCT_SCTP) {
+    SendQueuedSctpDataMessages();
+  } else {
+    while (!queued_send_data_.Empty()) {
+      DataBuffer* buffer = queued_send_data_.Front();
+      if (!SendDataMessage(*buffer, false)) {
+        // Leave the message in the queue if sending is aborted.
+        break;
+      }
+      queued_send_data_.Pop();
+      delete buffer;
     }
-    queued_send_data_.Pop();
-    delete buffer;
   }
 
   if (observer_ && buffered_amount() < start_buffered_amount) {
@@ -538,8 +550,41 @@ void DataChannel::SendQueuedDataMessages() {
   }
 }
 
-bool DataChannel::SendDataMessage(const DataBuffer& buffer,
-                                  bool queue_if_blocked) {
+// Sends each run of queued messages of the same type with one call to the
+// provider, instead of one call and network thread hop per message.
+void DataChannel::SendQueuedSctpDataMessages() {
+  while (!queued_send_data_.Empty()) {
+    const bool binary = queued_send_data_.Front()->binary;
+    std::vector<rtc::CopyOnWriteBuffer> payloads;
+    for (size_t i = 0; i < queued_send_data_.Size() &&
+                       queued_send_data_.At(i)->binary == binary;
+         ++i) {
+      payloads.push_back(queued_send_data_.At(i)->data);
+    }
+
+    cricket::SendDataResult send_result = cricket::SDR_SUCCESS;
+    size_t sent = provider_->SendDataBulk(GetSendDataParams(binary), payloads,
+                                          &send_result);
+    for (size_t i = 0; i < sent; ++i) {
+      DataBuffer* buffer = queued_send_data_.Front();
+      ++messages_sent_;
+      bytes_sent_ += buffer->size();
+      queued_send_data_.Pop();
+      delete buffer;
+    }
+    if (sent < payloads.size()) {
+      // Leave the remaining messages in the queue if sending is blocked.
+      if (send_result != cricket::SDR_BLOCK) {
+        LOG(LS_ERROR) << "Closing the DataChannel due to a failure to send "
+                      << "data, send_result = " << send_result;
+        Close();
+      }
+      return;
+    }
+  }
+}
+
+cricket::SendDataParams DataChannel::GetSendDataParams(bool binary) const {
   cricket::SendDataParams send_params;
 
   if (data_channel_type_ == cricket::DCT_SCTP) {
@@ -557,10 +602,15 @@ bool DataChannel::SendDataMessage(const DataBuffer& buffer,
   } else {
     send_params.ssrc = send_ssrc_;
   }
-  send_params.type = buffer.binary ? cricket::DMT_BINARY : cricket::DMT_TEXT;
+  send_params.type = binary ? cricket::DMT_BINARY : cricket::DMT_TEXT;
+  return send_params;
+}
 
+bool DataChannel::SendDataMessage(const DataBuffer& buffer,
+                                  bool queue_if_blocked) {
   cricket::SendDataResult send_result = cricket::SDR_SUCCESS;
-  bool success = provider_->SendData(send_params, buffer.data, &send_result);
+  bool success = provider_->SendData(GetSendDataParams(buffer.binary),
+                                     buffer.data, &send_result);
 
   if (success) {
     ++messages_sent_;
@@ -14,6 +14,7 @@
 #include <deque>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "api/datachannelinterface.h"
 #include "api/proxy.h"
@@ -33,6 +34,22 @@ class DataChannelProviderInterface {
   virtual bool SendData(const cricket::SendDataParams& params,
                         const rtc::CopyOnWriteBuffer& payload,
                         cricket::SendDataResult* result) = 0;
+  // Sends each of |payloads| as a separate message with the same |params|,
+  // stopping at the first one that can't be sent. Returns the number of
+  // messages sent; |result| describes the outcome of the last attempt.
+  virtual size_t SendDataBulk(
+      const cricket::SendDataParams& params,
+      const std::vector<rtc::CopyOnWriteBuffer>& payloads,
+      cricket::SendDataResult* result) {
+    size_t sent = 0;
+    for (const rtc::CopyOnWriteBuffer& payload : payloads) {
+      if (!SendData(params, payload, result)) {
+        break;
+      }
+      ++sent;
+    }
+    return sent;
+  }
   // Connects to the transport signals.
   virtual bool ConnectDataChannel(DataChannel* data_channel) = 0;
   // Disconnects from the transport signals.
@@ -206,8 +223,12 @@ class DataChannel : public DataChannelInterface,
 
     bool Empty() const;
 
+    size_t Size() const;
+
     DataBuffer* Front();
 
+    DataBuffer* At(size_t index);
+
     void Pop();
 
     void Push(DataBuffer* packet);
@@ -239,6 +260,8 @@ class DataChannel : public DataChannelInterface,
   void DeliverQueuedReceivedData();
 
   void SendQueuedDataMessages();
+  void SendQueuedSctpDataMessages();
+  cricket::SendDataParams GetSendDataParams(bool binary) const;
   bool SendDataMessage(const DataBuffer& buffer, bool queue_if_blocked);
   bool QueueSendDataMessage(const DataBuffer& buffer);
 
@@ -202,6 +202,26 @@ TEST_F(SctpDataChannelTest, QueuedDataSentWhenUnblocked) {
   EXPECT_EQ(2U, observer_->on_buffered_amount_change_count());
 }
 
+// Tests that the queued data are sent with one bulk send per run of messages of
+// the same type.
+TEST_F(SctpDataChannelTest, QueuedDataSentInBulk) {
+  SetChannelReady();
+  webrtc::DataBuffer text("text");
+  webrtc::DataBuffer binary(rtc::CopyOnWriteBuffer("binary", 6), true);
+  provider_->set_send_blocked(true);
+  EXPECT_TRUE(webrtc_data_channel_->Send(text));
+  EXPECT_TRUE(webrtc_data_channel_->Send(text));
+  EXPECT_TRUE(webrtc_data_channel_->Send(binary));
+  EXPECT_TRUE(webrtc_data_channel_->Send(text));
+  EXPECT_EQ(0U, webrtc_data_channel_->messages_sent());
+
+  provider_->set_send_blocked(false);
+  EXPECT_EQ(0U, webrtc_data_channel_->buffered_amount());
+  EXPECT_EQ(4U, webrtc_data_channel_->messages_sent());
+  EXPECT_EQ(3, provider_->bulk_send_count());
+  EXPECT_EQ(cricket::DMT_TEXT, provider_->last_send_data_params().type);
+}
+
 // Tests that no crash when the channel is blocked right away while trying to
 // send queued data.
 TEST_F(SctpDataChannelTest, BlockedWhenSendQueuedDataNoCrash) {
@@ -236,10 +236,18 @@ bool JsepSessionDescription::GetMediasectionIndex(
   }
   *index = static_cast<size_t>(candidate->sdp_mline_index());
   if (description_ && !candidate->sdp_mid().empty()) {
+    const cricket::ContentInfos& contents = description_->contents();
+    // The sdp_mline_index usually agrees with the sdp_mid, so check it
+    // before searching, which keeps adding candidates to descriptions with
+    // many m= sections linear.
+    if (*index < contents.size() &&
+        candidate->sdp_mid() == contents[*index].name) {
+      return true;
+    }
     bool found = false;
     // Try to match the sdp_mid with content name.
-    for (size_t i = 0; i < description_->contents().size(); ++i) {
-      if (candidate->sdp_mid() == description_->contents().at(i).name) {
+    for (size_t i = 0; i < contents.size(); ++i) {
+      if (candidate->sdp_mid() == contents[i].name) {
         *index = i;
         found = true;
         break;
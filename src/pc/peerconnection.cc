@@ -274,6 +274,8 @@ bool PeerConnectionInterface::RTCConfiguration::operator==(
     bool redetermine_role_on_ice_restart;
     rtc::Optional<int> ice_check_min_interval;
     rtc::Optional<rtc::IntervalRange> ice_regather_interval_range;
+    rtc::Optional<int> sctp_send_buffer_size;
+    rtc::Optional<int> sctp_receive_buffer_size;
   };
   static_assert(sizeof(stuff_being_tested_for_equality) == sizeof(*this),
                 "Did you add something to RTCConfiguration and forget to "
@@ -309,7 +311,9 @@ bool PeerConnectionInterface::RTCConfiguration::operator==(
          enable_ice_renomination == o.enable_ice_renomination &&
          redetermine_role_on_ice_restart == o.redetermine_role_on_ice_restart &&
          ice_check_min_interval == o.ice_check_min_interval &&
-         ice_regather_interval_range == o.ice_regather_interval_range;
+         ice_regather_interval_range == o.ice_regather_interval_range &&
+         sctp_send_buffer_size == o.sctp_send_buffer_size &&
+         sctp_receive_buffer_size == o.sctp_receive_buffer_size;
 }
 
 bool PeerConnectionInterface::RTCConfiguration::operator!=(
@@ -387,9 +391,11 @@ bool ConvertConstraintsToOfferAnswerOptions(
 }
 
 PeerConnection::PeerConnection(PeerConnectionFactory* factory,
+                               rtc::Thread* network_thread,
                                std::unique_ptr<RtcEventLog> event_log,
                                std::unique_ptr<Call> call)
     : factory_(factory),
+      network_thread_(network_thread),
       observer_(NULL),
       uma_observer_(NULL),
       event_log_(std::move(event_log)),
@@ -430,6 +436,7 @@ PeerConnection::~PeerConnection() {
     call_.reset();
     event_log_.reset();
   });
+  factory_->ReleaseNetworkThread(network_thread_);
 }
 
 bool PeerConnection::Initialize(
@@ -471,16 +478,16 @@ bool PeerConnection::Initialize(
   session_.reset(new WebRtcSession(
       call_.get(), factory_->channel_manager(), configuration.media_config,
       event_log_.get(),
-      factory_->network_thread(),
+      network_thread_,
       factory_->worker_thread(), factory_->signaling_thread(),
       port_allocator_.get(),
       std::unique_ptr<cricket::TransportController>(
           factory_->CreateTransportController(
-              port_allocator_.get(),
+              port_allocator_.get(), network_thread_,
               configuration.redetermine_role_on_ice_restart)),
 #ifdef HAVE_SCTP
       std::unique_ptr<cricket::SctpTransportInternalFactory>(
-          new cricket::SctpTransportFactory(factory_->network_thread()))
+          new cricket::SctpTransportFactory(network_thread_))
 #else
       nullptr
 #endif
@@ -45,9 +45,12 @@ class PeerConnection : public PeerConnectionInterface,
                        public rtc::MessageHandler,
                        public sigslot::has_slots<> {
  public:
-  explicit PeerConnection(PeerConnectionFactory* factory,
-                          std::unique_ptr<RtcEventLog> event_log,
-                          std::unique_ptr<Call> call);
+  // |network_thread| is the thread picked for this PeerConnection from the
+  // factory's network thread pool.
+  PeerConnection(PeerConnectionFactory* factory,
+                 rtc::Thread* network_thread,
+                 std::unique_ptr<RtcEventLog> event_log,
+                 std::unique_ptr<Call> call);
 
   bool Initialize(
       const PeerConnectionInterface::RTCConfiguration& configuration,
@@ -214,7 +217,7 @@ class PeerConnection : public PeerConnectionInterface,
     return factory_->signaling_thread();
   }
 
-  rtc::Thread* network_thread() const { return factory_->network_thread(); }
+  rtc::Thread* network_thread() const { return network_thread_; }
 
   void PostSetSessionDescriptionFailure(SetSessionDescriptionObserver* observer,
                                         const std::string& error);
@@ -394,6 +397,7 @@ class PeerConnection : public PeerConnectionInterface,
   // PeerConnectionFactoryInterface all instances created using the raw pointer
   // will refer to the same reference count.
   rtc::scoped_refptr<PeerConnectionFactory> factory_;
+  rtc::Thread* const network_thread_;
   PeerConnectionObserver* observer_;
   UMAObserver* uma_observer_;
 
@@ -9,6 +9,7 @@
  */
 
 #include <memory>
+#include <vector>
 
 #include "api/audio_codecs/builtin_audio_decoder_factory.h"
 #include "api/audio_codecs/builtin_audio_encoder_factory.h"
@@ -17,6 +18,7 @@
 #include "rtc_base/ptr_util.h"
 #include "rtc_base/stringencode.h"
 #include "rtc_base/stringutils.h"
+#include "rtc_base/timeutils.h"
 
 #ifdef WEBRTC_ANDROID
 #include "pc/test/androidtestinitializer.h"
@@ -544,4 +546,90 @@ TEST_F(PeerConnectionEndToEndTest, CloseDataChannelRemotelyWhileNotReferenced) {
   // close message and be destroyed.
   rtc::Thread::Current()->ProcessMessages(100);
 }
+
+// Measures how long it takes to connect many pairs of PeerConnections that
+// share one factory and to exchange data channel messages between all of them,
+// with all transports on one network thread and spread over a pool.
+TEST(PeerConnectionEndToEndPerfTest,
+     DISABLED_ManyConnectionsWithNetworkThreadPool) {
+  const int kNumPairs = 25;
+  const size_t kNumMessages = 100;
+  for (int pool_size : {1, 4}) {
+    std::unique_ptr<rtc::Thread> network_thread =
+        rtc::Thread::CreateWithSocketServer();
+    std::unique_ptr<rtc::Thread> worker_thread = rtc::Thread::Create();
+    RTC_CHECK(network_thread->Start());
+    RTC_CHECK(worker_thread->Start());
+    rtc::scoped_refptr<webrtc::PeerConnectionFactoryInterface> factory =
+        webrtc::CreatePeerConnectionFactory(
+            network_thread.get(), worker_thread.get(), rtc::Thread::Current(),
+            FakeAudioCaptureModule::Create(),
+            webrtc::CreateBuiltinAudioEncoderFactory(),
+            webrtc::CreateBuiltinAudioDecoderFactory(), nullptr, nullptr);
+    ASSERT_TRUE(factory);
+    webrtc::PeerConnectionFactoryInterface::Options options;
+    options.network_thread_pool_size = pool_size;
+    // Connect over the loopback interface.
+    options.network_ignore_mask = 0;
+    factory->SetOptions(options);
+
+    int64_t start_ns = rtc::TimeNanos();
+    std::vector<rtc::scoped_refptr<PeerConnectionTestWrapper>> wrappers;
+    std::vector<rtc::scoped_refptr<DataChannelInterface>> caller_dcs;
+    std::vector<rtc::scoped_refptr<DataChannelInterface>> callee_dcs;
+    std::vector<std::unique_ptr<webrtc::MockDataChannelObserver>> observers;
+    webrtc::DataChannelInit init;
+    init.negotiated = true;
+    init.id = 0;
+    for (int i = 0; i < kNumPairs; ++i) {
+      rtc::scoped_refptr<PeerConnectionTestWrapper> caller(
+          new rtc::RefCountedObject<PeerConnectionTestWrapper>(
+              "caller", network_thread.get(), worker_thread.get()));
+      rtc::scoped_refptr<PeerConnectionTestWrapper> callee(
+          new rtc::RefCountedObject<PeerConnectionTestWrapper>(
+              "callee", network_thread.get(), worker_thread.get()));
+      PeerConnectionInterface::RTCConfiguration config;
+      ASSERT_TRUE(caller->CreatePcWithFactory(factory, config));
+      ASSERT_TRUE(callee->CreatePcWithFactory(factory, config));
+      PeerConnectionTestWrapper::Connect(caller.get(), callee.get());
+      caller_dcs.push_back(caller->CreateDataChannel("data", init));
+      callee_dcs.push_back(callee->CreateDataChannel("data", init));
+      observers.emplace_back(
+          new webrtc::MockDataChannelObserver(callee_dcs.back()));
+      caller->CreateOffer(nullptr);
+      wrappers.push_back(caller);
+      wrappers.push_back(callee);
+    }
+    for (int i = 0; i < kNumPairs; ++i) {
+      EXPECT_EQ_WAIT(DataChannelInterface::kOpen, caller_dcs[i]->state(),
+                     kMaxWait);
+      EXPECT_TRUE_WAIT(observers[i]->IsOpen(), kMaxWait);
+    }
+    int64_t connected_ns = rtc::TimeNanos();
+
+    for (size_t message = 0; message < kNumMessages; ++message) {
+      for (const auto& dc : caller_dcs)
+        dc->Send(webrtc::DataBuffer("message " + rtc::ToString(message)));
+    }
+    for (const auto& observer : observers) {
+      EXPECT_EQ_WAIT(kNumMessages, observer->received_message_count(),
+                     kMaxWait);
+    }
+    int64_t done_ns = rtc::TimeNanos();
+    LOG(LS_INFO) << "Network thread pool size " << pool_size << ": connected "
+                 << kNumPairs << " pairs in "
+                 << (connected_ns - start_ns) / rtc::kNumNanosecsPerMillisec
+                 << " ms, sent " << kNumMessages << " messages each in "
+                 << (done_ns - connected_ns) / rtc::kNumNanosecsPerMillisec
+                 << " ms.";
+
+    // The PeerConnections hold the last reference to the factory, which must
+    // be released before its threads are stopped.
+    observers.clear();
+    caller_dcs.clear();
+    callee_dcs.clear();
+    wrappers.clear();
+    factory = nullptr;
+  }
+}
 #endif  // HAVE_SCTP
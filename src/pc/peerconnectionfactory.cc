@@ -10,6 +10,7 @@
 
 #include "pc/peerconnectionfactory.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "api/mediaconstraintsinterface.h"
@@ -119,10 +120,9 @@ PeerConnectionFactory::~PeerConnectionFactory() {
   RTC_DCHECK(signaling_thread_->IsCurrent());
   channel_manager_.reset(nullptr);
 
-  // Make sure |worker_thread_| and |signaling_thread_| outlive
-  // |default_socket_factory_| and |default_network_manager_|.
-  default_socket_factory_ = nullptr;
-  default_network_manager_ = nullptr;
+  // Make sure |worker_thread_| and |signaling_thread_| outlive the socket
+  // factories and network managers of the network thread pool.
+  network_thread_pool_.clear();
 
   if (wraps_current_thread_)
     rtc::ThreadManager::Instance()->UnwrapCurrentThread();
@@ -132,16 +132,7 @@ bool PeerConnectionFactory::Initialize() {
   RTC_DCHECK(signaling_thread_->IsCurrent());
   rtc::InitRandom(rtc::Time32());
 
-  default_network_manager_.reset(new rtc::BasicNetworkManager());
-  if (!default_network_manager_) {
-    return false;
-  }
-
-  default_socket_factory_.reset(
-      new rtc::BasicPacketSocketFactory(network_thread_));
-  if (!default_socket_factory_) {
-    return false;
-  }
+  AddPooledNetworkThread(network_thread_);
 
   channel_manager_.reset(new cricket::ChannelManager(
       std::move(media_engine_), worker_thread_, network_thread_));
@@ -240,11 +231,16 @@ PeerConnectionFactory::CreatePeerConnection(
         new rtc::RTCCertificateGenerator(signaling_thread_, network_thread_));
   }
 
+  // An injected allocator is bound to the factory's network thread, so only
+  // PeerConnections using the default one can be moved to other threads.
+  PooledNetworkThread* network_thread =
+      allocator ? network_thread_pool_[0].get() : SelectNetworkThread();
   if (!allocator) {
     allocator.reset(new cricket::BasicPortAllocator(
-        default_network_manager_.get(), default_socket_factory_.get()));
+        network_thread->network_manager.get(),
+        network_thread->socket_factory.get()));
   }
-  network_thread_->Invoke<void>(
+  network_thread->thread->Invoke<void>(
       RTC_FROM_HERE, rtc::Bind(&cricket::PortAllocator::SetNetworkIgnoreMask,
                                allocator.get(), options_.network_ignore_mask));
 
@@ -257,8 +253,12 @@ PeerConnectionFactory::CreatePeerConnection(
       RTC_FROM_HERE,
       rtc::Bind(&PeerConnectionFactory::CreateCall_w, this, event_log.get()));
 
+  // Released by the PeerConnection when it's destroyed, also if it fails to
+  // initialize.
+  ++network_thread->num_peer_connections;
   rtc::scoped_refptr<PeerConnection> pc(
-      new rtc::RefCountedObject<PeerConnection>(this, std::move(event_log),
+      new rtc::RefCountedObject<PeerConnection>(this, network_thread->thread,
+                                                std::move(event_log),
                                                 std::move(call)));
 
   if (!pc->Initialize(configuration, std::move(allocator),
@@ -294,13 +294,25 @@ PeerConnectionFactory::CreateAudioTrack(const std::string& id,
 
 cricket::TransportController* PeerConnectionFactory::CreateTransportController(
     cricket::PortAllocator* port_allocator,
+    rtc::Thread* network_thread,
     bool redetermine_role_on_ice_restart) {
   RTC_DCHECK(signaling_thread_->IsCurrent());
   return new cricket::TransportController(
-      signaling_thread_, network_thread_, port_allocator,
+      signaling_thread_, network_thread, port_allocator,
       redetermine_role_on_ice_restart, options_.crypto_options);
 }
 
+void PeerConnectionFactory::ReleaseNetworkThread(rtc::Thread* network_thread) {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  for (const auto& pooled : network_thread_pool_) {
+    if (pooled->thread == network_thread) {
+      RTC_DCHECK_GT(pooled->num_peer_connections, 0);
+      --pooled->num_peer_connections;
+      return;
+    }
+  }
+}
+
 cricket::ChannelManager* PeerConnectionFactory::channel_manager() {
   return channel_manager_.get();
 }
@@ -345,4 +357,46 @@ std::unique_ptr<Call> PeerConnectionFactory::CreateCall_w(
   return std::unique_ptr<Call>(call_factory_->CreateCall(call_config));
 }
 
+PeerConnectionFactory::PooledNetworkThread*
+PeerConnectionFactory::AddPooledNetworkThread(rtc::Thread* thread) {
+  std::unique_ptr<PooledNetworkThread> pooled(new PooledNetworkThread());
+  if (!thread) {
+    pooled->owned_thread = rtc::Thread::CreateWithSocketServer();
+    pooled->owned_thread->Start();
+    // Like the factory's network thread, see ChannelManager::Init.
+    pooled->owned_thread->Invoke<bool>(
+        RTC_FROM_HERE, rtc::Bind(&rtc::Thread::SetAllowBlockingCalls,
+                                 pooled->owned_thread.get(), false));
+    thread = pooled->owned_thread.get();
+  }
+  pooled->thread = thread;
+  pooled->network_manager.reset(new rtc::BasicNetworkManager());
+  pooled->socket_factory.reset(new rtc::BasicPacketSocketFactory(thread));
+  network_thread_pool_.push_back(std::move(pooled));
+  return network_thread_pool_.back().get();
+}
+
+PeerConnectionFactory::PooledNetworkThread*
+PeerConnectionFactory::SelectNetworkThread() {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  RTC_DCHECK(!network_thread_pool_.empty());
+  // If the pool has shrunk, PeerConnections stay on the threads beyond the
+  // pool size but no new ones are assigned to them.
+  size_t pool_size =
+      static_cast<size_t>(std::max(1, options_.network_thread_pool_size));
+  PooledNetworkThread* selected = network_thread_pool_[0].get();
+  for (size_t i = 1; i < std::min(pool_size, network_thread_pool_.size());
+       ++i) {
+    if (network_thread_pool_[i]->num_peer_connections <
+        selected->num_peer_connections) {
+      selected = network_thread_pool_[i].get();
+    }
+  }
+  if (selected->num_peer_connections > 0 &&
+      network_thread_pool_.size() < pool_size) {
+    selected = AddPooledNetworkThread(nullptr);
+  }
+  return selected;
+}
+
 }  // namespace webrtc
@@ -13,6 +13,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "api/mediastreaminterface.h"
 #include "api/peerconnectioninterface.h"
@@ -97,6 +98,7 @@ class PeerConnectionFactory : public PeerConnectionFactoryInterface {
 
   virtual cricket::TransportController* CreateTransportController(
       cricket::PortAllocator* port_allocator,
+      rtc::Thread* network_thread,
       bool redetermine_role_on_ice_restart);
   virtual cricket::ChannelManager* channel_manager();
   virtual rtc::Thread* signaling_thread();
@@ -104,6 +106,10 @@ class PeerConnectionFactory : public PeerConnectionFactoryInterface {
   virtual rtc::Thread* network_thread();
   const Options& options() const { return options_; }
 
+  // Called by a PeerConnection when it's destroyed, to release the network
+  // thread it was assigned when it was created.
+  void ReleaseNetworkThread(rtc::Thread* network_thread);
+
  protected:
   PeerConnectionFactory(
       rtc::Thread* network_thread,
@@ -117,8 +123,24 @@ class PeerConnectionFactory : public PeerConnectionFactoryInterface {
   virtual ~PeerConnectionFactory();
 
  private:
+  // A network thread that PeerConnections can be assigned to, with the
+  // network manager and socket factory used by the default PortAllocator on
+  // that thread.
+  struct PooledNetworkThread {
+    rtc::Thread* thread = nullptr;
+    std::unique_ptr<rtc::Thread> owned_thread;
+    std::unique_ptr<rtc::BasicNetworkManager> network_manager;
+    std::unique_ptr<rtc::BasicPacketSocketFactory> socket_factory;
+    int num_peer_connections = 0;
+  };
+
   std::unique_ptr<RtcEventLog> CreateRtcEventLog_w();
   std::unique_ptr<Call> CreateCall_w(RtcEventLog* event_log);
+  // Adds |thread| to the network thread pool, or a new thread if null.
+  PooledNetworkThread* AddPooledNetworkThread(rtc::Thread* thread);
+  // Returns the pooled network thread with the fewest PeerConnections,
+  // starting a new one if the pool isn't full and all threads are in use.
+  PooledNetworkThread* SelectNetworkThread();
 
   bool wraps_current_thread_;
   rtc::Thread* network_thread_;
@@ -134,8 +156,8 @@ class PeerConnectionFactory : public PeerConnectionFactoryInterface {
   // External Video decoder factory. This can be NULL if the client has not
   // injected any. In that case, video engine will use the internal SW decoder.
   std::unique_ptr<cricket::WebRtcVideoDecoderFactory> video_decoder_factory_;
-  std::unique_ptr<rtc::BasicNetworkManager> default_network_manager_;
-  std::unique_ptr<rtc::BasicPacketSocketFactory> default_socket_factory_;
+  // The first thread is |network_thread_|.
+  std::vector<std::unique_ptr<PooledNetworkThread>> network_thread_pool_;
   std::unique_ptr<cricket::MediaEngineInterface> media_engine_;
   std::unique_ptr<webrtc::CallFactoryInterface> call_factory_;
   std::unique_ptr<RtcEventLogFactoryInterface> event_log_factory_;
@@ -684,7 +684,9 @@ class PeerConnectionFactoryForTest : public webrtc::PeerConnectionFactory {
 
   cricket::TransportController* CreateTransportController(
       cricket::PortAllocator* port_allocator,
+      rtc::Thread* network_thread,
       bool redetermine_role_on_ice_restart) override {
+    network_threads.push_back(network_thread);
     transport_controller = new cricket::TransportController(
         rtc::Thread::Current(), rtc::Thread::Current(), port_allocator,
         redetermine_role_on_ice_restart, rtc::CryptoOptions());
@@ -693,6 +695,8 @@ class PeerConnectionFactoryForTest : public webrtc::PeerConnectionFactory {
 
   rtc::scoped_refptr<FakeAudioCaptureModule> fake_audio_capture_module_;
   cricket::TransportController* transport_controller;
+  // The network thread assigned to each created PeerConnection.
+  std::vector<rtc::Thread*> network_threads;
 };
 
 class PeerConnectionInterfaceTest : public testing::Test {
@@ -3941,6 +3945,40 @@ TEST_F(PeerConnectionMediaConfigTest,
   EXPECT_TRUE(media_config.video.suspend_below_min_bitrate);
 }
 
+// Tests that PeerConnections using the default port allocator are spread over
+// the network thread pool, and that threads are reused once released.
+TEST(PeerConnectionNetworkThreadPoolTest, SpreadsPeerConnectionsOverPool) {
+  rtc::scoped_refptr<PeerConnectionFactoryForTest> pcf =
+      PeerConnectionFactoryForTest::CreatePeerConnectionFactoryForTest();
+  ASSERT_TRUE(pcf->Initialize());
+  webrtc::PeerConnectionFactoryInterface::Options options;
+  options.network_thread_pool_size = 2;
+  pcf->SetOptions(options);
+
+  PeerConnectionInterface::RTCConfiguration config;
+  MockPeerConnectionObserver observer;
+  rtc::scoped_refptr<PeerConnectionInterface> pc1(
+      pcf->CreatePeerConnection(config, nullptr, nullptr, &observer));
+  rtc::scoped_refptr<PeerConnectionInterface> pc2(
+      pcf->CreatePeerConnection(config, nullptr, nullptr, &observer));
+  ASSERT_TRUE(pc1 && pc2);
+  ASSERT_EQ(2u, pcf->network_threads.size());
+  EXPECT_EQ(pcf->network_thread(), pcf->network_threads[0]);
+  EXPECT_NE(pcf->network_thread(), pcf->network_threads[1]);
+
+  // Each new PeerConnection goes to the thread released last.
+  pc1 = nullptr;
+  rtc::scoped_refptr<PeerConnectionInterface> pc3(
+      pcf->CreatePeerConnection(config, nullptr, nullptr, &observer));
+  pc2 = nullptr;
+  rtc::scoped_refptr<PeerConnectionInterface> pc4(
+      pcf->CreatePeerConnection(config, nullptr, nullptr, &observer));
+  ASSERT_TRUE(pc3 && pc4);
+  ASSERT_EQ(4u, pcf->network_threads.size());
+  EXPECT_EQ(pcf->network_thread(), pcf->network_threads[2]);
+  EXPECT_EQ(pcf->network_threads[1], pcf->network_threads[3]);
+}
+
 // Tests a few random fields being different.
 TEST(RTCConfigurationTest, ComparisonOperators) {
   PeerConnectionInterface::RTCConfiguration a;
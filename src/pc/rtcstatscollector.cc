@@ -585,6 +585,12 @@ rtc::scoped_refptr<RTCStatsCollector> RTCStatsCollector::Create(
       new rtc::RefCountedObject<RTCStatsCollector>(pc, cache_lifetime_us));
 }
 
+rtc::scoped_refptr<RTCStatsCollector::DeltaStatsBase>
+RTCStatsCollector::DeltaStatsBase::Create() {
+  return rtc::scoped_refptr<DeltaStatsBase>(
+      new rtc::RefCountedObject<DeltaStatsBase>());
+}
+
 RTCStatsCollector::RTCStatsCollector(PeerConnection* pc,
                                      int64_t cache_lifetime_us)
     : pc_(pc),
@@ -613,7 +619,21 @@ void RTCStatsCollector::GetStatsReport(
   RTC_DCHECK(signaling_thread_->IsCurrent());
   RTC_DCHECK(callback);
   callbacks_.push_back(callback);
+  RequestStatsReport();
+}
 
+void RTCStatsCollector::GetDeltaStatsReport(
+    rtc::scoped_refptr<DeltaStatsBase> base,
+    rtc::scoped_refptr<RTCStatsCollectorCallback> callback) {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  RTC_DCHECK(base);
+  RTC_DCHECK(callback);
+  delta_requests_.push_back(std::make_pair(base, callback));
+  RequestStatsReport();
+}
+
+void RTCStatsCollector::RequestStatsReport() {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
   // "Now" using a monotonically increasing timer.
   int64_t cache_now_us = rtc::TimeMicros();
   if (cached_report_ &&
@@ -776,13 +796,23 @@ void RTCStatsCollector::AddPartialResults_s(
 
 void RTCStatsCollector::DeliverCachedReport() {
   RTC_DCHECK(signaling_thread_->IsCurrent());
-  RTC_DCHECK(!callbacks_.empty());
+  RTC_DCHECK(!callbacks_.empty() || !delta_requests_.empty());
   RTC_DCHECK(cached_report_);
   for (const rtc::scoped_refptr<RTCStatsCollectorCallback>& callback :
        callbacks_) {
     callback->OnStatsDelivered(cached_report_);
   }
   callbacks_.clear();
+
+  for (const auto& request : delta_requests_) {
+    DeltaStatsBase* base = request.first.get();
+    rtc::scoped_refptr<const RTCStatsReport> delta_report = cached_report_;
+    if (base->report_)
+      delta_report = cached_report_->CreateDelta(*base->report_);
+    base->report_ = cached_report_;
+    request.second->OnStatsDelivered(delta_report);
+  }
+  delta_requests_.clear();
 }
 
 void RTCStatsCollector::ProduceCertificateStats_n(
@@ -14,6 +14,7 @@
 #include <map>
 #include <memory>
 #include <set>
+#include <utility>
 #include <vector>
 
 #include "api/optional.h"
@@ -61,6 +62,32 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
   // considered fresh for |cache_lifetime_| ms. const RTCStatsReports are safe
   // to use across multiple threads and may be destructed on any thread.
   void GetStatsReport(rtc::scoped_refptr<RTCStatsCollectorCallback> callback);
+  // The report that a caller of |GetDeltaStatsReport| was last delivered,
+  // which its next delta report is computed against. Each caller uses its own,
+  // so that callers polling at different rates get correct deltas.
+  class DeltaStatsBase : public rtc::RefCountInterface {
+   public:
+    static rtc::scoped_refptr<DeltaStatsBase> Create();
+
+   protected:
+    DeltaStatsBase() {}
+    ~DeltaStatsBase() override {}
+
+   private:
+    friend class RTCStatsCollector;
+    rtc::scoped_refptr<const RTCStatsReport> report_;
+  };
+
+  // Like |GetStatsReport|, but delivers only what has changed since the
+  // previous report delivered with the same |base|: stats objects that are new
+  // or that have changed, with only their changed members defined, and the IDs
+  // of the ones that have been removed (see |RTCStatsReport::CreateDelta|). The
+  // first call with a |base| delivers a full report. Intended for callers that
+  // poll stats frequently and forward them, which would otherwise have to
+  // serialize and transmit the full report each time.
+  void GetDeltaStatsReport(
+      rtc::scoped_refptr<DeltaStatsBase> base,
+      rtc::scoped_refptr<RTCStatsCollectorCallback> callback);
   // Clears the cache's reference to the most recent stats report. Subsequently
   // calling |GetStatsReport| guarantees fresh stats.
   void ClearCachedStatsReport();
@@ -88,6 +115,9 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
     std::unique_ptr<rtc::SSLCertificateStats> remote;
   };
 
+  // Delivers the cached report if it is fresh, otherwise starts gathering
+  // stats unless that is already in progress.
+  void RequestStatsReport();
   void AddPartialResults_s(rtc::scoped_refptr<RTCStatsReport> partial_report);
   void DeliverCachedReport();
 
@@ -149,6 +179,9 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
   int64_t partial_report_timestamp_us_;
   rtc::scoped_refptr<RTCStatsReport> partial_report_;
   std::vector<rtc::scoped_refptr<RTCStatsCollectorCallback>> callbacks_;
+  std::vector<std::pair<rtc::scoped_refptr<DeltaStatsBase>,
+                        rtc::scoped_refptr<RTCStatsCollectorCallback>>>
+      delta_requests_;
 
   // Set in |GetStatsReport|, read in |ProducePartialResultsOnNetworkThread| and
   // |ProducePartialResultsOnSignalingThread|, reset after work is complete. Not
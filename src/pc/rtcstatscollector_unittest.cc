@@ -709,6 +709,51 @@ TEST_F(RTCStatsCollectorTest, MultipleCallbacksWithInvalidatedCacheInBetween) {
   EXPECT_NE(c.get(), b.get());
 }
 
+TEST_F(RTCStatsCollectorTest, DeltaStatsReports) {
+  rtc::scoped_refptr<RTCStatsCollector::DeltaStatsBase> base1 =
+      RTCStatsCollector::DeltaStatsBase::Create();
+  rtc::scoped_refptr<RTCStatsCollector::DeltaStatsBase> base2 =
+      RTCStatsCollector::DeltaStatsBase::Create();
+
+  // The first delta report is the full report.
+  rtc::scoped_refptr<const RTCStatsReport> full;
+  rtc::scoped_refptr<const RTCStatsReport> delta;
+  collector_->GetStatsReport(RTCStatsObtainer::Create(&full));
+  collector_->GetDeltaStatsReport(base1, RTCStatsObtainer::Create(&delta));
+  EXPECT_TRUE_WAIT(full, kGetStatsReportTimeoutMs);
+  EXPECT_TRUE_WAIT(delta, kGetStatsReportTimeoutMs);
+  EXPECT_EQ(full.get(), delta.get());
+  ASSERT_GT(full->size(), static_cast<size_t>(0));
+
+  // The cached report has not changed since the previous delta.
+  delta = nullptr;
+  collector_->GetDeltaStatsReport(base1, RTCStatsObtainer::Create(&delta));
+  EXPECT_TRUE_WAIT(delta, kGetStatsReportTimeoutMs);
+  EXPECT_EQ(delta->size(), static_cast<size_t>(0));
+  EXPECT_TRUE(delta->removed_ids().empty());
+
+  // Another caller has not been delivered a report yet, and gets the full
+  // report even though the first caller has been delivered it.
+  rtc::scoped_refptr<const RTCStatsReport> delta2;
+  collector_->GetDeltaStatsReport(base2, RTCStatsObtainer::Create(&delta2));
+  EXPECT_TRUE_WAIT(delta2, kGetStatsReportTimeoutMs);
+  EXPECT_EQ(full.get(), delta2.get());
+
+  // Nothing is producing new stats, so a fresh report only differs in the
+  // timestamps, which are not considered changes.
+  collector_->ClearCachedStatsReport();
+  delta = nullptr;
+  delta2 = nullptr;
+  collector_->GetDeltaStatsReport(base1, RTCStatsObtainer::Create(&delta));
+  collector_->GetDeltaStatsReport(base2, RTCStatsObtainer::Create(&delta2));
+  EXPECT_TRUE_WAIT(delta, kGetStatsReportTimeoutMs);
+  EXPECT_TRUE_WAIT(delta2, kGetStatsReportTimeoutMs);
+  EXPECT_NE(full.get(), delta.get());
+  EXPECT_EQ(delta->size(), static_cast<size_t>(0));
+  EXPECT_TRUE(delta->removed_ids().empty());
+  EXPECT_EQ(delta2->size(), static_cast<size_t>(0));
+}
+
 TEST_F(RTCStatsCollectorTest, CollectRTCCertificateStatsSingle) {
   std::unique_ptr<CertificateInfo> local_certinfo =
       CreateFakeCertificateAndInfoFromDers(
@@ -11,6 +11,7 @@
 #include "pc/rtptransport.h"
 
 #include "media/base/rtputils.h"
+#include "p2p/base/dtlstransportinternal.h"
 #include "p2p/base/packettransportinterface.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/copyonwritebuffer.h"
@@ -31,14 +32,20 @@ void RtpTransport::SetRtpPacketTransport(
   if (rtp_packet_transport_) {
     rtp_packet_transport_->SignalReadyToSend.disconnect(this);
     rtp_packet_transport_->SignalReadPacket.disconnect(this);
+    rtp_packet_transport_->SignalSrtpBypassTransportChanged.disconnect(this);
   }
   if (new_packet_transport) {
     new_packet_transport->SignalReadyToSend.connect(
         this, &RtpTransport::OnReadyToSend);
     new_packet_transport->SignalReadPacket.connect(this,
                                                    &RtpTransport::OnReadPacket);
+    new_packet_transport->SignalSrtpBypassTransportChanged.connect(
+        this, &RtpTransport::OnSrtpBypassTransportChanged);
   }
   rtp_packet_transport_ = new_packet_transport;
+  rtp_bypass_transport_ =
+      new_packet_transport ? new_packet_transport->srtp_bypass_transport()
+                           : nullptr;
 
   // Assumes the transport is ready to send if it is writable. If we are wrong,
   // ready to send will be updated the next time we try to send.
@@ -54,14 +61,20 @@ void RtpTransport::SetRtcpPacketTransport(
   if (rtcp_packet_transport_) {
     rtcp_packet_transport_->SignalReadyToSend.disconnect(this);
     rtcp_packet_transport_->SignalReadPacket.disconnect(this);
+    rtcp_packet_transport_->SignalSrtpBypassTransportChanged.disconnect(this);
   }
   if (new_packet_transport) {
     new_packet_transport->SignalReadyToSend.connect(
         this, &RtpTransport::OnReadyToSend);
     new_packet_transport->SignalReadPacket.connect(this,
                                                    &RtpTransport::OnReadPacket);
+    new_packet_transport->SignalSrtpBypassTransportChanged.connect(
+        this, &RtpTransport::OnSrtpBypassTransportChanged);
   }
   rtcp_packet_transport_ = new_packet_transport;
+  rtcp_bypass_transport_ =
+      new_packet_transport ? new_packet_transport->srtp_bypass_transport()
+                           : nullptr;
 
   // Assumes the transport is ready to send if it is writable. If we are wrong,
   // ready to send will be updated the next time we try to send.
@@ -80,9 +93,20 @@ bool RtpTransport::SendPacket(bool rtcp,
                               rtc::CopyOnWriteBuffer* packet,
                               const rtc::PacketOptions& options,
                               int flags) {
-  rtc::PacketTransportInternal* transport = rtcp && !rtcp_mux_enabled_
-                                                ? rtcp_packet_transport_
-                                                : rtp_packet_transport_;
+  bool use_rtcp_transport = rtcp && !rtcp_mux_enabled_;
+  rtc::PacketTransportInternal* transport =
+      use_rtcp_transport ? rtcp_packet_transport_ : rtp_packet_transport_;
+  if (flags & cricket::PF_SRTP_BYPASS) {
+    rtc::PacketTransportInternal* bypass_transport =
+        use_rtcp_transport ? rtcp_bypass_transport_ : rtp_bypass_transport_;
+    // Same check as DtlsTransport does before bypassing DTLS, so that nothing
+    // but SRTP ever goes out unencrypted.
+    if (bypass_transport &&
+        cricket::IsRtpPacket(packet->data(), packet->size())) {
+      transport = bypass_transport;
+      flags = cricket::PF_NORMAL;
+    }
+  }
   int ret = transport->SendPacket(packet->data<char>(), packet->size(), options,
                                   flags);
   if (ret != static_cast<int>(packet->size())) {
@@ -149,6 +173,16 @@ void RtpTransport::OnReadyToSend(rtc::PacketTransportInternal* transport) {
   SetReadyToSend(transport == rtcp_packet_transport_, true);
 }
 
+void RtpTransport::OnSrtpBypassTransportChanged(
+    rtc::PacketTransportInternal* transport) {
+  if (transport == rtp_packet_transport_) {
+    rtp_bypass_transport_ = transport->srtp_bypass_transport();
+  }
+  if (transport == rtcp_packet_transport_) {
+    rtcp_bypass_transport_ = transport->srtp_bypass_transport();
+  }
+}
+
 void RtpTransport::SetReadyToSend(bool rtcp, bool ready) {
   if (rtcp) {
     rtcp_ready_to_send_ = ready;
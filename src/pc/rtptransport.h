@@ -74,6 +74,12 @@ class RtpTransport : public RtpTransportInternal {
 
   void OnReadyToSend(rtc::PacketTransportInternal* transport);
 
+  // Re-resolves the cached SRTP bypass transport of |transport|; called once
+  // per DTLS state change instead of once per packet. The bypass transport is
+  // the ICE transport itself, which picks the selected connection on each
+  // send, so selected connection changes don't invalidate it.
+  void OnSrtpBypassTransportChanged(rtc::PacketTransportInternal* transport);
+
   // Updates "ready to send" for an individual channel and fires
   // SignalReadyToSend.
   void SetReadyToSend(bool rtcp, bool ready);
@@ -93,6 +99,12 @@ class RtpTransport : public RtpTransportInternal {
   rtc::PacketTransportInternal* rtp_packet_transport_ = nullptr;
   rtc::PacketTransportInternal* rtcp_packet_transport_ = nullptr;
 
+  // Where already protected SRTP packets can be written directly, bypassing
+  // the DTLS layer of |rtp_packet_transport_| and |rtcp_packet_transport_|.
+  // Null if no such shortcut is currently available.
+  rtc::PacketTransportInternal* rtp_bypass_transport_ = nullptr;
+  rtc::PacketTransportInternal* rtcp_bypass_transport_ = nullptr;
+
   bool ready_to_send_ = false;
   bool rtp_ready_to_send_ = false;
   bool rtcp_ready_to_send_ = false;
@@ -10,10 +10,14 @@
 
 #include <string>
 
+#include "p2p/base/dtlstransportinternal.h"
 #include "p2p/base/fakepackettransport.h"
 #include "pc/rtptransport.h"
 #include "pc/rtptransporttestutil.h"
+#include "rtc_base/copyonwritebuffer.h"
 #include "rtc_base/gunit.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/timeutils.h"
 
 namespace webrtc {
 
@@ -222,4 +226,129 @@ TEST(RtpTransportTest, DontSignalUnhandledRtpPayloadType) {
   EXPECT_EQ(0, observer.rtcp_count());
 }
 
+// Stands in for a DTLS transport layered on top of |inner|: packets sent to it
+// are forwarded to |inner|, and once "connected" it reports |inner| as the
+// transport SRTP packets may bypass it to.
+class LayeredPacketTransport : public rtc::FakePacketTransport {
+ public:
+  LayeredPacketTransport(const std::string& debug_name,
+                         rtc::FakePacketTransport* inner)
+      : rtc::FakePacketTransport(debug_name), inner_(inner) {
+    SetWritable(true);
+  }
+
+  void SetConnected(bool connected) {
+    connected_ = connected;
+    SignalSrtpBypassTransportChanged(this);
+  }
+  int sent_count() const { return sent_count_; }
+
+  int SendPacket(const char* data,
+                 size_t len,
+                 const rtc::PacketOptions& options,
+                 int flags) override {
+    ++sent_count_;
+    return inner_->SendPacket(data, len, options, cricket::PF_NORMAL);
+  }
+  rtc::PacketTransportInternal* srtp_bypass_transport() override {
+    return connected_ ? inner_ : nullptr;
+  }
+
+ private:
+  rtc::FakePacketTransport* const inner_;
+  bool connected_ = false;
+  int sent_count_ = 0;
+};
+
+// Counts the packets sent on a transport.
+class SentPacketCounter : public sigslot::has_slots<> {
+ public:
+  explicit SentPacketCounter(rtc::PacketTransportInternal* transport) {
+    transport->SignalSentPacket.connect(this,
+                                        &SentPacketCounter::OnSentPacket);
+  }
+  int count() const { return count_; }
+  void OnSentPacket(rtc::PacketTransportInternal* transport,
+                    const rtc::SentPacket& sent_packet) {
+    ++count_;
+  }
+
+ private:
+  int count_ = 0;
+};
+
+TEST(RtpTransportTest, SrtpPacketsBypassLayeredTransportOnceConnected) {
+  RtpTransport transport(kMuxEnabled);
+  rtc::FakePacketTransport fake_ice("fake_ice");
+  fake_ice.SetDestination(&fake_ice, true);
+  SentPacketCounter ice_sent(&fake_ice);
+  LayeredPacketTransport fake_dtls("fake_dtls", &fake_ice);
+  transport.SetRtpPacketTransport(&fake_dtls);
+
+  rtc::CopyOnWriteBuffer packet(kRtpData, kRtpLen);
+  const rtc::PacketOptions options;
+  EXPECT_TRUE(
+      transport.SendPacket(false, &packet, options, cricket::PF_SRTP_BYPASS));
+  EXPECT_EQ(1, fake_dtls.sent_count());
+  EXPECT_EQ(1, ice_sent.count());
+
+  // Once connected, SRTP packets are written to the ICE transport directly.
+  fake_dtls.SetConnected(true);
+  EXPECT_TRUE(
+      transport.SendPacket(false, &packet, options, cricket::PF_SRTP_BYPASS));
+  EXPECT_EQ(1, fake_dtls.sent_count());
+  EXPECT_EQ(2, ice_sent.count());
+
+  // Packets that are not flagged as SRTP still go through the DTLS transport.
+  EXPECT_TRUE(transport.SendPacket(false, &packet, options, cricket::PF_NORMAL));
+  EXPECT_EQ(2, fake_dtls.sent_count());
+  EXPECT_EQ(3, ice_sent.count());
+
+  fake_dtls.SetConnected(false);
+  EXPECT_TRUE(
+      transport.SendPacket(false, &packet, options, cricket::PF_SRTP_BYPASS));
+  EXPECT_EQ(3, fake_dtls.sent_count());
+  EXPECT_EQ(4, ice_sent.count());
+}
+
+TEST(RtpTransportTest, NonRtpPacketsDoNotBypassLayeredTransport) {
+  RtpTransport transport(kMuxEnabled);
+  rtc::FakePacketTransport fake_ice("fake_ice");
+  fake_ice.SetDestination(&fake_ice, true);
+  LayeredPacketTransport fake_dtls("fake_dtls", &fake_ice);
+  fake_dtls.SetConnected(true);
+  transport.SetRtpPacketTransport(&fake_dtls);
+
+  const uint8_t kNotRtp[] = {0x16, 0xfe, 0xfd, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+  rtc::CopyOnWriteBuffer packet(kNotRtp, sizeof(kNotRtp));
+  const rtc::PacketOptions options;
+  transport.SendPacket(false, &packet, options, cricket::PF_SRTP_BYPASS);
+  EXPECT_EQ(1, fake_dtls.sent_count());
+}
+
+// Measures the cost of the send chain with and without the SRTP bypass.
+// Disabled by default to avoid unnecessarily loading the bots.
+TEST(RtpTransportTest, DISABLED_SrtpBypassSendPerformance) {
+  static const int kNumPackets = 1000000;
+  const rtc::PacketOptions options;
+  for (bool bypass : {false, true}) {
+    RtpTransport transport(kMuxEnabled);
+    rtc::FakePacketTransport fake_ice("fake_ice");
+    rtc::FakePacketTransport fake_sink("fake_sink");
+    fake_ice.SetDestination(&fake_sink, true);
+    LayeredPacketTransport fake_dtls("fake_dtls", &fake_ice);
+    fake_dtls.SetConnected(bypass);
+    transport.SetRtpPacketTransport(&fake_dtls);
+
+    rtc::CopyOnWriteBuffer packet(kRtpData, kRtpLen);
+    int64_t start_ns = rtc::TimeNanos();
+    for (int i = 0; i < kNumPackets; ++i) {
+      transport.SendPacket(false, &packet, options, cricket::PF_SRTP_BYPASS);
+    }
+    int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+    LOG(LS_INFO) << "SendPacket with bypass " << (bypass ? "on" : "off")
+                 << ": " << elapsed_ns / kNumPackets << " ns/packet";
+  }
+}
+
 }  // namespace webrtc
@@ -376,6 +376,29 @@ void ExtractRemoteStats(const cricket::MediaReceiverInfo& info,
   // TODO(hta): Extract some stats here.
 }
 
+// Adds the candidate gathering milestones that have been reached to |report|.
+void AddCandidateGatheringTimes(const cricket::CandidateGatheringTimes& times,
+                                StatsReport* report) {
+  const struct {
+    StatsReport::StatsValueName name;
+    int64_t value;
+  } times_ms[] = {
+    { StatsReport::kStatsValueNameCandidateGatheringUdpPhaseMs,
+      times.udp_phase_ms },
+    { StatsReport::kStatsValueNameCandidateGatheringRelayPhaseMs,
+      times.relay_phase_ms },
+    { StatsReport::kStatsValueNameCandidateGatheringTcpPhaseMs,
+      times.tcp_phase_ms },
+    { StatsReport::kStatsValueNameCandidateGatheringFirstCandidateMs,
+      times.first_candidate_ms },
+    { StatsReport::kStatsValueNameCandidateGatheringDoneMs, times.done_ms },
+  };
+  for (const auto& t : times_ms) {
+    if (t.value >= 0)
+      report->AddInt64(t.name, t.value);
+  }
+}
+
 // Template to extract stats from a data vector.
 // In order to use the template, the functions that are called from it,
 // ExtractStats and ExtractRemoteStats, must be defined and overloaded
@@ -810,6 +833,7 @@ void StatsCollector::ExtractSessionInfo() {
             StatsReport::kStatsValueNameDtlsCipher,
             rtc::SSLStreamAdapter::SslCipherSuiteToName(ssl_cipher_suite));
       }
+      AddCandidateGatheringTimes(channel_iter.gathering_times, channel_report);
 
       int connection_id = 0;
       for (const cricket::ConnectionInfo& info :
@@ -1627,6 +1627,65 @@ TEST_F(StatsCollectorTest, NoTransport) {
   ASSERT_EQ(kNotFound, srtp_crypto_suite);
 }
 
+// This test verifies that the candidate gathering times that have been reached
+// are reported in the component report.
+TEST_F(StatsCollectorTest, CandidateGatheringTimesReported) {
+  StatsCollectorForTest stats(&pc_);
+
+  EXPECT_CALL(session_, GetLocalCertificate(_, _))
+      .WillRepeatedly(Return(false));
+  EXPECT_CALL(session_, GetRemoteSSLCertificate_ReturnsRawPointer(_))
+      .WillRepeatedly(Return(nullptr));
+
+  StatsReports reports;  // returned values.
+
+  // Fake stats to process. The TCP phase and the end of gathering haven't
+  // been reached yet.
+  cricket::TransportChannelStats channel_stats;
+  channel_stats.component = 1;
+  channel_stats.gathering_times.udp_phase_ms = 0;
+  channel_stats.gathering_times.relay_phase_ms = 50;
+  channel_stats.gathering_times.first_candidate_ms = 12;
+
+  cricket::TransportStats transport_stats;
+  transport_stats.transport_name = "audio";
+  transport_stats.channel_stats.push_back(channel_stats);
+
+  SessionStats session_stats;
+  session_stats.transport_stats[transport_stats.transport_name] =
+      transport_stats;
+
+  EXPECT_CALL(session_, GetStats(_)).WillRepeatedly(Invoke(
+      [&session_stats](const ChannelNamePairs&) {
+        return std::unique_ptr<SessionStats>(
+            new SessionStats(session_stats));
+      }));
+
+  stats.UpdateStats(PeerConnectionInterface::kStatsOutputLevelStandard);
+  stats.GetStats(NULL, &reports);
+
+  EXPECT_EQ("0", ExtractStatsValue(
+                     StatsReport::kStatsReportTypeComponent, reports,
+                     StatsReport::kStatsValueNameCandidateGatheringUdpPhaseMs));
+  EXPECT_EQ("50",
+            ExtractStatsValue(
+                StatsReport::kStatsReportTypeComponent, reports,
+                StatsReport::kStatsValueNameCandidateGatheringRelayPhaseMs));
+  EXPECT_EQ(
+      "12",
+      ExtractStatsValue(
+          StatsReport::kStatsReportTypeComponent, reports,
+          StatsReport::kStatsValueNameCandidateGatheringFirstCandidateMs));
+  EXPECT_EQ(kNotFound,
+            ExtractStatsValue(
+                StatsReport::kStatsReportTypeComponent, reports,
+                StatsReport::kStatsValueNameCandidateGatheringTcpPhaseMs));
+  EXPECT_EQ(kNotFound,
+            ExtractStatsValue(
+                StatsReport::kStatsReportTypeComponent, reports,
+                StatsReport::kStatsValueNameCandidateGatheringDoneMs));
+}
+
 // This test verifies that the stats are generated correctly when the transport
 // does not have any certificates.
 TEST_F(StatsCollectorTest, NoCertificates) {
@@ -42,6 +42,14 @@ class FakeDataChannelProvider : public webrtc::DataChannelProviderInterface {
     return true;
   }
 
+  size_t SendDataBulk(const cricket::SendDataParams& params,
+                      const std::vector<rtc::CopyOnWriteBuffer>& payloads,
+                      cricket::SendDataResult* result) override {
+    ++bulk_send_count_;
+    return webrtc::DataChannelProviderInterface::SendDataBulk(params, payloads,
+                                                              result);
+  }
+
   bool ConnectDataChannel(webrtc::DataChannel* data_channel) override {
     RTC_CHECK(connected_channels_.find(data_channel) ==
               connected_channels_.end());
@@ -123,6 +131,8 @@ class FakeDataChannelProvider : public webrtc::DataChannelProviderInterface {
     return last_send_data_params_;
   }
 
+  int bulk_send_count() const { return bulk_send_count_; }
+
   bool IsConnected(webrtc::DataChannel* data_channel) const {
     return connected_channels_.find(data_channel) != connected_channels_.end();
   }
@@ -144,5 +154,6 @@ class FakeDataChannelProvider : public webrtc::DataChannelProviderInterface {
   std::set<webrtc::DataChannel*> connected_channels_;
   std::set<uint32_t> send_ssrcs_;
   std::set<uint32_t> recv_ssrcs_;
+  int bulk_send_count_ = 0;
 };
 #endif  // PC_TEST_FAKEDATACHANNELPROVIDER_H_
@@ -43,6 +43,7 @@ class MockPeerConnection
   MockPeerConnection()
       : rtc::RefCountedObject<webrtc::PeerConnection>(
             new FakePeerConnectionFactory(),
+            rtc::Thread::Current(),
             std::unique_ptr<RtcEventLog>(),
             std::unique_ptr<Call>()) {}
   MOCK_METHOD0(local_streams,
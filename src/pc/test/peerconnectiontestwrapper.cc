@@ -87,6 +87,18 @@ bool PeerConnectionTestWrapper::CreatePc(
   return peer_connection_.get() != NULL;
 }
 
+bool PeerConnectionTestWrapper::CreatePcWithFactory(
+    rtc::scoped_refptr<webrtc::PeerConnectionFactoryInterface> factory,
+    const webrtc::PeerConnectionInterface::RTCConfiguration& config) {
+  peer_connection_factory_ = factory;
+  std::unique_ptr<rtc::RTCCertificateGeneratorInterface> cert_generator(
+      new FakeRTCCertificateGenerator());
+  peer_connection_ = peer_connection_factory_->CreatePeerConnection(
+      config, nullptr, std::move(cert_generator), this);
+
+  return peer_connection_.get() != NULL;
+}
+
 rtc::scoped_refptr<webrtc::DataChannelInterface>
 PeerConnectionTestWrapper::CreateDataChannel(
     const std::string& label,
@@ -37,6 +37,12 @@ class PeerConnectionTestWrapper
       const webrtc::PeerConnectionInterface::RTCConfiguration& config,
       rtc::scoped_refptr<webrtc::AudioEncoderFactory> audio_encoder_factory,
       rtc::scoped_refptr<webrtc::AudioDecoderFactory> audio_decoder_factory);
+  // Creates the PeerConnection with a factory shared with other wrappers and
+  // the factory's default port allocator, so that the factory picks its
+  // network thread.
+  bool CreatePcWithFactory(
+      rtc::scoped_refptr<webrtc::PeerConnectionFactoryInterface> factory,
+      const webrtc::PeerConnectionInterface::RTCConfiguration& config);
 
   webrtc::PeerConnectionInterface* pc() { return peer_connection_.get(); }
 
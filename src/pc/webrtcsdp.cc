@@ -442,7 +442,8 @@ static bool GetLine(const std::string& message,
   if (line_end > 0 && (message.at(line_end - 1) == kReturn)) {
     --line_end;
   }
-  *line = message.substr(line_begin, (line_end - line_begin));
+  // Reuse the capacity of |line| rather than allocating a new string.
+  line->assign(message, line_begin, line_end - line_begin);
   const char* cline = line->c_str();
   // RFC 4566
   // An SDP session description consists of a number of lines of text of
@@ -511,9 +512,10 @@ static bool GetLineWithType(const std::string& message, size_t* pos,
   return true;
 }
 
-static bool HasAttribute(const std::string& line,
-                         const std::string& attribute) {
-  return (line.compare(kLinePrefixLength, attribute.size(), attribute) == 0);
+// Takes the attribute as a C string, since every line is checked against many
+// attributes and a temporary std::string for each check adds up.
+static bool HasAttribute(const std::string& line, const char* attribute) {
+  return (line.compare(kLinePrefixLength, strlen(attribute), attribute) == 0);
 }
 
 static bool AddSsrcLine(uint32_t ssrc_id,
@@ -2570,40 +2572,21 @@ void AddFeedbackParameters(const cricket::FeedbackParams& feedback_params,
   }
 }
 
-// Gets the current codec setting associated with |payload_type|. If there
-// is no Codec associated with that payload type it returns an empty codec
-// with that payload type.
-template <class T>
-T GetCodecWithPayloadType(const std::vector<T>& codecs, int payload_type) {
-  const T* codec = FindCodecById(codecs, payload_type);
-  if (codec)
-    return *codec;
-  // Return empty codec with |payload_type|.
-  T ret_val;
-  ret_val.id = payload_type;
-  return ret_val;
-}
-
-// Updates or creates a new codec entry in the audio description.
+// Gets the codec associated with |payload_type| for updating it in place. If
+// there is no Codec associated with that payload type, an empty codec with
+// that payload type is added first.
 template <class T, class U>
-void AddOrReplaceCodec(MediaContentDescription* content_desc, const U& codec) {
-  T* desc = static_cast<T*>(content_desc);
-  std::vector<U> codecs = desc->codecs();
-  bool found = false;
-
-  typename std::vector<U>::iterator iter;
-  for (iter = codecs.begin(); iter != codecs.end(); ++iter) {
-    if (iter->id == codec.id) {
-      *iter = codec;
-      found = true;
-      break;
-    }
+U* GetOrAddCodecWithPayloadType(MediaContentDescription* content_desc,
+                                int payload_type) {
+  std::vector<U>& codecs = static_cast<T*>(content_desc)->mutable_codecs();
+  for (U& codec : codecs) {
+    if (codec.id == payload_type)
+      return &codec;
   }
-  if (!found) {
-    desc->AddCodec(codec);
-    return;
-  }
-  desc->set_codecs(codecs);
+  U new_codec;
+  new_codec.id = payload_type;
+  codecs.push_back(std::move(new_codec));
+  return &codecs.back();
 }
 
 // Adds or updates existing codec corresponding to |payload_type| according
@@ -2612,10 +2595,8 @@ template <class T, class U>
 void UpdateCodec(MediaContentDescription* content_desc, int payload_type,
                  const cricket::CodecParameterMap& parameters) {
   // Codec might already have been populated (from rtpmap).
-  U new_codec = GetCodecWithPayloadType(static_cast<T*>(content_desc)->codecs(),
-                                        payload_type);
-  AddParameters(parameters, &new_codec);
-  AddOrReplaceCodec<T, U>(content_desc, new_codec);
+  AddParameters(parameters,
+                GetOrAddCodecWithPayloadType<T, U>(content_desc, payload_type));
 }
 
 // Adds or updates existing codec corresponding to |payload_type| according
@@ -2624,10 +2605,9 @@ template <class T, class U>
 void UpdateCodec(MediaContentDescription* content_desc, int payload_type,
                  const cricket::FeedbackParam& feedback_param) {
   // Codec might already have been populated (from rtpmap).
-  U new_codec = GetCodecWithPayloadType(static_cast<T*>(content_desc)->codecs(),
-                                        payload_type);
-  AddFeedbackParameter(feedback_param, &new_codec);
-  AddOrReplaceCodec<T, U>(content_desc, new_codec);
+  AddFeedbackParameter(
+      feedback_param,
+      GetOrAddCodecWithPayloadType<T, U>(content_desc, payload_type));
 }
 
 template <class T>
@@ -2644,7 +2624,7 @@ bool PopWildcardCodec(std::vector<T>* codecs, T* wildcard_codec) {
 
 template<class T>
 void UpdateFromWildcardCodecs(cricket::MediaContentDescriptionImpl<T>* desc) {
-  auto codecs = desc->codecs();
+  std::vector<T>& codecs = desc->mutable_codecs();
   T wildcard_codec;
   if (!PopWildcardCodec(&codecs, &wildcard_codec)) {
     return;
@@ -2652,7 +2632,6 @@ void UpdateFromWildcardCodecs(cricket::MediaContentDescriptionImpl<T>* desc) {
   for (auto& codec : codecs) {
     AddFeedbackParameters(wildcard_codec.feedback_params, &codec);
   }
-  desc->set_codecs(codecs);
 }
 
 void AddAudioAttribute(const std::string& name, const std::string& value,
@@ -2660,12 +2639,9 @@ void AddAudioAttribute(const std::string& name, const std::string& value,
   if (value.empty()) {
     return;
   }
-  std::vector<cricket::AudioCodec> codecs = audio_desc->codecs();
-  for (std::vector<cricket::AudioCodec>::iterator iter = codecs.begin();
-       iter != codecs.end(); ++iter) {
-    iter->params[name] = value;
+  for (cricket::AudioCodec& codec : audio_desc->mutable_codecs()) {
+    codec.params[name] = value;
   }
-  audio_desc->set_codecs(codecs);
 }
 
 bool ParseContent(const std::string& message,
@@ -2703,6 +2679,10 @@ bool ParseContent(const std::string& message,
   std::string stream_id;
   std::string track_id;
 
+  // The protocol is the same for every line of the section.
+  const bool is_rtp = IsRtp(protocol);
+  const bool is_dtls_sctp = IsDtlsSctp(protocol);
+
   // Loop until the next m line
   while (!IsLineType(message, kLineTypeMedia, *pos)) {
     if (!GetLine(message, pos, &line)) {
@@ -2742,7 +2722,7 @@ bool ParseContent(const std::string& message,
           // data channels. Don't allow SDP to set the bandwidth, because
           // that would give JS the opportunity to "break the Internet".
           // See: https://code.google.com/p/chromium/issues/detail?id=280726
-          if (media_type == cricket::MEDIA_TYPE_DATA && IsRtp(protocol) &&
+          if (media_type == cricket::MEDIA_TYPE_DATA && is_rtp &&
               b > cricket::kDataMaxBandwidth / 1000) {
             std::ostringstream description;
             description << "RTP-based data channels may not send more than "
@@ -2824,7 +2804,7 @@ bool ParseContent(const std::string& message,
       if (!ParseDtlsSetup(line, &(transport->connection_role), error)) {
         return false;
       }
-    } else if (IsDtlsSctp(protocol) && HasAttribute(line, kAttributeSctpPort)) {
+    } else if (is_dtls_sctp && HasAttribute(line, kAttributeSctpPort)) {
       if (media_type != cricket::MEDIA_TYPE_DATA) {
         return ParseFailed(
             line, "sctp-port attribute found in non-data media description.",
@@ -2838,7 +2818,7 @@ bool ParseContent(const std::string& message,
                             sctp_port)) {
         return false;
       }
-    } else if (IsRtp(protocol)) {
+    } else if (is_rtp) {
       //
       // RTP specific attrubtes
       //
@@ -3125,14 +3105,14 @@ void UpdateCodec(int payload_type,
                  AudioContentDescription* audio_desc) {
   // Codec may already be populated with (only) optional parameters
   // (from an fmtp).
-  cricket::AudioCodec codec =
-      GetCodecWithPayloadType(audio_desc->codecs(), payload_type);
-  codec.name = name;
-  codec.clockrate = clockrate;
-  codec.bitrate = bitrate;
-  codec.channels = channels;
-  AddOrReplaceCodec<AudioContentDescription, cricket::AudioCodec>(audio_desc,
-                                                                  codec);
+  cricket::AudioCodec* codec =
+      GetOrAddCodecWithPayloadType<AudioContentDescription,
+                                   cricket::AudioCodec>(audio_desc,
+                                                        payload_type);
+  codec->name = name;
+  codec->clockrate = clockrate;
+  codec->bitrate = bitrate;
+  codec->channels = channels;
 }
 
 // Updates or creates a new codec entry in the video description according to
@@ -3142,11 +3122,8 @@ void UpdateCodec(int payload_type,
                  VideoContentDescription* video_desc) {
   // Codec may already be populated with (only) optional parameters
   // (from an fmtp).
-  cricket::VideoCodec codec =
-      GetCodecWithPayloadType(video_desc->codecs(), payload_type);
-  codec.name = name;
-  AddOrReplaceCodec<VideoContentDescription, cricket::VideoCodec>(video_desc,
-                                                                  codec);
+  GetOrAddCodecWithPayloadType<VideoContentDescription, cricket::VideoCodec>(
+      video_desc, payload_type)->name = name;
 }
 
 bool ParseRtpmapAttribute(const std::string& line,
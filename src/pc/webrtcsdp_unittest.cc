@@ -10,6 +10,7 @@
 
 #include <memory>
 #include <set>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -23,6 +24,7 @@
 #include "rtc_base/logging.h"
 #include "rtc_base/stringencode.h"
 #include "rtc_base/stringutils.h"
+#include "rtc_base/timeutils.h"
 
 #ifdef WEBRTC_ANDROID
 #include "pc/test/androidtestinitializer.h"
@@ -3602,3 +3604,146 @@ TEST_F(WebRtcSdpTest, SerializeAndDeserializeWithConnectionAddress) {
   EXPECT_EQ(video_desc_->connection_address().ToString(),
             video_desc->connection_address().ToString());
 }
+
+// Returns an offer the way a browser creates it for a session with
+// |num_participants| bundled audio and video senders, as an SFU sees it.
+static std::string CreateLargeBundleOffer(int num_participants) {
+  std::ostringstream os;
+  os << "v=0\r\n"
+     << "o=- 4962303333179871722 2 IN IP4 127.0.0.1\r\n"
+     << "s=-\r\n"
+     << "t=0 0\r\n"
+     << "a=group:BUNDLE";
+  for (int i = 0; i < num_participants; ++i)
+    os << " audio" << i << " video" << i;
+  os << "\r\n"
+     << "a=msid-semantic: WMS";
+  for (int i = 0; i < num_participants; ++i)
+    os << " stream" << i;
+  os << "\r\n";
+  const char kTransport[] =
+      "c=IN IP4 0.0.0.0\r\n"
+      "a=rtcp:9 IN IP4 0.0.0.0\r\n"
+      "a=candidate:1467250027 1 udp 2122260223 192.168.0.196 46243 typ host "
+      "generation 0 network-id 1 network-cost 10\r\n"
+      "a=candidate:435653019 1 tcp 1845501695 203.0.113.17 9 typ srflx raddr "
+      "192.168.0.196 rport 9 tcptype active generation 0 network-id 1\r\n"
+      "a=ice-ufrag:Oyef7uvBlwafI3hT\r\n"
+      "a=ice-pwd:T0teqPLNQQOf+5W+ls+P2p16\r\n"
+      "a=fingerprint:sha-256 49:66:12:17:0D:1C:91:AE:57:4C:C6:36:DD:D5:97:D2:"
+      "7D:62:C9:9A:7F:B9:A3:F4:70:03:E7:43:91:73:23:5E\r\n"
+      "a=setup:actpass\r\n";
+  for (int i = 0; i < num_participants; ++i) {
+    uint32_t audio_ssrc = 1000 + 10 * i;
+    uint32_t video_ssrc = audio_ssrc + 1;
+    uint32_t rtx_ssrc = audio_ssrc + 2;
+    os << "m=audio 9 UDP/TLS/RTP/SAVPF 111 103 104 9 0 8 106 105 13 110 126\r\n"
+       << kTransport << "a=mid:audio" << i << "\r\n"
+       << "a=extmap:1 urn:ietf:params:rtp-hdrext:ssrc-audio-level\r\n"
+       << "a=extmap:3 http://www.webrtc.org/experiments/rtp-hdrext/"
+          "abs-send-time\r\n"
+       << "a=sendrecv\r\n"
+       << "a=rtcp-mux\r\n"
+       << "a=rtpmap:111 opus/48000/2\r\n"
+       << "a=rtcp-fb:111 transport-cc\r\n"
+       << "a=fmtp:111 minptime=10;useinbandfec=1\r\n"
+       << "a=rtpmap:103 ISAC/16000\r\n"
+       << "a=rtpmap:104 ISAC/32000\r\n"
+       << "a=rtpmap:9 G722/8000\r\n"
+       << "a=rtpmap:0 PCMU/8000\r\n"
+       << "a=rtpmap:8 PCMA/8000\r\n"
+       << "a=rtpmap:106 CN/32000\r\n"
+       << "a=rtpmap:105 CN/16000\r\n"
+       << "a=rtpmap:13 CN/8000\r\n"
+       << "a=rtpmap:110 telephone-event/48000\r\n"
+       << "a=rtpmap:126 telephone-event/8000\r\n"
+       << "a=ssrc:" << audio_ssrc << " cname:cname" << i << "\r\n"
+       << "a=ssrc:" << audio_ssrc << " msid:stream" << i << " audio" << i
+       << "\r\n"
+       << "a=ssrc:" << audio_ssrc << " mslabel:stream" << i << "\r\n"
+       << "a=ssrc:" << audio_ssrc << " label:audio" << i << "\r\n";
+    os << "m=video 9 UDP/TLS/RTP/SAVPF 96 97 98 99 100 101 102\r\n"
+       << kTransport << "a=mid:video" << i << "\r\n"
+       << "a=extmap:2 urn:ietf:params:rtp-hdrext:toffset\r\n"
+       << "a=extmap:3 http://www.webrtc.org/experiments/rtp-hdrext/"
+          "abs-send-time\r\n"
+       << "a=extmap:4 urn:3gpp:video-orientation\r\n"
+       << "a=extmap:5 http://www.ietf.org/id/"
+          "draft-holmer-rmcat-transport-wide-cc-extensions-01\r\n"
+       << "a=extmap:6 http://www.webrtc.org/experiments/rtp-hdrext/"
+          "playout-delay\r\n"
+       << "a=sendrecv\r\n"
+       << "a=rtcp-mux\r\n"
+       << "a=rtcp-rsize\r\n";
+    const char* kCodecs[] = {"VP8", "VP9", "H264"};
+    for (int c = 0; c < 3; ++c) {
+      int payload_type = 96 + 2 * c;
+      os << "a=rtpmap:" << payload_type << " " << kCodecs[c] << "/90000\r\n"
+         << "a=rtcp-fb:" << payload_type << " goog-remb\r\n"
+         << "a=rtcp-fb:" << payload_type << " transport-cc\r\n"
+         << "a=rtcp-fb:" << payload_type << " ccm fir\r\n"
+         << "a=rtcp-fb:" << payload_type << " nack\r\n"
+         << "a=rtcp-fb:" << payload_type << " nack pli\r\n";
+      if (c == 2) {
+        os << "a=fmtp:" << payload_type << " level-asymmetry-allowed=1;"
+           << "packetization-mode=1;profile-level-id=42e01f\r\n";
+      }
+      os << "a=rtpmap:" << payload_type + 1 << " rtx/90000\r\n"
+         << "a=fmtp:" << payload_type + 1 << " apt=" << payload_type << "\r\n";
+    }
+    os << "a=rtpmap:102 red/90000\r\n"
+       << "a=ssrc-group:FID " << video_ssrc << " " << rtx_ssrc << "\r\n";
+    for (uint32_t ssrc : {video_ssrc, rtx_ssrc}) {
+      os << "a=ssrc:" << ssrc << " cname:cname" << i << "\r\n"
+         << "a=ssrc:" << ssrc << " msid:stream" << i << " video" << i << "\r\n"
+         << "a=ssrc:" << ssrc << " mslabel:stream" << i << "\r\n"
+         << "a=ssrc:" << ssrc << " label:video" << i << "\r\n";
+    }
+  }
+  return os.str();
+}
+
+TEST_F(WebRtcSdpTest, DeserializeAndSerializeLargeBundleOffer) {
+  const int kNumParticipants = 50;
+  std::string sdp = CreateLargeBundleOffer(kNumParticipants);
+  JsepSessionDescription jdesc(kDummyString);
+  SdpParseError error;
+  ASSERT_TRUE(webrtc::SdpDeserialize(sdp, &jdesc, &error)) << error.line
+                                                           << error.description;
+  EXPECT_EQ(2u * kNumParticipants, jdesc.description()->contents().size());
+  EXPECT_EQ(2u * kNumParticipants, jdesc.number_of_mediasections());
+
+  // Another round trip gives the same description.
+  std::string serialized = webrtc::SdpSerialize(jdesc, false);
+  JsepSessionDescription jdesc2(kDummyString);
+  ASSERT_TRUE(webrtc::SdpDeserialize(serialized, &jdesc2, &error))
+      << error.line << error.description;
+  EXPECT_TRUE(CompareSessionDescription(jdesc, jdesc2));
+  EXPECT_EQ(serialized, webrtc::SdpSerialize(jdesc2, false));
+}
+
+// Measures parsing and serializing of large offers. Disabled by default since
+// it only logs timings.
+TEST_F(WebRtcSdpTest, DISABLED_LargeBundleOfferPerformance) {
+  const int kIterations = 20;
+  for (int num_participants : {1, 10, 50, 100}) {
+    std::string sdp = CreateLargeBundleOffer(num_participants);
+    int64_t parse_ns = 0;
+    int64_t serialize_ns = 0;
+    for (int i = 0; i < kIterations; ++i) {
+      JsepSessionDescription jdesc(kDummyString);
+      int64_t start_ns = rtc::TimeNanos();
+      ASSERT_TRUE(SdpDeserialize(sdp, &jdesc));
+      int64_t parsed_ns = rtc::TimeNanos();
+      std::string serialized = webrtc::SdpSerialize(jdesc, false);
+      serialize_ns += rtc::TimeNanos() - parsed_ns;
+      parse_ns += parsed_ns - start_ns;
+    }
+    LOG(LS_INFO) << num_participants << " participants (" << sdp.size()
+                 << " bytes): parse "
+                 << parse_ns / kIterations / rtc::kNumNanosecsPerMicrosec
+                 << " us, serialize "
+                 << serialize_ns / kIterations / rtc::kNumNanosecsPerMicrosec
+                 << " us.";
+  }
+}
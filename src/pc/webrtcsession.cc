@@ -611,6 +611,10 @@ bool WebRtcSession::Initialize(
   audio_options_.audio_jitter_buffer_fast_accelerate = rtc::Optional<bool>(
       rtc_configuration.audio_jitter_buffer_fast_accelerate);
 
+  sctp_send_buffer_size_ = rtc_configuration.sctp_send_buffer_size.value_or(0);
+  sctp_receive_buffer_size_ =
+      rtc_configuration.sctp_receive_buffer_size.value_or(0);
+
   if (!dtls_enabled_) {
     // Construct with DTLS disabled.
     webrtc_session_desc_factory_.reset(new WebRtcSessionDescriptionFactory(
@@ -984,26 +988,32 @@ bool WebRtcSession::PushdownMediaDescription(
       (source == cricket::CS_LOCAL ? local_description() : remote_description())
           ->description();
   RTC_DCHECK(sdesc);
-  bool all_success = true;
-  for (auto* channel : Channels()) {
-    // TODO(steveanton): Add support for multiple channels of the same type.
-    const ContentInfo* content_info =
-        cricket::GetFirstMediaContent(sdesc->contents(), channel->media_type());
-    if (!content_info) {
-      continue;
-    }
-    const MediaContentDescription* content_desc =
-        static_cast<const MediaContentDescription*>(content_info->description);
-    if (content_desc && !content_info->rejected) {
-      bool success = (source == cricket::CS_LOCAL)
-                         ? channel->SetLocalContent(content_desc, action, err)
-                         : channel->SetRemoteContent(content_desc, action, err);
-      if (!success) {
-        all_success = false;
-        break;
+  std::vector<cricket::BaseChannel*> channels = Channels();
+  // Apply the contents of all channels in a single hop to the worker thread,
+  // instead of blocking on it once per channel.
+  bool all_success = worker_thread()->Invoke<bool>(RTC_FROM_HERE, [&] {
+    for (auto* channel : channels) {
+      // TODO(steveanton): Add support for multiple channels of the same type.
+      const ContentInfo* content_info = cricket::GetFirstMediaContent(
+          sdesc->contents(), channel->media_type());
+      if (!content_info) {
+        continue;
+      }
+      const MediaContentDescription* content_desc =
+          static_cast<const MediaContentDescription*>(
+              content_info->description);
+      if (content_desc && !content_info->rejected) {
+        bool success =
+            (source == cricket::CS_LOCAL)
+                ? channel->SetLocalContent(content_desc, action, err)
+                : channel->SetRemoteContent(content_desc, action, err);
+        if (!success) {
+          return false;
+        }
       }
     }
-  }
+    return true;
+  });
   // Need complete offer/answer with an SCTP m= section before starting SCTP,
   // according to https://tools.ietf.org/html/draft-ietf-mmusic-sctp-sdp-19
   if (sctp_transport_ && local_description() && remote_description() &&
@@ -1311,6 +1321,19 @@ bool WebRtcSession::SendData(const cricket::SendDataParams& params,
                         sctp_transport_.get(), params, payload, result));
 }
 
+size_t WebRtcSession::SendDataBulk(
+    const cricket::SendDataParams& params,
+    const std::vector<rtc::CopyOnWriteBuffer>& payloads,
+    cricket::SendDataResult* result) {
+  if (rtp_data_channel_ || !sctp_transport_) {
+    return DataChannelProviderInterface::SendDataBulk(params, payloads, result);
+  }
+  // One hop to the network thread for all of the messages.
+  return network_thread_->Invoke<size_t>(
+      RTC_FROM_HERE, Bind(&cricket::SctpTransportInternal::SendDataBulk,
+                          sctp_transport_.get(), params, payloads, result));
+}
+
 bool WebRtcSession::ConnectDataChannel(DataChannel* webrtc_data_channel) {
   if (!rtp_data_channel_ && !sctp_transport_) {
     // Don't log an error here, because DataChannels are expected to call
@@ -1591,20 +1614,15 @@ void WebRtcSession::OnTransportControllerDtlsHandshakeError(
 
 // Enabling voice and video (and RTP data) channels.
 void WebRtcSession::EnableChannels() {
-  for (cricket::VoiceChannel* voice_channel : voice_channels_) {
-    if (!voice_channel->enabled()) {
-      voice_channel->Enable(true);
-    }
-  }
-
-  for (cricket::VideoChannel* video_channel : video_channels_) {
-    if (!video_channel->enabled()) {
-      video_channel->Enable(true);
+  // Enable all channels in a single hop to the worker thread.
+  std::vector<cricket::BaseChannel*> channels = Channels();
+  worker_thread()->Invoke<void>(RTC_FROM_HERE, [&channels] {
+    for (cricket::BaseChannel* channel : channels) {
+      if (!channel->enabled()) {
+        channel->Enable(true);
+      }
     }
-  }
-
-  if (rtp_data_channel_ && !rtp_data_channel_->enabled())
-    rtp_data_channel_->Enable(true);
+  });
 }
 
 // Returns the media index for a local ice candidate given the content name.
@@ -1814,6 +1832,7 @@ bool WebRtcSession::CreateVoiceChannel(const cricket::ContentInfo* content,
 
   cricket::VoiceChannel* voice_channel = channel_manager_->CreateVoiceChannel(
       call_, media_config_, rtp_dtls_transport, rtcp_dtls_transport,
+      transport_controller_->network_thread(),
       transport_controller_->signaling_thread(), content->name, SrtpRequired(),
       audio_options_);
   if (!voice_channel) {
@@ -1863,6 +1882,7 @@ bool WebRtcSession::CreateVideoChannel(const cricket::ContentInfo* content,
 
   cricket::VideoChannel* video_channel = channel_manager_->CreateVideoChannel(
       call_, media_config_, rtp_dtls_transport, rtcp_dtls_transport,
+      transport_controller_->network_thread(),
       transport_controller_->signaling_thread(), content->name, SrtpRequired(),
       video_options_);
 
@@ -1931,6 +1951,7 @@ bool WebRtcSession::CreateDataChannel(const cricket::ContentInfo* content,
 
     rtp_data_channel_.reset(channel_manager_->CreateRtpDataChannel(
         media_config_, rtp_dtls_transport, rtcp_dtls_transport,
+        transport_controller_->network_thread(),
         transport_controller_->signaling_thread(), content->name,
         SrtpRequired()));
 
@@ -1998,6 +2019,13 @@ bool WebRtcSession::CreateSctpTransport_n(const std::string& content_name,
           transport_name, cricket::ICE_CANDIDATE_COMPONENT_RTP);
   sctp_transport_ = sctp_factory_->CreateSctpTransport(tc);
   RTC_DCHECK(sctp_transport_);
+  if ((sctp_send_buffer_size_ || sctp_receive_buffer_size_) &&
+      !sctp_transport_->SetBufferSizes(sctp_send_buffer_size_,
+                                       sctp_receive_buffer_size_)) {
+    LOG(LS_WARNING) << "Failed to set the SCTP buffer sizes to "
+                    << sctp_send_buffer_size_ << " and "
+                    << sctp_receive_buffer_size_ << " bytes.";
+  }
   sctp_invoker_.reset(new rtc::AsyncInvoker());
   sctp_transport_->SignalReadyToSendData.connect(
       this, &WebRtcSession::OnSctpTransportReadyToSendData_n);
@@ -306,6 +306,9 @@ class WebRtcSession :
   bool SendData(const cricket::SendDataParams& params,
                 const rtc::CopyOnWriteBuffer& payload,
                 cricket::SendDataResult* result) override;
+  size_t SendDataBulk(const cricket::SendDataParams& params,
+                      const std::vector<rtc::CopyOnWriteBuffer>& payloads,
+                      cricket::SendDataResult* result) override;
   bool ConnectDataChannel(DataChannel* webrtc_data_channel) override;
   void DisconnectDataChannel(DataChannel* webrtc_data_channel) override;
   void AddSctpDataStream(int sid) override;
@@ -610,6 +613,10 @@ class WebRtcSession :
   rtc::Optional<std::string> sctp_transport_name_;
   // |sctp_content_name_| is the content name (MID) in SDP.
   rtc::Optional<std::string> sctp_content_name_;
+  // Socket buffer sizes for |sctp_transport_|, from the RTCConfiguration. 0
+  // means the usrsctp default.
+  int sctp_send_buffer_size_ = 0;
+  int sctp_receive_buffer_size_ = 0;
   // Value cached on signaling thread. Only updated when SctpReadyToSendData
   // fires on the signaling thread.
   bool sctp_ready_to_send_data_ = false;
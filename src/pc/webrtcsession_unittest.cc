@@ -219,15 +219,25 @@ class FakeSctpTransport : public cricket::SctpTransportInternal {
                 cricket::SendDataResult* result = nullptr) override {
     return true;
   }
+  bool SetBufferSizes(int send_buffer_size,
+                      int receive_buffer_size) override {
+    send_buffer_size_ = send_buffer_size;
+    receive_buffer_size_ = receive_buffer_size;
+    return true;
+  }
   bool ReadyToSendData() override { return true; }
   void set_debug_name_for_testing(const char* debug_name) override {}
 
   int local_port() const { return local_port_; }
   int remote_port() const { return remote_port_; }
+  int send_buffer_size() const { return send_buffer_size_; }
+  int receive_buffer_size() const { return receive_buffer_size_; }
 
  private:
   int local_port_ = -1;
   int remote_port_ = -1;
+  int send_buffer_size_ = 0;
+  int receive_buffer_size_ = 0;
 };
 
 class FakeSctpTransportFactory : public cricket::SctpTransportInternalFactory {
@@ -4166,6 +4176,21 @@ TEST_P(WebRtcSessionTest, TestSctpDataChannelWithDtls) {
   EXPECT_NE(nullptr, fake_sctp_transport_factory_->last_fake_sctp_transport());
 }
 
+// Test that the SCTP buffer sizes in the configuration are passed on to the
+// SctpTransport.
+TEST_P(WebRtcSessionTest, TestSctpBufferSizesFromConfiguration) {
+  configuration_.sctp_send_buffer_size = rtc::Optional<int>(1024 * 1024);
+  configuration_.sctp_receive_buffer_size = rtc::Optional<int>(2 * 1024 * 1024);
+  InitWithDtls(GetParam());
+
+  SetLocalDescriptionWithDataChannel();
+  FakeSctpTransport* sctp_transport =
+      fake_sctp_transport_factory_->last_fake_sctp_transport();
+  ASSERT_NE(nullptr, sctp_transport);
+  EXPECT_EQ(1024 * 1024, sctp_transport->send_buffer_size());
+  EXPECT_EQ(2 * 1024 * 1024, sctp_transport->receive_buffer_size());
+}
+
 // Test that if SCTP is disabled, we don't end up with an SctpTransport
 // created (or an RtpDataChannel).
 TEST_P(WebRtcSessionTest, TestDisableSctpDataChannels) {
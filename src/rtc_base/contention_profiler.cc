@@ -0,0 +1,258 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/contention_profiler.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <sstream>
+
+#include "rtc_base/location.h"
+#include "rtc_base/timeutils.h"
+
+namespace rtc {
+namespace contention_profiler {
+
+namespace {
+
+// Must be a power of two.
+const size_t kMaxSites = 2048;
+const size_t kMaxProbes = 32;
+const size_t kMaxObjectNameLength = 32;
+
+enum SiteState { kEmpty = 0, kClaiming = 1, kReady = 2 };
+
+struct Site {
+  std::atomic<int> state;
+  // The key is written once by the thread that claims the site, before
+  // |state| is set to kReady.
+  SiteType type;
+  const void* object;
+  const void* callsite;
+  const char* function_name;
+  char object_name[kMaxObjectNameLength];
+
+  std::atomic<int64_t> count;
+  std::atomic<int64_t> total_wait_ns;
+  std::atomic<int64_t> max_wait_ns;
+  std::atomic<int64_t> total_hold_ns;
+  std::atomic<int64_t> max_hold_ns;
+};
+
+std::atomic<bool> g_enabled(false);
+// Allocated on the first Enable() and never freed, so that threads that are
+// still recording when profiling is disabled never touch freed memory.
+std::atomic<Site*> g_sites(nullptr);
+std::atomic<int64_t> g_num_dropped(0);
+
+size_t HashKey(SiteType type, const void* object, const void* callsite) {
+  uint64_t key = reinterpret_cast<uintptr_t>(object) * 0x9E3779B97F4A7C15ull;
+  key ^= reinterpret_cast<uintptr_t>(callsite) + (key << 6) + (key >> 2);
+  key ^= static_cast<uint64_t>(type);
+  return static_cast<size_t>(key ^ (key >> 29));
+}
+
+void UpdateMax(std::atomic<int64_t>* max, int64_t value) {
+  int64_t current = max->load(std::memory_order_relaxed);
+  while (value > current &&
+         !max->compare_exchange_weak(current, value,
+                                     std::memory_order_relaxed)) {
+  }
+}
+
+void ResetSite(Site* site) {
+  site->count.store(0, std::memory_order_relaxed);
+  site->total_wait_ns.store(0, std::memory_order_relaxed);
+  site->max_wait_ns.store(0, std::memory_order_relaxed);
+  site->total_hold_ns.store(0, std::memory_order_relaxed);
+  site->max_hold_ns.store(0, std::memory_order_relaxed);
+  site->state.store(kEmpty, std::memory_order_release);
+}
+
+Site* FindOrClaimSite(SiteType type,
+                      const void* object,
+                      const void* callsite,
+                      const char* function_name,
+                      const std::string* object_name) {
+  Site* sites = g_sites.load(std::memory_order_acquire);
+  if (!sites)
+    return nullptr;
+  size_t hash = HashKey(type, object, callsite);
+  for (size_t probe = 0; probe < kMaxProbes; ++probe) {
+    Site* site = &sites[(hash + probe) & (kMaxSites - 1)];
+    int state = site->state.load(std::memory_order_acquire);
+    if (state == kEmpty) {
+      if (site->state.compare_exchange_strong(state, kClaiming,
+                                              std::memory_order_acquire)) {
+        site->type = type;
+        site->object = object;
+        site->callsite = callsite;
+        site->function_name = function_name;
+        site->object_name[0] = '\0';
+        if (object_name) {
+          size_t length =
+              std::min(object_name->size(), kMaxObjectNameLength - 1);
+          memcpy(site->object_name, object_name->data(), length);
+          site->object_name[length] = '\0';
+        }
+        site->state.store(kReady, std::memory_order_release);
+        return site;
+      }
+    }
+    // Another thread is writing the key of this site; it will be done after a
+    // handful of stores.
+    while (state == kClaiming)
+      state = site->state.load(std::memory_order_acquire);
+    if (site->type == type && site->object == object &&
+        site->callsite == callsite) {
+      return site;
+    }
+  }
+  return nullptr;
+}
+
+void AddSample(Site* site, int64_t wait_ns, int64_t hold_ns) {
+  if (!site) {
+    g_num_dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  site->count.fetch_add(1, std::memory_order_relaxed);
+  site->total_wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+  site->total_hold_ns.fetch_add(hold_ns, std::memory_order_relaxed);
+  UpdateMax(&site->max_wait_ns, wait_ns);
+  UpdateMax(&site->max_hold_ns, hold_ns);
+}
+
+double ToMs(int64_t ns) {
+  return static_cast<double>(ns) / kNumNanosecsPerMillisec;
+}
+
+}  // namespace
+
+bool Enable() {
+  if (!g_sites.load(std::memory_order_acquire)) {
+    Site* sites = new Site[kMaxSites];
+    for (size_t i = 0; i < kMaxSites; ++i)
+      ResetSite(&sites[i]);
+    Site* expected = nullptr;
+    if (!g_sites.compare_exchange_strong(expected, sites))
+      delete[] sites;
+  }
+  g_enabled.store(true, std::memory_order_release);
+  return WEBRTC_CONTENTION_PROFILER != 0;
+}
+
+void Disable() {
+  g_enabled.store(false, std::memory_order_release);
+}
+
+bool IsEnabled() {
+  return g_enabled.load(std::memory_order_relaxed);
+}
+
+void Reset() {
+  Site* sites = g_sites.load(std::memory_order_acquire);
+  if (sites) {
+    for (size_t i = 0; i < kMaxSites; ++i)
+      ResetSite(&sites[i]);
+  }
+  g_num_dropped.store(0, std::memory_order_relaxed);
+}
+
+std::vector<SiteStats> GetSites() {
+  std::vector<SiteStats> result;
+  Site* sites = g_sites.load(std::memory_order_acquire);
+  if (!sites)
+    return result;
+  for (size_t i = 0; i < kMaxSites; ++i) {
+    const Site& site = sites[i];
+    if (site.state.load(std::memory_order_acquire) != kReady)
+      continue;
+    SiteStats stats;
+    stats.type = site.type;
+    stats.object = site.object;
+    stats.callsite_address = site.callsite;
+    if (site.type == SiteType::kInvoke) {
+      stats.callsite =
+          Location(site.function_name, static_cast<const char*>(site.callsite))
+              .ToString();
+    } else {
+      std::ostringstream oss;
+      oss << site.callsite;
+      stats.callsite = oss.str();
+    }
+    stats.object_name = site.object_name;
+    stats.count = site.count.load(std::memory_order_relaxed);
+    stats.total_wait_ns = site.total_wait_ns.load(std::memory_order_relaxed);
+    stats.max_wait_ns = site.max_wait_ns.load(std::memory_order_relaxed);
+    stats.total_hold_ns = site.total_hold_ns.load(std::memory_order_relaxed);
+    stats.max_hold_ns = site.max_hold_ns.load(std::memory_order_relaxed);
+    result.push_back(stats);
+  }
+  std::sort(result.begin(), result.end(),
+            [](const SiteStats& a, const SiteStats& b) {
+              return a.total_wait_ns > b.total_wait_ns;
+            });
+  return result;
+}
+
+int64_t NumDroppedSamples() {
+  return g_num_dropped.load(std::memory_order_relaxed);
+}
+
+std::string Report(size_t max_sites) {
+  std::vector<SiteStats> sites = GetSites();
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(3);
+  oss << "Contention report: " << sites.size() << " sites, "
+      << NumDroppedSamples() << " dropped samples. Lock call sites are code "
+      << "addresses, use a symbolizer to resolve them.\n";
+  for (size_t i = 0; i < sites.size() && i < max_sites; ++i) {
+    const SiteStats& site = sites[i];
+    if (site.type == SiteType::kLock) {
+      oss << "lock " << site.object << " entered at " << site.callsite;
+    } else {
+      oss << "invoke on thread "
+          << (site.object_name.empty() ? "<unnamed>" : site.object_name)
+          << " (" << site.object << ") from " << site.callsite;
+    }
+    oss << ": count " << site.count << ", wait total "
+        << ToMs(site.total_wait_ns) << " ms max " << ToMs(site.max_wait_ns)
+        << " ms, " << (site.type == SiteType::kLock ? "hold" : "run")
+        << " total " << ToMs(site.total_hold_ns) << " ms max "
+        << ToMs(site.max_hold_ns) << " ms\n";
+  }
+  return oss.str();
+}
+
+void RecordLock(const void* lock,
+                const void* callsite,
+                int64_t wait_ns,
+                int64_t hold_ns) {
+  AddSample(FindOrClaimSite(SiteType::kLock, lock, callsite, nullptr, nullptr),
+            wait_ns, hold_ns);
+}
+
+void RecordInvoke(const void* thread,
+                  const std::string& thread_name,
+                  const Location& posted_from,
+                  int64_t wait_ns,
+                  int64_t run_ns) {
+  AddSample(FindOrClaimSite(SiteType::kInvoke, thread,
+                            posted_from.file_and_line(),
+                            posted_from.function_name(), &thread_name),
+            wait_ns, run_ns);
+}
+
+}  // namespace contention_profiler
+}  // namespace rtc
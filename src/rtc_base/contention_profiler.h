@@ -0,0 +1,100 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_CONTENTION_PROFILER_H_
+#define RTC_BASE_CONTENTION_PROFILER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+// Set by the rtc_enable_contention_profiler build flag. When 0, CriticalSection
+// and Thread are not instrumented and Enable() has no effect.
+#if !defined(WEBRTC_CONTENTION_PROFILER)
+#define WEBRTC_CONTENTION_PROFILER 0
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define RTC_RETURN_ADDRESS() _ReturnAddress()
+#else
+#define RTC_RETURN_ADDRESS() __builtin_return_address(0)
+#endif
+
+namespace rtc {
+
+class Location;
+
+// Profiles where threads block on each other. For every CriticalSection it
+// records the time spent waiting to enter the lock and the time it is held,
+// per lock and calling code address. For every blocking Thread::Invoke (or
+// Thread::Send) it records the time the message waited in the target thread's
+// queue and the time the handler ran, per target thread and rtc::Location.
+//
+// Samples are aggregated without locking into a fixed size table; sites that
+// do not fit are counted as dropped. Profiling is off until Enable() is called
+// and is only compiled in when building with rtc_enable_contention_profiler.
+namespace contention_profiler {
+
+enum class SiteType { kLock, kInvoke };
+
+struct SiteStats {
+  SiteType type;
+  // The CriticalSection or the target Thread.
+  const void* object;
+  // For locks, the return address of the code that entered the lock. For
+  // invokes, the rtc::Location given to Invoke.
+  const void* callsite_address;
+  std::string callsite;
+  // The name of the target thread, for invokes.
+  std::string object_name;
+  int64_t count;
+  int64_t total_wait_ns;
+  int64_t max_wait_ns;
+  int64_t total_hold_ns;
+  int64_t max_hold_ns;
+};
+
+// Starts recording. Returns false if CriticalSection and Thread are not
+// instrumented in this build, in which case only samples passed to the
+// Record functions below are collected.
+bool Enable();
+void Disable();
+bool IsEnabled();
+
+// Clears all recorded sites. Must not be called while other threads may be
+// recording samples.
+void Reset();
+
+// Returns the recorded sites, sorted by total wait time, longest first.
+std::vector<SiteStats> GetSites();
+int64_t NumDroppedSamples();
+
+// Returns a human readable report of the |max_sites| sites with the longest
+// total wait time.
+std::string Report(size_t max_sites);
+
+// Called by CriticalSection and Thread.
+void RecordLock(const void* lock,
+                const void* callsite,
+                int64_t wait_ns,
+                int64_t hold_ns);
+void RecordInvoke(const void* thread,
+                  const std::string& thread_name,
+                  const Location& posted_from,
+                  int64_t wait_ns,
+                  int64_t run_ns);
+
+}  // namespace contention_profiler
+}  // namespace rtc
+
+#endif  // RTC_BASE_CONTENTION_PROFILER_H_
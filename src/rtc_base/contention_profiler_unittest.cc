@@ -0,0 +1,154 @@
+/*
+ *  Copyright 2017 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/contention_profiler.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/gunit.h"
+#include "rtc_base/location.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/timeutils.h"
+
+namespace rtc {
+
+namespace {
+
+class ContentionProfilerTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    contention_profiler::Enable();
+    contention_profiler::Reset();
+  }
+  void TearDown() override {
+    contention_profiler::Disable();
+    contention_profiler::Reset();
+  }
+};
+
+const contention_profiler::SiteStats* FindSite(
+    const std::vector<contention_profiler::SiteStats>& sites,
+    const void* object) {
+  for (const auto& site : sites) {
+    if (site.object == object)
+      return &site;
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+TEST_F(ContentionProfilerTest, AggregatesLockSamplesPerLockAndCallsite) {
+  int lock1, lock2;
+  int callsite1, callsite2;
+  contention_profiler::RecordLock(&lock1, &callsite1, 100, 1000);
+  contention_profiler::RecordLock(&lock1, &callsite1, 300, 2000);
+  contention_profiler::RecordLock(&lock1, &callsite2, 5, 10);
+  contention_profiler::RecordLock(&lock2, &callsite1, 1000, 10);
+
+  std::vector<contention_profiler::SiteStats> sites =
+      contention_profiler::GetSites();
+  ASSERT_EQ(3u, sites.size());
+  // Sorted by total wait time.
+  EXPECT_EQ(&lock2, sites[0].object);
+  EXPECT_EQ(&lock1, sites[1].object);
+  EXPECT_EQ(&callsite1, sites[1].callsite_address);
+  EXPECT_EQ(contention_profiler::SiteType::kLock, sites[1].type);
+  EXPECT_EQ(2, sites[1].count);
+  EXPECT_EQ(400, sites[1].total_wait_ns);
+  EXPECT_EQ(300, sites[1].max_wait_ns);
+  EXPECT_EQ(3000, sites[1].total_hold_ns);
+  EXPECT_EQ(2000, sites[1].max_hold_ns);
+  EXPECT_EQ(&callsite2, sites[2].callsite_address);
+  EXPECT_EQ(1, sites[2].count);
+  EXPECT_EQ(0, contention_profiler::NumDroppedSamples());
+
+  contention_profiler::Reset();
+  EXPECT_TRUE(contention_profiler::GetSites().empty());
+}
+
+TEST_F(ContentionProfilerTest, RecordsInvokeLocationAndThreadName) {
+  int thread;
+  Location location = RTC_FROM_HERE;
+  contention_profiler::RecordInvoke(&thread, "worker", location, 50, 70);
+
+  std::vector<contention_profiler::SiteStats> sites =
+      contention_profiler::GetSites();
+  ASSERT_EQ(1u, sites.size());
+  EXPECT_EQ(contention_profiler::SiteType::kInvoke, sites[0].type);
+  EXPECT_EQ("worker", sites[0].object_name);
+  EXPECT_EQ(location.ToString(), sites[0].callsite);
+  EXPECT_EQ(50, sites[0].total_wait_ns);
+  EXPECT_EQ(70, sites[0].total_hold_ns);
+
+  std::string report = contention_profiler::Report(10);
+  EXPECT_NE(std::string::npos, report.find("invoke on thread worker"));
+  EXPECT_NE(std::string::npos, report.find(location.file_and_line()));
+}
+
+TEST_F(ContentionProfilerTest, ReportIsLimitedToLongestWaits) {
+  int lock1, lock2, callsite;
+  contention_profiler::RecordLock(&lock1, &callsite, 10, 0);
+  contention_profiler::RecordLock(&lock2, &callsite, 20, 0);
+  std::string report = contention_profiler::Report(1);
+  EXPECT_NE(std::string::npos, report.find("2 sites"));
+  // One header line and one site.
+  EXPECT_EQ(2, std::count(report.begin(), report.end(), '\n'));
+}
+
+TEST_F(ContentionProfilerTest, DoesNotRecordWhenDisabled) {
+  contention_profiler::Disable();
+  CriticalSection crit;
+  { CritScope cs(&crit); }
+  EXPECT_EQ(nullptr, FindSite(contention_profiler::GetSites(), &crit));
+}
+
+#if WEBRTC_CONTENTION_PROFILER
+TEST_F(ContentionProfilerTest, RecordsCriticalSectionHoldTime) {
+  const int64_t kHoldNs = 2 * kNumNanosecsPerMillisec;
+  CriticalSection crit;
+  {
+    CritScope cs(&crit);
+    // Nested entries are part of the outer hold.
+    CritScope nested(&crit);
+    int64_t start_ns = TimeNanos();
+    while (TimeNanos() - start_ns < kHoldNs) {
+    }
+  }
+  const contention_profiler::SiteStats* site =
+      FindSite(contention_profiler::GetSites(), &crit);
+  ASSERT_TRUE(site);
+  EXPECT_EQ(1, site->count);
+  EXPECT_GE(site->total_hold_ns, kHoldNs);
+}
+
+TEST_F(ContentionProfilerTest, RecordsBlockingInvokes) {
+  std::unique_ptr<Thread> thread(Thread::Create());
+  thread->SetName("target", nullptr);
+  thread->Start();
+  const int kNumInvokes = 3;
+  for (int i = 0; i < kNumInvokes; ++i)
+    thread->Invoke<void>(RTC_FROM_HERE, [] {});
+  thread->Stop();
+
+  const contention_profiler::SiteStats* site =
+      FindSite(contention_profiler::GetSites(), thread.get());
+  ASSERT_TRUE(site);
+  EXPECT_EQ(contention_profiler::SiteType::kInvoke, site->type);
+  EXPECT_EQ("target", site->object_name);
+  EXPECT_EQ(kNumInvokes, site->count);
+}
+#endif  // WEBRTC_CONTENTION_PROFILER
+
+}  // namespace rtc
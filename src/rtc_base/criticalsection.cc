@@ -12,12 +12,19 @@
 
 #include "rtc_base/checks.h"
 #include "rtc_base/platform_thread.h"
+#include "rtc_base/timeutils.h"
 
 // TODO(tommi): Split this file up to per-platform implementation files.
 
 namespace rtc {
 
 CriticalSection::CriticalSection() {
+#if WEBRTC_CONTENTION_PROFILER
+  profiled_depth_ = 0;
+  profiled_callsite_ = nullptr;
+  profiled_wait_ns_ = 0;
+  profiled_acquired_ns_ = 0;
+#endif
 #if defined(WEBRTC_WIN)
   InitializeCriticalSection(&crit_);
 #elif defined(WEBRTC_POSIX)
@@ -57,6 +64,35 @@ CriticalSection::~CriticalSection() {
 }
 
 void CriticalSection::Enter() const RTC_EXCLUSIVE_LOCK_FUNCTION() {
+#if WEBRTC_CONTENTION_PROFILER
+  EnterFrom(RTC_RETURN_ADDRESS());
+#else
+  EnterInternal();
+#endif
+}
+
+#if WEBRTC_CONTENTION_PROFILER
+void CriticalSection::EnterFrom(const void* callsite) const
+    RTC_EXCLUSIVE_LOCK_FUNCTION() {
+  if (!contention_profiler::IsEnabled()) {
+    EnterInternal();
+    // Keep counting nested entries of a lock that was entered while profiling
+    // was enabled, so that its hold time ends at the outermost Leave().
+    if (profiled_depth_ > 0)
+      ++profiled_depth_;
+    return;
+  }
+  int64_t start_ns = TimeNanos();
+  EnterInternal();
+  if (profiled_depth_++ == 0) {
+    profiled_acquired_ns_ = TimeNanos();
+    profiled_wait_ns_ = profiled_acquired_ns_ - start_ns;
+    profiled_callsite_ = callsite;
+  }
+}
+#endif
+
+void CriticalSection::EnterInternal() const RTC_EXCLUSIVE_LOCK_FUNCTION() {
 #if defined(WEBRTC_WIN)
   EnterCriticalSection(&crit_);
 #elif defined(WEBRTC_POSIX)
@@ -117,7 +153,13 @@ void CriticalSection::Enter() const RTC_EXCLUSIVE_LOCK_FUNCTION() {
 
 bool CriticalSection::TryEnter() const RTC_EXCLUSIVE_TRYLOCK_FUNCTION(true) {
 #if defined(WEBRTC_WIN)
-  return TryEnterCriticalSection(&crit_) != FALSE;
+  if (TryEnterCriticalSection(&crit_) == FALSE)
+    return false;
+# if WEBRTC_CONTENTION_PROFILER
+  if (profiled_depth_ > 0)
+    ++profiled_depth_;
+# endif
+  return true;
 #elif defined(WEBRTC_POSIX)
 # if defined(WEBRTC_MAC) && !USE_NATIVE_MUTEX_ON_MAC
   if (!IsThreadRefEqual(owning_thread_, CurrentThreadRef())) {
@@ -141,6 +183,12 @@ bool CriticalSection::TryEnter() const RTC_EXCLUSIVE_TRYLOCK_FUNCTION(true) {
     RTC_DCHECK(CurrentThreadIsOwner());
   }
   ++recursion_count_;
+# endif
+# if WEBRTC_CONTENTION_PROFILER
+  // TryEnter never waits, so it only extends the hold time of a profiled
+  // outer Enter().
+  if (profiled_depth_ > 0)
+    ++profiled_depth_;
 # endif
   return true;
 #else
@@ -150,6 +198,22 @@ bool CriticalSection::TryEnter() const RTC_EXCLUSIVE_TRYLOCK_FUNCTION(true) {
 
 void CriticalSection::Leave() const RTC_UNLOCK_FUNCTION() {
   RTC_DCHECK(CurrentThreadIsOwner());
+#if WEBRTC_CONTENTION_PROFILER
+  // Read the sample before unlocking, another thread may overwrite it as soon
+  // as the lock is released.
+  if (profiled_depth_ > 0 && --profiled_depth_ == 0) {
+    const void* callsite = profiled_callsite_;
+    int64_t wait_ns = profiled_wait_ns_;
+    int64_t hold_ns = TimeNanos() - profiled_acquired_ns_;
+    LeaveInternal();
+    contention_profiler::RecordLock(this, callsite, wait_ns, hold_ns);
+    return;
+  }
+#endif
+  LeaveInternal();
+}
+
+void CriticalSection::LeaveInternal() const RTC_UNLOCK_FUNCTION() {
 #if defined(WEBRTC_WIN)
   LeaveCriticalSection(&crit_);
 #elif defined(WEBRTC_POSIX)
@@ -195,7 +259,13 @@ bool CriticalSection::CurrentThreadIsOwner() const {
 #endif
 }
 
-CritScope::CritScope(const CriticalSection* cs) : cs_(cs) { cs_->Enter(); }
+CritScope::CritScope(const CriticalSection* cs) : cs_(cs) {
+#if WEBRTC_CONTENTION_PROFILER
+  cs_->EnterFrom(RTC_RETURN_ADDRESS());
+#else
+  cs_->Enter();
+#endif
+}
 CritScope::~CritScope() { cs_->Leave(); }
 
 TryCritScope::TryCritScope(const CriticalSection* cs)
@@ -14,6 +14,7 @@
 #include "rtc_base/atomicops.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/constructormagic.h"
+#include "rtc_base/contention_profiler.h"
 #include "rtc_base/platform_thread_types.h"
 #include "rtc_base/thread_annotations.h"
 #include "typedefs.h"  // NOLINT(build/include)
@@ -62,9 +63,28 @@ class RTC_LOCKABLE CriticalSection {
   void Leave() const RTC_UNLOCK_FUNCTION();
 
  private:
+  friend class CritScope;
+
+  void EnterInternal() const RTC_EXCLUSIVE_LOCK_FUNCTION();
+  void LeaveInternal() const RTC_UNLOCK_FUNCTION();
+#if WEBRTC_CONTENTION_PROFILER
+  // Enter() that attributes the time spent waiting for and holding the lock
+  // to |callsite| when the contention profiler is enabled.
+  void EnterFrom(const void* callsite) const RTC_EXCLUSIVE_LOCK_FUNCTION();
+#endif
+
   // Use only for RTC_DCHECKing.
   bool CurrentThreadIsOwner() const;
 
+#if WEBRTC_CONTENTION_PROFILER
+  // Only modified by the thread that owns the lock. |profiled_depth_| is the
+  // recursion count of profiled Enter calls.
+  mutable int profiled_depth_;
+  mutable const void* profiled_callsite_;
+  mutable int64_t profiled_wait_ns_;
+  mutable int64_t profiled_acquired_ns_;
+#endif
+
 #if defined(WEBRTC_WIN)
   mutable CRITICAL_SECTION crit_;
 #elif defined(WEBRTC_POSIX)
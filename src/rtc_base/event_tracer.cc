@@ -11,9 +11,19 @@
 
 #include <inttypes.h>
 
+#if defined(WEBRTC_WIN)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include <algorithm>
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "rtc_base/bytebuffer.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/event.h"
@@ -85,7 +95,574 @@ static void EventTracingThreadFunc(void* params);
 // Atomic-int fast path for avoiding logging when disabled.
 static volatile int g_event_logging_active = 0;
 
-// TODO(pbos): Log metadata for all threads, etc.
+// Only every |g_sampling_interval|th event is recorded when larger than one.
+static volatile int g_sampling_interval = 1;
+
+// Maximum number of arguments to a trace event, see trace_event.h.
+const int kMaxTraceArgs = 2;
+
+// Number of events a thread can record before the logging thread drains its
+// buffer. Events added to a full buffer are dropped and counted.
+const uint32_t kThreadBufferCapacity = 2048;
+const size_t kCacheLineSize = 64;
+
+// Header of files written by binary captures, followed by a version number.
+const char kBinaryTraceMagic[] = "RTCTRACE";
+const uint32_t kBinaryTraceVersion = 1;
+
+// Record types of binary captures.
+enum BinaryRecordType : uint8_t {
+  kStringRecord = 1,
+  kEventRecord = 2,
+  kDroppedEventsRecord = 3,
+};
+
+struct TraceArg {
+  const char* name;
+  unsigned char type;
+  // Copied from webrtc/rtc_base/trace_event.h TraceValueUnion.
+  union TraceArgValue {
+    bool as_bool;
+    unsigned long long as_uint;
+    long long as_int;
+    double as_double;
+    const void* as_pointer;
+    const char* as_string;
+  } value;
+
+  // Assert that the size of the union is equal to the size of the as_uint
+  // field since we are assigning to arbitrary types using it.
+  static_assert(sizeof(TraceArgValue) == sizeof(unsigned long long),
+                "Size of TraceArg value union is not equal to the size of "
+                "the uint field of that union.");
+};
+
+// Fixed size record of a trace event. Names and string arguments point to
+// strings owned by the caller, except when copies were requested through
+// TRACE_EVENT_FLAG_COPY or TRACE_VALUE_TYPE_COPY_STRING. Those copies are
+// owned by the record and freed with FreeCopiedStrings().
+struct TraceRecord {
+  const char* name;
+  unsigned long long id;
+  uint64_t timestamp;
+  uint32_t tid;
+  uint8_t category;
+  char phase;
+  unsigned char flags;
+  uint8_t num_args;
+  TraceArg args[kMaxTraceArgs];
+};
+
+char* CopyString(const char* str) {
+  // Space for the string and for the terminating null character.
+  size_t str_length = strlen(str) + 1;
+  char* str_copy = new char[str_length];
+  memcpy(str_copy, str, str_length);
+  return str_copy;
+}
+
+void FreeCopiedStrings(TraceRecord* record) {
+  if (record->flags & TRACE_EVENT_FLAG_COPY) {
+    delete[] record->name;
+    record->name = nullptr;
+  }
+  for (int i = 0; i < record->num_args; ++i) {
+    TraceArg& arg = record->args[i];
+    if (arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
+      delete[] arg.value.as_string;
+      arg.value.as_string = nullptr;
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+// Categories
+//////////////////////////////////////////////////////////////////////
+
+// The macros in trace_event.h cache the pointer returned for a category at
+// each call site and check the byte it points to before adding an event. The
+// bytes are only set while capturing and for categories that pass the filter,
+// so disabled call sites never call into the tracer. Entries are therefore
+// never moved or removed.
+const int kMaxCategories = 256;
+unsigned char g_category_enabled[kMaxCategories];
+const char* g_category_names[kMaxCategories];
+volatile int g_num_categories = 0;
+
+// Protects registration of categories and |g_category_filter|.
+GlobalLockPod g_category_lock;
+// Comma separated category names, or nullptr for all categories that are not
+// disabled by default.
+std::string* g_category_filter = nullptr;
+
+static const char* const kDisabledTracePrefix = TRACE_DISABLED_BY_DEFAULT("");
+
+bool IsDisabledByDefault(const char* name) {
+  const char* prefix_ptr = &kDisabledTracePrefix[0];
+  const char* name_ptr = name;
+  // Check whether name contains the default-disabled prefix.
+  while (*prefix_ptr == *name_ptr && *prefix_ptr != '\0') {
+    ++prefix_ptr;
+    ++name_ptr;
+  }
+  return *prefix_ptr == '\0';
+}
+
+bool CategoryPassesFilter(const char* name) {
+  if (!g_category_filter)
+    return !IsDisabledByDefault(name);
+
+  size_t pos = 0;
+  while (pos <= g_category_filter->size()) {
+    size_t end = g_category_filter->find(',', pos);
+    if (end == std::string::npos)
+      end = g_category_filter->size();
+    if (g_category_filter->compare(pos, end - pos, "*") == 0) {
+      if (!IsDisabledByDefault(name))
+        return true;
+    } else if (g_category_filter->compare(pos, end - pos, name) == 0) {
+      return true;
+    }
+    pos = end + 1;
+  }
+  return false;
+}
+
+unsigned char CategoryFlag(const char* name) {
+  return (rtc::AtomicOps::AcquireLoad(&g_event_logging_active) &&
+          CategoryPassesFilter(name))
+             ? 1
+             : 0;
+}
+
+// Updates the enabled bytes after capture was started or stopped or the
+// filter was changed.
+void UpdateCategoryFlags() {
+  GlobalLockScope lock(&g_category_lock);
+  int num_categories = rtc::AtomicOps::AcquireLoad(&g_num_categories);
+  for (int i = 0; i < num_categories; ++i)
+    g_category_enabled[i] = CategoryFlag(g_category_names[i]);
+}
+
+const unsigned char* FindCategory(const char* name, int num_categories) {
+  for (int i = 0; i < num_categories; ++i) {
+    if (strcmp(g_category_names[i], name) == 0)
+      return &g_category_enabled[i];
+  }
+  return nullptr;
+}
+
+//////////////////////////////////////////////////////////////////////
+// ThreadBuffer
+//////////////////////////////////////////////////////////////////////
+
+// Single producer, single consumer ring of trace records. Each thread that
+// adds trace events owns one buffer, which only that thread writes to and only
+// the logging thread reads from, so neither side takes a lock. Buffers are
+// never freed; the buffer of a thread that exits is reused by the next thread
+// that needs one.
+class ThreadBuffer {
+ public:
+  ThreadBuffer() : records_(new TraceRecord[kThreadBufferCapacity]) {}
+
+  // Returns the slot for the next record, or nullptr if the buffer is full.
+  // Must be followed by EndWrite() to publish the record. Called on the owning
+  // thread.
+  TraceRecord* BeginWrite() {
+    uint32_t write_index = static_cast<uint32_t>(writer_.write_index);
+    uint32_t read_index =
+        static_cast<uint32_t>(rtc::AtomicOps::AcquireLoad(&reader_.read_index));
+    if (write_index - read_index >= kThreadBufferCapacity) {
+      rtc::AtomicOps::Increment(&writer_.num_dropped);
+      return nullptr;
+    }
+    return &records_[write_index % kThreadBufferCapacity];
+  }
+
+  void EndWrite() {
+    uint32_t write_index = static_cast<uint32_t>(writer_.write_index);
+    rtc::AtomicOps::ReleaseStore(&writer_.write_index,
+                                 static_cast<int>(write_index + 1));
+  }
+
+  // Moves all published records to |records|. Called on the logging thread.
+  void Read(std::vector<TraceRecord>* records) {
+    uint32_t read_index = static_cast<uint32_t>(reader_.read_index);
+    uint32_t write_index = static_cast<uint32_t>(
+        rtc::AtomicOps::AcquireLoad(&writer_.write_index));
+    for (; read_index != write_index; ++read_index)
+      records->push_back(records_[read_index % kThreadBufferCapacity]);
+    rtc::AtomicOps::ReleaseStore(&reader_.read_index,
+                                 static_cast<int>(read_index));
+  }
+
+  // Returns the number of dropped events since the last call.
+  int TakeNumDropped() {
+    int num_dropped = rtc::AtomicOps::AcquireLoad(&writer_.num_dropped);
+    while (num_dropped != 0) {
+      int previous =
+          rtc::AtomicOps::CompareAndSwap(&writer_.num_dropped, num_dropped, 0);
+      if (previous == num_dropped)
+        break;
+      num_dropped = previous;
+    }
+    return num_dropped;
+  }
+
+  // Decides whether an event is recorded when sampling. Begin and end events
+  // of a scope get the same decision, as do events sharing an async id.
+  // Called on the owning thread.
+  bool ShouldSample(char phase,
+                    unsigned char flags,
+                    unsigned long long id,
+                    int interval) {
+    if (phase == TRACE_EVENT_PHASE_BEGIN) {
+      bool sampled = (num_sampling_decisions_++ % interval) == 0;
+      if (scope_depth_ < kMaxSampledScopeDepth) {
+        if (sampled)
+          sampled_scopes_ |= (1ull << scope_depth_);
+        else
+          sampled_scopes_ &= ~(1ull << scope_depth_);
+      } else {
+        // Too deep to remember; record both begin and end.
+        sampled = true;
+      }
+      ++scope_depth_;
+      return sampled;
+    }
+    if (phase == TRACE_EVENT_PHASE_END) {
+      // An end without a begin can be seen if sampling was enabled inside a
+      // scope.
+      if (scope_depth_ == 0)
+        return true;
+      --scope_depth_;
+      return scope_depth_ >= kMaxSampledScopeDepth ||
+             (sampled_scopes_ & (1ull << scope_depth_)) != 0;
+    }
+    if (flags & TRACE_EVENT_FLAG_HAS_ID)
+      return ((id * 0x9E3779B97F4A7C15ull) >> 32) % interval == 0;
+    return (num_sampling_decisions_++ % interval) == 0;
+  }
+
+  // Returns an unused buffer that the logging thread has drained, creating
+  // one if there is none. Called on the thread that will own the buffer.
+  static ThreadBuffer* Acquire() {
+    ThreadBuffer* buffer = AcquireUnused();
+    // Looking up the thread id is a system call on some platforms, so it is
+    // done once per thread rather than for every event.
+    buffer->thread_id_ = static_cast<uint32_t>(rtc::CurrentThreadId());
+    return buffer;
+  }
+
+  // Called on the owning thread when it exits.
+  void Release() {
+    num_sampling_decisions_ = 0;
+    scope_depth_ = 0;
+    rtc::AtomicOps::ReleaseStore(&in_use_, 0);
+  }
+
+  uint32_t thread_id() const { return thread_id_; }
+
+  static ThreadBuffer* First() {
+    return rtc::AtomicOps::AcquireLoadPtr(&buffers_);
+  }
+  ThreadBuffer* next() const { return next_; }
+
+ private:
+  static const int kMaxSampledScopeDepth = 64;
+
+  static ThreadBuffer* AcquireUnused() {
+    ThreadBuffer* head = rtc::AtomicOps::AcquireLoadPtr(&buffers_);
+    for (ThreadBuffer* buffer = head; buffer; buffer = buffer->next_) {
+      if (rtc::AtomicOps::AcquireLoad(&buffer->in_use_) == 0 &&
+          rtc::AtomicOps::CompareAndSwap(&buffer->in_use_, 0, 1) == 0) {
+        if (buffer->IsEmpty())
+          return buffer;
+        rtc::AtomicOps::ReleaseStore(&buffer->in_use_, 0);
+      }
+    }
+    ThreadBuffer* buffer = new ThreadBuffer();
+    buffer->in_use_ = 1;
+    while (true) {
+      buffer->next_ = head;
+      ThreadBuffer* previous =
+          rtc::AtomicOps::CompareAndSwapPtr(&buffers_, head, buffer);
+      if (previous == head)
+        return buffer;
+      head = previous;
+    }
+  }
+
+  bool IsEmpty() const {
+    return rtc::AtomicOps::AcquireLoad(&reader_.read_index) ==
+           rtc::AtomicOps::AcquireLoad(&writer_.write_index);
+  }
+
+  // All buffers ever created.
+  static ThreadBuffer* volatile buffers_;
+
+  const std::unique_ptr<TraceRecord[]> records_;
+  ThreadBuffer* next_ = nullptr;
+  volatile int in_use_ = 0;
+  uint32_t thread_id_ = 0;
+  // Sampling state, only accessed by the owning thread.
+  uint32_t num_sampling_decisions_ = 0;
+  int scope_depth_ = 0;
+  uint64_t sampled_scopes_ = 0;
+  // The indices are written by different threads, so they are kept on
+  // separate cache lines, from each other and from the fields above. They are
+  // padded rather than aligned, since buffers are allocated with plain new.
+  // Written by the owning thread.
+  struct {
+    char padding[kCacheLineSize];
+    volatile int write_index = 0;
+    volatile int num_dropped = 0;
+  } writer_;
+  // Written by the logging thread.
+  struct {
+    char padding[kCacheLineSize - 2 * sizeof(int)];
+    volatile int read_index = 0;
+  } reader_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ThreadBuffer);
+};
+
+ThreadBuffer* volatile ThreadBuffer::buffers_ = nullptr;
+
+#if defined(WEBRTC_WIN)
+DWORD g_thread_buffer_tls = FLS_OUT_OF_INDEXES;
+
+VOID NTAPI ReleaseThreadBuffer(PVOID buffer) {
+  if (buffer)
+    static_cast<ThreadBuffer*>(buffer)->Release();
+}
+
+BOOL CALLBACK InitializeTls(PINIT_ONCE init_once, void* param, void** context) {
+  // Fiber local storage, unlike TlsAlloc(), calls back when the thread exits.
+  g_thread_buffer_tls = FlsAlloc(&ReleaseThreadBuffer);
+  return TRUE;
+}
+
+ThreadBuffer* GetThreadBuffer() {
+  static INIT_ONCE init_once = INIT_ONCE_STATIC_INIT;
+  ::InitOnceExecuteOnce(&init_once, InitializeTls, nullptr, nullptr);
+  ThreadBuffer* buffer =
+      static_cast<ThreadBuffer*>(FlsGetValue(g_thread_buffer_tls));
+  if (!buffer) {
+    buffer = ThreadBuffer::Acquire();
+    FlsSetValue(g_thread_buffer_tls, buffer);
+  }
+  return buffer;
+}
+#else
+pthread_key_t g_thread_buffer_tls = 0;
+
+void ReleaseThreadBuffer(void* buffer) {
+  static_cast<ThreadBuffer*>(buffer)->Release();
+}
+
+void InitializeTls() {
+  RTC_CHECK(pthread_key_create(&g_thread_buffer_tls, &ReleaseThreadBuffer) ==
+            0);
+}
+
+ThreadBuffer* GetThreadBuffer() {
+  static pthread_once_t init_once = PTHREAD_ONCE_INIT;
+  RTC_CHECK(pthread_once(&init_once, &InitializeTls) == 0);
+  ThreadBuffer* buffer =
+      static_cast<ThreadBuffer*>(pthread_getspecific(g_thread_buffer_tls));
+  if (!buffer) {
+    buffer = ThreadBuffer::Acquire();
+    pthread_setspecific(g_thread_buffer_tls, buffer);
+  }
+  return buffer;
+}
+#endif  // defined(WEBRTC_WIN)
+
+//////////////////////////////////////////////////////////////////////
+// Output
+//////////////////////////////////////////////////////////////////////
+
+std::string TraceArgValueAsString(TraceArg arg) {
+  std::string output;
+
+  if (arg.type == TRACE_VALUE_TYPE_STRING ||
+      arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
+    // Space for every character to be an espaced character + two for
+    // quatation marks.
+    output.reserve(strlen(arg.value.as_string) * 2 + 2);
+    output += '\"';
+    const char* c = arg.value.as_string;
+    do {
+      if (*c == '"' || *c == '\\') {
+        output += '\\';
+        output += *c;
+      } else {
+        output += *c;
+      }
+    } while (*++c);
+    output += '\"';
+  } else {
+    output.resize(kTraceArgBufferLength);
+    size_t print_length = 0;
+    switch (arg.type) {
+      case TRACE_VALUE_TYPE_BOOL:
+        if (arg.value.as_bool) {
+          strcpy(&output[0], "true");
+          print_length = 4;
+        } else {
+          strcpy(&output[0], "false");
+          print_length = 5;
+        }
+        break;
+      case TRACE_VALUE_TYPE_UINT:
+        print_length = sprintfn(&output[0], kTraceArgBufferLength, "%llu",
+                                arg.value.as_uint);
+        break;
+      case TRACE_VALUE_TYPE_INT:
+        print_length = sprintfn(&output[0], kTraceArgBufferLength, "%lld",
+                                arg.value.as_int);
+        break;
+      case TRACE_VALUE_TYPE_DOUBLE:
+        print_length = sprintfn(&output[0], kTraceArgBufferLength, "%f",
+                                arg.value.as_double);
+        break;
+      case TRACE_VALUE_TYPE_POINTER:
+        print_length = sprintfn(&output[0], kTraceArgBufferLength, "\"%p\"",
+                                arg.value.as_pointer);
+        break;
+    }
+    size_t output_length = print_length < kTraceArgBufferLength
+                               ? print_length
+                               : kTraceArgBufferLength - 1;
+    // This will hopefully be very close to nop. On most implementations, it
+    // just writes null byte and sets the length field of the string.
+    output.resize(output_length);
+  }
+
+  return output;
+}
+
+// The TraceEvent format is documented here:
+// https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview
+void WriteJsonEvent(FILE* file,
+                    bool is_first_event,
+                    const TraceRecord& e,
+                    const char* category) {
+  std::string args_str;
+  args_str.reserve(kEventLoggerArgsStrBufferInitialSize);
+  if (e.flags & TRACE_EVENT_FLAG_HAS_ID) {
+    char id_str[kTraceArgBufferLength];
+    sprintfn(id_str, sizeof(id_str), ", \"id\": \"0x%llx\"", e.id);
+    args_str += id_str;
+  }
+  if (e.num_args > 0) {
+    args_str += ", \"args\": {";
+    for (int i = 0; i < e.num_args; ++i) {
+      if (i > 0)
+        args_str += ",";
+      args_str += " \"";
+      args_str += e.args[i].name;
+      args_str += "\": ";
+      args_str += TraceArgValueAsString(e.args[i]);
+    }
+    args_str += " }";
+  }
+  fprintf(file,
+          "%s{ \"name\": \"%s\""
+          ", \"cat\": \"%s\""
+          ", \"ph\": \"%c\""
+          ", \"ts\": %" PRIu64
+          ", \"pid\": %d"
+          ", \"tid\": %" PRIu32
+          "%s"
+          "}\n",
+          is_first_event ? " " : ",", e.name, category, e.phase, e.timestamp,
+          1, e.tid, args_str.c_str());
+}
+
+// Writes the compact binary format read by ConvertInternalBinaryCapture().
+// Strings that outlive the capture (event, category and argument names) are
+// written once and referred to by id afterwards.
+class BinaryTraceWriter {
+ public:
+  BinaryTraceWriter() {
+    buffer_.WriteBytes(kBinaryTraceMagic, sizeof(kBinaryTraceMagic) - 1);
+    buffer_.WriteUInt32(kBinaryTraceVersion);
+  }
+
+  void WriteEvent(const TraceRecord& e, const char* category) {
+    uint32_t name_id = (e.flags & TRACE_EVENT_FLAG_COPY)
+                           ? WriteString(e.name)
+                           : GetStringId(e.name);
+    uint32_t category_id = GetStringId(category);
+    uint32_t arg_name_ids[kMaxTraceArgs];
+    for (int i = 0; i < e.num_args; ++i)
+      arg_name_ids[i] = GetStringId(e.args[i].name);
+
+    buffer_.WriteUInt8(kEventRecord);
+    buffer_.WriteUInt8(static_cast<uint8_t>(e.phase));
+    buffer_.WriteUInt8(e.flags);
+    buffer_.WriteUInt8(e.num_args);
+    buffer_.WriteUInt32(name_id);
+    buffer_.WriteUInt32(category_id);
+    buffer_.WriteUInt64(e.timestamp);
+    buffer_.WriteUInt32(e.tid);
+    buffer_.WriteUInt64(e.id);
+    for (int i = 0; i < e.num_args; ++i) {
+      const TraceArg& arg = e.args[i];
+      buffer_.WriteUInt32(arg_name_ids[i]);
+      buffer_.WriteUInt8(arg.type);
+      if (arg.type == TRACE_VALUE_TYPE_STRING ||
+          arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
+        size_t length = strlen(arg.value.as_string);
+        buffer_.WriteUInt32(static_cast<uint32_t>(length));
+        buffer_.WriteBytes(arg.value.as_string, length);
+      } else {
+        buffer_.WriteUInt64(arg.value.as_uint);
+      }
+    }
+  }
+
+  void WriteDroppedEvents(int num_dropped) {
+    buffer_.WriteUInt8(kDroppedEventsRecord);
+    buffer_.WriteUInt32(static_cast<uint32_t>(num_dropped));
+  }
+
+  void Flush(FILE* file) {
+    fwrite(buffer_.Data(), 1, buffer_.Length(), file);
+    buffer_.Clear();
+  }
+
+ private:
+  uint32_t GetStringId(const char* str) {
+    auto it = string_ids_.find(str);
+    if (it != string_ids_.end())
+      return it->second;
+    uint32_t id = WriteString(str);
+    string_ids_[str] = id;
+    return id;
+  }
+
+  uint32_t WriteString(const char* str) {
+    uint32_t id = next_string_id_++;
+    size_t length = strlen(str);
+    buffer_.WriteUInt8(kStringRecord);
+    buffer_.WriteUInt32(id);
+    buffer_.WriteUInt32(static_cast<uint32_t>(length));
+    buffer_.WriteBytes(str, length);
+    return id;
+  }
+
+  ByteBufferWriter buffer_;
+  std::map<const char*, uint32_t> string_ids_;
+  uint32_t next_string_id_ = 0;
+};
+
+//////////////////////////////////////////////////////////////////////
+// EventLogger
+//////////////////////////////////////////////////////////////////////
+
 class EventLogger final {
  public:
   EventLogger()
@@ -99,116 +676,117 @@ class EventLogger final {
   void AddTraceEvent(const char* name,
                      const unsigned char* category_enabled,
                      char phase,
+                     unsigned long long id,
+                     unsigned char flags,
                      int num_args,
                      const char** arg_names,
                      const unsigned char* arg_types,
-                     const unsigned long long* arg_values,
-                     uint64_t timestamp,
-                     int pid,
-                     rtc::PlatformThreadId thread_id) {
-    std::vector<TraceArg> args(num_args);
+                     const unsigned long long* arg_values) {
+    // Call sites cache the category pointer, which may come from a tracer
+    // that was set up before this one.
+    if (category_enabled < &g_category_enabled[0] ||
+        category_enabled >= &g_category_enabled[kMaxCategories]) {
+      return;
+    }
+    ThreadBuffer* buffer = GetThreadBuffer();
+    int sampling_interval = rtc::AtomicOps::AcquireLoad(&g_sampling_interval);
+    if (sampling_interval > 1 &&
+        !buffer->ShouldSample(phase, flags, id, sampling_interval)) {
+      return;
+    }
+    TraceRecord* record = buffer->BeginWrite();
+    if (!record)
+      return;
+
+    RTC_DCHECK_LE(num_args, kMaxTraceArgs);
+    record->name = (flags & TRACE_EVENT_FLAG_COPY) ? CopyString(name) : name;
+    record->id = id;
+    record->timestamp = rtc::TimeMicros();
+    record->tid = buffer->thread_id();
+    record->category =
+        static_cast<uint8_t>(category_enabled - g_category_enabled);
+    record->phase = phase;
+    record->flags = flags;
+    record->num_args = static_cast<uint8_t>(num_args);
     for (int i = 0; i < num_args; ++i) {
-      TraceArg& arg = args[i];
+      TraceArg& arg = record->args[i];
       arg.name = arg_names[i];
       arg.type = arg_types[i];
       arg.value.as_uint = arg_values[i];
 
       // Value is a pointer to a temporary string, so we have to make a copy.
-      if (arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
-        // Space for the string and for the terminating null character.
-        size_t str_length = strlen(arg.value.as_string) + 1;
-        char* str_copy = new char[str_length];
-        memcpy(str_copy, arg.value.as_string, str_length);
-        arg.value.as_string = str_copy;
-      }
+      if (arg.type == TRACE_VALUE_TYPE_COPY_STRING)
+        arg.value.as_string = CopyString(arg.value.as_string);
     }
-    rtc::CritScope lock(&crit_);
-    trace_events_.push_back(
-        {name, category_enabled, phase, args, timestamp, 1, thread_id});
+    buffer->EndWrite();
   }
 
-// The TraceEvent format is documented here:
-// https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview
   void Log() {
     RTC_DCHECK(output_file_);
     static const int kLoggingIntervalMs = 100;
-    fprintf(output_file_, "{ \"traceEvents\": [\n");
+    std::unique_ptr<BinaryTraceWriter> binary_writer;
+    if (binary_format_)
+      binary_writer.reset(new BinaryTraceWriter());
+    else
+      fprintf(output_file_, "{ \"traceEvents\": [\n");
     bool has_logged_event = false;
+    std::vector<TraceRecord> events;
     while (true) {
       bool shutting_down = shutdown_event_.Wait(kLoggingIntervalMs);
-      std::vector<TraceEvent> events;
-      {
-        rtc::CritScope lock(&crit_);
-        trace_events_.swap(events);
-      }
-      std::string args_str;
-      args_str.reserve(kEventLoggerArgsStrBufferInitialSize);
-      for (TraceEvent& e : events) {
-        args_str.clear();
-        if (!e.args.empty()) {
-          args_str += ", \"args\": {";
-          bool is_first_argument = true;
-          for (TraceArg& arg : e.args) {
-            if (!is_first_argument)
-              args_str += ",";
-            is_first_argument = false;
-            args_str += " \"";
-            args_str += arg.name;
-            args_str += "\": ";
-            args_str += TraceArgValueAsString(arg);
-
-            // Delete our copy of the string.
-            if (arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
-              delete[] arg.value.as_string;
-              arg.value.as_string = nullptr;
-            }
+      int num_dropped = 0;
+      for (ThreadBuffer* buffer = ThreadBuffer::First(); buffer;
+           buffer = buffer->next()) {
+        events.clear();
+        buffer->Read(&events);
+        num_dropped += buffer->TakeNumDropped();
+        for (TraceRecord& e : events) {
+          const char* category = g_category_names[e.category];
+          if (binary_writer) {
+            binary_writer->WriteEvent(e, category);
+          } else {
+            WriteJsonEvent(output_file_, !has_logged_event, e, category);
+            has_logged_event = true;
           }
-          args_str += " }";
+          FreeCopiedStrings(&e);
         }
-        fprintf(output_file_,
-                "%s{ \"name\": \"%s\""
-                ", \"cat\": \"%s\""
-                ", \"ph\": \"%c\""
-                ", \"ts\": %" PRIu64
-                ", \"pid\": %d"
-#if defined(WEBRTC_WIN)
-                ", \"tid\": %lu"
-#else
-                ", \"tid\": %d"
-#endif  // defined(WEBRTC_WIN)
-                "%s"
-                "}\n",
-                has_logged_event ? "," : " ", e.name, e.category_enabled,
-                e.phase, e.timestamp, e.pid, e.tid, args_str.c_str());
-        has_logged_event = true;
       }
+      if (num_dropped > 0) {
+        LOG(LS_WARNING) << "Dropped " << num_dropped << " trace events.";
+        if (binary_writer)
+          binary_writer->WriteDroppedEvents(num_dropped);
+      }
+      if (binary_writer)
+        binary_writer->Flush(output_file_);
+      // Flush continuously so that the trace survives a crash.
+      fflush(output_file_);
       if (shutting_down)
         break;
     }
-    fprintf(output_file_, "]}\n");
+    if (!binary_writer)
+      fprintf(output_file_, "]}\n");
     if (output_file_owned_)
       fclose(output_file_);
     output_file_ = nullptr;
   }
 
-  void Start(FILE* file, bool owned) {
+  void Start(FILE* file, bool owned, bool binary_format) {
     RTC_DCHECK(thread_checker_.CalledOnValidThread());
     RTC_DCHECK(file);
     RTC_DCHECK(!output_file_);
     output_file_ = file;
     output_file_owned_ = owned;
-    {
-      rtc::CritScope lock(&crit_);
-      // Since the atomic fast-path for adding events to the queue can be
-      // bypassed while the logging thread is shutting down there may be some
-      // stale events in the queue, hence the vector needs to be cleared to not
-      // log events from a previous logging session (which may be days old).
-      trace_events_.clear();
-    }
+    binary_format_ = binary_format;
+    // Since the atomic fast-path for adding events can be bypassed while the
+    // logging thread is shutting down there may be some stale events in the
+    // buffers, hence they need to be cleared to not log events from a
+    // previous logging session (which may be days old).
+    DiscardBufferedEvents();
+
     // Enable event logging (fast-path). This should be disabled since starting
     // shouldn't be done twice.
     RTC_CHECK_EQ(0,
                  rtc::AtomicOps::CompareAndSwap(&g_event_logging_active, 0, 1));
+    UpdateCategoryFlags();
 
     // Finally start, everything should be set up now.
     logging_thread_.Start();
@@ -221,111 +799,38 @@ class EventLogger final {
     // Try to stop. Abort if we're not currently logging.
     if (rtc::AtomicOps::CompareAndSwap(&g_event_logging_active, 1, 0) == 0)
       return;
+    UpdateCategoryFlags();
 
     // Wake up logging thread to finish writing.
     shutdown_event_.Set();
     // Join the logging thread.
     logging_thread_.Stop();
+    // Free the strings copied for events that were added after the logging
+    // thread's last read, rather than holding on to them until the next
+    // Start().
+    DiscardBufferedEvents();
   }
 
  private:
-  struct TraceArg {
-    const char* name;
-    unsigned char type;
-    // Copied from webrtc/rtc_base/trace_event.h TraceValueUnion.
-    union TraceArgValue {
-      bool as_bool;
-      unsigned long long as_uint;
-      long long as_int;
-      double as_double;
-      const void* as_pointer;
-      const char* as_string;
-    } value;
-
-    // Assert that the size of the union is equal to the size of the as_uint
-    // field since we are assigning to arbitrary types using it.
-    static_assert(sizeof(TraceArgValue) == sizeof(unsigned long long),
-                  "Size of TraceArg value union is not equal to the size of "
-                  "the uint field of that union.");
-  };
-
-  struct TraceEvent {
-    const char* name;
-    const unsigned char* category_enabled;
-    char phase;
-    std::vector<TraceArg> args;
-    uint64_t timestamp;
-    int pid;
-    rtc::PlatformThreadId tid;
-  };
-
-  static std::string TraceArgValueAsString(TraceArg arg) {
-    std::string output;
-
-    if (arg.type == TRACE_VALUE_TYPE_STRING ||
-        arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
-      // Space for every character to be an espaced character + two for
-      // quatation marks.
-      output.reserve(strlen(arg.value.as_string) * 2 + 2);
-      output += '\"';
-      const char* c = arg.value.as_string;
-      do {
-        if (*c == '"' || *c == '\\') {
-          output += '\\';
-          output += *c;
-        } else {
-          output += *c;
-        }
-      } while (*++c);
-      output += '\"';
-    } else {
-      output.resize(kTraceArgBufferLength);
-      size_t print_length = 0;
-      switch (arg.type) {
-        case TRACE_VALUE_TYPE_BOOL:
-          if (arg.value.as_bool) {
-            strcpy(&output[0], "true");
-            print_length = 4;
-          } else {
-            strcpy(&output[0], "false");
-            print_length = 5;
-          }
-          break;
-        case TRACE_VALUE_TYPE_UINT:
-          print_length = sprintfn(&output[0], kTraceArgBufferLength, "%llu",
-                                  arg.value.as_uint);
-          break;
-        case TRACE_VALUE_TYPE_INT:
-          print_length = sprintfn(&output[0], kTraceArgBufferLength, "%lld",
-                                  arg.value.as_int);
-          break;
-        case TRACE_VALUE_TYPE_DOUBLE:
-          print_length = sprintfn(&output[0], kTraceArgBufferLength, "%f",
-                                  arg.value.as_double);
-          break;
-        case TRACE_VALUE_TYPE_POINTER:
-          print_length = sprintfn(&output[0], kTraceArgBufferLength, "\"%p\"",
-                                  arg.value.as_pointer);
-          break;
-      }
-      size_t output_length = print_length < kTraceArgBufferLength
-                                 ? print_length
-                                 : kTraceArgBufferLength - 1;
-      // This will hopefully be very close to nop. On most implementations, it
-      // just writes null byte and sets the length field of the string.
-      output.resize(output_length);
+  // Drops the events in the buffers. Must not be called while the logging
+  // thread is running, since it reads the buffers too.
+  void DiscardBufferedEvents() {
+    std::vector<TraceRecord> events;
+    for (ThreadBuffer* buffer = ThreadBuffer::First(); buffer;
+         buffer = buffer->next()) {
+      buffer->Read(&events);
+      buffer->TakeNumDropped();
     }
-
-    return output;
+    for (TraceRecord& e : events)
+      FreeCopiedStrings(&e);
   }
 
-  rtc::CriticalSection crit_;
-  std::vector<TraceEvent> trace_events_ RTC_GUARDED_BY(crit_);
   rtc::PlatformThread logging_thread_;
   rtc::Event shutdown_event_;
   rtc::ThreadChecker thread_checker_;
   FILE* output_file_ = nullptr;
   bool output_file_owned_ = false;
+  bool binary_format_ = false;
 };
 
 static void EventTracingThreadFunc(void* params) {
@@ -333,17 +838,30 @@ static void EventTracingThreadFunc(void* params) {
 }
 
 static EventLogger* volatile g_event_logger = nullptr;
-static const char* const kDisabledTracePrefix = TRACE_DISABLED_BY_DEFAULT("");
+
 const unsigned char* InternalGetCategoryEnabled(const char* name) {
-  const char* prefix_ptr = &kDisabledTracePrefix[0];
-  const char* name_ptr = name;
-  // Check whether name contains the default-disabled prefix.
-  while (*prefix_ptr == *name_ptr && *prefix_ptr != '\0') {
-    ++prefix_ptr;
-    ++name_ptr;
+  const unsigned char* category_enabled =
+      FindCategory(name, rtc::AtomicOps::AcquireLoad(&g_num_categories));
+  if (category_enabled)
+    return category_enabled;
+
+  GlobalLockScope lock(&g_category_lock);
+  int num_categories = rtc::AtomicOps::AcquireLoad(&g_num_categories);
+  // Another thread may have registered the category after the lookup above.
+  category_enabled = FindCategory(name, num_categories);
+  if (category_enabled)
+    return category_enabled;
+
+  if (num_categories == kMaxCategories) {
+    RTC_NOTREACHED() << "Too many trace categories, " << name
+                     << " will not be traced.";
+    // A string with null terminator means category is disabled.
+    return reinterpret_cast<const unsigned char*>("\0");
   }
-  return reinterpret_cast<const unsigned char*>(*prefix_ptr == '\0' ? ""
-                                                                    : name);
+  g_category_names[num_categories] = CopyString(name);
+  g_category_enabled[num_categories] = CategoryFlag(name);
+  rtc::AtomicOps::ReleaseStore(&g_num_categories, num_categories + 1);
+  return &g_category_enabled[num_categories];
 }
 
 void InternalAddTraceEvent(char phase,
@@ -359,9 +877,17 @@ void InternalAddTraceEvent(char phase,
   if (rtc::AtomicOps::AcquireLoad(&g_event_logging_active) == 0)
     return;
 
-  g_event_logger->AddTraceEvent(name, category_enabled, phase, num_args,
-                                arg_names, arg_types, arg_values,
-                                rtc::TimeMicros(), 1, rtc::CurrentThreadId());
+  g_event_logger->AddTraceEvent(name, category_enabled, phase, id, flags,
+                                num_args, arg_names, arg_types, arg_values);
+}
+
+FILE* OpenCaptureFile(const char* filename) {
+  FILE* file = fopen(filename, "wb");
+  if (!file) {
+    LOG(LS_ERROR) << "Failed to open trace file '" << filename
+                  << "' for writing.";
+  }
+  return file;
 }
 
 }  // namespace
@@ -373,9 +899,23 @@ void SetupInternalTracer() {
   webrtc::SetupEventTracer(InternalGetCategoryEnabled, InternalAddTraceEvent);
 }
 
+void SetInternalCaptureCategories(const char* categories) {
+  {
+    GlobalLockScope lock(&g_category_lock);
+    delete g_category_filter;
+    g_category_filter = categories ? new std::string(categories) : nullptr;
+  }
+  UpdateCategoryFlags();
+}
+
+void SetInternalCaptureSamplingInterval(int interval) {
+  RTC_DCHECK_GE(interval, 1);
+  rtc::AtomicOps::ReleaseStore(&g_sampling_interval, std::max(interval, 1));
+}
+
 void StartInternalCaptureToFile(FILE* file) {
   if (g_event_logger) {
-    g_event_logger->Start(file, false);
+    g_event_logger->Start(file, false, false);
   }
 }
 
@@ -383,13 +923,27 @@ bool StartInternalCapture(const char* filename) {
   if (!g_event_logger)
     return false;
 
-  FILE* file = fopen(filename, "w");
-  if (!file) {
-    LOG(LS_ERROR) << "Failed to open trace file '" << filename
-                  << "' for writing.";
+  FILE* file = OpenCaptureFile(filename);
+  if (!file)
     return false;
+  g_event_logger->Start(file, true, false);
+  return true;
+}
+
+void StartInternalBinaryCaptureToFile(FILE* file) {
+  if (g_event_logger) {
+    g_event_logger->Start(file, false, true);
   }
-  g_event_logger->Start(file, true);
+}
+
+bool StartInternalBinaryCapture(const char* filename) {
+  if (!g_event_logger)
+    return false;
+
+  FILE* file = OpenCaptureFile(filename);
+  if (!file)
+    return false;
+  g_event_logger->Start(file, true, true);
   return true;
 }
 
@@ -410,5 +964,96 @@ void ShutdownInternalTracer() {
   webrtc::SetupEventTracer(nullptr, nullptr);
 }
 
+bool ConvertInternalBinaryCapture(FILE* input, FILE* output) {
+  std::string data;
+  char chunk[4096];
+  size_t bytes_read;
+  while ((bytes_read = fread(chunk, 1, sizeof(chunk), input)) > 0)
+    data.append(chunk, bytes_read);
+
+  ByteBufferReader reader(data.data(), data.size());
+  std::string magic;
+  uint32_t version;
+  if (!reader.ReadString(&magic, sizeof(kBinaryTraceMagic) - 1) ||
+      magic != kBinaryTraceMagic || !reader.ReadUInt32(&version) ||
+      version != kBinaryTraceVersion) {
+    LOG(LS_ERROR) << "Not a binary trace.";
+    return false;
+  }
+
+  std::map<uint32_t, std::string> strings;
+  auto get_string = [&strings](uint32_t id) -> const char* {
+    auto it = strings.find(id);
+    return it == strings.end() ? "" : it->second.c_str();
+  };
+  fprintf(output, "{ \"traceEvents\": [\n");
+  bool has_logged_event = false;
+  // A capture that was not stopped may end in a partial record, which is
+  // ignored.
+  uint8_t type;
+  while (reader.ReadUInt8(&type)) {
+    if (type == kStringRecord) {
+      uint32_t id;
+      uint32_t length;
+      std::string str;
+      if (!reader.ReadUInt32(&id) || !reader.ReadUInt32(&length) ||
+          !reader.ReadString(&str, length)) {
+        break;
+      }
+      strings[id] = std::move(str);
+    } else if (type == kEventRecord) {
+      TraceRecord e;
+      uint8_t phase;
+      uint32_t name_id;
+      uint32_t category_id;
+      uint64_t id;
+      if (!reader.ReadUInt8(&phase) || !reader.ReadUInt8(&e.flags) ||
+          !reader.ReadUInt8(&e.num_args) || !reader.ReadUInt32(&name_id) ||
+          !reader.ReadUInt32(&category_id) ||
+          !reader.ReadUInt64(&e.timestamp) || !reader.ReadUInt32(&e.tid) ||
+          !reader.ReadUInt64(&id) || e.num_args > kMaxTraceArgs) {
+        break;
+      }
+      e.id = id;
+      e.phase = static_cast<char>(phase);
+      e.name = get_string(name_id);
+      std::string string_values[kMaxTraceArgs];
+      bool complete = true;
+      for (int i = 0; i < e.num_args && complete; ++i) {
+        TraceArg& arg = e.args[i];
+        uint32_t arg_name_id;
+        complete = reader.ReadUInt32(&arg_name_id) &&
+                   reader.ReadUInt8(&arg.type);
+        arg.name = get_string(arg_name_id);
+        if (arg.type == TRACE_VALUE_TYPE_STRING ||
+            arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
+          uint32_t length;
+          complete = complete && reader.ReadUInt32(&length) &&
+                     reader.ReadString(&string_values[i], length);
+          arg.value.as_string = string_values[i].c_str();
+        } else {
+          uint64_t value;
+          complete = complete && reader.ReadUInt64(&value);
+          arg.value.as_uint = value;
+        }
+      }
+      if (!complete)
+        break;
+      WriteJsonEvent(output, !has_logged_event, e, get_string(category_id));
+      has_logged_event = true;
+    } else if (type == kDroppedEventsRecord) {
+      uint32_t num_dropped;
+      if (!reader.ReadUInt32(&num_dropped))
+        break;
+      LOG(LS_WARNING) << num_dropped << " trace events were dropped.";
+    } else {
+      LOG(LS_ERROR) << "Unknown record type " << static_cast<int>(type);
+      return false;
+    }
+  }
+  fprintf(output, "]}\n");
+  return true;
+}
+
 }  // namespace tracing
 }  // namespace rtc
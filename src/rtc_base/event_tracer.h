@@ -74,11 +74,26 @@ namespace rtc {
 namespace tracing {
 // Set up internal event tracer.
 void SetupInternalTracer();
+// Restricts capture to a comma separated list of categories, where "*" stands
+// for all categories that are not disabled by default. nullptr, the default,
+// is the same as "*". Can be changed while capturing.
+void SetInternalCaptureCategories(const char* categories);
+// Records only one in |interval| events. Begin and end events of a scope are
+// sampled together. Defaults to 1, recording all events.
+void SetInternalCaptureSamplingInterval(int interval);
+// Captures events in the Chrome trace event JSON format.
 bool StartInternalCapture(const char* filename);
 void StartInternalCaptureToFile(FILE* file);
+// Captures events in a compact binary format, which is cheaper to write and
+// can be converted with ConvertInternalBinaryCapture().
+bool StartInternalBinaryCapture(const char* filename);
+void StartInternalBinaryCaptureToFile(FILE* file);
 void StopInternalCapture();
 // Make sure we run this, this will tear down the internal tracing.
 void ShutdownInternalTracer();
+// Converts a binary capture to the Chrome trace event JSON format. Returns
+// false if |input| is not a binary capture.
+bool ConvertInternalBinaryCapture(FILE* input, FILE* output);
 }  // namespace tracing
 }  // namespace rtc
 
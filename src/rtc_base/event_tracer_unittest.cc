@@ -10,6 +10,16 @@
 
 #include "rtc_base/event_tracer.h"
 
+#include <stdio.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rtc_base/event.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/timeutils.h"
 #include "rtc_base/trace_event.h"
 #include "system_wrappers/include/static_instance.h"
 #include "test/gtest.h"
@@ -58,6 +68,32 @@ static void AddTraceEventHandler(char phase,
   TestStatistics::Get()->Increment();
 }
 
+std::string ReadFile(FILE* file) {
+  std::string contents;
+  rewind(file);
+  char buffer[4096];
+  size_t bytes_read;
+  while ((bytes_read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    contents.append(buffer, bytes_read);
+  return contents;
+}
+
+int CountOccurrences(const std::string& str, const std::string& substr) {
+  int count = 0;
+  for (size_t pos = str.find(substr); pos != std::string::npos;
+       pos = str.find(substr, pos + 1)) {
+    ++count;
+  }
+  return count;
+}
+
+const int kNumEventsPerThread = 1000;
+
+void AddInstantEvents(void* obj) {
+  for (int i = 0; i < kNumEventsPerThread; ++i)
+    TRACE_EVENT_INSTANT0("webrtc", "ThreadEvent");
+}
+
 }  // namespace
 
 namespace webrtc {
@@ -79,4 +115,163 @@ TEST(EventTracerTest, ScopedTraceEvent) {
   TestStatistics::Get()->Reset();
 }
 
+class InternalTracerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    rtc::tracing::SetupInternalTracer();
+    file_ = tmpfile();
+    ASSERT_TRUE(file_);
+  }
+
+  void TearDown() override {
+    rtc::tracing::ShutdownInternalTracer();
+    rtc::tracing::SetInternalCaptureCategories(nullptr);
+    rtc::tracing::SetInternalCaptureSamplingInterval(1);
+    fclose(file_);
+  }
+
+  FILE* file_ = nullptr;
+};
+
+TEST_F(InternalTracerTest, CapturesJson) {
+  rtc::tracing::StartInternalCaptureToFile(file_);
+  {
+    TRACE_EVENT1("webrtc", "JsonEvent", "value", 42);
+    TRACE_EVENT_INSTANT1("webrtc", "CopiedArgument", "str",
+                         TRACE_STR_COPY(std::string("copied").c_str()));
+  }
+  rtc::tracing::StopInternalCapture();
+
+  std::string json = ReadFile(file_);
+  EXPECT_EQ(0u, json.find("{ \"traceEvents\": ["));
+  EXPECT_EQ(2, CountOccurrences(json, "\"name\": \"JsonEvent\""));
+  EXPECT_EQ(1, CountOccurrences(json, "\"args\": { \"value\": 42 }"));
+  EXPECT_EQ(1, CountOccurrences(json, "\"args\": { \"str\": \"copied\" }"));
+}
+
+TEST_F(InternalTracerTest, FiltersCategories) {
+  rtc::tracing::SetInternalCaptureCategories(
+      "included," TRACE_DISABLED_BY_DEFAULT("included"));
+  rtc::tracing::StartInternalCaptureToFile(file_);
+  TRACE_EVENT_INSTANT0("included", "IncludedEvent");
+  TRACE_EVENT_INSTANT0("excluded", "ExcludedEvent");
+  TRACE_EVENT_INSTANT0(TRACE_DISABLED_BY_DEFAULT("included"),
+                       "DisabledByDefaultEvent");
+  rtc::tracing::StopInternalCapture();
+
+  std::string json = ReadFile(file_);
+  EXPECT_EQ(1, CountOccurrences(json, "IncludedEvent"));
+  EXPECT_EQ(0, CountOccurrences(json, "ExcludedEvent"));
+  EXPECT_EQ(1, CountOccurrences(json, "DisabledByDefaultEvent"));
+}
+
+TEST_F(InternalTracerTest, CategoriesAreDisabledWhenNotCapturing) {
+  const unsigned char* category_enabled =
+      TRACE_EVENT_API_GET_CATEGORY_ENABLED("webrtc");
+  EXPECT_FALSE(*category_enabled);
+  rtc::tracing::StartInternalCaptureToFile(file_);
+  EXPECT_TRUE(*category_enabled);
+  rtc::tracing::SetInternalCaptureCategories("other");
+  EXPECT_FALSE(*category_enabled);
+  rtc::tracing::StopInternalCapture();
+}
+
+TEST_F(InternalTracerTest, SamplesScopesTogether) {
+  rtc::tracing::SetInternalCaptureSamplingInterval(4);
+  rtc::tracing::StartInternalCaptureToFile(file_);
+  for (int i = 0; i < 100; ++i) {
+    TRACE_EVENT0("webrtc", "Outer");
+    TRACE_EVENT0("webrtc", "Inner");
+  }
+  rtc::tracing::StopInternalCapture();
+
+  std::string json = ReadFile(file_);
+  int num_begin = CountOccurrences(json, "\"ph\": \"B\"");
+  EXPECT_EQ(50, num_begin);
+  EXPECT_EQ(num_begin, CountOccurrences(json, "\"ph\": \"E\""));
+}
+
+TEST_F(InternalTracerTest, ConvertsBinaryCaptureToJson) {
+  rtc::tracing::StartInternalBinaryCaptureToFile(file_);
+  {
+    TRACE_EVENT2("webrtc", "BinaryEvent", "value", -7, "flag", true);
+    TRACE_EVENT_ASYNC_BEGIN0("webrtc", "AsyncEvent", 0x1234);
+    TRACE_EVENT_INSTANT1("webrtc", "StringEvent", "str", "quoted \"str\"");
+  }
+  rtc::tracing::StopInternalCapture();
+
+  rewind(file_);
+  FILE* json_file = tmpfile();
+  ASSERT_TRUE(json_file);
+  EXPECT_TRUE(rtc::tracing::ConvertInternalBinaryCapture(file_, json_file));
+  std::string json = ReadFile(json_file);
+  fclose(json_file);
+
+  EXPECT_EQ(0u, json.find("{ \"traceEvents\": ["));
+  EXPECT_EQ(2, CountOccurrences(json, "\"name\": \"BinaryEvent\""));
+  EXPECT_EQ(1, CountOccurrences(
+                   json, "\"args\": { \"value\": -7, \"flag\": true }"));
+  EXPECT_EQ(1, CountOccurrences(json, "\"ph\": \"S\", "));
+  EXPECT_EQ(1, CountOccurrences(json, "\"id\": \"0x1234\""));
+  EXPECT_EQ(1, CountOccurrences(json, "\"str\": \"quoted \\\"str\\\"\""));
+}
+
+TEST_F(InternalTracerTest, RejectsNonBinaryCapture) {
+  fputs("{ \"traceEvents\": [\n]}\n", file_);
+  rewind(file_);
+  FILE* json_file = tmpfile();
+  ASSERT_TRUE(json_file);
+  EXPECT_FALSE(rtc::tracing::ConvertInternalBinaryCapture(file_, json_file));
+  fclose(json_file);
+}
+
+TEST_F(InternalTracerTest, CapturesEventsFromMultipleThreads) {
+  const int kNumThreads = 4;
+  rtc::tracing::StartInternalCaptureToFile(file_);
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back(
+        new rtc::PlatformThread(&AddInstantEvents, nullptr, "TraceThread"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+  rtc::tracing::StopInternalCapture();
+
+  std::string json = ReadFile(file_);
+  EXPECT_EQ(kNumThreads * kNumEventsPerThread,
+            CountOccurrences(json, "ThreadEvent"));
+}
+
+TEST_F(InternalTracerTest, DISABLED_AddEventPerformance) {
+  const int kNumEvents = 1000000;
+  int64_t start_ns = rtc::TimeNanos();
+  for (int i = 0; i < kNumEvents; ++i) {
+    TRACE_EVENT0("webrtc", "PerformanceEvent");
+  }
+  int64_t disabled_ns = rtc::TimeNanos() - start_ns;
+
+  // Add events in bursts that fit in the thread's buffer, giving the logging
+  // thread time to drain it in between, so that no events are dropped.
+  const int kNumBursts = 20;
+  const int kNumEventsPerBurst = 1000;
+  rtc::Event drained(false, false);
+  int64_t enabled_ns = 0;
+  rtc::tracing::StartInternalBinaryCaptureToFile(file_);
+  for (int burst = 0; burst < kNumBursts; ++burst) {
+    start_ns = rtc::TimeNanos();
+    for (int i = 0; i < kNumEventsPerBurst; ++i) {
+      TRACE_EVENT0("webrtc", "PerformanceEvent");
+    }
+    enabled_ns += rtc::TimeNanos() - start_ns;
+    drained.Wait(200);
+  }
+  rtc::tracing::StopInternalCapture();
+
+  LOG(LS_INFO) << "Scoped trace event: " << disabled_ns / kNumEvents
+               << " ns when not capturing, "
+               << enabled_ns / (kNumBursts * kNumEventsPerBurst)
+               << " ns when capturing.";
+}
+
 }  // namespace webrtc
@@ -0,0 +1,57 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_NUMERICS_HISTOGRAM_PERCENTILE_COUNTER_H_
+#define RTC_BASE_NUMERICS_HISTOGRAM_PERCENTILE_COUNTER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <vector>
+
+#include "api/optional.h"
+
+namespace rtc {
+
+// Calculates percentiles on a stream of non-negative integers, e.g. latencies
+// in milliseconds. Adding a value below |long_tail_boundary| is an array
+// increment; larger values are counted in a map. Unlike PercentileFilter, the
+// samples themselves are not stored, so memory does not grow with the number
+// of samples.
+class HistogramPercentileCounter {
+ public:
+  explicit HistogramPercentileCounter(uint32_t long_tail_boundary);
+  ~HistogramPercentileCounter();
+
+  void Add(uint32_t value);
+  void Add(uint32_t value, size_t count);
+  void Add(const HistogramPercentileCounter& other);
+
+  // |fraction| must be in [0, 1]. Returns the smallest value such that at
+  // least |fraction| of the samples are less than or equal to it, or nothing if
+  // no samples have been added.
+  rtc::Optional<uint32_t> GetPercentile(float fraction) const;
+  rtc::Optional<uint32_t> GetMax() const;
+
+  size_t NumSamples() const { return total_elements_; }
+  void Reset();
+
+ private:
+  std::vector<size_t> histogram_low_;
+  std::map<uint32_t, size_t> histogram_high_;
+  const uint32_t long_tail_boundary_;
+  size_t total_elements_;
+  size_t total_elements_low_;
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_NUMERICS_HISTOGRAM_PERCENTILE_COUNTER_H_
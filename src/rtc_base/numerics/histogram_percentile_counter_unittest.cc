@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/numerics/histogram_percentile_counter.h"
+
+#include <utility>
+#include <vector>
+
+#include "test/gtest.h"
+
+namespace rtc {
+
+TEST(HistogramPercentileCounterTest, ReturnsNothingWithoutSamples) {
+  HistogramPercentileCounter counter(10);
+  EXPECT_FALSE(counter.GetPercentile(0.5f));
+  EXPECT_FALSE(counter.GetMax());
+  EXPECT_EQ(0u, counter.NumSamples());
+}
+
+TEST(HistogramPercentileCounterTest, ReturnsCorrectPercentiles) {
+  HistogramPercentileCounter counter(10);
+  const std::vector<uint32_t> kValues = {1,  2,  3,  4,  5,  6,  7,  8,  9,  10,
+                                         11, 12, 13, 14, 15, 16, 17, 18, 19, 20};
+  for (uint32_t value : kValues)
+    counter.Add(value);
+
+  EXPECT_EQ(20u, counter.NumSamples());
+  EXPECT_EQ(1u, *counter.GetPercentile(0.0f));
+  EXPECT_EQ(10u, *counter.GetPercentile(0.5f));
+  EXPECT_EQ(19u, *counter.GetPercentile(0.95f));
+  EXPECT_EQ(20u, *counter.GetMax());
+}
+
+TEST(HistogramPercentileCounterTest, HandlesEmptySlots) {
+  HistogramPercentileCounter counter(10);
+  const std::vector<std::pair<uint32_t, size_t>> kCounts = {
+      {0, 2}, {5, 1}, {7, 1}, {15, 3}, {1000, 1}};
+  for (const auto& value_count : kCounts)
+    counter.Add(value_count.first, value_count.second);
+
+  EXPECT_EQ(0u, *counter.GetPercentile(0.0f));
+  EXPECT_EQ(0u, *counter.GetPercentile(0.25f));
+  EXPECT_EQ(7u, *counter.GetPercentile(0.5f));
+  EXPECT_EQ(15u, *counter.GetPercentile(0.85f));
+  EXPECT_EQ(1000u, *counter.GetMax());
+}
+
+TEST(HistogramPercentileCounterTest, AddsOtherCounter) {
+  HistogramPercentileCounter counter(10);
+  HistogramPercentileCounter other(20);
+  counter.Add(3);
+  other.Add(15, 2);
+  other.Add(100);
+  counter.Add(other);
+
+  EXPECT_EQ(4u, counter.NumSamples());
+  EXPECT_EQ(15u, *counter.GetPercentile(0.5f));
+  EXPECT_EQ(100u, *counter.GetMax());
+
+  counter.Reset();
+  EXPECT_EQ(0u, counter.NumSamples());
+  EXPECT_FALSE(counter.GetMax());
+}
+
+}  // namespace rtc
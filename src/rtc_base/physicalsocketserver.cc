@@ -1236,7 +1236,8 @@ PhysicalSocketServer::~PhysicalSocketServer() {
     close(epoll_fd_);
   }
 #endif
-  RTC_DCHECK(dispatchers_.empty());
+  RTC_DCHECK(dispatcher_by_key_.empty());
+  RTC_DCHECK(key_by_dispatcher_.empty());
 }
 
 void PhysicalSocketServer::WakeUp() {
@@ -1283,44 +1284,31 @@ AsyncSocket* PhysicalSocketServer::WrapSocket(SOCKET s) {
 
 void PhysicalSocketServer::Add(Dispatcher *pdispatcher) {
   CritScope cs(&crit_);
-  if (processing_dispatchers_) {
-    // A dispatcher is being added while a "Wait" call is processing the
-    // list of socket events.
-    // Defer adding to "dispatchers_" set until processing is done to avoid
-    // invalidating the iterator in "Wait".
-    pending_remove_dispatchers_.erase(pdispatcher);
-    pending_add_dispatchers_.insert(pdispatcher);
-  } else {
-    dispatchers_.insert(pdispatcher);
+  if (key_by_dispatcher_.count(pdispatcher)) {
+    LOG(LS_WARNING) << "PhysicalSocketServer asked to add a duplicate "
+                    << "dispatcher.";
+    return;
   }
+  uint64_t key = next_dispatcher_key_++;
+  dispatcher_by_key_.emplace(key, pdispatcher);
+  key_by_dispatcher_.emplace(pdispatcher, key);
 #if defined(WEBRTC_USE_EPOLL)
   if (epoll_fd_ != INVALID_SOCKET) {
-    AddEpoll(pdispatcher);
+    AddEpoll(pdispatcher, key);
   }
 #endif  // WEBRTC_USE_EPOLL
 }
 
 void PhysicalSocketServer::Remove(Dispatcher *pdispatcher) {
   CritScope cs(&crit_);
-  if (processing_dispatchers_) {
-    // A dispatcher is being removed while a "Wait" call is processing the
-    // list of socket events.
-    // Defer removal from "dispatchers_" set until processing is done to avoid
-    // invalidating the iterator in "Wait".
-    if (!pending_add_dispatchers_.erase(pdispatcher) &&
-        dispatchers_.find(pdispatcher) == dispatchers_.end()) {
-      LOG(LS_WARNING) << "PhysicalSocketServer asked to remove a unknown "
-                      << "dispatcher, potentially from a duplicate call to "
-                      << "Add.";
-      return;
-    }
-
-    pending_remove_dispatchers_.insert(pdispatcher);
-  } else if (!dispatchers_.erase(pdispatcher)) {
+  auto it = key_by_dispatcher_.find(pdispatcher);
+  if (it == key_by_dispatcher_.end()) {
     LOG(LS_WARNING) << "PhysicalSocketServer asked to remove a unknown "
                     << "dispatcher, potentially from a duplicate call to Add.";
     return;
   }
+  dispatcher_by_key_.erase(it->second);
+  key_by_dispatcher_.erase(it);
 #if defined(WEBRTC_USE_EPOLL)
   if (epoll_fd_ != INVALID_SOCKET) {
     RemoveEpoll(pdispatcher);
@@ -1335,30 +1323,15 @@ void PhysicalSocketServer::Update(Dispatcher* pdispatcher) {
   }
 
   CritScope cs(&crit_);
-  if (dispatchers_.find(pdispatcher) == dispatchers_.end()) {
+  auto it = key_by_dispatcher_.find(pdispatcher);
+  if (it == key_by_dispatcher_.end()) {
     return;
   }
 
-  UpdateEpoll(pdispatcher);
+  UpdateEpoll(pdispatcher, it->second);
 #endif
 }
 
-void PhysicalSocketServer::AddRemovePendingDispatchers() {
-  if (!pending_add_dispatchers_.empty()) {
-    for (Dispatcher* pdispatcher : pending_add_dispatchers_) {
-      dispatchers_.insert(pdispatcher);
-    }
-    pending_add_dispatchers_.clear();
-  }
-
-  if (!pending_remove_dispatchers_.empty()) {
-    for (Dispatcher* pdispatcher : pending_remove_dispatchers_) {
-      dispatchers_.erase(pdispatcher);
-    }
-    pending_remove_dispatchers_.clear();
-  }
-}
-
 #if defined(WEBRTC_POSIX)
 
 bool PhysicalSocketServer::Wait(int cmsWait, bool process_io) {
@@ -1461,6 +1434,10 @@ bool PhysicalSocketServer::WaitSelect(int cmsWait, bool process_io) {
   __msan_unpoison(&fdsWrite, sizeof(fdsWrite));
 #endif
 
+  // Keys of the dispatchers waited on in an iteration. Local to this call,
+  // and reused across its iterations to avoid an allocation per iteration.
+  std::vector<uint64_t> dispatcher_keys;
+
   fWait_ = true;
 
   while (fWait_) {
@@ -1469,11 +1446,14 @@ bool PhysicalSocketServer::WaitSelect(int cmsWait, bool process_io) {
       CritScope cr(&crit_);
       // TODO(jbauch): Support re-entrant waiting.
       RTC_DCHECK(!processing_dispatchers_);
-      for (Dispatcher* pdispatcher : dispatchers_) {
+      dispatcher_keys.clear();
+      for (const auto& entry : dispatcher_by_key_) {
         // Query dispatchers for read and write wait state
+        Dispatcher* pdispatcher = entry.second;
         RTC_DCHECK(pdispatcher);
         if (!process_io && (pdispatcher != signal_wakeup_))
           continue;
+        dispatcher_keys.push_back(entry.first);
         int fd = pdispatcher->GetDescriptor();
         // "select"ing a file descriptor that is equal to or larger than
         // FD_SETSIZE will result in undefined behavior.
@@ -1512,7 +1492,15 @@ bool PhysicalSocketServer::WaitSelect(int cmsWait, bool process_io) {
       // We have signaled descriptors
       CritScope cr(&crit_);
       processing_dispatchers_ = true;
-      for (Dispatcher* pdispatcher : dispatchers_) {
+      // Iterate over the keys waited on above. Handlers may add or remove
+      // dispatchers, so look each one up again before using it.
+      for (uint64_t key : dispatcher_keys) {
+        auto it = dispatcher_by_key_.find(key);
+        if (it == dispatcher_by_key_.end()) {
+          // The dispatcher was removed while processing earlier events.
+          continue;
+        }
+        Dispatcher* pdispatcher = it->second;
         int fd = pdispatcher->GetDescriptor();
 
         bool readable = FD_ISSET(fd, &fdsRead);
@@ -1528,11 +1516,7 @@ bool PhysicalSocketServer::WaitSelect(int cmsWait, bool process_io) {
         // The error code can be signaled through reads or writes.
         ProcessEvents(pdispatcher, readable, writable, readable || writable);
       }
-
       processing_dispatchers_ = false;
-      // Process deferred dispatchers that have been added/removed while the
-      // events were handled above.
-      AddRemovePendingDispatchers();
     }
 
     // Recalc the time remaining to wait. Doing it here means it doesn't get
@@ -1567,7 +1551,7 @@ static const size_t kInitialEpollEvents = 128;
 // Maximum number of events to process with one call to "epoll_wait".
 static const size_t kMaxEpollEvents = 8192;
 
-void PhysicalSocketServer::AddEpoll(Dispatcher* pdispatcher) {
+void PhysicalSocketServer::AddEpoll(Dispatcher* pdispatcher, uint64_t key) {
   RTC_DCHECK(epoll_fd_ != INVALID_SOCKET);
   int fd = pdispatcher->GetDescriptor();
   RTC_DCHECK(fd != INVALID_SOCKET);
@@ -1577,7 +1561,7 @@ void PhysicalSocketServer::AddEpoll(Dispatcher* pdispatcher) {
 
   struct epoll_event event = {0};
   event.events = GetEpollEvents(pdispatcher->GetRequestedEvents());
-  event.data.ptr = pdispatcher;
+  event.data.u64 = key;
   int err = epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
   RTC_DCHECK_EQ(err, 0);
   if (err == -1) {
@@ -1606,7 +1590,8 @@ void PhysicalSocketServer::RemoveEpoll(Dispatcher* pdispatcher) {
   }
 }
 
-void PhysicalSocketServer::UpdateEpoll(Dispatcher* pdispatcher) {
+void PhysicalSocketServer::UpdateEpoll(Dispatcher* pdispatcher,
+                                       uint64_t key) {
   RTC_DCHECK(epoll_fd_ != INVALID_SOCKET);
   int fd = pdispatcher->GetDescriptor();
   RTC_DCHECK(fd != INVALID_SOCKET);
@@ -1616,7 +1601,7 @@ void PhysicalSocketServer::UpdateEpoll(Dispatcher* pdispatcher) {
 
   struct epoll_event event = {0};
   event.events = GetEpollEvents(pdispatcher->GetRequestedEvents());
-  event.data.ptr = pdispatcher;
+  event.data.u64 = key;
   int err = epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &event);
   RTC_DCHECK_EQ(err, 0);
   if (err == -1) {
@@ -1663,13 +1648,17 @@ bool PhysicalSocketServer::WaitEpoll(int cmsWait) {
     } else {
       // We have signaled descriptors
       CritScope cr(&crit_);
+      // TODO(jbauch): Support re-entrant waiting.
+      RTC_DCHECK(!processing_dispatchers_);
+      processing_dispatchers_ = true;
       for (int i = 0; i < n; ++i) {
         const epoll_event& event = epoll_events_[i];
-        Dispatcher* pdispatcher = static_cast<Dispatcher*>(event.data.ptr);
-        if (dispatchers_.find(pdispatcher) == dispatchers_.end()) {
+        auto it = dispatcher_by_key_.find(event.data.u64);
+        if (it == dispatcher_by_key_.end()) {
           // The dispatcher for this socket no longer exists.
           continue;
         }
+        Dispatcher* pdispatcher = it->second;
 
         bool readable = (event.events & (EPOLLIN | EPOLLPRI));
         bool writable = (event.events & EPOLLOUT);
@@ -1677,13 +1666,14 @@ bool PhysicalSocketServer::WaitEpoll(int cmsWait) {
 
         ProcessEvents(pdispatcher, readable, writable, check_error);
       }
+      processing_dispatchers_ = false;
     }
 
     if (static_cast<size_t>(n) == epoll_events_.size() &&
         epoll_events_.size() < kMaxEpollEvents) {
       // We used the complete space to receive events, increase size for future
       // iterations.
-      epoll_events_.resize(std::max(epoll_events_.size() * 2, kMaxEpollEvents));
+      epoll_events_.resize(std::min(epoll_events_.size() * 2, kMaxEpollEvents));
     }
 
     if (cmsWait != kForever) {
@@ -1831,10 +1821,14 @@ bool PhysicalSocketServer::Wait(int cmsWait, bool process_io) {
   int64_t cmsElapsed = 0;
   int64_t msStart = Time();
 
+  // Snapshot of the dispatcher keys. Local to this call, and reused across
+  // its iterations to avoid an allocation per iteration.
+  std::vector<uint64_t> dispatcher_keys;
+
   fWait_ = true;
   while (fWait_) {
     std::vector<WSAEVENT> events;
-    std::vector<Dispatcher *> event_owners;
+    std::vector<uint64_t> event_owners;
 
     events.push_back(socket_ev_);
 
@@ -1843,10 +1837,18 @@ bool PhysicalSocketServer::Wait(int cmsWait, bool process_io) {
       // TODO(jbauch): Support re-entrant waiting.
       RTC_DCHECK(!processing_dispatchers_);
 
-      // Calling "CheckSignalClose" might remove a closed dispatcher from the
-      // set. This must be deferred to prevent invalidating the iterator.
+      // Calling "CheckSignalClose" might remove a closed dispatcher, so
+      // iterate over a snapshot of the keys.
       processing_dispatchers_ = true;
-      for (Dispatcher* disp : dispatchers_) {
+      dispatcher_keys.clear();
+      for (const auto& entry : dispatcher_by_key_) {
+        dispatcher_keys.push_back(entry.first);
+      }
+      for (uint64_t key : dispatcher_keys) {
+        auto it = dispatcher_by_key_.find(key);
+        if (it == dispatcher_by_key_.end())
+          continue;
+        Dispatcher* disp = it->second;
         if (!process_io && (disp != signal_wakeup_))
           continue;
         SOCKET s = disp->GetSocket();
@@ -1858,14 +1860,10 @@ bool PhysicalSocketServer::Wait(int cmsWait, bool process_io) {
                          FlagsToEvents(disp->GetRequestedEvents()));
         } else {
           events.push_back(disp->GetWSAEvent());
-          event_owners.push_back(disp);
+          event_owners.push_back(key);
         }
       }
-
       processing_dispatchers_ = false;
-      // Process deferred dispatchers that have been added/removed while the
-      // events were handled above.
-      AddRemovePendingDispatchers();
     }
 
     // Which is shorter, the delay wait or the asked wait?
@@ -1899,15 +1897,26 @@ bool PhysicalSocketServer::Wait(int cmsWait, bool process_io) {
       int index = dw - WSA_WAIT_EVENT_0;
       if (index > 0) {
         --index; // The first event is the socket event
-        Dispatcher* disp = event_owners[index];
         // The dispatcher could have been removed while waiting for events.
-        if (dispatchers_.find(disp) != dispatchers_.end()) {
+        auto it = dispatcher_by_key_.find(event_owners[index]);
+        if (it != dispatcher_by_key_.end()) {
+          Dispatcher* disp = it->second;
           disp->OnPreEvent(0);
           disp->OnEvent(0, 0);
         }
       } else if (process_io) {
         processing_dispatchers_ = true;
-        for (Dispatcher* disp : dispatchers_) {
+        // Handlers may add or remove dispatchers, so iterate over a snapshot
+        // of the keys and look each one up again before using it.
+        dispatcher_keys.clear();
+        for (const auto& entry : dispatcher_by_key_) {
+          dispatcher_keys.push_back(entry.first);
+        }
+        for (uint64_t key : dispatcher_keys) {
+          auto it = dispatcher_by_key_.find(key);
+          if (it == dispatcher_by_key_.end())
+            continue;
+          Dispatcher* disp = it->second;
           SOCKET s = disp->GetSocket();
           if (s == INVALID_SOCKET)
             continue;
@@ -1968,11 +1977,7 @@ bool PhysicalSocketServer::Wait(int cmsWait, bool process_io) {
             }
           }
         }
-
         processing_dispatchers_ = false;
-        // Process deferred dispatchers that have been added/removed while the
-        // events were handled above.
-        AddRemovePendingDispatchers();
       }
 
       // Reset the network event until new activity occurs
@@ -17,7 +17,7 @@
 #endif
 
 #include <memory>
-#include <set>
+#include <unordered_map>
 #include <vector>
 
 #include "rtc_base/criticalsection.h"
@@ -102,10 +102,6 @@ class PhysicalSocketServer : public SocketServer {
 #endif
 
  private:
-  typedef std::set<Dispatcher*> DispatcherSet;
-
-  void AddRemovePendingDispatchers();
-
 #if defined(WEBRTC_POSIX)
   bool WaitSelect(int cms, bool process_io);
   static bool InstallSignal(int signum, void (*handler)(int));
@@ -113,18 +109,22 @@ class PhysicalSocketServer : public SocketServer {
   std::unique_ptr<PosixSignalDispatcher> signal_dispatcher_;
 #endif  // WEBRTC_POSIX
 #if defined(WEBRTC_USE_EPOLL)
-  void AddEpoll(Dispatcher* dispatcher);
+  void AddEpoll(Dispatcher* dispatcher, uint64_t key);
   void RemoveEpoll(Dispatcher* dispatcher);
-  void UpdateEpoll(Dispatcher* dispatcher);
+  void UpdateEpoll(Dispatcher* dispatcher, uint64_t key);
   bool WaitEpoll(int cms);
   bool WaitPoll(int cms, Dispatcher* dispatcher);
 
   int epoll_fd_ = INVALID_SOCKET;
   std::vector<struct epoll_event> epoll_events_;
 #endif  // WEBRTC_USE_EPOLL
-  DispatcherSet dispatchers_;
-  DispatcherSet pending_add_dispatchers_;
-  DispatcherSet pending_remove_dispatchers_;
+  // Every dispatcher gets a unique key when it is added. Events are mapped
+  // back to dispatchers through the key, so a dispatcher that is removed
+  // while events are processed is skipped rather than used after deletion,
+  // and adding or removing dispatchers never has to be deferred.
+  uint64_t next_dispatcher_key_ = 0;
+  std::unordered_map<uint64_t, Dispatcher*> dispatcher_by_key_;
+  std::unordered_map<Dispatcher*, uint64_t> key_by_dispatcher_;
   bool processing_dispatchers_ = false;
   Signaler* signal_wakeup_;
   CriticalSection crit_;
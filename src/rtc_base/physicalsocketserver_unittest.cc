@@ -11,6 +11,7 @@
 #include <memory>
 #include <signal.h>
 #include <stdarg.h>
+#include <vector>
 
 #include "rtc_base/gunit.h"
 #include "rtc_base/logging.h"
@@ -19,6 +20,7 @@
 #include "rtc_base/socket_unittest.h"
 #include "rtc_base/testutils.h"
 #include "rtc_base/thread.h"
+#include "rtc_base/timeutils.h"
 
 namespace rtc {
 
@@ -498,6 +500,113 @@ TEST_F(PhysicalSocketTest,
   server_->set_network_binder(nullptr);
 }
 
+// Reads one packet per read event and, on the first event, deletes every other
+// socket in |sockets_| so the socket server has to cope with dispatchers being
+// removed while it is handling events.
+class ReadAndDeleteOthers : public sigslot::has_slots<> {
+ public:
+  explicit ReadAndDeleteOthers(
+      std::vector<std::unique_ptr<AsyncSocket>>* sockets)
+      : sockets_(sockets) {}
+
+  void OnReadEvent(AsyncSocket* socket) {
+    char buffer[64];
+    socket->Recv(buffer, sizeof(buffer), nullptr);
+    ++read_events_;
+    for (auto& other : *sockets_) {
+      if (other.get() != socket) {
+        other.reset();
+      }
+    }
+  }
+
+  int read_events() const { return read_events_; }
+
+ private:
+  std::vector<std::unique_ptr<AsyncSocket>>* sockets_;
+  int read_events_ = 0;
+};
+
+TEST_F(PhysicalSocketTest, DeletingSocketsWhileHandlingEvents) {
+  MAYBE_SKIP_IPV4;
+  const int kNumSockets = 8;
+  std::vector<std::unique_ptr<AsyncSocket>> sockets;
+  ReadAndDeleteOthers handler(&sockets);
+  std::unique_ptr<AsyncSocket> sender(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, sender->Bind(SocketAddress(kIPv4Loopback, 0)));
+  for (int i = 0; i < kNumSockets; ++i) {
+    sockets.emplace_back(server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+    ASSERT_EQ(0, sockets.back()->Bind(SocketAddress(kIPv4Loopback, 0)));
+    sockets.back()->SignalReadEvent.connect(&handler,
+                                            &ReadAndDeleteOthers::OnReadEvent);
+    ASSERT_EQ(1, sender->SendTo("x", 1, sockets.back()->GetLocalAddress()));
+  }
+  // All sockets are readable, but only the first one handled may fire since
+  // it deletes the others.
+  EXPECT_TRUE_WAIT(handler.read_events() > 0, kTimeout);
+  server_->Wait(0, true);
+  EXPECT_EQ(1, handler.read_events());
+}
+
+// Counts read events and drains the socket that became readable.
+class ReadCounter : public sigslot::has_slots<> {
+ public:
+  void OnReadEvent(AsyncSocket* socket) {
+    char buffer[64];
+    while (socket->Recv(buffer, sizeof(buffer), nullptr) > 0) {
+      ++packets_;
+    }
+  }
+
+  int packets() const { return packets_; }
+
+ private:
+  int packets_ = 0;
+};
+
+// Measures how quickly the socket server dispatches read events when many
+// sockets are registered. Disabled by default since it only logs timings.
+TEST_F(PhysicalSocketTest, DISABLED_DispatchThroughputWithManySockets) {
+  MAYBE_SKIP_IPV4;
+  // Stay below FD_SETSIZE so the select() based implementations can run too.
+  const int kNumSockets = 500;
+  const int kNumRounds = 200;
+  ReadCounter counter;
+  std::vector<std::unique_ptr<AsyncSocket>> sockets;
+  std::unique_ptr<AsyncSocket> sender(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, sender->Bind(SocketAddress(kIPv4Loopback, 0)));
+  for (int i = 0; i < kNumSockets; ++i) {
+    sockets.emplace_back(server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+    ASSERT_TRUE(sockets.back());
+    ASSERT_EQ(0, sockets.back()->Bind(SocketAddress(kIPv4Loopback, 0)));
+    sockets.back()->SignalReadEvent.connect(&counter,
+                                            &ReadCounter::OnReadEvent);
+  }
+
+  int64_t start_ns = TimeNanos();
+  int64_t wait_calls = 0;
+  for (int round = 0; round < kNumRounds; ++round) {
+    for (const auto& socket : sockets) {
+      // Dispatch pending reads whenever the sender's buffer fills up.
+      while (sender->SendTo("x", 1, socket->GetLocalAddress()) != 1) {
+        server_->Wait(0, true);
+        ++wait_calls;
+      }
+    }
+    while (counter.packets() < (round + 1) * kNumSockets) {
+      server_->Wait(0, true);
+      ++wait_calls;
+    }
+  }
+  int64_t elapsed_ns = TimeNanos() - start_ns;
+  LOG(LS_INFO) << "Dispatched " << counter.packets() << " packets on "
+               << kNumSockets << " sockets in " << elapsed_ns / 1000 << " us ("
+               << counter.packets() * kNumNanosecsPerSec / elapsed_ns
+               << " packets/s, " << wait_calls << " Wait calls).";
+}
+
 class PosixSignalDeliveryTest : public testing::Test {
  public:
   static void RecordSignal(int signum) {
@@ -359,6 +359,10 @@ void Thread::Send(const Location& posted_from,
     smsg.thread = current_thread;
     smsg.msg = msg;
     smsg.ready = &ready;
+#if WEBRTC_CONTENTION_PROFILER
+    if (contention_profiler::IsEnabled())
+      smsg.send_time_ns = TimeNanos();
+#endif
     sendlist_.push_back(smsg);
   }
 
@@ -410,7 +414,17 @@ void Thread::ReceiveSendsFromThread(const Thread* source) {
   while (PopSendMessageFromThread(source, &smsg)) {
     crit_.Leave();
 
+#if WEBRTC_CONTENTION_PROFILER
+    int64_t run_start_ns = smsg.send_time_ns ? TimeNanos() : 0;
+#endif
     smsg.msg.phandler->OnMessage(&smsg.msg);
+#if WEBRTC_CONTENTION_PROFILER
+    if (smsg.send_time_ns) {
+      contention_profiler::RecordInvoke(
+          this, name(), smsg.msg.posted_from, run_start_ns - smsg.send_time_ns,
+          TimeNanos() - run_start_ns);
+    }
+#endif
 
     crit_.Enter();
     *smsg.ready = true;
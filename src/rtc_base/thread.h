@@ -21,6 +21,7 @@
 #include <pthread.h>
 #endif
 #include "rtc_base/constructormagic.h"
+#include "rtc_base/contention_profiler.h"
 #include "rtc_base/event.h"
 #include "rtc_base/messagequeue.h"
 #include "rtc_base/platform_thread_types.h"
@@ -84,6 +85,10 @@ struct _SendMessage {
   Thread *thread;
   Message msg;
   bool *ready;
+#if WEBRTC_CONTENTION_PROFILER
+  // rtc::TimeNanos() when the message was sent, or 0 if it is not profiled.
+  int64_t send_time_ns = 0;
+#endif
 };
 
 class Runnable {
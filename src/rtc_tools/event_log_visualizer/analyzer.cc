@@ -304,42 +304,96 @@ void MovingAverage(
 
 }  // namespace
 
+LoggedRtpHeader::LoggedRtpHeader(const RTPHeader& header)
+    : markerBit(header.markerBit),
+      payloadType(header.payloadType),
+      sequenceNumber(header.sequenceNumber),
+      timestamp(header.timestamp),
+      ssrc(header.ssrc),
+      headerLength(rtc::checked_cast<uint16_t>(header.headerLength)),
+      paddingLength(rtc::checked_cast<uint16_t>(header.paddingLength)) {
+  extension.hasAbsoluteSendTime = header.extension.hasAbsoluteSendTime;
+  extension.absoluteSendTime = header.extension.absoluteSendTime;
+  extension.hasTransportSequenceNumber =
+      header.extension.hasTransportSequenceNumber;
+  extension.transportSequenceNumber = header.extension.transportSequenceNumber;
+  extension.hasAudioLevel = header.extension.hasAudioLevel;
+  extension.voiceActivity = header.extension.voiceActivity;
+  extension.audioLevel = header.extension.audioLevel;
+}
+
+RTPHeader LoggedRtpHeader::ToRtpHeader() const {
+  RTPHeader header;
+  header.markerBit = markerBit;
+  header.payloadType = payloadType;
+  header.sequenceNumber = sequenceNumber;
+  header.timestamp = timestamp;
+  header.ssrc = ssrc;
+  header.headerLength = headerLength;
+  header.paddingLength = paddingLength;
+  header.extension.hasAbsoluteSendTime = extension.hasAbsoluteSendTime;
+  header.extension.absoluteSendTime = extension.absoluteSendTime;
+  header.extension.hasTransportSequenceNumber =
+      extension.hasTransportSequenceNumber;
+  header.extension.transportSequenceNumber = extension.transportSequenceNumber;
+  header.extension.hasAudioLevel = extension.hasAudioLevel;
+  header.extension.voiceActivity = extension.voiceActivity;
+  header.extension.audioLevel = extension.audioLevel;
+  return header;
+}
+
 EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
-    : parsed_log_(log), window_duration_(250000), step_(10000) {
-  uint64_t first_timestamp = std::numeric_limits<uint64_t>::max();
-  uint64_t last_timestamp = std::numeric_limits<uint64_t>::min();
+    : EventLogAnalyzer() {
+  ProcessEvents(log);
+  FinishProcessing();
+}
 
+EventLogAnalyzer::EventLogAnalyzer(const std::string& file_name,
+                                   bool memory_map)
+    : EventLogAnalyzer() {
+  // Number of events parsed at a time. This bounds the memory used for the
+  // raw events, independently of the length of the log.
+  const size_t kEventsPerChunk = 10000;
+  ParsedRtcEventLog log;
+  parsed_entire_log_ = log.StartParsingFile(file_name, memory_map);
+  while (parsed_entire_log_ && !log.AtEndOfLog()) {
+    parsed_entire_log_ = log.ParseNextEvents(kEventsPerChunk, {});
+    ProcessEvents(log);
+  }
+  FinishProcessing();
+}
+
+EventLogAnalyzer::EventLogAnalyzer()
+    : parsed_entire_log_(true),
+      first_timestamp_(std::numeric_limits<uint64_t>::max()),
+      last_timestamp_(std::numeric_limits<uint64_t>::min()),
+      last_incoming_rtcp_packet_length_(0),
+      default_extension_map_(GetDefaultHeaderExtensionMap()),
+      window_duration_(250000),
+      step_(10000) {}
+
+void EventLogAnalyzer::ProcessEvents(const ParsedRtcEventLog& log) {
   PacketDirection direction;
   uint8_t header[IP_PACKET_SIZE];
   size_t header_length;
   size_t total_length;
 
-  uint8_t last_incoming_rtcp_packet[IP_PACKET_SIZE];
-  uint8_t last_incoming_rtcp_packet_length = 0;
-
-  // Make a default extension map for streams without configuration information.
-  // TODO(ivoc): Once configuration of audio streams is stored in the event log,
-  //             this can be removed. Tracking bug: webrtc:6399
-  RtpHeaderExtensionMap default_extension_map = GetDefaultHeaderExtensionMap();
-
-  rtc::Optional<uint64_t> last_log_start;
-
-  for (size_t i = 0; i < parsed_log_.GetNumberOfEvents(); i++) {
-    ParsedRtcEventLog::EventType event_type = parsed_log_.GetEventType(i);
+  for (size_t i = 0; i < log.GetNumberOfEvents(); i++) {
+    ParsedRtcEventLog::EventType event_type = log.GetEventType(i);
     if (event_type != ParsedRtcEventLog::VIDEO_RECEIVER_CONFIG_EVENT &&
         event_type != ParsedRtcEventLog::VIDEO_SENDER_CONFIG_EVENT &&
         event_type != ParsedRtcEventLog::AUDIO_RECEIVER_CONFIG_EVENT &&
         event_type != ParsedRtcEventLog::AUDIO_SENDER_CONFIG_EVENT &&
         event_type != ParsedRtcEventLog::LOG_START &&
         event_type != ParsedRtcEventLog::LOG_END) {
-      uint64_t timestamp = parsed_log_.GetTimestamp(i);
-      first_timestamp = std::min(first_timestamp, timestamp);
-      last_timestamp = std::max(last_timestamp, timestamp);
+      uint64_t timestamp = log.GetTimestamp(i);
+      first_timestamp_ = std::min(first_timestamp_, timestamp);
+      last_timestamp_ = std::max(last_timestamp_, timestamp);
     }
 
-    switch (parsed_log_.GetEventType(i)) {
+    switch (log.GetEventType(i)) {
       case ParsedRtcEventLog::VIDEO_RECEIVER_CONFIG_EVENT: {
-        rtclog::StreamConfig config = parsed_log_.GetVideoReceiveConfig(i);
+        rtclog::StreamConfig config = log.GetVideoReceiveConfig(i);
         StreamId stream(config.remote_ssrc, kIncomingPacket);
         video_ssrcs_.insert(stream);
         StreamId rtx_stream(config.rtx_ssrc, kIncomingPacket);
@@ -349,7 +403,7 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
       }
       case ParsedRtcEventLog::VIDEO_SENDER_CONFIG_EVENT: {
         std::vector<rtclog::StreamConfig> configs =
-            parsed_log_.GetVideoSendConfig(i);
+            log.GetVideoSendConfig(i);
         for (const auto& config : configs) {
           StreamId stream(config.local_ssrc, kOutgoingPacket);
           video_ssrcs_.insert(stream);
@@ -360,19 +414,19 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
         break;
       }
       case ParsedRtcEventLog::AUDIO_RECEIVER_CONFIG_EVENT: {
-        rtclog::StreamConfig config = parsed_log_.GetAudioReceiveConfig(i);
+        rtclog::StreamConfig config = log.GetAudioReceiveConfig(i);
         StreamId stream(config.remote_ssrc, kIncomingPacket);
         audio_ssrcs_.insert(stream);
         break;
       }
       case ParsedRtcEventLog::AUDIO_SENDER_CONFIG_EVENT: {
-        rtclog::StreamConfig config = parsed_log_.GetAudioSendConfig(i);
+        rtclog::StreamConfig config = log.GetAudioSendConfig(i);
         StreamId stream(config.local_ssrc, kOutgoingPacket);
         audio_ssrcs_.insert(stream);
         break;
       }
       case ParsedRtcEventLog::RTP_EVENT: {
-        RtpHeaderExtensionMap* extension_map = parsed_log_.GetRtpHeader(
+        RtpHeaderExtensionMap* extension_map = log.GetRtpHeader(
             i, &direction, header, &header_length, &total_length);
         RtpUtility::RtpHeaderParser rtp_parser(header, header_length);
         RTPHeader parsed_header;
@@ -383,9 +437,9 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
           // TODO(ivoc): Once configuration of audio streams is stored in the
           //             event log, this can be removed.
           //             Tracking bug: webrtc:6399
-          rtp_parser.Parse(&parsed_header, &default_extension_map);
+          rtp_parser.Parse(&parsed_header, &default_extension_map_);
         }
-        uint64_t timestamp = parsed_log_.GetTimestamp(i);
+        uint64_t timestamp = log.GetTimestamp(i);
         StreamId stream(parsed_header.ssrc, direction);
         rtp_packets_[stream].push_back(
             LoggedRtpPacket(timestamp, parsed_header, total_length));
@@ -393,18 +447,18 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
       }
       case ParsedRtcEventLog::RTCP_EVENT: {
         uint8_t packet[IP_PACKET_SIZE];
-        parsed_log_.GetRtcpPacket(i, &direction, packet, &total_length);
+        log.GetRtcpPacket(i, &direction, packet, &total_length);
         // Currently incoming RTCP packets are logged twice, both for audio and
         // video. Only act on one of them. Compare against the previous parsed
         // incoming RTCP packet.
         if (direction == webrtc::kIncomingPacket) {
           RTC_CHECK_LE(total_length, IP_PACKET_SIZE);
-          if (total_length == last_incoming_rtcp_packet_length &&
-              memcmp(last_incoming_rtcp_packet, packet, total_length) == 0) {
+          if (total_length == last_incoming_rtcp_packet_length_ &&
+              memcmp(last_incoming_rtcp_packet_, packet, total_length) == 0) {
             continue;
           } else {
-            memcpy(last_incoming_rtcp_packet, packet, total_length);
-            last_incoming_rtcp_packet_length = total_length;
+            memcpy(last_incoming_rtcp_packet_, packet, total_length);
+            last_incoming_rtcp_packet_length_ = total_length;
           }
         }
         rtcp::CommonHeader header;
@@ -419,7 +473,7 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
             if (rtcp_packet->Parse(header)) {
               uint32_t ssrc = rtcp_packet->sender_ssrc();
               StreamId stream(ssrc, direction);
-              uint64_t timestamp = parsed_log_.GetTimestamp(i);
+              uint64_t timestamp = log.GetTimestamp(i);
               rtcp_packets_[stream].push_back(LoggedRtcpPacket(
                   timestamp, kRtcpTransportFeedback, std::move(rtcp_packet)));
             }
@@ -429,7 +483,7 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
             if (rtcp_packet->Parse(header)) {
               uint32_t ssrc = rtcp_packet->sender_ssrc();
               StreamId stream(ssrc, direction);
-              uint64_t timestamp = parsed_log_.GetTimestamp(i);
+              uint64_t timestamp = log.GetTimestamp(i);
               rtcp_packets_[stream].push_back(
                   LoggedRtcpPacket(timestamp, kRtcpSr, std::move(rtcp_packet)));
             }
@@ -439,7 +493,7 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
             if (rtcp_packet->Parse(header)) {
               uint32_t ssrc = rtcp_packet->sender_ssrc();
               StreamId stream(ssrc, direction);
-              uint64_t timestamp = parsed_log_.GetTimestamp(i);
+              uint64_t timestamp = log.GetTimestamp(i);
               rtcp_packets_[stream].push_back(
                   LoggedRtcpPacket(timestamp, kRtcpRr, std::move(rtcp_packet)));
             }
@@ -450,7 +504,7 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
             if (rtcp_packet->Parse(header)) {
               uint32_t ssrc = rtcp_packet->sender_ssrc();
               StreamId stream(ssrc, direction);
-              uint64_t timestamp = parsed_log_.GetTimestamp(i);
+              uint64_t timestamp = log.GetTimestamp(i);
               rtcp_packets_[stream].push_back(LoggedRtcpPacket(
                   timestamp, kRtcpRemb, std::move(rtcp_packet)));
             }
@@ -459,55 +513,55 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
         break;
       }
       case ParsedRtcEventLog::LOG_START: {
-        if (last_log_start) {
-          // A LOG_END event was missing. Use last_timestamp.
-          RTC_DCHECK_GE(last_timestamp, *last_log_start);
+        if (last_log_start_) {
+          // A LOG_END event was missing. Use last_timestamp_.
+          RTC_DCHECK_GE(last_timestamp_, *last_log_start_);
           log_segments_.push_back(
-            std::make_pair(*last_log_start, last_timestamp));
+            std::make_pair(*last_log_start_, last_timestamp_));
         }
-        last_log_start = rtc::Optional<uint64_t>(parsed_log_.GetTimestamp(i));
+        last_log_start_ = rtc::Optional<uint64_t>(log.GetTimestamp(i));
         break;
       }
       case ParsedRtcEventLog::LOG_END: {
-        RTC_DCHECK(last_log_start);
+        RTC_DCHECK(last_log_start_);
         log_segments_.push_back(
-            std::make_pair(*last_log_start, parsed_log_.GetTimestamp(i)));
-        last_log_start.reset();
+            std::make_pair(*last_log_start_, log.GetTimestamp(i)));
+        last_log_start_.reset();
         break;
       }
       case ParsedRtcEventLog::AUDIO_PLAYOUT_EVENT: {
         uint32_t this_ssrc;
-        parsed_log_.GetAudioPlayout(i, &this_ssrc);
-        audio_playout_events_[this_ssrc].push_back(parsed_log_.GetTimestamp(i));
+        log.GetAudioPlayout(i, &this_ssrc);
+        audio_playout_events_[this_ssrc].push_back(log.GetTimestamp(i));
         break;
       }
       case ParsedRtcEventLog::LOSS_BASED_BWE_UPDATE: {
         LossBasedBweUpdate bwe_update;
-        bwe_update.timestamp = parsed_log_.GetTimestamp(i);
-        parsed_log_.GetLossBasedBweUpdate(i, &bwe_update.new_bitrate,
-                                          &bwe_update.fraction_loss,
-                                          &bwe_update.expected_packets);
+        bwe_update.timestamp = log.GetTimestamp(i);
+        log.GetLossBasedBweUpdate(i, &bwe_update.new_bitrate,
+                                  &bwe_update.fraction_loss,
+                                  &bwe_update.expected_packets);
         bwe_loss_updates_.push_back(bwe_update);
         break;
       }
       case ParsedRtcEventLog::DELAY_BASED_BWE_UPDATE: {
-        bwe_delay_updates_.push_back(parsed_log_.GetDelayBasedBweUpdate(i));
+        bwe_delay_updates_.push_back(log.GetDelayBasedBweUpdate(i));
         break;
       }
       case ParsedRtcEventLog::AUDIO_NETWORK_ADAPTATION_EVENT: {
         AudioNetworkAdaptationEvent ana_event;
-        ana_event.timestamp = parsed_log_.GetTimestamp(i);
-        parsed_log_.GetAudioNetworkAdaptation(i, &ana_event.config);
+        ana_event.timestamp = log.GetTimestamp(i);
+        log.GetAudioNetworkAdaptation(i, &ana_event.config);
         audio_network_adaptation_events_.push_back(ana_event);
         break;
       }
       case ParsedRtcEventLog::BWE_PROBE_CLUSTER_CREATED_EVENT: {
         bwe_probe_cluster_created_events_.push_back(
-            parsed_log_.GetBweProbeClusterCreated(i));
+            log.GetBweProbeClusterCreated(i));
         break;
       }
       case ParsedRtcEventLog::BWE_PROBE_RESULT_EVENT: {
-        bwe_probe_result_events_.push_back(parsed_log_.GetBweProbeResult(i));
+        bwe_probe_result_events_.push_back(log.GetBweProbeResult(i));
         break;
       }
       case ParsedRtcEventLog::UNKNOWN_EVENT: {
@@ -515,17 +569,19 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLog& log)
       }
     }
   }
+}
 
-  if (last_timestamp < first_timestamp) {
+void EventLogAnalyzer::FinishProcessing() {
+  if (last_timestamp_ < first_timestamp_) {
     // No useful events in the log.
-    first_timestamp = last_timestamp = 0;
+    first_timestamp_ = last_timestamp_ = 0;
   }
-  begin_time_ = first_timestamp;
-  end_time_ = last_timestamp;
+  begin_time_ = first_timestamp_;
+  end_time_ = last_timestamp_;
   call_duration_s_ = static_cast<float>(end_time_ - begin_time_) / 1000000;
-  if (last_log_start) {
+  if (last_log_start_) {
     // The log was missing the last LOG_END event. Fake it.
-    log_segments_.push_back(std::make_pair(*last_log_start, end_time_));
+    log_segments_.push_back(std::make_pair(*last_log_start_, end_time_));
   }
 }
 
@@ -668,24 +724,20 @@ void EventLogAnalyzer::CreatePlayoutGraph(Plot* plot) {
   std::map<uint32_t, TimeSeries> time_series;
   std::map<uint32_t, uint64_t> last_playout;
 
-  uint32_t ssrc;
-
-  for (size_t i = 0; i < parsed_log_.GetNumberOfEvents(); i++) {
-    ParsedRtcEventLog::EventType event_type = parsed_log_.GetEventType(i);
-    if (event_type == ParsedRtcEventLog::AUDIO_PLAYOUT_EVENT) {
-      parsed_log_.GetAudioPlayout(i, &ssrc);
-      uint64_t timestamp = parsed_log_.GetTimestamp(i);
-      if (MatchingSsrc(ssrc, desired_ssrc_)) {
-        float x = static_cast<float>(timestamp - begin_time_) / 1000000;
-        float y = static_cast<float>(timestamp - last_playout[ssrc]) / 1000;
-        if (time_series[ssrc].points.size() == 0) {
-          // There were no previusly logged playout for this SSRC.
-          // Generate a point, but place it on the x-axis.
-          y = 0;
-        }
-        time_series[ssrc].points.push_back(TimeSeriesPoint(x, y));
-        last_playout[ssrc] = timestamp;
+  for (const auto& kv : audio_playout_events_) {
+    uint32_t ssrc = kv.first;
+    if (!MatchingSsrc(ssrc, desired_ssrc_))
+      continue;
+    for (uint64_t timestamp : kv.second) {
+      float x = static_cast<float>(timestamp - begin_time_) / 1000000;
+      float y = static_cast<float>(timestamp - last_playout[ssrc]) / 1000;
+      if (time_series[ssrc].points.size() == 0) {
+        // There were no previusly logged playout for this SSRC.
+        // Generate a point, but place it on the x-axis.
+        y = 0;
       }
+      time_series[ssrc].points.push_back(TimeSeriesPoint(x, y));
+      last_playout[ssrc] = timestamp;
     }
   }
 
@@ -916,20 +968,18 @@ void EventLogAnalyzer::CreateTotalBitrateGraph(
   };
   std::vector<TimestampSize> packets;
 
-  PacketDirection direction;
-  size_t total_length;
-
   // Extract timestamps and sizes for the relevant packets.
-  for (size_t i = 0; i < parsed_log_.GetNumberOfEvents(); i++) {
-    ParsedRtcEventLog::EventType event_type = parsed_log_.GetEventType(i);
-    if (event_type == ParsedRtcEventLog::RTP_EVENT) {
-      parsed_log_.GetRtpHeader(i, &direction, nullptr, nullptr, &total_length);
-      if (direction == desired_direction) {
-        uint64_t timestamp = parsed_log_.GetTimestamp(i);
-        packets.push_back(TimestampSize(timestamp, total_length));
-      }
+  for (const auto& kv : rtp_packets_) {
+    if (kv.first.GetDirection() == desired_direction) {
+      for (const LoggedRtpPacket& rtp_packet : kv.second)
+        packets.push_back(
+            TimestampSize(rtp_packet.timestamp, rtp_packet.total_length));
     }
   }
+  std::sort(packets.begin(), packets.end(),
+            [](const TimestampSize& a, const TimestampSize& b) {
+              return a.timestamp < b.timestamp;
+            });
 
   size_t window_index_begin = 0;
   size_t window_index_end = 0;
@@ -1538,7 +1588,7 @@ class NetEqStreamInput : public test::NetEqInput {
       return std::unique_ptr<PacketData>();
     }
     std::unique_ptr<PacketData> packet_data(new PacketData());
-    packet_data->header = packet_stream_it_->header;
+    packet_data->header = packet_stream_it_->header.ToRtpHeader();
     // Convert from us to ms.
     packet_data->time_ms = packet_stream_it_->timestamp / 1000.0;
 
@@ -1563,7 +1613,8 @@ class NetEqStreamInput : public test::NetEqInput {
     if (packet_stream_it_ == packet_stream_.end()) {
       return rtc::Optional<RTPHeader>();
     }
-    return rtc::Optional<RTPHeader>(packet_stream_it_->header);
+    return rtc::Optional<RTPHeader>(
+        packet_stream_it_->header.ToRtpHeader());
   }
 
  private:
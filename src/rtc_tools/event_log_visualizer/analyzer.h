@@ -18,6 +18,7 @@
 #include <utility>
 #include <vector>
 
+#include "api/optional.h"
 #include "logging/rtc_event_log/rtc_event_log_parser.h"
 #include "modules/audio_coding/audio_network_adaptor/include/audio_network_adaptor.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
@@ -28,12 +29,40 @@
 namespace webrtc {
 namespace plotting {
 
+// The fields of an RTPHeader that the plots and the NetEq simulation use,
+// with the same names. A full RTPHeader has room for 15 CSRCs and every
+// header extension, which adds up over the packets of a long log.
+struct LoggedRtpHeader {
+  explicit LoggedRtpHeader(const RTPHeader& header);
+  RTPHeader ToRtpHeader() const;
+
+  struct Extension {
+    bool hasAbsoluteSendTime;
+    uint32_t absoluteSendTime;
+    bool hasTransportSequenceNumber;
+    uint16_t transportSequenceNumber;
+    bool hasAudioLevel;
+    bool voiceActivity;
+    uint8_t audioLevel;
+  };
+
+  bool markerBit;
+  uint8_t payloadType;
+  uint16_t sequenceNumber;
+  uint32_t timestamp;
+  uint32_t ssrc;
+  uint16_t headerLength;
+  uint16_t paddingLength;
+  Extension extension;
+};
+
 struct LoggedRtpPacket {
-  LoggedRtpPacket(uint64_t timestamp, RTPHeader header, size_t total_length)
+  LoggedRtpPacket(uint64_t timestamp,
+                  const RTPHeader& header,
+                  size_t total_length)
       : timestamp(timestamp), header(header), total_length(total_length) {}
   uint64_t timestamp;
-  // TODO(terelius): This allocates space for 15 CSRCs even if none are used.
-  RTPHeader header;
+  LoggedRtpHeader header;
   size_t total_length;
 };
 
@@ -61,11 +90,19 @@ struct AudioNetworkAdaptationEvent {
 
 class EventLogAnalyzer {
  public:
-  // The EventLogAnalyzer keeps a reference to the ParsedRtcEventLog for the
-  // duration of its lifetime. The ParsedRtcEventLog must not be destroyed or
-  // modified while the EventLogAnalyzer is being used.
+  // Analyzes all events of |log|. The EventLogAnalyzer extracts what it needs
+  // up front, so |log| may be destroyed afterwards.
   explicit EventLogAnalyzer(const ParsedRtcEventLog& log);
 
+  // Analyzes the log in |file_name| in a single pass, parsing a limited number
+  // of events at a time, so memory use doesn't grow with the raw size of the
+  // log. See ParsedRtcEventLog::StartParsingFile() for |memory_map|.
+  EventLogAnalyzer(const std::string& file_name, bool memory_map);
+
+  // Returns false if the log couldn't be opened or was malformed. In that
+  // case the analysis covers the events up to the error.
+  bool ParsedEntireLog() const { return parsed_entire_log_; }
+
   void CreatePacketGraph(PacketDirection desired_direction, Plot* plot);
 
   void CreateAccumulatedPacketsGraph(PacketDirection desired_direction,
@@ -110,6 +147,13 @@ class EventLogAnalyzer {
   std::vector<std::pair<int64_t, int64_t>> GetFrameTimestamps() const;
 
  private:
+  EventLogAnalyzer();
+
+  // Extracts the events of |log|. Called once per chunk of parsed events.
+  void ProcessEvents(const ParsedRtcEventLog& log);
+  // Computes the time span of the log once all events have been processed.
+  void FinishProcessing();
+
   class StreamId {
    public:
     StreamId(uint32_t ssrc, webrtc::PacketDirection direction)
@@ -145,7 +189,18 @@ class EventLogAnalyzer {
 
   std::string GetStreamName(StreamId) const;
 
-  const ParsedRtcEventLog& parsed_log_;
+  bool parsed_entire_log_;
+
+  // State carried between chunks of events while processing the log.
+  uint64_t first_timestamp_;
+  uint64_t last_timestamp_;
+  rtc::Optional<uint64_t> last_log_start_;
+  uint8_t last_incoming_rtcp_packet_[IP_PACKET_SIZE];
+  size_t last_incoming_rtcp_packet_length_;
+  // Extension map for streams without configuration information.
+  // TODO(ivoc): Once configuration of audio streams is stored in the event log,
+  //             this can be removed. Tracking bug: webrtc:6399
+  RtpHeaderExtensionMap default_extension_map_;
 
   // A list of SSRCs we are interested in analysing.
   // If left empty, all SSRCs will be considered relevant.
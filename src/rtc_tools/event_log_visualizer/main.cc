@@ -10,7 +10,6 @@
 
 #include <iostream>
 
-#include "logging/rtc_event_log/rtc_event_log_parser.h"
 #include "rtc_base/flags.h"
 #include "rtc_tools/event_log_visualizer/analyzer.h"
 #include "rtc_tools/event_log_visualizer/plot_base.h"
@@ -121,6 +120,11 @@ DEFINE_bool(show_detector_state,
             "Show the state of the delay based BWE detector on the total "
             "bitrate graph");
 
+DEFINE_bool(memory_map,
+            false,
+            "Map the log file into memory instead of reading it. The log is "
+            "always analyzed in a single pass.");
+
 void SetAllPlotFlags(bool setting);
 
 
@@ -162,16 +166,12 @@ int main(int argc, char* argv[]) {
 
   std::string filename = argv[1];
 
-  webrtc::ParsedRtcEventLog parsed_log;
-
-  if (!parsed_log.ParseFile(filename)) {
+  webrtc::plotting::EventLogAnalyzer analyzer(filename, FLAG_memory_map);
+  if (!analyzer.ParsedEntireLog()) {
     std::cerr << "Could not parse the entire log file." << std::endl;
-    std::cerr << "Proceeding to analyze the first "
-              << parsed_log.GetNumberOfEvents() << " events in the file."
+    std::cerr << "Proceeding to analyze the events before the error."
               << std::endl;
   }
-
-  webrtc::plotting::EventLogAnalyzer analyzer(parsed_log);
   std::unique_ptr<webrtc::plotting::PlotCollection> collection(
       new webrtc::plotting::PythonPlotCollection());
 
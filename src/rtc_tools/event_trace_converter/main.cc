@@ -0,0 +1,57 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+
+#include <iostream>
+#include <string>
+
+#include "rtc_base/event_tracer.h"
+#include "rtc_base/flags.h"
+
+DEFINE_bool(help, false, "prints this message");
+
+int main(int argc, char* argv[]) {
+  std::string program_name = argv[0];
+  std::string usage =
+      "Converts a binary WebRTC trace, as written by "
+      "rtc::tracing::StartInternalBinaryCapture(), to the Chrome trace event "
+      "JSON format that chrome://tracing and Perfetto can load.\n"
+      "Example usage:\n" +
+      program_name + " <binary trace> <json trace>\n";
+
+  rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, true);
+  if (argc != 3 || FLAG_help) {
+    std::cout << usage;
+    if (FLAG_help)
+      rtc::FlagList::Print(nullptr, false);
+    return 0;
+  }
+
+  FILE* input = fopen(argv[1], "rb");
+  if (!input) {
+    std::cerr << "Failed to open " << argv[1] << std::endl;
+    return 1;
+  }
+  FILE* output = fopen(argv[2], "w");
+  if (!output) {
+    std::cerr << "Failed to open " << argv[2] << std::endl;
+    fclose(input);
+    return 1;
+  }
+  bool success = rtc::tracing::ConvertInternalBinaryCapture(input, output);
+  fclose(input);
+  fclose(output);
+  if (!success) {
+    std::cerr << argv[1] << " is not a binary trace." << std::endl;
+    return 1;
+  }
+  return 0;
+}
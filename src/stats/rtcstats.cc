@@ -113,10 +113,36 @@ std::string RTCStats::ToJson() const {
   return oss.str();
 }
 
+std::unique_ptr<RTCStats> RTCStats::CopyChangedMembers(
+    const RTCStats& previous) const {
+  RTC_DCHECK_EQ(type(), previous.type());
+  RTC_DCHECK_EQ(id(), previous.id());
+  std::unique_ptr<RTCStats> changed = copy();
+  std::vector<RTCStatsMemberInterface*> members = changed->MutableMembers();
+  std::vector<const RTCStatsMemberInterface*> previous_members =
+      previous.Members();
+  RTC_DCHECK_EQ(members.size(), previous_members.size());
+  bool any_changed = false;
+  for (size_t i = 0; i < members.size(); ++i) {
+    if (*members[i] == *previous_members[i] || !members[i]->is_defined()) {
+      members[i]->Undefine();
+    } else {
+      any_changed = true;
+    }
+  }
+  if (!any_changed)
+    return nullptr;
+  return changed;
+}
+
 std::vector<const RTCStatsMemberInterface*> RTCStats::Members() const {
   return MembersOfThisObjectAndAncestors(0);
 }
 
+std::vector<RTCStatsMemberInterface*> RTCStats::MutableMembers() {
+  return MutableMembersOfThisObjectAndAncestors(0);
+}
+
 std::vector<const RTCStatsMemberInterface*>
 RTCStats::MembersOfThisObjectAndAncestors(
     size_t additional_capacity) const {
@@ -125,6 +151,13 @@ RTCStats::MembersOfThisObjectAndAncestors(
   return members;
 }
 
+std::vector<RTCStatsMemberInterface*>
+RTCStats::MutableMembersOfThisObjectAndAncestors(size_t additional_capacity) {
+  std::vector<RTCStatsMemberInterface*> members;
+  members.reserve(additional_capacity);
+  return members;
+}
+
 #define WEBRTC_DEFINE_RTCSTATSMEMBER(T, type, is_seq, is_str, to_str, to_json) \
   template <>                                                                  \
   const RTCStatsMemberInterface::Type RTCStatsMember<T>::kType =               \
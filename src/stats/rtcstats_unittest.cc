@@ -215,6 +215,41 @@ TEST(RTCStatsTest, RTCStatsGrandChild) {
   EXPECT_EQ(*copy.grandchild_int, *stats.grandchild_int);
 }
 
+TEST(RTCStatsTest, CopyChangedMembers) {
+  RTCGrandChildStats previous("grandchild", 1);
+  previous.child_int = 1;
+  previous.grandchild_int = 2;
+  RTCGrandChildStats current("grandchild", 2);
+  current.child_int = 1;
+  current.grandchild_int = 2;
+  // Only the timestamp differs.
+  EXPECT_FALSE(current.CopyChangedMembers(previous));
+
+  current.grandchild_int = 3;
+  std::unique_ptr<RTCStats> changed_ptr = current.CopyChangedMembers(previous);
+  ASSERT_TRUE(changed_ptr);
+  const RTCGrandChildStats& changed =
+      changed_ptr->cast_to<RTCGrandChildStats>();
+  EXPECT_EQ(changed.id(), "grandchild");
+  EXPECT_EQ(changed.timestamp_us(), 2);
+  EXPECT_FALSE(changed.child_int.is_defined());
+  ASSERT_TRUE(changed.grandchild_int.is_defined());
+  EXPECT_EQ(*changed.grandchild_int, 3);
+  // The original is left untouched.
+  EXPECT_TRUE(current.child_int.is_defined());
+
+  // Members that become defined count as changed, members that become
+  // undefined are not reported.
+  RTCGrandChildStats undefined("grandchild", 3);
+  undefined.grandchild_int = 3;
+  EXPECT_FALSE(undefined.CopyChangedMembers(current));
+  changed_ptr = current.CopyChangedMembers(undefined);
+  ASSERT_TRUE(changed_ptr);
+  EXPECT_EQ(*changed_ptr->cast_to<RTCGrandChildStats>().child_int, 1);
+  EXPECT_FALSE(
+      changed_ptr->cast_to<RTCGrandChildStats>().grandchild_int.is_defined());
+}
+
 TEST(RTCStatsTest, RTCStatsPrintsValidJson) {
   std::string id = "statsId";
   int timestamp = 42;
@@ -10,10 +10,416 @@
 
 #include "api/stats/rtcstatsreport.h"
 
+#include <string.h>
+
+#include <deque>
+#include <limits>
 #include <sstream>
+#include <unordered_map>
+#include <utility>
+
+#include "rtc_base/bytebuffer.h"
 
 namespace webrtc {
 
+namespace {
+
+// Writes the binary format described at |RTCStatsReport::ToBinary|.
+class BinaryStatsWriter {
+ public:
+  void WriteStats(const RTCStats& stats) {
+    WriteInternedString(stats.id());
+    WriteInternedString(stats.type());
+    WriteVarint(stats.timestamp_us());
+    std::vector<const RTCStatsMemberInterface*> members = stats.Members();
+    uint64_t defined_members = 0;
+    for (const RTCStatsMemberInterface* member : members) {
+      if (member->is_defined())
+        ++defined_members;
+    }
+    buffer_.WriteUVarint(defined_members);
+    for (const RTCStatsMemberInterface* member : members) {
+      if (member->is_defined())
+        WriteMember(*member);
+    }
+  }
+
+  void WriteVarint(int64_t value) {
+    buffer_.WriteUVarint((static_cast<uint64_t>(value) << 1) ^
+                         static_cast<uint64_t>(value >> 63));
+  }
+
+  rtc::ByteBufferWriter& buffer() { return buffer_; }
+
+  void WriteInternedString(const std::string& str) {
+    auto it = string_indices_.find(str);
+    if (it != string_indices_.end()) {
+      buffer_.WriteUVarint(it->second);
+      return;
+    }
+    uint64_t index = string_indices_.size();
+    string_indices_[str] = index;
+    buffer_.WriteUVarint(index);
+    WriteString(str);
+  }
+
+ private:
+  void WriteString(const std::string& str) {
+    buffer_.WriteUVarint(str.size());
+    buffer_.WriteString(str);
+  }
+
+  void WriteDouble(double value) {
+    uint64_t bits;
+    static_assert(sizeof(bits) == sizeof(value), "Unexpected double size.");
+    memcpy(&bits, &value, sizeof(bits));
+    buffer_.WriteUInt64(bits);
+  }
+
+  void WriteValue(bool value) { buffer_.WriteUInt8(value ? 1 : 0); }
+  void WriteValue(int32_t value) { WriteVarint(value); }
+  void WriteValue(uint32_t value) { buffer_.WriteUVarint(value); }
+  void WriteValue(int64_t value) { WriteVarint(value); }
+  void WriteValue(uint64_t value) { buffer_.WriteUVarint(value); }
+  void WriteValue(double value) { WriteDouble(value); }
+  void WriteValue(const std::string& value) { WriteString(value); }
+
+  template <typename T>
+  void WriteValue(const std::vector<T>& values) {
+    buffer_.WriteUVarint(values.size());
+    for (const T& value : values)
+      WriteValue(value);
+  }
+
+  // std::vector<bool> elements are not references to bool.
+  void WriteValue(const std::vector<bool>& values) {
+    buffer_.WriteUVarint(values.size());
+    for (bool value : values)
+      WriteValue(value);
+  }
+
+  template <typename T>
+  void WriteMemberValue(const RTCStatsMemberInterface& member) {
+    WriteValue(*member.cast_to<RTCStatsMember<T>>());
+  }
+
+  void WriteMember(const RTCStatsMemberInterface& member) {
+    WriteInternedString(member.name());
+    buffer_.WriteUInt8(static_cast<uint8_t>(member.type()));
+    switch (member.type()) {
+      case RTCStatsMemberInterface::kBool:
+        WriteMemberValue<bool>(member);
+        break;
+      case RTCStatsMemberInterface::kInt32:
+        WriteMemberValue<int32_t>(member);
+        break;
+      case RTCStatsMemberInterface::kUint32:
+        WriteMemberValue<uint32_t>(member);
+        break;
+      case RTCStatsMemberInterface::kInt64:
+        WriteMemberValue<int64_t>(member);
+        break;
+      case RTCStatsMemberInterface::kUint64:
+        WriteMemberValue<uint64_t>(member);
+        break;
+      case RTCStatsMemberInterface::kDouble:
+        WriteMemberValue<double>(member);
+        break;
+      case RTCStatsMemberInterface::kString:
+        WriteMemberValue<std::string>(member);
+        break;
+      case RTCStatsMemberInterface::kSequenceBool:
+        WriteMemberValue<std::vector<bool>>(member);
+        break;
+      case RTCStatsMemberInterface::kSequenceInt32:
+        WriteMemberValue<std::vector<int32_t>>(member);
+        break;
+      case RTCStatsMemberInterface::kSequenceUint32:
+        WriteMemberValue<std::vector<uint32_t>>(member);
+        break;
+      case RTCStatsMemberInterface::kSequenceInt64:
+        WriteMemberValue<std::vector<int64_t>>(member);
+        break;
+      case RTCStatsMemberInterface::kSequenceUint64:
+        WriteMemberValue<std::vector<uint64_t>>(member);
+        break;
+      case RTCStatsMemberInterface::kSequenceDouble:
+        WriteMemberValue<std::vector<double>>(member);
+        break;
+      case RTCStatsMemberInterface::kSequenceString:
+        WriteMemberValue<std::vector<std::string>>(member);
+        break;
+    }
+  }
+
+  rtc::ByteBufferWriter buffer_;
+  std::unordered_map<std::string, uint64_t> string_indices_;
+};
+
+template <typename T>
+std::unique_ptr<RTCStatsMemberInterface> CopyMemberOfType(
+    const RTCStatsMemberInterface& member) {
+  return std::unique_ptr<RTCStatsMemberInterface>(
+      new RTCStatsMember<T>(member.cast_to<RTCStatsMember<T>>()));
+}
+
+std::unique_ptr<RTCStatsMemberInterface> CopyMember(
+    const RTCStatsMemberInterface& member) {
+  switch (member.type()) {
+    case RTCStatsMemberInterface::kBool:
+      return CopyMemberOfType<bool>(member);
+    case RTCStatsMemberInterface::kInt32:
+      return CopyMemberOfType<int32_t>(member);
+    case RTCStatsMemberInterface::kUint32:
+      return CopyMemberOfType<uint32_t>(member);
+    case RTCStatsMemberInterface::kInt64:
+      return CopyMemberOfType<int64_t>(member);
+    case RTCStatsMemberInterface::kUint64:
+      return CopyMemberOfType<uint64_t>(member);
+    case RTCStatsMemberInterface::kDouble:
+      return CopyMemberOfType<double>(member);
+    case RTCStatsMemberInterface::kString:
+      return CopyMemberOfType<std::string>(member);
+    case RTCStatsMemberInterface::kSequenceBool:
+      return CopyMemberOfType<std::vector<bool>>(member);
+    case RTCStatsMemberInterface::kSequenceInt32:
+      return CopyMemberOfType<std::vector<int32_t>>(member);
+    case RTCStatsMemberInterface::kSequenceUint32:
+      return CopyMemberOfType<std::vector<uint32_t>>(member);
+    case RTCStatsMemberInterface::kSequenceInt64:
+      return CopyMemberOfType<std::vector<int64_t>>(member);
+    case RTCStatsMemberInterface::kSequenceUint64:
+      return CopyMemberOfType<std::vector<uint64_t>>(member);
+    case RTCStatsMemberInterface::kSequenceDouble:
+      return CopyMemberOfType<std::vector<double>>(member);
+    case RTCStatsMemberInterface::kSequenceString:
+      return CopyMemberOfType<std::vector<std::string>>(member);
+  }
+  RTC_NOTREACHED();
+  return nullptr;
+}
+
+// A stats object decoded by |RTCStatsReport::FromBinary|, whose type and
+// members are only known at runtime. The type and member names point into
+// |strings|, which is shared by the stats objects decoded from a report.
+class DecodedStats : public RTCStats {
+ public:
+  DecodedStats(const std::string& id,
+               int64_t timestamp_us,
+               std::shared_ptr<const std::deque<std::string>> strings,
+               const char* type)
+      : RTCStats(id, timestamp_us),
+        strings_(std::move(strings)),
+        type_(type) {}
+
+  void AddMember(std::unique_ptr<RTCStatsMemberInterface> member) {
+    members_.push_back(std::move(member));
+  }
+
+  std::unique_ptr<RTCStats> copy() const override {
+    std::unique_ptr<DecodedStats> copy(
+        new DecodedStats(id_, timestamp_us_, strings_, type_));
+    for (const auto& member : members_)
+      copy->AddMember(CopyMember(*member));
+    return std::move(copy);
+  }
+
+  const char* type() const override { return type_; }
+
+ protected:
+  std::vector<const RTCStatsMemberInterface*> MembersOfThisObjectAndAncestors(
+      size_t additional_capacity) const override {
+    std::vector<const RTCStatsMemberInterface*> members =
+        RTCStats::MembersOfThisObjectAndAncestors(members_.size() +
+                                                  additional_capacity);
+    for (const auto& member : members_)
+      members.push_back(member.get());
+    return members;
+  }
+
+  std::vector<RTCStatsMemberInterface*> MutableMembersOfThisObjectAndAncestors(
+      size_t additional_capacity) override {
+    std::vector<RTCStatsMemberInterface*> members =
+        RTCStats::MutableMembersOfThisObjectAndAncestors(members_.size() +
+                                                         additional_capacity);
+    for (const auto& member : members_)
+      members.push_back(member.get());
+    return members;
+  }
+
+ private:
+  const std::shared_ptr<const std::deque<std::string>> strings_;
+  const char* const type_;
+  std::vector<std::unique_ptr<RTCStatsMemberInterface>> members_;
+};
+
+// Reads the binary format described at |RTCStatsReport::ToBinary|. All read
+// methods return false if the data is exhausted or invalid.
+class BinaryStatsReader {
+ public:
+  explicit BinaryStatsReader(const std::string& binary)
+      : buffer_(binary.data(), binary.size()),
+        strings_(std::make_shared<std::deque<std::string>>()) {}
+
+  std::unique_ptr<RTCStats> ReadStats() {
+    const std::string* id;
+    const std::string* type;
+    int64_t timestamp_us;
+    uint64_t member_count;
+    if (!ReadInternedString(&id) || !ReadInternedString(&type) ||
+        !ReadVarint(&timestamp_us) || !buffer_.ReadUVarint(&member_count)) {
+      return nullptr;
+    }
+    std::unique_ptr<DecodedStats> stats(
+        new DecodedStats(*id, timestamp_us, strings_, type->c_str()));
+    for (uint64_t i = 0; i < member_count; ++i) {
+      std::unique_ptr<RTCStatsMemberInterface> member = ReadMember();
+      if (!member)
+        return nullptr;
+      stats->AddMember(std::move(member));
+    }
+    return std::move(stats);
+  }
+
+  bool ReadVarint(int64_t* value) {
+    uint64_t zigzag;
+    if (!buffer_.ReadUVarint(&zigzag))
+      return false;
+    *value = static_cast<int64_t>((zigzag >> 1) ^ (0 - (zigzag & 1)));
+    return true;
+  }
+
+  bool ReadUVarint(uint64_t* value) { return buffer_.ReadUVarint(value); }
+
+  // The returned string stays valid for as long as the stats objects read by
+  // this reader.
+  bool ReadInternedString(const std::string** str) {
+    uint64_t index;
+    if (!buffer_.ReadUVarint(&index) || index > strings_->size())
+      return false;
+    if (index == strings_->size()) {
+      std::string value;
+      if (!ReadValue(&value))
+        return false;
+      // Appending to a deque keeps references to its elements valid.
+      strings_->push_back(std::move(value));
+    }
+    *str = &(*strings_)[index];
+    return true;
+  }
+
+  bool done() const { return buffer_.Length() == 0; }
+
+ private:
+  bool ReadValue(bool* value) {
+    uint8_t byte;
+    if (!buffer_.ReadUInt8(&byte) || byte > 1)
+      return false;
+    *value = (byte == 1);
+    return true;
+  }
+  bool ReadValue(int32_t* value) {
+    int64_t value64;
+    if (!ReadVarint(&value64) ||
+        value64 < std::numeric_limits<int32_t>::min() ||
+        value64 > std::numeric_limits<int32_t>::max()) {
+      return false;
+    }
+    *value = static_cast<int32_t>(value64);
+    return true;
+  }
+  bool ReadValue(uint32_t* value) {
+    uint64_t value64;
+    if (!buffer_.ReadUVarint(&value64) ||
+        value64 > std::numeric_limits<uint32_t>::max()) {
+      return false;
+    }
+    *value = static_cast<uint32_t>(value64);
+    return true;
+  }
+  bool ReadValue(int64_t* value) { return ReadVarint(value); }
+  bool ReadValue(uint64_t* value) { return buffer_.ReadUVarint(value); }
+  bool ReadValue(double* value) {
+    uint64_t bits;
+    if (!buffer_.ReadUInt64(&bits))
+      return false;
+    memcpy(value, &bits, sizeof(bits));
+    return true;
+  }
+  bool ReadValue(std::string* value) {
+    uint64_t length;
+    return buffer_.ReadUVarint(&length) && length <= buffer_.Length() &&
+           buffer_.ReadString(value, static_cast<size_t>(length));
+  }
+
+  template <typename T>
+  bool ReadValue(std::vector<T>* values) {
+    uint64_t count;
+    if (!buffer_.ReadUVarint(&count))
+      return false;
+    // Every element takes at least a byte, which bounds the loop.
+    for (uint64_t i = 0; i < count; ++i) {
+      T value;
+      if (!ReadValue(&value))
+        return false;
+      values->push_back(std::move(value));
+    }
+    return true;
+  }
+
+  template <typename T>
+  std::unique_ptr<RTCStatsMemberInterface> ReadMemberValue(const char* name) {
+    T value;
+    if (!ReadValue(&value))
+      return nullptr;
+    return std::unique_ptr<RTCStatsMemberInterface>(
+        new RTCStatsMember<T>(name, std::move(value)));
+  }
+
+  std::unique_ptr<RTCStatsMemberInterface> ReadMember() {
+    const std::string* name;
+    uint8_t type;
+    if (!ReadInternedString(&name) || !buffer_.ReadUInt8(&type))
+      return nullptr;
+    switch (type) {
+      case RTCStatsMemberInterface::kBool:
+        return ReadMemberValue<bool>(name->c_str());
+      case RTCStatsMemberInterface::kInt32:
+        return ReadMemberValue<int32_t>(name->c_str());
+      case RTCStatsMemberInterface::kUint32:
+        return ReadMemberValue<uint32_t>(name->c_str());
+      case RTCStatsMemberInterface::kInt64:
+        return ReadMemberValue<int64_t>(name->c_str());
+      case RTCStatsMemberInterface::kUint64:
+        return ReadMemberValue<uint64_t>(name->c_str());
+      case RTCStatsMemberInterface::kDouble:
+        return ReadMemberValue<double>(name->c_str());
+      case RTCStatsMemberInterface::kString:
+        return ReadMemberValue<std::string>(name->c_str());
+      case RTCStatsMemberInterface::kSequenceBool:
+        return ReadMemberValue<std::vector<bool>>(name->c_str());
+      case RTCStatsMemberInterface::kSequenceInt32:
+        return ReadMemberValue<std::vector<int32_t>>(name->c_str());
+      case RTCStatsMemberInterface::kSequenceUint32:
+        return ReadMemberValue<std::vector<uint32_t>>(name->c_str());
+      case RTCStatsMemberInterface::kSequenceInt64:
+        return ReadMemberValue<std::vector<int64_t>>(name->c_str());
+      case RTCStatsMemberInterface::kSequenceUint64:
+        return ReadMemberValue<std::vector<uint64_t>>(name->c_str());
+      case RTCStatsMemberInterface::kSequenceDouble:
+        return ReadMemberValue<std::vector<double>>(name->c_str());
+      case RTCStatsMemberInterface::kSequenceString:
+        return ReadMemberValue<std::vector<std::string>>(name->c_str());
+    }
+    return nullptr;
+  }
+
+  rtc::ByteBufferReader buffer_;
+  const std::shared_ptr<std::deque<std::string>> strings_;
+};
+
+}  // namespace
+
 RTCStatsReport::ConstIterator::ConstIterator(
     const rtc::scoped_refptr<const RTCStatsReport>& report,
     StatsMap::const_iterator it)
@@ -116,4 +522,65 @@ std::string RTCStatsReport::ToJson() const {
   return oss.str();
 }
 
+rtc::scoped_refptr<RTCStatsReport> RTCStatsReport::CreateDelta(
+    const RTCStatsReport& previous) const {
+  rtc::scoped_refptr<RTCStatsReport> delta = Create(timestamp_us_);
+  for (const auto& entry : stats_) {
+    const RTCStats* previous_stats = previous.Get(entry.first);
+    if (!previous_stats || previous_stats->type() != entry.second->type()) {
+      delta->AddStats(entry.second->copy());
+      continue;
+    }
+    std::unique_ptr<RTCStats> changed =
+        entry.second->CopyChangedMembers(*previous_stats);
+    if (changed)
+      delta->AddStats(std::move(changed));
+  }
+  for (const auto& entry : previous.stats_) {
+    if (!Get(entry.first))
+      delta->removed_ids_.push_back(entry.first);
+  }
+  return delta;
+}
+
+std::string RTCStatsReport::ToBinary() const {
+  BinaryStatsWriter writer;
+  writer.WriteVarint(timestamp_us_);
+  writer.buffer().WriteUVarint(stats_.size());
+  for (const auto& entry : stats_)
+    writer.WriteStats(*entry.second);
+  writer.buffer().WriteUVarint(removed_ids_.size());
+  for (const std::string& id : removed_ids_)
+    writer.WriteInternedString(id);
+  return std::string(writer.buffer().Data(), writer.buffer().Length());
+}
+
+rtc::scoped_refptr<RTCStatsReport> RTCStatsReport::FromBinary(
+    const std::string& binary) {
+  BinaryStatsReader reader(binary);
+  int64_t timestamp_us;
+  uint64_t stats_count;
+  if (!reader.ReadVarint(&timestamp_us) || !reader.ReadUVarint(&stats_count))
+    return nullptr;
+  rtc::scoped_refptr<RTCStatsReport> report = Create(timestamp_us);
+  for (uint64_t i = 0; i < stats_count; ++i) {
+    std::unique_ptr<RTCStats> stats = reader.ReadStats();
+    if (!stats || report->Get(stats->id()))
+      return nullptr;
+    report->AddStats(std::move(stats));
+  }
+  uint64_t removed_count;
+  if (!reader.ReadUVarint(&removed_count))
+    return nullptr;
+  for (uint64_t i = 0; i < removed_count; ++i) {
+    const std::string* id;
+    if (!reader.ReadInternedString(&id))
+      return nullptr;
+    report->removed_ids_.push_back(*id);
+  }
+  if (!reader.done())
+    return nullptr;
+  return report;
+}
+
 }  // namespace webrtc
@@ -132,4 +132,148 @@ TEST(RTCStatsReport, TakeMembersFrom) {
   EXPECT_EQ(i, static_cast<int64_t>(6));
 }
 
+TEST(RTCStatsReport, CreateDelta) {
+  rtc::scoped_refptr<RTCStatsReport> previous = RTCStatsReport::Create(1);
+  std::unique_ptr<RTCTestStats1> a(new RTCTestStats1("a", 1));
+  a->integer = 1;
+  previous->AddStats(std::move(a));
+  std::unique_ptr<RTCTestStats1> b(new RTCTestStats1("b", 1));
+  b->integer = 2;
+  previous->AddStats(std::move(b));
+  previous->AddStats(
+      std::unique_ptr<RTCStats>(new RTCTestStats2("removed", 1)));
+
+  rtc::scoped_refptr<RTCStatsReport> current = RTCStatsReport::Create(2);
+  a.reset(new RTCTestStats1("a", 2));
+  a->integer = 1;
+  current->AddStats(std::move(a));
+  b.reset(new RTCTestStats1("b", 2));
+  b->integer = 3;
+  current->AddStats(std::move(b));
+  std::unique_ptr<RTCTestStats3> c(new RTCTestStats3("c", 2));
+  c->string = "new";
+  current->AddStats(std::move(c));
+
+  rtc::scoped_refptr<RTCStatsReport> delta = current->CreateDelta(*previous);
+  EXPECT_EQ(delta->timestamp_us(), 2);
+  EXPECT_EQ(delta->size(), static_cast<size_t>(2));
+  EXPECT_FALSE(delta->Get("a"));
+  EXPECT_FALSE(delta->Get("removed"));
+  EXPECT_EQ(delta->removed_ids(), std::vector<std::string>({"removed"}));
+  ASSERT_TRUE(delta->Get("b"));
+  EXPECT_EQ(*delta->Get("b")->cast_to<RTCTestStats1>().integer, 3);
+  ASSERT_TRUE(delta->Get("c"));
+  EXPECT_EQ(*delta->Get("c")->cast_to<RTCTestStats3>().string, "new");
+
+  // Nothing has changed compared to itself.
+  EXPECT_EQ(current->CreateDelta(*current)->size(), static_cast<size_t>(0));
+  EXPECT_TRUE(current->CreateDelta(*current)->removed_ids().empty());
+}
+
+TEST(RTCStatsReport, ToBinary) {
+  rtc::scoped_refptr<RTCStatsReport> report = RTCStatsReport::Create(1);
+  EXPECT_EQ(report->ToBinary(), std::string("\x02\x00\x00", 3));
+
+  std::unique_ptr<RTCTestStats1> a(new RTCTestStats1("a", -1));
+  a->integer = -2;
+  report->AddStats(std::move(a));
+  std::unique_ptr<RTCTestStats1> b(new RTCTestStats1("b", 2));
+  b->integer = 3;
+  report->AddStats(std::move(b));
+  report->AddStats(std::unique_ptr<RTCStats>(new RTCTestStats3("c", 4)));
+  const char kExpected[] =
+      "\x02"                                    // Report timestamp.
+      "\x03"                                    // Number of stats.
+      "\x00\x01" "a"                            // ID, interned as 0.
+      "\x01\x0c" "test-stats-1"                 // Type, interned as 1.
+      "\x01"                                    // Timestamp -1.
+      "\x01"                                    // One defined member.
+      "\x02\x07" "integer"                      // Name, interned as 2.
+      "\x01"                                    // kInt32.
+      "\x03"                                    // Value -2.
+      "\x03\x01" "b"                            // ID, interned as 3.
+      "\x01"                                    // Type "test-stats-1".
+      "\x04"                                    // Timestamp 2.
+      "\x01"                                    // One defined member.
+      "\x02"                                    // Name "integer".
+      "\x01"                                    // kInt32.
+      "\x06"                                    // Value 3.
+      "\x04\x01" "c"                            // ID, interned as 4.
+      "\x05\x0c" "test-stats-3"                 // Type, interned as 5.
+      "\x08"                                    // Timestamp 4.
+      "\x00"                                    // No defined members.
+      "\x00";                                   // No removed IDs.
+  EXPECT_EQ(report->ToBinary(), std::string(kExpected, sizeof(kExpected) - 1));
+  EXPECT_LT(report->ToBinary().size(), report->ToJson().size());
+}
+
+TEST(RTCStatsReport, FromBinary) {
+  rtc::scoped_refptr<RTCStatsReport> previous = RTCStatsReport::Create(1);
+  previous->AddStats(
+      std::unique_ptr<RTCStats>(new RTCTestStats2("removed", 1)));
+  rtc::scoped_refptr<RTCStatsReport> report = RTCStatsReport::Create(-2);
+  std::unique_ptr<RTCTestStats1> a(new RTCTestStats1("a", -1));
+  a->integer = -2;
+  report->AddStats(std::move(a));
+  std::unique_ptr<RTCTestStats2> b(new RTCTestStats2("b", 2));
+  b->number = 0.5;
+  report->AddStats(std::move(b));
+  std::unique_ptr<RTCTestStats3> c(new RTCTestStats3("c", 4));
+  c->string = "removed";
+  report->AddStats(std::move(c));
+  report->AddStats(std::unique_ptr<RTCStats>(new RTCTestStats3("d", 4)));
+  rtc::scoped_refptr<RTCStatsReport> delta = report->CreateDelta(*previous);
+
+  rtc::scoped_refptr<RTCStatsReport> decoded =
+      RTCStatsReport::FromBinary(delta->ToBinary());
+  ASSERT_TRUE(decoded);
+  EXPECT_EQ(decoded->timestamp_us(), -2);
+  EXPECT_EQ(decoded->ToJson(), delta->ToJson());
+  EXPECT_EQ(decoded->removed_ids(), delta->removed_ids());
+  ASSERT_TRUE(decoded->Get("a"));
+  EXPECT_STREQ(decoded->Get("a")->type(), "test-stats-1");
+  EXPECT_EQ(decoded->ToBinary(), delta->ToBinary());
+
+  // Decoded stats can be compared and copied.
+  rtc::scoped_refptr<RTCStatsReport> decoded_again =
+      RTCStatsReport::FromBinary(delta->ToBinary());
+  std::unique_ptr<RTCStats> a_copy = decoded->Get("a")->copy();
+  EXPECT_TRUE(*a_copy == *decoded->Get("a"));
+  EXPECT_EQ(a_copy->ToJson(), decoded_again->Get("a")->ToJson());
+}
+
+TEST(RTCStatsReport, FromBinaryRejectsInvalidInput) {
+  rtc::scoped_refptr<RTCStatsReport> report = RTCStatsReport::Create(1);
+  std::unique_ptr<RTCTestStats1> a(new RTCTestStats1("a", 1));
+  a->integer = 1;
+  report->AddStats(std::move(a));
+  std::string binary = report->ToBinary();
+  ASSERT_TRUE(RTCStatsReport::FromBinary(binary));
+
+  EXPECT_FALSE(RTCStatsReport::FromBinary(""));
+  // Every truncation of a valid report is invalid.
+  for (size_t size = 0; size < binary.size(); ++size)
+    EXPECT_FALSE(RTCStatsReport::FromBinary(binary.substr(0, size)));
+  // Trailing data.
+  EXPECT_FALSE(RTCStatsReport::FromBinary(binary + '\x00'));
+  // String index that has not been interned.
+  EXPECT_FALSE(RTCStatsReport::FromBinary(std::string("\x02\x01\x05", 3)));
+  // Unknown member type.
+  std::string unknown_type = binary;
+  size_t type_offset = binary.find("integer") + strlen("integer");
+  unknown_type[type_offset] = '\x7f';
+  EXPECT_FALSE(RTCStatsReport::FromBinary(unknown_type));
+  // Duplicate stats IDs.
+  std::string duplicate_id(
+      "\x02\x02"                       // Timestamp 1, two stats.
+      "\x00\x01" "a" "\x01\x01" "t"    // ID "a", type "t".
+      "\x02\x00"                       // Timestamp 1, no members.
+      "\x00\x01\x02\x00"               // Same ID "a" and type.
+      "\x00",                          // No removed IDs.
+      15);
+  EXPECT_FALSE(RTCStatsReport::FromBinary(duplicate_id));
+  duplicate_id[10] = '\x01';  // The second stats object has ID "t" instead.
+  EXPECT_TRUE(RTCStatsReport::FromBinary(duplicate_id));
+}
+
 }  // namespace webrtc
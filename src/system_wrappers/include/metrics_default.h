@@ -41,6 +41,11 @@ void Enable();
 void GetAndReset(
     std::map<std::string, std::unique_ptr<SampleInfo>>* histograms);
 
+// Gets a copy of the histograms without clearing any samples. Samples added
+// concurrently may or may not be included.
+void GetSnapshot(
+    std::map<std::string, std::unique_ptr<SampleInfo>>* histograms);
+
 // Functions below are mainly for testing.
 
 // Clears all samples.
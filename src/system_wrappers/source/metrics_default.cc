@@ -10,10 +10,12 @@
 #include "system_wrappers/include/metrics_default.h"
 
 #include <algorithm>
+#include <limits>
 
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/thread_annotations.h"
 #include "system_wrappers/include/metrics.h"
+#include "system_wrappers/include/sleep.h"
 
 // Default implementation of histogram methods for WebRTC clients that do not
 // want to provide their own implementation.
@@ -28,104 +30,299 @@ namespace {
 // linearly/exponentially spaced buckets) if samples are logged more frequently.
 const int kMaxSampleMapSize = 300;
 
+// Marks an unused slot in a SampleTable. Samples are clamped to
+// [min - 1, max], so this value is never a valid sample.
+const int kEmptySlot = std::numeric_limits<int>::min();
+
+// The writers of a SampleTable are counted in this many counters, on separate
+// cache lines, so that threads adding samples at the same time mostly don't
+// write to the same cache line.
+const int kNumWriterShards = 8;
+const size_t kCacheLineSize = 64;
+
+// Number of times SwapTables() checks for writers before it starts yielding.
+// Writers only hold a table for a few instructions, unless preempted.
+const int kMaxSwapSpins = 100;
+
+// Returns the writer counter to use for the calling thread. Threads run on
+// separate stacks, so the address of a local variable tells them apart without
+// a system call.
+int CurrentWriterShard() {
+  int local;
+  uint32_t stack_page =
+      static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&local) >> 16);
+  return static_cast<int>((stack_page * 2654435761u) >> 29) % kNumWriterShards;
+}
+
+// Fixed size, open addressed table mapping sample values to event counts.
+// Samples are added without locking: a slot is claimed for a new value with a
+// compare-and-swap and its count is then incremented atomically. Slots are
+// never released while samples are being added; Clear() may only be called
+// when no thread is in Add(). The number of threads in Add() is tracked by the
+// owner through AddWriter() and RemoveWriter(), in the counter given by
+// CurrentWriterShard().
+class SampleTable {
+ public:
+  explicit SampleTable(int max_keys)
+      : max_keys_(max_keys),
+        size_(TableSize(max_keys)),
+        keys_(new volatile int[size_]),
+        counts_(new volatile int[size_]) {
+    Clear();
+  }
+
+  void Add(int sample) {
+    const size_t mask = size_ - 1;
+    size_t slot = Hash(sample) & mask;
+    // The table is larger than |max_keys_|, so an empty slot or the sample is
+    // always found.
+    for (size_t probes = 0; probes < size_; ++probes) {
+      int key = rtc::AtomicOps::AcquireLoad(&keys_[slot]);
+      if (key == kEmptySlot) {
+        if (rtc::AtomicOps::Increment(&num_keys_) > max_keys_) {
+          // Full; samples with new values are dropped.
+          rtc::AtomicOps::Decrement(&num_keys_);
+          return;
+        }
+        key = rtc::AtomicOps::CompareAndSwap(&keys_[slot], kEmptySlot, sample);
+        if (key == kEmptySlot) {
+          rtc::AtomicOps::Increment(&counts_[slot]);
+          return;
+        }
+        // Another thread claimed the slot first.
+        rtc::AtomicOps::Decrement(&num_keys_);
+      }
+      if (key == sample) {
+        rtc::AtomicOps::Increment(&counts_[slot]);
+        return;
+      }
+      slot = (slot + 1) & mask;
+    }
+  }
+
+  // Copies the non-zero counts to |samples|.
+  void GetSamples(std::map<int, int>* samples) const {
+    for (size_t i = 0; i < size_; ++i) {
+      int key = rtc::AtomicOps::AcquireLoad(&keys_[i]);
+      if (key == kEmptySlot)
+        continue;
+      int count = rtc::AtomicOps::AcquireLoad(&counts_[i]);
+      if (count > 0)
+        (*samples)[key] = count;
+    }
+  }
+
+  void Clear() {
+    for (size_t i = 0; i < size_; ++i) {
+      rtc::AtomicOps::ReleaseStore(&counts_[i], 0);
+      rtc::AtomicOps::ReleaseStore(&keys_[i], kEmptySlot);
+    }
+    rtc::AtomicOps::ReleaseStore(&num_keys_, 0);
+  }
+
+  void AddWriter(int shard) {
+    rtc::AtomicOps::Increment(&writers_[shard].count);
+  }
+  void RemoveWriter(int shard) {
+    rtc::AtomicOps::Decrement(&writers_[shard].count);
+  }
+  bool HasWriters() const {
+    for (const WriterCount& writers : writers_) {
+      if (rtc::AtomicOps::AcquireLoad(&writers.count) != 0)
+        return true;
+    }
+    return false;
+  }
+
+ private:
+  static size_t TableSize(int max_keys) {
+    size_t size = 4;
+    while (size < static_cast<size_t>(max_keys) * 3 / 2 + 1)
+      size *= 2;
+    return size;
+  }
+
+  static size_t Hash(int sample) {
+    return (static_cast<uint32_t>(sample) * 2654435761u) >> 7;
+  }
+
+  const int max_keys_;
+  const size_t size_;
+  const std::unique_ptr<volatile int[]> keys_;
+  const std::unique_ptr<volatile int[]> counts_;
+  volatile int num_keys_ = 0;
+
+  // Padded to a cache line each, rather than aligned, so that tables can be
+  // allocated with plain new. The padding comes first to also keep the first
+  // count away from the read-mostly fields above.
+  struct WriterCount {
+    char padding[kCacheLineSize - sizeof(int)];
+    volatile int count;
+  };
+  WriterCount writers_[kNumWriterShards] = {};
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SampleTable);
+};
+
+// Samples are added to one of two tables without taking a lock. Reading and
+// clearing the samples swaps in the other table, waits for samples that are
+// in the middle of being added to the old one and then empties it, so the
+// number of distinct values is limited per reporting interval, as before.
 class RtcHistogram {
  public:
   RtcHistogram(const std::string& name, int min, int max, int bucket_count)
-      : min_(min), max_(max), info_(name, min, max, bucket_count) {
+      : min_(min),
+        max_(max),
+        info_(name, min, max, bucket_count),
+        first_table_(MaxKeys(min, max)),
+        second_table_(MaxKeys(min, max)),
+        active_(&first_table_) {
     RTC_DCHECK_GT(bucket_count, 0);
+    RTC_DCHECK_GT(min, kEmptySlot + 1);
   }
 
   void Add(int sample) {
     sample = std::min(sample, max_);
     sample = std::max(sample, min_ - 1);  // Underflow bucket.
 
-    rtc::CritScope cs(&crit_);
-    if (info_.samples.size() == kMaxSampleMapSize &&
-        info_.samples.find(sample) == info_.samples.end()) {
-      return;
+    const int shard = CurrentWriterShard();
+    while (true) {
+      SampleTable* table = rtc::AtomicOps::AcquireLoadPtr(&active_);
+      table->AddWriter(shard);
+      // Both the increment above and the swap in SwapTables() are full
+      // barriers, so either the table is still active here or SwapTables()
+      // sees this writer and waits for it.
+      if (rtc::AtomicOps::AcquireLoadPtr(&active_) == table) {
+        table->Add(sample);
+        table->RemoveWriter(shard);
+        return;
+      }
+      table->RemoveWriter(shard);
     }
-    ++info_.samples[sample];
   }
 
   // Returns a copy (or nullptr if there are no samples) and clears samples.
   std::unique_ptr<SampleInfo> GetAndReset() {
     rtc::CritScope cs(&crit_);
-    if (info_.samples.empty())
+    std::unique_ptr<SampleInfo> copy(
+        new SampleInfo(info_.name, info_.min, info_.max, info_.bucket_count));
+    SampleTable* table = SwapTables();
+    table->GetSamples(&copy->samples);
+    table->Clear();
+    if (copy->samples.empty())
       return nullptr;
 
-    SampleInfo* copy =
-        new SampleInfo(info_.name, info_.min, info_.max, info_.bucket_count);
+    return copy;
+  }
 
-    std::swap(info_.samples, copy->samples);
+  // Returns a copy (or nullptr if there are no samples) without clearing the
+  // samples.
+  std::unique_ptr<SampleInfo> GetSnapshot() const {
+    std::unique_ptr<SampleInfo> copy(
+        new SampleInfo(info_.name, info_.min, info_.max, info_.bucket_count));
+    GetSamples(&copy->samples);
+    if (copy->samples.empty())
+      return nullptr;
 
-    return std::unique_ptr<SampleInfo>(copy);
+    return copy;
   }
 
   const std::string& name() const { return info_.name; }
 
+  RtcHistogram* next() const { return next_; }
+  void set_next(RtcHistogram* next) { next_ = next; }
+
   // Functions only for testing.
   void Reset() {
     rtc::CritScope cs(&crit_);
-    info_.samples.clear();
+    SwapTables()->Clear();
   }
 
   int NumEvents(int sample) const {
-    rtc::CritScope cs(&crit_);
-    const auto it = info_.samples.find(sample);
-    return (it == info_.samples.end()) ? 0 : it->second;
+    std::map<int, int> samples;
+    GetSamples(&samples);
+    const auto it = samples.find(sample);
+    return (it == samples.end()) ? 0 : it->second;
   }
 
   int NumSamples() const {
+    std::map<int, int> samples;
+    GetSamples(&samples);
     int num_samples = 0;
-    rtc::CritScope cs(&crit_);
-    for (const auto& sample : info_.samples) {
+    for (const auto& sample : samples) {
       num_samples += sample.second;
     }
     return num_samples;
   }
 
   int MinSample() const {
-    rtc::CritScope cs(&crit_);
-    return (info_.samples.empty()) ? -1 : info_.samples.begin()->first;
+    std::map<int, int> samples;
+    GetSamples(&samples);
+    return samples.empty() ? -1 : samples.begin()->first;
   }
 
  private:
+  static int MaxKeys(int min, int max) {
+    // Values in [min - 1, max] can be added.
+    int64_t num_values = static_cast<int64_t>(max) - min + 2;
+    return static_cast<int>(
+        std::min<int64_t>(std::max<int64_t>(num_values, 1), kMaxSampleMapSize));
+  }
+
+  void GetSamples(std::map<int, int>* samples) const {
+    const SampleTable* table = rtc::AtomicOps::AcquireLoadPtr(
+        const_cast<SampleTable* volatile*>(&active_));
+    table->GetSamples(samples);
+  }
+
+  // Makes the inactive table the active one and returns the previously active
+  // table once no thread is adding samples to it.
+  SampleTable* SwapTables() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_) {
+    SampleTable* old_table = rtc::AtomicOps::AcquireLoadPtr(&active_);
+    SampleTable* new_table =
+        (old_table == &first_table_) ? &second_table_ : &first_table_;
+    rtc::AtomicOps::CompareAndSwapPtr(&active_, old_table, new_table);
+    for (int spins = 0; old_table->HasWriters(); ++spins) {
+      // Let a writer that has been preempted while adding a sample run.
+      if (spins >= kMaxSwapSpins)
+        SleepMs(0);
+    }
+    return old_table;
+  }
+
+  // Serializes GetAndReset() and Reset(). Not taken when adding samples.
   rtc::CriticalSection crit_;
   const int min_;
   const int max_;
-  SampleInfo info_ RTC_GUARDED_BY(crit_);
+  const SampleInfo info_;
+  SampleTable first_table_;
+  SampleTable second_table_;
+  SampleTable* volatile active_;
+  // Next histogram in the same bucket of the RtcHistogramMap index.
+  RtcHistogram* next_ = nullptr;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(RtcHistogram);
 };
 
 class RtcHistogramMap {
  public:
-  RtcHistogramMap() {}
+  RtcHistogramMap() {
+    for (auto& head : index_)
+      head = nullptr;
+  }
   ~RtcHistogramMap() {}
 
   Histogram* GetCountsHistogram(const std::string& name,
                                 int min,
                                 int max,
                                 int bucket_count) {
-    rtc::CritScope cs(&crit_);
-    const auto& it = map_.find(name);
-    if (it != map_.end())
-      return reinterpret_cast<Histogram*>(it->second.get());
-
-    RtcHistogram* hist = new RtcHistogram(name, min, max, bucket_count);
-    map_[name].reset(hist);
-    return reinterpret_cast<Histogram*>(hist);
+    return reinterpret_cast<Histogram*>(
+        GetOrCreateHistogram(name, min, max, bucket_count));
   }
 
   Histogram* GetEnumerationHistogram(const std::string& name, int boundary) {
-    rtc::CritScope cs(&crit_);
-    const auto& it = map_.find(name);
-    if (it != map_.end())
-      return reinterpret_cast<Histogram*>(it->second.get());
-
-    RtcHistogram* hist = new RtcHistogram(name, 1, boundary, boundary + 1);
-    map_[name].reset(hist);
-    return reinterpret_cast<Histogram*>(hist);
+    return reinterpret_cast<Histogram*>(
+        GetOrCreateHistogram(name, 1, boundary, boundary + 1));
   }
 
   void GetAndReset(
@@ -138,6 +335,16 @@ class RtcHistogramMap {
     }
   }
 
+  void GetSnapshot(
+      std::map<std::string, std::unique_ptr<SampleInfo>>* histograms) const {
+    rtc::CritScope cs(&crit_);
+    for (const auto& kv : map_) {
+      std::unique_ptr<SampleInfo> info = kv.second->GetSnapshot();
+      if (info)
+        histograms->insert(std::make_pair(kv.first, std::move(info)));
+    }
+  }
+
   // Functions only for testing.
   void Reset() {
     rtc::CritScope cs(&crit_);
@@ -146,27 +353,73 @@ class RtcHistogramMap {
   }
 
   int NumEvents(const std::string& name, int sample) const {
-    rtc::CritScope cs(&crit_);
-    const auto& it = map_.find(name);
-    return (it == map_.end()) ? 0 : it->second->NumEvents(sample);
+    const RtcHistogram* hist = Find(name);
+    return hist ? hist->NumEvents(sample) : 0;
   }
 
   int NumSamples(const std::string& name) const {
-    rtc::CritScope cs(&crit_);
-    const auto& it = map_.find(name);
-    return (it == map_.end()) ? 0 : it->second->NumSamples();
+    const RtcHistogram* hist = Find(name);
+    return hist ? hist->NumSamples() : 0;
   }
 
   int MinSample(const std::string& name) const {
-    rtc::CritScope cs(&crit_);
-    const auto& it = map_.find(name);
-    return (it == map_.end()) ? -1 : it->second->MinSample();
+    const RtcHistogram* hist = Find(name);
+    return hist ? hist->MinSample() : -1;
   }
 
  private:
+  static const size_t kIndexSize = 256;
+
+  static size_t IndexOf(const std::string& name) {
+    // FNV-1a.
+    uint32_t hash = 2166136261u;
+    for (char c : name) {
+      hash ^= static_cast<uint8_t>(c);
+      hash *= 16777619u;
+    }
+    return hash % kIndexSize;
+  }
+
+  // Looks up |name| without taking |crit_|. Histograms are only ever
+  // prepended to the index lists and are never removed.
+  RtcHistogram* Find(const std::string& name) const {
+    RtcHistogram* hist = rtc::AtomicOps::AcquireLoadPtr(
+        const_cast<RtcHistogram* volatile*>(&index_[IndexOf(name)]));
+    for (; hist; hist = hist->next()) {
+      if (hist->name() == name)
+        return hist;
+    }
+    return nullptr;
+  }
+
+  RtcHistogram* GetOrCreateHistogram(const std::string& name,
+                                     int min,
+                                     int max,
+                                     int bucket_count) {
+    RtcHistogram* hist = Find(name);
+    if (hist)
+      return hist;
+
+    rtc::CritScope cs(&crit_);
+    // Another thread may have created the histogram after the lookup above.
+    hist = Find(name);
+    if (hist)
+      return hist;
+
+    hist = new RtcHistogram(name, min, max, bucket_count);
+    map_[name].reset(hist);
+    RtcHistogram* volatile* head = &index_[IndexOf(name)];
+    hist->set_next(*head);
+    // Publishes the fully constructed histogram to lock-free readers.
+    rtc::AtomicOps::CompareAndSwapPtr(head, hist->next(), hist);
+    return hist;
+  }
+
   rtc::CriticalSection crit_;
   std::map<std::string, std::unique_ptr<RtcHistogram>> map_
       RTC_GUARDED_BY(crit_);
+  // Hash index over |map_| used for lookups that do not take |crit_|.
+  RtcHistogram* volatile index_[kIndexSize];
 
   RTC_DISALLOW_COPY_AND_ASSIGN(RtcHistogramMap);
 };
@@ -283,6 +536,14 @@ void GetAndReset(
     map->GetAndReset(histograms);
 }
 
+void GetSnapshot(
+    std::map<std::string, std::unique_ptr<SampleInfo>>* histograms) {
+  histograms->clear();
+  RtcHistogramMap* map = GetMap();
+  if (map)
+    map->GetSnapshot(histograms);
+}
+
 void Reset() {
   RtcHistogramMap* map = GetMap();
   if (map)
@@ -8,8 +8,15 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <memory>
+#include <vector>
+
+#include "rtc_base/logging.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/timeutils.h"
 #include "system_wrappers/include/metrics.h"
 #include "system_wrappers/include/metrics_default.h"
+#include "system_wrappers/include/sleep.h"
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -47,6 +54,21 @@ int NumEvents(const std::string& name,
 
   return it_sample->second;
 }
+
+const int kNumSamplesPerThread = 100000;
+
+void AddSamples(void* obj) {
+  const std::string* name = static_cast<const std::string*>(obj);
+  for (int i = 0; i < kNumSamplesPerThread; ++i)
+    RTC_HISTOGRAM_COUNTS_SPARSE_100(*name, i % 10);
+}
+
+const int kNumPerformanceSamplesPerThread = 10000000;
+
+void AddPerformanceSamples(void* obj) {
+  for (int i = 0; i < kNumPerformanceSamplesPerThread; ++i)
+    RTC_HISTOGRAM_COUNTS_1000("AddPerformanceMultipleThreads", i % 100);
+}
 }  // namespace
 
 class MetricsDefaultTest : public ::testing::Test {
@@ -160,4 +182,114 @@ TEST_F(MetricsDefaultTest, TestMinMaxBucket) {
   EXPECT_EQ(1u, histograms.begin()->second->samples.size());
 }
 
+TEST_F(MetricsDefaultTest, GetSnapshot) {
+  RTC_HISTOGRAM_PERCENTAGE("Histogram1", 4);
+  RTC_HISTOGRAM_PERCENTAGE("Histogram1", 5);
+  RTC_HISTOGRAM_PERCENTAGE("Histogram2", 10);
+
+  std::map<std::string, std::unique_ptr<metrics::SampleInfo>> histograms;
+  metrics::GetSnapshot(&histograms);
+  EXPECT_EQ(2u, histograms.size());
+  EXPECT_EQ(1, NumEvents("Histogram1", 4, histograms));
+  EXPECT_EQ(1, NumEvents("Histogram1", 5, histograms));
+  EXPECT_EQ(1, NumEvents("Histogram2", 10, histograms));
+
+  // Samples are kept.
+  EXPECT_EQ(2, metrics::NumSamples("Histogram1"));
+  EXPECT_EQ(1, metrics::NumSamples("Histogram2"));
+}
+
+TEST_F(MetricsDefaultTest, MaxDistinctSamples) {
+  const std::string kName = "MaxDistinctSamples";
+  for (int i = 1; i <= 400; ++i)
+    RTC_HISTOGRAM_COUNTS_1000(kName, i);
+  // Samples with new values are dropped once 300 values have been seen.
+  EXPECT_EQ(300, metrics::NumSamples(kName));
+  RTC_HISTOGRAM_COUNTS_1000(kName, 1);
+  EXPECT_EQ(2, metrics::NumEvents(kName, 1));
+  EXPECT_EQ(0, metrics::NumEvents(kName, 301));
+
+  // The limit applies per reporting interval.
+  std::map<std::string, std::unique_ptr<metrics::SampleInfo>> histograms;
+  metrics::GetAndReset(&histograms);
+  RTC_HISTOGRAM_COUNTS_1000(kName, 301);
+  EXPECT_EQ(1, metrics::NumEvents(kName, 301));
+}
+
+TEST_F(MetricsDefaultTest, AddSamplesFromMultipleThreads) {
+  const std::string kName = "MultipleThreads";
+  const int kNumThreads = 4;
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back(new rtc::PlatformThread(
+        &AddSamples, const_cast<std::string*>(&kName), "MetricsThread"));
+  }
+  for (auto& thread : threads)
+    thread->Start();
+
+  // Collect while the threads are adding samples; no sample may be lost.
+  int num_samples = 0;
+  std::map<std::string, std::unique_ptr<metrics::SampleInfo>> histograms;
+  for (int i = 0; i < 100; ++i) {
+    metrics::GetAndReset(&histograms);
+    num_samples += NumSamples(kName, histograms);
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+  metrics::GetAndReset(&histograms);
+  num_samples += NumSamples(kName, histograms);
+
+  EXPECT_EQ(kNumThreads * kNumSamplesPerThread, num_samples);
+}
+
+TEST_F(MetricsDefaultTest, DISABLED_AddPerformance) {
+  const std::string kName = "AddPerformance";
+  const int kNumSamples = 10000000;
+  int64_t start_ns = rtc::TimeNanos();
+  for (int i = 0; i < kNumSamples; ++i)
+    RTC_HISTOGRAM_COUNTS_1000(kName, i % 100);
+  int64_t cached_ns = rtc::TimeNanos() - start_ns;
+
+  start_ns = rtc::TimeNanos();
+  for (int i = 0; i < kNumSamples; ++i)
+    RTC_HISTOGRAM_COUNTS_SPARSE_1000(kName, i % 100);
+  int64_t sparse_ns = rtc::TimeNanos() - start_ns;
+
+  EXPECT_EQ(2 * kNumSamples, metrics::NumSamples(kName));
+  LOG(LS_INFO) << "Add: " << cached_ns / kNumSamples << " ns/sample, sparse: "
+               << sparse_ns / kNumSamples << " ns/sample.";
+}
+
+// Adds samples to one histogram from several threads at once, while another
+// thread collects them as a client reporting metrics periodically would.
+TEST_F(MetricsDefaultTest, DISABLED_AddPerformanceMultipleThreads) {
+  const std::string kName = "AddPerformanceMultipleThreads";
+  for (int num_threads : {1, 2, 4, 8}) {
+    metrics::Reset();
+    std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+    for (int i = 0; i < num_threads; ++i) {
+      threads.emplace_back(new rtc::PlatformThread(
+          &AddPerformanceSamples, nullptr, "MetricsThread"));
+    }
+    int64_t start_ns = rtc::TimeNanos();
+    for (auto& thread : threads)
+      thread->Start();
+    int64_t num_samples = 0;
+    std::map<std::string, std::unique_ptr<metrics::SampleInfo>> histograms;
+    while (num_samples <
+           static_cast<int64_t>(num_threads) * kNumPerformanceSamplesPerThread) {
+      SleepMs(10);
+      metrics::GetAndReset(&histograms);
+      num_samples += NumSamples(kName, histograms);
+    }
+    int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+    for (auto& thread : threads)
+      thread->Stop();
+
+    LOG(LS_INFO) << num_threads << " threads: "
+                 << elapsed_ns / kNumPerformanceSamplesPerThread
+                 << " ns/sample per thread.";
+  }
+}
+
 }  // namespace webrtc
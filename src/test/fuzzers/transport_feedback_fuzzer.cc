@@ -0,0 +1,58 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+// Parses the input, checking the result against the per packet status decoder
+// used by IsConsistent(), and encodes the parsed packets again both one by one
+// and in bulk, which must give the same feedback.
+void FuzzOneInput(const uint8_t* data, size_t size) {
+  std::unique_ptr<rtcp::TransportFeedback> feedback =
+      rtcp::TransportFeedback::ParseFrom(data, size);
+  if (!feedback)
+    return;
+  RTC_CHECK(feedback->IsConsistent());
+  if (feedback->GetBaseTimeUs() < 0)
+    return;
+
+  std::vector<uint16_t> sequence_numbers;
+  std::vector<int64_t> timestamps_us;
+  int64_t timestamp_us = feedback->GetBaseTimeUs();
+  for (const auto& packet : feedback->GetReceivedPackets()) {
+    timestamp_us += packet.delta_us();
+    sequence_numbers.push_back(packet.sequence_number());
+    timestamps_us.push_back(timestamp_us);
+  }
+
+  rtcp::TransportFeedback one_by_one;
+  one_by_one.SetBase(feedback->GetBaseSequence(), feedback->GetBaseTimeUs());
+  size_t num_added = 0;
+  while (num_added < sequence_numbers.size() &&
+         one_by_one.AddReceivedPacket(sequence_numbers[num_added],
+                                      timestamps_us[num_added])) {
+    ++num_added;
+  }
+  rtcp::TransportFeedback bulk;
+  bulk.SetBase(feedback->GetBaseSequence(), feedback->GetBaseTimeUs());
+  RTC_CHECK_EQ(num_added,
+               bulk.AddReceivedPackets(sequence_numbers, timestamps_us));
+  RTC_CHECK(bulk.IsConsistent());
+  RTC_CHECK_EQ(one_by_one.GetPacketStatusCount(), bulk.GetPacketStatusCount());
+  if (bulk.GetPacketStatusCount() > 0)
+    RTC_CHECK(one_by_one.Build() == bulk.Build());
+}
+
+}  // namespace webrtc
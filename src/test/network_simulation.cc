@@ -0,0 +1,234 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "test/network_simulation.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "call/call.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace test {
+
+NetworkSimulation::NetworkSimulation(int64_t start_time_us)
+    : clock_(start_time_us) {}
+
+NetworkSimulation::~NetworkSimulation() = default;
+
+void NetworkSimulation::PostDelayedTask(int64_t delay_us,
+                                        std::function<void()> task) {
+  RTC_DCHECK_GE(delay_us, 0);
+  events_.push(
+      Event{TimeUs() + delay_us, next_sequence_number_++, std::move(task)});
+}
+
+void NetworkSimulation::RunForMs(int64_t duration_ms) {
+  const int64_t end_time_us = TimeUs() + duration_ms * 1000;
+  while (!events_.empty() && events_.top().time_us <= end_time_us) {
+    // The task is moved out before the event is popped; the priority queue
+    // only orders by time and sequence number.
+    std::function<void()> task =
+        std::move(const_cast<Event&>(events_.top()).task);
+    int64_t time_us = events_.top().time_us;
+    events_.pop();
+    if (time_us > TimeUs())
+      clock_.AdvanceTimeMicroseconds(time_us - TimeUs());
+    task();
+  }
+  if (end_time_us > TimeUs())
+    clock_.AdvanceTimeMicroseconds(end_time_us - TimeUs());
+}
+
+SimulatedLink* NetworkSimulation::CreateLink(uint64_t seed) {
+  links_.emplace_back(new SimulatedLink(this, seed));
+  return links_.back().get();
+}
+
+SimulatedEndpoint* NetworkSimulation::CreateEndpoint() {
+  endpoints_.emplace_back(new SimulatedEndpoint(this));
+  return endpoints_.back().get();
+}
+
+void NetworkSimulation::ForwardPacket(SimulatedPacket packet) {
+  if (!packet.route)
+    return;
+  if (packet.next_hop < packet.route->size()) {
+    SimulatedLink* link = (*packet.route)[packet.next_hop++];
+    link->EnqueuePacket(std::move(packet));
+  } else if (packet.destination) {
+    packet.destination->OnPacketReceived(std::move(packet));
+  }
+}
+
+SimulatedLink::SimulatedLink(NetworkSimulation* simulation, uint64_t seed)
+    : simulation_(simulation), random_(seed) {}
+
+SimulatedLink::~SimulatedLink() = default;
+
+void SimulatedLink::SetConfig(const Config& config) {
+  config_ = config;
+  ++cross_traffic_generation_;
+  ScheduleCrossTraffic();
+}
+
+void SimulatedLink::EnqueuePacket(SimulatedPacket packet) {
+  if (config_.queue_length_packets > 0 &&
+      queue_.size() >= config_.queue_length_packets) {
+    ++stats_.packets_queue_dropped;
+    return;
+  }
+  queue_.push_back(QueuedPacket{std::move(packet), simulation_->TimeUs()});
+  if (!transmitting_)
+    StartTransmission();
+}
+
+void SimulatedLink::StartTransmission() {
+  if (queue_.empty()) {
+    transmitting_ = false;
+    return;
+  }
+  transmitting_ = true;
+  int64_t transmission_time_us = 0;
+  if (config_.capacity_kbps > 0) {
+    transmission_time_us = queue_.front().packet.data.size() * 8 * 1000 /
+                           config_.capacity_kbps;
+  }
+  simulation_->PostDelayedTask(transmission_time_us,
+                               [this] { OnTransmitted(); });
+}
+
+void SimulatedLink::OnTransmitted() {
+  QueuedPacket queued = std::move(queue_.front());
+  queue_.pop_front();
+  const int64_t now_us = simulation_->TimeUs();
+  const int64_t queue_delay_us = now_us - queued.enqueue_time_us;
+  ++stats_.packets_transmitted;
+  stats_.total_queue_delay_us += queue_delay_us;
+  stats_.max_queue_delay_us =
+      std::max(stats_.max_queue_delay_us, queue_delay_us);
+  StartTransmission();
+
+  if (!queued.packet.route) {
+    ++stats_.cross_traffic_packets;
+    return;
+  }
+  if (IsLost()) {
+    ++stats_.packets_lost;
+    return;
+  }
+
+  int64_t delay_us = static_cast<int64_t>(
+      random_.Gaussian(config_.delay_ms * 1000.0,
+                       config_.delay_standard_deviation_ms * 1000.0));
+  int64_t arrival_time_us = now_us + std::max<int64_t>(delay_us, 0);
+  if (!config_.allow_reordering)
+    arrival_time_us = std::max(arrival_time_us, last_arrival_time_us_);
+  last_arrival_time_us_ = std::max(last_arrival_time_us_, arrival_time_us);
+
+  NetworkSimulation* simulation = simulation_;
+  SimulatedPacket packet = std::move(queued.packet);
+  simulation_->PostDelayedTask(
+      arrival_time_us - now_us, [simulation, packet]() mutable {
+        simulation->ForwardPacket(std::move(packet));
+      });
+}
+
+bool SimulatedLink::IsLost() {
+  if (bad_state_) {
+    if (random_.Rand<double>() < config_.bad_to_good_probability)
+      bad_state_ = false;
+  } else if (random_.Rand<double>() < config_.good_to_bad_probability) {
+    bad_state_ = true;
+  }
+  double loss_probability =
+      bad_state_ ? config_.loss_probability_bad : config_.loss_probability_good;
+  return random_.Rand<double>() < loss_probability;
+}
+
+void SimulatedLink::ScheduleCrossTraffic() {
+  if (config_.cross_traffic_kbps <= 0 || config_.cross_traffic_packet_size == 0)
+    return;
+  double mean_interval_us = config_.cross_traffic_packet_size * 8 * 1000.0 /
+                            config_.cross_traffic_kbps;
+  int64_t interval_us =
+      static_cast<int64_t>(random_.Exponential(1.0 / mean_interval_us));
+  uint64_t generation = cross_traffic_generation_;
+  simulation_->PostDelayedTask(
+      interval_us, [this, generation] { OnCrossTraffic(generation); });
+}
+
+void SimulatedLink::OnCrossTraffic(uint64_t generation) {
+  if (generation != cross_traffic_generation_)
+    return;
+  SimulatedPacket packet;
+  packet.data = rtc::CopyOnWriteBuffer(config_.cross_traffic_packet_size);
+  packet.send_time_us = simulation_->TimeUs();
+  EnqueuePacket(std::move(packet));
+  ScheduleCrossTraffic();
+}
+
+SimulatedEndpoint::SimulatedEndpoint(NetworkSimulation* simulation)
+    : simulation_(simulation) {}
+
+SimulatedEndpoint::~SimulatedEndpoint() = default;
+
+void SimulatedEndpoint::SetRoute(const std::vector<SimulatedLink*>& links,
+                                 SimulatedEndpoint* destination) {
+  route_ = links;
+  destination_ = destination;
+}
+
+void SimulatedEndpoint::SetReceiver(PacketReceiver* receiver) {
+  receiver_ = receiver;
+}
+
+void SimulatedEndpoint::SendPacket(const uint8_t* data, size_t length) {
+  RTC_DCHECK(destination_) << "No route set.";
+  SimulatedPacket packet;
+  packet.data.SetData(data, length);
+  packet.send_time_us = simulation_->TimeUs();
+  packet.route = &route_;
+  packet.destination = destination_;
+  ++stats_.packets_sent;
+  simulation_->ForwardPacket(std::move(packet));
+}
+
+void SimulatedEndpoint::OnPacketReceived(SimulatedPacket packet) {
+  const int64_t now_us = simulation_->TimeUs();
+  const int64_t delay_us = now_us - packet.send_time_us;
+  ++stats_.packets_received;
+  stats_.bytes_received += packet.data.size();
+  stats_.total_delay_us += delay_us;
+  stats_.max_delay_us = std::max(stats_.max_delay_us, delay_us);
+  if (stats_.first_receive_time_us < 0)
+    stats_.first_receive_time_us = now_us;
+  stats_.last_receive_time_us = now_us;
+  if (receiver_) {
+    receiver_->DeliverPacket(MediaType::ANY, packet.data.cdata(),
+                             packet.data.size(), PacketTime());
+  }
+}
+
+bool SimulatedEndpoint::SendRtp(const uint8_t* packet,
+                                size_t length,
+                                const PacketOptions& options) {
+  SendPacket(packet, length);
+  return true;
+}
+
+bool SimulatedEndpoint::SendRtcp(const uint8_t* packet, size_t length) {
+  SendPacket(packet, length);
+  return true;
+}
+
+}  // namespace test
+}  // namespace webrtc
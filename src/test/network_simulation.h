@@ -0,0 +1,224 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef TEST_NETWORK_SIMULATION_H_
+#define TEST_NETWORK_SIMULATION_H_
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <vector>
+
+#include "api/call/transport.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/copyonwritebuffer.h"
+#include "rtc_base/random.h"
+#include "system_wrappers/include/clock.h"
+
+namespace webrtc {
+
+class PacketReceiver;
+
+namespace test {
+
+class SimulatedEndpoint;
+class SimulatedLink;
+
+// A packet travelling through the simulated network. Packets are moved
+// between the links of their route rather than allocated per hop.
+struct SimulatedPacket {
+  rtc::CopyOnWriteBuffer data;
+  // The time the packet was sent by its endpoint.
+  int64_t send_time_us = 0;
+  // The links the packet passes, followed by the destination. Null for cross
+  // traffic, which leaves the network after the link that generated it.
+  const std::vector<SimulatedLink*>* route = nullptr;
+  SimulatedEndpoint* destination = nullptr;
+  size_t next_hop = 0;
+};
+
+// Discrete-event network simulation. Events run in time order on the thread
+// calling RunForMs(), and the simulated clock jumps directly from one event to
+// the next, so a simulation typically runs much faster than real time.
+//
+// The simulation is not thread safe: links and endpoints must only be used
+// from the thread running it, e.g. from tasks posted with PostDelayedTask().
+// Components driving traffic through it must therefore use clock() and be
+// driven by posted tasks rather than by threads of their own.
+class NetworkSimulation {
+ public:
+  explicit NetworkSimulation(int64_t start_time_us);
+  ~NetworkSimulation();
+
+  Clock* clock() { return &clock_; }
+  int64_t TimeUs() const { return clock_.TimeInMicroseconds(); }
+
+  // Runs |task| |delay_us| after the current simulated time. Tasks scheduled
+  // for the same time run in the order they were posted.
+  void PostDelayedTask(int64_t delay_us, std::function<void()> task);
+
+  // Runs all events scheduled within |duration_ms| and leaves the clock at the
+  // end of the interval.
+  void RunForMs(int64_t duration_ms);
+
+  // The simulation owns the links and endpoints it creates.
+  SimulatedLink* CreateLink(uint64_t seed);
+  SimulatedEndpoint* CreateEndpoint();
+
+  // Hands |packet| to the next link of its route, or to its destination.
+  void ForwardPacket(SimulatedPacket packet);
+
+ private:
+  struct Event {
+    int64_t time_us;
+    uint64_t sequence_number;
+    std::function<void()> task;
+  };
+  struct EventLater {
+    bool operator()(const Event& a, const Event& b) const {
+      return a.time_us > b.time_us ||
+             (a.time_us == b.time_us && a.sequence_number > b.sequence_number);
+    }
+  };
+
+  SimulatedClock clock_;
+  std::priority_queue<Event, std::vector<Event>, EventLater> events_;
+  uint64_t next_sequence_number_ = 0;
+  std::vector<std::unique_ptr<SimulatedLink>> links_;
+  std::vector<std::unique_ptr<SimulatedEndpoint>> endpoints_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(NetworkSimulation);
+};
+
+// A link with a bottleneck queue, a propagation delay distribution, bursty
+// loss and optional cross traffic. Links are composed into routes, and a link
+// can be part of the routes of many endpoints.
+class SimulatedLink {
+ public:
+  struct Config {
+    Config() {}
+    // Link capacity in kbps, 0 for unlimited.
+    int capacity_kbps = 0;
+    // Queue length in packets, 0 for unlimited.
+    size_t queue_length_packets = 0;
+    // Propagation delay, added after the packet has left the queue.
+    int delay_ms = 0;
+    int delay_standard_deviation_ms = 0;
+    // If packets with a shorter propagation delay may overtake earlier ones.
+    bool allow_reordering = false;
+    // Gilbert-Elliott loss model. The link switches between a good and a bad
+    // state with the given probabilities for every transmitted packet and
+    // loses packets with the loss probability of the current state.
+    double loss_probability_good = 0.0;
+    double loss_probability_bad = 1.0;
+    double good_to_bad_probability = 0.0;
+    double bad_to_good_probability = 1.0;
+    // Average rate of Poisson distributed cross traffic sharing the queue and
+    // capacity of the link.
+    int cross_traffic_kbps = 0;
+    size_t cross_traffic_packet_size = 1200;
+  };
+
+  struct Stats {
+    size_t packets_transmitted = 0;
+    size_t packets_queue_dropped = 0;
+    size_t packets_lost = 0;
+    size_t cross_traffic_packets = 0;
+    int64_t total_queue_delay_us = 0;
+    int64_t max_queue_delay_us = 0;
+  };
+
+  SimulatedLink(NetworkSimulation* simulation, uint64_t seed);
+  ~SimulatedLink();
+
+  // Applies to packets transmitted from now on.
+  void SetConfig(const Config& config);
+
+  void EnqueuePacket(SimulatedPacket packet);
+
+  const Stats& stats() const { return stats_; }
+  size_t queue_length_packets() const { return queue_.size(); }
+
+ private:
+  struct QueuedPacket {
+    SimulatedPacket packet;
+    int64_t enqueue_time_us;
+  };
+
+  void StartTransmission();
+  void OnTransmitted();
+  bool IsLost();
+  void ScheduleCrossTraffic();
+  void OnCrossTraffic(uint64_t generation);
+
+  NetworkSimulation* const simulation_;
+  Config config_;
+  Random random_;
+  Stats stats_;
+  std::deque<QueuedPacket> queue_;
+  bool transmitting_ = false;
+  bool bad_state_ = false;
+  int64_t last_arrival_time_us_ = 0;
+  // Incremented on config changes to stop the previous cross traffic source.
+  uint64_t cross_traffic_generation_ = 0;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SimulatedLink);
+};
+
+// A network endpoint. Implements Transport so that RTP modules, or a Call
+// whose modules run on the simulated clock, can send through it, and delivers
+// received packets to a PacketReceiver.
+class SimulatedEndpoint : public Transport {
+ public:
+  struct Stats {
+    size_t packets_sent = 0;
+    size_t packets_received = 0;
+    size_t bytes_received = 0;
+    int64_t total_delay_us = 0;
+    int64_t max_delay_us = 0;
+    int64_t first_receive_time_us = -1;
+    int64_t last_receive_time_us = -1;
+  };
+
+  explicit SimulatedEndpoint(NetworkSimulation* simulation);
+  ~SimulatedEndpoint() override;
+
+  // Packets sent from this endpoint pass |links|, in order, to |destination|.
+  // Must not be changed while packets from this endpoint are in flight.
+  void SetRoute(const std::vector<SimulatedLink*>& links,
+                SimulatedEndpoint* destination);
+  void SetReceiver(PacketReceiver* receiver);
+
+  void SendPacket(const uint8_t* data, size_t length);
+  void OnPacketReceived(SimulatedPacket packet);
+
+  // Implements Transport.
+  bool SendRtp(const uint8_t* packet,
+               size_t length,
+               const PacketOptions& options) override;
+  bool SendRtcp(const uint8_t* packet, size_t length) override;
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  NetworkSimulation* const simulation_;
+  std::vector<SimulatedLink*> route_;
+  SimulatedEndpoint* destination_ = nullptr;
+  PacketReceiver* receiver_ = nullptr;
+  Stats stats_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SimulatedEndpoint);
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // TEST_NETWORK_SIMULATION_H_
@@ -0,0 +1,263 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "test/network_simulation.h"
+
+#include <string.h>
+
+#include <vector>
+
+#include "call/call.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/timeutils.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace test {
+
+namespace {
+
+const size_t kPacketSize = 1000;
+
+// Records the sequence number written into the first bytes of each packet.
+class SequenceNumberReceiver : public PacketReceiver {
+ public:
+  DeliveryStatus DeliverPacket(MediaType media_type,
+                               const uint8_t* packet,
+                               size_t length,
+                               const PacketTime& packet_time) override {
+    int sequence_number;
+    memcpy(&sequence_number, packet, sizeof(sequence_number));
+    sequence_numbers.push_back(sequence_number);
+    return DELIVERY_OK;
+  }
+
+  std::vector<int> sequence_numbers;
+};
+
+void SendPackets(SimulatedEndpoint* endpoint, int first, int count) {
+  uint8_t packet[kPacketSize] = {0};
+  for (int i = first; i < first + count; ++i) {
+    memcpy(packet, &i, sizeof(i));
+    endpoint->SendPacket(packet, sizeof(packet));
+  }
+}
+
+// Sends |rate_kbps| of |kPacketSize| byte packets from |endpoint| until
+// |end_time_us|.
+void SendAtRate(NetworkSimulation* simulation,
+                SimulatedEndpoint* endpoint,
+                int rate_kbps,
+                int64_t end_time_us) {
+  if (simulation->TimeUs() >= end_time_us)
+    return;
+  SendPackets(endpoint, 0, 1);
+  simulation->PostDelayedTask(
+      kPacketSize * 8 * 1000 / rate_kbps,
+      [simulation, endpoint, rate_kbps, end_time_us] {
+        SendAtRate(simulation, endpoint, rate_kbps, end_time_us);
+      });
+}
+
+}  // namespace
+
+class NetworkSimulationTest : public ::testing::Test {
+ public:
+  NetworkSimulationTest()
+      : simulation_(12345000),
+        link_(simulation_.CreateLink(1)),
+        sender_(simulation_.CreateEndpoint()),
+        receiver_(simulation_.CreateEndpoint()) {
+    sender_->SetRoute({link_}, receiver_);
+    receiver_->SetReceiver(&packet_receiver_);
+  }
+
+ protected:
+  NetworkSimulation simulation_;
+  SimulatedLink* const link_;
+  SimulatedEndpoint* const sender_;
+  SimulatedEndpoint* const receiver_;
+  SequenceNumberReceiver packet_receiver_;
+};
+
+TEST_F(NetworkSimulationTest, RunsTasksInTimeOrder) {
+  std::vector<int> order;
+  simulation_.PostDelayedTask(2000, [&order] { order.push_back(3); });
+  simulation_.PostDelayedTask(1000, [&order] { order.push_back(1); });
+  simulation_.PostDelayedTask(1000, [&order] { order.push_back(2); });
+  simulation_.PostDelayedTask(5000, [&order] { order.push_back(4); });
+  simulation_.RunForMs(2);
+  EXPECT_EQ(std::vector<int>({1, 2, 3}), order);
+  EXPECT_EQ(12347000, simulation_.TimeUs());
+  simulation_.RunForMs(3);
+  EXPECT_EQ(std::vector<int>({1, 2, 3, 4}), order);
+}
+
+TEST_F(NetworkSimulationTest, CapacityAndDelay) {
+  SimulatedLink::Config config;
+  config.capacity_kbps = 80;
+  config.delay_ms = 100;
+  link_->SetConfig(config);
+
+  // Each packet takes 100 ms to transmit.
+  SendPackets(sender_, 0, 10);
+  simulation_.RunForMs(199);
+  EXPECT_EQ(0u, receiver_->stats().packets_received);
+  simulation_.RunForMs(1);
+  EXPECT_EQ(1u, receiver_->stats().packets_received);
+  simulation_.RunForMs(899);
+  EXPECT_EQ(9u, receiver_->stats().packets_received);
+  simulation_.RunForMs(1);
+  EXPECT_EQ(10u, receiver_->stats().packets_received);
+  EXPECT_EQ(1100000, receiver_->stats().max_delay_us);
+  EXPECT_EQ(1000000, link_->stats().max_queue_delay_us);
+}
+
+TEST_F(NetworkSimulationTest, DropsPacketsWhenQueueIsFull) {
+  SimulatedLink::Config config;
+  config.capacity_kbps = 80;
+  config.queue_length_packets = 3;
+  link_->SetConfig(config);
+
+  SendPackets(sender_, 0, 10);
+  simulation_.RunForMs(10000);
+  // The packet being transmitted counts against the queue length.
+  EXPECT_EQ(std::vector<int>({0, 1, 2}), packet_receiver_.sequence_numbers);
+  EXPECT_EQ(7u, link_->stats().packets_queue_dropped);
+}
+
+TEST_F(NetworkSimulationTest, KeepsOrderUnlessReorderingIsAllowed) {
+  SimulatedLink::Config config;
+  config.delay_ms = 50;
+  config.delay_standard_deviation_ms = 20;
+  link_->SetConfig(config);
+  for (int i = 0; i < 100; ++i) {
+    SendPackets(sender_, i, 1);
+    simulation_.RunForMs(1);
+  }
+  simulation_.RunForMs(1000);
+  ASSERT_EQ(100u, packet_receiver_.sequence_numbers.size());
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(i, packet_receiver_.sequence_numbers[i]);
+
+  config.allow_reordering = true;
+  link_->SetConfig(config);
+  packet_receiver_.sequence_numbers.clear();
+  for (int i = 0; i < 100; ++i) {
+    SendPackets(sender_, i, 1);
+    simulation_.RunForMs(1);
+  }
+  simulation_.RunForMs(1000);
+  ASSERT_EQ(100u, packet_receiver_.sequence_numbers.size());
+  bool reordered = false;
+  for (int i = 1; i < 100; ++i) {
+    if (packet_receiver_.sequence_numbers[i] <
+        packet_receiver_.sequence_numbers[i - 1]) {
+      reordered = true;
+    }
+  }
+  EXPECT_TRUE(reordered);
+}
+
+TEST_F(NetworkSimulationTest, GilbertElliottLoss) {
+  SimulatedLink::Config config;
+  config.good_to_bad_probability = 0.01;
+  config.bad_to_good_probability = 0.25;
+  link_->SetConfig(config);
+
+  const int kNumPackets = 100000;
+  SendPackets(sender_, 0, kNumPackets);
+  simulation_.RunForMs(1000);
+  const std::vector<int>& received = packet_receiver_.sequence_numbers;
+  // The bad state, where all packets are lost, is entered with probability
+  // 0.01 and left with probability 0.25, giving 0.01 / (0.01 + 0.25) loss in
+  // bursts of 4 packets on average.
+  const double kExpectedLoss = 0.01 / 0.26;
+  double loss = 1.0 - static_cast<double>(received.size()) / kNumPackets;
+  EXPECT_NEAR(kExpectedLoss, loss, 0.005);
+  EXPECT_EQ(kNumPackets - received.size(), link_->stats().packets_lost);
+
+  int num_bursts = 0;
+  for (size_t i = 1; i < received.size(); ++i) {
+    if (received[i] != received[i - 1] + 1)
+      ++num_bursts;
+  }
+  ASSERT_GT(num_bursts, 0);
+  double avg_burst_length =
+      static_cast<double>(kNumPackets - received.size()) / num_bursts;
+  EXPECT_NEAR(4.0, avg_burst_length, 0.3);
+}
+
+TEST_F(NetworkSimulationTest, CrossTrafficSharesCapacity) {
+  SimulatedLink::Config config;
+  config.capacity_kbps = 1000;
+  config.cross_traffic_kbps = 400;
+  config.cross_traffic_packet_size = kPacketSize;
+  link_->SetConfig(config);
+
+  // Together with the cross traffic the link is overloaded, and the capacity
+  // is shared in proportion to the offered rates.
+  const int64_t kDurationMs = 20000;
+  SendAtRate(&simulation_, sender_, 800,
+             simulation_.TimeUs() + kDurationMs * 1000);
+  simulation_.RunForMs(kDurationMs);
+  int received_kbps =
+      static_cast<int>(receiver_->stats().bytes_received * 8 / kDurationMs);
+  EXPECT_NEAR(1000 * 800 / 1200, received_kbps, 30);
+  EXPECT_GT(link_->stats().cross_traffic_packets, 0u);
+}
+
+TEST_F(NetworkSimulationTest, EndpointsShareBottleneck) {
+  SimulatedLink* access_link = simulation_.CreateLink(2);
+  SimulatedEndpoint* other_sender = simulation_.CreateEndpoint();
+  SimulatedEndpoint* other_receiver = simulation_.CreateEndpoint();
+  other_sender->SetRoute({access_link, link_}, other_receiver);
+  SimulatedLink::Config config;
+  config.capacity_kbps = 800;
+  link_->SetConfig(config);
+  config.delay_ms = 50;
+  access_link->SetConfig(config);
+
+  const int64_t kDurationMs = 10000;
+  const int64_t end_time_us = simulation_.TimeUs() + kDurationMs * 1000;
+  SendAtRate(&simulation_, sender_, 400, end_time_us);
+  SendAtRate(&simulation_, other_sender, 400, end_time_us);
+  simulation_.RunForMs(kDurationMs + 1000);
+  EXPECT_EQ(sender_->stats().packets_sent,
+            receiver_->stats().packets_received);
+  EXPECT_EQ(other_sender->stats().packets_sent,
+            other_receiver->stats().packets_received);
+  EXPECT_GE(other_receiver->stats().max_delay_us, 50000);
+}
+
+// Measures how much faster than real time a loaded link is simulated.
+TEST_F(NetworkSimulationTest, DISABLED_SimulationSpeed) {
+  SimulatedLink::Config config;
+  config.capacity_kbps = 10000;
+  config.queue_length_packets = 100;
+  config.delay_ms = 50;
+  config.delay_standard_deviation_ms = 5;
+  config.cross_traffic_kbps = 2000;
+  link_->SetConfig(config);
+
+  const int64_t kDurationMs = 600000;
+  int64_t start_ns = rtc::TimeNanos();
+  SendAtRate(&simulation_, sender_, 9000,
+             simulation_.TimeUs() + kDurationMs * 1000);
+  simulation_.RunForMs(kDurationMs);
+  int64_t elapsed_ms =
+      (rtc::TimeNanos() - start_ns) / rtc::kNumNanosecsPerMillisec;
+  LOG(LS_INFO) << "Simulated " << kDurationMs << " ms with "
+               << link_->stats().packets_transmitted << " packets in "
+               << elapsed_ms << " ms.";
+}
+
+}  // namespace test
+}  // namespace webrtc
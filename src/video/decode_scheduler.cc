@@ -0,0 +1,168 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/decode_scheduler.h"
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/timeutils.h"
+#include "rtc_base/trace_event.h"
+
+namespace webrtc {
+
+DecodeScheduler::DecodeScheduler(int num_threads)
+    : stopping_(false), wake_event_(false, false) {
+  RTC_DCHECK_GT(num_threads, 0);
+  for (int i = 0; i < num_threads; ++i) {
+    threads_.emplace_back(new rtc::PlatformThread(
+        &ThreadFunction, this, "DecodingThread", rtc::kHighestPriority));
+    threads_.back()->Start();
+  }
+}
+
+DecodeScheduler::~DecodeScheduler() {
+  {
+    rtc::CritScope lock(&crit_);
+    RTC_DCHECK(streams_.empty());
+    stopping_ = true;
+  }
+  wake_event_.Set();
+  for (auto& thread : threads_)
+    thread->Stop();
+}
+
+void DecodeScheduler::AddStream(Stream* stream) {
+  rtc::CritScope lock(&crit_);
+  RTC_DCHECK(streams_.find(stream) == streams_.end());
+  Enqueue(stream, &streams_[stream]);
+}
+
+void DecodeScheduler::RemoveStream(Stream* stream) {
+  rtc::Event removed_event(false, false);
+  {
+    rtc::CritScope lock(&crit_);
+    auto it = streams_.find(stream);
+    RTC_DCHECK(it != streams_.end());
+    StreamState* state = &it->second;
+    if (state->queued) {
+      ready_streams_.erase(
+          std::find(ready_streams_.begin(), ready_streams_.end(), stream));
+    }
+    Unschedule(stream, state);
+    if (!state->running) {
+      streams_.erase(it);
+      return;
+    }
+    state->removed_event = &removed_event;
+  }
+  removed_event.Wait(rtc::Event::kForever);
+}
+
+void DecodeScheduler::Wake(Stream* stream) {
+  rtc::CritScope lock(&crit_);
+  auto it = streams_.find(stream);
+  if (it == streams_.end())
+    return;
+  StreamState* state = &it->second;
+  if (state->running) {
+    state->woken = true;
+  } else if (!state->queued) {
+    Unschedule(stream, state);
+    Enqueue(stream, state);
+  }
+}
+
+void DecodeScheduler::ThreadFunction(void* ptr) {
+  static_cast<DecodeScheduler*>(ptr)->Run();
+}
+
+void DecodeScheduler::Run() {
+  while (true) {
+    Stream* stream = nullptr;
+    int wait_ms = rtc::Event::kForever;
+    {
+      rtc::CritScope lock(&crit_);
+      if (stopping_) {
+        // Pass the wake up on to the next thread.
+        wake_event_.Set();
+        return;
+      }
+
+      int64_t now_ms = rtc::TimeMillis();
+      while (!scheduled_streams_.empty() &&
+             scheduled_streams_.begin()->first <= now_ms) {
+        Stream* due_stream = scheduled_streams_.begin()->second;
+        StreamState* state = &streams_[due_stream];
+        Unschedule(due_stream, state);
+        Enqueue(due_stream, state);
+      }
+
+      if (!ready_streams_.empty()) {
+        stream = ready_streams_.front();
+        ready_streams_.pop_front();
+        StreamState* state = &streams_[stream];
+        state->queued = false;
+        state->running = true;
+        // Wake another thread to take the remaining streams, and to keep track
+        // of when the scheduled ones are due, while this one is decoding.
+        if (!ready_streams_.empty() || !scheduled_streams_.empty())
+          wake_event_.Set();
+      } else if (!scheduled_streams_.empty()) {
+        wait_ms =
+            static_cast<int>(scheduled_streams_.begin()->first - now_ms);
+      }
+    }
+
+    if (!stream) {
+      wake_event_.Wait(wait_ms);
+      continue;
+    }
+
+    int64_t next_run_ms;
+    {
+      TRACE_EVENT0("webrtc", "DecodeScheduler::DecodeFrames");
+      next_run_ms = stream->DecodeFrames();
+    }
+
+    rtc::CritScope lock(&crit_);
+    auto it = streams_.find(stream);
+    RTC_DCHECK(it != streams_.end());
+    StreamState* state = &it->second;
+    bool woken = state->woken;
+    state->running = false;
+    state->woken = false;
+    if (state->removed_event) {
+      state->removed_event->Set();
+      streams_.erase(it);
+    } else if (woken || next_run_ms == 0) {
+      Enqueue(stream, state);
+    } else if (next_run_ms > 0) {
+      state->run_time_ms = rtc::TimeMillis() + next_run_ms;
+      scheduled_streams_.insert(std::make_pair(state->run_time_ms, stream));
+    }
+  }
+}
+
+void DecodeScheduler::Enqueue(Stream* stream, StreamState* state) {
+  RTC_DCHECK(!state->queued);
+  state->queued = true;
+  ready_streams_.push_back(stream);
+  wake_event_.Set();
+}
+
+void DecodeScheduler::Unschedule(Stream* stream, StreamState* state) {
+  if (state->run_time_ms == -1)
+    return;
+  scheduled_streams_.erase(std::make_pair(state->run_time_ms, stream));
+  state->run_time_ms = -1;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,100 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VIDEO_DECODE_SCHEDULER_H_
+#define VIDEO_DECODE_SCHEDULER_H_
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Decodes video receive streams on a fixed pool of threads, instead of on a
+// thread per stream, for receivers of a large number of streams. A stream is
+// run on one thread at a time, so it needs no locking of its own for the
+// state of its decoder, but may run on a different thread each time.
+class DecodeScheduler {
+ public:
+  class Stream {
+   public:
+    // Decodes the frames that are due for decoding. Returns the time in ms
+    // until it should be called again, 0 to be called again once other
+    // streams have had their turn, or -1 to not be called until Wake().
+    virtual int64_t DecodeFrames() = 0;
+
+   protected:
+    virtual ~Stream() {}
+  };
+
+  explicit DecodeScheduler(int num_threads);
+  ~DecodeScheduler();
+
+  int num_threads() const { return static_cast<int>(threads_.size()); }
+
+  // Starts decoding |stream|, with a first DecodeFrames() call right away.
+  void AddStream(Stream* stream);
+  // Stops decoding |stream|. Blocks until any ongoing DecodeFrames() call for
+  // it has returned, so it must not be called from DecodeFrames().
+  void RemoveStream(Stream* stream);
+  // Makes |stream| decode as soon as there is a free thread, e.g. because it
+  // has a new decodable frame. Does nothing if the stream is not added.
+  void Wake(Stream* stream);
+
+ private:
+  struct StreamState {
+    // When the stream should be run, or -1 if it is not scheduled to run at a
+    // given time.
+    int64_t run_time_ms = -1;
+    bool queued = false;
+    bool running = false;
+    // Wake() was called while running, to run again right away.
+    bool woken = false;
+    // Set by RemoveStream() while running, to be signaled when done.
+    rtc::Event* removed_event = nullptr;
+  };
+
+  static void ThreadFunction(void* ptr);
+  void Run();
+
+  void Enqueue(Stream* stream, StreamState* state)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void Unschedule(Stream* stream, StreamState* state)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  rtc::CriticalSection crit_;
+  std::map<Stream*, StreamState> streams_ RTC_GUARDED_BY(crit_);
+  // Streams to run as soon as there is a free thread, in the order they
+  // became ready.
+  std::deque<Stream*> ready_streams_ RTC_GUARDED_BY(crit_);
+  // Streams to run at a given time, ordered by that time.
+  std::set<std::pair<int64_t, Stream*>> scheduled_streams_
+      RTC_GUARDED_BY(crit_);
+  bool stopping_ RTC_GUARDED_BY(crit_);
+  // Wakes up an idle thread, when a stream becomes ready or the first
+  // scheduled stream changes.
+  rtc::Event wake_event_;
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(DecodeScheduler);
+};
+
+}  // namespace webrtc
+
+#endif  // VIDEO_DECODE_SCHEDULER_H_
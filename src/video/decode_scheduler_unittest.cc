@@ -0,0 +1,148 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/decode_scheduler.h"
+
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/event.h"
+#include "system_wrappers/include/sleep.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kTimeoutMs = 1000;
+
+class FakeStream : public DecodeScheduler::Stream {
+ public:
+  explicit FakeStream(int64_t next_run_ms)
+      : next_run_ms_(next_run_ms),
+        started_event_(false, false),
+        decoded_event_(false, false) {}
+
+  int64_t DecodeFrames() override {
+    {
+      rtc::CritScope lock(&crit_);
+      EXPECT_FALSE(decoding_) << "Decoded on two threads at once.";
+      decoding_ = true;
+    }
+    if (other_stream_) {
+      // Wait for the other stream to start decoding on another thread.
+      started_event_.Set();
+      EXPECT_TRUE(other_stream_->started_event_.Wait(kTimeoutMs));
+    }
+    SleepMs(decode_time_ms_);
+    {
+      rtc::CritScope lock(&crit_);
+      decoding_ = false;
+      ++num_decodes_;
+    }
+    decoded_event_.Set();
+    return next_run_ms_;
+  }
+
+  bool decoding() const {
+    rtc::CritScope lock(&crit_);
+    return decoding_;
+  }
+  int num_decodes() const {
+    rtc::CritScope lock(&crit_);
+    return num_decodes_;
+  }
+
+  void set_decode_time_ms(int decode_time_ms) {
+    decode_time_ms_ = decode_time_ms;
+  }
+  void set_other_stream(FakeStream* other_stream) {
+    other_stream_ = other_stream;
+  }
+
+  rtc::Event* decoded_event() { return &decoded_event_; }
+
+ private:
+  const int64_t next_run_ms_;
+  int decode_time_ms_ = 0;
+  FakeStream* other_stream_ = nullptr;
+  rtc::Event started_event_;
+  rtc::Event decoded_event_;
+  rtc::CriticalSection crit_;
+  bool decoding_ RTC_GUARDED_BY(crit_) = false;
+  int num_decodes_ RTC_GUARDED_BY(crit_) = 0;
+};
+
+}  // namespace
+
+TEST(DecodeSchedulerTest, DecodesAddedStream) {
+  DecodeScheduler scheduler(1);
+  FakeStream stream(-1);
+  scheduler.AddStream(&stream);
+  EXPECT_TRUE(stream.decoded_event()->Wait(kTimeoutMs));
+  scheduler.RemoveStream(&stream);
+  EXPECT_EQ(1, stream.num_decodes());
+}
+
+TEST(DecodeSchedulerTest, DecodesAgainWhenWoken) {
+  DecodeScheduler scheduler(2);
+  FakeStream stream(-1);
+  scheduler.AddStream(&stream);
+  EXPECT_TRUE(stream.decoded_event()->Wait(kTimeoutMs));
+  scheduler.Wake(&stream);
+  EXPECT_TRUE(stream.decoded_event()->Wait(kTimeoutMs));
+  scheduler.RemoveStream(&stream);
+  EXPECT_EQ(2, stream.num_decodes());
+
+  // Waking a removed stream does nothing.
+  scheduler.Wake(&stream);
+  EXPECT_FALSE(stream.decoded_event()->Wait(20));
+}
+
+TEST(DecodeSchedulerTest, DecodesAgainAfterReturnedTime) {
+  DecodeScheduler scheduler(1);
+  FakeStream stream(10);
+  FakeStream idle_stream(-1);
+  scheduler.AddStream(&stream);
+  scheduler.AddStream(&idle_stream);
+  for (int i = 0; i < 3; ++i)
+    EXPECT_TRUE(stream.decoded_event()->Wait(kTimeoutMs));
+  scheduler.RemoveStream(&stream);
+  scheduler.RemoveStream(&idle_stream);
+  EXPECT_GE(stream.num_decodes(), 3);
+  EXPECT_EQ(1, idle_stream.num_decodes());
+}
+
+TEST(DecodeSchedulerTest, DecodesStreamsInParallel) {
+  DecodeScheduler scheduler(2);
+  FakeStream stream1(-1);
+  FakeStream stream2(-1);
+  stream1.set_other_stream(&stream2);
+  stream2.set_other_stream(&stream1);
+  scheduler.AddStream(&stream1);
+  scheduler.AddStream(&stream2);
+  EXPECT_TRUE(stream1.decoded_event()->Wait(kTimeoutMs));
+  EXPECT_TRUE(stream2.decoded_event()->Wait(kTimeoutMs));
+  scheduler.RemoveStream(&stream1);
+  scheduler.RemoveStream(&stream2);
+}
+
+TEST(DecodeSchedulerTest, RemoveStreamWaitsForDecodeToFinish) {
+  DecodeScheduler scheduler(1);
+  FakeStream stream(0);
+  stream.set_decode_time_ms(20);
+  scheduler.AddStream(&stream);
+  EXPECT_TRUE(stream.decoded_event()->Wait(kTimeoutMs));
+  // The stream is decoding again, or about to.
+  scheduler.RemoveStream(&stream);
+  EXPECT_FALSE(stream.decoding());
+  int num_decodes = stream.num_decodes();
+  SleepMs(50);
+  EXPECT_EQ(num_decodes, stream.num_decodes());
+}
+
+}  // namespace webrtc
@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/encoder_queue_pool.h"
+
+#include <utility>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+EncoderQueuePool::EncoderQueuePool(int num_queues) : next_task_id_(0) {
+  RTC_DCHECK_GT(num_queues, 0);
+  queues_.resize(num_queues);
+  for (QueueState& state : queues_)
+    state.queue.reset(new rtc::TaskQueue("EncoderQueue"));
+}
+
+EncoderQueuePool::~EncoderQueuePool() {
+  // Stop the queues before the pending tasks are destroyed, since the tasks
+  // posted to run them refer to them.
+  for (QueueState& state : queues_) {
+    RTC_DCHECK_EQ(0, state.num_streams);
+    state.queue.reset();
+  }
+}
+
+rtc::TaskQueue* EncoderQueuePool::AcquireQueue() {
+  rtc::CritScope lock(&crit_);
+  QueueState* least_used = &queues_[0];
+  for (QueueState& state : queues_) {
+    if (state.num_streams < least_used->num_streams)
+      least_used = &state;
+  }
+  ++least_used->num_streams;
+  return least_used->queue.get();
+}
+
+void EncoderQueuePool::ReleaseQueue(rtc::TaskQueue* queue) {
+  rtc::CritScope lock(&crit_);
+  QueueState* state = GetState(queue);
+  RTC_DCHECK_GT(state->num_streams, 0);
+  --state->num_streams;
+}
+
+void EncoderQueuePool::PostTask(rtc::TaskQueue* queue,
+                                const void* stream,
+                                int64_t deadline_ms,
+                                std::unique_ptr<rtc::QueuedTask> task) {
+  QueueState* state;
+  {
+    rtc::CritScope lock(&crit_);
+    state = GetState(queue);
+    state->pending_tasks[stream].push_back(
+        PendingTask{deadline_ms, next_task_id_++, std::move(task)});
+  }
+  // Each posted task runs the pending task that is due first when it is run,
+  // which need not be the one posted with it.
+  queue->PostTask([this, state] { RunNextTask(state); });
+}
+
+EncoderQueuePool::QueueState* EncoderQueuePool::GetState(
+    rtc::TaskQueue* queue) {
+  for (QueueState& state : queues_) {
+    if (state.queue.get() == queue)
+      return &state;
+  }
+  RTC_NOTREACHED();
+  return nullptr;
+}
+
+void EncoderQueuePool::RunNextTask(QueueState* state) {
+  RTC_DCHECK(state->queue->IsCurrent());
+  std::unique_ptr<rtc::QueuedTask> task;
+  {
+    rtc::CritScope lock(&crit_);
+    // Only the first task of each stream may run. Of those, pick the one due
+    // first, and the one posted first of those due at the same time.
+    auto next = state->pending_tasks.end();
+    for (auto it = state->pending_tasks.begin();
+         it != state->pending_tasks.end(); ++it) {
+      const PendingTask& first = it->second.front();
+      if (next == state->pending_tasks.end() ||
+          first.deadline_ms < next->second.front().deadline_ms ||
+          (first.deadline_ms == next->second.front().deadline_ms &&
+           first.id < next->second.front().id)) {
+        next = it;
+      }
+    }
+    RTC_DCHECK(next != state->pending_tasks.end());
+    task = std::move(next->second.front().task);
+    next->second.pop_front();
+    if (next->second.empty())
+      state->pending_tasks.erase(next);
+  }
+  if (!task->Run())
+    task.release();
+}
+
+}  // namespace webrtc
@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VIDEO_ENCODER_QUEUE_POOL_H_
+#define VIDEO_ENCODER_QUEUE_POOL_H_
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/task_queue.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Runs the encoders of video send streams on a fixed pool of task queues,
+// instead of on a task queue per stream, for senders of a large number of
+// streams. Each stream runs all of its tasks on the one queue it is given, so
+// they are serialized as on a queue of its own.
+//
+// Tasks posted through the pool wait in a queue per stream and run in the
+// order they were posted within their stream. Across the streams sharing a
+// queue, the stream whose next task has the earliest deadline runs first, so
+// when the queue is overloaded the frame closest to its deadline is encoded
+// first. A task of a stream is never run ahead of the tasks the stream posted
+// before it, which keeps e.g. its frames from being encoded after its Stop().
+class EncoderQueuePool {
+ public:
+  explicit EncoderQueuePool(int num_queues);
+  ~EncoderQueuePool();
+
+  // Returns the queue with the fewest streams, for a new stream to run its
+  // tasks on. The stream must call ReleaseQueue() when it is done with it.
+  rtc::TaskQueue* AcquireQueue();
+  void ReleaseQueue(rtc::TaskQueue* queue);
+
+  // Posts |task| of |stream| to |queue|, the queue acquired for the stream,
+  // to be run by |deadline_ms|. The deadlines of the streams sharing a queue
+  // must have the same time base.
+  void PostTask(rtc::TaskQueue* queue,
+                const void* stream,
+                int64_t deadline_ms,
+                std::unique_ptr<rtc::QueuedTask> task);
+  template <class Closure,
+            typename std::enable_if<
+                std::is_copy_constructible<Closure>::value>::type* = nullptr>
+  void PostTask(rtc::TaskQueue* queue,
+                const void* stream,
+                int64_t deadline_ms,
+                const Closure& closure) {
+    PostTask(queue, stream, deadline_ms, rtc::NewClosure(closure));
+  }
+
+ private:
+  struct PendingTask {
+    int64_t deadline_ms;
+    uint64_t id;
+    std::unique_ptr<rtc::QueuedTask> task;
+  };
+  struct QueueState {
+    std::unique_ptr<rtc::TaskQueue> queue;
+    int num_streams = 0;
+    // Tasks waiting to be run, in the order they were posted, per stream.
+    std::map<const void*, std::deque<PendingTask>> pending_tasks;
+  };
+
+  QueueState* GetState(rtc::TaskQueue* queue)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void RunNextTask(QueueState* state);
+
+  rtc::CriticalSection crit_;
+  uint64_t next_task_id_ RTC_GUARDED_BY(crit_);
+  // The queues are only added to in the constructor, and are stopped in the
+  // destructor before anything else is destroyed.
+  std::vector<QueueState> queues_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(EncoderQueuePool);
+};
+
+}  // namespace webrtc
+
+#endif  // VIDEO_ENCODER_QUEUE_POOL_H_
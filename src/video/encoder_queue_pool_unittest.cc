@@ -0,0 +1,246 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/encoder_queue_pool.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/event.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/timeutils.h"
+#include "system_wrappers/include/sleep.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kTimeoutMs = 1000;
+
+// A stream for the performance test, which spends CPU time to encode its
+// frames.
+class BusyStream {
+ public:
+  void OnFramePosted() {
+    rtc::CritScope lock(&crit_);
+    ++frames_waiting_;
+  }
+
+  void Encode(int64_t capture_time_ms, int64_t encode_time_us) {
+    {
+      rtc::CritScope lock(&crit_);
+      if (--frames_waiting_ > 0) {
+        ++frames_dropped_;
+        return;
+      }
+    }
+    int64_t end_us = rtc::TimeMicros() + encode_time_us;
+    while (rtc::TimeMicros() < end_us) {
+    }
+    rtc::CritScope lock(&crit_);
+    latencies_ms_.push_back(rtc::TimeMillis() - capture_time_ms);
+  }
+
+  int frames_dropped() const {
+    rtc::CritScope lock(&crit_);
+    return frames_dropped_;
+  }
+  std::vector<int64_t> latencies_ms() const {
+    rtc::CritScope lock(&crit_);
+    return latencies_ms_;
+  }
+
+ private:
+  rtc::CriticalSection crit_;
+  int frames_waiting_ RTC_GUARDED_BY(crit_) = 0;
+  int frames_dropped_ RTC_GUARDED_BY(crit_) = 0;
+  std::vector<int64_t> latencies_ms_ RTC_GUARDED_BY(crit_);
+};
+
+// Records the order in which the tasks posted through it are run.
+class TaskRecorder {
+ public:
+  TaskRecorder(EncoderQueuePool* pool, rtc::TaskQueue* queue)
+      : pool_(pool), queue_(queue) {}
+
+  void Post(const void* stream, int64_t deadline_ms, const std::string& name) {
+    pool_->PostTask(queue_, stream, deadline_ms, [this, name] {
+      rtc::CritScope lock(&crit_);
+      names_.push_back(name);
+    });
+  }
+
+  std::vector<std::string> names() const {
+    rtc::CritScope lock(&crit_);
+    return names_;
+  }
+
+ private:
+  EncoderQueuePool* const pool_;
+  rtc::TaskQueue* const queue_;
+  rtc::CriticalSection crit_;
+  std::vector<std::string> names_ RTC_GUARDED_BY(crit_);
+};
+
+void WaitUntilIdle(rtc::TaskQueue* queue) {
+  rtc::Event event(false, false);
+  queue->PostTask([&event] { event.Set(); });
+  ASSERT_TRUE(event.Wait(kTimeoutMs));
+}
+
+}  // namespace
+
+TEST(EncoderQueuePoolTest, AssignsStreamsToLeastUsedQueue) {
+  EncoderQueuePool pool(2);
+  rtc::TaskQueue* queue1 = pool.AcquireQueue();
+  rtc::TaskQueue* queue2 = pool.AcquireQueue();
+  EXPECT_NE(queue1, queue2);
+  pool.ReleaseQueue(queue2);
+  EXPECT_EQ(queue2, pool.AcquireQueue());
+  EXPECT_EQ(queue1, pool.AcquireQueue());
+  pool.ReleaseQueue(queue1);
+  pool.ReleaseQueue(queue1);
+  pool.ReleaseQueue(queue2);
+}
+
+TEST(EncoderQueuePoolTest, RunsStreamWithEarliestDeadlineFirst) {
+  EncoderQueuePool pool(1);
+  rtc::TaskQueue* queue = pool.AcquireQueue();
+  TaskRecorder recorder(&pool, queue);
+  const int kStream1 = 1;
+  const int kStream2 = 2;
+  const int kStream3 = 3;
+
+  // Keep the queue busy until all tasks are posted.
+  rtc::Event unblock(false, false);
+  queue->PostTask([&unblock] { unblock.Wait(rtc::Event::kForever); });
+  recorder.Post(&kStream1, 30, "1a");
+  recorder.Post(&kStream1, 10, "1b");
+  recorder.Post(&kStream2, 20, "2a");
+  recorder.Post(&kStream3, 30, "3a");
+  unblock.Set();
+  WaitUntilIdle(queue);
+
+  // Stream 2 is due first. Stream 1 and 3 are due at the same time, and
+  // stream 1 posted first. The second task of stream 1 is due before all the
+  // others, but stays behind the first task of its stream.
+  EXPECT_EQ(std::vector<std::string>({"2a", "1a", "1b", "3a"}),
+            recorder.names());
+  pool.ReleaseQueue(queue);
+}
+
+TEST(EncoderQueuePoolTest, RunsTasksOfStreamInPostingOrder) {
+  EncoderQueuePool pool(1);
+  rtc::TaskQueue* queue = pool.AcquireQueue();
+  TaskRecorder recorder(&pool, queue);
+  const int kStream1 = 1;
+  const int kStream2 = 2;
+
+  rtc::Event unblock(false, false);
+  queue->PostTask([&unblock] { unblock.Wait(rtc::Event::kForever); });
+  // A stop that is due before the frames of its stream still runs after the
+  // frames that were posted before it.
+  recorder.Post(&kStream1, 10, "frame1");
+  recorder.Post(&kStream1, 50, "frame2");
+  recorder.Post(&kStream2, 20, "other_frame");
+  recorder.Post(&kStream1, 0, "stop");
+  unblock.Set();
+  WaitUntilIdle(queue);
+
+  EXPECT_EQ(std::vector<std::string>({"frame1", "other_frame", "frame2",
+                                      "stop"}),
+            recorder.names());
+  pool.ReleaseQueue(queue);
+}
+
+// Encodes frames of a number of streams on a queue per stream and on a pool
+// of two queues, and reports the latency from capture to encoded frame. The
+// streams take about 80% of a core on average, and more for a while with
+// every key frame. Each stream drops a frame if a newer one is waiting, as
+// VideoStreamEncoder does.
+TEST(EncoderQueuePoolTest, DISABLED_EncodeLatencyUnderLoadPerformance) {
+  const int kNumQueues = 2;
+  const int kNumStreams = 16;
+  const int kFrameIntervalMs = 33;
+  const int kNumFrames = 300;
+  const int64_t kEncodeTimeUs = 1500;
+  const int64_t kKeyFrameEncodeTimeUs = 7500;
+  const int kKeyFrameInterval = 30;
+
+  for (bool use_pool : {false, true}) {
+    EncoderQueuePool pool(kNumQueues);
+    std::vector<std::unique_ptr<rtc::TaskQueue>> owned_queues;
+    std::vector<std::unique_ptr<BusyStream>> streams;
+    std::vector<rtc::TaskQueue*> queues;
+    for (int i = 0; i < kNumStreams; ++i) {
+      streams.emplace_back(new BusyStream());
+      if (use_pool) {
+        queues.push_back(pool.AcquireQueue());
+      } else {
+        owned_queues.emplace_back(new rtc::TaskQueue("EncoderQueue"));
+        queues.push_back(owned_queues.back().get());
+      }
+    }
+
+    int64_t start_ms = rtc::TimeMillis();
+    for (int frame = 0; frame < kNumFrames; ++frame) {
+      int64_t capture_time_ms = start_ms + frame * kFrameIntervalMs;
+      int64_t now_ms = rtc::TimeMillis();
+      if (capture_time_ms > now_ms)
+        SleepMs(static_cast<int>(capture_time_ms - now_ms));
+      for (int i = 0; i < kNumStreams; ++i) {
+        BusyStream* stream = streams[i].get();
+        // Spread the key frames of the streams over the key frame interval.
+        bool key_frame =
+            (frame + i * kKeyFrameInterval / kNumStreams) %
+                kKeyFrameInterval ==
+            0;
+        int64_t encode_time_us =
+            key_frame ? kKeyFrameEncodeTimeUs : kEncodeTimeUs;
+        stream->OnFramePosted();
+        auto encode = [stream, capture_time_ms, encode_time_us] {
+          stream->Encode(capture_time_ms, encode_time_us);
+        };
+        if (use_pool) {
+          pool.PostTask(queues[i], stream, capture_time_ms, encode);
+        } else {
+          queues[i]->PostTask(encode);
+        }
+      }
+    }
+
+    std::vector<int64_t> latencies_ms;
+    int frames_dropped = 0;
+    for (int i = 0; i < kNumStreams; ++i) {
+      WaitUntilIdle(queues[i]);
+      if (use_pool)
+        pool.ReleaseQueue(queues[i]);
+      std::vector<int64_t> stream_latencies_ms = streams[i]->latencies_ms();
+      latencies_ms.insert(latencies_ms.end(), stream_latencies_ms.begin(),
+                          stream_latencies_ms.end());
+      frames_dropped += streams[i]->frames_dropped();
+    }
+    ASSERT_FALSE(latencies_ms.empty());
+    std::sort(latencies_ms.begin(), latencies_ms.end());
+    auto percentile = [&latencies_ms](int percent) {
+      return latencies_ms[(latencies_ms.size() - 1) * percent / 100];
+    };
+    LOG(LS_INFO) << (use_pool ? "Pool of queues" : "Queue per stream") << ": "
+                 << latencies_ms.size() << " frames encoded, "
+                 << frames_dropped << " dropped, latency p50 "
+                 << percentile(50) << " ms, p95 " << percentile(95)
+                 << " ms, p99 " << percentile(99) << " ms, max "
+                 << latencies_ms.back() << " ms.";
+  }
+}
+
+}  // namespace webrtc
@@ -31,7 +31,8 @@ class MockVideoStreamEncoder : public VideoStreamEncoder {
                                                                     nullptr),
                            nullptr,
                            nullptr,
-                           std::unique_ptr<OveruseFrameDetector>()) {}
+                           std::unique_ptr<OveruseFrameDetector>(),
+                           nullptr) {}
   ~MockVideoStreamEncoder() { Stop(); }
 
   MOCK_METHOD1(OnReceivedIntraFrameRequest, void(size_t));
@@ -0,0 +1,42 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/latency_percentiles.h"
+
+#include "rtc_base/logging.h"
+#include "system_wrappers/include/metrics.h"
+
+namespace webrtc {
+
+LatencyPercentiles GetLatencyPercentiles(
+    const rtc::HistogramPercentileCounter& counter) {
+  LatencyPercentiles percentiles;
+  percentiles.num_samples = counter.NumSamples();
+  if (percentiles.num_samples > 0) {
+    percentiles.p50_ms = *counter.GetPercentile(0.5f);
+    percentiles.p99_ms = *counter.GetPercentile(0.99f);
+    percentiles.max_ms = *counter.GetMax();
+  }
+  return percentiles;
+}
+
+void ReportLatencyPercentiles(const std::string& name,
+                              const rtc::HistogramPercentileCounter& counter) {
+  if (counter.NumSamples() < kMinRequiredLatencySamples)
+    return;
+  int p50_ms = *counter.GetPercentile(0.5f);
+  int p99_ms = *counter.GetPercentile(0.99f);
+  RTC_HISTOGRAM_COUNTS_SPARSE_10000(name + ".P50InMs", p50_ms);
+  RTC_HISTOGRAM_COUNTS_SPARSE_10000(name + ".P99InMs", p99_ms);
+  LOG(LS_INFO) << name << " p50: " << p50_ms << " ms, p99: " << p99_ms
+               << " ms";
+}
+
+}  // namespace webrtc
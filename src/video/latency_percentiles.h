@@ -0,0 +1,37 @@
+/*
+ *  Copyright (c) 2017 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VIDEO_LATENCY_PERCENTILES_H_
+#define VIDEO_LATENCY_PERCENTILES_H_
+
+#include <string>
+
+#include "common_types.h"  // NOLINT(build/include)
+#include "rtc_base/numerics/histogram_percentile_counter.h"
+
+namespace webrtc {
+
+// Latencies below this are counted in a flat array, longer ones in a map.
+constexpr uint32_t kLatencyLongTailMs = 500;
+// Minimum number of frames before latency percentiles are reported to UMA.
+constexpr size_t kMinRequiredLatencySamples = 200;
+
+// Returns the percentiles of the latencies in |counter| for the stats.
+LatencyPercentiles GetLatencyPercentiles(
+    const rtc::HistogramPercentileCounter& counter);
+
+// Reports the p50 and p99 latency in |counter| to the UMA histograms
+// |name|.P50InMs and |name|.P99InMs, if enough samples have been counted.
+void ReportLatencyPercentiles(const std::string& name,
+                              const rtc::HistogramPercentileCounter& counter);
+
+}  // namespace webrtc
+
+#endif  // VIDEO_LATENCY_PERCENTILES_H_
@@ -19,8 +19,10 @@
 #include "modules/video_coding/include/video_codec_interface.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/safe_conversions.h"
 #include "system_wrappers/include/clock.h"
 #include "system_wrappers/include/metrics.h"
+#include "video/latency_percentiles.h"
 
 namespace webrtc {
 namespace {
@@ -50,6 +52,10 @@ const int kMovingMaxWindowMs = 10000;
 // How large window we use to calculate the framerate/bitrate.
 const int kRateStatisticsWindowSizeMs = 1000;
 
+// Frames that are decoded but never rendered are forgotten after this many
+// newer frames have started decoding.
+const size_t kMaxPendingFrameTimes = 60;
+
 std::string UmaPrefixForContentType(VideoContentType content_type) {
   std::stringstream ss;
   ss << "WebRTC.Video";
@@ -105,6 +111,10 @@ ReceiveStatisticsProxy::ReceiveStatisticsProxy(
       first_report_block_time_ms_(-1),
       avg_rtt_ms_(0),
       last_content_type_(VideoContentType::UNSPECIFIED),
+      packet_receive_latency_(kLatencyLongTailMs),
+      jitter_buffer_latency_(kLatencyLongTailMs),
+      decode_latency_(kLatencyLongTailMs),
+      render_latency_(kLatencyLongTailMs),
       timing_frame_info_counter_(kMovingMaxWindowMs) {
   stats_.ssrc = config_.rtp.remote_ssrc;
   // TODO(brandtr): Replace |rtx_stats_| with a single instance of
@@ -206,6 +216,14 @@ void ReceiveStatisticsProxy::UpdateHistograms() {
   int delay_ms = delay_counter_.Avg(kMinRequiredSamples);
   if (delay_ms != -1)
     RTC_HISTOGRAM_COUNTS_10000("WebRTC.Video.OnewayDelayInMs", delay_ms);
+  std::string latency_prefix =
+      UmaPrefixForContentType(last_content_type_) + ".Latency.";
+  ReportLatencyPercentiles(latency_prefix + "PacketReceive",
+                           packet_receive_latency_);
+  ReportLatencyPercentiles(latency_prefix + "JitterBuffer",
+                           jitter_buffer_latency_);
+  ReportLatencyPercentiles(latency_prefix + "Decode", decode_latency_);
+  ReportLatencyPercentiles(latency_prefix + "Render", render_latency_);
 
   // Aggregate content_specific_stats_ by removing experiment or simulcast
   // information;
@@ -502,6 +520,11 @@ VideoReceiveStream::Stats ReceiveStatisticsProxy::GetStats() const {
       interframe_delay_max_moving_.Max(now_ms).value_or(-1);
   stats_.timing_frame_info = timing_frame_info_counter_.Max(now_ms);
   stats_.content_type = last_content_type_;
+  stats_.packet_receive_latency =
+      GetLatencyPercentiles(packet_receive_latency_);
+  stats_.jitter_buffer_latency = GetLatencyPercentiles(jitter_buffer_latency_);
+  stats_.decode_latency = GetLatencyPercentiles(decode_latency_);
+  stats_.render_latency = GetLatencyPercentiles(render_latency_);
   return stats_;
 }
 
@@ -547,6 +570,11 @@ void ReceiveStatisticsProxy::OnFrameBufferTimingsUpdated(
   delay_counter_.Add(target_delay_ms + avg_rtt_ms_ / 2);
 }
 
+void ReceiveStatisticsProxy::OnFramesBufferedUpdated(int frames_buffered) {
+  rtc::CritScope lock(&crit_);
+  stats_.frames_buffered = frames_buffered;
+}
+
 void ReceiveStatisticsProxy::OnTimingFrameInfoUpdated(
     const TimingFrameInfo& info) {
   int64_t now_ms = clock_->TimeInMilliseconds();
@@ -648,6 +676,43 @@ void ReceiveStatisticsProxy::OnDecodedFrame(rtc::Optional<uint8_t> qp,
   last_decoded_frame_time_ms_.emplace(now);
 }
 
+void ReceiveStatisticsProxy::OnFrameDecodeStart(
+    uint32_t rtp_timestamp,
+    int64_t first_packet_received_ms,
+    int64_t last_packet_received_ms) {
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  rtc::CritScope lock(&crit_);
+  if (first_packet_received_ms > 0 &&
+      last_packet_received_ms >= first_packet_received_ms &&
+      now_ms >= last_packet_received_ms) {
+    packet_receive_latency_.Add(rtc::dchecked_cast<uint32_t>(
+        last_packet_received_ms - first_packet_received_ms));
+    jitter_buffer_latency_.Add(
+        rtc::dchecked_cast<uint32_t>(now_ms - last_packet_received_ms));
+  }
+  if (pending_frame_times_.size() >= kMaxPendingFrameTimes)
+    pending_frame_times_.pop_front();
+  pending_frame_times_.push_back({rtp_timestamp, now_ms, -1});
+}
+
+void ReceiveStatisticsProxy::OnFrameDecodeFinish(uint32_t rtp_timestamp) {
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  rtc::CritScope lock(&crit_);
+  // Searched from the back, since the frame that was just decoded is almost
+  // always the most recent one.
+  for (auto it = pending_frame_times_.rbegin();
+       it != pending_frame_times_.rend(); ++it) {
+    if (it->rtp_timestamp == rtp_timestamp) {
+      if (it->decode_finish_ms == -1) {
+        it->decode_finish_ms = now_ms;
+        decode_latency_.Add(
+            rtc::dchecked_cast<uint32_t>(now_ms - it->decode_start_ms));
+      }
+      return;
+    }
+  }
+}
+
 void ReceiveStatisticsProxy::OnRenderedFrame(const VideoFrame& frame) {
   int width = frame.width();
   int height = frame.height();
@@ -672,6 +737,19 @@ void ReceiveStatisticsProxy::OnRenderedFrame(const VideoFrame& frame) {
       content_specific_stats->e2e_delay_counter.Add(delay_ms);
     }
   }
+
+  // Frames are rendered in decode order, so older pending entries belong to
+  // frames that were dropped before rendering.
+  for (auto it = pending_frame_times_.begin(); it != pending_frame_times_.end();
+       ++it) {
+    if (it->rtp_timestamp == frame.timestamp()) {
+      int64_t render_ms = static_cast<int64_t>(now) - it->decode_finish_ms;
+      if (it->decode_finish_ms != -1 && render_ms >= 0)
+        render_latency_.Add(rtc::dchecked_cast<uint32_t>(render_ms));
+      pending_frame_times_.erase(pending_frame_times_.begin(), it + 1);
+      break;
+    }
+  }
 }
 
 void ReceiveStatisticsProxy::OnSyncOffsetUpdated(int64_t sync_offset_ms,
@@ -11,6 +11,7 @@
 #ifndef VIDEO_RECEIVE_STATISTICS_PROXY_H_
 #define VIDEO_RECEIVE_STATISTICS_PROXY_H_
 
+#include <deque>
 #include <map>
 #include <string>
 
@@ -21,6 +22,7 @@
 #include "modules/video_coding/include/video_coding_defines.h"
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/moving_max_counter.h"
+#include "rtc_base/numerics/histogram_percentile_counter.h"
 #include "rtc_base/rate_statistics.h"
 #include "rtc_base/ratetracker.h"
 #include "rtc_base/thread_annotations.h"
@@ -49,6 +51,13 @@ class ReceiveStatisticsProxy : public VCMReceiveStatisticsCallback,
   VideoReceiveStream::Stats GetStats() const;
 
   void OnDecodedFrame(rtc::Optional<uint8_t> qp, VideoContentType content_type);
+  // Called right before and after a frame is decoded. Packet receive times are
+  // 0 if unknown. Together with OnRenderedFrame, these track how long each
+  // frame spends in the receive pipeline.
+  void OnFrameDecodeStart(uint32_t rtp_timestamp,
+                          int64_t first_packet_received_ms,
+                          int64_t last_packet_received_ms);
+  void OnFrameDecodeFinish(uint32_t rtp_timestamp);
   void OnSyncOffsetUpdated(int64_t sync_offset_ms, double estimated_freq_khz);
   void OnRenderedFrame(const VideoFrame& frame);
   void OnIncomingPayloadType(int payload_type);
@@ -76,6 +85,8 @@ class ReceiveStatisticsProxy : public VCMReceiveStatisticsCallback,
                                    int min_playout_delay_ms,
                                    int render_delay_ms) override;
 
+  void OnFramesBufferedUpdated(int frames_buffered) override;
+
   void OnTimingFrameInfoUpdated(const TimingFrameInfo& info) override;
 
   // Overrides RtcpStatisticsCallback.
@@ -126,6 +137,13 @@ class ReceiveStatisticsProxy : public VCMReceiveStatisticsCallback,
     FrameCounts frame_counts;
   };
 
+  // Timestamps of a frame that has started decoding but not yet been rendered.
+  struct PendingFrameTimes {
+    uint32_t rtp_timestamp;
+    int64_t decode_start_ms;
+    int64_t decode_finish_ms;
+  };
+
   void UpdateHistograms() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
   void QualitySample() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
@@ -178,6 +196,12 @@ class ReceiveStatisticsProxy : public VCMReceiveStatisticsCallback,
   mutable std::map<int64_t, size_t> frame_window_ RTC_GUARDED_BY(&crit_);
   VideoContentType last_content_type_ RTC_GUARDED_BY(&crit_);
   rtc::Optional<int64_t> last_decoded_frame_time_ms_ RTC_GUARDED_BY(&crit_);
+  std::deque<PendingFrameTimes> pending_frame_times_ RTC_GUARDED_BY(&crit_);
+  rtc::HistogramPercentileCounter packet_receive_latency_
+      RTC_GUARDED_BY(&crit_);
+  rtc::HistogramPercentileCounter jitter_buffer_latency_ RTC_GUARDED_BY(&crit_);
+  rtc::HistogramPercentileCounter decode_latency_ RTC_GUARDED_BY(&crit_);
+  rtc::HistogramPercentileCounter render_latency_ RTC_GUARDED_BY(&crit_);
   // Mutable because calling Max() on MovingMaxCounter is not const. Yet it is
   // called from const GetStats().
   mutable rtc::MovingMaxCounter<TimingFrameInfo> timing_frame_info_counter_
@@ -249,6 +249,89 @@ TEST_F(ReceiveStatisticsProxyTest, GetStatsReportsDecodeTimingStats) {
   EXPECT_EQ(kRenderDelayMs, stats.render_delay_ms);
 }
 
+TEST_F(ReceiveStatisticsProxyTest, GetStatsReportsFramesBuffered) {
+  EXPECT_EQ(0, statistics_proxy_->GetStats().frames_buffered);
+  statistics_proxy_->OnFramesBufferedUpdated(3);
+  EXPECT_EQ(3, statistics_proxy_->GetStats().frames_buffered);
+}
+
+TEST_F(ReceiveStatisticsProxyTest, GetStatsReportsPipelineLatencies) {
+  const int64_t kPacketReceiveMs = 3;
+  const int64_t kJitterBufferMs = 20;
+  const int64_t kDecodeMs = 5;
+  const int64_t kRenderMs = 10;
+  const uint32_t kRtpTimestamp = 90000;
+  VideoReceiveStream::Stats stats = statistics_proxy_->GetStats();
+  EXPECT_EQ(0u, stats.decode_latency.num_samples);
+  EXPECT_EQ(-1, stats.decode_latency.p50_ms);
+
+  int64_t first_packet_ms = fake_clock_.TimeInMilliseconds();
+  fake_clock_.AdvanceTimeMilliseconds(kPacketReceiveMs);
+  int64_t last_packet_ms = fake_clock_.TimeInMilliseconds();
+  fake_clock_.AdvanceTimeMilliseconds(kJitterBufferMs);
+  statistics_proxy_->OnFrameDecodeStart(kRtpTimestamp, first_packet_ms,
+                                        last_packet_ms);
+  fake_clock_.AdvanceTimeMilliseconds(kDecodeMs);
+  statistics_proxy_->OnFrameDecodeFinish(kRtpTimestamp);
+  fake_clock_.AdvanceTimeMilliseconds(kRenderMs);
+  VideoFrame frame = CreateFrame(640, 480);
+  frame.set_timestamp(kRtpTimestamp);
+  statistics_proxy_->OnRenderedFrame(frame);
+
+  stats = statistics_proxy_->GetStats();
+  EXPECT_EQ(1u, stats.packet_receive_latency.num_samples);
+  EXPECT_EQ(kPacketReceiveMs, stats.packet_receive_latency.p50_ms);
+  EXPECT_EQ(kJitterBufferMs, stats.jitter_buffer_latency.p99_ms);
+  EXPECT_EQ(kDecodeMs, stats.decode_latency.max_ms);
+  EXPECT_EQ(1u, stats.render_latency.num_samples);
+  EXPECT_EQ(kRenderMs, stats.render_latency.p50_ms);
+}
+
+TEST_F(ReceiveStatisticsProxyTest, DoesNotReportRenderLatencyForDroppedFrames) {
+  const uint32_t kRtpTimestamp = 90000;
+  statistics_proxy_->OnFrameDecodeStart(kRtpTimestamp, 0, 0);
+  statistics_proxy_->OnFrameDecodeFinish(kRtpTimestamp);
+  VideoFrame frame = CreateFrame(640, 480);
+  frame.set_timestamp(kRtpTimestamp + 3000);
+  statistics_proxy_->OnRenderedFrame(frame);
+
+  VideoReceiveStream::Stats stats = statistics_proxy_->GetStats();
+  // Unknown packet receive times are not counted.
+  EXPECT_EQ(0u, stats.packet_receive_latency.num_samples);
+  EXPECT_EQ(0u, stats.jitter_buffer_latency.num_samples);
+  EXPECT_EQ(1u, stats.decode_latency.num_samples);
+  EXPECT_EQ(0u, stats.render_latency.num_samples);
+}
+
+TEST_F(ReceiveStatisticsProxyTest, LatencyPercentilesAreReportedToUma) {
+  for (int i = 0; i < kMinRequiredSamples; ++i) {
+    uint32_t rtp_timestamp = 3000 * i;
+    statistics_proxy_->OnFrameDecodeStart(rtp_timestamp, 0, 0);
+    fake_clock_.AdvanceTimeMilliseconds(i < kMinRequiredSamples / 2 ? 4 : 8);
+    statistics_proxy_->OnFrameDecodeFinish(rtp_timestamp);
+  }
+  statistics_proxy_.reset();
+  EXPECT_EQ(1, metrics::NumSamples("WebRTC.Video.Latency.Decode.P50InMs"));
+  EXPECT_EQ(1, metrics::NumEvents("WebRTC.Video.Latency.Decode.P50InMs", 4));
+  EXPECT_EQ(1, metrics::NumEvents("WebRTC.Video.Latency.Decode.P99InMs", 8));
+  EXPECT_EQ(0, metrics::NumSamples("WebRTC.Video.Latency.Render.P50InMs"));
+}
+
+TEST_F(ReceiveStatisticsProxyTest, ScreenshareLatencyPercentilesAreReported) {
+  for (int i = 0; i < kMinRequiredSamples; ++i) {
+    uint32_t rtp_timestamp = 3000 * i;
+    statistics_proxy_->OnFrameDecodeStart(rtp_timestamp, 0, 0);
+    fake_clock_.AdvanceTimeMilliseconds(4);
+    statistics_proxy_->OnFrameDecodeFinish(rtp_timestamp);
+    statistics_proxy_->OnDecodedFrame(rtc::Optional<uint8_t>(),
+                                      VideoContentType::SCREENSHARE);
+  }
+  statistics_proxy_.reset();
+  EXPECT_EQ(0, metrics::NumSamples("WebRTC.Video.Latency.Decode.P50InMs"));
+  EXPECT_EQ(1, metrics::NumEvents(
+                   "WebRTC.Video.Screenshare.Latency.Decode.P50InMs", 4));
+}
+
 TEST_F(ReceiveStatisticsProxyTest, GetStatsReportsRtcpPacketTypeCounts) {
   const uint32_t kFirPackets = 33;
   const uint32_t kPliPackets = 44;
@@ -19,8 +19,10 @@
 #include "modules/video_coding/include/video_codec_interface.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/safe_conversions.h"
 #include "system_wrappers/include/field_trial.h"
 #include "system_wrappers/include/metrics.h"
+#include "video/latency_percentiles.h"
 
 namespace webrtc {
 namespace {
@@ -122,6 +124,8 @@ SendStatisticsProxy::SendStatisticsProxy(
       start_ms_(clock->TimeInMilliseconds()),
       last_sent_frame_timestamp_(0),
       encode_time_(kEncodeTimeWeigthFactor),
+      encode_queue_latency_(kLatencyLongTailMs),
+      encode_latency_(kLatencyLongTailMs),
       quality_downscales_(-1),
       cpu_downscales_(-1),
       uma_container_(
@@ -148,6 +152,8 @@ SendStatisticsProxy::UmaSamplesContainer::UmaSamplesContainer(
       clock_(clock),
       max_sent_width_per_timestamp_(0),
       max_sent_height_per_timestamp_(0),
+      encode_queue_latency_counter_(kLatencyLongTailMs),
+      encode_latency_counter_(kLatencyLongTailMs),
       input_frame_rate_tracker_(100, 10u),
       input_fps_counter_(clock, nullptr, true),
       sent_fps_counter_(clock, nullptr, true),
@@ -253,6 +259,10 @@ void SendStatisticsProxy::UmaSamplesContainer::UpdateHistograms(
                                encode_ms);
     LOG(LS_INFO) << uma_prefix_ << "EncodeTimeInMs " << encode_ms;
   }
+  ReportLatencyPercentiles(uma_prefix_ + "Latency.EncodeQueue",
+                           encode_queue_latency_counter_);
+  ReportLatencyPercentiles(uma_prefix_ + "Latency.Encode",
+                           encode_latency_counter_);
   int key_frames_permille =
       key_frame_counter_.Permille(kMinRequiredMetricsSamples);
   if (key_frames_permille != -1) {
@@ -596,6 +606,8 @@ VideoSendStream::Stats SendStatisticsProxy::GetStats() {
       content_type_ == VideoEncoderConfig::ContentType::kRealtimeVideo
           ? VideoContentType::UNSPECIFIED
           : VideoContentType::SCREENSHARE;
+  stats_.encode_queue_latency = GetLatencyPercentiles(encode_queue_latency_);
+  stats_.encode_latency = GetLatencyPercentiles(encode_latency_);
   return stats_;
 }
 
@@ -758,6 +770,23 @@ void SendStatisticsProxy::OnSendEncodedImage(
   stats->height = encoded_image._encodedHeight;
   update_times_[ssrc].resolution_update_ms = clock_->TimeInMilliseconds();
 
+  // Encode times are only set when the encoder is fed by VideoStreamEncoder,
+  // i.e. not for encoders with internal sources.
+  if (encoded_image.timing_.encode_start_ms > 0 &&
+      encoded_image.timing_.encode_start_ms >= encoded_image.capture_time_ms_ &&
+      encoded_image.timing_.encode_finish_ms >=
+          encoded_image.timing_.encode_start_ms) {
+    uint32_t queue_ms = rtc::dchecked_cast<uint32_t>(
+        encoded_image.timing_.encode_start_ms - encoded_image.capture_time_ms_);
+    uint32_t encode_ms =
+        rtc::dchecked_cast<uint32_t>(encoded_image.timing_.encode_finish_ms -
+                                     encoded_image.timing_.encode_start_ms);
+    encode_queue_latency_.Add(queue_ms);
+    encode_latency_.Add(encode_ms);
+    uma_container_->encode_queue_latency_counter_.Add(queue_ms);
+    uma_container_->encode_latency_counter_.Add(encode_ms);
+  }
+
   uma_container_->key_frame_counter_.Add(encoded_image._frameType ==
                                          kVideoFrameKey);
   stats_.bw_limited_resolution =
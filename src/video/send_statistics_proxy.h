@@ -21,6 +21,7 @@
 #include "modules/video_coding/include/video_coding_defines.h"
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/numerics/exp_filter.h"
+#include "rtc_base/numerics/histogram_percentile_counter.h"
 #include "rtc_base/ratetracker.h"
 #include "rtc_base/thread_annotations.h"
 #include "system_wrappers/include/clock.h"
@@ -195,6 +196,10 @@ class SendStatisticsProxy : public CpuOveruseMetricsObserver,
   uint32_t last_sent_frame_timestamp_ RTC_GUARDED_BY(crit_);
   std::map<uint32_t, StatsUpdateTimes> update_times_ RTC_GUARDED_BY(crit_);
   rtc::ExpFilter encode_time_ RTC_GUARDED_BY(crit_);
+  // Time from capture until the encoder picks up the frame, and time spent
+  // in the encoder, over the lifetime of the stream.
+  rtc::HistogramPercentileCounter encode_queue_latency_ RTC_GUARDED_BY(crit_);
+  rtc::HistogramPercentileCounter encode_latency_ RTC_GUARDED_BY(crit_);
   int quality_downscales_ RTC_GUARDED_BY(crit_);
   int cpu_downscales_ RTC_GUARDED_BY(crit_);
 
@@ -221,6 +226,8 @@ class SendStatisticsProxy : public CpuOveruseMetricsObserver,
     SampleCounter sent_width_counter_;
     SampleCounter sent_height_counter_;
     SampleCounter encode_time_counter_;
+    rtc::HistogramPercentileCounter encode_queue_latency_counter_;
+    rtc::HistogramPercentileCounter encode_latency_counter_;
     BoolSampleCounter key_frame_counter_;
     BoolSampleCounter quality_limited_frame_counter_;
     SampleCounter quality_downscales_counter_;
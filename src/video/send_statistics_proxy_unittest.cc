@@ -374,6 +374,44 @@ TEST_F(SendStatisticsProxyTest, OnSendEncodedImageWithoutQpQpSumWontExist) {
   EXPECT_EQ(rtc::Optional<uint64_t>(), statistics_proxy_->GetStats().qp_sum);
 }
 
+TEST_F(SendStatisticsProxyTest, OnSendEncodedImageReportsEncodeLatencies) {
+  const int64_t kCaptureTimeMs = 1000;
+  EncodedImage encoded_image;
+  CodecSpecificInfo codec_info;
+  encoded_image.capture_time_ms_ = kCaptureTimeMs;
+  // Frames without encode times, e.g. from encoders with internal sources,
+  // are not counted.
+  statistics_proxy_->OnSendEncodedImage(encoded_image, &codec_info);
+  EXPECT_EQ(0u, statistics_proxy_->GetStats().encode_latency.num_samples);
+
+  encoded_image.SetEncodeTime(kCaptureTimeMs + 15, kCaptureTimeMs + 25);
+  statistics_proxy_->OnSendEncodedImage(encoded_image, &codec_info);
+  VideoSendStream::Stats stats = statistics_proxy_->GetStats();
+  EXPECT_EQ(1u, stats.encode_queue_latency.num_samples);
+  EXPECT_EQ(15, stats.encode_queue_latency.p50_ms);
+  EXPECT_EQ(15, stats.encode_queue_latency.max_ms);
+  EXPECT_EQ(1u, stats.encode_latency.num_samples);
+  EXPECT_EQ(10, stats.encode_latency.p99_ms);
+}
+
+TEST_F(SendStatisticsProxyTest, EncodeLatencyPercentilesAreReportedToUma) {
+  EncodedImage encoded_image;
+  CodecSpecificInfo codec_info;
+  const int kNumFrames = 200;
+  for (int i = 0; i < kNumFrames; ++i) {
+    encoded_image.capture_time_ms_ = 1000 + i * 33;
+    int64_t encode_start_ms = encoded_image.capture_time_ms_ + 2;
+    int64_t encode_ms = i < kNumFrames / 2 ? 5 : 30;
+    encoded_image.SetEncodeTime(encode_start_ms, encode_start_ms + encode_ms);
+    statistics_proxy_->OnSendEncodedImage(encoded_image, &codec_info);
+  }
+  statistics_proxy_.reset();
+  EXPECT_EQ(1,
+            metrics::NumEvents("WebRTC.Video.Latency.EncodeQueue.P50InMs", 2));
+  EXPECT_EQ(1, metrics::NumEvents("WebRTC.Video.Latency.Encode.P50InMs", 5));
+  EXPECT_EQ(1, metrics::NumEvents("WebRTC.Video.Latency.Encode.P99InMs", 30));
+}
+
 TEST_F(SendStatisticsProxyTest, GetCpuAdaptationStats) {
   VideoStreamEncoder::AdaptCounts cpu_counts;
   VideoStreamEncoder::AdaptCounts quality_counts;
@@ -12,6 +12,7 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
 #include <set>
 #include <string>
 #include <utility>
@@ -43,6 +44,9 @@
 namespace webrtc {
 
 namespace {
+constexpr int kMaxWaitForFrameMs = 3000;
+constexpr int kMaxWaitForKeyFrameMs = 200;
+
 VideoCodec CreateDecoderVideoCodec(const VideoReceiveStream::Decoder& decoder) {
   VideoCodec codec;
   memset(&codec, 0, sizeof(codec));
@@ -79,12 +83,14 @@ VideoReceiveStream::VideoReceiveStream(
     PacketRouter* packet_router,
     VideoReceiveStream::Config config,
     ProcessThread* process_thread,
-    CallStats* call_stats)
+    CallStats* call_stats,
+    DecodeScheduler* decode_scheduler)
     : transport_adapter_(config.rtcp_send_transport),
       config_(std::move(config)),
       num_cpu_cores_(num_cpu_cores),
       process_thread_(process_thread),
       clock_(Clock::GetRealTimeClock()),
+      decode_scheduler_(decode_scheduler),
       decode_thread_(&DecodeThreadFunction,
                      this,
                      "DecodingThread",
@@ -168,7 +174,7 @@ void VideoReceiveStream::SetSync(Syncable* audio_syncable) {
 
 void VideoReceiveStream::Start() {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&worker_sequence_checker_);
-  if (decode_thread_.IsRunning())
+  if (decoding_)
     return;
 
   bool protected_by_fec = config_.rtp.protected_by_flexfec ||
@@ -195,6 +201,15 @@ void VideoReceiveStream::Start() {
   }
   RTC_DCHECK(renderer != nullptr);
 
+  // On the decode scheduler, the threads of the pool already keep the cores
+  // busy with the other streams, so each decoder gets its share of the cores.
+  // This caps the threads a decoder starts of its own, e.g. FFmpeg's slice
+  // threads.
+  int decoder_num_cores = num_cpu_cores_;
+  if (decode_scheduler_) {
+    decoder_num_cores =
+        std::max(1, num_cpu_cores_ / decode_scheduler_->num_threads());
+  }
   for (const Decoder& decoder : config_.decoders) {
     video_receiver_.RegisterExternalDecoder(decoder.decoder,
                                             decoder.payload_type);
@@ -202,7 +217,7 @@ void VideoReceiveStream::Start() {
     RTC_CHECK(rtp_video_stream_receiver_.AddReceiveCodec(codec,
                                                          decoder.codec_params));
     RTC_CHECK_EQ(VCM_OK, video_receiver_.RegisterReceiveCodec(
-                             &codec, num_cpu_cores_, false));
+                             &codec, decoder_num_cores, false));
   }
 
   video_stream_decoder_.reset(new VideoStreamDecoder(
@@ -215,8 +230,14 @@ void VideoReceiveStream::Start() {
 
   process_thread_->RegisterModule(&video_receiver_, RTC_FROM_HERE);
 
-  // Start the decode thread
-  decode_thread_.Start();
+  // Start decoding, on the decode scheduler if there is one.
+  if (decode_scheduler_) {
+    decode_deadline_ms_.reset();
+    decode_scheduler_->AddStream(this);
+  } else {
+    decode_thread_.Start();
+  }
+  decoding_ = true;
   rtp_video_stream_receiver_.StartReceive();
 }
 
@@ -228,13 +249,19 @@ void VideoReceiveStream::Stop() {
   call_stats_->DeregisterStatsObserver(&rtp_video_stream_receiver_);
   process_thread_->DeRegisterModule(&video_receiver_);
 
-  if (decode_thread_.IsRunning()) {
+  if (decoding_) {
     // TriggerDecoderShutdown will release any waiting decoder thread and make
     // it stop immediately, instead of waiting for a timeout. Needs to be called
     // before joining the decoder thread.
     video_receiver_.TriggerDecoderShutdown();
 
-    decode_thread_.Stop();
+    if (decode_scheduler_) {
+      decode_scheduler_->RemoveStream(this);
+      video_receiver_.DecodingStopped();
+    } else {
+      decode_thread_.Stop();
+    }
+    decoding_ = false;
     // Deregister external decoders so they are no longer running during
     // destruction. This effectively stops the VCM since the decoder thread is
     // stopped, the VCM is deregistered and no asynchronous decoder threads are
@@ -343,8 +370,12 @@ void VideoReceiveStream::RequestKeyFrame() {
 void VideoReceiveStream::OnCompleteFrame(
     std::unique_ptr<video_coding::FrameObject> frame) {
   int last_continuous_pid = frame_buffer_->InsertFrame(std::move(frame));
-  if (last_continuous_pid != -1)
+  if (last_continuous_pid != -1) {
     rtp_video_stream_receiver_.FrameContinuous(last_continuous_pid);
+    // There might be a new frame to decode.
+    if (decode_scheduler_)
+      decode_scheduler_->Wake(this);
+  }
 }
 
 int VideoReceiveStream::id() const {
@@ -394,9 +425,6 @@ void VideoReceiveStream::DecodeThreadFunction(void* ptr) {
 
 bool VideoReceiveStream::Decode() {
   TRACE_EVENT0("webrtc", "VideoReceiveStream::Decode");
-  static const int kMaxWaitForFrameMs = 3000;
-  static const int kMaxWaitForKeyFrameMs = 200;
-
   int wait_ms = keyframe_required_ ? kMaxWaitForKeyFrameMs : kMaxWaitForFrameMs;
   std::unique_ptr<video_coding::FrameObject> frame;
   // TODO(philipel): Call NextFrame with |keyframe_required| argument when
@@ -411,43 +439,92 @@ bool VideoReceiveStream::Decode() {
 
   if (frame) {
     RTC_DCHECK_EQ(res, video_coding::FrameBuffer::ReturnReason::kFrameFound);
-    if (video_receiver_.Decode(frame.get()) == VCM_OK) {
-      keyframe_required_ = false;
-      frame_decoded_ = true;
-      rtp_video_stream_receiver_.FrameDecoded(frame->picture_id);
-    } else if (!keyframe_required_ || !frame_decoded_) {
-      keyframe_required_ = true;
-      // TODO(philipel): Remove this keyframe request when downstream project
-      //                 has been fixed.
-      RequestKeyFrame();
-    }
+    DecodeFrame(frame.get());
   } else {
     RTC_DCHECK_EQ(res, video_coding::FrameBuffer::ReturnReason::kTimeout);
-    int64_t now_ms = clock_->TimeInMilliseconds();
-    rtc::Optional<int64_t> last_packet_ms =
-        rtp_video_stream_receiver_.LastReceivedPacketMs();
-    rtc::Optional<int64_t> last_keyframe_packet_ms =
-        rtp_video_stream_receiver_.LastReceivedKeyframePacketMs();
-
-    // To avoid spamming keyframe requests for a stream that is not active we
-    // check if we have received a packet within the last 5 seconds.
-    bool stream_is_active = last_packet_ms && now_ms - *last_packet_ms < 5000;
-    if (!stream_is_active)
-      stats_proxy_.OnStreamInactive();
-
-    // If we recently have been receiving packets belonging to a keyframe then
-    // we assume a keyframe is currently being received.
-    bool receiving_keyframe =
-        last_keyframe_packet_ms &&
-        now_ms - *last_keyframe_packet_ms < kMaxWaitForKeyFrameMs;
-
-    if (stream_is_active && !receiving_keyframe) {
-      LOG(LS_WARNING) << "No decodable frame in " << wait_ms
-                      << " ms, requesting keyframe.";
-      RequestKeyFrame();
-    }
+    HandleNoDecodableFrame(wait_ms);
   }
   return true;
 }
+
+int64_t VideoReceiveStream::DecodeFrames() {
+  TRACE_EVENT0("webrtc", "VideoReceiveStream::DecodeFrames");
+  int wait_ms = keyframe_required_ ? kMaxWaitForKeyFrameMs : kMaxWaitForFrameMs;
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  if (!decode_deadline_ms_)
+    decode_deadline_ms_.emplace(now_ms + wait_ms);
+
+  std::unique_ptr<video_coding::FrameObject> frame;
+  int64_t frame_wait_ms = -1;
+  video_coding::FrameBuffer::ReturnReason res =
+      frame_buffer_->PollNextFrame(&frame, &frame_wait_ms);
+  if (res == video_coding::FrameBuffer::ReturnReason::kTimeout &&
+      now_ms >= *decode_deadline_ms_) {
+    // Like NextFrame() does when it times out, hand off the next frame even if
+    // it is not due yet.
+    res = frame_buffer_->NextFrame(0, &frame);
+  }
+
+  if (res == video_coding::FrameBuffer::ReturnReason::kStopped)
+    return -1;
+
+  if (frame) {
+    decode_deadline_ms_.reset();
+    DecodeFrame(frame.get());
+    // Decode any further frames that are due once other streams have had
+    // their turn.
+    return 0;
+  }
+
+  if (now_ms >= *decode_deadline_ms_) {
+    HandleNoDecodableFrame(wait_ms);
+    decode_deadline_ms_.emplace(now_ms + wait_ms);
+  }
+  int64_t deadline_wait_ms = *decode_deadline_ms_ - now_ms;
+  return frame_wait_ms == -1 ? deadline_wait_ms
+                             : std::min(frame_wait_ms, deadline_wait_ms);
+}
+
+void VideoReceiveStream::DecodeFrame(video_coding::FrameObject* frame) {
+  stats_proxy_.OnFrameDecodeStart(frame->timestamp,
+                                  frame->video_timing().receive_start_ms,
+                                  frame->video_timing().receive_finish_ms);
+  if (video_receiver_.Decode(frame) == VCM_OK) {
+    keyframe_required_ = false;
+    frame_decoded_ = true;
+    rtp_video_stream_receiver_.FrameDecoded(frame->picture_id);
+  } else if (!keyframe_required_ || !frame_decoded_) {
+    keyframe_required_ = true;
+    // TODO(philipel): Remove this keyframe request when downstream project
+    //                 has been fixed.
+    RequestKeyFrame();
+  }
+}
+
+void VideoReceiveStream::HandleNoDecodableFrame(int wait_ms) {
+  int64_t now_ms = clock_->TimeInMilliseconds();
+  rtc::Optional<int64_t> last_packet_ms =
+      rtp_video_stream_receiver_.LastReceivedPacketMs();
+  rtc::Optional<int64_t> last_keyframe_packet_ms =
+      rtp_video_stream_receiver_.LastReceivedKeyframePacketMs();
+
+  // To avoid spamming keyframe requests for a stream that is not active we
+  // check if we have received a packet within the last 5 seconds.
+  bool stream_is_active = last_packet_ms && now_ms - *last_packet_ms < 5000;
+  if (!stream_is_active)
+    stats_proxy_.OnStreamInactive();
+
+  // If we recently have been receiving packets belonging to a keyframe then
+  // we assume a keyframe is currently being received.
+  bool receiving_keyframe =
+      last_keyframe_packet_ms &&
+      now_ms - *last_keyframe_packet_ms < kMaxWaitForKeyFrameMs;
+
+  if (stream_is_active && !receiving_keyframe) {
+    LOG(LS_WARNING) << "No decodable frame in " << wait_ms
+                    << " ms, requesting keyframe.";
+    RequestKeyFrame();
+  }
+}
 }  // namespace internal
 }  // namespace webrtc
@@ -24,6 +24,7 @@
 #include "modules/video_coding/video_coding_impl.h"
 #include "rtc_base/sequenced_task_checker.h"
 #include "system_wrappers/include/clock.h"
+#include "video/decode_scheduler.h"
 #include "video/receive_statistics_proxy.h"
 #include "video/rtp_streams_synchronizer.h"
 #include "video/rtp_video_stream_receiver.h"
@@ -50,14 +51,16 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
                            public NackSender,
                            public KeyFrameRequestSender,
                            public video_coding::OnCompleteFrameCallback,
-                           public Syncable {
+                           public Syncable,
+                           public DecodeScheduler::Stream {
  public:
   VideoReceiveStream(RtpStreamReceiverControllerInterface* receiver_controller,
                      int num_cpu_cores,
                      PacketRouter* packet_router,
                      VideoReceiveStream::Config config,
                      ProcessThread* process_thread,
-                     CallStats* call_stats);
+                     CallStats* call_stats,
+                     DecodeScheduler* decode_scheduler);
   ~VideoReceiveStream() override;
 
   const Config& config() const { return config_; }
@@ -109,9 +112,14 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
   uint32_t GetPlayoutTimestamp() const override;
   void SetMinimumPlayoutDelay(int delay_ms) override;
 
+  // Implements DecodeScheduler::Stream.
+  int64_t DecodeFrames() override;
+
  private:
   static void DecodeThreadFunction(void* ptr);
   bool Decode();
+  void DecodeFrame(video_coding::FrameObject* frame);
+  void HandleNoDecodableFrame(int wait_ms);
 
   rtc::SequencedTaskChecker worker_sequence_checker_;
   rtc::SequencedTaskChecker module_process_sequence_checker_;
@@ -122,7 +130,10 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
   ProcessThread* const process_thread_;
   Clock* const clock_;
 
+  // Decodes on |decode_scheduler_| if set, otherwise on |decode_thread_|.
+  DecodeScheduler* const decode_scheduler_;
   rtc::PlatformThread decode_thread_;
+  bool decoding_ = false;
 
   CallStats* const call_stats_;
 
@@ -155,6 +166,10 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
 
   // If we have successfully decoded any frame.
   bool frame_decoded_ = false;
+
+  // When decoding on |decode_scheduler_|, the time at which to stop waiting for
+  // a decodable frame, like Decode() does.
+  rtc::Optional<int64_t> decode_deadline_ms_;
 };
 }  // namespace internal
 }  // namespace webrtc
@@ -24,15 +24,20 @@
 #include "system_wrappers/include/clock.h"
 #include "test/field_trial.h"
 #include "video/call_stats.h"
+#include "video/decode_scheduler.h"
 #include "video/video_receive_stream.h"
 
 namespace webrtc {
 namespace {
 
 using testing::_;
+using testing::DoAll;
 using testing::Invoke;
+using testing::InvokeWithoutArgs;
+using testing::Return;
 
 constexpr int kDefaultTimeOutMs = 50;
+constexpr int kDefaultNumCpuCores = 2;
 
 const char kNewJitterBufferFieldTrialEnabled[] =
     "WebRTC-NewVideoJitterBuffer/Enabled/";
@@ -73,7 +78,6 @@ class VideoReceiveStreamTest : public testing::Test {
         process_thread_(ProcessThread::Create("TestThread")) {}
 
   void SetUp() {
-    constexpr int kDefaultNumCpuCores = 2;
     config_.rtp.remote_ssrc = 1111;
     config_.rtp.local_ssrc = 2222;
     config_.renderer = &fake_renderer_;
@@ -92,7 +96,8 @@ class VideoReceiveStreamTest : public testing::Test {
 
     video_receive_stream_.reset(new webrtc::internal::VideoReceiveStream(
         &rtp_stream_receiver_controller_, kDefaultNumCpuCores,
-        &packet_router_, config_.Copy(), process_thread_.get(), &call_stats_));
+        &packet_router_, config_.Copy(), process_thread_.get(), &call_stats_,
+        nullptr));
   }
 
  protected:
@@ -137,4 +142,38 @@ TEST_F(VideoReceiveStreamTest, CreateFrameFromH264FmtpSpropAndIdr) {
   init_decode_event_.Wait(kDefaultTimeOutMs);
 }
 
+TEST_F(VideoReceiveStreamTest, DecodesOnDecodeScheduler) {
+  DecodeScheduler decode_scheduler(kDefaultNumCpuCores);
+  video_receive_stream_.reset();
+  video_receive_stream_.reset(new webrtc::internal::VideoReceiveStream(
+      &rtp_stream_receiver_controller_, kDefaultNumCpuCores, &packet_router_,
+      config_.Copy(), process_thread_.get(), &call_stats_, &decode_scheduler));
+
+  constexpr uint8_t idr_nalu[] = {0x05, 0xFF, 0xFF, 0xFF};
+  RtpPacketToSend rtppacket(nullptr);
+  uint8_t* payload = rtppacket.AllocatePayload(sizeof(idr_nalu));
+  memcpy(payload, idr_nalu, sizeof(idr_nalu));
+  rtppacket.SetMarker(true);
+  rtppacket.SetSsrc(1111);
+  rtppacket.SetPayloadType(99);
+  rtppacket.SetSequenceNumber(1);
+  rtppacket.SetTimestamp(0);
+  rtc::Event decode_event(false, false);
+  // The decoder gets its share of the cores, with the other threads of the
+  // scheduler decoding other streams.
+  EXPECT_CALL(mock_h264_video_decoder_, InitDecode(_, 1));
+  EXPECT_CALL(mock_h264_video_decoder_, RegisterDecodeCompleteCallback(_));
+  video_receive_stream_->Start();
+  EXPECT_CALL(mock_h264_video_decoder_, Decode(_, false, _, _, _))
+      .WillOnce(DoAll(
+          InvokeWithoutArgs([&decode_event] { decode_event.Set(); }),
+          Return(0)));
+  RtpPacketReceived parsed_packet;
+  ASSERT_TRUE(parsed_packet.Parse(rtppacket.data(), rtppacket.size()));
+  rtp_stream_receiver_controller_.OnRtpPacket(parsed_packet);
+  EXPECT_CALL(mock_h264_video_decoder_, Release());
+  EXPECT_TRUE(decode_event.Wait(1000));
+  video_receive_stream_.reset();
+}
+
 }  // namespace webrtc
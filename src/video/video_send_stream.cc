@@ -218,6 +218,7 @@ class VideoSendStreamImpl : public webrtc::BitrateAllocatorObserver,
                       RtcEventLog* event_log,
                       const VideoSendStream::Config* config,
                       int initial_encoder_max_bitrate,
+                      double initial_encoder_bitrate_priority,
                       std::map<uint32_t, RtpState> suspended_ssrcs,
                       VideoEncoderConfig::ContentType content_type);
   ~VideoSendStreamImpl() override;
@@ -310,6 +311,7 @@ class VideoSendStreamImpl : public webrtc::BitrateAllocatorObserver,
   int encoder_min_bitrate_bps_;
   uint32_t encoder_max_bitrate_bps_;
   uint32_t encoder_target_rate_bps_;
+  double encoder_bitrate_priority_;
 
   VideoStreamEncoder* const video_stream_encoder_;
   EncoderRtcpFeedback encoder_feedback_;
@@ -350,6 +352,7 @@ class VideoSendStream::ConstructionTask : public rtc::QueuedTask {
                    RtcEventLog* event_log,
                    const VideoSendStream::Config* config,
                    int initial_encoder_max_bitrate,
+                   double initial_encoder_bitrate_priority,
                    const std::map<uint32_t, RtpState>& suspended_ssrcs,
                    VideoEncoderConfig::ContentType content_type)
       : send_stream_(send_stream),
@@ -363,6 +366,7 @@ class VideoSendStream::ConstructionTask : public rtc::QueuedTask {
         event_log_(event_log),
         config_(config),
         initial_encoder_max_bitrate_(initial_encoder_max_bitrate),
+        initial_encoder_bitrate_priority_(initial_encoder_bitrate_priority),
         suspended_ssrcs_(suspended_ssrcs),
         content_type_(content_type) {}
 
@@ -374,7 +378,8 @@ class VideoSendStream::ConstructionTask : public rtc::QueuedTask {
         stats_proxy_, rtc::TaskQueue::Current(), call_stats_, transport_,
         bitrate_allocator_, send_delay_stats_, video_stream_encoder_,
         event_log_, config_, initial_encoder_max_bitrate_,
-        std::move(suspended_ssrcs_), content_type_));
+        initial_encoder_bitrate_priority_, std::move(suspended_ssrcs_),
+        content_type_));
     return true;
   }
 
@@ -389,6 +394,7 @@ class VideoSendStream::ConstructionTask : public rtc::QueuedTask {
   RtcEventLog* const event_log_;
   const VideoSendStream::Config* config_;
   int initial_encoder_max_bitrate_;
+  double initial_encoder_bitrate_priority_;
   std::map<uint32_t, RtpState> suspended_ssrcs_;
   const VideoEncoderConfig::ContentType content_type_;
 };
@@ -503,7 +509,8 @@ VideoSendStream::VideoSendStream(
     RtcEventLog* event_log,
     VideoSendStream::Config config,
     VideoEncoderConfig encoder_config,
-    const std::map<uint32_t, RtpState>& suspended_ssrcs)
+    const std::map<uint32_t, RtpState>& suspended_ssrcs,
+    EncoderQueuePool* encoder_queue_pool)
     : worker_queue_(worker_queue),
       thread_sync_event_(false /* manual_reset */, false),
       stats_proxy_(Clock::GetRealTimeClock(),
@@ -516,13 +523,14 @@ VideoSendStream::VideoSendStream(
                              config_.encoder_settings,
                              config_.pre_encode_callback,
                              config_.post_encode_callback,
-                             std::unique_ptr<OveruseFrameDetector>()));
+                             std::unique_ptr<OveruseFrameDetector>(),
+                             encoder_queue_pool));
   worker_queue_->PostTask(std::unique_ptr<rtc::QueuedTask>(new ConstructionTask(
       &send_stream_, &thread_sync_event_, &stats_proxy_,
       video_stream_encoder_.get(), module_process_thread, call_stats, transport,
       bitrate_allocator, send_delay_stats, event_log, &config_,
-      encoder_config.max_bitrate_bps, suspended_ssrcs,
-      encoder_config.content_type)));
+      encoder_config.max_bitrate_bps, encoder_config.bitrate_priority,
+      suspended_ssrcs, encoder_config.content_type)));
 
   // Wait for ConstructionTask to complete so that |send_stream_| can be used.
   // |module_process_thread| must be registered and deregistered on the thread
@@ -641,6 +649,7 @@ VideoSendStreamImpl::VideoSendStreamImpl(
     RtcEventLog* event_log,
     const VideoSendStream::Config* config,
     int initial_encoder_max_bitrate,
+    double initial_encoder_bitrate_priority,
     std::map<uint32_t, RtpState> suspended_ssrcs,
     VideoEncoderConfig::ContentType content_type)
     : send_side_bwe_with_overhead_(
@@ -659,6 +668,7 @@ VideoSendStreamImpl::VideoSendStreamImpl(
       encoder_min_bitrate_bps_(0),
       encoder_max_bitrate_bps_(initial_encoder_max_bitrate),
       encoder_target_rate_bps_(0),
+      encoder_bitrate_priority_(initial_encoder_bitrate_priority),
       video_stream_encoder_(video_stream_encoder),
       encoder_feedback_(Clock::GetRealTimeClock(),
                         config_->rtp.ssrcs,
@@ -824,7 +834,8 @@ void VideoSendStreamImpl::Start() {
 
   bitrate_allocator_->AddObserver(
       this, encoder_min_bitrate_bps_, encoder_max_bitrate_bps_,
-      max_padding_bitrate_, !config_->suspend_below_min_bitrate);
+      max_padding_bitrate_, !config_->suspend_below_min_bitrate,
+      encoder_bitrate_priority_);
 
   // Start monitoring encoder activity.
   {
@@ -877,7 +888,8 @@ void VideoSendStreamImpl::SignalEncoderActive() {
   LOG(LS_INFO) << "SignalEncoderActive, Encoder is active.";
   bitrate_allocator_->AddObserver(
       this, encoder_min_bitrate_bps_, encoder_max_bitrate_bps_,
-      max_padding_bitrate_, !config_->suspend_below_min_bitrate);
+      max_padding_bitrate_, !config_->suspend_below_min_bitrate,
+      encoder_bitrate_priority_);
 }
 
 void VideoSendStreamImpl::OnEncoderConfigurationChanged(
@@ -902,6 +914,8 @@ void VideoSendStreamImpl::OnEncoderConfigurationChanged(
     encoder_max_bitrate_bps_ += stream.max_bitrate_bps;
   max_padding_bitrate_ = CalculateMaxPadBitrateBps(
       streams, min_transmit_bitrate_bps, config_->suspend_below_min_bitrate);
+  if (streams[0].bitrate_priority)
+    encoder_bitrate_priority_ = *streams[0].bitrate_priority;
 
   // Clear stats for disabled layers.
   for (size_t i = streams.size(); i < config_->rtp.ssrcs.size(); ++i) {
@@ -919,7 +933,8 @@ void VideoSendStreamImpl::OnEncoderConfigurationChanged(
     // limits.
     bitrate_allocator_->AddObserver(
         this, encoder_min_bitrate_bps_, encoder_max_bitrate_bps_,
-        max_padding_bitrate_, !config_->suspend_below_min_bitrate);
+        max_padding_bitrate_, !config_->suspend_below_min_bitrate,
+        encoder_bitrate_priority_);
   }
 }
 
@@ -58,7 +58,8 @@ class VideoSendStream : public webrtc::VideoSendStream {
                   RtcEventLog* event_log,
                   VideoSendStream::Config config,
                   VideoEncoderConfig encoder_config,
-                  const std::map<uint32_t, RtpState>& suspended_ssrcs);
+                  const std::map<uint32_t, RtpState>& suspended_ssrcs,
+                  EncoderQueuePool* encoder_queue_pool);
 
   ~VideoSendStream() override;
 
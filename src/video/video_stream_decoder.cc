@@ -78,6 +78,7 @@ VideoStreamDecoder::~VideoStreamDecoder() {
 int32_t VideoStreamDecoder::FrameToRender(VideoFrame& video_frame,
                                           rtc::Optional<uint8_t> qp,
                                           VideoContentType content_type) {
+  receive_stats_callback_->OnFrameDecodeFinish(video_frame.timestamp());
   receive_stats_callback_->OnDecodedFrame(qp, content_type);
   incoming_video_stream_->OnFrame(video_frame);
   return 0;
@@ -119,6 +120,8 @@ void VideoStreamDecoder::OnFrameBufferTimingsUpdated(int decode_ms,
                                                      int min_playout_delay_ms,
                                                      int render_delay_ms) {}
 
+void VideoStreamDecoder::OnFramesBufferedUpdated(int frames_buffered) {}
+
 void VideoStreamDecoder::OnTimingFrameInfoUpdated(const TimingFrameInfo& info) {
 }
 
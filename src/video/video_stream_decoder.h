@@ -80,6 +80,8 @@ class VideoStreamDecoder : public VCMReceiveCallback,
                                    int min_playout_delay_ms,
                                    int render_delay_ms) override;
 
+  void OnFramesBufferedUpdated(int frames_buffered) override;
+
   void OnTimingFrameInfoUpdated(const TimingFrameInfo& info) override;
 
   void RegisterReceiveStatisticsProxy(
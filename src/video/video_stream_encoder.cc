@@ -29,6 +29,7 @@
 #include "rtc_base/logging.h"
 #include "rtc_base/timeutils.h"
 #include "rtc_base/trace_event.h"
+#include "video/encoder_queue_pool.h"
 #include "video/overuse_frame_detector.h"
 #include "video/send_statistics_proxy.h"
 
@@ -136,7 +137,7 @@ class VideoStreamEncoder::EncodeTask : public rtc::QueuedTask {
 
  private:
   bool Run() override {
-    RTC_DCHECK_RUN_ON(&video_stream_encoder_->encoder_queue_);
+    RTC_DCHECK_RUN_ON(video_stream_encoder_->encoder_queue_);
     RTC_DCHECK_GT(
         video_stream_encoder_->posted_frames_waiting_for_encode_.Value(), 0);
     video_stream_encoder_->stats_proxy_->OnIncomingFrame(frame_.width(),
@@ -380,7 +381,8 @@ VideoStreamEncoder::VideoStreamEncoder(uint32_t number_of_cores,
                        const VideoSendStream::Config::EncoderSettings& settings,
                        rtc::VideoSinkInterface<VideoFrame>* pre_encode_callback,
                        EncodedFrameObserver* encoder_timing,
-                       std::unique_ptr<OveruseFrameDetector> overuse_detector)
+                       std::unique_ptr<OveruseFrameDetector> overuse_detector,
+                       EncoderQueuePool* encoder_queue_pool)
     : shutdown_event_(true /* manual_reset */, false),
       number_of_cores_(number_of_cores),
       initial_rampup_(0),
@@ -417,10 +419,15 @@ VideoStreamEncoder::VideoStreamEncoder(uint32_t number_of_cores,
       captured_frame_count_(0),
       dropped_frame_count_(0),
       bitrate_observer_(nullptr),
-      encoder_queue_("EncoderQueue") {
+      encoder_queue_pool_(encoder_queue_pool),
+      owned_encoder_queue_(encoder_queue_pool
+                               ? nullptr
+                               : new rtc::TaskQueue("EncoderQueue")),
+      encoder_queue_(encoder_queue_pool ? encoder_queue_pool->AcquireQueue()
+                                        : owned_encoder_queue_.get()) {
   RTC_DCHECK(stats_proxy);
-  encoder_queue_.PostTask([this] {
-    RTC_DCHECK_RUN_ON(&encoder_queue_);
+  PostTask([this] {
+    RTC_DCHECK_RUN_ON(encoder_queue_);
     overuse_detector_->StartCheckForOveruse();
     video_sender_.RegisterExternalEncoder(
         settings_.encoder, settings_.payload_type, settings_.internal_source);
@@ -431,6 +438,14 @@ VideoStreamEncoder::~VideoStreamEncoder() {
   RTC_DCHECK_RUN_ON(&thread_checker_);
   RTC_DCHECK(shutdown_event_.Wait(0))
       << "Must call ::Stop() before destruction.";
+  if (encoder_queue_pool_) {
+    // A shared queue outlives this encoder, so wait for the tasks that are
+    // already posted to run. They run before this one, as it is posted last.
+    rtc::Event event(false, false);
+    PostTask([&event] { event.Set(); });
+    event.Wait(rtc::Event::kForever);
+    encoder_queue_pool_->ReleaseQueue(encoder_queue_);
+  }
 }
 
 // TODO(pbos): Lower these thresholds (to closer to 100%) when we handle
@@ -450,8 +465,8 @@ CpuOveruseOptions VideoStreamEncoder::GetCpuOveruseOptions(
 void VideoStreamEncoder::Stop() {
   RTC_DCHECK_RUN_ON(&thread_checker_);
   source_proxy_->SetSource(nullptr, VideoSendStream::DegradationPreference());
-  encoder_queue_.PostTask([this] {
-    RTC_DCHECK_RUN_ON(&encoder_queue_);
+  PostTask([this] {
+    RTC_DCHECK_RUN_ON(encoder_queue_);
     overuse_detector_->StopCheckForOveruse();
     rate_allocator_.reset();
     bitrate_observer_ = nullptr;
@@ -481,8 +496,8 @@ void VideoStreamEncoder::DeRegisterProcessThread() {
 void VideoStreamEncoder::SetBitrateObserver(
     VideoBitrateAllocationObserver* bitrate_observer) {
   RTC_DCHECK_RUN_ON(&thread_checker_);
-  encoder_queue_.PostTask([this, bitrate_observer] {
-    RTC_DCHECK_RUN_ON(&encoder_queue_);
+  PostTask([this, bitrate_observer] {
+    RTC_DCHECK_RUN_ON(encoder_queue_);
     RTC_DCHECK(!bitrate_observer_);
     bitrate_observer_ = bitrate_observer;
   });
@@ -493,8 +508,8 @@ void VideoStreamEncoder::SetSource(
     const VideoSendStream::DegradationPreference& degradation_preference) {
   RTC_DCHECK_RUN_ON(&thread_checker_);
   source_proxy_->SetSource(source, degradation_preference);
-  encoder_queue_.PostTask([this, degradation_preference] {
-    RTC_DCHECK_RUN_ON(&encoder_queue_);
+  PostTask([this, degradation_preference] {
+    RTC_DCHECK_RUN_ON(encoder_queue_);
     if (degradation_preference_ != degradation_preference) {
       // Reset adaptation state, so that we're not tricked into thinking there's
       // an already pending request of the same type.
@@ -524,15 +539,15 @@ void VideoStreamEncoder::SetSource(
 
 void VideoStreamEncoder::SetSink(EncoderSink* sink, bool rotation_applied) {
   source_proxy_->SetWantsRotationApplied(rotation_applied);
-  encoder_queue_.PostTask([this, sink] {
-    RTC_DCHECK_RUN_ON(&encoder_queue_);
+  PostTask([this, sink] {
+    RTC_DCHECK_RUN_ON(encoder_queue_);
     sink_ = sink;
   });
 }
 
 void VideoStreamEncoder::SetStartBitrate(int start_bitrate_bps) {
-  encoder_queue_.PostTask([this, start_bitrate_bps] {
-    RTC_DCHECK_RUN_ON(&encoder_queue_);
+  PostTask([this, start_bitrate_bps] {
+    RTC_DCHECK_RUN_ON(encoder_queue_);
     encoder_start_bitrate_bps_ = start_bitrate_bps;
   });
 }
@@ -540,16 +555,16 @@ void VideoStreamEncoder::SetStartBitrate(int start_bitrate_bps) {
 void VideoStreamEncoder::ConfigureEncoder(VideoEncoderConfig config,
                                           size_t max_data_payload_length,
                                           bool nack_enabled) {
-  encoder_queue_.PostTask(
-      std::unique_ptr<rtc::QueuedTask>(new ConfigureEncoderTask(
-          this, std::move(config), max_data_payload_length, nack_enabled)));
+  PostTask(std::unique_ptr<rtc::QueuedTask>(new ConfigureEncoderTask(
+               this, std::move(config), max_data_payload_length, nack_enabled)),
+           clock_->TimeInMilliseconds());
 }
 
 void VideoStreamEncoder::ConfigureEncoderOnTaskQueue(
     VideoEncoderConfig config,
     size_t max_data_payload_length,
     bool nack_enabled) {
-  RTC_DCHECK_RUN_ON(&encoder_queue_);
+  RTC_DCHECK_RUN_ON(encoder_queue_);
   RTC_DCHECK(sink_);
   LOG(LS_INFO) << "ConfigureEncoder requested.";
 
@@ -572,11 +587,12 @@ void VideoStreamEncoder::ConfigureEncoderOnTaskQueue(
 }
 
 void VideoStreamEncoder::ReconfigureEncoder() {
-  RTC_DCHECK_RUN_ON(&encoder_queue_);
+  RTC_DCHECK_RUN_ON(encoder_queue_);
   RTC_DCHECK(pending_encoder_reconfiguration_);
   std::vector<VideoStream> streams =
       encoder_config_.video_stream_factory->CreateEncoderStreams(
           last_frame_info_->width, last_frame_info_->height, encoder_config_);
+  streams[0].bitrate_priority.emplace(encoder_config_.bitrate_priority);
 
   // TODO(ilnik): If configured resolution is significantly less than provided,
   // e.g. because there are not enough SSRCs for all simulcast streams,
@@ -646,7 +662,7 @@ void VideoStreamEncoder::ReconfigureEncoder() {
 }
 
 void VideoStreamEncoder::ConfigureQualityScaler() {
-  RTC_DCHECK_RUN_ON(&encoder_queue_);
+  RTC_DCHECK_RUN_ON(encoder_queue_);
   const auto scaling_settings = settings_.encoder->GetScalingSettings();
   const bool quality_scaling_allowed =
       IsResolutionScalingEnabled(degradation_preference_) &&
@@ -718,12 +734,24 @@ void VideoStreamEncoder::OnFrame(const VideoFrame& video_frame) {
   }
 
   last_captured_timestamp_ = incoming_frame.ntp_time_ms();
-  encoder_queue_.PostTask(std::unique_ptr<rtc::QueuedTask>(new EncodeTask(
-      incoming_frame, this, rtc::TimeMicros(), log_stats)));
+  // A frame is due by its capture time, in local time.
+  PostTask(std::unique_ptr<rtc::QueuedTask>(new EncodeTask(
+               incoming_frame, this, rtc::TimeMicros(), log_stats)),
+           incoming_frame.ntp_time_ms() - delta_ntp_internal_ms_);
+}
+
+void VideoStreamEncoder::PostTask(std::unique_ptr<rtc::QueuedTask> task,
+                                  int64_t deadline_ms) {
+  if (encoder_queue_pool_) {
+    encoder_queue_pool_->PostTask(encoder_queue_, this, deadline_ms,
+                                  std::move(task));
+  } else {
+    encoder_queue_->PostTask(std::move(task));
+  }
 }
 
 bool VideoStreamEncoder::EncoderPaused() const {
-  RTC_DCHECK_RUN_ON(&encoder_queue_);
+  RTC_DCHECK_RUN_ON(encoder_queue_);
   // Pause video if paused by caller or as long as the network is down or the
   // pacer queue has grown too large in buffered mode.
   // If the pacer queue has grown too large or the network is down,
@@ -732,7 +760,7 @@ bool VideoStreamEncoder::EncoderPaused() const {
 }
 
 void VideoStreamEncoder::TraceFrameDropStart() {
-  RTC_DCHECK_RUN_ON(&encoder_queue_);
+  RTC_DCHECK_RUN_ON(encoder_queue_);
   // Start trace event only on the first frame after encoder is paused.
   if (!encoder_paused_and_dropped_frame_) {
     TRACE_EVENT_ASYNC_BEGIN0("webrtc", "EncoderPaused", this);
@@ -741,7 +769,7 @@ void VideoStreamEncoder::TraceFrameDropStart() {
 }
 
 void VideoStreamEncoder::TraceFrameDropEnd() {
-  RTC_DCHECK_RUN_ON(&encoder_queue_);
+  RTC_DCHECK_RUN_ON(encoder_queue_);
   // End trace event on first frame after encoder resumes, if frame was dropped.
   if (encoder_paused_and_dropped_frame_) {
     TRACE_EVENT_ASYNC_END0("webrtc", "EncoderPaused", this);
@@ -751,7 +779,7 @@ void VideoStreamEncoder::TraceFrameDropEnd() {
 
 void VideoStreamEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
                                           int64_t time_when_posted_us) {
-  RTC_DCHECK_RUN_ON(&encoder_queue_);
+  RTC_DCHECK_RUN_ON(encoder_queue_);
 
   if (pre_encode_callback_)
     pre_encode_callback_->OnFrame(video_frame);
@@ -827,11 +855,11 @@ void VideoStreamEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
 }
 
 void VideoStreamEncoder::SendKeyFrame() {
-  if (!encoder_queue_.IsCurrent()) {
-    encoder_queue_.PostTask([this] { SendKeyFrame(); });
+  if (!encoder_queue_->IsCurrent()) {
+    PostTask([this] { SendKeyFrame(); });
     return;
   }
-  RTC_DCHECK_RUN_ON(&encoder_queue_);
+  RTC_DCHECK_RUN_ON(encoder_queue_);
   video_sender_.IntraFrameRequest(0);
 }
 
@@ -850,8 +878,8 @@ EncodedImageCallback::Result VideoStreamEncoder::OnEncodedImage(
   int64_t time_sent_us = rtc::TimeMicros();
   uint32_t timestamp = encoded_image._timeStamp;
   const int qp = encoded_image.qp_;
-  encoder_queue_.PostTask([this, timestamp, time_sent_us, qp] {
-    RTC_DCHECK_RUN_ON(&encoder_queue_);
+  PostTask([this, timestamp, time_sent_us, qp] {
+    RTC_DCHECK_RUN_ON(encoder_queue_);
     overuse_detector_->FrameSent(timestamp, time_sent_us);
     if (quality_scaler_ && qp >= 0)
       quality_scaler_->ReportQP(qp);
@@ -861,8 +889,8 @@ EncodedImageCallback::Result VideoStreamEncoder::OnEncodedImage(
 }
 
 void VideoStreamEncoder::OnDroppedFrame() {
-  encoder_queue_.PostTask([this] {
-    RTC_DCHECK_RUN_ON(&encoder_queue_);
+  PostTask([this] {
+    RTC_DCHECK_RUN_ON(encoder_queue_);
     if (quality_scaler_)
       quality_scaler_->ReportDroppedFrame();
   });
@@ -875,12 +903,12 @@ void VideoStreamEncoder::SendStatistics(uint32_t bit_rate,
 }
 
 void VideoStreamEncoder::OnReceivedIntraFrameRequest(size_t stream_index) {
-  if (!encoder_queue_.IsCurrent()) {
-    encoder_queue_.PostTask(
+  if (!encoder_queue_->IsCurrent()) {
+    PostTask(
         [this, stream_index] { OnReceivedIntraFrameRequest(stream_index); });
     return;
   }
-  RTC_DCHECK_RUN_ON(&encoder_queue_);
+  RTC_DCHECK_RUN_ON(encoder_queue_);
   // Key frame request from remote side, signal to VCM.
   TRACE_EVENT0("webrtc", "OnKeyFrameRequest");
   video_sender_.IntraFrameRequest(stream_index);
@@ -889,14 +917,13 @@ void VideoStreamEncoder::OnReceivedIntraFrameRequest(size_t stream_index) {
 void VideoStreamEncoder::OnBitrateUpdated(uint32_t bitrate_bps,
                                           uint8_t fraction_lost,
                                           int64_t round_trip_time_ms) {
-  if (!encoder_queue_.IsCurrent()) {
-    encoder_queue_.PostTask(
-        [this, bitrate_bps, fraction_lost, round_trip_time_ms] {
-          OnBitrateUpdated(bitrate_bps, fraction_lost, round_trip_time_ms);
-        });
+  if (!encoder_queue_->IsCurrent()) {
+    PostTask([this, bitrate_bps, fraction_lost, round_trip_time_ms] {
+      OnBitrateUpdated(bitrate_bps, fraction_lost, round_trip_time_ms);
+    });
     return;
   }
-  RTC_DCHECK_RUN_ON(&encoder_queue_);
+  RTC_DCHECK_RUN_ON(encoder_queue_);
   RTC_DCHECK(sink_) << "sink_ must be set before the encoder is active.";
 
   LOG(LS_VERBOSE) << "OnBitrateUpdated, bitrate " << bitrate_bps
@@ -921,7 +948,7 @@ void VideoStreamEncoder::OnBitrateUpdated(uint32_t bitrate_bps,
 }
 
 void VideoStreamEncoder::AdaptDown(AdaptReason reason) {
-  RTC_DCHECK_RUN_ON(&encoder_queue_);
+  RTC_DCHECK_RUN_ON(encoder_queue_);
   AdaptationRequest adaptation_request = {
       last_frame_info_->pixel_count(),
       stats_proxy_->GetStats().input_frame_rate,
@@ -1013,7 +1040,7 @@ void VideoStreamEncoder::AdaptDown(AdaptReason reason) {
 }
 
 void VideoStreamEncoder::AdaptUp(AdaptReason reason) {
-  RTC_DCHECK_RUN_ON(&encoder_queue_);
+  RTC_DCHECK_RUN_ON(encoder_queue_);
 
   const AdaptCounter& adapt_counter = GetConstAdaptCounter();
   int num_downgrades = adapt_counter.TotalCount(reason);
@@ -14,6 +14,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "api/video/video_rotation.h"
@@ -36,6 +37,7 @@
 
 namespace webrtc {
 
+class EncoderQueuePool;
 class ProcessThread;
 class SendStatisticsProxy;
 class VideoBitrateAllocationObserver;
@@ -78,7 +80,8 @@ class VideoStreamEncoder : public rtc::VideoSinkInterface<VideoFrame>,
                      const VideoSendStream::Config::EncoderSettings& settings,
                      rtc::VideoSinkInterface<VideoFrame>* pre_encode_callback,
                      EncodedFrameObserver* encoder_timing,
-                     std::unique_ptr<OveruseFrameDetector> overuse_detector);
+                     std::unique_ptr<OveruseFrameDetector> overuse_detector,
+                     EncoderQueuePool* encoder_queue_pool);
   ~VideoStreamEncoder();
   // RegisterProcessThread register |module_process_thread| with those objects
   // that use it. Registration has to happen on the thread where
@@ -124,7 +127,7 @@ class VideoStreamEncoder : public rtc::VideoSinkInterface<VideoFrame>,
  protected:
   // Used for testing. For example the |ScalingObserverInterface| methods must
   // be called on |encoder_queue_|.
-  rtc::TaskQueue* encoder_queue() { return &encoder_queue_; }
+  rtc::TaskQueue* encoder_queue() { return encoder_queue_; }
 
   // webrtc::ScalingObserverInterface implementation.
   // These methods are protected for easier testing.
@@ -151,6 +154,18 @@ class VideoStreamEncoder : public rtc::VideoSinkInterface<VideoFrame>,
     int pixel_count() const { return width * height; }
   };
 
+  // Posts |task| to |encoder_queue_|, to be run by |deadline_ms|. On a shared
+  // queue, tasks of other streams that are due earlier may run first, but the
+  // tasks of this encoder still run in the order they were posted.
+  void PostTask(std::unique_ptr<rtc::QueuedTask> task, int64_t deadline_ms);
+  // Posts a task that is due when it is posted.
+  template <class Closure,
+            typename std::enable_if<
+                std::is_copy_constructible<Closure>::value>::type* = nullptr>
+  void PostTask(const Closure& closure) {
+    PostTask(rtc::NewClosure(closure), clock_->TimeInMilliseconds());
+  }
+
   void ConfigureEncoderOnTaskQueue(VideoEncoderConfig config,
                                    size_t max_data_payload_length,
                                    bool nack_enabled);
@@ -217,10 +232,10 @@ class VideoStreamEncoder : public rtc::VideoSinkInterface<VideoFrame>,
     std::vector<int> resolution_counters_;
   };
 
-  AdaptCounter& GetAdaptCounter() RTC_RUN_ON(&encoder_queue_);
-  const AdaptCounter& GetConstAdaptCounter() RTC_RUN_ON(&encoder_queue_);
-  void UpdateAdaptationStats(AdaptReason reason) RTC_RUN_ON(&encoder_queue_);
-  AdaptCounts GetActiveCounts(AdaptReason reason) RTC_RUN_ON(&encoder_queue_);
+  AdaptCounter& GetAdaptCounter() RTC_RUN_ON(encoder_queue_);
+  const AdaptCounter& GetConstAdaptCounter() RTC_RUN_ON(encoder_queue_);
+  void UpdateAdaptationStats(AdaptReason reason) RTC_RUN_ON(encoder_queue_);
+  AdaptCounts GetActiveCounts(AdaptReason reason) RTC_RUN_ON(encoder_queue_);
 
   rtc::Event shutdown_event_;
 
@@ -233,10 +248,10 @@ class VideoStreamEncoder : public rtc::VideoSinkInterface<VideoFrame>,
   const VideoSendStream::Config::EncoderSettings settings_;
   const VideoCodecType codec_type_;
 
-  vcm::VideoSender video_sender_ RTC_ACCESS_ON(&encoder_queue_);
+  vcm::VideoSender video_sender_ RTC_ACCESS_ON(encoder_queue_);
   std::unique_ptr<OveruseFrameDetector> overuse_detector_
-      RTC_ACCESS_ON(&encoder_queue_);
-  std::unique_ptr<QualityScaler> quality_scaler_ RTC_ACCESS_ON(&encoder_queue_);
+      RTC_ACCESS_ON(encoder_queue_);
+  std::unique_ptr<QualityScaler> quality_scaler_ RTC_ACCESS_ON(encoder_queue_);
 
   SendStatisticsProxy* const stats_proxy_;
   rtc::VideoSinkInterface<VideoFrame>* const pre_encode_callback_;
@@ -246,24 +261,24 @@ class VideoStreamEncoder : public rtc::VideoSinkInterface<VideoFrame>,
   // of VideoStreamEncoder are called on the same thread.
   rtc::ThreadChecker thread_checker_;
 
-  VideoEncoderConfig encoder_config_ RTC_ACCESS_ON(&encoder_queue_);
+  VideoEncoderConfig encoder_config_ RTC_ACCESS_ON(encoder_queue_);
   std::unique_ptr<VideoBitrateAllocator> rate_allocator_
-      RTC_ACCESS_ON(&encoder_queue_);
+      RTC_ACCESS_ON(encoder_queue_);
   // The maximum frame rate of the current codec configuration, as determined
   // at the last ReconfigureEncoder() call.
-  int max_framerate_ RTC_ACCESS_ON(&encoder_queue_);
+  int max_framerate_ RTC_ACCESS_ON(encoder_queue_);
 
   // Set when ConfigureEncoder has been called in order to lazy reconfigure the
   // encoder on the next frame.
-  bool pending_encoder_reconfiguration_ RTC_ACCESS_ON(&encoder_queue_);
-  rtc::Optional<VideoFrameInfo> last_frame_info_ RTC_ACCESS_ON(&encoder_queue_);
-  int crop_width_ RTC_ACCESS_ON(&encoder_queue_);
-  int crop_height_ RTC_ACCESS_ON(&encoder_queue_);
-  uint32_t encoder_start_bitrate_bps_ RTC_ACCESS_ON(&encoder_queue_);
-  size_t max_data_payload_length_ RTC_ACCESS_ON(&encoder_queue_);
-  bool nack_enabled_ RTC_ACCESS_ON(&encoder_queue_);
-  uint32_t last_observed_bitrate_bps_ RTC_ACCESS_ON(&encoder_queue_);
-  bool encoder_paused_and_dropped_frame_ RTC_ACCESS_ON(&encoder_queue_);
+  bool pending_encoder_reconfiguration_ RTC_ACCESS_ON(encoder_queue_);
+  rtc::Optional<VideoFrameInfo> last_frame_info_ RTC_ACCESS_ON(encoder_queue_);
+  int crop_width_ RTC_ACCESS_ON(encoder_queue_);
+  int crop_height_ RTC_ACCESS_ON(encoder_queue_);
+  uint32_t encoder_start_bitrate_bps_ RTC_ACCESS_ON(encoder_queue_);
+  size_t max_data_payload_length_ RTC_ACCESS_ON(encoder_queue_);
+  bool nack_enabled_ RTC_ACCESS_ON(encoder_queue_);
+  uint32_t last_observed_bitrate_bps_ RTC_ACCESS_ON(encoder_queue_);
+  bool encoder_paused_and_dropped_frame_ RTC_ACCESS_ON(encoder_queue_);
   Clock* const clock_;
   // Counters used for deciding if the video resolution or framerate is
   // currently restricted, and if so, why, on a per degradation preference
@@ -271,10 +286,10 @@ class VideoStreamEncoder : public rtc::VideoSinkInterface<VideoFrame>,
   // TODO(sprang): Replace this with a state holding a relative overuse measure
   // instead, that can be translated into suitable down-scale or fps limit.
   std::map<const VideoSendStream::DegradationPreference, AdaptCounter>
-      adapt_counters_ RTC_ACCESS_ON(&encoder_queue_);
+      adapt_counters_ RTC_ACCESS_ON(encoder_queue_);
   // Set depending on degradation preferences.
   VideoSendStream::DegradationPreference degradation_preference_
-      RTC_ACCESS_ON(&encoder_queue_);
+      RTC_ACCESS_ON(encoder_queue_);
 
   struct AdaptationRequest {
     // The pixel count produced by the source at the time of the adaptation.
@@ -287,7 +302,7 @@ class VideoStreamEncoder : public rtc::VideoSinkInterface<VideoFrame>,
   // Stores a snapshot of the last adaptation request triggered by an AdaptUp
   // or AdaptDown signal.
   rtc::Optional<AdaptationRequest> last_adaptation_request_
-      RTC_ACCESS_ON(&encoder_queue_);
+      RTC_ACCESS_ON(encoder_queue_);
 
   rtc::RaceChecker incoming_frame_race_checker_
       RTC_GUARDED_BY(incoming_frame_race_checker_);
@@ -299,17 +314,21 @@ class VideoStreamEncoder : public rtc::VideoSinkInterface<VideoFrame>,
       RTC_GUARDED_BY(incoming_frame_race_checker_);
 
   int64_t last_frame_log_ms_ RTC_GUARDED_BY(incoming_frame_race_checker_);
-  int captured_frame_count_ RTC_ACCESS_ON(&encoder_queue_);
-  int dropped_frame_count_ RTC_ACCESS_ON(&encoder_queue_);
+  int captured_frame_count_ RTC_ACCESS_ON(encoder_queue_);
+  int dropped_frame_count_ RTC_ACCESS_ON(encoder_queue_);
 
   VideoBitrateAllocationObserver* bitrate_observer_
-      RTC_ACCESS_ON(&encoder_queue_);
+      RTC_ACCESS_ON(encoder_queue_);
   rtc::Optional<int64_t> last_parameters_update_ms_
-      RTC_ACCESS_ON(&encoder_queue_);
-
-  // All public methods are proxied to |encoder_queue_|. It must must be
-  // destroyed first to make sure no tasks are run that use other members.
-  rtc::TaskQueue encoder_queue_;
+      RTC_ACCESS_ON(encoder_queue_);
+
+  EncoderQueuePool* const encoder_queue_pool_;
+  // All public methods are proxied to |encoder_queue_|, which is either shared
+  // with other streams through |encoder_queue_pool_| or owned by this encoder.
+  // An owned queue must be destroyed first to make sure no tasks are run that
+  // use other members.
+  std::unique_ptr<rtc::TaskQueue> owned_encoder_queue_;
+  rtc::TaskQueue* const encoder_queue_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(VideoStreamEncoder);
 };
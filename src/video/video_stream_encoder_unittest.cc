@@ -25,6 +25,7 @@
 #include "test/frame_generator.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
+#include "video/encoder_queue_pool.h"
 #include "video/send_statistics_proxy.h"
 #include "video/video_stream_encoder.h"
 
@@ -94,8 +95,10 @@ class CpuOveruseDetectorProxy : public OveruseFrameDetector {
 
 class VideoStreamEncoderUnderTest : public VideoStreamEncoder {
  public:
-  VideoStreamEncoderUnderTest(SendStatisticsProxy* stats_proxy,
-                      const VideoSendStream::Config::EncoderSettings& settings)
+  VideoStreamEncoderUnderTest(
+      SendStatisticsProxy* stats_proxy,
+      const VideoSendStream::Config::EncoderSettings& settings,
+      EncoderQueuePool* encoder_queue_pool = nullptr)
       : VideoStreamEncoder(
             1 /* number_of_cores */,
             stats_proxy,
@@ -107,7 +110,8 @@ class VideoStreamEncoderUnderTest : public VideoStreamEncoder {
                     GetCpuOveruseOptions(settings.full_overuse_time),
                     this,
                     nullptr,
-                    stats_proxy))) {}
+                    stats_proxy)),
+            encoder_queue_pool) {}
 
   void PostTaskAndWait(bool down, AdaptReason reason) {
     rtc::Event event(false, false);
@@ -680,6 +684,34 @@ TEST_F(VideoStreamEncoderTest, EncodeOneFrame) {
   video_stream_encoder_->Stop();
 }
 
+TEST_F(VideoStreamEncoderTest, EncodesFramesOnSharedEncoderQueue) {
+  EncoderQueuePool encoder_queue_pool(1);
+  video_stream_encoder_->Stop();
+  video_stream_encoder_.reset(new VideoStreamEncoderUnderTest(
+      stats_proxy_.get(), video_send_config_.encoder_settings,
+      &encoder_queue_pool));
+  video_stream_encoder_->SetSink(&sink_, false /* rotation_applied */);
+  video_stream_encoder_->SetSource(
+      &video_source_,
+      VideoSendStream::DegradationPreference::kMaintainFramerate);
+  video_stream_encoder_->SetStartBitrate(kTargetBitrateBps);
+  video_stream_encoder_->ConfigureEncoder(video_encoder_config_.Copy(),
+                                          kMaxPayloadLength,
+                                          true /* nack_enabled */);
+  video_stream_encoder_->OnBitrateUpdated(kTargetBitrateBps, 0, 0);
+
+  video_source_.IncomingCapturedFrame(
+      CreateFrame(1, codec_width_, codec_height_));
+  WaitForEncodedFrame(1);
+  video_source_.IncomingCapturedFrame(
+      CreateFrame(2, codec_width_, codec_height_));
+  WaitForEncodedFrame(2);
+
+  video_stream_encoder_->Stop();
+  // The encoder gives its queue back to the pool when it is destroyed.
+  video_stream_encoder_.reset();
+}
+
 TEST_F(VideoStreamEncoderTest, DropsFramesBeforeFirstOnBitrateUpdated) {
   // Dropped since no target bitrate has been set.
   rtc::Event frame_destroyed_event(false, false);